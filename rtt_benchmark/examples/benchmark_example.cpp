@@ -1,4 +1,6 @@
+#include <array>
 #include <rtt_logger/rtt_logger.hpp>
+#include <rtt_benchmark/profiler.hpp>
 #include <rtt_benchmark/rtt_benchmark.hpp>
 
 
@@ -32,6 +34,16 @@ namespace
             result %= 1000000007; // Keep numbers manageable
         }
     }
+
+    void profiledStep()
+    {
+        RTT_PROFILE_FUNCTION();
+        quickOperation();
+        {
+            RTT_PROFILE_SCOPE("profiledStep/medium");
+            mediumOperation();
+        }
+    }
 }
 
 int main()
@@ -71,7 +83,7 @@ int main()
         const auto stats = bench.run<50>(mediumOperation);
 
         // You can use stats programmatically before reporting
-        if (stats.mean > 1000)
+        if (stats.meanNanoseconds() > 1'000'000)
         {
             logger.warning("Mean execution time exceeds 1ms threshold!");
         }
@@ -118,6 +130,55 @@ int main()
         }
     }
 
+    // Example 5: Tail latency of a long run
+    {
+        logger.info("");
+        logger.info("Example 5: Percentiles and histogram over 10000 iterations");
+        logger.info("-------------------------------------------");
+
+        // Statistics are computed online, only the reservoir needs a buffer
+        static std::array<uint32_t, 64> samples{};
+        static rtt::benchmark::Reservoir reservoir(samples);
+        static rtt::benchmark::Benchmark bench("QuickOperation-Long", logger);
+        bench.setReservoir(&reservoir);
+
+        const auto stats = bench.run(quickOperation, 10000);
+        bench.report(stats);
+        bench.reportHistogram();
+        logger.logFormatted(rtt::LogLevel::Info, "Reservoir holds %u of %u samples",
+                            static_cast<unsigned int>(reservoir.size()), static_cast<unsigned int>(reservoir.seen()));
+    }
+
+    // Example 6: Stall breakdown from the DWT profiling counters
+    {
+        logger.info("");
+        logger.info("Example 6: DWT stall breakdown");
+        logger.info("-------------------------------------------");
+
+        rtt::benchmark::Benchmark bench("QuickOperation-Profiled", logger);
+        if (!bench.enableProfiling())
+        {
+            logger.info("DWT profiling counters not available, reporting timing only");
+        }
+        bench.report(bench.run<100>(quickOperation));
+        bench.disableProfiling();
+    }
+
+    // Example 7: Aggregating scope profiler
+    {
+        logger.info("");
+        logger.info("Example 7: Scope profiler over 200 calls");
+        logger.info("-------------------------------------------");
+
+        // Nothing is printed per call; the sites are aggregated and reported once
+        for (int i = 0; i < 200; ++i)
+        {
+            profiledStep();
+        }
+        rtt::benchmark::Profiler::log(logger);
+        rtt::benchmark::Profiler::report();
+    }
+
     logger.info("");
     logger.info("===========================================");
     logger.info("  Benchmark Examples Completed");
@@ -0,0 +1,74 @@
+#include <array>
+#include <rtt_benchmark/suite.hpp>
+#include <rtt_logger/rtt_logger.hpp>
+
+namespace
+{
+    std::array<uint32_t, 1024> s_input{};
+
+    // Parameterized over the input size: sums the first argument elements
+    void sumArray(uint32_t size)
+    {
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            sum += s_input[i];
+        }
+        rtt::benchmark::doNotOptimize(sum);
+    }
+
+    void fillArray(uint32_t size)
+    {
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            s_input[i] = i;
+        }
+        rtt::benchmark::clobberMemory();
+    }
+
+    void crc8(uint32_t)
+    {
+        uint8_t crc = 0;
+        for (const uint32_t value : s_input)
+        {
+            crc ^= static_cast<uint8_t>(value);
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = static_cast<uint8_t>((crc & 0x80U) != 0 ? (crc << 1) ^ 0x07U : crc << 1);
+            }
+        }
+        rtt::benchmark::doNotOptimize(crc);
+    }
+} // namespace
+
+// Registration: function, timed iterations, warmup iterations[, input sizes...]
+RTT_BENCHMARK_ARGS(sumArray, 1000, 10, 16, 256, 1024);
+RTT_BENCHMARK_ARGS(fillArray, 1000, 10, 16, 256, 1024);
+RTT_BENCHMARK(crc8, 100, 2);
+
+/**
+ * Example running all registered benchmarks as a suite
+ *
+ * Results are sent as binary BenchmarkResult records on data channel 1
+ * (capture it and compare with scripts/rtt_benchmark_compare.py) and
+ * reported as text on channel 0.
+ */
+int main()
+{
+    rtt::Logger::initialize();
+    auto& logger = rtt::getLogger();
+
+    logger.logFormatted(rtt::LogLevel::Info, "Running %u registered benchmarks",
+                        static_cast<unsigned int>(rtt::benchmark::Registry::count()));
+
+    for (uint32_t i = 0; i < s_input.size(); ++i)
+    {
+        s_input[i] = i * 2654435761U;
+    }
+
+    static rtt::benchmark::Suite suite;
+    const size_t results = suite.run();
+
+    logger.logFormatted(rtt::LogLevel::Info, "Sent %u benchmark results", static_cast<unsigned int>(results));
+    return 0;
+}
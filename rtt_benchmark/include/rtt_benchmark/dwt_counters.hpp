@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rtt::benchmark
+{
+    /**
+     * @brief Values of the DWT profiling counters
+     *
+     * Each counter increments once per cycle of its event, so the sum of
+     * cycles, stalls and folds describes where the time of a kernel went:
+     * instructions = cycles - cpi - exception - sleep - lsu + fold.
+     */
+    struct DwtEvents
+    {
+        uint32_t cpi; // Extra cycles of multi-cycle instructions, incl. instruction fetch stalls (flash wait states)
+        uint32_t exception; // Cycles spent in exception entry and exit
+        uint32_t sleep; // Cycles spent sleeping
+        uint32_t lsu; // Extra cycles of load/store instructions (memory access stalls)
+        uint32_t fold; // Instructions folded (executed in zero cycles)
+    };
+
+    /**
+     * @brief Access to the Cortex-M DWT profiling counters
+     *
+     * CPICNT, EXCCNT, SLEEPCNT, LSUCNT and FOLDCNT are available on Cortex-M3,
+     * M4, M7 and M33 (not on M0/M0+). They are 8 bits wide and wrap, so a
+     * difference of two samples is exact only while fewer than 256 cycles
+     * passed between them. On host builds the counters read as zero.
+     */
+    class DwtCounters
+    {
+    public:
+        /// Width mask of the profiling counters; differences are exact for spans below 256 cycles
+        static constexpr uint32_t COUNTER_MASK{0xFFU};
+
+        /**
+         * @brief Check if the core implements the profiling counters
+         */
+        [[nodiscard]] static bool isSupported() noexcept;
+
+        /**
+         * @brief Reset and enable the profiling counters
+         * @return True if the counters are running
+         */
+        static bool enable() noexcept;
+
+        /**
+         * @brief Disable the profiling counters, leaving the cycle counter running
+         */
+        static void disable() noexcept;
+
+        /**
+         * @brief Read all profiling counters
+         */
+        [[nodiscard]] static DwtEvents sample() noexcept
+        {
+#ifdef __ARM_ARCH
+            return DwtEvents{
+                .cpi = *reinterpret_cast<volatile uint32_t*>(0xE0001008) & COUNTER_MASK, // DWT_CPICNT
+                .exception = *reinterpret_cast<volatile uint32_t*>(0xE000100C) & COUNTER_MASK, // DWT_EXCCNT
+                .sleep = *reinterpret_cast<volatile uint32_t*>(0xE0001010) & COUNTER_MASK, // DWT_SLEEPCNT
+                .lsu = *reinterpret_cast<volatile uint32_t*>(0xE0001014) & COUNTER_MASK, // DWT_LSUCNT
+                .fold = *reinterpret_cast<volatile uint32_t*>(0xE0001018) & COUNTER_MASK, // DWT_FOLDCNT
+            };
+#else
+            return DwtEvents{};
+#endif
+        }
+
+        /**
+         * @brief Events between two samples (modulo the 8-bit counter width)
+         * @param start Sample taken first
+         * @param end Sample taken last
+         */
+        [[nodiscard]] static constexpr DwtEvents elapsed(const DwtEvents& start, const DwtEvents& end) noexcept
+        {
+            return DwtEvents{
+                .cpi = (end.cpi - start.cpi) & COUNTER_MASK,
+                .exception = (end.exception - start.exception) & COUNTER_MASK,
+                .sleep = (end.sleep - start.sleep) & COUNTER_MASK,
+                .lsu = (end.lsu - start.lsu) & COUNTER_MASK,
+                .fold = (end.fold - start.fold) & COUNTER_MASK,
+            };
+        }
+    };
+} // namespace rtt::benchmark
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <rtt_data/rtt_data.hpp>
+#include <rtt_logger/rtt_logger.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
+
+#ifndef RTT_PROFILER_NAME_LENGTH
+#define RTT_PROFILER_NAME_LENGTH 24
+#endif
+
+#ifndef RTT_PROFILER_SCHEMA_ID
+#define RTT_PROFILER_SCHEMA_ID 0xB1
+#endif
+
+namespace rtt::benchmark
+{
+    /// Characters per site name in a ProfileRecord, including the terminating zero
+    static constexpr size_t PROFILER_NAME_LENGTH{RTT_PROFILER_NAME_LENGTH};
+
+    class ProfileScope;
+
+    /**
+     * @brief Aggregated timing of one profiled call site
+     *
+     * Created as a constant-initialized static by RTT_PROFILE_SCOPE and linked
+     * into the Profiler on its first completed scope. Updates are plain
+     * (single-writer) arithmetic; a site entered concurrently from several
+     * tasks or interrupts may occasionally lose an update, so give such call
+     * sites their own names. Times are in timebase ticks (CPU cycles on
+     * Cortex-M).
+     */
+    class ProfileSite
+    {
+    public:
+        constexpr explicit ProfileSite(const char* name) noexcept : m_name(name)
+        {
+        }
+
+        // Registered by address
+        ProfileSite(const ProfileSite&) = delete;
+        ProfileSite& operator=(const ProfileSite&) = delete;
+        ProfileSite(ProfileSite&&) = delete;
+        ProfileSite& operator=(ProfileSite&&) = delete;
+
+        /**
+         * @brief Add one completed scope
+         * @param inclusive Ticks between entry and exit
+         * @param exclusive Inclusive ticks minus the ticks of nested scopes
+         */
+        void record(uint32_t inclusive, uint32_t exclusive) noexcept
+        {
+            ++m_count;
+            m_total += inclusive;
+            m_exclusive += exclusive;
+            m_min = inclusive < m_min ? inclusive : m_min;
+            m_max = inclusive > m_max ? inclusive : m_max;
+        }
+
+        /**
+         * @brief Clear the aggregated values (the site stays registered)
+         */
+        void reset() noexcept
+        {
+            m_count = 0;
+            m_min = UINT32_MAX;
+            m_max = 0;
+            m_total = 0;
+            m_exclusive = 0;
+        }
+
+        [[nodiscard]] const char* getName() const noexcept { return m_name; }
+        [[nodiscard]] uint32_t getCount() const noexcept { return m_count; }
+        [[nodiscard]] uint32_t getMin() const noexcept { return m_count > 0 ? m_min : 0; }
+        [[nodiscard]] uint32_t getMax() const noexcept { return m_max; }
+        [[nodiscard]] uint64_t getTotal() const noexcept { return m_total; }
+
+        /**
+         * @brief Total ticks excluding nested scopes (equals getTotal() without RTT_PROFILER_EXCLUSIVE)
+         */
+        [[nodiscard]] uint64_t getExclusive() const noexcept { return m_exclusive; }
+
+        [[nodiscard]] bool isRegistered() const noexcept { return m_registered.load(std::memory_order_relaxed); }
+        [[nodiscard]] const ProfileSite* getNext() const noexcept { return m_next; }
+
+    private:
+        friend class Profiler;
+
+        const char* m_name;
+        uint32_t m_count{0};
+        uint32_t m_min{UINT32_MAX};
+        uint32_t m_max{0};
+        uint64_t m_total{0};
+        uint64_t m_exclusive{0};
+        std::atomic<bool> m_registered{false};
+        ProfileSite* m_next{nullptr};
+    };
+
+    /**
+     * @brief Binary record of one call site, streamed by Profiler::report()
+     */
+    struct ProfileRecord
+    {
+        char name[PROFILER_NAME_LENGTH]; // Site name (truncated), zero-terminated
+        uint32_t count; // Completed scopes
+        uint32_t min; // Shortest scope in ticks
+        uint32_t max; // Longest scope in ticks
+        uint32_t frequency; // Timebase frequency in Hz
+        uint64_t total; // Inclusive ticks
+        uint64_t exclusive; // Exclusive ticks
+    };
+} // namespace rtt::benchmark
+
+RTT_DATA_SCHEMA(rtt::benchmark::ProfileRecord, RTT_PROFILER_SCHEMA_ID, RTT_DATA_FIELD(name), RTT_DATA_FIELD(count),
+                RTT_DATA_FIELD(min), RTT_DATA_FIELD(max), RTT_DATA_FIELD(frequency), RTT_DATA_FIELD(total),
+                RTT_DATA_FIELD(exclusive));
+
+namespace rtt::benchmark
+{
+    /**
+     * @brief Registry and reporting of all profiled call sites
+     *
+     * Nothing is printed while profiling; report() streams the aggregated
+     * records of all sites in one burst of Struct packets, e.g. from a
+     * periodic low-priority task or on demand from the debugger.
+     */
+    class Profiler
+    {
+    public:
+        /**
+         * @brief Returns the slot holding the innermost open scope of the current context
+         */
+        using ScopeSlotProvider = ProfileScope** (*)() noexcept;
+
+        /**
+         * @brief Link a site into the registry (called on its first completed scope)
+         * @param site Site to register
+         */
+        static void registerSite(ProfileSite& site) noexcept;
+
+        /**
+         * @brief First registered site (most recently registered first)
+         */
+        [[nodiscard]] static const ProfileSite* first() noexcept { return s_head.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Number of registered sites
+         */
+        [[nodiscard]] static size_t count() noexcept { return s_count.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Stream one ProfileRecord per registered site (schema first)
+         * @param sender DataSender to stream through
+         * @param reset Clear the sites after sending, for per-interval statistics
+         * @return Number of records sent
+         */
+        static size_t report(data::DataSender& sender = data::getDataSender(), bool reset = false) noexcept;
+
+        /**
+         * @brief Print one line per registered site via the logger
+         * @param logger Logger to use
+         */
+        static void log(Logger& logger = getLogger()) noexcept;
+
+        /**
+         * @brief Clear all registered sites
+         */
+        static void reset() noexcept;
+
+        /**
+         * @brief Set how the scope stack of the current context is found (RTT_PROFILER_EXCLUSIVE)
+         *
+         * The default is one global stack, which is correct without an RTOS:
+         * interrupts nest like scopes, so their time is excluded from the scope
+         * they preempt. With an RTOS return a per-task slot, e.g. a FreeRTOS
+         * thread local storage pointer.
+         *
+         * @param provider Slot provider (nullptr restores the global stack)
+         */
+        static void setScopeSlotProvider(ScopeSlotProvider provider) noexcept;
+
+        /**
+         * @brief Slot holding the innermost open scope of the current context
+         */
+        [[nodiscard]] static ProfileScope** scopeSlot() noexcept { return s_slotProvider(); }
+
+        /**
+         * @brief Copy a site into its binary record
+         * @param site Site to convert
+         * @return Record with the name truncated to PROFILER_NAME_LENGTH - 1 characters
+         */
+        [[nodiscard]] static ProfileRecord makeRecord(const ProfileSite& site) noexcept;
+
+    private:
+        static ProfileScope** globalSlot() noexcept { return &s_globalTop; }
+
+        static inline std::atomic<ProfileSite*> s_head{nullptr};
+        static inline std::atomic<size_t> s_count{0};
+        static inline ProfileScope* s_globalTop{nullptr};
+        static inline ScopeSlotProvider s_slotProvider{&Profiler::globalSlot};
+    };
+
+    /**
+     * @brief RAII measurement of one scope into a ProfileSite
+     *
+     * Costs two raw timebase reads and the record update; with
+     * RTT_PROFILER_EXCLUSIVE also a push and pop on the context's scope stack.
+     */
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(ProfileSite& site) noexcept : m_site(site)
+        {
+#if RTT_PROFILER_EXCLUSIVE
+            m_slot = Profiler::scopeSlot();
+            m_parent = *m_slot;
+            *m_slot = this;
+#endif
+            m_start = Timebase::sample();
+        }
+
+        ~ProfileScope() noexcept
+        {
+            const uint32_t elapsed = Timebase::sample() - m_start;
+#if RTT_PROFILER_EXCLUSIVE
+            *m_slot = m_parent;
+            if (m_parent != nullptr)
+            {
+                m_parent->m_nested += elapsed;
+            }
+            m_site.record(elapsed, elapsed > m_nested ? elapsed - m_nested : 0);
+#else
+            m_site.record(elapsed, elapsed);
+#endif
+            if (!m_site.isRegistered())
+            {
+                Profiler::registerSite(m_site);
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+        ProfileScope(ProfileScope&&) = delete;
+        ProfileScope& operator=(ProfileScope&&) = delete;
+
+    private:
+        ProfileSite& m_site;
+        uint32_t m_start{0};
+#if RTT_PROFILER_EXCLUSIVE
+        ProfileScope** m_slot{nullptr};
+        ProfileScope* m_parent{nullptr};
+        uint32_t m_nested{0}; // Ticks spent in nested scopes
+#endif
+    };
+} // namespace rtt::benchmark
+
+#define RTT_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RTT_PROFILE_CONCAT(a, b) RTT_PROFILE_CONCAT_IMPL(a, b)
+
+#if RTT_PROFILER_DISABLE
+#define RTT_PROFILE_SCOPE(name)
+#else
+/**
+ * @brief Profile the rest of the enclosing scope under a site name
+ * @param name Site name (string literal)
+ */
+#define RTT_PROFILE_SCOPE(name)                                                                                      \
+    static ::rtt::benchmark::ProfileSite RTT_PROFILE_CONCAT(s_rttProfileSite_, __LINE__){name};                      \
+    const ::rtt::benchmark::ProfileScope RTT_PROFILE_CONCAT(rttProfileScope_, __LINE__)(                             \
+        RTT_PROFILE_CONCAT(s_rttProfileSite_, __LINE__))
+#endif
+
+/**
+ * @brief Profile the rest of the enclosing function under its name
+ */
+#define RTT_PROFILE_FUNCTION() RTT_PROFILE_SCOPE(__func__)
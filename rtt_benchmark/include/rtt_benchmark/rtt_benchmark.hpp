@@ -3,9 +3,12 @@
 #include <chrono>
 #include <cstdint>
 #include <algorithm>
-#include <numeric>
+#include <atomic>
 #include <functional>
+#include <rtt_benchmark/dwt_counters.hpp>
+#include <rtt_benchmark/statistics.hpp>
 #include <rtt_logger/rtt_logger.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
 #include <string_view>
 #include <concepts>
 
@@ -14,6 +17,10 @@ namespace rtt::benchmark
 {
     // Default CPU frequency for ARM platforms if not defined externally
     constexpr auto F_CPU{80'000'000}; // 80 MHz default
+    /**
+     * @brief std::chrono clock over the shared rtt::Timebase
+     * @tparam CPUFrequencyHz Tick frequency of the timebase
+     */
     template<uint64_t CPUFrequencyHz>
     struct Clock
     {
@@ -22,90 +29,64 @@ namespace rtt::benchmark
         using duration = std::chrono::duration<rep, period>;
         using time_point = std::chrono::time_point<Clock>;
         static constexpr bool is_steady{true};
-        static inline auto DWT_CYCCNT = reinterpret_cast<uint32_t*>(0xE0001004);
-
-        static time_point now() noexcept { return time_point{duration{getTicks()}}; }
-        static uint64_t getTicks() noexcept {
-            static uint32_t last_count = 0;
-            static uint32_t overflow_count = 0;
 
-            const uint32_t current = *DWT_CYCCNT;
-
-            // Detect overflow (wrapped around)
-            if (current < last_count) {
-                ++overflow_count;
-            }
-
-            last_count = current;
-
-            // Combine overflow count and current count into 64-bit value
-            return (static_cast<uint64_t>(overflow_count) << 32) | current;
-        }
+        static time_point now() noexcept { return time_point{duration{static_cast<rep>(getTicks())}}; }
+        static uint64_t getTicks() noexcept { return Timebase::now(); }
     };
 
+#ifdef __ARM_ARCH
     using DwtClock = Clock<F_CPU>;
+#else
+    using DwtClock = Clock<1'000'000'000>; // Timebase ticks are nanoseconds on the host
+#endif
 
+    /**
+     * @brief Measures the time since construction on the shared timebase
+     *
+     * The counter itself is never reset or stopped, so other modules keep a
+     * consistent timeline while benchmarks run.
+     */
     class CycleCounter
     {
     public:
 
-        CycleCounter()
+        CycleCounter() noexcept : m_startTime(DwtClock::now())
         {
-            resetCounter();
-            startCounter();
-            m_startTime = DwtClock::now();
         }
 
+        /**
+         * @brief Start the timebase with the F_CPU frequency
+         * @return True if the counter is running
+         */
         static bool initialize() noexcept {
-            // Enable DWT if not already enabled
-            *SCB_DEMCR |= TRACE_MASK; // Enable trace
-            *DWT_CYCCNT = 0U;
-            startCounter();
-            return (*DWT_CYCCNT & DWT_CTRL_CYCCNTENA) != 0;
+            return Timebase::initialize(F_CPU);
         }
 
-
         template<typename T = std::chrono::microseconds>
         auto getTimeDiff() const
         {
-            stopCounter();
             return std::chrono::duration_cast<T>(DwtClock::now() - m_startTime);
         }
 
-        static void reset() noexcept {
-            resetCounter();
-        }
-
-        ~CycleCounter()
-        {
-            resetCounter();
-            *SCB_DEMCR &= ~TRACE_MASK;
-        }
-
     private:
         DwtClock::time_point m_startTime{};
+    };
 
-        // DWT (Data Watchpoint and Trace) registers for ARM Cortex-M
-        static inline auto DWT_CYCCNT = reinterpret_cast<uint32_t*>(0xE0001004);
-        static inline auto DWT_CONTROL = reinterpret_cast<uint32_t*>(0xE0001000);
-        static inline auto SCB_DEMCR = reinterpret_cast<uint32_t*>(0xE000EDFC);
-        static constexpr uint32_t TRACE_MASK{0x01000000};
-        static constexpr uint32_t DWT_CTRL_CYCCNTENA = 1UL << 0;
-
-        static void stopCounter()
-        {
-            *DWT_CONTROL &= ~DWT_CTRL_CYCCNTENA;
-        }
-
-        static void startCounter()
-        {
-            *DWT_CONTROL |= DWT_CTRL_CYCCNTENA; // Enable counter
-        }
-
-        static void resetCounter()
-        {
-            *DWT_CYCCNT = 0; // Reset counter
-        }
+    /**
+     * @brief DWT event totals of a profiled benchmark run
+     *
+     * Measurement overhead is subtracted like for the cycle counts. Divide by
+     * the iteration count for per-iteration values.
+     */
+    struct ProfileStats
+    {
+        bool enabled; // True if the DWT profiling counters were sampled
+        uint64_t cpi; // Extra cycles of multi-cycle instructions and instruction fetch stalls
+        uint64_t exception; // Exception entry/exit cycles
+        uint64_t sleep; // Sleep cycles
+        uint64_t lsu; // Extra cycles of load/store instructions
+        uint64_t fold; // Folded instructions
+        size_t inexact; // Iterations too long for the 8-bit counters, whose counts may have wrapped
     };
 
     /**
@@ -113,22 +94,73 @@ namespace rtt::benchmark
      */
     struct BenchmarkStats
     {
-        uint32_t min; // Minimum execution time in microseconds
-        uint32_t max; // Maximum execution time in microseconds
-        uint32_t mean; // Mean execution time in microseconds
-        uint32_t total; // Total execution time in microseconds
+        uint64_t min; // Minimum execution time in timebase ticks (CPU cycles on Cortex-M)
+        uint64_t max; // Maximum execution time in ticks
+        uint64_t mean; // Mean execution time in ticks
+        uint64_t total; // Total execution time in ticks
+        uint64_t stddev; // Standard deviation in ticks
+        uint64_t p50; // Median (P² estimate) in ticks
+        uint64_t p90; // 90th percentile in ticks
+        uint64_t p99; // 99th percentile in ticks
+        uint64_t p999; // 99.9th percentile in ticks
+        uint32_t overhead; // Measurement overhead in ticks, already subtracted from each iteration
         size_t iterations; // Number of iterations performed
+        ProfileStats profile; // DWT event breakdown (only with Benchmark::enableProfiling())
+
+        [[nodiscard]] uint64_t minNanoseconds() const noexcept { return Timebase::toNanoseconds(min); }
+        [[nodiscard]] uint64_t maxNanoseconds() const noexcept { return Timebase::toNanoseconds(max); }
+        [[nodiscard]] uint64_t meanNanoseconds() const noexcept { return Timebase::toNanoseconds(mean); }
+        [[nodiscard]] uint64_t totalNanoseconds() const noexcept { return Timebase::toNanoseconds(total); }
+        [[nodiscard]] uint64_t p99Nanoseconds() const noexcept { return Timebase::toNanoseconds(p99); }
     };
 
     template <typename F>
     concept BenchmarkableFunction = std::invocable<F> && std::same_as<void, std::invoke_result_t<F>>;
 
+    /**
+     * @brief Force the compiler to materialize a value
+     *
+     * Prevents a benchmarked computation whose result is unused from being
+     * optimized away, without the store a volatile sink costs.
+     *
+     * @param value Result to keep
+     */
+    template <typename T>
+    inline void doNotOptimize(const T& value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __asm volatile("" : : "r,m"(value) : "memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        (void)value;
+#endif
+    }
+
+    /**
+     * @brief Force pending writes to memory to be treated as observable
+     *
+     * Compiler barrier; emits no instructions.
+     */
+    inline void clobberMemory() noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __asm volatile("" : : : "memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
     /**
      * @brief Benchmark class for measuring code execution time via RTT
      *
      * This class provides a simple interface to benchmark code snippets
      * by running them multiple times and collecting timing statistics.
      * Results are output via RTT for analysis on the host.
+     *
+     * Statistics are computed online (StreamingStats), so memory use does not
+     * depend on the iteration count. The object holds the engine of the last
+     * run (about 700 bytes); place long-lived benchmarks in static storage on
+     * small task stacks.
      */
     class Benchmark
     {
@@ -145,11 +177,28 @@ namespace rtt::benchmark
 
         /**
          * @brief Run a benchmark function multiple times
+         *
+         * Each iteration is timed with two raw timebase samples around the call.
+         * The cost of the samples themselves is measured first (measureOverhead)
+         * and subtracted, so results resolve kernels of a few cycles.
+         *
          * @param func Function to benchmark (must be invocable with no args and return void)
-         * @return BenchmarkStats containing timing statistics
+         * @return BenchmarkStats containing timing statistics in ticks
          */
         template <size_t Iterations, BenchmarkableFunction Func>
-        BenchmarkStats run(Func&& func) noexcept;
+        BenchmarkStats run(Func&& func) noexcept
+        {
+            return run(std::forward<Func>(func), Iterations);
+        }
+
+        /**
+         * @brief Run a benchmark function with a runtime iteration count
+         * @param func Function to benchmark
+         * @param iterations Number of iterations
+         * @return BenchmarkStats containing timing statistics in ticks
+         */
+        template <BenchmarkableFunction Func>
+        BenchmarkStats run(Func&& func, size_t iterations) noexcept;
 
         /**
          * @brief Run a benchmark function and report results via RTT
@@ -164,6 +213,73 @@ namespace rtt::benchmark
          */
         void report(const BenchmarkStats& stats) const noexcept;
 
+        /**
+         * @brief Report the log2 histogram of the last run via RTT
+         *
+         * One line per non-empty bin with its tick range and sample count.
+         */
+        void reportHistogram() const noexcept;
+
+        /**
+         * @brief Keep a uniform sample of raw iteration times in a reservoir
+         *
+         * The reservoir is reset at the start of every run.
+         *
+         * @param reservoir Reservoir to fill (nullptr to disable), must outlive the benchmark
+         */
+        void setReservoir(Reservoir* reservoir) noexcept { m_statistics.setReservoir(reservoir); }
+
+        /**
+         * @brief Sample the DWT profiling counters around each iteration
+         *
+         * Adds the stall breakdown (CPI, load/store, exception, sleep, folded
+         * instructions) to the results, telling e.g. flash wait states apart
+         * from memory stalls. The counters are 8 bits wide, so the breakdown is
+         * exact only for iterations shorter than about 256 cycles; longer
+         * iterations are counted in ProfileStats::inexact.
+         *
+         * @return True if the core supports the counters (false on host builds and Cortex-M0)
+         */
+        bool enableProfiling() noexcept
+        {
+            m_profiling = DwtCounters::enable();
+            return m_profiling;
+        }
+
+        /**
+         * @brief Stop sampling the DWT profiling counters
+         */
+        void disableProfiling() noexcept
+        {
+            DwtCounters::disable();
+            m_profiling = false;
+        }
+
+        /**
+         * @brief Check if DWT profiling is active
+         */
+        [[nodiscard]] bool isProfiling() const noexcept { return m_profiling; }
+
+        /**
+         * @brief Set the number of untimed iterations run before measuring
+         *
+         * Warms caches, branch predictors and lazily initialized state so the
+         * first timed iterations are not outliers.
+         *
+         * @param iterations Warmup iterations (default: 0)
+         */
+        void setWarmup(size_t iterations) noexcept { m_warmup = iterations; }
+
+        /**
+         * @brief Get the number of warmup iterations
+         */
+        [[nodiscard]] size_t getWarmup() const noexcept { return m_warmup; }
+
+        /**
+         * @brief Get the statistics engine of the last run (histogram, reservoir)
+         */
+        [[nodiscard]] const StreamingStats& getStatistics() const noexcept { return m_statistics; }
+
         /**
          * @brief Verify that steady_clock has sufficient resolution for benchmarking
          *
@@ -175,49 +291,113 @@ namespace rtt::benchmark
          */
         static void verifyClockResolution(Logger& logger) noexcept;
 
+        /**
+         * @brief Measure the cost of timing an empty iteration
+         *
+         * Takes the minimum over several back-to-back sample pairs, which is what
+         * an iteration measures when the function does nothing.
+         *
+         * @return Measurement overhead in ticks
+         */
+        [[nodiscard]] static uint32_t measureOverhead() noexcept
+        {
+            uint32_t overhead = UINT32_MAX;
+            for (size_t i = 0; i < OVERHEAD_SAMPLES; ++i)
+            {
+                const uint32_t start = Timebase::sample();
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                overhead = std::min(overhead, Timebase::sample() - start);
+            }
+            return overhead;
+        }
+
         /**
          * @brief Get the benchmark name
          * @return Benchmark name
          */
         [[nodiscard]] constexpr std::string_view getName() const noexcept { return m_name; }
 
+        /**
+         * @brief Rename the benchmark, e.g. to reuse one object for several runs
+         * @param name New name, must outlive the benchmark's use of it
+         */
+        void setName(std::string_view name) noexcept { m_name = name; }
+
     private:
+        static constexpr size_t OVERHEAD_SAMPLES{16};
+
+        /**
+         * @brief Measure the DWT events of timing an empty iteration
+         *
+         * Same sequence as a profiled iteration, minimum per counter.
+         */
+        [[nodiscard]] static DwtEvents measureEventOverhead() noexcept
+        {
+            DwtEvents overhead{UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+            for (size_t i = 0; i < OVERHEAD_SAMPLES; ++i)
+            {
+                const DwtEvents before = DwtCounters::sample();
+                const uint32_t start = Timebase::sample();
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                (void)(Timebase::sample() - start);
+                const DwtEvents events = DwtCounters::elapsed(before, DwtCounters::sample());
+                overhead.cpi = std::min(overhead.cpi, events.cpi);
+                overhead.exception = std::min(overhead.exception, events.exception);
+                overhead.sleep = std::min(overhead.sleep, events.sleep);
+                overhead.lsu = std::min(overhead.lsu, events.lsu);
+                overhead.fold = std::min(overhead.fold, events.fold);
+            }
+            return overhead;
+        }
+
+        /**
+         * @brief Accumulate the DWT events of one profiled iteration
+         * @param events Events of the iteration including overhead
+         * @param overhead Events of an empty iteration
+         * @param elapsed Cycles of the iteration including overhead
+         * @param cycleOverhead Cycle measurement overhead
+         */
+        void addEvents(const DwtEvents& events, const DwtEvents& overhead, uint32_t elapsed,
+                       uint32_t cycleOverhead) noexcept;
+
+        /**
+         * @brief Report the DWT event breakdown of a profiled run
+         * @param stats Statistics to report
+         */
+        void reportProfile(const BenchmarkStats& stats) const noexcept;
+
         std::string_view m_name;
         Logger& m_logger;
+        size_t m_warmup{0};
+        bool m_profiling{false};
+        ProfileStats m_profile{};
+        StreamingStats m_statistics;
 
         /**
          * @brief Get current time in microseconds
          *
-         * Uses hardware-specific timing mechanisms for maximum accuracy:
-         * - ARM Cortex-M: DWT cycle counter (requires F_CPU to be defined)
-         * - Other platforms: std::chrono::steady_clock
+         * Taken from the shared rtt::Timebase (DWT cycle counter on ARM Cortex-M,
+         * std::chrono::steady_clock on other platforms).
          *
          * @return Current time in microseconds
          */
         [[nodiscard]] static uint32_t getCurrentTimeMicros() noexcept;
 
         /**
-         * @brief Calculate statistics from timing measurements
-         * @param timings Timing measurements
+         * @brief Report one time value in ticks and nanoseconds
+         * @param label Line label
+         * @param ticks Time in ticks
+         */
+        void reportTime(const char* label, uint64_t ticks) const noexcept;
+
+        /**
+         * @brief Summarize the statistics engine after a run
+         * @param overhead Subtracted measurement overhead in ticks
          * @return Calculated statistics
          */
-        template<size_t Size>
-        [[nodiscard]] static BenchmarkStats calculateStats(const std::array<uint32_t, Size>& timings) noexcept
-        {
-            if (timings.empty())
-            {
-                return {};
-            }
-            const auto [minimum, maximum] = std::ranges::minmax_element(timings);
-            const BenchmarkStats stats{
-                .min = *minimum,
-                .max = *maximum,
-                .mean = static_cast<uint32_t>(std::accumulate(timings.begin(), timings.end(), 0U) / Size),
-                .total = (std::accumulate(timings.begin(), timings.end(), 0U)),
-                .iterations = Size,
-            };
-            return stats;
-        }
+        [[nodiscard]] BenchmarkStats makeStats(uint32_t overhead) const noexcept;
     };
 
     /**
@@ -234,7 +414,7 @@ namespace rtt::benchmark
          * @param logger Logger instance to use
          */
         explicit ScopedTimer(std::string_view name, Logger& logger = getLogger()) noexcept :
-            m_name(name), m_logger(logger), m_start(std::chrono::steady_clock::now())
+            m_name(name), m_logger(logger), m_start(Timebase::now())
         {
         }
 
@@ -252,24 +432,53 @@ namespace rtt::benchmark
     private:
         std::string_view m_name;
         Logger& m_logger;
-        std::chrono::steady_clock::time_point m_start;
+        uint64_t m_start; // Timebase ticks
     };
 
-    template <size_t Iterations, BenchmarkableFunction Func>
-    BenchmarkStats Benchmark::run(Func&& func) noexcept
+    template <BenchmarkableFunction Func>
+    BenchmarkStats Benchmark::run(Func&& func, size_t iterations) noexcept
     {
-        // Allocate timing buffer on stack for small iterations, heap for large
-        std::array<uint32_t, Iterations> timings{};
+        for (size_t i = 0; i < m_warmup; ++i)
+        {
+            func();
+        }
+
+        m_statistics.reset();
+        m_profile = ProfileStats{};
+        const uint32_t overhead = measureOverhead();
+
+        if (m_profiling)
+        {
+            // The counters are sampled outside the cycle samples, so the timing is unaffected
+            const DwtEvents eventOverhead = measureEventOverhead();
+            m_profile.enabled = true;
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                const DwtEvents before = DwtCounters::sample();
+                const uint32_t start = Timebase::sample();
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                func();
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                const uint32_t elapsed = Timebase::sample() - start;
+                const DwtEvents events = DwtCounters::elapsed(before, DwtCounters::sample());
+                m_statistics.add(elapsed > overhead ? elapsed - overhead : 0);
+                addEvents(events, eventOverhead, elapsed, overhead);
+            }
+            return makeStats(overhead);
+        }
 
-        // Run benchmark iterations
-        for (size_t i = 0; i < Iterations; ++i)
+        // Run benchmark iterations; the fences keep the call between the samples
+        for (size_t i = 0; i < iterations; ++i)
         {
-            CycleCounter cycle;
+            const uint32_t start = Timebase::sample();
+            std::atomic_signal_fence(std::memory_order_seq_cst);
             func();
-            timings.at(i) = cycle.getTimeDiff().count();
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            const uint32_t elapsed = Timebase::sample() - start;
+            m_statistics.add(elapsed > overhead ? elapsed - overhead : 0);
         }
 
-        return calculateStats(timings);
+        return makeStats(overhead);
     }
 
     template <size_t Iterations, BenchmarkableFunction Func>
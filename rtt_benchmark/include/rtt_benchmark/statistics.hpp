@@ -0,0 +1,266 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace rtt::benchmark
+{
+    /**
+     * @brief Running count, min, max, mean and variance (Welford's algorithm)
+     *
+     * Numerically stable single-pass mean and variance in constant memory.
+     */
+    class RunningStats
+    {
+    public:
+        /**
+         * @brief Add one sample
+         * @param value Sample value
+         */
+        void add(uint64_t value) noexcept;
+
+        /**
+         * @brief Discard all samples
+         */
+        void reset() noexcept { *this = RunningStats{}; }
+
+        [[nodiscard]] size_t count() const noexcept { return m_count; }
+        [[nodiscard]] uint64_t min() const noexcept { return m_count > 0 ? m_min : 0; }
+        [[nodiscard]] uint64_t max() const noexcept { return m_max; }
+        [[nodiscard]] uint64_t total() const noexcept { return m_total; }
+        [[nodiscard]] double mean() const noexcept { return m_mean; }
+
+        /**
+         * @brief Sample variance (n - 1 denominator), 0 for fewer than two samples
+         */
+        [[nodiscard]] double variance() const noexcept
+        {
+            return m_count > 1 ? m_m2 / static_cast<double>(m_count - 1) : 0.0;
+        }
+
+        /**
+         * @brief Sample standard deviation
+         */
+        [[nodiscard]] double stddev() const noexcept;
+
+    private:
+        size_t m_count{0};
+        uint64_t m_min{UINT64_MAX};
+        uint64_t m_max{0};
+        uint64_t m_total{0};
+        double m_mean{0.0};
+        double m_m2{0.0}; // Sum of squared differences from the mean
+    };
+
+    /**
+     * @brief Streaming quantile estimate with the P² algorithm (Jain & Chlamtac)
+     *
+     * Tracks five markers whose heights converge to the minimum, p/2, p,
+     * (1 + p)/2 and maximum quantiles, adjusting them with piecewise-parabolic
+     * interpolation. Constant memory and time per sample, no stored samples.
+     */
+    class P2Quantile
+    {
+    public:
+        /**
+         * @brief Construct an estimator
+         * @param quantile Quantile to estimate, in (0, 1), e.g. 0.99
+         */
+        explicit P2Quantile(double quantile) noexcept;
+
+        /**
+         * @brief Add one sample
+         * @param value Sample value
+         */
+        void add(double value) noexcept;
+
+        /**
+         * @brief Discard all samples
+         */
+        void reset() noexcept { *this = P2Quantile{m_quantile}; }
+
+        /**
+         * @brief Current estimate (exact for up to five samples, 0 without samples)
+         */
+        [[nodiscard]] double value() const noexcept;
+
+        [[nodiscard]] double getQuantile() const noexcept { return m_quantile; }
+        [[nodiscard]] size_t count() const noexcept { return m_count; }
+
+    private:
+        static constexpr size_t MARKERS{5};
+
+        [[nodiscard]] double parabolic(size_t i, double direction) const noexcept;
+        [[nodiscard]] double linear(size_t i, int direction) const noexcept;
+
+        double m_quantile;
+        size_t m_count{0};
+        std::array<double, MARKERS> m_heights{};
+        std::array<int32_t, MARKERS> m_positions{};
+        std::array<double, MARKERS> m_desired{};
+    };
+
+    /**
+     * @brief Histogram with one bin per power of two
+     *
+     * Bin 0 counts zero, bin k counts values in [2^(k-1), 2^k). 33 bins cover
+     * the full 32-bit tick range in 132 bytes.
+     */
+    class LogHistogram
+    {
+    public:
+        static constexpr size_t BINS{33};
+
+        /**
+         * @brief Add one sample
+         * @param value Sample value
+         */
+        void add(uint32_t value) noexcept
+        {
+            const size_t bin = binOf(value);
+            if (m_counts[bin] < UINT32_MAX)
+            {
+                ++m_counts[bin];
+            }
+        }
+
+        /**
+         * @brief Discard all samples
+         */
+        void reset() noexcept { m_counts.fill(0); }
+
+        /**
+         * @brief Bin index of a value
+         */
+        [[nodiscard]] static constexpr size_t binOf(uint32_t value) noexcept
+        {
+            return static_cast<size_t>(std::bit_width(value));
+        }
+
+        /**
+         * @brief Smallest value counted in a bin
+         */
+        [[nodiscard]] static constexpr uint64_t lowerBound(size_t bin) noexcept
+        {
+            return bin == 0 ? 0 : uint64_t{1} << (bin - 1);
+        }
+
+        /**
+         * @brief First value above a bin
+         */
+        [[nodiscard]] static constexpr uint64_t upperBound(size_t bin) noexcept
+        {
+            return uint64_t{1} << bin;
+        }
+
+        /**
+         * @brief Number of samples in a bin (saturates at UINT32_MAX)
+         */
+        [[nodiscard]] uint32_t getCount(size_t bin) const noexcept { return bin < BINS ? m_counts[bin] : 0; }
+
+    private:
+        std::array<uint32_t, BINS> m_counts{};
+    };
+
+    /**
+     * @brief Uniform random sample of a stream in a caller-supplied buffer
+     *
+     * Algorithm R: the first capacity samples are stored, then each new sample
+     * replaces a random slot with probability capacity / seen. Use it to look
+     * at raw samples (e.g. exact percentiles host side) of arbitrarily long runs.
+     */
+    class Reservoir
+    {
+    public:
+        /**
+         * @brief Construct a reservoir over a buffer
+         * @param buffer Sample storage, must outlive the reservoir
+         * @param capacity Number of elements in buffer
+         */
+        Reservoir(uint32_t* buffer, size_t capacity) noexcept : m_buffer(buffer), m_capacity(buffer != nullptr ? capacity : 0)
+        {
+        }
+
+        template<size_t N>
+        explicit Reservoir(std::array<uint32_t, N>& buffer) noexcept : Reservoir(buffer.data(), N)
+        {
+        }
+
+        /**
+         * @brief Offer one sample
+         * @param value Sample value
+         */
+        void add(uint32_t value) noexcept;
+
+        /**
+         * @brief Discard all samples (the random sequence continues)
+         */
+        void reset() noexcept
+        {
+            m_size = 0;
+            m_seen = 0;
+        }
+
+        [[nodiscard]] const uint32_t* data() const noexcept { return m_buffer; }
+        [[nodiscard]] size_t size() const noexcept { return m_size; }
+        [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+        [[nodiscard]] size_t seen() const noexcept { return m_seen; }
+
+    private:
+        [[nodiscard]] uint32_t nextRandom() noexcept;
+
+        uint32_t* m_buffer;
+        size_t m_capacity;
+        size_t m_size{0};
+        size_t m_seen{0};
+        uint32_t m_state{0x9E3779B9U}; // xorshift32 state, never zero
+    };
+
+    /**
+     * @brief Online statistics engine for benchmark timings
+     *
+     * Combines RunningStats, a LogHistogram and P² estimators for p50, p90,
+     * p99 and p99.9, all in constant memory (about 700 bytes), plus an
+     * optional Reservoir.
+     */
+    class StreamingStats
+    {
+    public:
+        /**
+         * @brief Add one sample to all estimators
+         * @param value Sample value in ticks
+         */
+        void add(uint32_t value) noexcept;
+
+        /**
+         * @brief Discard all samples, including the reservoir's
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Also feed samples into a reservoir
+         * @param reservoir Reservoir to fill (nullptr to disable), must outlive this object
+         */
+        void setReservoir(Reservoir* reservoir) noexcept { m_reservoir = reservoir; }
+
+        [[nodiscard]] const RunningStats& summary() const noexcept { return m_summary; }
+        [[nodiscard]] const LogHistogram& histogram() const noexcept { return m_histogram; }
+        [[nodiscard]] const Reservoir* reservoir() const noexcept { return m_reservoir; }
+
+        [[nodiscard]] double p50() const noexcept { return m_p50.value(); }
+        [[nodiscard]] double p90() const noexcept { return m_p90.value(); }
+        [[nodiscard]] double p99() const noexcept { return m_p99.value(); }
+        [[nodiscard]] double p999() const noexcept { return m_p999.value(); }
+
+    private:
+        RunningStats m_summary;
+        LogHistogram m_histogram;
+        P2Quantile m_p50{0.5};
+        P2Quantile m_p90{0.9};
+        P2Quantile m_p99{0.99};
+        P2Quantile m_p999{0.999};
+        Reservoir* m_reservoir{nullptr};
+    };
+} // namespace rtt::benchmark
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <rtt_benchmark/rtt_benchmark.hpp>
+#include <rtt_data/rtt_data.hpp>
+
+#ifndef RTT_BENCHMARK_MAX_ARGUMENTS
+#define RTT_BENCHMARK_MAX_ARGUMENTS 8
+#endif
+
+#ifndef RTT_BENCHMARK_NAME_LENGTH
+#define RTT_BENCHMARK_NAME_LENGTH 32
+#endif
+
+#ifndef RTT_BENCHMARK_RESULT_SCHEMA_ID
+#define RTT_BENCHMARK_RESULT_SCHEMA_ID 0xB0
+#endif
+
+namespace rtt::benchmark
+{
+    /// Input sizes per parameterized benchmark
+    static constexpr size_t BENCHMARK_MAX_ARGUMENTS{RTT_BENCHMARK_MAX_ARGUMENTS};
+    /// Characters per result name, including the terminating zero
+    static constexpr size_t BENCHMARK_NAME_LENGTH{RTT_BENCHMARK_NAME_LENGTH};
+
+    /**
+     * @brief Function of a registered benchmark, called once per iteration
+     *
+     * The argument is the input size of a parameterized benchmark (0 otherwise).
+     * Prepare inputs up front, e.g. in a static buffer of the largest size.
+     */
+    using BenchmarkFunction = void (*)(uint32_t argument);
+
+    /**
+     * @brief Statically registered benchmark, see RTT_BENCHMARK
+     *
+     * Definitions link themselves into the Registry on construction, so
+     * registration needs no heap and works from any translation unit.
+     */
+    class BenchmarkDefinition
+    {
+    public:
+        /**
+         * @brief Define and register a benchmark
+         * @param name Benchmark name (string literal)
+         * @param function Function called once per iteration
+         * @param iterations Timed iterations per argument
+         * @param warmup Untimed iterations run before measuring
+         * @param arguments Input sizes; empty runs once with argument 0 (at most BENCHMARK_MAX_ARGUMENTS are kept)
+         */
+        BenchmarkDefinition(const char* name, BenchmarkFunction function, size_t iterations, size_t warmup,
+                            std::initializer_list<uint32_t> arguments = {}) noexcept;
+
+        // Registered by address
+        BenchmarkDefinition(const BenchmarkDefinition&) = delete;
+        BenchmarkDefinition& operator=(const BenchmarkDefinition&) = delete;
+        BenchmarkDefinition(BenchmarkDefinition&&) = delete;
+        BenchmarkDefinition& operator=(BenchmarkDefinition&&) = delete;
+
+        [[nodiscard]] const char* getName() const noexcept { return m_name; }
+        [[nodiscard]] BenchmarkFunction getFunction() const noexcept { return m_function; }
+        [[nodiscard]] size_t getIterations() const noexcept { return m_iterations; }
+        [[nodiscard]] size_t getWarmup() const noexcept { return m_warmup; }
+        [[nodiscard]] size_t getArgumentCount() const noexcept { return m_argumentCount; }
+        [[nodiscard]] uint32_t getArgument(size_t index) const noexcept
+        {
+            return index < m_argumentCount ? m_arguments[index] : 0;
+        }
+
+        /**
+         * @brief Next definition in registration order (nullptr at the end)
+         */
+        [[nodiscard]] const BenchmarkDefinition* getNext() const noexcept { return m_next; }
+
+    private:
+        friend class Registry;
+
+        const char* m_name;
+        BenchmarkFunction m_function;
+        size_t m_iterations;
+        size_t m_warmup;
+        std::array<uint32_t, BENCHMARK_MAX_ARGUMENTS> m_arguments{};
+        size_t m_argumentCount{0};
+        BenchmarkDefinition* m_next{nullptr};
+    };
+
+    /**
+     * @brief Static list of all registered benchmarks
+     */
+    class Registry
+    {
+    public:
+        /**
+         * @brief First registered benchmark (nullptr if none)
+         */
+        [[nodiscard]] static const BenchmarkDefinition* first() noexcept { return s_head; }
+
+        /**
+         * @brief Number of registered benchmarks
+         */
+        [[nodiscard]] static size_t count() noexcept { return s_count; }
+
+    private:
+        friend class BenchmarkDefinition;
+
+        static void add(BenchmarkDefinition& definition) noexcept;
+
+        // Constant-initialized, so registration from static constructors is order-safe
+        static inline BenchmarkDefinition* s_head{nullptr};
+        static inline BenchmarkDefinition* s_tail{nullptr};
+        static inline size_t s_count{0};
+    };
+
+    /**
+     * @brief Binary result record of one benchmark run
+     *
+     * Sent as a schema-registered Struct packet, so the host decodes it into
+     * named columns (see scripts/rtt_benchmark_compare.py). Times are in
+     * timebase ticks; frequency converts them to seconds.
+     */
+    struct BenchmarkResult
+    {
+        char name[BENCHMARK_NAME_LENGTH]; // "name" or "name/argument", zero-terminated
+        uint32_t argument; // Input size (0 if not parameterized)
+        uint32_t iterations; // Timed iterations
+        uint32_t overhead; // Subtracted measurement overhead in ticks
+        uint32_t frequency; // Timebase frequency in Hz
+        uint64_t min;
+        uint64_t mean;
+        uint64_t max;
+        uint64_t stddev;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+    };
+} // namespace rtt::benchmark
+
+RTT_DATA_SCHEMA(rtt::benchmark::BenchmarkResult, RTT_BENCHMARK_RESULT_SCHEMA_ID, RTT_DATA_FIELD(name),
+                RTT_DATA_FIELD(argument), RTT_DATA_FIELD(iterations), RTT_DATA_FIELD(overhead),
+                RTT_DATA_FIELD(frequency), RTT_DATA_FIELD(min), RTT_DATA_FIELD(mean), RTT_DATA_FIELD(max),
+                RTT_DATA_FIELD(stddev), RTT_DATA_FIELD(p50), RTT_DATA_FIELD(p90), RTT_DATA_FIELD(p99),
+                RTT_DATA_FIELD(p999));
+
+namespace rtt::benchmark
+{
+    /**
+     * @brief Runs all registered benchmarks and emits binary result records
+     *
+     * Each benchmark is run once per argument. Results are sent as
+     * BenchmarkResult Struct packets over a DataSender (the schema is sent at
+     * the start of every suite run) and optionally reported as text.
+     */
+    class Suite
+    {
+    public:
+        /**
+         * @brief Construct a suite runner
+         * @param sender DataSender for result records
+         * @param logger Logger for the text report
+         */
+        explicit Suite(data::DataSender& sender = data::getDataSender(), Logger& logger = getLogger()) noexcept :
+            m_sender(sender), m_benchmark("", logger)
+        {
+        }
+
+        /**
+         * @brief Only run benchmarks whose name starts with a prefix
+         * @param prefix Name prefix (empty runs all)
+         */
+        void setFilter(std::string_view prefix) noexcept { m_filter = prefix; }
+
+        /**
+         * @brief Enable or disable the text report of each result
+         * @param enabled True to report via the logger (default: true)
+         */
+        void setTextReport(bool enabled) noexcept { m_textReport = enabled; }
+
+        /**
+         * @brief Run all registered benchmarks matching the filter
+         * @return Number of result records sent
+         */
+        size_t run() noexcept;
+
+        /**
+         * @brief Run one benchmark for all its arguments
+         * @param definition Benchmark to run
+         * @return Number of result records sent
+         */
+        size_t run(const BenchmarkDefinition& definition) noexcept;
+
+        /**
+         * @brief Run one benchmark for a single argument
+         *
+         * For runners that prepare each input themselves. Unlike run(), no
+         * schema is sent; send it once with sendSchema<BenchmarkResult>().
+         *
+         * @param definition Benchmark to run
+         * @param argument Input size passed to the function
+         * @return Number of result records sent
+         */
+        size_t run(const BenchmarkDefinition& definition, uint32_t argument) noexcept;
+
+        /**
+         * @brief Get the result record of the last run
+         */
+        [[nodiscard]] const BenchmarkResult& getLastResult() const noexcept { return m_result; }
+
+    private:
+        void runOnce(const BenchmarkDefinition& definition, uint32_t argument, bool parameterized) noexcept;
+
+        data::DataSender& m_sender;
+        Benchmark m_benchmark;
+        std::string_view m_filter;
+        bool m_textReport{true};
+        BenchmarkResult m_result{};
+    };
+} // namespace rtt::benchmark
+
+#define RTT_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define RTT_BENCHMARK_CONCAT(a, b) RTT_BENCHMARK_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Register a benchmark function
+ * @param function void function(uint32_t argument)
+ * @param iterations Timed iterations
+ * @param warmup Untimed warmup iterations
+ */
+#define RTT_BENCHMARK(function, iterations, warmup)                                                             \
+    static ::rtt::benchmark::BenchmarkDefinition RTT_BENCHMARK_CONCAT(s_rttBenchmark_, __LINE__)(             \
+        #function, (function), (iterations), (warmup))
+
+/**
+ * @brief Register a benchmark function parameterized over input sizes
+ * @param function void function(uint32_t argument)
+ * @param iterations Timed iterations per argument
+ * @param warmup Untimed warmup iterations per argument
+ * @param ... Input sizes passed as argument, e.g. 16, 64, 256
+ */
+#define RTT_BENCHMARK_ARGS(function, iterations, warmup, ...)                                                   \
+    static ::rtt::benchmark::BenchmarkDefinition RTT_BENCHMARK_CONCAT(s_rttBenchmark_, __LINE__)(             \
+        #function, (function), (iterations), (warmup), {__VA_ARGS__})
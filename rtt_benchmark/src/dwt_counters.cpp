@@ -0,0 +1,54 @@
+#include <rtt_benchmark/dwt_counters.hpp>
+
+namespace rtt::benchmark
+{
+    namespace
+    {
+#ifdef __ARM_ARCH
+        volatile uint32_t* const DWT_CONTROL = reinterpret_cast<volatile uint32_t*>(0xE0001000);
+        volatile uint32_t* const SCB_DEMCR = reinterpret_cast<volatile uint32_t*>(0xE000EDFC);
+        constexpr uint32_t DEMCR_TRCENA{1UL << 24};
+        constexpr uint32_t DWT_CTRL_NOPRFCNT{1UL << 24}; // Set if the profiling counters are not implemented
+        constexpr uint32_t DWT_CTRL_PROFILE_ENABLE{(1UL << 17) | (1UL << 18) | (1UL << 19) | (1UL << 20) |
+                                                   (1UL << 21)}; // CPIEVTENA..FOLDEVTENA
+        constexpr uintptr_t DWT_CPICNT{0xE0001008};
+        constexpr uintptr_t DWT_FOLDCNT{0xE0001018};
+#endif
+    } // namespace
+
+    bool DwtCounters::isSupported() noexcept
+    {
+#ifdef __ARM_ARCH
+        *SCB_DEMCR = *SCB_DEMCR | DEMCR_TRCENA; // DWT registers are only accessible with trace enabled
+        return (*DWT_CONTROL & DWT_CTRL_NOPRFCNT) == 0U;
+#else
+        return false;
+#endif
+    }
+
+    bool DwtCounters::enable() noexcept
+    {
+#ifdef __ARM_ARCH
+        if (!isSupported())
+        {
+            return false;
+        }
+
+        for (uintptr_t address = DWT_CPICNT; address <= DWT_FOLDCNT; address += sizeof(uint32_t))
+        {
+            *reinterpret_cast<volatile uint32_t*>(address) = 0;
+        }
+        *DWT_CONTROL = *DWT_CONTROL | DWT_CTRL_PROFILE_ENABLE;
+        return (*DWT_CONTROL & DWT_CTRL_PROFILE_ENABLE) == DWT_CTRL_PROFILE_ENABLE;
+#else
+        return false;
+#endif
+    }
+
+    void DwtCounters::disable() noexcept
+    {
+#ifdef __ARM_ARCH
+        *DWT_CONTROL = *DWT_CONTROL & ~DWT_CTRL_PROFILE_ENABLE;
+#endif
+    }
+} // namespace rtt::benchmark
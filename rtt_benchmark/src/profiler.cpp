@@ -0,0 +1,87 @@
+#include <rtt_benchmark/profiler.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace rtt::benchmark
+{
+    void Profiler::registerSite(ProfileSite& site) noexcept
+    {
+        if (site.m_registered.exchange(true, std::memory_order_acq_rel))
+        {
+            return;
+        }
+
+        // Lock-free push, safe against registration from interrupts
+        ProfileSite* head = s_head.load(std::memory_order_relaxed);
+        do
+        {
+            site.m_next = head;
+        } while (!s_head.compare_exchange_weak(head, &site, std::memory_order_release, std::memory_order_relaxed));
+        s_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ProfileRecord Profiler::makeRecord(const ProfileSite& site) noexcept
+    {
+        ProfileRecord record{};
+        const char* name = site.getName() != nullptr ? site.getName() : "";
+        std::memcpy(record.name, name, std::min(std::strlen(name), sizeof(record.name) - 1));
+        record.count = site.getCount();
+        record.min = site.getMin();
+        record.max = site.getMax();
+        record.frequency = Timebase::getFrequency();
+        record.total = site.getTotal();
+        record.exclusive = site.getExclusive();
+        return record;
+    }
+
+    size_t Profiler::report(data::DataSender& sender, bool reset) noexcept
+    {
+        // The host may have connected after an earlier report
+        (void)sender.sendSchema<ProfileRecord>();
+
+        size_t sent = 0;
+        for (const ProfileSite* site = first(); site != nullptr; site = site->getNext())
+        {
+            if (sender.sendStruct(makeRecord(*site)) > 0)
+            {
+                ++sent;
+            }
+            if (reset)
+            {
+                const_cast<ProfileSite*>(site)->reset();
+            }
+        }
+        return sent;
+    }
+
+    void Profiler::log(Logger& logger) noexcept
+    {
+        logger.info("=== Profiler ===");
+        for (const ProfileSite* site = first(); site != nullptr; site = site->getNext())
+        {
+            const uint32_t count = site->getCount();
+            const uint64_t mean = count > 0 ? site->getTotal() / count : 0;
+            logger.logFormatted(LogLevel::Info, "%s: %lu calls, mean %llu, min %lu, max %lu, total %llu, excl %llu (%llu us)",
+                                site->getName(), static_cast<unsigned long>(count), static_cast<unsigned long long>(mean),
+                                static_cast<unsigned long>(site->getMin()), static_cast<unsigned long>(site->getMax()),
+                                static_cast<unsigned long long>(site->getTotal()),
+                                static_cast<unsigned long long>(site->getExclusive()),
+                                static_cast<unsigned long long>(Timebase::toMicroseconds(site->getTotal())));
+        }
+        logger.info("================");
+    }
+
+    void Profiler::reset() noexcept
+    {
+        for (ProfileSite* site = s_head.load(std::memory_order_acquire); site != nullptr; site = site->m_next)
+        {
+            site->reset();
+        }
+    }
+
+    void Profiler::setScopeSlotProvider(ScopeSlotProvider provider) noexcept
+    {
+        s_slotProvider = provider != nullptr ? provider : &Profiler::globalSlot;
+    }
+} // namespace rtt::benchmark
@@ -1,7 +1,67 @@
 #include <rtt_benchmark/rtt_benchmark.hpp>
 
+#include <cmath>
+
 namespace rtt::benchmark
 {
+    namespace
+    {
+#ifdef __ARM_ARCH
+        constexpr const char* TICK_UNIT = "cycles";
+#else
+        constexpr const char* TICK_UNIT = "ticks";
+#endif
+
+        uint32_t subtractOverhead(uint32_t value, uint32_t overhead) noexcept
+        {
+            return value > overhead ? value - overhead : 0;
+        }
+
+        uint64_t toTicks(double value) noexcept
+        {
+            return value > 0.0 ? static_cast<uint64_t>(std::llround(value)) : 0;
+        }
+    } // namespace
+
+    BenchmarkStats Benchmark::makeStats(uint32_t overhead) const noexcept
+    {
+        const RunningStats& summary = m_statistics.summary();
+        const size_t iterations = summary.count();
+        if (iterations == 0)
+        {
+            BenchmarkStats stats{};
+            stats.overhead = overhead;
+            stats.profile = m_profile;
+            return stats;
+        }
+
+        // The estimators are independent; keep the reported percentiles ordered and within the observed range
+        const uint64_t p50 = std::clamp(toTicks(m_statistics.p50()), summary.min(), summary.max());
+        const uint64_t p90 = std::clamp(toTicks(m_statistics.p90()), p50, summary.max());
+        const uint64_t p99 = std::clamp(toTicks(m_statistics.p99()), p90, summary.max());
+        const uint64_t p999 = std::clamp(toTicks(m_statistics.p999()), p99, summary.max());
+
+        return BenchmarkStats{
+            .min = summary.min(),
+            .max = summary.max(),
+            .mean = summary.total() / iterations,
+            .total = summary.total(),
+            .stddev = toTicks(summary.stddev()),
+            .p50 = p50,
+            .p90 = p90,
+            .p99 = p99,
+            .p999 = p999,
+            .overhead = overhead,
+            .iterations = iterations,
+            .profile = m_profile,
+        };
+    }
+
+    void Benchmark::reportTime(const char* label, uint64_t ticks) const noexcept
+    {
+        m_logger.logFormatted(LogLevel::Info, "%s: %llu %s (%llu ns)", label, static_cast<unsigned long long>(ticks),
+                              TICK_UNIT, static_cast<unsigned long long>(Timebase::toNanoseconds(ticks)));
+    }
 
     void Benchmark::verifyClockResolution(Logger& logger) noexcept
     {
@@ -31,7 +91,7 @@ namespace rtt::benchmark
         }
 
         logger.info("DWT cycle counter provides cycle-accurate hardware timing");
-        logger.warning("Note: DWT counter is 32-bit and will overflow after ~35 seconds at 120MHz");
+        logger.info("Counter is extended to 64 bits by rtt::Timebase");
         logger.info("====================================");
 #else
         // On non-ARM platforms, check steady_clock resolution
@@ -80,38 +140,7 @@ namespace rtt::benchmark
 
     uint32_t Benchmark::getCurrentTimeMicros() noexcept
     {
-#ifdef __ARM_ARCH
-        // DWT (Data Watchpoint and Trace) registers for ARM Cortex-M
-        static volatile uint32_t* DWT_CYCCNT = reinterpret_cast<uint32_t*>(0xE0001004);
-        static volatile uint32_t* DWT_CONTROL = reinterpret_cast<uint32_t*>(0xE0001000);
-        static volatile uint32_t* SCB_DEMCR = reinterpret_cast<uint32_t*>(0xE000EDFC);
-
-        // Pre-calculate conversion factor for performance (avoid division in hot path)
-        static constexpr double CYCLES_TO_MICROS = 1000000.0 / static_cast<double>(F_CPU);
-
-        // Enable DWT if not already enabled
-        static uint8_t dwt_initialized = 0;
-        if (dwt_initialized == 0U)
-        {
-            *SCB_DEMCR |= 0x01000000; // Enable trace
-            *DWT_CYCCNT = 0; // Reset counter
-            *DWT_CONTROL |= 1U; // Enable counter
-            dwt_initialized = 1;
-        }
-
-        // Read cycle counter and convert to microseconds
-        // Note: DWT_CYCCNT is a 32-bit counter that will overflow.
-        // For short benchmarks (< ~35 seconds at 120MHz), this is acceptable.
-        // For longer benchmarks, overflow handling would be needed.
-        const uint32_t cycles = *DWT_CYCCNT;
-
-        return static_cast<uint32_t>(static_cast<double>(cycles) * CYCLES_TO_MICROS);
-#else
-        // Fall back to std::chrono for non-ARM platforms
-        const auto now = std::chrono::steady_clock::now();
-        const auto duration = now.time_since_epoch();
-        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-#endif
+        return static_cast<uint32_t>(Timebase::toMicroseconds(Timebase::now()));
     }
 
     void Benchmark::report(const BenchmarkStats& stats) const noexcept
@@ -121,22 +150,101 @@ namespace rtt::benchmark
 
         // Use logger's formatted output directly via RTT
         m_logger.logFormatted(LogLevel::Info, "Name: %.*s", static_cast<int>(m_name.length()), m_name.data());
-        m_logger.logFormatted(LogLevel::Info, "Iterations: %u", stats.iterations);
-        m_logger.logFormatted(LogLevel::Info, "Min time: %llu us", static_cast<unsigned long long>(stats.min));
-        m_logger.logFormatted(LogLevel::Info, "Max time: %llu us", static_cast<unsigned long long>(stats.max));
-        m_logger.logFormatted(LogLevel::Info, "Mean time: %llu us", static_cast<unsigned long long>(stats.mean));
-        m_logger.logFormatted(LogLevel::Info, "Total time: %llu us", static_cast<unsigned long long>(stats.total));
+        m_logger.logFormatted(LogLevel::Info, "Iterations: %u", static_cast<unsigned int>(stats.iterations));
+        reportTime("Min time", stats.min);
+        reportTime("Max time", stats.max);
+        reportTime("Mean time", stats.mean);
+        reportTime("Total time", stats.total);
+        reportTime("Std dev", stats.stddev);
+        reportTime("p50", stats.p50);
+        reportTime("p90", stats.p90);
+        reportTime("p99", stats.p99);
+        reportTime("p99.9", stats.p999);
+        m_logger.logFormatted(LogLevel::Info, "Overhead: %lu %s (subtracted)", static_cast<unsigned long>(stats.overhead),
+                              TICK_UNIT);
+        if (stats.profile.enabled && stats.iterations > 0)
+        {
+            reportProfile(stats);
+        }
+        m_logger.info("========================");
+    }
+
+    void Benchmark::addEvents(const DwtEvents& events, const DwtEvents& overhead, uint32_t elapsed,
+                              uint32_t cycleOverhead) noexcept
+    {
+        m_profile.cpi += subtractOverhead(events.cpi, overhead.cpi);
+        m_profile.exception += subtractOverhead(events.exception, overhead.exception);
+        m_profile.sleep += subtractOverhead(events.sleep, overhead.sleep);
+        m_profile.lsu += subtractOverhead(events.lsu, overhead.lsu);
+        m_profile.fold += subtractOverhead(events.fold, overhead.fold);
+
+        // The counter window spans the iteration plus the sampling on both sides
+        if (static_cast<uint64_t>(elapsed) + cycleOverhead >= DwtCounters::COUNTER_MASK)
+        {
+            ++m_profile.inexact;
+        }
+    }
+
+    void Benchmark::reportProfile(const BenchmarkStats& stats) const noexcept
+    {
+        const ProfileStats& profile = stats.profile;
+        const auto iterations = static_cast<double>(stats.iterations);
+        const auto cycles = static_cast<double>(stats.total);
+
+        const auto line = [this, iterations, cycles](const char* label, uint64_t total) {
+            const double share = cycles > 0.0 ? 100.0 * static_cast<double>(total) / cycles : 0.0;
+            m_logger.logFormatted(LogLevel::Info, "%s: %.1f cycles/iteration (%.1f%%)", label,
+                                  static_cast<double>(total) / iterations, share);
+        };
+
+        m_logger.info("--- DWT event breakdown ---");
+        line("CPI stalls (multi-cycle, fetch)", profile.cpi);
+        line("LSU stalls (load/store)", profile.lsu);
+        line("Exception overhead", profile.exception);
+        line("Sleep", profile.sleep);
+        m_logger.logFormatted(LogLevel::Info, "Folded instructions: %.1f/iteration",
+                              static_cast<double>(profile.fold) / iterations);
+
+        // ARMv7-M: instructions = cycles - CPI - EXC - SLEEP - LSU + FOLD
+        const double stalls = static_cast<double>(profile.cpi + profile.exception + profile.sleep + profile.lsu);
+        const double instructions = std::max(0.0, cycles - stalls + static_cast<double>(profile.fold));
+        m_logger.logFormatted(LogLevel::Info, "Instructions (est.): %.1f/iteration, IPC %.2f", instructions / iterations,
+                              cycles > 0.0 ? instructions / cycles : 0.0);
+
+        if (profile.inexact > 0)
+        {
+            m_logger.logFormatted(LogLevel::Warning, "%u of %u iterations exceed the 8-bit counter range, counts may have wrapped",
+                                  static_cast<unsigned int>(profile.inexact), static_cast<unsigned int>(stats.iterations));
+        }
+    }
+
+    void Benchmark::reportHistogram() const noexcept
+    {
+        const LogHistogram& histogram = m_statistics.histogram();
+        m_logger.logFormatted(LogLevel::Info, "=== Histogram: %.*s (%s) ===", static_cast<int>(m_name.length()),
+                              m_name.data(), TICK_UNIT);
+        for (size_t bin = 0; bin < LogHistogram::BINS; ++bin)
+        {
+            const uint32_t count = histogram.getCount(bin);
+            if (count == 0)
+            {
+                continue;
+            }
+            m_logger.logFormatted(LogLevel::Info, "[%llu, %llu): %lu",
+                                  static_cast<unsigned long long>(LogHistogram::lowerBound(bin)),
+                                  static_cast<unsigned long long>(LogHistogram::upperBound(bin)),
+                                  static_cast<unsigned long>(count));
+        }
         m_logger.info("========================");
     }
 
     ScopedTimer::~ScopedTimer() noexcept
     {
-        const auto end = std::chrono::steady_clock::now();
-        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - m_start);
+        const uint64_t elapsed = Timebase::toMicroseconds(Timebase::now() - m_start);
 
         // Use logger's formatted output directly via RTT
-        m_logger.logFormatted(LogLevel::Info, "[%.*s] Elapsed time: %lld us", static_cast<int>(m_name.length()),
-                              m_name.data(), duration.count());
+        m_logger.logFormatted(LogLevel::Info, "[%.*s] Elapsed time: %llu us", static_cast<int>(m_name.length()),
+                              m_name.data(), static_cast<unsigned long long>(elapsed));
     }
 
 } // namespace rtt::benchmark
@@ -0,0 +1,190 @@
+#include <rtt_benchmark/statistics.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace rtt::benchmark
+{
+    void RunningStats::add(uint64_t value) noexcept
+    {
+        ++m_count;
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+        m_total += value;
+
+        const double sample = static_cast<double>(value);
+        const double delta = sample - m_mean;
+        m_mean += delta / static_cast<double>(m_count);
+        m_m2 += delta * (sample - m_mean);
+    }
+
+    double RunningStats::stddev() const noexcept
+    {
+        return std::sqrt(variance());
+    }
+
+    P2Quantile::P2Quantile(double quantile) noexcept : m_quantile(std::clamp(quantile, 0.0, 1.0))
+    {
+        for (size_t i = 0; i < MARKERS; ++i)
+        {
+            m_positions[i] = static_cast<int32_t>(i);
+        }
+        m_desired = {0.0, 2.0 * m_quantile, 4.0 * m_quantile, 2.0 + (2.0 * m_quantile), 4.0};
+    }
+
+    void P2Quantile::add(double value) noexcept
+    {
+        if (m_count < MARKERS)
+        {
+            // Collect the first samples sorted, they become the initial marker heights
+            size_t i = m_count++;
+            for (; i > 0 && m_heights[i - 1] > value; --i)
+            {
+                m_heights[i] = m_heights[i - 1];
+            }
+            m_heights[i] = value;
+            return;
+        }
+        ++m_count;
+
+        // Find the cell containing the sample, extending the extremes if needed
+        size_t cell = 0;
+        if (value < m_heights[0])
+        {
+            m_heights[0] = value;
+        }
+        else if (value >= m_heights[MARKERS - 1])
+        {
+            m_heights[MARKERS - 1] = value;
+            cell = MARKERS - 2;
+        }
+        else
+        {
+            while (value >= m_heights[cell + 1])
+            {
+                ++cell;
+            }
+        }
+
+        for (size_t i = cell + 1; i < MARKERS; ++i)
+        {
+            ++m_positions[i];
+        }
+        const std::array<double, MARKERS> increments{0.0, m_quantile / 2.0, m_quantile, (1.0 + m_quantile) / 2.0, 1.0};
+        for (size_t i = 0; i < MARKERS; ++i)
+        {
+            m_desired[i] += increments[i];
+        }
+
+        // Move the middle markers towards their desired positions
+        for (size_t i = 1; i < MARKERS - 1; ++i)
+        {
+            const double offset = m_desired[i] - static_cast<double>(m_positions[i]);
+            if ((offset >= 1.0 && m_positions[i + 1] - m_positions[i] > 1) ||
+                (offset <= -1.0 && m_positions[i - 1] - m_positions[i] < -1))
+            {
+                const int direction = offset >= 0.0 ? 1 : -1;
+                const double candidate = parabolic(i, static_cast<double>(direction));
+                if (m_heights[i - 1] < candidate && candidate < m_heights[i + 1])
+                {
+                    m_heights[i] = candidate;
+                }
+                else
+                {
+                    m_heights[i] = linear(i, direction);
+                }
+                m_positions[i] += direction;
+            }
+        }
+    }
+
+    double P2Quantile::value() const noexcept
+    {
+        if (m_count == 0)
+        {
+            return 0.0;
+        }
+        if (m_count <= MARKERS)
+        {
+            // Exact: nearest-rank on the sorted samples
+            const auto rank = static_cast<size_t>(std::lround(m_quantile * static_cast<double>(m_count - 1)));
+            return m_heights[rank];
+        }
+        return m_heights[2];
+    }
+
+    double P2Quantile::parabolic(size_t i, double direction) const noexcept
+    {
+        const auto below = static_cast<double>(m_positions[i - 1]);
+        const auto here = static_cast<double>(m_positions[i]);
+        const auto above = static_cast<double>(m_positions[i + 1]);
+        return m_heights[i] +
+               (direction / (above - below)) *
+                   (((here - below + direction) * (m_heights[i + 1] - m_heights[i]) / (above - here)) +
+                    ((above - here - direction) * (m_heights[i] - m_heights[i - 1]) / (here - below)));
+    }
+
+    double P2Quantile::linear(size_t i, int direction) const noexcept
+    {
+        const size_t neighbour = direction > 0 ? i + 1 : i - 1;
+        return m_heights[i] + (static_cast<double>(direction) * (m_heights[neighbour] - m_heights[i]) /
+                               static_cast<double>(m_positions[neighbour] - m_positions[i]));
+    }
+
+    void Reservoir::add(uint32_t value) noexcept
+    {
+        ++m_seen;
+        if (m_size < m_capacity)
+        {
+            m_buffer[m_size++] = value;
+            return;
+        }
+        if (m_capacity == 0)
+        {
+            return;
+        }
+
+        const size_t slot = static_cast<size_t>(nextRandom()) % m_seen;
+        if (slot < m_capacity)
+        {
+            m_buffer[slot] = value;
+        }
+    }
+
+    uint32_t Reservoir::nextRandom() noexcept
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    void StreamingStats::add(uint32_t value) noexcept
+    {
+        m_summary.add(value);
+        m_histogram.add(value);
+        const auto sample = static_cast<double>(value);
+        m_p50.add(sample);
+        m_p90.add(sample);
+        m_p99.add(sample);
+        m_p999.add(sample);
+        if (m_reservoir != nullptr)
+        {
+            m_reservoir->add(value);
+        }
+    }
+
+    void StreamingStats::reset() noexcept
+    {
+        m_summary.reset();
+        m_histogram.reset();
+        m_p50.reset();
+        m_p90.reset();
+        m_p99.reset();
+        m_p999.reset();
+        if (m_reservoir != nullptr)
+        {
+            m_reservoir->reset();
+        }
+    }
+} // namespace rtt::benchmark
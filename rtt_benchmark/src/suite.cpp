@@ -0,0 +1,118 @@
+#include <rtt_benchmark/suite.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace rtt::benchmark
+{
+    BenchmarkDefinition::BenchmarkDefinition(const char* name, BenchmarkFunction function, size_t iterations,
+                                             size_t warmup, std::initializer_list<uint32_t> arguments) noexcept :
+        m_name(name), m_function(function), m_iterations(iterations), m_warmup(warmup),
+        m_argumentCount(std::min(arguments.size(), BENCHMARK_MAX_ARGUMENTS))
+    {
+        std::copy_n(arguments.begin(), m_argumentCount, m_arguments.begin());
+        Registry::add(*this);
+    }
+
+    void Registry::add(BenchmarkDefinition& definition) noexcept
+    {
+        if (s_tail == nullptr)
+        {
+            s_head = &definition;
+        }
+        else
+        {
+            s_tail->m_next = &definition;
+        }
+        s_tail = &definition;
+        ++s_count;
+    }
+
+    size_t Suite::run() noexcept
+    {
+        // The host may have connected after an earlier suite run
+        (void)m_sender.sendSchema<BenchmarkResult>();
+
+        size_t sent = 0;
+        for (const BenchmarkDefinition* definition = Registry::first(); definition != nullptr;
+             definition = definition->getNext())
+        {
+            if (std::string_view(definition->getName()).starts_with(m_filter))
+            {
+                sent += run(*definition);
+            }
+        }
+        return sent;
+    }
+
+    size_t Suite::run(const BenchmarkDefinition& definition) noexcept
+    {
+        if (definition.getFunction() == nullptr || definition.getIterations() == 0)
+        {
+            return 0;
+        }
+
+        if (definition.getArgumentCount() == 0)
+        {
+            runOnce(definition, 0, false);
+            return 1;
+        }
+
+        for (size_t i = 0; i < definition.getArgumentCount(); ++i)
+        {
+            runOnce(definition, definition.getArgument(i), true);
+        }
+        return definition.getArgumentCount();
+    }
+
+    size_t Suite::run(const BenchmarkDefinition& definition, uint32_t argument) noexcept
+    {
+        if (definition.getFunction() == nullptr || definition.getIterations() == 0)
+        {
+            return 0;
+        }
+
+        runOnce(definition, argument, definition.getArgumentCount() != 0);
+        return 1;
+    }
+
+    void Suite::runOnce(const BenchmarkDefinition& definition, uint32_t argument, bool parameterized) noexcept
+    {
+        m_result = BenchmarkResult{};
+        if (parameterized)
+        {
+            (void)std::snprintf(m_result.name, sizeof(m_result.name), "%s/%lu", definition.getName(),
+                                static_cast<unsigned long>(argument));
+        }
+        else
+        {
+            (void)std::snprintf(m_result.name, sizeof(m_result.name), "%s", definition.getName());
+        }
+
+        const BenchmarkFunction function = definition.getFunction();
+        m_benchmark.setName(m_result.name);
+        m_benchmark.setWarmup(definition.getWarmup());
+        const BenchmarkStats stats =
+            m_benchmark.run([function, argument]() { function(argument); }, definition.getIterations());
+
+        m_result.argument = argument;
+        m_result.iterations = static_cast<uint32_t>(stats.iterations);
+        m_result.overhead = stats.overhead;
+        m_result.frequency = Timebase::getFrequency();
+        m_result.min = stats.min;
+        m_result.mean = stats.mean;
+        m_result.max = stats.max;
+        m_result.stddev = stats.stddev;
+        m_result.p50 = stats.p50;
+        m_result.p90 = stats.p90;
+        m_result.p99 = stats.p99;
+        m_result.p999 = stats.p999;
+        (void)m_sender.sendStruct(m_result);
+
+        if (m_textReport)
+        {
+            m_benchmark.report(stats);
+        }
+    }
+} // namespace rtt::benchmark
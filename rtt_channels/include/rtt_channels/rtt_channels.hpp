@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef RTT_CHANNELS_MAX_CHANNELS
+#define RTT_CHANNELS_MAX_CHANNELS 3 // SEGGER_RTT_MAX_NUM_UP_BUFFERS or less
+#endif
+
+#ifndef RTT_CHANNELS_ARENA_SIZE
+#define RTT_CHANNELS_ARENA_SIZE 4096 // Bytes shared by all buffers claimed with a size
+#endif
+
+namespace rtt
+{
+    /**
+     * @brief Up-buffer mode, values as SEGGER_RTT_MODE_*
+     */
+    enum class ChannelMode : uint8_t
+    {
+        Skip = 0, // Drop a write that does not fit completely
+        Trim = 1, // Write as much as fits
+        Block = 2 // Wait until the host has read enough
+    };
+
+    /**
+     * @brief Channel number for claims that take the lowest free channel
+     */
+    inline constexpr unsigned ANY_CHANNEL{~0U};
+
+    /**
+     * @brief One up-buffer claim, e.g. an entry of a startup table
+     */
+    struct ChannelConfig
+    {
+        const char* name; // Module or stream name, shown by RTT viewers; must outlive the claim
+        unsigned channel; // Channel number or ANY_CHANNEL
+        uint32_t size; // Buffer size in bytes; 0 for channel 0, which keeps SEGGER's terminal buffer
+        ChannelMode mode;
+    };
+
+    /**
+     * @brief A claimed up-buffer
+     */
+    struct ChannelInfo
+    {
+        const char* name; // nullptr: unclaimed
+        char* buffer;
+        uint32_t size;
+        ChannelMode mode;
+        bool fromArena; // Allocated by the manager (false: module-owned or SEGGER's terminal buffer)
+    };
+
+    /**
+     * @brief Central owner of the RTT up-buffers
+     *
+     * Modules claim a named up-buffer with a size and mode instead of
+     * configuring SEGGER's control block themselves, so two streams can no
+     * longer end up on the same channel and all buffer sizes are set in one
+     * place. Buffers come from one static arena (RTT_CHANNELS_ARENA_SIZE);
+     * modules with a buffer of their own, like the FreeRTOS trace, adopt it.
+     *
+     * Claims survive SEGGER_RTT_Init(): initialize() reinitializes RTT and
+     * configures every claimed channel again. Logger::initialize() and
+     * rtt_trace_init() call it, so a table claimed before them stays in place.
+     *
+     * Claims are made from startup code; the functions are not thread-safe
+     * and the arena is never freed, except by reset().
+     *
+     * @code
+     * constexpr rtt::ChannelConfig CHANNELS[] = {
+     *     {"Terminal", 0, 0, rtt::ChannelMode::Skip},
+     *     {"Data", 1, 1024, rtt::ChannelMode::Skip},
+     *     {"Profiler", 2, 512, rtt::ChannelMode::Trim},
+     * };
+     * static_assert(rtt::ChannelManager::isValid(CHANNELS));
+     *
+     * rtt::ChannelManager::configure(CHANNELS);
+     * rtt::ChannelManager::announce(); // Descriptor table on channel 0
+     * @endcode
+     */
+    class ChannelManager
+    {
+    public:
+        static constexpr unsigned MAX_CHANNELS{RTT_CHANNELS_MAX_CHANNELS};
+        static constexpr size_t ARENA_SIZE{RTT_CHANNELS_ARENA_SIZE};
+        static constexpr size_t ARENA_ALIGNMENT{4}; // Each arena buffer starts word-aligned
+
+        /**
+         * @brief Initialize RTT (SEGGER_RTT_Init()) and configure every claimed channel again
+         */
+        static void initialize() noexcept;
+
+        /**
+         * @brief Claim an up-buffer from the arena
+         *
+         * Claiming a channel again under the same name reconfigures it and
+         * keeps its buffer if the size fits, so modules may claim on every
+         * initialization.
+         *
+         * @param name Stream name, must outlive the claim (a string literal)
+         * @param channel Channel number, ANY_CHANNEL for the lowest free one above 0
+         * @param size Buffer size in bytes, 0 for channel 0
+         * @param mode Up-buffer mode
+         * @return Channel number, or -1 if the channel belongs to another name, no channel is free or the arena is
+         * exhausted
+         */
+        static int claim(const char* name, unsigned channel, uint32_t size, ChannelMode mode) noexcept;
+
+        /**
+         * @brief Claim an up-buffer from a table entry
+         */
+        static int claim(const ChannelConfig& config) noexcept
+        {
+            return claim(config.name, config.channel, config.size, config.mode);
+        }
+
+        /**
+         * @brief Claim an up-buffer the module owns
+         *
+         * Same rules as claim(), but the buffer is not taken from the arena.
+         *
+         * @return Channel number, or -1 as for claim()
+         */
+        static int adopt(const char* name, unsigned channel, char* buffer, uint32_t size, ChannelMode mode) noexcept;
+
+        /**
+         * @brief Claim every entry of a table
+         * @return True if every entry was claimed
+         */
+        template <size_t N>
+        static bool configure(const ChannelConfig (&table)[N]) noexcept
+        {
+            bool claimed = true;
+            for (const ChannelConfig& config : table)
+            {
+                claimed = claim(config) >= 0 && claimed;
+            }
+            return claimed;
+        }
+
+        /**
+         * @brief Check a table at compile time
+         *
+         * Valid if channels and names are unique, channel 0 has size 0, the
+         * other entries have a size and all arena buffers fit into the arena.
+         */
+        template <size_t N>
+        [[nodiscard]] static constexpr bool isValid(const ChannelConfig (&table)[N]) noexcept
+        {
+            size_t arena = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                const ChannelConfig& config = table[i];
+                if (config.name == nullptr || (config.channel >= MAX_CHANNELS && config.channel != ANY_CHANNEL))
+                {
+                    return false;
+                }
+                if (config.channel == 0 ? config.size != 0 : config.size < 2)
+                {
+                    return false;
+                }
+                arena += alignedSize(config.size);
+                for (size_t j = 0; j < i; ++j)
+                {
+                    if ((config.channel != ANY_CHANNEL && table[j].channel == config.channel) ||
+                        isSameName(table[j].name, config.name))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return arena <= ARENA_SIZE;
+        }
+
+        /**
+         * @brief Change the mode of a claimed channel
+         * @return False if the channel is not claimed
+         */
+        static bool setMode(unsigned channel, ChannelMode mode) noexcept;
+
+        /**
+         * @brief Find a configured up-buffer by name
+         *
+         * Looks at SEGGER's control block, so buffers configured without the
+         * manager are found too.
+         *
+         * @return Channel number, or -1 if no up-buffer has this name
+         */
+        [[nodiscard]] static int find(const char* name) noexcept;
+
+        /**
+         * @brief Claim of a channel
+         * @return Claim, or nullptr if the channel is not claimed
+         */
+        [[nodiscard]] static const ChannelInfo* getInfo(unsigned channel) noexcept;
+
+        /**
+         * @brief Arena bytes handed out so far
+         */
+        [[nodiscard]] static size_t getArenaUsed() noexcept;
+
+        /**
+         * @brief Write the descriptor table of all configured up-buffers
+         *
+         * One text block host tools use to find channels by name
+         * (scripts/rtt_reader.py --channel-name):
+         *
+         *     RTT_CHANNELS 3
+         *     RTT_CHANNEL 0 1024 skip Terminal
+         *     RTT_CHANNEL 1 1024 skip Data
+         *     RTT_CHANNEL 2 2048 skip FreeRTOS Trace
+         *
+         * @param channel Channel to write the table to
+         * @return Bytes written
+         */
+        static size_t announce(unsigned channel = 0) noexcept;
+
+        /**
+         * @brief Forget all claims and free the arena (the control block is not touched)
+         */
+        static void reset() noexcept;
+
+    private:
+        [[nodiscard]] static constexpr size_t alignedSize(uint32_t size) noexcept
+        {
+            return (static_cast<size_t>(size) + ARENA_ALIGNMENT - 1U) & ~(ARENA_ALIGNMENT - 1U);
+        }
+
+        [[nodiscard]] static constexpr bool isSameName(const char* first, const char* second) noexcept
+        {
+            while (*first != '\0' && *first == *second)
+            {
+                ++first;
+                ++second;
+            }
+            return *first == *second;
+        }
+
+        static int place(const char* name, unsigned channel, char* buffer, uint32_t size, ChannelMode mode) noexcept;
+        static void apply(unsigned channel) noexcept;
+
+        static ChannelInfo s_channels[MAX_CHANNELS];
+        static size_t s_arenaUsed;
+    };
+} // namespace rtt
@@ -0,0 +1,281 @@
+#include <rtt_channels/rtt_channels.hpp>
+#include <cstring>
+#include "SEGGER_RTT.h"
+
+static_assert(RTT_CHANNELS_MAX_CHANNELS <= SEGGER_RTT_MAX_NUM_UP_BUFFERS,
+              "RTT_CHANNELS_MAX_CHANNELS exceeds SEGGER_RTT_MAX_NUM_UP_BUFFERS");
+static_assert(static_cast<unsigned>(rtt::ChannelMode::Skip) == SEGGER_RTT_MODE_NO_BLOCK_SKIP &&
+                  static_cast<unsigned>(rtt::ChannelMode::Trim) == SEGGER_RTT_MODE_NO_BLOCK_TRIM &&
+                  static_cast<unsigned>(rtt::ChannelMode::Block) == SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL,
+              "ChannelMode must match SEGGER_RTT_MODE_*");
+
+namespace rtt
+{
+    namespace
+    {
+        constexpr size_t LINE_SIZE{64}; // One descriptor line; longer names are cut
+
+        alignas(ChannelManager::ARENA_ALIGNMENT) char s_arena[ChannelManager::ARENA_SIZE];
+
+        [[nodiscard]] bool isConfigured(const SEGGER_RTT_BUFFER_UP& up) noexcept
+        {
+            return up.pBuffer != nullptr && up.SizeOfBuffer != 0;
+        }
+
+        [[nodiscard]] const char* modeName(unsigned flags) noexcept
+        {
+            switch (flags & SEGGER_RTT_MODE_MASK)
+            {
+            case SEGGER_RTT_MODE_NO_BLOCK_SKIP:
+                return "skip";
+            case SEGGER_RTT_MODE_NO_BLOCK_TRIM:
+                return "trim";
+            case SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL:
+                return "block";
+            default:
+                return "unknown";
+            }
+        }
+
+        /**
+         * @brief Append text, cut at the end of the line buffer
+         */
+        size_t appendText(char* line, size_t length, const char* text) noexcept
+        {
+            while (*text != '\0' && length < LINE_SIZE - 1U)
+            {
+                line[length++] = *text++;
+            }
+            return length;
+        }
+
+        size_t appendUnsigned(char* line, size_t length, unsigned value) noexcept
+        {
+            char digits[10];
+            size_t count = 0;
+            do
+            {
+                digits[count++] = static_cast<char>('0' + (value % 10U));
+                value /= 10U;
+            } while (value != 0U);
+
+            while (count != 0U && length < LINE_SIZE - 1U)
+            {
+                line[length++] = digits[--count];
+            }
+            return length;
+        }
+
+        size_t writeLine(unsigned channel, char* line, size_t length) noexcept
+        {
+            line[length++] = '\n';
+            return SEGGER_RTT_Write(channel, line, static_cast<unsigned>(length));
+        }
+    } // namespace
+
+    ChannelInfo ChannelManager::s_channels[MAX_CHANNELS]{};
+    size_t ChannelManager::s_arenaUsed{0};
+
+    void ChannelManager::initialize() noexcept
+    {
+        SEGGER_RTT_Init();
+        for (unsigned channel = 0; channel < MAX_CHANNELS; ++channel)
+        {
+            if (s_channels[channel].name != nullptr)
+            {
+                apply(channel);
+            }
+        }
+    }
+
+    int ChannelManager::claim(const char* name, unsigned channel, uint32_t size, ChannelMode mode) noexcept
+    {
+        return place(name, channel, nullptr, size, mode);
+    }
+
+    int ChannelManager::adopt(const char* name, unsigned channel, char* buffer, uint32_t size,
+                              ChannelMode mode) noexcept
+    {
+        if (buffer == nullptr)
+        {
+            return -1;
+        }
+        return place(name, channel, buffer, size, mode);
+    }
+
+    int ChannelManager::place(const char* name, unsigned channel, char* buffer, uint32_t size,
+                              ChannelMode mode) noexcept
+    {
+        if (name == nullptr)
+        {
+            return -1;
+        }
+
+        unsigned claimed = MAX_CHANNELS;
+        for (unsigned index = 0; index < MAX_CHANNELS; ++index)
+        {
+            if (s_channels[index].name != nullptr && isSameName(s_channels[index].name, name))
+            {
+                claimed = index;
+            }
+        }
+
+        if (channel == ANY_CHANNEL)
+        {
+            // Lowest channel nobody claimed or configured directly; channel 0 is the terminal
+            channel = claimed;
+            for (unsigned index = 1; index < MAX_CHANNELS && channel == MAX_CHANNELS; ++index)
+            {
+                if (s_channels[index].name == nullptr && !isConfigured(_SEGGER_RTT.aUp[index]))
+                {
+                    channel = index;
+                }
+            }
+        }
+        if (channel >= MAX_CHANNELS || (claimed != MAX_CHANNELS && claimed != channel))
+        {
+            return -1;
+        }
+
+        ChannelInfo& info = s_channels[channel];
+        if (info.name != nullptr && !isSameName(info.name, name))
+        {
+            return -1; // Claimed by another stream
+        }
+
+        bool fromArena = false;
+        if (channel == 0)
+        {
+            // SEGGER keeps the terminal buffer of channel 0 (BUFFER_SIZE_UP), only its mode can change
+            if (size != 0 || buffer != nullptr)
+            {
+                return -1;
+            }
+        }
+        else if (size < 2)
+        {
+            return -1;
+        }
+        else if (buffer == nullptr)
+        {
+            fromArena = true;
+            if (info.fromArena && info.size >= size)
+            {
+                buffer = info.buffer;
+            }
+            else if (alignedSize(size) <= ARENA_SIZE - s_arenaUsed)
+            {
+                buffer = &s_arena[s_arenaUsed];
+                s_arenaUsed += alignedSize(size);
+            }
+            else
+            {
+                return -1;
+            }
+        }
+
+        info.name = name;
+        info.buffer = buffer;
+        info.size = size;
+        info.mode = mode;
+        info.fromArena = fromArena;
+        apply(channel);
+        return static_cast<int>(channel);
+    }
+
+    void ChannelManager::apply(unsigned channel) noexcept
+    {
+        const ChannelInfo& info = s_channels[channel];
+        if (channel == 0)
+        {
+            SEGGER_RTT_SetFlagsUpBuffer(0, static_cast<unsigned>(info.mode));
+        }
+        else
+        {
+            SEGGER_RTT_ConfigUpBuffer(channel, info.name, info.buffer, info.size, static_cast<unsigned>(info.mode));
+        }
+    }
+
+    bool ChannelManager::setMode(unsigned channel, ChannelMode mode) noexcept
+    {
+        if (channel >= MAX_CHANNELS || s_channels[channel].name == nullptr)
+        {
+            return false;
+        }
+        s_channels[channel].mode = mode;
+        SEGGER_RTT_SetFlagsUpBuffer(channel, static_cast<unsigned>(mode));
+        return true;
+    }
+
+    int ChannelManager::find(const char* name) noexcept
+    {
+        if (name == nullptr)
+        {
+            return -1;
+        }
+        for (unsigned channel = 0; channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS; ++channel)
+        {
+            const SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[channel];
+            if (isConfigured(up) && up.sName != nullptr && std::strcmp(up.sName, name) == 0)
+            {
+                return static_cast<int>(channel);
+            }
+        }
+        return -1;
+    }
+
+    const ChannelInfo* ChannelManager::getInfo(unsigned channel) noexcept
+    {
+        if (channel >= MAX_CHANNELS || s_channels[channel].name == nullptr)
+        {
+            return nullptr;
+        }
+        return &s_channels[channel];
+    }
+
+    size_t ChannelManager::getArenaUsed() noexcept
+    {
+        return s_arenaUsed;
+    }
+
+    size_t ChannelManager::announce(unsigned channel) noexcept
+    {
+        unsigned count = 0;
+        for (const SEGGER_RTT_BUFFER_UP& up : _SEGGER_RTT.aUp)
+        {
+            count += isConfigured(up) ? 1U : 0U;
+        }
+
+        char line[LINE_SIZE];
+        size_t length = appendText(line, 0, "RTT_CHANNELS ");
+        size_t written = writeLine(channel, line, appendUnsigned(line, length, count));
+
+        for (unsigned index = 0; index < SEGGER_RTT_MAX_NUM_UP_BUFFERS; ++index)
+        {
+            const SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[index];
+            if (!isConfigured(up))
+            {
+                continue;
+            }
+            length = appendText(line, 0, "RTT_CHANNEL ");
+            length = appendUnsigned(line, length, index);
+            length = appendText(line, length, " ");
+            length = appendUnsigned(line, length, up.SizeOfBuffer);
+            length = appendText(line, length, " ");
+            length = appendText(line, length, modeName(up.Flags));
+            length = appendText(line, length, " ");
+            length = appendText(line, length, up.sName != nullptr ? up.sName : "");
+            written += writeLine(channel, line, length);
+        }
+        return written;
+    }
+
+    void ChannelManager::reset() noexcept
+    {
+        for (ChannelInfo& info : s_channels)
+        {
+            info = ChannelInfo{};
+        }
+        s_arenaUsed = 0;
+    }
+} // namespace rtt
@@ -0,0 +1,135 @@
+#pragma once
+
+/**
+ * @file rtt_control.hpp
+ * @brief Host-to-target control commands over an RTT down-buffer
+ *
+ * Reconfigures the instrumentation at run time: log level, FreeRTOS trace
+ * on/off and category mask, registry resend, flight recorder dump and
+ * enable/decimation of data streams, so everything can stay compiled in but
+ * quiet until it is needed.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Execute the commands received so far (for FreeRtosHooks::addIdleCallback() or C code)
+ */
+void rtt_control_poll(void);
+
+#ifdef __cplusplus
+}
+
+#include <rtt_data/rtt_data.hpp>
+#include <rtt_logger/rtt_logger.hpp>
+
+#ifndef RTT_CONTROL_MAX_LINE
+#define RTT_CONTROL_MAX_LINE 64 // Longest command line in bytes, including the line ending
+#endif
+
+#ifndef RTT_CONTROL_MAX_STREAMS
+#define RTT_CONTROL_MAX_STREAMS 4 // Data streams addressable with "data <name> ..."
+#endif
+
+#ifndef RTT_CONTROL_BUFFER_SIZE
+#define RTT_CONTROL_BUFFER_SIZE 64 // Down-buffer configured for channels other than 0
+#endif
+
+namespace rtt::control
+{
+    /**
+     * @brief Text command interpreter on an RTT down-buffer
+     *
+     * The host writes one command per line, e.g. from the J-Link RTT Viewer
+     * terminal or with `rtt_reader.py --command`:
+     *
+     *     log <trace|debug|info|warn|error|crit>   Logger minimum level
+     *     trace start | trace stop                 FreeRtosTrace::start()/stop()
+     *     trace mask <all|none|task|isr|queue|semaphore|mutex|timer|heap|number>...
+     *     trace registry                           Resend the task registry
+     *     trace snapshot                           Dump the flight recorder
+     *     data <stream> on | off                   Enable a registered DataSender
+     *     data <stream> every <n>                  Send every n-th sample only
+     *
+     * Every line is answered on the reply channel with
+     * `RTT_CONTROL OK <command>` or `RTT_CONTROL ERR <reason>: <command>`.
+     *
+     * Commands run from poll(), so they execute in the context that polls:
+     * the idle hook (FreeRtosHooks::addIdleCallback(rtt_control_poll)) or a
+     * low-priority task. The functions are not thread-safe; configure and poll
+     * from one context.
+     *
+     * @code
+     * rtt::Logger::initialize();
+     * rtt::control::Control::initialize();
+     * rtt::control::Control::addStream("adc", adcSender);
+     * rtt::freertos::FreeRtosHooks::addIdleCallback(rtt_control_poll);
+     * @endcode
+     */
+    class Control
+    {
+    public:
+        static constexpr size_t MAX_LINE{RTT_CONTROL_MAX_LINE};
+        static constexpr size_t MAX_STREAMS{RTT_CONTROL_MAX_STREAMS};
+        static constexpr size_t BUFFER_SIZE{RTT_CONTROL_BUFFER_SIZE};
+
+        /**
+         * @brief Select the channels and discard partial input
+         *
+         * Channel 0 uses SEGGER's terminal down-buffer (BUFFER_SIZE_DOWN);
+         * other channels get a down-buffer of RTT_CONTROL_BUFFER_SIZE bytes.
+         * SEGGER_RTT_Init() forgets down-buffers, so call this after
+         * Logger::initialize().
+         *
+         * @param channel Down-buffer the commands arrive on
+         * @param replyChannel Up-buffer for the replies
+         * @return False if the down-buffer does not exist
+         */
+        static bool initialize(unsigned channel = 0, unsigned replyChannel = 0) noexcept;
+
+        /**
+         * @brief Read the down-buffer and execute complete lines
+         * @return Number of lines executed
+         */
+        static size_t poll() noexcept;
+
+        /**
+         * @brief Execute one command line without the line ending
+         * @return True if the command was valid and executed
+         */
+        static bool execute(const char* line, size_t length) noexcept;
+
+        /**
+         * @brief Logger changed by the log command (default: getLogger())
+         */
+        static void setLogger(Logger& logger) noexcept;
+
+        /**
+         * @brief Make a DataSender addressable as "data <name> ..."
+         *
+         * Registering a name again replaces its sender.
+         *
+         * @param name Stream name without spaces, must outlive the registration (a string literal)
+         * @return False if the name is invalid or all MAX_STREAMS slots are used
+         */
+        static bool addStream(const char* name, data::DataSender& sender) noexcept;
+
+        /**
+         * @brief Find a registered stream
+         * @return Sender, or nullptr if no stream has this name
+         */
+        [[nodiscard]] static data::DataSender* findStream(const char* name) noexcept;
+
+        /**
+         * @brief Forget streams and partial input and restore the defaults (for tests)
+         */
+        static void reset() noexcept;
+    };
+} // namespace rtt::control
+
+#endif // __cplusplus
@@ -0,0 +1,452 @@
+#include <rtt_control/rtt_control.hpp>
+#include <rtt_freertos_trace/rtt_freertos_trace.hpp>
+#include <cstring>
+#include "SEGGER_RTT.h"
+
+namespace rtt::control
+{
+    namespace
+    {
+        constexpr size_t MAX_TOKENS{10}; // "trace mask" followed by every category
+        constexpr size_t REPLY_SIZE{Control::MAX_LINE + 48};
+        constexpr size_t READ_CHUNK{16};
+
+        struct Stream
+        {
+            const char* name; // nullptr: free slot
+            data::DataSender* sender;
+        };
+
+        struct NamedValue
+        {
+            const char* name;
+            uint32_t value;
+        };
+
+        constexpr NamedValue LEVELS[] = {
+            {"trace", static_cast<uint32_t>(LogLevel::Trace)},
+            {"debug", static_cast<uint32_t>(LogLevel::Debug)},
+            {"info", static_cast<uint32_t>(LogLevel::Info)},
+            {"warn", static_cast<uint32_t>(LogLevel::Warning)},
+            {"warning", static_cast<uint32_t>(LogLevel::Warning)},
+            {"error", static_cast<uint32_t>(LogLevel::Error)},
+            {"crit", static_cast<uint32_t>(LogLevel::Critical)},
+            {"critical", static_cast<uint32_t>(LogLevel::Critical)},
+        };
+
+        constexpr NamedValue CATEGORIES[] = {
+            {"all", TRACE_CATEGORY_ALL},
+            {"none", 0},
+            {"task", TRACE_CATEGORY_TASK},
+            {"isr", TRACE_CATEGORY_ISR},
+            {"queue", TRACE_CATEGORY_QUEUE},
+            {"semaphore", TRACE_CATEGORY_SEMAPHORE},
+            {"mutex", TRACE_CATEGORY_MUTEX},
+            {"timer", TRACE_CATEGORY_TIMER},
+            {"heap", TRACE_CATEGORY_HEAP},
+        };
+
+        unsigned s_channel{0};
+        unsigned s_replyChannel{0};
+        Logger* s_logger{nullptr}; // nullptr: getLogger()
+        Stream s_streams[Control::MAX_STREAMS]{};
+        char s_line[Control::MAX_LINE];
+        size_t s_length{0};
+        bool s_overflow{false}; // The current line is longer than MAX_LINE and is discarded
+        char s_downBuffer[Control::BUFFER_SIZE];
+
+        [[nodiscard]] bool isEqual(const char* first, const char* second) noexcept
+        {
+            return std::strcmp(first, second) == 0;
+        }
+
+        /**
+         * @brief Parse a decimal or 0x-prefixed hexadecimal number
+         */
+        [[nodiscard]] bool parseUnsigned(const char* text, uint32_t& value) noexcept
+        {
+            uint32_t base = 10;
+            if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+            {
+                base = 16;
+                text += 2;
+            }
+            if (*text == '\0')
+            {
+                return false;
+            }
+
+            uint32_t result = 0;
+            for (; *text != '\0'; ++text)
+            {
+                uint32_t digit = 0;
+                if (*text >= '0' && *text <= '9')
+                {
+                    digit = static_cast<uint32_t>(*text - '0');
+                }
+                else if (base == 16 && *text >= 'a' && *text <= 'f')
+                {
+                    digit = static_cast<uint32_t>(*text - 'a' + 10);
+                }
+                else if (base == 16 && *text >= 'A' && *text <= 'F')
+                {
+                    digit = static_cast<uint32_t>(*text - 'A' + 10);
+                }
+                else
+                {
+                    return false;
+                }
+                if (result > (UINT32_MAX - digit) / base)
+                {
+                    return false;
+                }
+                result = result * base + digit;
+            }
+            value = result;
+            return true;
+        }
+
+        /**
+         * @brief Look up a name or parse a number
+         */
+        template <size_t N>
+        [[nodiscard]] bool parseValue(const char* text, const NamedValue (&names)[N], uint32_t& value) noexcept
+        {
+            for (const NamedValue& entry : names)
+            {
+                if (isEqual(text, entry.name))
+                {
+                    value = entry.value;
+                    return true;
+                }
+            }
+            return parseUnsigned(text, value);
+        }
+
+        void reply(const char* status, const char* reason, const char* line, size_t length) noexcept
+        {
+            char text[REPLY_SIZE];
+            size_t size = 0;
+            const auto append = [&text, &size](const char* data, size_t count) {
+                count = count < sizeof(text) - 1U - size ? count : sizeof(text) - 1U - size;
+                std::memcpy(&text[size], data, count);
+                size += count;
+            };
+
+            append("RTT_CONTROL ", 12);
+            append(status, std::strlen(status));
+            append(" ", 1);
+            if (reason != nullptr)
+            {
+                append(reason, std::strlen(reason));
+                append(": ", 2);
+            }
+            append(line, length);
+            text[size++] = '\n';
+            SEGGER_RTT_Write(s_replyChannel, text, static_cast<unsigned>(size));
+        }
+
+        const char* runLog(const char* const* tokens, size_t count) noexcept
+        {
+            uint32_t level = 0;
+            if (count != 2)
+            {
+                return "usage: log <level>";
+            }
+            if (!parseValue(tokens[1], LEVELS, level) || level > static_cast<uint32_t>(LogLevel::Critical))
+            {
+                return "invalid level";
+            }
+            Logger& logger = s_logger != nullptr ? *s_logger : getLogger();
+            logger.setMinLevel(static_cast<LogLevel>(level));
+            return nullptr;
+        }
+
+        const char* runTrace(const char* const* tokens, size_t count) noexcept
+        {
+            if (count < 2)
+            {
+                return "usage: trace <start|stop|mask|registry|snapshot>";
+            }
+
+            const char* action = tokens[1];
+            if (isEqual(action, "mask"))
+            {
+                if (count < 3)
+                {
+                    return "usage: trace mask <category>...";
+                }
+                uint32_t mask = 0;
+                for (size_t i = 2; i < count; ++i)
+                {
+                    uint32_t category = 0;
+                    if (!parseValue(tokens[i], CATEGORIES, category) || (category & ~TRACE_CATEGORY_ALL) != 0U)
+                    {
+                        return "invalid category";
+                    }
+                    mask |= category;
+                }
+                trace::FreeRtosTrace::setCategoryMask(mask);
+                return nullptr;
+            }
+            if (count != 2)
+            {
+                return "unexpected argument";
+            }
+
+            if (isEqual(action, "start"))
+            {
+                trace::FreeRtosTrace::start();
+                return trace::FreeRtosTrace::isEnabled() ? nullptr : "trace not initialized";
+            }
+            if (isEqual(action, "stop"))
+            {
+                trace::FreeRtosTrace::stop();
+                return nullptr;
+            }
+            if (isEqual(action, "registry"))
+            {
+                trace::FreeRtosTrace::requestRegistry();
+                return nullptr;
+            }
+            if (isEqual(action, "snapshot"))
+            {
+                trace::FreeRtosTrace::dumpFlightRecorder();
+                return nullptr;
+            }
+            return "unknown trace command";
+        }
+
+        const char* runData(const char* const* tokens, size_t count) noexcept
+        {
+            if (count < 3)
+            {
+                return "usage: data <stream> <on|off|every n>";
+            }
+
+            data::DataSender* sender = Control::findStream(tokens[1]);
+            if (sender == nullptr)
+            {
+                return "unknown stream";
+            }
+
+            const char* action = tokens[2];
+            if (isEqual(action, "every"))
+            {
+                uint32_t factor = 0;
+                if (count != 4 || !parseUnsigned(tokens[3], factor) || factor == 0)
+                {
+                    return "invalid factor";
+                }
+                sender->setDecimation(factor);
+                return nullptr;
+            }
+            if (count != 3)
+            {
+                return "unexpected argument";
+            }
+            if (isEqual(action, "on") || isEqual(action, "off"))
+            {
+                sender->setEnabled(isEqual(action, "on"));
+                return nullptr;
+            }
+            return "unknown data command";
+        }
+    } // namespace
+
+    bool Control::initialize(unsigned channel, unsigned replyChannel) noexcept
+    {
+        s_length = 0;
+        s_overflow = false;
+        if (channel >= SEGGER_RTT_MAX_NUM_DOWN_BUFFERS || replyChannel >= SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+        {
+            return false;
+        }
+        if (channel != 0 &&
+            SEGGER_RTT_ConfigDownBuffer(channel, "Control", s_downBuffer, sizeof(s_downBuffer),
+                                        SEGGER_RTT_MODE_NO_BLOCK_SKIP) < 0)
+        {
+            return false;
+        }
+        s_channel = channel;
+        s_replyChannel = replyChannel;
+        return true;
+    }
+
+    size_t Control::poll() noexcept
+    {
+        size_t executed = 0;
+        char chunk[READ_CHUNK];
+        unsigned received = 0;
+        while ((received = SEGGER_RTT_Read(s_channel, chunk, sizeof(chunk))) > 0)
+        {
+            for (unsigned i = 0; i < received; ++i)
+            {
+                const char c = chunk[i];
+                if (c == '\r')
+                {
+                    continue;
+                }
+                if (c != '\n')
+                {
+                    if (s_length < MAX_LINE - 1U)
+                    {
+                        s_line[s_length++] = c;
+                    }
+                    else
+                    {
+                        s_overflow = true;
+                    }
+                    continue;
+                }
+
+                if (s_overflow)
+                {
+                    reply("ERR", "line too long", s_line, s_length);
+                }
+                else if (s_length > 0)
+                {
+                    execute(s_line, s_length);
+                }
+                executed += (s_overflow || s_length > 0) ? 1U : 0U;
+                s_length = 0;
+                s_overflow = false;
+            }
+        }
+        return executed;
+    }
+
+    bool Control::execute(const char* line, size_t length) noexcept
+    {
+        if (line == nullptr || length >= MAX_LINE)
+        {
+            reply("ERR", "line too long", line != nullptr ? line : "", line != nullptr ? MAX_LINE - 1U : 0U);
+            return false;
+        }
+
+        // Split a copy in place into NUL-terminated tokens
+        char text[MAX_LINE];
+        std::memcpy(text, line, length);
+        text[length] = '\0';
+        const char* tokens[MAX_TOKENS];
+        size_t count = 0;
+        bool tooMany = false;
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (text[i] == ' ' || text[i] == '\t')
+            {
+                text[i] = '\0';
+            }
+            else if (i == 0 || text[i - 1] == '\0')
+            {
+                if (count == MAX_TOKENS)
+                {
+                    tooMany = true;
+                    break;
+                }
+                tokens[count++] = &text[i];
+            }
+        }
+
+        const char* error = nullptr;
+        if (count == 0)
+        {
+            error = "empty command";
+        }
+        else if (tooMany)
+        {
+            error = "too many arguments";
+        }
+        else if (isEqual(tokens[0], "log"))
+        {
+            error = runLog(tokens, count);
+        }
+        else if (isEqual(tokens[0], "trace"))
+        {
+            error = runTrace(tokens, count);
+        }
+        else if (isEqual(tokens[0], "data"))
+        {
+            error = runData(tokens, count);
+        }
+        else
+        {
+            error = "unknown command";
+        }
+
+        if (error != nullptr)
+        {
+            reply("ERR", error, line, length);
+            return false;
+        }
+        reply("OK", nullptr, line, length);
+        return true;
+    }
+
+    void Control::setLogger(Logger& logger) noexcept
+    {
+        s_logger = &logger;
+    }
+
+    bool Control::addStream(const char* name, data::DataSender& sender) noexcept
+    {
+        if (name == nullptr || *name == '\0' || std::strpbrk(name, " \t") != nullptr)
+        {
+            return false;
+        }
+
+        Stream* free = nullptr;
+        for (Stream& stream : s_streams)
+        {
+            if (stream.name != nullptr && isEqual(stream.name, name))
+            {
+                stream.sender = &sender;
+                return true;
+            }
+            if (stream.name == nullptr && free == nullptr)
+            {
+                free = &stream;
+            }
+        }
+        if (free == nullptr)
+        {
+            return false;
+        }
+        *free = Stream{name, &sender};
+        return true;
+    }
+
+    data::DataSender* Control::findStream(const char* name) noexcept
+    {
+        if (name == nullptr)
+        {
+            return nullptr;
+        }
+        for (const Stream& stream : s_streams)
+        {
+            if (stream.name != nullptr && isEqual(stream.name, name))
+            {
+                return stream.sender;
+            }
+        }
+        return nullptr;
+    }
+
+    void Control::reset() noexcept
+    {
+        for (Stream& stream : s_streams)
+        {
+            stream = Stream{};
+        }
+        s_channel = 0;
+        s_replyChannel = 0;
+        s_logger = nullptr;
+        s_length = 0;
+        s_overflow = false;
+    }
+} // namespace rtt::control
+
+extern "C" void rtt_control_poll(void)
+{
+    rtt::control::Control::poll();
+}
@@ -1,6 +1,20 @@
 #include <rtt_data/rtt_data.hpp>
 #include <rtt_logger/rtt_logger.hpp>
 
+/**
+ * Struct with a registered schema: the host decodes its fields by name
+ */
+struct MotorState
+{
+    float current[3];
+    int32_t position;
+    uint16_t speed;
+    uint8_t fault;
+};
+
+RTT_DATA_SCHEMA(MotorState, 1, RTT_DATA_FIELD(current), RTT_DATA_FIELD(position), RTT_DATA_FIELD(speed),
+                RTT_DATA_FIELD(fault));
+
 /**
  * Example demonstrating RTT data transmission
  *
@@ -72,6 +86,28 @@ int main()
     dataSender.sendBinary(dataSpan);
 #endif
 
+    // Example 8: Send a buffer of samples under one header per packet
+    logger.info("Sending sample array...");
+    constexpr int16_t waveform[] = {0, 707, 1000, 707, 0, -707, -1000, -707};
+    dataSender.sendArray(waveform);
+
+    // Example 9: Batch samples as they are produced, one RTT write per block
+    logger.info("Streaming samples in blocks...");
+    rtt::data::SampleBlock<uint16_t, 32> block(dataSender);
+    for (uint16_t i = 0; i < 100; ++i)
+    {
+        block.push(static_cast<uint16_t>(i * 40));
+    }
+    block.flush();
+
+    // Example 10: Registered struct, the schema is sent once before the first sample
+    logger.info("Sending registered struct samples...");
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        const MotorState state{{0.5f, -0.25f, -0.25f}, i * 100, 1500, 0};
+        dataSender.send(state);
+    }
+
     logger.info("RTT Data Example Completed");
 
     return 0;
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string_view>
 #include <type_traits>
+#include <rtt_channels/rtt_channels.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
 
 #if __cplusplus >= 202002L
 #include <span>
@@ -31,7 +36,11 @@ namespace rtt::data
         Float,
         Double,
         String,
-        Binary
+        Binary,
+        Array, // Packed samples of one numeric type, element type in DataHeader::subtype
+        Schema, // Field layout of a registered struct, schema ID in DataHeader::subtype
+        Struct, // Raw bytes of a registered struct, schema ID in DataHeader::subtype
+        Memory // Target memory: start address (DataHeader::subtype bytes, little-endian), then the bytes
     };
 
     /**
@@ -41,14 +50,70 @@ namespace rtt::data
     {
         uint8_t magic[2]; // Magic bytes: 'R', 'D' (RTT Data)
         DataType type; // Data type
-        uint8_t reserved; // Reserved for future use
+        uint8_t subtype; // Array: element DataType, Schema/Struct: schema ID, 0 otherwise
         uint32_t size; // Data size in bytes
-        uint32_t timestamp; // Timestamp (optional, 0 if not used)
+        uint32_t timestamp; // Timebase ticks (low 32 bits), 0 if timestamping is disabled
     } __attribute__((packed));
 
     static constexpr uint8_t DATA_MAGIC_0 = 'R';
     static constexpr uint8_t DATA_MAGIC_1 = 'D';
 
+#ifndef RTT_DATA_MAX_PACKET_SIZE
+#define RTT_DATA_MAX_PACKET_SIZE 256
+#endif
+    /// Largest packet (header and payload) assembled on the stack and sent with one RTT write
+    static constexpr size_t DATA_MAX_PACKET_SIZE{RTT_DATA_MAX_PACKET_SIZE};
+    static_assert(DATA_MAX_PACKET_SIZE >= sizeof(DataHeader) + sizeof(uint64_t),
+                  "Data packet size too small for a header and one 64-bit value");
+
+#ifndef RTT_DATA_MEMORY_CHUNK_SIZE
+#define RTT_DATA_MEMORY_CHUNK_SIZE 1024
+#endif
+    /// Largest payload of one Memory packet; larger regions are split into several packets
+    static constexpr size_t DATA_MEMORY_CHUNK_SIZE{RTT_DATA_MEMORY_CHUNK_SIZE};
+    static_assert(DATA_MEMORY_CHUNK_SIZE > 0, "Memory chunk size must not be zero");
+
+#ifndef RTT_DATA_BUFFER_SIZE
+#define RTT_DATA_BUFFER_SIZE 1024
+#endif
+    /// Up-buffer DataSender::initialize() claims from ChannelManager by default
+    static constexpr uint32_t DATA_BUFFER_SIZE{RTT_DATA_BUFFER_SIZE};
+
+    /**
+     * @brief Bytes DataSender::sendMemory writes for a region, including all packet headers
+     * @param size Size of the region in bytes
+     */
+    constexpr size_t memoryPacketBytes(size_t size) noexcept
+    {
+        const size_t packets = (size + DATA_MEMORY_CHUNK_SIZE - 1) / DATA_MEMORY_CHUNK_SIZE;
+        return size + packets * (sizeof(DataHeader) + sizeof(uintptr_t));
+    }
+
+    /**
+     * @brief Description of one field of a registered struct
+     */
+    struct FieldDescriptor
+    {
+        const char* name; // Field name
+        DataType type; // Element type (Binary for non-numeric fields)
+        uint16_t offset; // Byte offset in the struct
+        uint16_t count; // Number of elements (bytes for Binary fields)
+    };
+
+    /**
+     * @brief Field layout of a struct type, specialized with RTT_DATA_SCHEMA
+     *
+     * A registered struct is described to the host once per DataSender with
+     * a Schema packet; samples are then sent as Struct packets carrying only
+     * the schema ID and the raw bytes, which the host decodes into named
+     * columns.
+     */
+    template <typename T>
+    struct Schema
+    {
+        static constexpr bool REGISTERED = false;
+    };
+
 #if __cplusplus >= 202002L
     // C++20 Concept for data types that can be sent
     template <typename T>
@@ -67,14 +132,34 @@ namespace rtt::data
     public:
         /**
          * @brief Construct a new DataSender object
-         * @param channel RTT channel number for data transmission (default: 1)
+         *
+         * The channel is only written to; call initialize() to claim it from
+         * ChannelManager so no other stream, like the FreeRTOS trace, can take it.
+         *
+         * @param channel RTT channel number for data transmission (default: 1), ANY_CHANNEL for the lowest free
+         * one once initialize() claims it
          * @param use_timestamps Enable automatic timestamping (default: false)
          */
         explicit DataSender(uint32_t channel = 1, bool use_timestamps = false) noexcept
-            : m_channel(channel), m_useTimestamps(use_timestamps), m_timestampCounter(0)
+            : m_channel(channel), m_useTimestamps(use_timestamps)
         {
         }
 
+        /**
+         * @brief Claim the sender's channel from ChannelManager
+         *
+         * Claiming again under the same name keeps the buffer, so this may run
+         * on every initialization. A sender created with ANY_CHANNEL switches
+         * to the channel it was given.
+         *
+         * @param name Stream name shown by RTT viewers, must outlive the claim (a string literal)
+         * @param size Up-buffer size in bytes, taken from the ChannelManager arena
+         * @param mode Up-buffer mode
+         * @return True if claimed, false if another stream owns the channel or no buffer is left
+         */
+        bool initialize(const char* name = "Data", uint32_t size = DATA_BUFFER_SIZE,
+                        ChannelMode mode = ChannelMode::Skip) noexcept;
+
         /**
          * @brief Send an integer value
          * @tparam T Integer type (int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t)
@@ -132,8 +217,39 @@ namespace rtt::data
         }
 #endif
 
+        /**
+         * @brief Send a memory region as Memory packets of at most DATA_MEMORY_CHUNK_SIZE bytes
+         *
+         * Each packet carries the address of its first byte, so the host can
+         * rebuild the image even if packets were dropped. The bytes are written
+         * to RTT straight from the region, without a copy, under one RTT lock
+         * per packet. Only a channel claimed in ChannelMode::Block waits for
+         * room; elsewhere sending stops at the first packet that does not fit.
+         *
+         * @param data Start of the region
+         * @param size Size of the region in bytes
+         * @return Number of bytes sent (including headers), memoryPacketBytes(size) on success
+         */
+        size_t sendMemory(const void* data, size_t size) noexcept
+        {
+            return sendMemory(data, size, reinterpret_cast<uintptr_t>(data));
+        }
+
+        /**
+         * @brief Send bytes as Memory packets tagged with another address, e.g. from a copy of the region
+         * @param data Bytes to send
+         * @param size Number of bytes
+         * @param address Target address of the first byte
+         * @return Number of bytes sent (including headers), memoryPacketBytes(size) on success
+         */
+        size_t sendMemory(const void* data, size_t size, uintptr_t address) noexcept;
+
         /**
          * @brief Send a generic trivially copyable type
+         *
+         * Structs registered with RTT_DATA_SCHEMA are sent as Struct packets,
+         * everything else as Binary.
+         *
          * @tparam T Type to send (must be trivially copyable)
          * @param value Value to send
          * @return Number of bytes sent
@@ -142,18 +258,120 @@ namespace rtt::data
         template <typename T>
             requires Sendable<T>
         size_t send(const T& value) noexcept
-        {
-            return sendBinary(&value, sizeof(T));
-        }
 #else
         template <typename T>
         typename std::enable_if<std::is_trivially_copyable<T>::value, size_t>::type
         send(const T& value) noexcept
+#endif
         {
-            return sendBinary(&value, sizeof(T));
+            if constexpr (Schema<T>::REGISTERED)
+            {
+                return sendStruct(value);
+            }
+            else
+            {
+                return sendBinary(&value, sizeof(T));
+            }
         }
+
+        /**
+         * @brief Send the Schema packet describing a registered struct
+         *
+         * sendStruct sends the schema automatically before the first sample of
+         * each type on this sender; call this again if the host may have
+         * connected later. Once sent, sendStruct does not describe the type
+         * again on this sender.
+         *
+         * @tparam T Struct registered with RTT_DATA_SCHEMA
+         * @return Number of bytes sent (0 if the descriptor exceeds DATA_MAX_PACKET_SIZE)
+         */
+        template <typename T>
+        size_t sendSchema() noexcept
+        {
+            static_assert(Schema<T>::REGISTERED, "Register the struct with RTT_DATA_SCHEMA");
+            const size_t sent = sendSchema(Schema<T>::ID, Schema<T>::NAME, sizeof(T), Schema<T>::FIELDS,
+                                           sizeof(Schema<T>::FIELDS) / sizeof(Schema<T>::FIELDS[0]));
+            if (sent != 0)
+            {
+                m_described[Schema<T>::ID / 32U].fetch_or(1U << (Schema<T>::ID % 32U), std::memory_order_relaxed);
+            }
+            return sent;
+        }
+
+        /**
+         * @brief Send a Schema packet from a field list
+         * @param id Schema ID referenced by Struct packets
+         * @param name Struct name
+         * @param structSize Size of the struct in bytes
+         * @param fields Field descriptors
+         * @param fieldCount Number of field descriptors
+         * @return Number of bytes sent (0 if the descriptor exceeds DATA_MAX_PACKET_SIZE)
+         */
+        size_t sendSchema(uint8_t id, const char* name, size_t structSize, const FieldDescriptor* fields,
+                          size_t fieldCount) noexcept;
+
+        /**
+         * @brief Send one sample of a registered struct as a Struct packet
+         *
+         * The packet carries only the schema ID and the raw struct bytes. The
+         * Schema packet is sent before the first sample of each schema ID on
+         * this sender, so every channel a struct is sent on gets it; if it
+         * could not be sent, the next sample tries again.
+         *
+         * @tparam T Struct registered with RTT_DATA_SCHEMA
+         * @param value Sample to send
+         * @return Number of bytes sent (including headers)
+         */
+        template <typename T>
+        size_t sendStruct(const T& value) noexcept;
+
+        /**
+         * @brief Send an array of numeric samples as Array packets
+         *
+         * The samples are split into packets of at most DATA_MAX_PACKET_SIZE bytes,
+         * each holding whole elements under one header and sent with a single RTT
+         * write. The host decodes every packet as a vector of the element type.
+         *
+         * @tparam T Element type (integer or float/double)
+         * @param data Pointer to the first sample
+         * @param count Number of samples
+         * @return Number of bytes sent (including headers)
+         */
+#if __cplusplus >= 202002L
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        size_t sendArray(const T* data, size_t count) noexcept;
+
+        /**
+         * @brief Send an array of numeric samples (C++20 span interface)
+         * @tparam T Element type (integer or float/double)
+         * @param data Span of samples to send
+         * @return Number of bytes sent (including headers)
+         */
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        size_t sendArray(std::span<const T> data) noexcept
+        {
+            return sendArray(data.data(), data.size());
+        }
+#else
+        template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+        size_t sendArray(const T* data, size_t count) noexcept;
 #endif
 
+        /**
+         * @brief Send a fixed-size array of numeric samples
+         * @tparam T Element type (integer or float/double)
+         * @tparam N Number of samples
+         * @param data Array of samples to send
+         * @return Number of bytes sent (including headers)
+         */
+        template <typename T, size_t N>
+        size_t sendArray(const T (&data)[N]) noexcept
+        {
+            return sendArray(&data[0], N);
+        }
+
         /**
          * @brief Enable or disable automatic timestamping
          * @param enable True to enable, false to disable
@@ -183,6 +401,9 @@ namespace rtt::data
 
         /**
          * @brief Set the RTT channel
+         *
+         * The new channel is not claimed; call initialize() again to claim it.
+         *
          * @param channel New channel number
          */
         void setChannel(uint32_t channel) noexcept
@@ -190,22 +411,114 @@ namespace rtt::data
             m_channel = channel;
         }
 
+        /**
+         * @brief Enable or disable sending
+         *
+         * A disabled sender drops every packet except Schema packets and
+         * returns 0, so instrumentation can stay compiled in but quiet. Safe to
+         * call while another task sends.
+         *
+         * @param enable True to send, false to drop
+         */
+        void setEnabled(bool enable) noexcept
+        {
+            m_enabled.store(enable, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Check if sending is enabled
+         * @return True if enabled, false otherwise
+         */
+        [[nodiscard]] bool isEnabled() const noexcept
+        {
+            return m_enabled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Send only every n-th sample to reduce the bandwidth of a stream
+         *
+         * Applies to each send call (an array or SampleBlock flush counts as one
+         * sample); memory regions and Schema packets are never decimated. Safe
+         * to call while another task sends.
+         *
+         * @param factor Send one of factor samples, 0 or 1 to send all
+         */
+        void setDecimation(uint32_t factor) noexcept
+        {
+            m_decimation.store(factor == 0 ? 1 : factor, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the decimation factor
+         * @return Samples per sent sample, 1 if all are sent
+         */
+        [[nodiscard]] uint32_t getDecimation() const noexcept
+        {
+            return m_decimation.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the DataType used for array elements of type T
+         * @return Element type, DataType::Binary if T has no numeric DataType
+         */
+        template <typename T>
+        static constexpr DataType getElementType() noexcept
+        {
+            // Map integers by width so that int and long both resolve on every ABI
+            if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+            {
+                constexpr bool SIGNED = std::is_signed_v<T>;
+                switch (sizeof(T))
+                {
+                case 1:
+                    return SIGNED ? DataType::Int8 : DataType::UInt8;
+                case 2:
+                    return SIGNED ? DataType::Int16 : DataType::UInt16;
+                case 4:
+                    return SIGNED ? DataType::Int32 : DataType::UInt32;
+                case 8:
+                    return SIGNED ? DataType::Int64 : DataType::UInt64;
+                default:
+                    return DataType::Binary;
+                }
+            }
+            else
+            {
+                return getFloatType<T>();
+            }
+        }
+
     private:
+        template <typename T, size_t N>
+        friend class SampleBlock;
+
         uint32_t m_channel;
         bool m_useTimestamps;
-        uint32_t m_timestampCounter;
+        std::atomic<bool> m_enabled{true};
+        std::atomic<uint32_t> m_decimation{1};
+        std::atomic<uint32_t> m_samples{0}; // Samples seen while decimating
+        std::atomic<uint32_t> m_described[(UINT8_MAX + 1) / 32]{}; // Bit per schema ID sent by sendStruct
 
         /**
-         * @brief Get timestamp for current data packet
-         * @return Timestamp value or 0 if disabled
+         * @brief Decide whether the next sample is sent (enable and decimation)
          */
-        uint32_t getTimestamp() noexcept
+        [[nodiscard]] bool admit() noexcept
         {
-            if (m_useTimestamps)
+            if (!m_enabled.load(std::memory_order_relaxed))
             {
-                return m_timestampCounter++;
+                return false;
             }
-            return 0;
+            const uint32_t factor = m_decimation.load(std::memory_order_relaxed);
+            return factor <= 1 || m_samples.fetch_add(1, std::memory_order_relaxed) % factor == 0;
+        }
+
+        /**
+         * @brief Get timestamp for current data packet
+         * @return Low 32 bits of the shared timebase, or 0 if disabled
+         */
+        [[nodiscard]] uint32_t getTimestamp() const noexcept
+        {
+            return m_useTimestamps ? Timebase::now32() : 0;
         }
 
         /**
@@ -213,9 +526,25 @@ namespace rtt::data
          * @param type Data type
          * @param data Pointer to data
          * @param size Data size in bytes
+         * @param subtype Element type or schema ID (DataHeader::subtype)
+         * @return Number of bytes sent (including header)
+         */
+        size_t sendWithHeader(DataType type, const void* data, size_t size, uint8_t subtype = 0) noexcept;
+
+        /**
+         * @brief Fill in the header at the start of a packet and send it with one RTT write
+         * @param packet Packet buffer, payload already stored after the header
+         * @param type Data type
+         * @param subtype Element type or schema ID (DataHeader::subtype)
+         * @param size Payload size in bytes
          * @return Number of bytes sent (including header)
          */
-        size_t sendWithHeader(DataType type, const void* data, size_t size) noexcept;
+        size_t sendPacket(uint8_t* packet, DataType type, uint8_t subtype, size_t size) noexcept;
+
+        /**
+         * @brief Build a packet header with the current timestamp
+         */
+        DataHeader makeHeader(DataType type, uint8_t subtype, size_t size) const noexcept;
 
         /**
          * @brief Get DataType enum for integral types
@@ -288,32 +617,240 @@ namespace rtt::data
      */
     DataSender& getDataSender() noexcept;
 
+    namespace detail
+    {
+        /**
+         * @brief Get the element DataType of a struct field
+         */
+        template <typename F>
+        constexpr DataType fieldType() noexcept
+        {
+            using Element = std::remove_cv_t<std::remove_all_extents_t<F>>;
+            if constexpr (std::is_enum_v<Element>)
+            {
+                return DataSender::getElementType<std::underlying_type_t<Element>>();
+            }
+            else if constexpr (std::is_arithmetic_v<Element>)
+            {
+                return DataSender::getElementType<Element>();
+            }
+            else
+            {
+                return DataType::Binary;
+            }
+        }
+
+        /**
+         * @brief Get the element count of a struct field (bytes for Binary fields)
+         */
+        template <typename F>
+        constexpr uint16_t fieldCount() noexcept
+        {
+            static_assert(sizeof(F) <= UINT16_MAX, "Field too large for a schema descriptor");
+            if constexpr (fieldType<F>() == DataType::Binary)
+            {
+                return static_cast<uint16_t>(sizeof(F));
+            }
+            else
+            {
+                return static_cast<uint16_t>(sizeof(F) / sizeof(std::remove_all_extents_t<F>));
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief Batches samples of one type into Array packets
+     *
+     * Samples are appended behind a pre-reserved header, so a full block is sent
+     * with a single RTT write and no copy. Intended for high-rate streams such as
+     * ADC data, where a header per sample would dominate the bandwidth. A block
+     * is not thread-safe; use one block per producer.
+     *
+     * @tparam T Sample type (integer or float/double)
+     * @tparam N Samples per packet
+     */
+    template <typename T, size_t N>
+    class SampleBlock
+    {
+    public:
+        static_assert(std::is_arithmetic_v<T> && DataSender::getElementType<T>() != DataType::Binary,
+                      "Sample type must map to a numeric DataType");
+        static_assert(N > 0, "Sample block must hold at least one sample");
+
+        /**
+         * @brief Construct an empty block
+         * @param sender DataSender used to transmit full blocks
+         */
+        explicit SampleBlock(DataSender& sender = getDataSender()) noexcept : m_sender(sender)
+        {
+        }
+
+        /**
+         * @brief Append a sample, sending the block when it becomes full
+         * @param sample Sample value
+         * @return True if the block was sent by this call
+         */
+        bool push(T sample) noexcept
+        {
+            std::memcpy(&m_packet[sizeof(DataHeader) + (m_count * sizeof(T))], &sample, sizeof(T));
+            if (++m_count < N)
+            {
+                return false;
+            }
+            flush();
+            return true;
+        }
+
+        /**
+         * @brief Send the buffered samples, if any
+         * @return Number of bytes sent (including header)
+         */
+        size_t flush() noexcept
+        {
+            if (m_count == 0)
+            {
+                return 0;
+            }
+            const size_t sent = m_sender.admit()
+                ? m_sender.sendPacket(m_packet, DataType::Array, ELEMENT_TYPE, m_count * sizeof(T))
+                : 0;
+            m_count = 0;
+            return sent;
+        }
+
+        /**
+         * @brief Get the number of buffered samples
+         */
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return m_count;
+        }
+
+        /**
+         * @brief Get the number of samples per packet
+         */
+        [[nodiscard]] static constexpr size_t capacity() noexcept
+        {
+            return N;
+        }
+
+    private:
+        static constexpr auto ELEMENT_TYPE{static_cast<uint8_t>(DataSender::getElementType<T>())};
+
+        DataSender& m_sender;
+        size_t m_count{0};
+        alignas(4) uint8_t m_packet[sizeof(DataHeader) + (N * sizeof(T))]{};
+    };
+
     // Template implementations
 #if __cplusplus >= 202002L
     template <typename T>
         requires std::is_integral_v<T>
     size_t DataSender::sendInt(T value) noexcept
     {
-        return sendWithHeader(getIntType<T>(), &value, sizeof(T));
+        return admit() ? sendWithHeader(getIntType<T>(), &value, sizeof(T)) : 0;
     }
 
     template <typename T>
         requires std::is_floating_point_v<T>
     size_t DataSender::sendFloat(T value) noexcept
     {
-        return sendWithHeader(getFloatType<T>(), &value, sizeof(T));
+        return admit() ? sendWithHeader(getFloatType<T>(), &value, sizeof(T)) : 0;
     }
 #else
     template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type>
     size_t DataSender::sendInt(T value) noexcept
     {
-        return sendWithHeader(getIntType<T>(), &value, sizeof(T));
+        return admit() ? sendWithHeader(getIntType<T>(), &value, sizeof(T)) : 0;
     }
 
     template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type>
     size_t DataSender::sendFloat(T value) noexcept
     {
-        return sendWithHeader(getFloatType<T>(), &value, sizeof(T));
+        return admit() ? sendWithHeader(getFloatType<T>(), &value, sizeof(T)) : 0;
     }
 #endif
+
+#if __cplusplus >= 202002L
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+#else
+    template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type>
+#endif
+    size_t DataSender::sendArray(const T* data, size_t count) noexcept
+    {
+        static_assert(getElementType<T>() != DataType::Binary, "Element type must map to a numeric DataType");
+        constexpr size_t PER_PACKET = (DATA_MAX_PACKET_SIZE - sizeof(DataHeader)) / sizeof(T);
+
+        if (data == nullptr || !admit())
+        {
+            return 0;
+        }
+
+        alignas(4) uint8_t packet[DATA_MAX_PACKET_SIZE];
+        size_t sent = 0;
+        while (count > 0)
+        {
+            const size_t chunk = count < PER_PACKET ? count : PER_PACKET;
+            std::memcpy(&packet[sizeof(DataHeader)], data, chunk * sizeof(T));
+            sent += sendPacket(packet, DataType::Array, static_cast<uint8_t>(getElementType<T>()), chunk * sizeof(T));
+            data += chunk;
+            count -= chunk;
+        }
+        return sent;
+    }
+
+    template <typename T>
+    size_t DataSender::sendStruct(const T& value) noexcept
+    {
+        static_assert(Schema<T>::REGISTERED, "Register the struct with RTT_DATA_SCHEMA");
+        static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>,
+                      "Registered structs must be trivially copyable with standard layout");
+
+        if (!admit())
+        {
+            return 0;
+        }
+
+        constexpr uint32_t BIT = 1U << (Schema<T>::ID % 32U);
+        std::atomic<uint32_t>& described = m_described[Schema<T>::ID / 32U];
+        size_t sent = 0;
+        if ((described.fetch_or(BIT, std::memory_order_relaxed) & BIT) == 0)
+        {
+            sent = sendSchema<T>();
+            if (sent == 0)
+            {
+                // Dropped (full Skip channel) or too large: describe it again with the next sample
+                described.fetch_and(~BIT, std::memory_order_relaxed);
+            }
+        }
+        return sent + sendWithHeader(DataType::Struct, &value, sizeof(T), Schema<T>::ID);
+    }
 } // namespace rtt::data
+
+/**
+ * @brief Describe one member of the struct named in the enclosing RTT_DATA_SCHEMA
+ */
+#define RTT_DATA_FIELD(member)                                                                      \
+    ::rtt::data::FieldDescriptor{#member, ::rtt::data::detail::fieldType<decltype(Self::member)>(), \
+                                 static_cast<uint16_t>(offsetof(Self, member)),                     \
+                                 ::rtt::data::detail::fieldCount<decltype(Self::member)>()}
+
+/**
+ * @brief Register the field layout of a struct for DataSender::sendStruct
+ *
+ * Use at global scope, once per struct type, with an ID unique within the firmware:
+ * @code
+ * RTT_DATA_SCHEMA(SensorData, 1, RTT_DATA_FIELD(temperature), RTT_DATA_FIELD(pressure));
+ * @endcode
+ */
+#define RTT_DATA_SCHEMA(Type, id, ...)                                          \
+    template <>                                                                 \
+    struct rtt::data::Schema<Type>                                              \
+    {                                                                           \
+        using Self = Type;                                                      \
+        static constexpr bool REGISTERED = true;                                \
+        static constexpr uint8_t ID = (id);                                     \
+        static constexpr const char* NAME = #Type;                              \
+        static constexpr ::rtt::data::FieldDescriptor FIELDS[] = {__VA_ARGS__}; \
+    }
@@ -1,47 +1,222 @@
 #include "rtt_data/rtt_data.hpp"
+#include <SEGGER_RTT.h>
+#include <algorithm>
 
 namespace rtt::data
 {
     // Global DataSender instance
     static DataSender g_dataSender;
 
+    namespace
+    {
+        /**
+         * @brief Appends little-endian fields to a Schema packet payload
+         */
+        class DescriptorWriter
+        {
+        public:
+            DescriptorWriter(uint8_t* buffer, size_t capacity) noexcept : m_buffer(buffer), m_capacity(capacity)
+            {
+            }
+
+            void putU8(uint8_t value) noexcept
+            {
+                putBytes(&value, 1);
+            }
+
+            void putU16(uint16_t value) noexcept
+            {
+                const uint8_t bytes[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+                putBytes(bytes, sizeof(bytes));
+            }
+
+            /**
+             * @brief Append a name as length byte and characters (at most 255)
+             */
+            void putName(const char* name) noexcept
+            {
+                size_t length = 0;
+                while ((name != nullptr) && name[length] != '\0' && length < UINT8_MAX)
+                {
+                    ++length;
+                }
+                putU8(static_cast<uint8_t>(length));
+                putBytes(name, length);
+            }
+
+            [[nodiscard]] bool overflowed() const noexcept
+            {
+                return m_overflow;
+            }
+
+            [[nodiscard]] size_t size() const noexcept
+            {
+                return m_size;
+            }
+
+        private:
+            void putBytes(const void* data, size_t size) noexcept
+            {
+                if (m_size + size > m_capacity)
+                {
+                    m_overflow = true;
+                    return;
+                }
+                if (size > 0)
+                {
+                    std::memcpy(&m_buffer[m_size], data, size);
+                }
+                m_size += size;
+            }
+
+            uint8_t* m_buffer;
+            size_t m_capacity;
+            size_t m_size{0};
+            bool m_overflow{false};
+        };
+    } // namespace
+
     DataSender& getDataSender() noexcept
     {
         return g_dataSender;
     }
 
-    size_t DataSender::sendWithHeader(DataType type, const void* data, size_t size) noexcept
+    bool DataSender::initialize(const char* name, uint32_t size, ChannelMode mode) noexcept
+    {
+        const int channel = ChannelManager::claim(name, m_channel, size, mode);
+        if (channel < 0)
+        {
+            return false;
+        }
+        m_channel = static_cast<uint32_t>(channel);
+        return true;
+    }
+
+    size_t DataSender::sendWithHeader(DataType type, const void* data, size_t size, uint8_t subtype) noexcept
     {
         if ((data == nullptr) || size == 0)
         {
             return 0;
         }
 
-        // Create header
+        // Assemble small packets so header and payload go out in one RTT write
+        if (size <= DATA_MAX_PACKET_SIZE - sizeof(DataHeader))
+        {
+            alignas(4) uint8_t packet[DATA_MAX_PACKET_SIZE];
+            std::memcpy(&packet[sizeof(DataHeader)], data, size);
+            return sendPacket(packet, type, subtype, size);
+        }
+
+        // Large binary payloads are sent directly behind the header, under one lock
+        const DataHeader header = makeHeader(type, subtype, size);
+        SEGGER_RTT_LOCK();
+        size_t sent = SEGGER_RTT_WriteNoLock(m_channel, &header, sizeof(header));
+        sent += SEGGER_RTT_WriteNoLock(m_channel, data, static_cast<unsigned int>(size));
+        SEGGER_RTT_UNLOCK();
+        return sent;
+    }
+
+    size_t DataSender::sendSchema(uint8_t id, const char* name, size_t structSize, const FieldDescriptor* fields,
+                                  size_t fieldCount) noexcept
+    {
+        if ((fields == nullptr && fieldCount > 0) || fieldCount > UINT8_MAX || structSize > UINT16_MAX)
+        {
+            return 0;
+        }
+
+        // Payload: struct size, field count, name, then type, offset, count and name per field
+        alignas(4) uint8_t packet[DATA_MAX_PACKET_SIZE];
+        DescriptorWriter writer(&packet[sizeof(DataHeader)], sizeof(packet) - sizeof(DataHeader));
+        writer.putU16(static_cast<uint16_t>(structSize));
+        writer.putU8(static_cast<uint8_t>(fieldCount));
+        writer.putName(name);
+        for (size_t i = 0; i < fieldCount; ++i)
+        {
+            writer.putU8(static_cast<uint8_t>(fields[i].type));
+            writer.putU16(fields[i].offset);
+            writer.putU16(fields[i].count);
+            writer.putName(fields[i].name);
+        }
+
+        if (writer.overflowed())
+        {
+            return 0;
+        }
+        return sendPacket(packet, DataType::Schema, id, writer.size());
+    }
+
+    size_t DataSender::sendPacket(uint8_t* packet, DataType type, uint8_t subtype, size_t size) noexcept
+    {
+        const DataHeader header = makeHeader(type, subtype, size);
+        std::memcpy(packet, &header, sizeof(header));
+        return SEGGER_RTT_Write(m_channel, packet, static_cast<unsigned int>(sizeof(header) + size));
+    }
+
+    DataHeader DataSender::makeHeader(DataType type, uint8_t subtype, size_t size) const noexcept
+    {
         DataHeader header{};
         header.magic[0] = DATA_MAGIC_0;
         header.magic[1] = DATA_MAGIC_1;
         header.type = type;
-        header.reserved = 0;
+        header.subtype = subtype;
         header.size = static_cast<uint32_t>(size);
         header.timestamp = getTimestamp();
-
-        // Send header
-        size_t sent = SEGGER_RTT_Write(m_channel, &header, sizeof(header));
-
-        // Send data
-        sent += SEGGER_RTT_Write(m_channel, data, size);
-
-        return sent;
+        return header;
     }
 
     size_t DataSender::sendString(std::string_view str) noexcept
     {
-        return sendWithHeader(DataType::String, str.data(), str.size());
+        return admit() ? sendWithHeader(DataType::String, str.data(), str.size()) : 0;
     }
 
     size_t DataSender::sendBinary(const void* data, size_t size) noexcept
     {
-        return sendWithHeader(DataType::Binary, data, size);
+        return admit() ? sendWithHeader(DataType::Binary, data, size) : 0;
+    }
+
+    size_t DataSender::sendMemory(const void* data, size_t size, uintptr_t address) noexcept
+    {
+        // A decimated image would be useless, so regions only follow the enable switch
+        if (data == nullptr || !isEnabled())
+        {
+            return 0;
+        }
+
+        // Only a channel claimed in block mode waits for room; any other may drop a write
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        const ChannelInfo* info = ChannelManager::getInfo(m_channel);
+        const bool blocking = info != nullptr && info->mode == ChannelMode::Block;
+        size_t sent = 0;
+        for (size_t offset = 0; offset < size; offset += DATA_MEMORY_CHUNK_SIZE)
+        {
+            const size_t chunk = std::min(DATA_MEMORY_CHUNK_SIZE, size - offset);
+            const uintptr_t chunkAddress = address + offset;
+
+            // Header and address in one write, then the bytes directly from memory
+            alignas(4) uint8_t prefix[sizeof(DataHeader) + sizeof(uintptr_t)];
+            const DataHeader header = makeHeader(DataType::Memory, sizeof(uintptr_t), sizeof(uintptr_t) + chunk);
+            std::memcpy(prefix, &header, sizeof(header));
+            std::memcpy(&prefix[sizeof(header)], &chunkAddress, sizeof(chunkAddress));
+
+            // One lock for both writes, so no other writer lands between header and payload
+            bool dropped = false;
+            SEGGER_RTT_LOCK();
+            // Drop whole chunks when the buffer is full rather than a payload behind its header
+            if (!blocking && SEGGER_RTT_GetAvailWriteSpace(m_channel) < sizeof(prefix) + chunk)
+            {
+                dropped = true;
+            }
+            else
+            {
+                sent += SEGGER_RTT_WriteNoLock(m_channel, prefix, sizeof(prefix));
+                sent += SEGGER_RTT_WriteNoLock(m_channel, bytes + offset, static_cast<unsigned int>(chunk));
+            }
+            SEGGER_RTT_UNLOCK();
+            if (dropped)
+            {
+                break;
+            }
+        }
+        return sent;
     }
 } // namespace rtt::data
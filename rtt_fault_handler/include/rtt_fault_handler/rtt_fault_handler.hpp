@@ -1,13 +1,19 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 // Forward declare SEGGER RTT functions
 extern "C" {
 int SEGGER_RTT_printf(unsigned int BufferIndex, const char* sFormat, ...);
 unsigned int SEGGER_RTT_WriteString(unsigned int BufferIndex, const char* s);
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void* pBuffer, unsigned NumBytes);
 }
 
+#ifndef RTT_FAULT_MAX_RETURN_ADDRESSES
+#define RTT_FAULT_MAX_RETURN_ADDRESSES 16
+#endif
+
 namespace rtt::fault
 {
     /**
@@ -40,6 +46,62 @@ namespace rtt::fault
         uint32_t psr; // Program Status Register
     };
 
+    /**
+         * @brief Binary crash record ('RC'), decoded by scripts/rtt_crash_decoder.py
+         *
+         * Sent with a single RTT write; only the used return addresses are
+         * included (see size). All fields are little-endian on Cortex-M.
+         */
+    struct CrashRecord
+    {
+        static constexpr uint8_t VERSION{1};
+        static constexpr uint8_t FLAG_PSP{0x01}; // Process stack (task) was active
+        static constexpr uint8_t FLAG_FPU_FRAME{0x02}; // fpu holds the stacked FP context
+        static constexpr size_t MAX_RETURN_ADDRESSES{RTT_FAULT_MAX_RETURN_ADDRESSES};
+
+        char magic[2]; // 'R', 'C'
+        uint8_t version;
+        uint8_t faultType; // FaultType
+        uint8_t flags; // FLAG_* bits
+        uint8_t numReturnAddresses;
+        uint16_t size; // Bytes sent (fixed part + used return addresses)
+        ExceptionStackFrame frame;
+        uint32_t excReturn; // EXC_RETURN value (LR on exception entry)
+        uint32_t sp; // Stack pointer before the exception frame was pushed
+        uint32_t cfsr;
+        uint32_t hfsr;
+        uint32_t mmfar;
+        uint32_t bfar;
+        uint32_t fpu[17]; // S0-S15, FPSCR
+        uint32_t returnAddresses[MAX_RETURN_ADDRESSES]; // Candidates found on the stack, innermost first
+    };
+
+    static_assert(sizeof(CrashRecord) == 132 + 4 * CrashRecord::MAX_RETURN_ADDRESSES, "CrashRecord must not be padded");
+    static_assert(CrashRecord::MAX_RETURN_ADDRESSES <= 255, "numReturnAddresses is 8 bits");
+
+    /**
+         * @brief Output produced by the fault handler
+         */
+    enum class ReportFormat : uint8_t
+    {
+        Text = 0, // Human-readable report (many RTT writes)
+        Binary, // One CrashRecord
+        TextAndBinary
+    };
+
+    /**
+         * @brief Look up the stack that contains an address
+         *
+         * Runs in fault context. SystemMonitor::findStack() resolves task
+         * stacks from the monitor's task registry.
+         *
+         * @param address Stack pointer of the faulting code
+         * @param start Receives the lowest address of the stack
+         * @param end Receives the address above the stack
+         * @return true if the address lies in a known stack
+         */
+    using StackBoundsFunction = bool (*)(uintptr_t address, uintptr_t& start, uintptr_t& end);
+
     /**
          * @brief Configuration for fault handler
          */
@@ -51,10 +113,20 @@ namespace rtt::fault
         bool checkStackBounds; // Enable stack boundary checking (default: false for portability)
         uintptr_t stackStart; // Stack start address (if checkStackBounds is true)
         uintptr_t stackEnd; // Stack end address (if checkStackBounds is true)
+        ReportFormat reportFormat; // Output format (default: Text)
+        bool preserveCrashRecord; // Keep the crash record in no-init RAM (default: false)
+        uint16_t stackScanWords; // Words scanned for return addresses if the stack end is unknown (default: 256)
+        uintptr_t codeStart; // Start of code (0: linker symbols on ARM, scan disabled if unresolved)
+        uintptr_t codeEnd; // End of code
+        StackBoundsFunction taskStackBounds; // Bounds of the task (PSP) stack (default: none)
+        uintptr_t mainStackEnd; // Top of the main (MSP) stack (0: _estack or __StackTop on ARM)
+        uintptr_t ramEnd; // Limit of the scan if the active stack is unknown (0: none)
 
         constexpr FaultHandlerConfig()
             : rttChannel(0), maxStackDepth(16), enableVerbose(true),
-              checkStackBounds(false), stackStart(0), stackEnd(0)
+              checkStackBounds(false), stackStart(0), stackEnd(0),
+              reportFormat(ReportFormat::Text), preserveCrashRecord(false), stackScanWords(256),
+              codeStart(0), codeEnd(0), taskStackBounds(nullptr), mainStackEnd(0), ramEnd(0)
         {
         }
     };
@@ -69,9 +141,23 @@ namespace rtt::fault
     class FaultHandler
     {
     public:
+        /**
+             * @brief Function run by the fault handler after the fault report
+             *
+             * Runs in fault context: it must not block or rely on the scheduler.
+             */
+        using FaultCallback = void (*)();
+
+        /// Maximum number of fault callbacks
+        static constexpr size_t MAX_FAULT_CALLBACKS{4};
+
         /**
              * @brief Initialize the fault handler
              *
+             * On ARM, code bounds and the main stack top left at 0 are taken
+             * from the linker symbols (g_pfnVectors or __Vectors to _etext or
+             * __etext, and _estack or __StackTop); getConfig() shows the result.
+             *
              * @param config Configuration for the fault handler
              */
         static void initialize(const FaultHandlerConfig& config = FaultHandlerConfig());
@@ -126,8 +212,95 @@ namespace rtt::fault
              */
         static const char* getFaultTypeName(FaultType type);
 
+        /**
+             * @brief Fill a crash record from the exception stack frame
+             *
+             * @param type Fault type
+             * @param stackFrame Exception stack frame
+             * @param excReturn EXC_RETURN value of the exception
+             * @param record Receives the record
+             */
+        static void buildCrashRecord(FaultType type, const uint32_t* stackFrame, uint32_t excReturn,
+                                     CrashRecord& record);
+
+        /**
+             * @brief Send a crash record with a single RTT write
+             */
+        static void sendCrashRecord(const CrashRecord& record);
+
+        /**
+             * @brief Number of stack words to scan for return addresses
+             *
+             * The scan ends at the first known bound: stackEnd with
+             * checkStackBounds, the task stack for PSP, the main stack for
+             * MSP, otherwise stackScanWords words clamped to ramEnd.
+             *
+             * @param stack First word above the exception frame
+             * @param psp true if the faulting code used the process stack
+             * @return Number of words
+             */
+        static size_t stackScanLimit(const uint32_t* stack, bool psp);
+
+        /**
+             * @brief Scan stack words for return addresses
+             *
+             * A word is a candidate if it is a Thumb address inside the code
+             * bounds and the instruction before it is a BL or BLX.
+             *
+             * @param stack First word to scan
+             * @param words Number of words to scan
+             * @param addresses Receives the candidates (without the Thumb bit)
+             * @param maxAddresses Capacity of addresses
+             * @return Number of candidates found
+             */
+        static size_t findReturnAddresses(const uint32_t* stack, size_t words, uint32_t* addresses,
+                                          size_t maxAddresses);
+
+        /**
+             * @brief Check if the instruction before a return address is a call
+             *
+             * @param returnAddress Address without the Thumb bit
+             * @return true if it follows a BL or BLX within the code bounds
+             */
+        static bool isCallSite(uint32_t returnAddress);
+
+        /**
+             * @brief Get the crash record kept in no-init RAM by a previous fault
+             *
+             * @return Record, or nullptr if none was preserved
+             */
+        static const CrashRecord* getPreservedCrashRecord();
+
+        /**
+             * @brief Discard the preserved crash record
+             */
+        static void clearPreservedCrashRecord();
+
+        /**
+             * @brief Register a function to run when a fault is handled
+             *
+             * E.g. rtt_trace_flight_recorder_dump to emit the scheduler
+             * history leading up to the fault.
+             *
+             * @param callback Function to run
+             * @return false if callback is null or all slots are in use
+             */
+        static bool addFaultCallback(FaultCallback callback);
+
+        /**
+             * @brief Remove all fault callbacks
+             */
+        static void clearFaultCallbacks();
+
+        /**
+             * @brief Run all registered fault callbacks (called by fault_handler_c)
+             */
+        static void runFaultCallbacks();
+
     private:
         static FaultHandlerConfig s_config;
+        static FaultCallback s_faultCallbacks[MAX_FAULT_CALLBACKS];
+        static size_t s_numFaultCallbacks;
     };
 }
 
@@ -161,6 +334,7 @@ void UsageFault_Handler(void);
  *
  * @param stackFrame Pointer to exception stack frame
  * @param faultType Type of fault that occurred
+ * @param excReturn EXC_RETURN value (LR on exception entry)
  */
-void fault_handler_c(uint32_t* stackFrame, uint8_t faultType);
+void fault_handler_c(uint32_t* stackFrame, uint8_t faultType, uint32_t excReturn);
 }
@@ -1,14 +1,89 @@
 #include <rtt_fault_handler/rtt_fault_handler.hpp>
 #include <cstdint>
+#include <cstring>
+
+// Section that is not cleared by the startup code (NOLOAD in the linker script)
+#ifndef RTT_FAULT_NOINIT_SECTION
+#define RTT_FAULT_NOINIT_SECTION ".noinit"
+#endif
+
+namespace
+{
+    constexpr uint32_t EXC_RETURN_PSP{1U << 2}; // Return to thread mode using PSP
+    constexpr uint32_t EXC_RETURN_STD_FRAME{1U << 4}; // Cleared if an extended (FP) frame was stacked
+    constexpr uint32_t PSR_STACK_ALIGN{1U << 9}; // Frame was realigned by 4 bytes
+    constexpr size_t BASIC_FRAME_WORDS{8};
+    constexpr size_t FPU_FRAME_WORDS{BASIC_FRAME_WORDS + 18}; // + S0-S15, FPSCR, reserved
+    constexpr size_t FPU_SAVED_WORDS{17};
+    constexpr uint32_t PRESERVED_MAGIC{0x43525456}; // "VTRC"
+
+    /**
+     * @brief Crash record kept in no-init RAM across the reset after a fault
+     */
+    struct PreservedCrashRecord
+    {
+        uint32_t magic;
+        rtt::fault::CrashRecord record;
+    };
+
+    PreservedCrashRecord s_preserved __attribute__((section(RTT_FAULT_NOINIT_SECTION)));
+
+#if defined(__arm__) || defined(__thumb__) || defined(__ARM_ARCH)
+    // Linker and startup symbols of STM32Cube (g_pfnVectors, _etext, _estack) and CMSIS (__Vectors, __etext,
+    // __StackTop) projects; weak so a missing symbol resolves to address 0
+    extern "C" const uint32_t g_pfnVectors[] __attribute__((weak));
+    extern "C" const uint32_t __Vectors[] __attribute__((weak));
+    extern "C" const uint32_t _etext[] __attribute__((weak));
+    extern "C" const uint32_t __etext[] __attribute__((weak));
+    extern "C" const uint32_t _estack[] __attribute__((weak));
+    extern "C" const uint32_t __StackTop[] __attribute__((weak));
+
+    uintptr_t firstSymbol(const uint32_t* preferred, const uint32_t* fallback)
+    {
+        return reinterpret_cast<uintptr_t>(preferred != nullptr ? preferred : fallback);
+    }
+#endif
+
+    /**
+     * @brief Read the fault status registers into a record (zero on non-ARM builds)
+     */
+    void readFaultStatus(rtt::fault::CrashRecord& record)
+    {
+#if defined(__arm__) || defined(__thumb__) || defined(__ARM_ARCH)
+        record.cfsr = *reinterpret_cast<volatile uint32_t*>(0xE000ED28);
+        record.hfsr = *reinterpret_cast<volatile uint32_t*>(0xE000ED2C);
+        record.mmfar = *reinterpret_cast<volatile uint32_t*>(0xE000ED34);
+        record.bfar = *reinterpret_cast<volatile uint32_t*>(0xE000ED38);
+#else
+        record.cfsr = 0;
+        record.hfsr = 0;
+        record.mmfar = 0;
+        record.bfar = 0;
+#endif
+    }
+}
 
 namespace rtt::fault
 {
     // Static member initialization
     FaultHandlerConfig FaultHandler::s_config;
+    FaultHandler::FaultCallback FaultHandler::s_faultCallbacks[MAX_FAULT_CALLBACKS] = {};
+    size_t FaultHandler::s_numFaultCallbacks = 0;
 
     void FaultHandler::initialize(const FaultHandlerConfig& config)
     {
         s_config = config;
+#if defined(__arm__) || defined(__thumb__) || defined(__ARM_ARCH)
+        if (s_config.codeStart == 0 && s_config.codeEnd == 0)
+        {
+            s_config.codeStart = firstSymbol(g_pfnVectors, __Vectors);
+            s_config.codeEnd = firstSymbol(_etext, __etext);
+        }
+        if (s_config.mainStackEnd == 0)
+        {
+            s_config.mainStackEnd = firstSymbol(_estack, __StackTop);
+        }
+#endif
 
         if (s_config.enableVerbose)
         {
@@ -186,6 +261,168 @@ namespace rtt::fault
         }
     }
 
+    bool FaultHandler::isCallSite(uint32_t returnAddress)
+    {
+        if (returnAddress < s_config.codeStart + 4 || returnAddress > s_config.codeEnd)
+        {
+            return false;
+        }
+
+        const auto* code = reinterpret_cast<const uint16_t*>(static_cast<uintptr_t>(returnAddress));
+
+        // BLX Rm (16-bit): 0100 0111 1xxx x000
+        if ((code[-1] & 0xFF87) == 0x4780)
+        {
+            return true;
+        }
+
+        // BL <label> (32-bit): 11110xxx xxxxxxxx, 11x1xxxx xxxxxxxx
+        return (code[-2] & 0xF800) == 0xF000 && (code[-1] & 0xD000) == 0xD000;
+    }
+
+    size_t FaultHandler::findReturnAddresses(const uint32_t* stack, size_t words, uint32_t* addresses,
+                                             size_t maxAddresses)
+    {
+        size_t found = 0;
+        if (s_config.codeStart >= s_config.codeEnd)
+        {
+            return 0;
+        }
+
+        for (size_t i = 0; i < words && found < maxAddresses; ++i)
+        {
+            const uint32_t value = stack[i];
+            if ((value & 1U) != 0 && isCallSite(value & ~1U))
+            {
+                addresses[found++] = value & ~1U;
+            }
+        }
+        return found;
+    }
+
+    size_t FaultHandler::stackScanLimit(const uint32_t* stack, bool psp)
+    {
+        const auto start = reinterpret_cast<uintptr_t>(stack);
+        const auto wordsTo = [start](uintptr_t end) -> size_t {
+            return start < end ? (end - start) / sizeof(uint32_t) : 0;
+        };
+
+        if (s_config.checkStackBounds)
+        {
+            return wordsTo(s_config.stackEnd);
+        }
+
+        uintptr_t stackStart = 0;
+        uintptr_t stackEnd = 0;
+        if (psp && s_config.taskStackBounds != nullptr && s_config.taskStackBounds(start, stackStart, stackEnd))
+        {
+            return wordsTo(stackEnd);
+        }
+        if (!psp && start < s_config.mainStackEnd)
+        {
+            return wordsTo(s_config.mainStackEnd);
+        }
+
+        const size_t words = s_config.stackScanWords;
+        return s_config.ramEnd != 0 && wordsTo(s_config.ramEnd) < words ? wordsTo(s_config.ramEnd) : words;
+    }
+
+    void FaultHandler::buildCrashRecord(FaultType type, const uint32_t* stackFrame, uint32_t excReturn,
+                                        CrashRecord& record)
+    {
+        std::memset(&record, 0, sizeof(record));
+        record.magic[0] = 'R';
+        record.magic[1] = 'C';
+        record.version = CrashRecord::VERSION;
+        record.faultType = static_cast<uint8_t>(type);
+        record.excReturn = excReturn;
+        std::memcpy(&record.frame, stackFrame, sizeof(record.frame));
+        readFaultStatus(record);
+
+        if ((excReturn & EXC_RETURN_PSP) != 0)
+        {
+            record.flags |= CrashRecord::FLAG_PSP;
+        }
+
+        size_t frameWords = BASIC_FRAME_WORDS;
+        if ((excReturn & EXC_RETURN_STD_FRAME) == 0)
+        {
+#if defined(__ARM_FP)
+            // Touching the FPU forces lazy state preservation into the reserved frame space
+            uint32_t fpscr;
+            __asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+            (void)fpscr;
+#endif
+            record.flags |= CrashRecord::FLAG_FPU_FRAME;
+            std::memcpy(record.fpu, &stackFrame[BASIC_FRAME_WORDS], FPU_SAVED_WORDS * sizeof(uint32_t));
+            frameWords = FPU_FRAME_WORDS;
+        }
+
+        // Stack of the faulting code starts right after the (possibly realigned) frame
+        const uint32_t* stack = stackFrame + frameWords + ((record.frame.psr & PSR_STACK_ALIGN) != 0 ? 1 : 0);
+        record.sp = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(stack));
+
+        const size_t scanWords = stackScanLimit(stack, (record.flags & CrashRecord::FLAG_PSP) != 0);
+        record.numReturnAddresses = static_cast<uint8_t>(
+            findReturnAddresses(stack, scanWords, record.returnAddresses, CrashRecord::MAX_RETURN_ADDRESSES));
+
+        record.size = static_cast<uint16_t>(sizeof(CrashRecord) -
+                                            (CrashRecord::MAX_RETURN_ADDRESSES - record.numReturnAddresses) *
+                                            sizeof(uint32_t));
+
+        if (s_config.preserveCrashRecord)
+        {
+            s_preserved.record = record;
+            s_preserved.magic = PRESERVED_MAGIC;
+        }
+    }
+
+    void FaultHandler::sendCrashRecord(const CrashRecord& record)
+    {
+        SEGGER_RTT_Write(s_config.rttChannel, &record, record.size);
+    }
+
+    const CrashRecord* FaultHandler::getPreservedCrashRecord()
+    {
+        const CrashRecord& record = s_preserved.record;
+        if (s_preserved.magic != PRESERVED_MAGIC || record.magic[0] != 'R' || record.magic[1] != 'C' ||
+            record.version != CrashRecord::VERSION || record.numReturnAddresses > CrashRecord::MAX_RETURN_ADDRESSES)
+        {
+            return nullptr;
+        }
+        return &record;
+    }
+
+    void FaultHandler::clearPreservedCrashRecord()
+    {
+        s_preserved.magic = 0;
+    }
+
+    bool FaultHandler::addFaultCallback(FaultCallback callback)
+    {
+        if (callback == nullptr || s_numFaultCallbacks >= MAX_FAULT_CALLBACKS)
+        {
+            return false;
+        }
+
+        s_faultCallbacks[s_numFaultCallbacks] = callback;
+        s_numFaultCallbacks++;
+        return true;
+    }
+
+    void FaultHandler::clearFaultCallbacks()
+    {
+        s_numFaultCallbacks = 0;
+    }
+
+    void FaultHandler::runFaultCallbacks()
+    {
+        for (size_t i = 0; i < s_numFaultCallbacks; ++i)
+        {
+            s_faultCallbacks[i]();
+        }
+    }
+
     void FaultHandler::printStackTrace(uint32_t* sp, uint8_t maxDepth)
     {
         SEGGER_RTT_WriteString(s_config.rttChannel, "\n--- Stack Trace ---\n");
@@ -224,18 +461,36 @@ extern "C" {
  * This function is called by the individual fault handlers with
  * the appropriate fault type and stack frame pointer.
  */
-void fault_handler_c(uint32_t* stackFrame, uint8_t faultType)
+void fault_handler_c(uint32_t* stackFrame, uint8_t faultType, uint32_t excReturn)
 {
     using namespace rtt::fault;
 
     auto* exceptionFrame = reinterpret_cast<ExceptionStackFrame*>(stackFrame);
     auto type = static_cast<FaultType>(faultType);
+    const ReportFormat format = FaultHandler::getConfig().reportFormat;
+
+    // The binary record goes first: it is one write and holds everything needed for decoding
+    if (format != ReportFormat::Text || FaultHandler::getConfig().preserveCrashRecord)
+    {
+        CrashRecord record;
+        FaultHandler::buildCrashRecord(type, stackFrame, excReturn, record);
+        if (format != ReportFormat::Text)
+        {
+            FaultHandler::sendCrashRecord(record);
+        }
+    }
 
-    // Print fault information
-    FaultHandler::printFaultInfo(type, exceptionFrame);
+    if (format != ReportFormat::Binary)
+    {
+        // Print fault information
+        FaultHandler::printFaultInfo(type, exceptionFrame);
+
+        // Print stack trace
+        FaultHandler::printStackTrace(stackFrame, FaultHandler::getConfig().maxStackDepth);
+    }
 
-    // Print stack trace
-    FaultHandler::printStackTrace(stackFrame, FaultHandler::getConfig().maxStackDepth);
+    // Let other modules add post-mortem data (e.g. the trace flight recorder)
+    FaultHandler::runFaultCallbacks();
 
     // Infinite loop to halt execution
     while (1)
@@ -263,8 +518,9 @@ void HardFault_Handler(void)
         "mrseq r0, msp\n" // If bit 2 is 0, use MSP
         "mrsne r0, psp\n" // If bit 2 is 1, use PSP
         "mov r1, #0\n" // Fault type: HardFault
+        "mov r2, lr\n" // EXC_RETURN
         "b fault_handler_c\n" // Branch to C handler
-        ::: "r0", "r1"
+        ::: "r0", "r1", "r2"
     );
 }
 
@@ -280,8 +536,9 @@ void MemManage_Handler(void)
         "mrseq r0, msp\n"
         "mrsne r0, psp\n"
         "mov r1, #1\n" // Fault type: MemManageFault
+        "mov r2, lr\n"
         "b fault_handler_c\n"
-        ::: "r0", "r1"
+        ::: "r0", "r1", "r2"
     );
 }
 
@@ -297,8 +554,9 @@ void BusFault_Handler(void)
         "mrseq r0, msp\n"
         "mrsne r0, psp\n"
         "mov r1, #2\n" // Fault type: BusFault
+        "mov r2, lr\n"
         "b fault_handler_c\n"
-        ::: "r0", "r1"
+        ::: "r0", "r1", "r2"
     );
 }
 
@@ -314,8 +572,9 @@ void UsageFault_Handler(void)
         "mrseq r0, msp\n"
         "mrsne r0, psp\n"
         "mov r1, #3\n" // Fault type: UsageFault
+        "mov r2, lr\n"
         "b fault_handler_c\n"
-        ::: "r0", "r1"
+        ::: "r0", "r1", "r2"
     );
 }
 
@@ -1,4 +1,5 @@
 #include <rtt_freertos_hooks/rtt_freertos_hooks.hpp>
+#include <rtt_freertos_hooks/system_monitor.hpp>
 #include <rtt_logger/rtt_logger.hpp>
 
 /**
@@ -36,6 +37,36 @@ int main() {
     logger.info("  - vApplicationDaemonTaskStartupHook()");
     logger.info("");
     
+    // Example: System monitor fed by the task switch and idle hooks
+    logger.info("System monitor with two simulated tasks:");
+    static uint32_t workerStack[64];
+    static uint32_t idleStack[32];
+    for (auto& word : workerStack) {
+        word = rtt::freertos::STACK_FILL_WORD;
+    }
+    for (auto& word : idleStack) {
+        word = rtt::freertos::STACK_FILL_WORD;
+    }
+    workerStack[48] = 0;  // Deepest stack use of the worker
+    rtt::freertos::SystemMonitor::registerTask(workerStack, "worker", workerStack, 64);
+    rtt::freertos::SystemMonitor::registerTask(idleStack, "IDLE", idleStack, 32);
+    rtt::freertos::SystemMonitor::start();
+    volatile uint32_t sink = 0;
+    for (int i = 0; i < 20; ++i) {
+        rtt_monitor_task_switched_in(workerStack);
+        for (uint32_t spin = 0; spin < 20000; ++spin) {
+            sink = spin;
+        }
+        rtt_monitor_task_switched_out(workerStack);
+        rtt_monitor_task_switched_in(idleStack);
+        vApplicationIdleHook();
+        vApplicationIdleHook();
+        rtt_monitor_task_switched_out(idleStack);
+    }
+    rtt::freertos::FreeRtosHooks::logSystemStats();
+    rtt::freertos::SystemMonitor::stop();
+    logger.info("");
+    
     // Example: Demonstrate what happens when malloc fails
     logger.info("Simulating malloc failure...");
     vApplicationMallocFailedHook();
@@ -58,6 +89,7 @@ int main() {
     // Example: Demonstrate idle hook (normally called when system is idle)
     logger.info("");
     logger.info("The idle hook is called when FreeRTOS is idle:");
+    rtt::freertos::FreeRtosHooks::addIdleCallback([] { rtt::getLogger().info("  idle callback"); });
     logger.info("Calling idle hook 3 times...");
     for (int i = 0; i < 3; ++i) {
         vApplicationIdleHook();
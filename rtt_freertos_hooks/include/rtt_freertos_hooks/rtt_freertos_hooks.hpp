@@ -4,6 +4,7 @@
 #include <cstddef>
 
 #ifdef __cplusplus
+#include <array>
 #include <string_view>
 extern "C" {
 #endif
@@ -20,7 +21,8 @@ extern "C" {
  * @brief Hook function called when malloc fails
  *
  * This hook is called when pvPortMalloc fails to allocate memory.
- * It logs the failure via RTT.
+ * It logs the failure via RTT and runs the callback set with
+ * FreeRtosHooks::setMallocFailedCallback() before it traps.
  */
 void vApplicationMallocFailedHook(void);
 
@@ -42,7 +44,8 @@ void vApplicationTickHook(void);
 /**
  * @brief Hook function called when the system is idle
  *
- * Can be used for low-priority background tasks.
+ * Runs the callbacks registered with FreeRtosHooks::addIdleCallback(), e.g.
+ * rtt_trace_drain() to move trace events to RTT outside the scheduler.
  */
 void vApplicationIdleHook(void);
 
@@ -63,6 +66,19 @@ namespace rtt::freertos {
  */
 class FreeRtosHooks {
 public:
+    /**
+     * @brief Function run from the idle hook (must not block)
+     */
+    using IdleCallback = void (*)();
+
+    /**
+     * @brief Function run by the malloc failed hook before it traps
+     */
+    using MallocFailedCallback = void (*)();
+
+    /// Maximum number of idle callbacks
+    static constexpr size_t MAX_IDLE_CALLBACKS{4};
+
     /**
      * @brief Enable or disable verbose hook logging
      * @param enable true to enable, false to disable
@@ -87,8 +103,39 @@ public:
      */
     static void logSystemStats() noexcept;
 
+    /**
+     * @brief Register a function to run from vApplicationIdleHook()
+     * @param callback Function to run (register before starting the scheduler)
+     * @return false if callback is null or all slots are in use
+     */
+    static bool addIdleCallback(IdleCallback callback) noexcept;
+
+    /**
+     * @brief Remove all idle callbacks
+     */
+    static void clearIdleCallbacks() noexcept;
+
+    /**
+     * @brief Run all registered idle callbacks (called by vApplicationIdleHook())
+     */
+    static void runIdleCallbacks() noexcept;
+
+    /**
+     * @brief Set a function to run when an allocation fails, e.g. rtt_heap_profiler_report
+     * @param callback Function to run (nullptr to remove)
+     */
+    static void setMallocFailedCallback(MallocFailedCallback callback) noexcept;
+
+    /**
+     * @brief Run the malloc failed callback, if set (called by vApplicationMallocFailedHook())
+     */
+    static void runMallocFailedCallback() noexcept;
+
 private:
     static inline bool m_verbose{false};
+    static inline std::array<IdleCallback, MAX_IDLE_CALLBACKS> m_idleCallbacks{};
+    static inline size_t m_numIdleCallbacks{0};
+    static inline MallocFailedCallback m_mallocFailedCallback{nullptr};
 };
 
 } // namespace rtt::freertos
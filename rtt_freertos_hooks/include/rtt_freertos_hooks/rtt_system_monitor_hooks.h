@@ -0,0 +1,77 @@
+#pragma once
+
+/**
+ * @file rtt_system_monitor_hooks.h
+ * @brief C-only header for the system monitor kernel hooks
+ *
+ * Include this header in FreeRTOSConfig.h. When rtt_freertos_trace is used
+ * as well, include it BEFORE rtt_freertos_trace_hooks.h: the trace hook
+ * macros then also feed the system monitor. Without the trace library, map
+ * the FreeRTOS trace macros yourself:
+ *
+ * ```c
+ * #include "rtt_freertos_hooks/rtt_system_monitor_hooks.h"
+ * #define traceTASK_SWITCHED_IN() RTT_MONITOR_TASK_SWITCHED_IN()
+ * #define traceTASK_SWITCHED_OUT() RTT_MONITOR_TASK_SWITCHED_OUT()
+ * #define traceTASK_CREATE(pxNewTCB) RTT_MONITOR_TASK_CREATE(pxNewTCB)
+ * #define traceTASK_DELETE(pxTaskToDelete) RTT_MONITOR_TASK_DELETE(pxTaskToDelete)
+ * ```
+ *
+ * For C++ code, use system_monitor.hpp instead.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start accounting run time to a task (traceTASK_SWITCHED_IN)
+ * @param handle Task handle (TCB address)
+ */
+void rtt_monitor_task_switched_in(const void* handle);
+
+/**
+ * @brief Stop accounting run time to the running task (traceTASK_SWITCHED_OUT)
+ * @param handle Task handle (TCB address)
+ */
+void rtt_monitor_task_switched_out(const void* handle);
+
+/**
+ * @brief Register a task with its stack for high-water scanning
+ *
+ * @param handle Task handle (TCB address)
+ * @param name Task name (copied, may be NULL)
+ * @param stack_base Lowest address of the stack (pxStack)
+ * @param stack_words Stack size in 32-bit words (0 tracks run time only)
+ * @return 0 on success, -1 if all task slots are in use
+ */
+int rtt_monitor_register_task(const void* handle, const char* name, const void* stack_base, uint32_t stack_words);
+
+/**
+ * @brief Release the slot of a deleted task
+ * @param handle Task handle (TCB address)
+ */
+void rtt_monitor_unregister_task(const void* handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * Hook macros, expanded inside FreeRTOS tasks.c where pxCurrentTCB and the
+ * TCB layout are visible. RTT_MONITOR_TASK_CREATE registers the stack from
+ * pxStack up to the initial pxTopOfStack (the stack grows down on Cortex-M).
+ */
+#define RTT_MONITOR_TASK_SWITCHED_IN() rtt_monitor_task_switched_in(pxCurrentTCB)
+
+#define RTT_MONITOR_TASK_SWITCHED_OUT() rtt_monitor_task_switched_out(pxCurrentTCB)
+
+#define RTT_MONITOR_TASK_CREATE(pxNewTCB)                                      \
+    (void)rtt_monitor_register_task((pxNewTCB), (pxNewTCB)->pcTaskName,        \
+                                    (pxNewTCB)->pxStack,                       \
+                                    (uint32_t)((pxNewTCB)->pxTopOfStack - (pxNewTCB)->pxStack))
+
+#define RTT_MONITOR_TASK_DELETE(pxTaskToDelete) rtt_monitor_unregister_task(pxTaskToDelete)
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <rtt_data/rtt_data.hpp>
+#include <rtt_freertos_hooks/rtt_system_monitor_hooks.h>
+#include <rtt_logger/rtt_logger.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
+
+#ifndef RTT_MONITOR_MAX_TASKS
+#define RTT_MONITOR_MAX_TASKS 16
+#endif
+
+#ifndef RTT_MONITOR_NAME_LENGTH
+#define RTT_MONITOR_NAME_LENGTH 16
+#endif
+
+#ifndef RTT_MONITOR_SCAN_WORDS
+#define RTT_MONITOR_SCAN_WORDS 8
+#endif
+
+#ifndef RTT_MONITOR_IDLE_MAX_GAP
+#define RTT_MONITOR_IDLE_MAX_GAP 2000
+#endif
+
+#ifndef RTT_MONITOR_SCHEMA_ID
+#define RTT_MONITOR_SCHEMA_ID 0xC0
+#endif
+
+namespace rtt::freertos {
+
+/// Task slots of the system monitor
+static constexpr size_t MONITOR_MAX_TASKS{RTT_MONITOR_MAX_TASKS};
+/// Characters per task name in SystemStats, including the terminating zero
+static constexpr size_t MONITOR_NAME_LENGTH{RTT_MONITOR_NAME_LENGTH};
+/// Stack words checked per idle pass
+static constexpr size_t MONITOR_SCAN_WORDS{RTT_MONITOR_SCAN_WORDS};
+/// Longest gap in ticks between two idle hook calls still counted as idle time
+static constexpr uint32_t MONITOR_IDLE_MAX_GAP{RTT_MONITOR_IDLE_MAX_GAP};
+/// Word FreeRTOS fills new stacks with (tskSTACK_FILL_BYTE)
+static constexpr uint32_t STACK_FILL_WORD{0xA5A5A5A5U};
+/// CPU load of a fully busy period in SystemStats::load
+static constexpr uint32_t MONITOR_LOAD_SCALE{10000};
+
+/**
+ * @brief One stats packet of the system monitor, streamed by SystemMonitor::report()
+ *
+ * Times are in timebase ticks (CPU cycles on Cortex-M) over the period since
+ * the previous sample. Per-task entries are parallel arrays; the first
+ * taskCount entries are valid.
+ */
+struct SystemStats {
+    uint32_t frequency; // Timebase frequency in Hz
+    uint32_t period; // Ticks covered by this sample
+    uint32_t idle; // Idle ticks measured by the idle hook
+    uint32_t load; // CPU load in 1/100 % (MONITOR_LOAD_SCALE = fully busy)
+    uint32_t taskCount; // Valid task entries
+    uint32_t handle[MONITOR_MAX_TASKS]; // Task handle (TCB address)
+    uint32_t runtime[MONITOR_MAX_TASKS]; // Ticks the task ran, including interrupts that preempted it
+    uint32_t switches[MONITOR_MAX_TASKS]; // Times the task was switched in
+    uint32_t stackWords[MONITOR_MAX_TASKS]; // Registered stack size in words (0 if unknown)
+    uint32_t stackFree[MONITOR_MAX_TASKS]; // Stack words never used so far (high-water mark)
+    char name[MONITOR_MAX_TASKS][MONITOR_NAME_LENGTH]; // Task name, zero-terminated
+};
+
+} // namespace rtt::freertos
+
+RTT_DATA_SCHEMA(rtt::freertos::SystemStats, RTT_MONITOR_SCHEMA_ID, RTT_DATA_FIELD(frequency), RTT_DATA_FIELD(period),
+                RTT_DATA_FIELD(idle), RTT_DATA_FIELD(load), RTT_DATA_FIELD(taskCount), RTT_DATA_FIELD(handle),
+                RTT_DATA_FIELD(runtime), RTT_DATA_FIELD(switches), RTT_DATA_FIELD(stackWords),
+                RTT_DATA_FIELD(stackFree), RTT_DATA_FIELD(name));
+
+namespace rtt::freertos {
+
+namespace detail {
+
+/**
+ * @brief Per-task state of the SystemMonitor
+ */
+struct MonitorSlot {
+    std::atomic<uintptr_t> handle{0};
+    const uint32_t* stackBase{nullptr};
+    std::atomic<uint32_t> stackWords{0}; // Published after stackBase
+    std::atomic<uint32_t> stackFree{0};
+    uint32_t scanCursor{0};
+    std::atomic<uint32_t> runtime{0};
+    std::atomic<uint32_t> switches{0};
+    uint32_t reportedRuntime{0};
+    uint32_t reportedSwitches{0};
+    std::array<char, MONITOR_NAME_LENGTH> name{};
+};
+
+} // namespace detail
+
+/**
+ * @brief Low-overhead CPU load, per-task run time and stack high-water monitor
+ *
+ * Fed by the kernel hooks (see rtt_system_monitor_hooks.h) and by
+ * vApplicationIdleHook():
+ * - Task switches add the ticks since the switch-in to the outgoing task:
+ *   one timebase sample and a few 32-bit stores per switch.
+ * - Each idle hook call counts the ticks since the previous call returned as
+ *   idle time, unless a task switch happened in between or the gap exceeds
+ *   MONITOR_IDLE_MAX_GAP; hook work such as idle callbacks counts as busy.
+ * - Each idle hook call checks MONITOR_SCAN_WORDS stack words of one task for
+ *   the fill pattern, so the high-water marks are refreshed in small
+ *   increments instead of a full uxTaskGetStackHighWaterMark() sweep.
+ *
+ * Counters are cumulative 32-bit values and samples report their difference,
+ * so sample or report at least once per 2^32 ticks (about 25 s at 168 MHz).
+ * Stack scanning needs stacks filled with tskSTACK_FILL_BYTE (FreeRTOS does
+ * this with configCHECK_FOR_STACK_OVERFLOW > 1, configUSE_TRACE_FACILITY or
+ * INCLUDE_uxTaskGetStackHighWaterMark) growing down (all Cortex-M ports).
+ */
+class SystemMonitor {
+public:
+    /**
+     * @brief Start accounting and begin a new sample period
+     * @param timestamp Timebase::sample() at the start
+     */
+    static void start(uint32_t timestamp) noexcept;
+    static void start() noexcept { start(Timebase::sample()); }
+
+    /**
+     * @brief Stop accounting (registrations and high-water marks are kept)
+     */
+    static void stop() noexcept;
+
+    /**
+     * @brief Check if the monitor is accounting
+     */
+    [[nodiscard]] static bool isRunning() noexcept { return m_running.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Register a task, or update the name and stack of a registered one
+     * @param handle Task handle
+     * @param name Task name (copied, truncated to MONITOR_NAME_LENGTH - 1 characters, may be nullptr)
+     * @param stackBase Lowest address of the stack
+     * @param stackWords Stack size in 32-bit words (0 tracks run time only)
+     * @return false if handle is null or all slots are in use
+     */
+    static bool registerTask(const void* handle, const char* name, const void* stackBase, size_t stackWords) noexcept;
+
+    /**
+     * @brief Release the slot of a task
+     * @param handle Task handle
+     */
+    static void unregisterTask(const void* handle) noexcept;
+
+    /**
+     * @brief Remove all tasks and clear all counters
+     */
+    static void reset() noexcept;
+
+    /**
+     * @brief Find the registered task stack that contains an address
+     *
+     * Lock-free and safe in fault context, e.g. as
+     * FaultHandlerConfig::taskStackBounds to bound the crash record's stack scan.
+     *
+     * @param address Address to look up, e.g. the PSP of a faulting task
+     * @param start Receives the lowest address of the stack
+     * @param end Receives the address above the registered stack words
+     * @return false if no registered stack contains the address
+     */
+    static bool findStack(uintptr_t address, uintptr_t& start, uintptr_t& end) noexcept;
+
+    /**
+     * @brief Number of occupied task slots
+     */
+    [[nodiscard]] static size_t getTaskCount() noexcept;
+
+    /**
+     * @brief A task was switched in (unregistered tasks get a slot without stack)
+     * @param handle Task handle
+     * @param timestamp Timebase::sample() at the switch
+     */
+    static void taskSwitchedIn(const void* handle, uint32_t timestamp) noexcept;
+    static void taskSwitchedIn(const void* handle) noexcept { taskSwitchedIn(handle, Timebase::sample()); }
+
+    /**
+     * @brief The running task was switched out
+     * @param timestamp Timebase::sample() at the switch
+     */
+    static void taskSwitchedOut(uint32_t timestamp) noexcept;
+    static void taskSwitchedOut() noexcept { taskSwitchedOut(Timebase::sample()); }
+
+    /**
+     * @brief Account idle time, scan stacks and send due reports (called first by vApplicationIdleHook())
+     * @param timestamp Timebase::sample() at idle hook entry
+     */
+    static void idleEntry(uint32_t timestamp) noexcept;
+    static void idleEntry() noexcept { idleEntry(Timebase::sample()); }
+
+    /**
+     * @brief Mark the end of the idle hook work (called last by vApplicationIdleHook())
+     * @param timestamp Timebase::sample() at idle hook exit
+     */
+    static void idleExit(uint32_t timestamp) noexcept;
+    static void idleExit() noexcept { idleExit(Timebase::sample()); }
+
+    /**
+     * @brief Check the next MONITOR_SCAN_WORDS stack words of one task
+     */
+    static void scanStacks() noexcept;
+
+    /**
+     * @brief Send a stats packet from the idle hook at a fixed interval
+     *
+     * The idle hook does not run while the CPU is fully loaded; to see hogs
+     * at 100 % load call report() from a task of suitable priority instead.
+     *
+     * @param ticks Interval in timebase ticks (0 disables periodic reports)
+     * @param sender DataSender for the packets
+     */
+    static void setReportInterval(uint32_t ticks, data::DataSender& sender = data::getDataSender()) noexcept;
+
+    /**
+     * @brief Collect the stats since the previous sample and begin a new period
+     * @param timestamp Timebase::sample() at the end of the period
+     * @return Stats of the finished period (valid until the next sample)
+     */
+    static const SystemStats& sample(uint32_t timestamp) noexcept;
+    static const SystemStats& sample() noexcept { return sample(Timebase::sample()); }
+
+    /**
+     * @brief Get the stats of the last sample
+     */
+    [[nodiscard]] static const SystemStats& getStats() noexcept { return m_stats; }
+
+    /**
+     * @brief Sample and send the stats as one Struct packet
+     * @param sender DataSender to send through
+     * @return Number of bytes sent (including the schema before the first packet)
+     */
+    static size_t report(data::DataSender& sender = data::getDataSender()) noexcept;
+
+    /**
+     * @brief Print the stats of the last sample via the logger
+     * @param logger Logger to use
+     */
+    static void log(Logger& logger = getLogger()) noexcept;
+
+private:
+    static constexpr uint32_t NO_TASK{UINT32_MAX};
+
+    static uint32_t claimSlot(uintptr_t handle) noexcept;
+    static uint32_t findSlot(uintptr_t handle) noexcept;
+
+    static inline std::array<detail::MonitorSlot, MONITOR_MAX_TASKS> m_slots{};
+    static inline std::atomic<bool> m_running{false};
+    static inline std::atomic<uint32_t> m_current{NO_TASK};
+    static inline std::atomic<uint32_t> m_switchedInAt{0};
+    static inline std::atomic<uint32_t> m_switchCount{0};
+    static inline std::atomic<uint32_t> m_idleTicks{0};
+    static inline uint32_t m_idleExitAt{0};
+    static inline uint32_t m_idleSwitchCount{0};
+    static inline bool m_idleValid{false};
+    static inline uint32_t m_reportedIdle{0};
+    static inline uint32_t m_periodStart{0};
+    static inline uint32_t m_scanSlot{0};
+    static inline uint32_t m_reportInterval{0};
+    static inline uint32_t m_lastReport{0};
+    static inline data::DataSender* m_reportSender{nullptr};
+    static inline SystemStats m_stats{};
+};
+
+} // namespace rtt::freertos
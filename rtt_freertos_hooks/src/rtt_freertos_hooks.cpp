@@ -1,4 +1,5 @@
 #include <rtt_freertos_hooks/rtt_freertos_hooks.hpp>
+#include <rtt_freertos_hooks/system_monitor.hpp>
 #include <rtt_logger/rtt_logger.hpp>
 #include <cstring>
 #include <tuple>
@@ -28,6 +29,40 @@ void FreeRtosHooks::logTaskInfo(std::string_view taskName, std::string_view mess
 void FreeRtosHooks::logSystemStats() noexcept {
     auto& logger = rtt::getLogger();
     logger.info("=== System Statistics ===");
+    if (SystemMonitor::isRunning()) {
+        std::ignore = SystemMonitor::sample();
+    }
+    SystemMonitor::log(logger);
+}
+
+bool FreeRtosHooks::addIdleCallback(IdleCallback callback) noexcept {
+    if (callback == nullptr || m_numIdleCallbacks >= MAX_IDLE_CALLBACKS) {
+        return false;
+    }
+
+    m_idleCallbacks[m_numIdleCallbacks] = callback;
+    m_numIdleCallbacks++;
+    return true;
+}
+
+void FreeRtosHooks::clearIdleCallbacks() noexcept {
+    m_numIdleCallbacks = 0;
+}
+
+void FreeRtosHooks::runIdleCallbacks() noexcept {
+    for (size_t i = 0; i < m_numIdleCallbacks; ++i) {
+        m_idleCallbacks[i]();
+    }
+}
+
+void FreeRtosHooks::setMallocFailedCallback(MallocFailedCallback callback) noexcept {
+    m_mallocFailedCallback = callback;
+}
+
+void FreeRtosHooks::runMallocFailedCallback() noexcept {
+    if (m_mallocFailedCallback != nullptr) {
+        m_mallocFailedCallback();
+    }
 }
 
 } // namespace rtt::freertos
@@ -37,6 +72,9 @@ void vApplicationMallocFailedHook(void) {
     auto& logger = rtt::getLogger();
     logger.critical("FreeRTOS: Malloc failed!");
 
+    // E.g. a heap profiler report, so the failure comes with a leak/fragmentation picture
+    rtt::freertos::FreeRtosHooks::runMallocFailedCallback();
+
     // In a real system, you might want to halt here
     while (true) {
         // Trap
@@ -68,7 +106,12 @@ void vApplicationTickHook(void) {
 }
 
 void vApplicationIdleHook(void) {
-    // Called when the system is idle
+    // Called when the system is idle - idle time accounting, stack scanning and background
+    // work such as draining trace events; the time spent here counts as busy
+    rtt::freertos::SystemMonitor::idleEntry();
+    rtt::freertos::FreeRtosHooks::runIdleCallbacks();
+    rtt::freertos::SystemMonitor::idleExit();
+
     if (rtt::freertos::FreeRtosHooks::isVerbose()) {
         // Could log idle statistics here
     }
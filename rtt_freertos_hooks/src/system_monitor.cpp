@@ -0,0 +1,335 @@
+#include <rtt_freertos_hooks/system_monitor.hpp>
+#include <cstring>
+#include <tuple>
+
+namespace rtt::freertos {
+
+void SystemMonitor::start(uint32_t timestamp) noexcept {
+    for (auto& slot : m_slots) {
+        slot.reportedRuntime = slot.runtime.load(std::memory_order_relaxed);
+        slot.reportedSwitches = slot.switches.load(std::memory_order_relaxed);
+    }
+    m_reportedIdle = m_idleTicks.load(std::memory_order_relaxed);
+    m_idleValid = false;
+    m_current.store(NO_TASK, std::memory_order_relaxed);
+    m_periodStart = timestamp;
+    m_lastReport = timestamp;
+    m_running.store(true, std::memory_order_release);
+}
+
+void SystemMonitor::stop() noexcept {
+    m_running.store(false, std::memory_order_relaxed);
+    m_current.store(NO_TASK, std::memory_order_relaxed);
+}
+
+bool SystemMonitor::registerTask(const void* handle, const char* name, const void* stackBase,
+                                 size_t stackWords) noexcept {
+    const auto key = reinterpret_cast<uintptr_t>(handle);
+    if (key == 0) {
+        return false;
+    }
+
+    uint32_t index = findSlot(key);
+    if (index == NO_TASK) {
+        index = claimSlot(key);
+        if (index == NO_TASK) {
+            return false;
+        }
+    }
+
+    detail::MonitorSlot& slot = m_slots[index];
+    slot.stackWords.store(0, std::memory_order_relaxed);
+    slot.name.fill('\0');
+    if (name != nullptr) {
+        for (size_t i = 0; i < MONITOR_NAME_LENGTH - 1 && name[i] != '\0'; ++i) {
+            slot.name[i] = name[i];
+        }
+    }
+
+    // The scan only reads the stack once stackWords is published
+    const auto words = static_cast<uint32_t>(stackBase != nullptr ? stackWords : 0);
+    slot.stackBase = static_cast<const uint32_t*>(stackBase);
+    slot.stackFree.store(words, std::memory_order_relaxed);
+    slot.scanCursor = 0;
+    slot.stackWords.store(words, std::memory_order_release);
+    return true;
+}
+
+void SystemMonitor::unregisterTask(const void* handle) noexcept {
+    const uint32_t index = findSlot(reinterpret_cast<uintptr_t>(handle));
+    if (index == NO_TASK) {
+        return;
+    }
+
+    if (m_current.load(std::memory_order_relaxed) == index) {
+        m_current.store(NO_TASK, std::memory_order_relaxed);
+    }
+    detail::MonitorSlot& slot = m_slots[index];
+    slot.stackWords.store(0, std::memory_order_relaxed);
+    slot.handle.store(0, std::memory_order_release);
+}
+
+void SystemMonitor::reset() noexcept {
+    stop();
+    for (auto& slot : m_slots) {
+        slot.handle.store(0, std::memory_order_relaxed);
+        slot.stackWords.store(0, std::memory_order_relaxed);
+        slot.stackFree.store(0, std::memory_order_relaxed);
+        slot.runtime.store(0, std::memory_order_relaxed);
+        slot.switches.store(0, std::memory_order_relaxed);
+        slot.stackBase = nullptr;
+        slot.scanCursor = 0;
+        slot.reportedRuntime = 0;
+        slot.reportedSwitches = 0;
+        slot.name.fill('\0');
+    }
+    m_idleTicks.store(0, std::memory_order_relaxed);
+    m_reportedIdle = 0;
+    m_idleValid = false;
+    m_scanSlot = 0;
+    m_reportInterval = 0;
+    m_reportSender = nullptr;
+    m_stats = SystemStats{};
+}
+
+bool SystemMonitor::findStack(uintptr_t address, uintptr_t& start, uintptr_t& end) noexcept {
+    for (const auto& slot : m_slots) {
+        const uint32_t words = slot.stackWords.load(std::memory_order_acquire);
+        const auto base = reinterpret_cast<uintptr_t>(slot.stackBase);
+        if (words != 0 && address >= base && address - base < words * sizeof(uint32_t)) {
+            start = base;
+            end = base + words * sizeof(uint32_t);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t SystemMonitor::getTaskCount() noexcept {
+    size_t count = 0;
+    for (const auto& slot : m_slots) {
+        count += slot.handle.load(std::memory_order_relaxed) != 0 ? 1 : 0;
+    }
+    return count;
+}
+
+void SystemMonitor::taskSwitchedIn(const void* handle, uint32_t timestamp) noexcept {
+    if (!isRunning()) {
+        return;
+    }
+
+    const auto key = reinterpret_cast<uintptr_t>(handle);
+    uint32_t index = findSlot(key);
+    if (index == NO_TASK && key != 0) {
+        index = claimSlot(key);
+    }
+
+    // The count changes first, so a sampler preempted by this switch retries its snapshot
+    m_switchCount.store(m_switchCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_switchedInAt.store(timestamp, std::memory_order_relaxed);
+    m_current.store(index, std::memory_order_relaxed);
+    if (index != NO_TASK) {
+        detail::MonitorSlot& slot = m_slots[index];
+        slot.switches.store(slot.switches.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+void SystemMonitor::taskSwitchedOut(uint32_t timestamp) noexcept {
+    const uint32_t index = m_current.load(std::memory_order_relaxed);
+    if (index == NO_TASK || !isRunning()) {
+        return;
+    }
+
+    detail::MonitorSlot& slot = m_slots[index];
+    const uint32_t elapsed = timestamp - m_switchedInAt.load(std::memory_order_relaxed);
+    slot.runtime.store(slot.runtime.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+    m_current.store(NO_TASK, std::memory_order_relaxed);
+}
+
+void SystemMonitor::idleEntry(uint32_t timestamp) noexcept {
+    if (!isRunning()) {
+        return;
+    }
+
+    // Only the idle loop between two hook calls is idle time, not the hook work itself
+    const uint32_t gap = timestamp - m_idleExitAt;
+    if (m_idleValid && m_idleSwitchCount == m_switchCount.load(std::memory_order_relaxed) &&
+        gap <= MONITOR_IDLE_MAX_GAP) {
+        m_idleTicks.store(m_idleTicks.load(std::memory_order_relaxed) + gap, std::memory_order_relaxed);
+    }
+
+    scanStacks();
+
+    if (m_reportInterval > 0 && m_reportSender != nullptr && timestamp - m_lastReport >= m_reportInterval) {
+        m_lastReport = timestamp;
+        std::ignore = report(*m_reportSender);
+    }
+}
+
+void SystemMonitor::idleExit(uint32_t timestamp) noexcept {
+    m_idleExitAt = timestamp;
+    m_idleSwitchCount = m_switchCount.load(std::memory_order_relaxed);
+    m_idleValid = true;
+}
+
+void SystemMonitor::scanStacks() noexcept {
+    // Skip slots without a stack, then check up to MONITOR_SCAN_WORDS words of one task
+    for (size_t visited = 0; visited < MONITOR_MAX_TASKS; ++visited) {
+        detail::MonitorSlot& slot = m_slots[m_scanSlot];
+        const uint32_t words = slot.stackWords.load(std::memory_order_acquire);
+        if (slot.handle.load(std::memory_order_relaxed) == 0 || words == 0) {
+            m_scanSlot = (m_scanSlot + 1) % MONITOR_MAX_TASKS;
+            continue;
+        }
+
+        // A sweep walks up from the stack base to the known high-water mark;
+        // the first used word below it is the new mark
+        uint32_t stackFree = slot.stackFree.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < MONITOR_SCAN_WORDS; ++i) {
+            if (slot.scanCursor >= stackFree) {
+                slot.scanCursor = 0;
+                m_scanSlot = (m_scanSlot + 1) % MONITOR_MAX_TASKS;
+                break;
+            }
+            if (slot.stackBase[slot.scanCursor] != STACK_FILL_WORD) {
+                stackFree = slot.scanCursor;
+                slot.stackFree.store(stackFree, std::memory_order_relaxed);
+                slot.scanCursor = 0;
+                m_scanSlot = (m_scanSlot + 1) % MONITOR_MAX_TASKS;
+                break;
+            }
+            ++slot.scanCursor;
+        }
+        return;
+    }
+}
+
+void SystemMonitor::setReportInterval(uint32_t ticks, data::DataSender& sender) noexcept {
+    m_reportSender = &sender;
+    m_lastReport = Timebase::sample();
+    m_reportInterval = ticks;
+}
+
+const SystemStats& SystemMonitor::sample(uint32_t timestamp) noexcept {
+    // Time of the running task since its switch-in, read consistently against concurrent switches
+    uint32_t current = NO_TASK;
+    uint32_t switchedInAt = 0;
+    uint32_t switchCount = 0;
+    do {
+        switchCount = m_switchCount.load(std::memory_order_acquire);
+        current = m_current.load(std::memory_order_relaxed);
+        switchedInAt = m_switchedInAt.load(std::memory_order_relaxed);
+    } while (switchCount != m_switchCount.load(std::memory_order_acquire));
+
+    SystemStats& stats = m_stats;
+    stats = SystemStats{};
+    stats.frequency = Timebase::getFrequency();
+    stats.period = timestamp - m_periodStart;
+    m_periodStart = timestamp;
+
+    const uint32_t idleTicks = m_idleTicks.load(std::memory_order_relaxed);
+    stats.idle = idleTicks - m_reportedIdle;
+    m_reportedIdle = idleTicks;
+    if (stats.period > 0) {
+        const uint32_t idle = stats.idle < stats.period ? stats.idle : stats.period;
+        stats.load = static_cast<uint32_t>((static_cast<uint64_t>(stats.period - idle) * MONITOR_LOAD_SCALE) /
+                                           stats.period);
+    }
+
+    for (uint32_t index = 0; index < MONITOR_MAX_TASKS; ++index) {
+        detail::MonitorSlot& slot = m_slots[index];
+        const uintptr_t handle = slot.handle.load(std::memory_order_acquire);
+        if (handle == 0) {
+            continue;
+        }
+
+        uint32_t runtime = slot.runtime.load(std::memory_order_relaxed);
+        if (index == current && isRunning()) {
+            runtime += timestamp - switchedInAt;
+        }
+        const uint32_t switches = slot.switches.load(std::memory_order_relaxed);
+
+        const uint32_t entry = stats.taskCount++;
+        stats.handle[entry] = static_cast<uint32_t>(handle);
+        stats.runtime[entry] = runtime - slot.reportedRuntime;
+        stats.switches[entry] = switches - slot.reportedSwitches;
+        stats.stackWords[entry] = slot.stackWords.load(std::memory_order_relaxed);
+        stats.stackFree[entry] = slot.stackFree.load(std::memory_order_relaxed);
+        std::memcpy(stats.name[entry], slot.name.data(), MONITOR_NAME_LENGTH);
+        slot.reportedRuntime = runtime;
+        slot.reportedSwitches = switches;
+    }
+    return stats;
+}
+
+size_t SystemMonitor::report(data::DataSender& sender) noexcept {
+    return sender.sendStruct(sample());
+}
+
+void SystemMonitor::log(Logger& logger) noexcept {
+    const SystemStats& stats = m_stats;
+    logger.logFormatted(LogLevel::Info, "CPU load %lu.%02lu %% (idle %lu of %lu ticks, %lu tasks)",
+                        static_cast<unsigned long>(stats.load / 100), static_cast<unsigned long>(stats.load % 100),
+                        static_cast<unsigned long>(stats.idle), static_cast<unsigned long>(stats.period),
+                        static_cast<unsigned long>(stats.taskCount));
+    for (uint32_t i = 0; i < stats.taskCount; ++i) {
+        const uint32_t share = stats.period > 0 ? static_cast<uint32_t>((static_cast<uint64_t>(stats.runtime[i]) *
+                                                                          MONITOR_LOAD_SCALE) / stats.period)
+                                                : 0;
+        logger.logFormatted(LogLevel::Info, "  %-*s %3lu.%02lu %% %lu switches, stack %lu/%lu words free",
+                            static_cast<int>(MONITOR_NAME_LENGTH - 1),
+                            stats.name[i][0] != '\0' ? stats.name[i] : "?", static_cast<unsigned long>(share / 100),
+                            static_cast<unsigned long>(share % 100), static_cast<unsigned long>(stats.switches[i]),
+                            static_cast<unsigned long>(stats.stackFree[i]),
+                            static_cast<unsigned long>(stats.stackWords[i]));
+    }
+}
+
+uint32_t SystemMonitor::claimSlot(uintptr_t handle) noexcept {
+    for (uint32_t index = 0; index < MONITOR_MAX_TASKS; ++index) {
+        detail::MonitorSlot& slot = m_slots[index];
+        uintptr_t expected = 0;
+        if (slot.handle.load(std::memory_order_relaxed) == 0 &&
+            slot.handle.compare_exchange_strong(expected, handle, std::memory_order_acq_rel)) {
+            slot.runtime.store(0, std::memory_order_relaxed);
+            slot.switches.store(0, std::memory_order_relaxed);
+            slot.reportedRuntime = 0;
+            slot.reportedSwitches = 0;
+            slot.name.fill('\0');
+            return index;
+        }
+    }
+    return NO_TASK;
+}
+
+uint32_t SystemMonitor::findSlot(uintptr_t handle) noexcept {
+    if (handle == 0) {
+        return NO_TASK;
+    }
+    for (uint32_t index = 0; index < MONITOR_MAX_TASKS; ++index) {
+        if (m_slots[index].handle.load(std::memory_order_relaxed) == handle) {
+            return index;
+        }
+    }
+    return NO_TASK;
+}
+
+} // namespace rtt::freertos
+
+extern "C" {
+void rtt_monitor_task_switched_in(const void* handle) {
+    rtt::freertos::SystemMonitor::taskSwitchedIn(handle);
+}
+
+void rtt_monitor_task_switched_out([[maybe_unused]] const void* handle) {
+    rtt::freertos::SystemMonitor::taskSwitchedOut();
+}
+
+int rtt_monitor_register_task(const void* handle, const char* name, const void* stack_base, uint32_t stack_words) {
+    return rtt::freertos::SystemMonitor::registerTask(handle, name, stack_base, stack_words) ? 0 : -1;
+}
+
+void rtt_monitor_unregister_task(const void* handle) {
+    rtt::freertos::SystemMonitor::unregisterTask(handle);
+}
+} // extern "C"
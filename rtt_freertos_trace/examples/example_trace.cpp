@@ -119,7 +119,7 @@ void createTasks()
     // xTaskCreate(sensorTask, "Sensor", 256, nullptr, 2, (TaskHandle_t*)&sensorTaskHandle);
     logger.info("Created Sensor task");
 
-    // Register tasks with trace system for readable output
+    // traceTASK_CREATE registers tasks under their TCB names; handles without a TCB name are registered by hand
     rtt_trace_register_task((uint32_t)ledTaskHandle, "LED", 3);
     rtt_trace_register_task((uint32_t)uartTaskHandle, "UART", 4);
     rtt_trace_register_task((uint32_t)sensorTaskHandle, "Sensor", 6);
@@ -0,0 +1,199 @@
+#pragma once
+
+/**
+ * @file heap_profiler.hpp
+ * @brief On-target aggregation of FreeRTOS heap allocations
+ *
+ * With RTT_TRACE_HEAP_PROFILER enabled, traceMALLOC/traceFREE update the
+ * tables below instead of streaming one event per allocation. A report is a
+ * handful of schema-registered Struct packets on an rtt_data channel
+ * (decoded by scripts/rtt_heap_report.py).
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <rtt_data/rtt_data.hpp>
+#include <rtt_freertos_trace/rtt_freertos_trace_hooks.h>
+
+#ifndef RTT_HEAP_PROFILER_LIVE_SLOTS
+#define RTT_HEAP_PROFILER_LIVE_SLOTS 256
+#endif
+
+#ifndef RTT_HEAP_PROFILER_CALLER_SLOTS
+#define RTT_HEAP_PROFILER_CALLER_SLOTS 64
+#endif
+
+#ifndef RTT_HEAP_PROFILER_LEAK_CANDIDATES
+#define RTT_HEAP_PROFILER_LEAK_CANDIDATES 8
+#endif
+
+#ifndef RTT_HEAP_PROFILER_SCHEMA_ID
+#define RTT_HEAP_PROFILER_SCHEMA_ID 0xC1 // Uses this ID and the next two
+#endif
+
+namespace rtt::trace
+{
+    /// Slots of the live allocation table (power of two; at most 7/8 of them are used)
+    static constexpr size_t HEAP_LIVE_SLOTS{RTT_HEAP_PROFILER_LIVE_SLOTS};
+    /// Slots of the per-caller table (power of two); further callers share one "other" entry
+    static constexpr size_t HEAP_CALLER_SLOTS{RTT_HEAP_PROFILER_CALLER_SLOTS};
+    /// Oldest live allocations sent as leak candidates per report
+    static constexpr size_t HEAP_LEAK_CANDIDATES{RTT_HEAP_PROFILER_LEAK_CANDIDATES};
+
+    static_assert(HEAP_LIVE_SLOTS >= 8 && (HEAP_LIVE_SLOTS & (HEAP_LIVE_SLOTS - 1)) == 0,
+                  "RTT_HEAP_PROFILER_LIVE_SLOTS must be a power of two of at least 8");
+    static_assert(HEAP_CALLER_SLOTS >= 2 && (HEAP_CALLER_SLOTS & (HEAP_CALLER_SLOTS - 1)) == 0,
+                  "RTT_HEAP_PROFILER_CALLER_SLOTS must be a power of two");
+
+    /**
+     * @brief Whole-heap totals, the first packet of a report
+     */
+    struct HeapSummary
+    {
+        uint32_t heapSize; // Configured heap size (0 if not set with setHeapSize())
+        uint32_t liveBytes; // Bytes currently allocated
+        uint32_t peakBytes; // Highest liveBytes seen
+        uint32_t liveCount; // Allocations currently live
+        uint32_t allocations; // Successful allocations
+        uint32_t frees; // Frees of tracked allocations
+        uint32_t failures; // Failed allocations
+        uint32_t failedSize; // Size of the last failed request
+        uint32_t failedCaller; // Caller of the last failed request
+        uint32_t untracked; // Allocations not tracked because the live table was full
+        uint32_t unknownFrees; // Frees of untracked allocations
+        uint32_t callers; // Caller records following this summary
+        uint32_t leakCandidates; // Leak candidate records following the caller records
+    };
+
+    /**
+     * @brief Statistics of one allocating call site (return address of pvPortMalloc)
+     */
+    struct HeapCallerStats
+    {
+        uint32_t caller; // Return address (0 for callers that did not fit the table)
+        uint32_t allocations; // Successful allocations
+        uint32_t frees; // Frees of its allocations
+        uint32_t liveCount; // Allocations currently live
+        uint32_t liveBytes; // Bytes currently allocated
+        uint32_t peakBytes; // Highest liveBytes seen
+        uint32_t totalBytes; // Bytes allocated in total (wraps)
+        uint32_t largest; // Largest single allocation
+    };
+
+    /**
+     * @brief A long-lived allocation, reported oldest first
+     */
+    struct HeapLeakCandidate
+    {
+        uint32_t address; // Allocated block
+        uint32_t size; // Requested size
+        uint32_t caller; // Return address of pvPortMalloc
+        uint32_t age; // Allocations made since this one
+    };
+} // namespace rtt::trace
+
+RTT_DATA_SCHEMA(rtt::trace::HeapSummary, RTT_HEAP_PROFILER_SCHEMA_ID, RTT_DATA_FIELD(heapSize),
+                RTT_DATA_FIELD(liveBytes), RTT_DATA_FIELD(peakBytes), RTT_DATA_FIELD(liveCount),
+                RTT_DATA_FIELD(allocations), RTT_DATA_FIELD(frees), RTT_DATA_FIELD(failures),
+                RTT_DATA_FIELD(failedSize), RTT_DATA_FIELD(failedCaller), RTT_DATA_FIELD(untracked),
+                RTT_DATA_FIELD(unknownFrees), RTT_DATA_FIELD(callers), RTT_DATA_FIELD(leakCandidates));
+RTT_DATA_SCHEMA(rtt::trace::HeapCallerStats, RTT_HEAP_PROFILER_SCHEMA_ID + 1, RTT_DATA_FIELD(caller),
+                RTT_DATA_FIELD(allocations), RTT_DATA_FIELD(frees), RTT_DATA_FIELD(liveCount),
+                RTT_DATA_FIELD(liveBytes), RTT_DATA_FIELD(peakBytes), RTT_DATA_FIELD(totalBytes),
+                RTT_DATA_FIELD(largest));
+RTT_DATA_SCHEMA(rtt::trace::HeapLeakCandidate, RTT_HEAP_PROFILER_SCHEMA_ID + 2, RTT_DATA_FIELD(address),
+                RTT_DATA_FIELD(size), RTT_DATA_FIELD(caller), RTT_DATA_FIELD(age));
+
+namespace rtt::trace
+{
+    /**
+     * @brief Live-allocation and per-caller heap statistics in fixed-size tables
+     *
+     * Both tables use open addressing with linear probing: live allocations
+     * are keyed by block address (removed with backward-shift deletion, so
+     * lookups never degrade), callers by return address. Recording is not
+     * locked; FreeRTOS calls the trace macros with the scheduler suspended
+     * and never from interrupts. A report from a task may see a table that
+     * another task is updating; the malloc failed hook reports a stable one.
+     */
+    class HeapProfiler
+    {
+    public:
+        /**
+         * @brief Record an allocation (traceMALLOC)
+         * @param address Allocated block (nullptr for a failed allocation)
+         * @param size Requested size in bytes
+         * @param caller Return address of the allocator
+         */
+        static void recordMalloc(const void* address, size_t size, const void* caller) noexcept;
+
+        /**
+         * @brief Record a free (traceFREE)
+         * @param address Freed block
+         */
+        static void recordFree(const void* address) noexcept;
+
+        /**
+         * @brief Set the heap size reported in the summary, e.g. configTOTAL_HEAP_SIZE
+         */
+        static void setHeapSize(size_t bytes) noexcept { s_heapSize = static_cast<uint32_t>(bytes); }
+
+        /**
+         * @brief Get the whole-heap totals
+         */
+        [[nodiscard]] static HeapSummary getSummary() noexcept;
+
+        /**
+         * @brief Copy the statistics of all callers seen so far
+         * @param out Destination
+         * @param capacity Entries available in out
+         * @return Number of entries written
+         */
+        static size_t getCallers(HeapCallerStats* out, size_t capacity) noexcept;
+
+        /**
+         * @brief Find the oldest live allocations
+         * @param out Destination, filled oldest first
+         * @param capacity Entries available in out
+         * @return Number of entries written
+         */
+        static size_t getLeakCandidates(HeapLeakCandidate* out, size_t capacity) noexcept;
+
+        /**
+         * @brief Send a HeapSummary, one HeapCallerStats per caller and up to HEAP_LEAK_CANDIDATES leak candidates
+         * @param sender DataSender to send through
+         * @return Number of bytes sent
+         */
+        static size_t report(data::DataSender& sender = data::getDataSender()) noexcept;
+
+        /**
+         * @brief Forget all allocations and callers
+         */
+        static void reset() noexcept;
+
+    private:
+        static constexpr uint16_t OTHER_CALLER{HEAP_CALLER_SLOTS};
+        static constexpr size_t MAX_LIVE{HEAP_LIVE_SLOTS - HEAP_LIVE_SLOTS / 8};
+
+        struct LiveAllocation
+        {
+            uintptr_t address;
+            uint32_t size;
+            uint32_t sequence; // Value of s_sequence when allocated
+            uint16_t caller; // Index into s_callers, OTHER_CALLER for s_otherCaller
+        };
+
+        static size_t liveHome(uintptr_t address) noexcept;
+        static uint16_t callerIndex(uintptr_t caller) noexcept;
+        static HeapCallerStats& callerAt(uint16_t index) noexcept;
+        static void eraseLive(size_t slot) noexcept;
+
+        static inline std::array<LiveAllocation, HEAP_LIVE_SLOTS> s_live{};
+        static inline std::array<HeapCallerStats, HEAP_CALLER_SLOTS> s_callers{};
+        static inline HeapCallerStats s_otherCaller{};
+        static inline HeapSummary s_summary{};
+        static inline uint32_t s_heapSize{0};
+        static inline uint32_t s_sequence{0};
+    };
+} // namespace rtt::trace
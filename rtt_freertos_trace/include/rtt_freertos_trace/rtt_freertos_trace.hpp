@@ -35,9 +35,9 @@ namespace rtt::trace
     public:
         /**
          * @brief Initialize tracing system
-         * @param channel RTT channel for trace output
+         * @param channel RTT channel for trace output (default: 2, DataSender defaults to 1)
          */
-        static void initialize(uint8_t channel = 1) noexcept;
+        static void initialize(uint8_t channel = 2) noexcept;
 
         /**
          * @brief Start tracing
@@ -60,10 +60,81 @@ namespace rtt::trace
          */
         static void recordEvent(TraceEventType type, uint32_t handle, uint32_t data = 0) noexcept;
 
+        /**
+         * @brief Move staged events to RTT (call from the idle hook or a trace task)
+         */
+        static void drain() noexcept;
+
+        /**
+         * @brief Select recorded event categories (bitwise OR of TraceCategory)
+         */
+        static void setCategoryMask(uint32_t mask) noexcept;
+
+        /**
+         * @brief Get the configured category mask
+         */
+        [[nodiscard]] static uint32_t getCategoryMask() noexcept;
+
+        /**
+         * @brief Configure per-handle filtering for the given categories
+         */
+        static void setHandleFilter(TraceFilterMode mode, uint32_t categories = TRACE_CATEGORY_ALL) noexcept;
+
+        /**
+         * @brief Add a handle to the filter list
+         * @return false if the filter list is full
+         */
+        static bool addHandleFilter(uint32_t handle) noexcept;
+
+        /**
+         * @brief Remove all handles from the filter list
+         */
+        static void clearHandleFilters() noexcept;
+
+        /**
+         * @brief Select the behavior when the trace buffers are full
+         */
+        static void setMode(TraceBufferMode mode) noexcept;
+
+        /**
+         * @brief Get the configured buffer mode
+         */
+        [[nodiscard]] static TraceBufferMode getMode() noexcept;
+
+        /**
+         * @brief Send the flight recorder contents to the trace channel
+         */
+        static void dumpFlightRecorder() noexcept;
+
+        /**
+         * @brief Discard all flight recorder events
+         */
+        static void clearFlightRecorder() noexcept;
+
+        /**
+         * @brief Get the number of events lost because the trace buffers were full
+         */
+        [[nodiscard]] static uint32_t droppedEvents() noexcept;
+
         /**
          * @brief Register a task for tracing (using std::string_view)
          */
         static void registerTask(uint32_t handle, std::string_view name) noexcept;
+
+        /**
+         * @brief Free the registry entry of a deleted task
+         */
+        static void unregisterTask(uint32_t handle) noexcept;
+
+        /**
+         * @brief Have the next drain resend the task registry
+         */
+        static void requestRegistry() noexcept;
+
+        /**
+         * @brief Set the registry resend interval in timebase ticks (0 disables it)
+         */
+        static void setRegistryInterval(uint32_t ticks) noexcept;
     };
 } // namespace rtt::trace
 
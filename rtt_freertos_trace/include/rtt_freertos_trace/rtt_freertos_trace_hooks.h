@@ -46,14 +46,83 @@ typedef enum
     TRACE_EVENT_TIMER_STOP = 0x52,
     TRACE_EVENT_MALLOC = 0x60,
     TRACE_EVENT_FREE = 0x61,
+    TRACE_EVENT_EVENTS_LOST = 0x70, // Emitted by the library: timestamp of first loss, data = lost count
 } TraceEventType;
 
+/**
+ * @brief Trace event categories (bit = 1 << (event type >> 4))
+ */
+typedef enum
+{
+    TRACE_CATEGORY_TASK = 1u << 0,
+    TRACE_CATEGORY_ISR = 1u << 1,
+    TRACE_CATEGORY_QUEUE = 1u << 2,
+    TRACE_CATEGORY_SEMAPHORE = 1u << 3,
+    TRACE_CATEGORY_MUTEX = 1u << 4,
+    TRACE_CATEGORY_TIMER = 1u << 5,
+    TRACE_CATEGORY_HEAP = 1u << 6,
+    TRACE_CATEGORY_ALL = 0x7Fu,
+} TraceCategory;
+
+/**
+ * @brief Per-handle filter modes
+ */
+typedef enum
+{
+    TRACE_FILTER_NONE = 0, // No per-handle filtering
+    TRACE_FILTER_INCLUDE, // Only record listed handles
+    TRACE_FILTER_EXCLUDE, // Record everything except listed handles
+} TraceFilterMode;
+
+/**
+ * @brief Behavior when the trace channel or the staging ring is full
+ */
+typedef enum
+{
+    TRACE_MODE_BLOCK = 0, // Wait for the host to read (default, never loses RTT data)
+    TRACE_MODE_SKIP, // Never wait; drop new events while full
+    TRACE_MODE_OVERWRITE, // Never wait; discard the oldest staged events while full
+    TRACE_MODE_FLIGHT_RECORDER, // Never stream; keep the latest events in no-init RAM until dumped
+} TraceBufferMode;
+
+/**
+ * @brief Category bit of an event type
+ */
+#define RTT_TRACE_CATEGORY_OF(event_type) (1u << (((uint32_t)(event_type)) >> 4))
+
+/**
+ * @brief Categories currently recorded (0 while tracing is stopped)
+ *
+ * Read inline by the hook macros so disabled categories cost one load and a
+ * branch. Change it with rtt_trace_set_category_mask().
+ */
+extern volatile uint32_t rtt_trace_active_categories;
+
+/**
+ * @brief Check inline whether events of a type are currently recorded
+ */
+#define RTT_TRACE_CATEGORY_ENABLED(event_type) \
+    ((rtt_trace_active_categories & RTT_TRACE_CATEGORY_OF(event_type)) != 0u)
+
+/**
+ * @brief Record an event if its category is enabled (used by the hook macros)
+ */
+#define RTT_TRACE_RECORD(event_type, handle, data)                  \
+    do                                                              \
+    {                                                               \
+        if (RTT_TRACE_CATEGORY_ENABLED(event_type))                 \
+        {                                                           \
+            rtt_trace_record_event((event_type), (handle), (data)); \
+        }                                                           \
+    }                                                               \
+    while (0)
+
 /**
  * @brief Trace event structure
  *
  * Compact binary format for efficient RTT transmission:
  * - Event type (1 byte)
- * - Timestamp (4 bytes) - system tick count
+ * - Timestamp (4 bytes) - timebase ticks (low 32 bits, CPU cycles on Cortex-M)
  * - Task/Object handle (4 bytes)
  * - Additional data (4 bytes) - context-dependent
  */
@@ -65,11 +134,18 @@ typedef struct __attribute__((packed))
     uint32_t data;
 } TraceEvent;
 
+/**
+ * @brief Name the trace claims its channel under (rtt::ChannelManager, RTT viewers)
+ */
+#define RTT_TRACE_CHANNEL_NAME "FreeRTOS Trace"
+
 /**
  * @brief Initialize the FreeRTOS trace system
  *
- * @param trace_channel RTT channel to use for trace output (default: 1)
- * @return 0 on success, negative on error
+ * Claims the channel as RTT_TRACE_CHANNEL_NAME from rtt::ChannelManager; if
+ * another stream owns it, the trace stays uninitialized and records nothing.
+ *
+ * @param trace_channel RTT channel to use for trace output (FreeRtosTrace::initialize() defaults to 2)
  */
 void rtt_trace_init(uint8_t trace_channel);
 
@@ -92,12 +168,104 @@ int rtt_trace_is_enabled(void);
 /**
  * @brief Record a trace event
  *
+ * Lock-free and safe to call from nested interrupts; interrupts stay enabled.
+ *
  * @param event_type Type of event
  * @param handle Task or object handle
  * @param data Additional event-specific data
  */
 void rtt_trace_record_event(TraceEventType event_type, uint32_t handle, uint32_t data);
 
+/**
+ * @brief Move staged events to the RTT channel
+ *
+ * Call from the idle hook or a low-priority trace task so the copy into RTT
+ * happens outside the scheduler and interrupt paths. Recording contexts only
+ * drain on their own once the ring reaches RTT_TRACE_DRAIN_WATERMARK.
+ * Returns immediately if another context is already draining.
+ */
+void rtt_trace_drain(void);
+
+/**
+ * @brief Select which event categories are recorded
+ *
+ * @param mask Bitwise OR of TraceCategory values (default: TRACE_CATEGORY_ALL)
+ */
+void rtt_trace_set_category_mask(uint32_t mask);
+
+/**
+ * @brief Get the configured category mask
+ * @return Bitwise OR of TraceCategory values
+ */
+uint32_t rtt_trace_get_category_mask(void);
+
+/**
+ * @brief Configure per-handle filtering
+ *
+ * @param mode Filter mode
+ * @param categories Categories the filter applies to (others are not filtered)
+ */
+void rtt_trace_set_handle_filter(TraceFilterMode mode, uint32_t categories);
+
+/**
+ * @brief Add a handle to the filter list
+ *
+ * @param handle Task or object handle
+ * @return 0 on success, -1 if the filter list is full
+ */
+int rtt_trace_add_handle_filter(uint32_t handle);
+
+/**
+ * @brief Remove all handles from the filter list
+ */
+void rtt_trace_clear_handle_filters(void);
+
+/**
+ * @brief Select the behavior when the trace buffers are full
+ *
+ * In the non-blocking modes the RTT channel is switched to
+ * SEGGER_RTT_MODE_NO_BLOCK_SKIP, events are only drained as far as they fit,
+ * and lost events are reported in-band with a TRACE_EVENT_EVENTS_LOST record
+ * once there is space again.
+ *
+ * @param mode Buffer mode (default: TRACE_MODE_BLOCK)
+ */
+void rtt_trace_set_mode(TraceBufferMode mode);
+
+/**
+ * @brief Get the configured buffer mode
+ * @return Buffer mode
+ */
+TraceBufferMode rtt_trace_get_mode(void);
+
+/**
+ * @brief Send the flight recorder contents to the trace channel
+ *
+ * Emits the stream header, a TRACE_SNAPSHOT marker, the task registry and the
+ * last RTT_TRACE_FLIGHT_RECORDER_SIZE events (oldest first), followed by
+ * TRACE_SNAPSHOT_END. Intended as a fault callback (see rtt_fault_handler) or
+ * an explicit trigger. The recorder lives in RTT_TRACE_NOINIT_SECTION, so
+ * events recorded before a warm reset can still be dumped after it.
+ */
+void rtt_trace_flight_recorder_dump(void);
+
+/**
+ * @brief Discard all flight recorder events
+ */
+void rtt_trace_flight_recorder_clear(void);
+
+/**
+ * @brief Get the number of events held by the flight recorder
+ * @return Event count (at most RTT_TRACE_FLIGHT_RECORDER_SIZE)
+ */
+uint32_t rtt_trace_flight_recorder_count(void);
+
+/**
+ * @brief Get the number of events lost because the trace buffers were full
+ * @return Lost event count since rtt_trace_init()
+ */
+uint32_t rtt_trace_get_dropped_events(void);
+
 /**
  * @brief Get current timestamp for tracing (in ticks)
  * @return Current tick count
@@ -107,17 +275,83 @@ uint32_t rtt_trace_get_timestamp(void);
 /**
  * @brief Register a task name for better trace readability
  *
+ * Called by traceTASK_CREATE for every task unless RTT_TRACE_AUTO_REGISTER is
+ * 0; may be called before rtt_trace_init(). Registering a known handle again
+ * renames it (a new task can reuse the TCB of a deleted one). Up to
+ * RTT_TRACE_MAX_TASKS handles are kept at a time; RTT_TRACE_V2 encodes their
+ * events with the registry index instead of the handle.
+ *
  * @param handle Task handle
  * @param name Task name (will be copied)
- * @param name_len Length of name
+ * @param name_len Length of name, or size of the array holding a NUL-terminated name
  */
 void rtt_trace_register_task(uint32_t handle, const char* name, size_t name_len);
 
+/**
+ * @brief Free the registry entry of a task
+ *
+ * Called by traceTASK_DELETE unless RTT_TRACE_AUTO_REGISTER is 0, so tasks
+ * that are created and deleted repeatedly do not fill the registry. The last
+ * entry takes over the freed index; while tracing, the next drain resends the
+ * registry.
+ *
+ * @param handle Task handle (ignored if it is not registered)
+ */
+void rtt_trace_unregister_task(uint32_t handle);
+
 /**
  * @brief Send task registry to RTT for Python parser
+ *
+ * The registry is a binary TASK_REGISTRY_BIN block. It is also sent by
+ * rtt_trace_start(), by the next drain after a task was registered or
+ * unregistered while tracing, after rtt_trace_request_registry() and every
+ * registry interval.
  */
 void rtt_trace_send_task_registry(void);
 
+/**
+ * @brief Have the next drain resend the task registry
+ *
+ * For command handlers, e.g. when a host attaches to a running trace. Safe
+ * from interrupts.
+ */
+void rtt_trace_request_registry(void);
+
+/**
+ * @brief Set how often the task registry is resent while tracing
+ *
+ * @param ticks Interval in timebase ticks, 0 to disable (default RTT_TRACE_REGISTRY_INTERVAL)
+ */
+void rtt_trace_set_registry_interval(uint32_t ticks);
+
+/**
+ * @brief Record an allocation in the heap profiler (traceMALLOC with RTT_TRACE_HEAP_PROFILER)
+ *
+ * @param address Allocated block (NULL for a failed allocation)
+ * @param size Requested size in bytes
+ * @param caller Return address of the allocator
+ */
+void rtt_heap_profiler_malloc(void* address, size_t size, void* caller);
+
+/**
+ * @brief Record a free in the heap profiler (traceFREE with RTT_TRACE_HEAP_PROFILER)
+ *
+ * @param address Freed block
+ */
+void rtt_heap_profiler_free(void* address);
+
+/**
+ * @brief Send the heap profiler report over the default rtt_data channel
+ *
+ * Suitable as a malloc failed callback (see FreeRtosHooks::setMallocFailedCallback).
+ */
+void rtt_heap_profiler_report(void);
+
+/**
+ * @brief Forget all allocations and callers recorded by the heap profiler
+ */
+void rtt_heap_profiler_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -136,77 +370,159 @@ void rtt_trace_send_task_registry(void);
  * ```
  */
 
+/*
+ * System monitor hooks of rtt_freertos_hooks, chained into the task macros
+ * below. They expand to nothing unless rtt_system_monitor_hooks.h was
+ * included before this header.
+ */
+#ifndef RTT_MONITOR_TASK_SWITCHED_IN
+#define RTT_MONITOR_TASK_SWITCHED_IN() ((void)0)
+#endif
+
+#ifndef RTT_MONITOR_TASK_SWITCHED_OUT
+#define RTT_MONITOR_TASK_SWITCHED_OUT() ((void)0)
+#endif
+
+#ifndef RTT_MONITOR_TASK_CREATE
+#define RTT_MONITOR_TASK_CREATE(pxNewTCB) ((void)0)
+#endif
+
+#ifndef RTT_MONITOR_TASK_DELETE
+#define RTT_MONITOR_TASK_DELETE(pxTaskToDelete) ((void)0)
+#endif
+
+/*
+ * traceTASK_CREATE registers every task under its TCB name, so traces name
+ * tasks without rtt_trace_register_task() calls in the application. Define
+ * RTT_TRACE_AUTO_REGISTER to 0 to register tasks by hand only.
+ */
+#ifndef RTT_TRACE_AUTO_REGISTER
+#define RTT_TRACE_AUTO_REGISTER 1
+#endif
+
+#if RTT_TRACE_AUTO_REGISTER
+#define RTT_TRACE_REGISTER_TCB(pxNewTCB) \
+    rtt_trace_register_task((uint32_t)(pxNewTCB), (pxNewTCB)->pcTaskName, sizeof((pxNewTCB)->pcTaskName))
+#define RTT_TRACE_UNREGISTER_TCB(pxTaskToDelete) rtt_trace_unregister_task((uint32_t)(pxTaskToDelete))
+#else
+#define RTT_TRACE_REGISTER_TCB(pxNewTCB) ((void)0)
+#define RTT_TRACE_UNREGISTER_TCB(pxTaskToDelete) ((void)0)
+#endif
+
 #ifndef traceTASK_SWITCHED_IN
-#define traceTASK_SWITCHED_IN() \
-    rtt_trace_record_event(TRACE_EVENT_TASK_SWITCHED_IN, (uint32_t)pxCurrentTCB, 0)
+#define traceTASK_SWITCHED_IN()                                                   \
+    do                                                                            \
+    {                                                                             \
+        RTT_MONITOR_TASK_SWITCHED_IN();                                           \
+        RTT_TRACE_RECORD(TRACE_EVENT_TASK_SWITCHED_IN, (uint32_t)pxCurrentTCB, 0); \
+    }                                                                             \
+    while (0)
 #endif
 
 #ifndef traceTASK_SWITCHED_OUT
-#define traceTASK_SWITCHED_OUT() \
-    rtt_trace_record_event(TRACE_EVENT_TASK_SWITCHED_OUT, (uint32_t)pxCurrentTCB, 0)
+#define traceTASK_SWITCHED_OUT()                                                   \
+    do                                                                             \
+    {                                                                              \
+        RTT_TRACE_RECORD(TRACE_EVENT_TASK_SWITCHED_OUT, (uint32_t)pxCurrentTCB, 0); \
+        RTT_MONITOR_TASK_SWITCHED_OUT();                                           \
+    }                                                                              \
+    while (0)
 #endif
 
 #ifndef traceTASK_CREATE
-#define traceTASK_CREATE(pxNewTCB) \
-    rtt_trace_record_event(TRACE_EVENT_TASK_CREATE, (uint32_t)pxNewTCB, 0)
+#define traceTASK_CREATE(pxNewTCB)                                            \
+    do                                                                        \
+    {                                                                         \
+        RTT_TRACE_REGISTER_TCB(pxNewTCB);                                     \
+        RTT_MONITOR_TASK_CREATE(pxNewTCB);                                    \
+        RTT_TRACE_RECORD(TRACE_EVENT_TASK_CREATE, (uint32_t)pxNewTCB, 0);     \
+    }                                                                         \
+    while (0)
 #endif
 
 #ifndef traceTASK_DELETE
-#define traceTASK_DELETE(pxTaskToDelete) \
-    rtt_trace_record_event(TRACE_EVENT_TASK_DELETE, (uint32_t)pxTaskToDelete, 0)
+#define traceTASK_DELETE(pxTaskToDelete)                                          \
+    do                                                                            \
+    {                                                                             \
+        RTT_TRACE_RECORD(TRACE_EVENT_TASK_DELETE, (uint32_t)pxTaskToDelete, 0);   \
+        RTT_MONITOR_TASK_DELETE(pxTaskToDelete);                                  \
+        RTT_TRACE_UNREGISTER_TCB(pxTaskToDelete);                                 \
+    }                                                                             \
+    while (0)
 #endif
 
 #ifndef traceMOVED_TASK_TO_READY_STATE
 #define traceMOVED_TASK_TO_READY_STATE(pxTCB) \
-    rtt_trace_record_event(TRACE_EVENT_TASK_READY, (uint32_t)pxTCB, 0)
+    RTT_TRACE_RECORD(TRACE_EVENT_TASK_READY, (uint32_t)pxTCB, 0)
 #endif
 
 #ifndef traceTASK_SUSPEND
 #define traceTASK_SUSPEND(pxTaskToSuspend) \
-    rtt_trace_record_event(TRACE_EVENT_TASK_SUSPENDED, (uint32_t)pxTaskToSuspend, 0)
+    RTT_TRACE_RECORD(TRACE_EVENT_TASK_SUSPENDED, (uint32_t)pxTaskToSuspend, 0)
 #endif
 
 #ifndef traceTASK_RESUME
 #define traceTASK_RESUME(pxTaskToResume) \
-    rtt_trace_record_event(TRACE_EVENT_TASK_RESUMED, (uint32_t)pxTaskToResume, 0)
+    RTT_TRACE_RECORD(TRACE_EVENT_TASK_RESUMED, (uint32_t)pxTaskToResume, 0)
 #endif
 
 #ifndef traceTASK_RESUME_FROM_ISR
 #define traceTASK_RESUME_FROM_ISR(pxTaskToResume) \
-    rtt_trace_record_event(TRACE_EVENT_TASK_RESUMED, (uint32_t)pxTaskToResume, 1)
+    RTT_TRACE_RECORD(TRACE_EVENT_TASK_RESUMED, (uint32_t)pxTaskToResume, 1)
 #endif
 
 #ifndef traceISR_ENTER
 #define traceISR_ENTER() \
-    rtt_trace_record_event(TRACE_EVENT_ISR_ENTER, 0, 0)
+    RTT_TRACE_RECORD(TRACE_EVENT_ISR_ENTER, 0, 0)
 #endif
 
 #ifndef traceISR_EXIT
 #define traceISR_EXIT() \
-    rtt_trace_record_event(TRACE_EVENT_ISR_EXIT, 0, 0)
+    RTT_TRACE_RECORD(TRACE_EVENT_ISR_EXIT, 0, 0)
 #endif
 
 #ifndef traceQUEUE_CREATE
 #define traceQUEUE_CREATE(pxNewQueue) \
-    rtt_trace_record_event(TRACE_EVENT_QUEUE_CREATE, (uint32_t)pxNewQueue, 0)
+    RTT_TRACE_RECORD(TRACE_EVENT_QUEUE_CREATE, (uint32_t)pxNewQueue, 0)
 #endif
 
 #ifndef traceQUEUE_SEND
 #define traceQUEUE_SEND(pxQueue) \
-    rtt_trace_record_event(TRACE_EVENT_QUEUE_SEND, (uint32_t)pxQueue, 0)
+    RTT_TRACE_RECORD(TRACE_EVENT_QUEUE_SEND, (uint32_t)pxQueue, 0)
 #endif
 
 #ifndef traceQUEUE_RECEIVE
 #define traceQUEUE_RECEIVE(pxQueue) \
-    rtt_trace_record_event(TRACE_EVENT_QUEUE_RECEIVE, (uint32_t)pxQueue, 0)
+    RTT_TRACE_RECORD(TRACE_EVENT_QUEUE_RECEIVE, (uint32_t)pxQueue, 0)
+#endif
+
+/*
+ * With RTT_TRACE_HEAP_PROFILER the heap macros aggregate into the heap
+ * profiler instead of streaming raw events. They expand inside pvPortMalloc
+ * and vPortFree, so the return address is the allocating call site.
+ */
+#if RTT_TRACE_HEAP_PROFILER
+
+#ifndef traceMALLOC
+#define traceMALLOC(pvAddress, uiSize) \
+    rtt_heap_profiler_malloc((pvAddress), (size_t)(uiSize), __builtin_return_address(0))
+#endif
+
+#ifndef traceFREE
+#define traceFREE(pvAddress, uiSize) \
+    rtt_heap_profiler_free(pvAddress)
 #endif
 
+#else
+
 #ifndef traceMALLOC
 #define traceMALLOC(pvAddress, uiSize) \
-    rtt_trace_record_event(TRACE_EVENT_MALLOC, (uint32_t)pvAddress, (uint32_t)uiSize)
+    RTT_TRACE_RECORD(TRACE_EVENT_MALLOC, (uint32_t)pvAddress, (uint32_t)uiSize)
 #endif
 
 #ifndef traceFREE
 #define traceFREE(pvAddress, uiSize) \
-    rtt_trace_record_event(TRACE_EVENT_FREE, (uint32_t)pvAddress, (uint32_t)uiSize)
+    RTT_TRACE_RECORD(TRACE_EVENT_FREE, (uint32_t)pvAddress, (uint32_t)uiSize)
 #endif
+
+#endif // RTT_TRACE_HEAP_PROFILER
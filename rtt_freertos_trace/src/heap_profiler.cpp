@@ -0,0 +1,259 @@
+#include <rtt_freertos_trace/heap_profiler.hpp>
+
+namespace rtt::trace
+{
+    namespace
+    {
+        constexpr uint32_t FIBONACCI_HASH{2654435769U};
+
+        uint32_t toAddress(uintptr_t value)
+        {
+            return static_cast<uint32_t>(value);
+        }
+    } // namespace
+
+    size_t HeapProfiler::liveHome(uintptr_t address) noexcept
+    {
+        // Blocks are at least 8-byte aligned, so the low bits carry no information
+        return (static_cast<uint32_t>(address >> 3) * FIBONACCI_HASH) & (HEAP_LIVE_SLOTS - 1);
+    }
+
+    uint16_t HeapProfiler::callerIndex(uintptr_t caller) noexcept
+    {
+        size_t slot = (static_cast<uint32_t>(caller >> 1) * FIBONACCI_HASH) & (HEAP_CALLER_SLOTS - 1);
+        for (size_t probe = 0; probe < HEAP_CALLER_SLOTS; ++probe)
+        {
+            HeapCallerStats& stats = s_callers[slot];
+            if (stats.caller == toAddress(caller))
+            {
+                return static_cast<uint16_t>(slot);
+            }
+            if (stats.caller == 0)
+            {
+                stats.caller = toAddress(caller);
+                ++s_summary.callers;
+                return static_cast<uint16_t>(slot);
+            }
+            slot = (slot + 1) & (HEAP_CALLER_SLOTS - 1);
+        }
+        return OTHER_CALLER;
+    }
+
+    HeapCallerStats& HeapProfiler::callerAt(uint16_t index) noexcept
+    {
+        return index < HEAP_CALLER_SLOTS ? s_callers[index] : s_otherCaller;
+    }
+
+    void HeapProfiler::recordMalloc(const void* address, size_t size, const void* caller) noexcept
+    {
+        const auto callerAddress = reinterpret_cast<uintptr_t>(caller);
+        if (address == nullptr)
+        {
+            ++s_summary.failures;
+            s_summary.failedSize = static_cast<uint32_t>(size);
+            s_summary.failedCaller = toAddress(callerAddress);
+            return;
+        }
+
+        const auto bytes = static_cast<uint32_t>(size);
+        const uint16_t index = callerAddress != 0 ? callerIndex(callerAddress) : OTHER_CALLER;
+        HeapCallerStats& stats = callerAt(index);
+        ++stats.allocations;
+        stats.totalBytes += bytes;
+        stats.largest = bytes > stats.largest ? bytes : stats.largest;
+        ++s_summary.allocations;
+        ++s_sequence;
+
+        if (s_summary.liveCount >= MAX_LIVE)
+        {
+            // Untracked blocks are not in the live totals; their frees count as unknown
+            ++s_summary.untracked;
+            return;
+        }
+
+        size_t slot = liveHome(reinterpret_cast<uintptr_t>(address));
+        while (s_live[slot].address != 0)
+        {
+            slot = (slot + 1) & (HEAP_LIVE_SLOTS - 1);
+        }
+        s_live[slot] = LiveAllocation{reinterpret_cast<uintptr_t>(address), bytes, s_sequence, index};
+
+        ++stats.liveCount;
+        stats.liveBytes += bytes;
+        stats.peakBytes = stats.liveBytes > stats.peakBytes ? stats.liveBytes : stats.peakBytes;
+        ++s_summary.liveCount;
+        s_summary.liveBytes += bytes;
+        s_summary.peakBytes = s_summary.liveBytes > s_summary.peakBytes ? s_summary.liveBytes : s_summary.peakBytes;
+    }
+
+    void HeapProfiler::recordFree(const void* address) noexcept
+    {
+        const auto key = reinterpret_cast<uintptr_t>(address);
+        if (key == 0)
+        {
+            return;
+        }
+
+        for (size_t slot = liveHome(key); s_live[slot].address != 0; slot = (slot + 1) & (HEAP_LIVE_SLOTS - 1))
+        {
+            if (s_live[slot].address == key)
+            {
+                const LiveAllocation& allocation = s_live[slot];
+                HeapCallerStats& stats = callerAt(allocation.caller);
+                ++stats.frees;
+                --stats.liveCount;
+                stats.liveBytes -= allocation.size;
+                ++s_summary.frees;
+                --s_summary.liveCount;
+                s_summary.liveBytes -= allocation.size;
+                eraseLive(slot);
+                return;
+            }
+        }
+        ++s_summary.unknownFrees;
+    }
+
+    void HeapProfiler::eraseLive(size_t slot) noexcept
+    {
+        // Backward-shift deletion: move later entries of the probe run into the hole
+        size_t hole = slot;
+        for (size_t next = (hole + 1) & (HEAP_LIVE_SLOTS - 1); s_live[next].address != 0;
+             next = (next + 1) & (HEAP_LIVE_SLOTS - 1))
+        {
+            const size_t home = liveHome(s_live[next].address);
+            const size_t distanceToHole = (hole - home) & (HEAP_LIVE_SLOTS - 1);
+            const size_t distanceToNext = (next - home) & (HEAP_LIVE_SLOTS - 1);
+            if (distanceToHole < distanceToNext)
+            {
+                s_live[hole] = s_live[next];
+                hole = next;
+            }
+        }
+        s_live[hole] = LiveAllocation{};
+    }
+
+    HeapSummary HeapProfiler::getSummary() noexcept
+    {
+        HeapSummary summary = s_summary;
+        summary.heapSize = s_heapSize;
+        summary.callers += (s_otherCaller.allocations > 0) ? 1 : 0;
+        summary.leakCandidates = static_cast<uint32_t>(
+            summary.liveCount < HEAP_LEAK_CANDIDATES ? summary.liveCount : HEAP_LEAK_CANDIDATES);
+        return summary;
+    }
+
+    size_t HeapProfiler::getCallers(HeapCallerStats* out, size_t capacity) noexcept
+    {
+        if (out == nullptr)
+        {
+            return 0;
+        }
+
+        size_t count = 0;
+        for (const auto& stats : s_callers)
+        {
+            if (stats.caller != 0 && count < capacity)
+            {
+                out[count++] = stats;
+            }
+        }
+        if (s_otherCaller.allocations > 0 && count < capacity)
+        {
+            out[count++] = s_otherCaller;
+        }
+        return count;
+    }
+
+    size_t HeapProfiler::getLeakCandidates(HeapLeakCandidate* out, size_t capacity) noexcept
+    {
+        if (out == nullptr || capacity == 0)
+        {
+            return 0;
+        }
+
+        // Insertion into a short sorted list: the oldest allocation has the largest age
+        size_t count = 0;
+        for (const auto& allocation : s_live)
+        {
+            if (allocation.address == 0)
+            {
+                continue;
+            }
+
+            const HeapLeakCandidate candidate{toAddress(allocation.address), allocation.size,
+                                              callerAt(allocation.caller).caller, s_sequence - allocation.sequence};
+            size_t position = count;
+            while (position > 0 && out[position - 1].age < candidate.age)
+            {
+                if (position < capacity)
+                {
+                    out[position] = out[position - 1];
+                }
+                --position;
+            }
+            if (position < capacity)
+            {
+                out[position] = candidate;
+                count = count < capacity ? count + 1 : capacity;
+            }
+        }
+        return count;
+    }
+
+    size_t HeapProfiler::report(data::DataSender& sender) noexcept
+    {
+        const HeapSummary summary = getSummary();
+        size_t sent = sender.sendStruct(summary);
+
+        for (const auto& stats : s_callers)
+        {
+            if (stats.caller != 0)
+            {
+                sent += sender.sendStruct(stats);
+            }
+        }
+        if (s_otherCaller.allocations > 0)
+        {
+            sent += sender.sendStruct(s_otherCaller);
+        }
+
+        std::array<HeapLeakCandidate, HEAP_LEAK_CANDIDATES> candidates{};
+        const size_t count = getLeakCandidates(candidates.data(), candidates.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            sent += sender.sendStruct(candidates[i]);
+        }
+        return sent;
+    }
+
+    void HeapProfiler::reset() noexcept
+    {
+        s_live.fill(LiveAllocation{});
+        s_callers.fill(HeapCallerStats{});
+        s_otherCaller = HeapCallerStats{};
+        s_summary = HeapSummary{};
+        s_sequence = 0;
+    }
+} // namespace rtt::trace
+
+extern "C" {
+void rtt_heap_profiler_malloc(void* address, size_t size, void* caller)
+{
+    rtt::trace::HeapProfiler::recordMalloc(address, size, caller);
+}
+
+void rtt_heap_profiler_free(void* address)
+{
+    rtt::trace::HeapProfiler::recordFree(address);
+}
+
+void rtt_heap_profiler_report(void)
+{
+    (void)rtt::trace::HeapProfiler::report();
+}
+
+void rtt_heap_profiler_reset(void)
+{
+    rtt::trace::HeapProfiler::reset();
+}
+} // extern "C"
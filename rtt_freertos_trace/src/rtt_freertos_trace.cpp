@@ -1,12 +1,102 @@
 #include <rtt_freertos_trace/rtt_freertos_trace.hpp>
+#include <rtt_channels/rtt_channels.hpp>
+#include <rtt_logger/mpsc_ring.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
 #include <SEGGER_RTT.h>
 #include <string.h>
-#include <cstdio>
+#include <atomic>
+
+#ifndef RTT_TRACE_RING_CAPACITY
+#if RTT_TRACE_DEFERRED_DRAIN
+#define RTT_TRACE_RING_CAPACITY 64 // Room for the events between two idle-time drains
+#else
+#define RTT_TRACE_RING_CAPACITY 32
+#endif
+#endif
+
+// Fill level at which a recording context drains the ring itself
+#ifndef RTT_TRACE_DRAIN_WATERMARK
+#if RTT_TRACE_DEFERRED_DRAIN
+#define RTT_TRACE_DRAIN_WATERMARK (RTT_TRACE_RING_CAPACITY - RTT_TRACE_RING_CAPACITY / 4)
+#else
+#define RTT_TRACE_DRAIN_WATERMARK (RTT_TRACE_RING_CAPACITY / 2)
+#endif
+#endif
+
+#ifndef RTT_TRACE_MAX_TASKS
+#define RTT_TRACE_MAX_TASKS 32
+#endif
+
+// Registry resend interval in timebase ticks while tracing (0: only on request and when tasks change)
+#ifndef RTT_TRACE_REGISTRY_INTERVAL
+#define RTT_TRACE_REGISTRY_INTERVAL 0
+#endif
 
 constexpr size_t MAX_TASK_NAME_LEN{16};
-constexpr size_t MAX_REGISTERED_TASKS{32};
-constexpr size_t TRACE_BUFFER_SIZE{512};
+constexpr size_t MAX_REGISTERED_TASKS{RTT_TRACE_MAX_TASKS};
+static_assert(MAX_REGISTERED_TASKS > 0 && MAX_REGISTERED_TASKS < 255, "RTT_TRACE_MAX_TASKS must be 1..254");
+
+/**
+ * @brief Slots of the handle -> registry index hash (power of two, at most half used)
+ */
+static constexpr size_t rtt_trace_task_hash_slots()
+{
+    size_t slots = 1;
+    while (slots < 2 * MAX_REGISTERED_TASKS)
+    {
+        slots <<= 1;
+    }
+    return slots;
+}
+constexpr size_t TASK_HASH_SLOTS{rtt_trace_task_hash_slots()};
+
+/**
+ * Binary task registry block: the marker line, a uint8 entry count, then per
+ * entry (in registry index order) a uint32 handle, a uint8 name length and
+ * the name bytes without terminator.
+ */
+constexpr char TASK_REGISTRY_MARKER[] = "TASK_REGISTRY_BIN\n";
+constexpr size_t TASK_REGISTRY_ENTRY_MAX_SIZE{sizeof(uint32_t) + 1 + MAX_TASK_NAME_LEN};
+#ifndef RTT_TRACE_FLIGHT_RECORDER_SIZE
+#define RTT_TRACE_FLIGHT_RECORDER_SIZE 64
+#endif
+
+// Section that is not cleared by the startup code (NOLOAD in the linker script)
+#ifndef RTT_TRACE_NOINIT_SECTION
+#define RTT_TRACE_NOINIT_SECTION ".noinit"
+#endif
+
+constexpr size_t TRACE_RING_CAPACITY{RTT_TRACE_RING_CAPACITY}; // Events staged before they go to RTT
+constexpr size_t TRACE_DRAIN_CHUNK{16}; // Events per RTT write while draining
+constexpr size_t TRACE_DRAIN_WATERMARK{RTT_TRACE_DRAIN_WATERMARK};
+static_assert(TRACE_DRAIN_WATERMARK > 0 && TRACE_DRAIN_WATERMARK <= TRACE_RING_CAPACITY,
+              "Drain watermark must be within the ring capacity");
+constexpr size_t MAX_HANDLE_FILTERS{8};
 constexpr size_t RTT_TRACE_BUFFER_SIZE{2048}; // RTT up-buffer size for trace channel
+constexpr size_t FLIGHT_RECORDER_SIZE{RTT_TRACE_FLIGHT_RECORDER_SIZE};
+constexpr uint32_t FLIGHT_RECORDER_MAGIC{0x52465452}; // "RTFR"
+static_assert(FLIGHT_RECORDER_SIZE >= 2 && (FLIGHT_RECORDER_SIZE & (FLIGHT_RECORDER_SIZE - 1)) == 0,
+              "RTT_TRACE_FLIGHT_RECORDER_SIZE must be a power of two");
+
+#if RTT_TRACE_V2
+/**
+ * RTT_TRACE_V2 event encoding, produced when events are drained:
+ * - type byte, bit 7 set if a data varint follows
+ * - zigzag varint timestamp delta to the previous event
+ * - varint handle: (index << 1) | 1 for tasks in the last sent registry, handle << 1 otherwise
+ * - varint data (only if non-zero)
+ * Every drain starts with a sync record (0x7E + absolute uint32 timestamp).
+ */
+constexpr uint8_t TRACE_V2_SYNC{0x7E};
+constexpr uint8_t TRACE_V2_HAS_DATA{0x80};
+constexpr size_t TRACE_V2_SYNC_SIZE{1 + sizeof(uint32_t)};
+constexpr size_t TRACE_V2_MAX_EVENT_SIZE{1 + 5 + 5 + 5}; // type, delta, 33-bit handle, data
+constexpr size_t TRACE_ENCODED_EVENT_SIZE{TRACE_V2_MAX_EVENT_SIZE};
+constexpr size_t TRACE_CHUNK_OVERHEAD{TRACE_V2_SYNC_SIZE};
+#else
+constexpr size_t TRACE_ENCODED_EVENT_SIZE{sizeof(TraceEvent)};
+constexpr size_t TRACE_CHUNK_OVERHEAD{0};
+#endif
 
 /**
  * @brief Static RTT buffer for trace channel
@@ -20,6 +110,7 @@ static char rtt_trace_buffer[RTT_TRACE_BUFFER_SIZE];
 typedef struct
 {
     uint32_t handle;
+    uint8_t name_len;
     char name[MAX_TASK_NAME_LEN];
 } TaskRegistryEntry;
 
@@ -32,44 +123,410 @@ static struct
     uint8_t enabled;
     uint8_t channel;
     TaskRegistryEntry task_registry[MAX_REGISTERED_TASKS];
+    uint8_t task_hash[TASK_HASH_SLOTS]; // Registry index + 1 per handle, 0 for free slots
     uint8_t num_registered_tasks;
-    uint8_t trace_buffer[TRACE_BUFFER_SIZE];
-    uint16_t buffer_pos;
-} trace_state = {0, 0, 0, {}, 0, {}, 0};
+    uint8_t num_announced_tasks; // Tasks the host knows from the last registry
+    uint32_t registry_interval;
+    uint32_t registry_sent_at;
+    uint32_t category_mask;
+    TraceFilterMode filter_mode;
+    uint32_t filter_categories;
+    uint32_t filter_handles[MAX_HANDLE_FILTERS];
+    uint8_t num_filter_handles;
+    TraceBufferMode buffer_mode;
+} trace_state = {0,  0, 0, {}, {}, 0, 0, RTT_TRACE_REGISTRY_INTERVAL, 0, TRACE_CATEGORY_ALL, TRACE_FILTER_NONE, 0, {},
+               0, TRACE_MODE_BLOCK};
+
+volatile uint32_t rtt_trace_active_categories = 0;
 
 /**
- * @brief Get timestamp from FreeRTOS or system timer
+ * @brief Staging ring for events
  *
- * @note For ARM Cortex-M processors, uses DWT CYCCNT for high-resolution timestamps.
- *       For other platforms, returns 0 (platform-specific implementation required).
+ * Hooks push from task and interrupt context without locking; whoever wins
+ * trace_drain_busy moves the events to RTT.
  */
-uint32_t rtt_trace_get_timestamp()
+static rtt::MpscRing<TraceEvent, TRACE_RING_CAPACITY> trace_ring;
+static std::atomic_flag trace_drain_busy = ATOMIC_FLAG_INIT;
+
+/**
+ * @brief Flight recorder ring (TRACE_MODE_FLIGHT_RECORDER)
+ *
+ * Kept in no-init RAM so that it survives a warm reset; the magic word tells a
+ * preserved ring from power-on garbage. Producers reserve a slot with one
+ * atomic increment and overwrite the oldest event.
+ */
+static struct FlightRecorder
+{
+    uint32_t magic;
+    std::atomic<uint32_t> head; // Events recorded so far (wraps)
+    TraceEvent events[FLIGHT_RECORDER_SIZE];
+} flight_recorder __attribute__((section(RTT_TRACE_NOINIT_SECTION)));
+
+/**
+ * @brief Lost event bookkeeping
+ *
+ * Losses are reported in-band with one TRACE_EVENT_EVENTS_LOST record per
+ * gap. In skip and block mode the events are lost after everything that is
+ * staged, so the record is staged by the next producer that finds space.
+ * In overwrite mode the oldest events are lost, so the drainer emits the
+ * record ahead of the remaining ones.
+ */
+static std::atomic<uint32_t> trace_lost_pending{0}; // Lost since the last loss record
+static std::atomic<uint32_t> trace_lost_since{0}; // Timestamp of the first pending loss
+static std::atomic<uint32_t> trace_lost_total{0};
+
+// Set when the host should get the registry again; sent by the next drain
+static std::atomic<bool> trace_registry_pending{false};
+
+/**
+ * @brief Home slot of a task handle in the hash
+ */
+static size_t rtt_trace_task_slot(uint32_t handle)
+{
+    // TCBs are word aligned, so the low bits carry no information
+    return ((handle >> 2) * 2654435769U) & (TASK_HASH_SLOTS - 1);
+}
+
+/**
+ * @brief Find the registry index of a task handle
+ * @return Index, or -1 if the handle is not registered
+ */
+static int rtt_trace_find_task(uint32_t handle)
+{
+    size_t slot = rtt_trace_task_slot(handle);
+    for (uint8_t index = trace_state.task_hash[slot]; index != 0; index = trace_state.task_hash[slot])
+    {
+        if (trace_state.task_registry[index - 1].handle == handle)
+        {
+            return index - 1;
+        }
+        slot = (slot + 1) & (TASK_HASH_SLOTS - 1);
+    }
+    return -1;
+}
+
+/**
+ * @brief Add a handle to the hash (the registry entry must already be filled in)
+ */
+static void rtt_trace_hash_task(uint32_t handle, uint8_t index)
+{
+    size_t slot = rtt_trace_task_slot(handle);
+    while (trace_state.task_hash[slot] != 0)
+    {
+        slot = (slot + 1) & (TASK_HASH_SLOTS - 1);
+    }
+    trace_state.task_hash[slot] = static_cast<uint8_t>(index + 1);
+}
+
+/**
+ * @brief Hash slot holding a registered handle
+ */
+static size_t rtt_trace_task_hash_slot(uint32_t handle)
+{
+    size_t slot = rtt_trace_task_slot(handle);
+    while (trace_state.task_registry[trace_state.task_hash[slot] - 1].handle != handle)
+    {
+        slot = (slot + 1) & (TASK_HASH_SLOTS - 1);
+    }
+    return slot;
+}
+
+/**
+ * @brief Remove a registered handle from the hash
+ *
+ * Later entries of the probe sequence move up into the gap, so lookups of
+ * the remaining handles still end at their entry without tombstones.
+ */
+static void rtt_trace_unhash_task(uint32_t handle)
+{
+    size_t gap = rtt_trace_task_hash_slot(handle);
+    for (size_t slot = (gap + 1) & (TASK_HASH_SLOTS - 1); trace_state.task_hash[slot] != 0;
+         slot = (slot + 1) & (TASK_HASH_SLOTS - 1))
+    {
+        const uint8_t index = trace_state.task_hash[slot];
+        const size_t home = rtt_trace_task_slot(trace_state.task_registry[index - 1].handle);
+        // The entry may fill the gap unless its home lies between the gap and its slot
+        if (((slot - home) & (TASK_HASH_SLOTS - 1)) >= ((slot - gap) & (TASK_HASH_SLOTS - 1)))
+        {
+            trace_state.task_hash[gap] = index;
+            gap = slot;
+        }
+    }
+    trace_state.task_hash[gap] = 0;
+}
+
+/**
+ * @brief Write the binary task registry block
+ * @return false if it did not fit into the channel (non-blocking modes)
+ */
+static bool rtt_trace_write_registry()
+{
+    const uint8_t count = trace_state.num_registered_tasks;
+    size_t size = sizeof(TASK_REGISTRY_MARKER) - 1 + 1;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        size += sizeof(uint32_t) + 1 + trace_state.task_registry[i].name_len;
+    }
+    if (trace_state.buffer_mode != TRACE_MODE_BLOCK && SEGGER_RTT_GetAvailWriteSpace(trace_state.channel) < size)
+    {
+        return false;
+    }
+
+    uint8_t record[TASK_REGISTRY_ENTRY_MAX_SIZE];
+    memcpy(record, TASK_REGISTRY_MARKER, sizeof(TASK_REGISTRY_MARKER) - 1);
+    record[sizeof(TASK_REGISTRY_MARKER) - 1] = count;
+    SEGGER_RTT_Write(trace_state.channel, record, sizeof(TASK_REGISTRY_MARKER));
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const TaskRegistryEntry& entry = trace_state.task_registry[i];
+        memcpy(record, &entry.handle, sizeof(entry.handle));
+        record[sizeof(entry.handle)] = entry.name_len;
+        memcpy(&record[sizeof(entry.handle) + 1], entry.name, entry.name_len);
+        SEGGER_RTT_Write(trace_state.channel, record, sizeof(entry.handle) + 1 + entry.name_len);
+    }
+
+    // From now on these tasks can be referenced by registry index
+    trace_state.num_announced_tasks = count;
+    trace_state.registry_sent_at = rtt::Timebase::now32();
+    return true;
+}
+
+#if RTT_TRACE_V2
+static size_t rtt_trace_put_varint(uint8_t* out, uint64_t value)
+{
+    size_t len = 0;
+    while (value >= 0x80)
+    {
+        out[len++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = static_cast<uint8_t>(value);
+    return len;
+}
+
+static uint64_t rtt_trace_encode_handle(uint32_t handle)
+{
+    const int index = rtt_trace_find_task(handle);
+    if (index >= 0 && index < trace_state.num_announced_tasks)
+    {
+        return (static_cast<uint64_t>(index) << 1) | 1;
+    }
+    return static_cast<uint64_t>(handle) << 1;
+}
+
+static size_t rtt_trace_encode_event(const TraceEvent& event, uint32_t& last_timestamp, uint8_t* out)
+{
+    size_t len = 0;
+    out[len++] = static_cast<uint8_t>(event.event_type | (event.data != 0 ? TRACE_V2_HAS_DATA : 0));
+
+    // Events from nested interrupts may be staged slightly out of order, hence zigzag
+    const auto delta = static_cast<int32_t>(event.timestamp - last_timestamp);
+    const uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+    last_timestamp = event.timestamp;
+    len += rtt_trace_put_varint(&out[len], zigzag);
+
+    len += rtt_trace_put_varint(&out[len], rtt_trace_encode_handle(event.handle));
+    if (event.data != 0)
+    {
+        len += rtt_trace_put_varint(&out[len], event.data);
+    }
+    return len;
+}
+#endif
+
+static void rtt_trace_add_pending_loss(uint32_t count, uint32_t timestamp)
+{
+    if (trace_lost_pending.load(std::memory_order_relaxed) == 0)
+    {
+        trace_lost_since.store(timestamp, std::memory_order_relaxed);
+    }
+    trace_lost_pending.fetch_add(count, std::memory_order_relaxed);
+}
+
+static void rtt_trace_count_lost(uint32_t timestamp)
+{
+    rtt_trace_add_pending_loss(1, timestamp);
+    trace_lost_total.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Turn the pending losses into a loss record
+ * @return false if nothing was lost
+ */
+static bool rtt_trace_take_lost(TraceEvent& record)
+{
+    // Read the timestamp first: a loss after the exchange starts a new gap
+    const uint32_t since = trace_lost_since.load(std::memory_order_relaxed);
+    const uint32_t lost = trace_lost_pending.exchange(0, std::memory_order_relaxed);
+    if (lost == 0)
+    {
+        return false;
+    }
+
+    record.event_type = TRACE_EVENT_EVENTS_LOST;
+    record.timestamp = since;
+    record.handle = 0;
+    record.data = lost;
+    return true;
+}
+
+/**
+ * @brief Stage a loss record behind the events that were kept
+ */
+static void rtt_trace_stage_lost_record()
+{
+    TraceEvent record;
+    if (rtt_trace_take_lost(record) && !trace_ring.tryPush(record))
+    {
+        // Still full, try again with the next event
+        rtt_trace_add_pending_loss(record.data, record.timestamp);
+    }
+}
+
+/**
+ * @brief Make room for an event by discarding the oldest staged one (overwrite mode)
+ * @return true if the event was stored
+ */
+static bool rtt_trace_overwrite_oldest(const TraceEvent& event)
 {
-#ifdef __ARM_ARCH
-    // Use DWT CYCCNT register for high-resolution timestamp on ARM Cortex-M
-    static volatile uint32_t* DWT_CYCCNT = (uint32_t*)0xE0001004;
-    static volatile uint32_t* DWT_CONTROL = (uint32_t*)0xE0001000;
-    static volatile uint32_t* SCB_DEMCR = (uint32_t*)0xE000EDFC;
+    // Popping is reserved to the drainer; if it is busy, the new event is lost instead
+    if (trace_state.buffer_mode != TRACE_MODE_OVERWRITE || trace_drain_busy.test_and_set(std::memory_order_acquire))
+    {
+        return false;
+    }
 
-    // Enable DWT if not already enabled
-    static uint8_t dwt_initialized = 0;
-    if (!dwt_initialized)
+    TraceEvent oldest;
+    if (trace_ring.tryPop(oldest))
     {
-        *SCB_DEMCR |= 0x01000000; // Enable trace
-        *DWT_CYCCNT = 0; // Reset counter
-        *DWT_CONTROL |= 1; // Enable counter
-        dwt_initialized = 1;
+        if (oldest.event_type == TRACE_EVENT_EVENTS_LOST)
+        {
+            rtt_trace_add_pending_loss(oldest.data, oldest.timestamp);
+        }
+        else
+        {
+            rtt_trace_count_lost(oldest.timestamp);
+        }
     }
+    const bool stored = trace_ring.tryPush(event);
+
+    trace_drain_busy.clear(std::memory_order_release);
+    return stored;
+}
 
-    return *DWT_CYCCNT;
+/**
+ * @brief Number of events that fit into the RTT channel without blocking
+ */
+static size_t rtt_trace_drain_budget(bool first_chunk)
+{
+    if (trace_state.buffer_mode == TRACE_MODE_BLOCK)
+    {
+        return TRACE_DRAIN_CHUNK;
+    }
+
+    const size_t space = SEGGER_RTT_GetAvailWriteSpace(trace_state.channel);
+    const size_t overhead = first_chunk ? TRACE_CHUNK_OVERHEAD : 0;
+    if (space <= overhead)
+    {
+        return 0;
+    }
+    const size_t fitting = (space - overhead) / TRACE_ENCODED_EVENT_SIZE;
+    return fitting < TRACE_DRAIN_CHUNK ? fitting : TRACE_DRAIN_CHUNK;
+}
+
+/**
+ * @brief Send one chunk of drained events in the configured encoding
+ */
+static void rtt_trace_write_events(const TraceEvent* events, size_t count, bool first_chunk,
+                                   uint32_t& last_timestamp)
+{
+#if RTT_TRACE_V2
+    uint8_t encoded[TRACE_V2_SYNC_SIZE + TRACE_DRAIN_CHUNK * TRACE_V2_MAX_EVENT_SIZE];
+    size_t len = 0;
+    if (first_chunk)
+    {
+        last_timestamp = events[0].timestamp;
+        encoded[len++] = TRACE_V2_SYNC;
+        memcpy(&encoded[len], &last_timestamp, sizeof(last_timestamp));
+        len += sizeof(last_timestamp);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        len += rtt_trace_encode_event(events[i], last_timestamp, &encoded[len]);
+    }
+    SEGGER_RTT_Write(trace_state.channel, encoded, len);
 #else
-    // Non-ARM platforms: timestamp not implemented
-    // Platform-specific timestamp implementation required
-#warning "Timestamp not implemented for this platform. All timestamps will be 0."
-    return 0;
+    (void)first_chunk;
+    (void)last_timestamp;
+    SEGGER_RTT_Write(trace_state.channel, events, count * sizeof(TraceEvent));
 #endif
 }
 
+/**
+ * @brief Move staged events to the RTT channel
+ *
+ * Only one context drains at a time; if another one is already draining
+ * (e.g. a task preempted by this interrupt), it picks up our events. In the
+ * non-blocking modes only as many events are popped as fit into the channel,
+ * the rest stays staged. A pending task registry goes out ahead of the
+ * events, so V2 handle indices always refer to a registry the host has.
+ */
+static void rtt_trace_drain_ring()
+{
+    if (trace_drain_busy.test_and_set(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    if (trace_state.registry_interval != 0 && rtt_trace_is_enabled() &&
+        rtt::Timebase::now32() - trace_state.registry_sent_at >= trace_state.registry_interval)
+    {
+        trace_registry_pending.store(true, std::memory_order_relaxed);
+    }
+
+    TraceEvent chunk[TRACE_DRAIN_CHUNK];
+    size_t count = 0;
+    bool first_chunk = true;
+    uint32_t last_timestamp = 0;
+    do
+    {
+        // Checked per chunk so that a request made while this context drains is not delayed
+        if (trace_registry_pending.exchange(false, std::memory_order_relaxed) && !rtt_trace_write_registry())
+        {
+            trace_registry_pending.store(true, std::memory_order_relaxed);
+        }
+
+        const size_t budget = rtt_trace_drain_budget(first_chunk);
+        count = 0;
+        if (budget > 0 && trace_state.buffer_mode == TRACE_MODE_OVERWRITE && rtt_trace_take_lost(chunk[0]))
+        {
+            ++count;
+        }
+        while (count < budget && trace_ring.tryPop(chunk[count]))
+        {
+            ++count;
+        }
+        if (count > 0)
+        {
+            rtt_trace_write_events(chunk, count, first_chunk, last_timestamp);
+            first_chunk = false;
+        }
+    }
+    while (count == TRACE_DRAIN_CHUNK);
+
+    trace_drain_busy.clear(std::memory_order_release);
+}
+
+/**
+ * @brief Get timestamp from the shared timebase
+ *
+ * @note Low 32 bits of rtt::Timebase (DWT CYCCNT on ARM Cortex-M), so trace
+ *       events line up with logger and data timestamps.
+ */
+uint32_t rtt_trace_get_timestamp()
+{
+    return rtt::Timebase::now32();
+}
+
 void rtt_trace_init(uint8_t trace_channel)
 {
     if (trace_state.initialized)
@@ -79,20 +536,37 @@ void rtt_trace_init(uint8_t trace_channel)
 
     trace_state.channel = trace_channel;
     trace_state.enabled = 0;
-    trace_state.num_registered_tasks = 0;
-    trace_state.buffer_pos = 0;
-    trace_state.initialized = 1;
+    trace_state.num_announced_tasks = 0; // Tasks registered before initialization are kept
+    trace_ring.reset();
+    trace_lost_pending.store(0, std::memory_order_relaxed);
+    trace_lost_total.store(0, std::memory_order_relaxed);
+    if (flight_recorder.magic != FLIGHT_RECORDER_MAGIC)
+    {
+        rtt_trace_flight_recorder_clear();
+    }
 
-    // Initialize RTT if not already done
-    SEGGER_RTT_Init();
+    // Initialize RTT and the timebase if not already done
+    rtt::ChannelManager::initialize();
+    if (!rtt::Timebase::isInitialized())
+    {
+        rtt::Timebase::initialize();
+    }
 
-    // Configure a dedicated buffer for the trace channel with adequate size
-    SEGGER_RTT_ConfigUpBuffer(trace_channel, "FreeRTOS Trace",
-                              rtt_trace_buffer, RTT_TRACE_BUFFER_SIZE,
-                              SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+    // The trace keeps its own buffer; the claim fails if another stream owns the channel
+    if (rtt::ChannelManager::adopt(RTT_TRACE_CHANNEL_NAME, trace_channel, rtt_trace_buffer, RTT_TRACE_BUFFER_SIZE,
+                                   trace_state.buffer_mode == TRACE_MODE_BLOCK ? rtt::ChannelMode::Block
+                                                                               : rtt::ChannelMode::Skip) < 0)
+    {
+        return;
+    }
+    trace_state.initialized = 1;
 
-    // Send a header marker to identify trace stream
+    // Send a header marker to identify trace stream and encoding
+#if RTT_TRACE_V2
+    constexpr char header[] = "RTT_TRACE_V2\n";
+#else
     constexpr char header[] = "RTT_TRACE_V1\n";
+#endif
     SEGGER_RTT_Write(trace_channel, header, sizeof(header) - 1);
 }
 
@@ -107,7 +581,11 @@ void rtt_trace_start(void)
         SEGGER_RTT_Write(trace_state.channel, start_msg, sizeof(start_msg) - 1);
 
         // Send task registry
-        rtt_trace_send_task_registry();
+        rtt_trace_write_registry();
+        trace_registry_pending.store(false, std::memory_order_relaxed);
+
+        // Let the hook macros through
+        rtt_trace_active_categories = trace_state.category_mask;
     }
 }
 
@@ -115,11 +593,14 @@ void rtt_trace_stop(void)
 {
     if (trace_state.initialized && trace_state.enabled)
     {
-        // Flush any buffered events
-        if (trace_state.buffer_pos > 0)
+        rtt_trace_active_categories = 0;
+
+        // Flush any staged events and report losses that are not yet recorded
+        rtt_trace_drain_ring();
+        if (trace_lost_pending.load(std::memory_order_relaxed) != 0)
         {
-            SEGGER_RTT_Write(trace_state.channel, trace_state.trace_buffer, trace_state.buffer_pos);
-            trace_state.buffer_pos = 0;
+            rtt_trace_stage_lost_record();
+            rtt_trace_drain_ring();
         }
 
         // Send stop marker
@@ -135,9 +616,31 @@ int rtt_trace_is_enabled(void)
     return trace_state.initialized && trace_state.enabled;
 }
 
+/**
+ * @brief Apply the per-handle filter
+ * @return true if the event should be recorded
+ */
+static bool rtt_trace_handle_passes(uint32_t category, uint32_t handle)
+{
+    if (trace_state.filter_mode == TRACE_FILTER_NONE || (trace_state.filter_categories & category) == 0)
+    {
+        return true;
+    }
+
+    bool listed = false;
+    for (uint8_t i = 0; i < trace_state.num_filter_handles && !listed; i++)
+    {
+        listed = trace_state.filter_handles[i] == handle;
+    }
+    return listed == (trace_state.filter_mode == TRACE_FILTER_INCLUDE);
+}
+
 void rtt_trace_record_event(TraceEventType event_type, uint32_t handle, uint32_t data)
 {
-    if (!rtt_trace_is_enabled())
+    // Also covers direct callers that bypass RTT_TRACE_RECORD
+    const uint32_t category = RTT_TRACE_CATEGORY_OF(event_type);
+    if (!rtt_trace_is_enabled() || (trace_state.category_mask & category) == 0 ||
+        !rtt_trace_handle_passes(category, handle))
     {
         return;
     }
@@ -148,81 +651,248 @@ void rtt_trace_record_event(TraceEventType event_type, uint32_t handle, uint32_t
     event.handle = handle;
     event.data = data;
 
-    // Check if we have space in buffer
-    if (trace_state.buffer_pos + sizeof(TraceEvent) > TRACE_BUFFER_SIZE)
+    if (trace_state.buffer_mode == TRACE_MODE_FLIGHT_RECORDER)
+    {
+        const uint32_t pos = flight_recorder.head.fetch_add(1, std::memory_order_relaxed);
+        flight_recorder.events[pos & (FLIGHT_RECORDER_SIZE - 1)] = event;
+        return;
+    }
+
+    if (trace_state.buffer_mode != TRACE_MODE_OVERWRITE && trace_lost_pending.load(std::memory_order_relaxed) != 0)
+    {
+        rtt_trace_stage_lost_record();
+    }
+
+    // Lock-free reservation; if the ring is full the event (or the oldest one) is lost
+    if (!trace_ring.tryPush(event) && !rtt_trace_overwrite_oldest(event))
     {
-        // Flush buffer
-        SEGGER_RTT_Write(trace_state.channel, trace_state.trace_buffer, trace_state.buffer_pos);
-        trace_state.buffer_pos = 0;
+        rtt_trace_count_lost(event.timestamp);
     }
 
-    // Add event to buffer
-    memcpy(&trace_state.trace_buffer[trace_state.buffer_pos], &event, sizeof(TraceEvent));
-    trace_state.buffer_pos += sizeof(TraceEvent);
+    // With RTT_TRACE_DEFERRED_DRAIN the ring is normally drained by rtt_trace_drain() from the
+    // idle hook or a trace task; the watermark is the fallback that keeps bursts from overflowing it
+    if (trace_ring.size() >= TRACE_DRAIN_WATERMARK)
+    {
+        rtt_trace_drain_ring();
+    }
+}
+
+void rtt_trace_drain(void)
+{
+    if (trace_state.initialized)
+    {
+        rtt_trace_drain_ring();
+    }
+}
 
-    // For critical events, flush periodically to avoid buffer overflow
-    // Note: event_count is accessed from ISR context, so we protect it
-    if (event_type == TRACE_EVENT_TASK_SWITCHED_IN ||
-        event_type == TRACE_EVENT_TASK_SWITCHED_OUT ||
-        event_type == TRACE_EVENT_ISR_ENTER ||
-        event_type == TRACE_EVENT_ISR_EXIT)
+void rtt_trace_set_category_mask(uint32_t mask)
+{
+    trace_state.category_mask = mask & TRACE_CATEGORY_ALL;
+    if (rtt_trace_is_enabled())
     {
-        // Simple threshold-based flush without additional state tracking
-        // Buffer flush happens automatically when buffer is full
-        if (trace_state.buffer_pos >= (TRACE_BUFFER_SIZE / 2))
+        rtt_trace_active_categories = trace_state.category_mask;
+    }
+}
+
+uint32_t rtt_trace_get_category_mask(void)
+{
+    return trace_state.category_mask;
+}
+
+void rtt_trace_set_handle_filter(TraceFilterMode mode, uint32_t categories)
+{
+    trace_state.filter_categories = categories;
+    trace_state.filter_mode = mode;
+}
+
+int rtt_trace_add_handle_filter(uint32_t handle)
+{
+    if (trace_state.num_filter_handles >= MAX_HANDLE_FILTERS)
+    {
+        return -1;
+    }
+
+    trace_state.filter_handles[trace_state.num_filter_handles] = handle;
+    trace_state.num_filter_handles++;
+    return 0;
+}
+
+void rtt_trace_clear_handle_filters(void)
+{
+    trace_state.num_filter_handles = 0;
+}
+
+void rtt_trace_set_mode(TraceBufferMode mode)
+{
+    trace_state.buffer_mode = mode;
+    if (trace_state.initialized)
+    {
+        rtt::ChannelManager::setMode(trace_state.channel,
+                                     mode == TRACE_MODE_BLOCK ? rtt::ChannelMode::Block : rtt::ChannelMode::Skip);
+    }
+}
+
+TraceBufferMode rtt_trace_get_mode(void)
+{
+    return trace_state.buffer_mode;
+}
+
+void rtt_trace_flight_recorder_dump(void)
+{
+    if (!trace_state.initialized)
+    {
+        return;
+    }
+
+    // Keep the hooks out while the ring is read (an explicit trigger may run with tracing active)
+    const uint32_t active_categories = rtt_trace_active_categories;
+    rtt_trace_active_categories = 0;
+
+    // Repeat the header so that a capture of just the dump can be decoded
+#if RTT_TRACE_V2
+    constexpr char header[] = "RTT_TRACE_V2\nTRACE_SNAPSHOT\n";
+#else
+    constexpr char header[] = "RTT_TRACE_V1\nTRACE_SNAPSHOT\n";
+#endif
+    SEGGER_RTT_Write(trace_state.channel, header, sizeof(header) - 1);
+    rtt_trace_write_registry();
+
+    const uint32_t head = flight_recorder.head.load(std::memory_order_relaxed);
+    const uint32_t count = rtt_trace_flight_recorder_count();
+    TraceEvent chunk[TRACE_DRAIN_CHUNK];
+    bool first_chunk = true;
+    uint32_t last_timestamp = 0;
+    for (uint32_t sent = 0; sent < count;)
+    {
+        size_t n = 0;
+        for (; n < TRACE_DRAIN_CHUNK && sent < count; ++n, ++sent)
         {
-            SEGGER_RTT_Write(trace_state.channel, trace_state.trace_buffer, trace_state.buffer_pos);
-            trace_state.buffer_pos = 0;
+            chunk[n] = flight_recorder.events[(head - count + sent) & (FLIGHT_RECORDER_SIZE - 1)];
         }
+        rtt_trace_write_events(chunk, n, first_chunk, last_timestamp);
+        first_chunk = false;
     }
+
+    constexpr char footer[] = "TRACE_SNAPSHOT_END\n";
+    SEGGER_RTT_Write(trace_state.channel, footer, sizeof(footer) - 1);
+
+    rtt_trace_active_categories = active_categories;
+}
+
+void rtt_trace_flight_recorder_clear(void)
+{
+    flight_recorder.head.store(0, std::memory_order_relaxed);
+    flight_recorder.magic = FLIGHT_RECORDER_MAGIC;
+}
+
+uint32_t rtt_trace_flight_recorder_count(void)
+{
+    const uint32_t head = flight_recorder.head.load(std::memory_order_relaxed);
+    return head < FLIGHT_RECORDER_SIZE ? head : static_cast<uint32_t>(FLIGHT_RECORDER_SIZE);
+}
+
+uint32_t rtt_trace_get_dropped_events(void)
+{
+    return trace_lost_total.load(std::memory_order_relaxed);
 }
 
 void rtt_trace_register_task(uint32_t handle, const char* name, size_t name_len)
 {
-    if (!trace_state.initialized || trace_state.num_registered_tasks >= MAX_REGISTERED_TASKS)
+    if (name == nullptr)
     {
         return;
     }
 
-    TaskRegistryEntry* entry = &trace_state.task_registry[trace_state.num_registered_tasks];
-    entry->handle = handle;
+    // Names may come from a fixed-size array such as the TCB's pcTaskName
+    const auto* end = static_cast<const char*>(memchr(name, '\0', name_len));
+    size_t copy_len = end != nullptr ? static_cast<size_t>(end - name) : name_len;
+    copy_len = copy_len < (MAX_TASK_NAME_LEN - 1) ? copy_len : (MAX_TASK_NAME_LEN - 1);
+
+    // A new task may reuse the TCB of a deleted one: it takes over the entry and its index
+    const int existing = rtt_trace_find_task(handle);
+    TaskRegistryEntry* entry = nullptr;
+    if (existing >= 0)
+    {
+        entry = &trace_state.task_registry[existing];
+    }
+    else if (trace_state.num_registered_tasks < MAX_REGISTERED_TASKS)
+    {
+        entry = &trace_state.task_registry[trace_state.num_registered_tasks];
+        entry->handle = handle;
+    }
+    else
+    {
+        return; // Registry full; the task's events keep their raw handle
+    }
 
-    const size_t copy_len = name_len < (MAX_TASK_NAME_LEN - 1) ? name_len : (MAX_TASK_NAME_LEN - 1);
     memcpy(entry->name, name, copy_len);
     entry->name[copy_len] = '\0';
+    entry->name_len = static_cast<uint8_t>(copy_len);
 
-    trace_state.num_registered_tasks++;
+    if (existing < 0)
+    {
+        // Publish the entry only once it is complete
+        rtt_trace_hash_task(handle, trace_state.num_registered_tasks);
+        trace_state.num_registered_tasks++;
+    }
+
+    // While tracing, tell the host about the change with the next drain
+    if (rtt_trace_is_enabled())
+    {
+        trace_registry_pending.store(true, std::memory_order_relaxed);
+    }
 }
 
-void rtt_trace_send_task_registry(void)
+void rtt_trace_unregister_task(uint32_t handle)
 {
-    if (!trace_state.initialized)
+    const int index = rtt_trace_find_task(handle);
+    if (index < 0)
     {
         return;
     }
 
-    // Send task registry header
-    constexpr char reg_header[] = "TASK_REGISTRY_START\n";
-    SEGGER_RTT_Write(trace_state.channel, reg_header, sizeof(reg_header) - 1);
+    // The last entry moves into the freed one, so the registry stays dense
+    rtt_trace_unhash_task(handle);
+    const uint8_t last = static_cast<uint8_t>(trace_state.num_registered_tasks - 1);
+    if (index != last)
+    {
+        trace_state.task_registry[index] = trace_state.task_registry[last];
+        trace_state.task_hash[rtt_trace_task_hash_slot(trace_state.task_registry[index].handle)] =
+            static_cast<uint8_t>(index + 1);
+    }
+    trace_state.num_registered_tasks = last;
 
-    // Send each registered task
-    for (uint8_t i = 0; i < trace_state.num_registered_tasks; i++)
+    // Indices from here on changed: send their handles until the host has the new registry
+    if (trace_state.num_announced_tasks > index)
+    {
+        trace_state.num_announced_tasks = static_cast<uint8_t>(index);
+    }
+    if (rtt_trace_is_enabled())
     {
-        TaskRegistryEntry* entry = &trace_state.task_registry[i];
+        trace_registry_pending.store(true, std::memory_order_relaxed);
+    }
+}
 
-        // Format: "TASK:handle:name\n"
-        char buffer[64] = {};
-        const int len = std::snprintf(buffer, sizeof(buffer), "TASK:%lu:%s\n",
-                                      (unsigned long)entry->handle, entry->name);
-        if (len > 0 && static_cast<size_t>(len) < sizeof(buffer))
-        {
-            SEGGER_RTT_Write(trace_state.channel, buffer, len);
-        }
+void rtt_trace_send_task_registry(void)
+{
+    if (!trace_state.initialized)
+    {
+        return;
     }
 
-    // Send task registry footer
-    constexpr char reg_footer[] = "TASK_REGISTRY_END\n";
-    SEGGER_RTT_Write(trace_state.channel, reg_footer, sizeof(reg_footer) - 1);
+    // Sent by the drainer so that it cannot end up between the bytes of an event chunk
+    trace_registry_pending.store(true, std::memory_order_relaxed);
+    rtt_trace_drain_ring();
+}
+
+void rtt_trace_request_registry(void)
+{
+    trace_registry_pending.store(true, std::memory_order_relaxed);
+}
+
+void rtt_trace_set_registry_interval(uint32_t ticks)
+{
+    trace_state.registry_interval = ticks;
 }
 
 #ifdef __cplusplus
@@ -254,6 +924,61 @@ namespace rtt::trace
         rtt_trace_record_event(type, handle, data);
     }
 
+    void FreeRtosTrace::drain() noexcept
+    {
+        rtt_trace_drain();
+    }
+
+    void FreeRtosTrace::setCategoryMask(uint32_t mask) noexcept
+    {
+        rtt_trace_set_category_mask(mask);
+    }
+
+    uint32_t FreeRtosTrace::getCategoryMask() noexcept
+    {
+        return rtt_trace_get_category_mask();
+    }
+
+    void FreeRtosTrace::setHandleFilter(TraceFilterMode mode, uint32_t categories) noexcept
+    {
+        rtt_trace_set_handle_filter(mode, categories);
+    }
+
+    bool FreeRtosTrace::addHandleFilter(uint32_t handle) noexcept
+    {
+        return rtt_trace_add_handle_filter(handle) == 0;
+    }
+
+    void FreeRtosTrace::clearHandleFilters() noexcept
+    {
+        rtt_trace_clear_handle_filters();
+    }
+
+    void FreeRtosTrace::setMode(TraceBufferMode mode) noexcept
+    {
+        rtt_trace_set_mode(mode);
+    }
+
+    TraceBufferMode FreeRtosTrace::getMode() noexcept
+    {
+        return rtt_trace_get_mode();
+    }
+
+    void FreeRtosTrace::dumpFlightRecorder() noexcept
+    {
+        rtt_trace_flight_recorder_dump();
+    }
+
+    void FreeRtosTrace::clearFlightRecorder() noexcept
+    {
+        rtt_trace_flight_recorder_clear();
+    }
+
+    uint32_t FreeRtosTrace::droppedEvents() noexcept
+    {
+        return rtt_trace_get_dropped_events();
+    }
+
     void FreeRtosTrace::registerTask(uint32_t handle, std::string_view name) noexcept
     {
         if (!name.empty())
@@ -262,6 +987,21 @@ namespace rtt::trace
             rtt_trace_register_task(handle, name.data(), name.size());
         }
     }
+
+    void FreeRtosTrace::unregisterTask(uint32_t handle) noexcept
+    {
+        rtt_trace_unregister_task(handle);
+    }
+
+    void FreeRtosTrace::requestRegistry() noexcept
+    {
+        rtt_trace_request_registry();
+    }
+
+    void FreeRtosTrace::setRegistryInterval(uint32_t ticks) noexcept
+    {
+        rtt_trace_set_registry_interval(ticks);
+    }
 } // namespace rtt::trace
 
 #endif // __cplusplus
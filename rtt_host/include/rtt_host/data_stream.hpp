@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <rtt_data/rtt_data.hpp>
+
+namespace rtt::host
+{
+    /**
+     * @brief One rtt_data packet in a capture
+     */
+    struct DataPacket
+    {
+        data::DataHeader header; // Copied: headers are not aligned in the stream
+        const uint8_t* payload; // header.size bytes, points into the capture
+        size_t offset; // Offset of the header in the capture
+    };
+
+    /**
+     * @brief Zero-copy iterator over the rtt_data packets of a capture
+     *
+     * Uses the firmware's DataHeader definition. Bytes that do not start a
+     * packet (text, lost data) are skipped until the next "RD" magic with a
+     * known type whose payload fits into the capture, as
+     * scripts/rtt_data_reader.py does.
+     */
+    class DataStream
+    {
+    public:
+        DataStream(const uint8_t* data, size_t size) noexcept : m_data(data), m_size(size)
+        {
+        }
+
+        /**
+         * @brief Get the next packet
+         * @return False at the end of the capture
+         */
+        bool next(DataPacket& packet) noexcept;
+
+        /**
+         * @brief Bytes skipped so far because they did not start a packet
+         */
+        [[nodiscard]] size_t getSkippedBytes() const noexcept
+        {
+            return m_skipped;
+        }
+
+        /**
+         * @brief Offset of the next byte to decode
+         */
+        [[nodiscard]] size_t getOffset() const noexcept
+        {
+            return m_offset;
+        }
+
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_offset{0};
+        size_t m_skipped{0};
+    };
+} // namespace rtt::host
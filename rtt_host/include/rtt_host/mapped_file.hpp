@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rtt::host
+{
+    /**
+     * @brief Read-only memory mapping of a capture file
+     *
+     * The decoders iterate the mapping in place, so captures larger than RAM
+     * are paged in by the kernel as they are read and never copied. Move-only;
+     * the mapping is released by the destructor.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() noexcept = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        /**
+         * @brief Map a file, replacing the current mapping
+         * @return False if the file cannot be opened or mapped (errno is set)
+         */
+        bool open(const char* path) noexcept;
+
+        /**
+         * @brief Release the mapping
+         */
+        void close() noexcept;
+
+        [[nodiscard]] bool isOpen() const noexcept
+        {
+            return m_open;
+        }
+
+        /**
+         * @brief Mapped bytes, nullptr for an empty file
+         */
+        [[nodiscard]] const uint8_t* data() const noexcept
+        {
+            return m_data;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+    private:
+        const uint8_t* m_data{nullptr};
+        size_t m_size{0};
+        bool m_open{false}; // Also set for empty files, which have no mapping
+    };
+} // namespace rtt::host
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <rtt_host/trace_decoder.hpp>
+
+namespace rtt::host
+{
+    /**
+     * @brief Streaming writer of a Perfetto protobuf trace
+     *
+     * Writes TracePacket messages of the Perfetto trace format directly to a
+     * file as the events arrive, so exports of any size need constant memory.
+     * The mapping follows the Chrome trace export of rtt_trace_analyzer.py:
+     * one track per task with a slice per execution period, an ISR track,
+     * instants for the kernel object events on a kernel track and a heap
+     * usage counter from MALLOC/FREE. EVENTS_LOST closes all open slices.
+     */
+    class PerfettoWriter
+    {
+    public:
+        /**
+         * @param file Output opened in binary mode, not closed by the writer
+         * @param decoder Source of the task names, which may still grow while writing
+         * @param frequency Timebase frequency in Hz to convert ticks to nanoseconds
+         */
+        PerfettoWriter(std::FILE* file, const TraceDecoder& decoder, uint64_t frequency);
+
+        /**
+         * @brief Write the packets of a block of events, in stream order
+         */
+        void write(const TraceRecord* records, size_t count);
+
+        /**
+         * @brief End open slices at the last event and flush
+         * @return False if writing failed at any point
+         */
+        bool finish();
+
+        [[nodiscard]] uint64_t getPacketCount() const noexcept
+        {
+            return m_packets;
+        }
+
+    private:
+        void writeEvent(const TraceRecord& record);
+        void describeTrack(uint64_t uuid, const std::string& name, bool counter);
+        const std::string& taskTrack(uint32_t handle);
+        void trackEvent(uint64_t timestamp, uint64_t track, uint32_t type, const std::string* name,
+                        int64_t counter = 0);
+        void endAll(uint64_t timestamp);
+        void emit();
+        [[nodiscard]] uint64_t toNanoseconds(uint64_t ticks) const noexcept;
+
+        std::FILE* m_file;
+        const TraceDecoder& m_decoder;
+        uint64_t m_frequency;
+        bool m_failed{false};
+        uint64_t m_packets{0};
+        uint64_t m_lastTimestamp{0};
+        std::vector<uint8_t> m_packet; // Packet under construction
+        std::vector<uint8_t> m_message; // Nested message under construction
+        std::unordered_map<uint32_t, std::string> m_tracks; // Tasks with a track descriptor, by name
+        std::unordered_set<uint32_t> m_running; // Tasks with an open slice
+        uint32_t m_isrDepth{0};
+        std::unordered_map<uint32_t, uint32_t> m_allocations; // Address -> size
+        int64_t m_allocated{0};
+    };
+} // namespace rtt::host
@@ -0,0 +1,155 @@
+#pragma once
+
+/**
+ * @file rtt_host.h
+ * @brief C API of the host decoder library
+ *
+ * Plain C interface over rtt::host for other languages; scripts/rtt_host.py
+ * loads the shared rtt_host_c library through ctypes. Functions returning int
+ * return 1 on success and 0 on failure, pointers are NULL on failure.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Decoded trace event, same layout as rtt::host::TraceRecord
+ */
+typedef struct
+{
+    uint64_t timestamp; // Timebase ticks, extended to 64 bits
+    uint32_t handle;
+    uint32_t data;
+    uint8_t type; // TraceEventType
+    uint8_t reserved[7];
+} RttHostTraceRecord;
+
+/**
+ * @brief Trace statistics, see rtt::host::TraceSummary
+ */
+typedef struct
+{
+    uint64_t events;
+    uint64_t first_timestamp;
+    uint64_t last_timestamp;
+    uint64_t gaps;
+    uint64_t lost_events;
+    uint64_t unmatched_in;
+    uint64_t unmatched_out;
+    uint64_t isr_count;
+    uint64_t isr_matched; // ISR_ENTER/ISR_EXIT pairs in the duration statistics
+    uint64_t isr_total;
+    uint64_t isr_min; // UINT64_MAX without matched pairs
+    uint64_t isr_max;
+    uint32_t task_count;
+    uint32_t encoding; // 1: RTT_TRACE_V1, 2: RTT_TRACE_V2
+} RttHostTraceSummary;
+
+/**
+ * @brief Execution periods of one task
+ */
+typedef struct
+{
+    uint32_t handle;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+} RttHostTaskStats;
+
+/**
+ * @brief One rtt_data packet, payload points into the mapped capture
+ */
+typedef struct
+{
+    const uint8_t* payload;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t timestamp;
+    uint8_t type; // rtt::data::DataType
+    uint8_t subtype;
+    uint8_t reserved[6];
+} RttHostDataPacket;
+
+typedef struct RttHostTrace RttHostTrace;
+typedef struct RttHostData RttHostData;
+
+/**
+ * @brief Map a trace capture and analyze it in one streaming pass
+ *
+ * Summary, task statistics and registry are available right away; events
+ * are only held in memory once rtt_host_trace_records() is called.
+ *
+ * @param threads Analysis worker threads, 0 for one per hardware thread
+ */
+RttHostTrace* rtt_host_trace_open(const char* path, unsigned threads);
+
+/**
+ * @brief Release a trace and everything returned for it
+ */
+void rtt_host_trace_close(RttHostTrace* trace);
+
+/**
+ * @brief Decode all events into memory, valid until rtt_host_trace_close()
+ * @return NULL if the trace is NULL or the events do not fit into memory
+ */
+const RttHostTraceRecord* rtt_host_trace_records(RttHostTrace* trace, uint64_t* count);
+
+int rtt_host_trace_summary(const RttHostTrace* trace, RttHostTraceSummary* summary);
+
+/**
+ * @brief Number of events of a TraceEventType
+ */
+uint64_t rtt_host_trace_type_count(const RttHostTrace* trace, uint32_t type);
+
+/**
+ * @brief Statistics of the index-th task, in ascending handle order
+ */
+int rtt_host_trace_task_stats(const RttHostTrace* trace, uint32_t index, RttHostTaskStats* stats);
+
+/**
+ * @brief Registered name of a task or "Task_0x%08X", valid until rtt_host_trace_close()
+ */
+const char* rtt_host_trace_task_name(RttHostTrace* trace, uint32_t handle);
+
+/**
+ * @brief index-th registered task, in ascending handle order
+ * @return Name valid until rtt_host_trace_close(), NULL past the last task
+ */
+const char* rtt_host_trace_registry_entry(const RttHostTrace* trace, uint32_t index, uint32_t* handle);
+
+/**
+ * @brief Stream a trace capture to a Perfetto protobuf trace
+ * @param frequency Timebase frequency in Hz
+ * @param threads Analysis worker threads running alongside the export
+ * @param summary Optional statistics of the same pass
+ */
+int rtt_host_export_perfetto(const char* trace_path, const char* output_path, uint64_t frequency, unsigned threads,
+                             RttHostTraceSummary* summary);
+
+/**
+ * @brief Map an rtt_data capture for packet iteration
+ */
+RttHostData* rtt_host_data_open(const char* path);
+
+void rtt_host_data_close(RttHostData* data);
+
+/**
+ * @brief Get the next packet
+ * @return 0 at the end of the capture
+ */
+int rtt_host_data_next(RttHostData* data, RttHostDataPacket* packet);
+
+/**
+ * @brief Bytes skipped so far because they did not start a packet
+ */
+uint64_t rtt_host_data_skipped(const RttHostData* data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <rtt_host/trace_decoder.hpp>
+
+namespace rtt::host
+{
+    /**
+     * @brief Count, total, min and max of a set of durations in ticks
+     */
+    struct DurationStats
+    {
+        uint64_t count{0};
+        uint64_t total{0};
+        uint64_t min{UINT64_MAX};
+        uint64_t max{0};
+
+        void add(uint64_t duration) noexcept
+        {
+            ++count;
+            total += duration;
+            min = duration < min ? duration : min;
+            max = duration > max ? duration : max;
+        }
+
+        void merge(const DurationStats& other) noexcept
+        {
+            count += other.count;
+            total += other.total;
+            min = other.min < min ? other.min : min;
+            max = other.max > max ? other.max : max;
+        }
+    };
+
+    /**
+     * @brief Statistics of a whole trace, as printed by scripts/rtt_trace_analyzer.py
+     */
+    struct TraceSummary
+    {
+        uint64_t events{0};
+        uint64_t firstTimestamp{0};
+        uint64_t lastTimestamp{0};
+        uint64_t gaps{0}; // EVENTS_LOST records
+        uint64_t lostEvents{0}; // Sum of their counts
+        std::array<uint64_t, 128> typeCounts{}; // Events per TraceEventType
+        std::map<uint32_t, DurationStats> tasks; // Execution periods per task handle
+        uint64_t unmatchedIn{0}; // SWITCHED_IN while another task was running
+        uint64_t unmatchedOut{0}; // SWITCHED_OUT without a running task
+        uint64_t isrCount{0}; // ISR_ENTER events
+        DurationStats isrDurations; // Matched ISR_ENTER/ISR_EXIT pairs
+    };
+
+    /**
+     * @brief Analysis settings
+     */
+    struct AnalysisOptions
+    {
+        unsigned threads{0}; // Worker threads, 0: one per hardware thread
+        size_t blockSize{65536}; // Events handed to a worker at once
+
+        /**
+         * @brief Called in stream order on the decoding thread for every decoded block (analyzeTrace)
+         *
+         * Lets a single pass over the capture also feed an exporter (PerfettoWriter).
+         */
+        std::function<void(const TraceRecord* records, size_t count)> onBlock;
+    };
+
+    /**
+     * @brief Decode and analyze a capture in one pass
+     *
+     * The decoder runs on the calling thread (V2 timestamps are deltas, so
+     * decoding is inherently sequential) and hands blocks of events to worker
+     * threads. Each worker computes the statistics of its block from the first
+     * task/ISR event that does not depend on earlier events; each block is
+     * merged in stream order as soon as its predecessors are, which resolves
+     * the events at block boundaries and keeps memory bounded.
+     * The result does not depend on the number of threads.
+     *
+     * Runtime semantics follow rtt_trace_analyzer.py: EVENTS_LOST ends the
+     * running task and ISR without counting them, a switch out of another
+     * task than the running one is attributed to the task switched out, and a
+     * task still running at the end is counted up to the last event.
+     */
+    [[nodiscard]] TraceSummary analyzeTrace(TraceDecoder& decoder, const AnalysisOptions& options = {});
+
+    /**
+     * @brief Analyze events already decoded into memory
+     */
+    [[nodiscard]] TraceSummary analyzeRecords(const TraceRecord* records, size_t count,
+                                              const AnalysisOptions& options = {});
+} // namespace rtt::host
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <rtt_freertos_trace/rtt_freertos_trace_hooks.h>
+
+namespace rtt::host
+{
+    /**
+     * @brief One decoded trace event
+     *
+     * Laid out for direct use from other languages (rtt_host.h, scripts/rtt_host.py).
+     */
+    struct TraceRecord
+    {
+        uint64_t timestamp; // Timebase ticks, extended to 64 bits across counter wraps
+        uint32_t handle; // Task or object handle (registry indices already resolved)
+        uint32_t data;
+        uint8_t type; // TraceEventType
+        uint8_t reserved[7];
+    };
+
+    static_assert(sizeof(TraceRecord) == 24, "TraceRecord layout is shared with the C API");
+
+    /**
+     * @brief Stream encoding, from the header marker
+     */
+    enum class TraceEncoding : uint8_t
+    {
+        V1, // Fixed 13-byte TraceEvent records
+        V2 // Delta/varint records after "RTT_TRACE_V2\n"
+    };
+
+    /**
+     * @brief Check if a byte is a TraceEventType the firmware emits
+     */
+    [[nodiscard]] bool isTraceEventType(uint8_t type) noexcept;
+
+    /**
+     * @brief Name of an event type as used by scripts/rtt_trace_analyzer.py, "UNKNOWN" otherwise
+     */
+    [[nodiscard]] const char* traceEventName(uint8_t type) noexcept;
+
+    /**
+     * @brief Incremental decoder of an rtt_freertos_trace capture
+     *
+     * Reads the capture in place in the encoding given by its header marker
+     * (V2 if "RTT_TRACE_V2\n" appears anywhere, as in rtt_trace_analyzer.py),
+     * skips in-band markers and collects the task registries on the way. The
+     * firmware's 32-bit timestamps are extended to 64 bits, so traces spanning
+     * many counter periods keep a monotonic timeline.
+     *
+     * Lost framing is handled as in the Python decoder: V1 resynchronizes
+     * byte by byte on an unknown event type, V2 waits for the next sync record.
+     */
+    class TraceDecoder
+    {
+    public:
+        TraceDecoder(const uint8_t* data, size_t size) noexcept;
+
+        /**
+         * @brief Decode up to capacity events
+         * @return Events written to records, 0 at the end of the capture
+         */
+        size_t next(TraceRecord* records, size_t capacity) noexcept;
+
+        [[nodiscard]] TraceEncoding getEncoding() const noexcept
+        {
+            return m_encoding;
+        }
+
+        /**
+         * @brief Task names from all registries decoded so far
+         */
+        [[nodiscard]] const std::unordered_map<uint32_t, std::string>& getTaskNames() const noexcept
+        {
+            return m_names;
+        }
+
+        /**
+         * @brief Name of a task, "Task_0x%08X" if it was never registered
+         */
+        [[nodiscard]] std::string getTaskName(uint32_t handle) const;
+
+        /**
+         * @brief Bytes decoded so far, for progress reports
+         */
+        [[nodiscard]] size_t getOffset() const noexcept
+        {
+            return m_offset;
+        }
+
+    private:
+        [[nodiscard]] bool startsWith(const char* marker, size_t length) const noexcept;
+        bool skipInBand() noexcept;
+        void parseBinaryRegistry() noexcept;
+        void parseTextRegistry() noexcept;
+        bool readVarint(size_t& offset, uint64_t& value) const noexcept;
+        [[nodiscard]] uint32_t decodeHandle(uint64_t value) const noexcept;
+        void extend(uint32_t timestamp) noexcept;
+        size_t nextV1(TraceRecord* records, size_t capacity) noexcept;
+        size_t nextV2(TraceRecord* records, size_t capacity) noexcept;
+
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_offset{0};
+        TraceEncoding m_encoding{TraceEncoding::V1};
+        uint64_t m_timestamp{0}; // Extended timestamp of the last event
+        bool m_haveTimestamp{false}; // V2: a sync record was seen since the last loss of framing
+        bool m_started{false}; // The first event starts the extended timeline
+        std::unordered_map<uint32_t, std::string> m_names;
+        std::vector<uint32_t> m_index; // Handles in the order of the last registry (V2 handle indices)
+    };
+} // namespace rtt::host
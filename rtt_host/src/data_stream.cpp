@@ -0,0 +1,44 @@
+#include <rtt_host/data_stream.hpp>
+#include <cstring>
+
+namespace rtt::host
+{
+    bool DataStream::next(DataPacket& packet) noexcept
+    {
+        constexpr size_t HEADER_SIZE{sizeof(data::DataHeader)};
+
+        while (m_size - m_offset >= HEADER_SIZE)
+        {
+            const uint8_t* candidate = &m_data[m_offset];
+            if (candidate[0] != data::DATA_MAGIC_0)
+            {
+                // Jump to the next possible magic instead of testing every byte
+                const void* magic = std::memchr(candidate, data::DATA_MAGIC_0, m_size - m_offset);
+                const size_t skip = magic == nullptr ? m_size - m_offset
+                                                     : static_cast<size_t>(static_cast<const uint8_t*>(magic) - candidate);
+                m_offset += skip;
+                m_skipped += skip;
+                continue;
+            }
+
+            data::DataHeader header{};
+            std::memcpy(&header, candidate, HEADER_SIZE);
+            // A size running past the end is a corrupted or cut-off header
+            if (header.magic[1] != data::DATA_MAGIC_1 ||
+                static_cast<uint8_t>(header.type) > static_cast<uint8_t>(data::DataType::Memory) ||
+                header.size > m_size - m_offset - HEADER_SIZE)
+            {
+                ++m_offset;
+                ++m_skipped;
+                continue;
+            }
+
+            packet.header = header;
+            packet.payload = candidate + HEADER_SIZE;
+            packet.offset = m_offset;
+            m_offset += HEADER_SIZE + header.size;
+            return true;
+        }
+        return false;
+    }
+} // namespace rtt::host
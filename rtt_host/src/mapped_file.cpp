@@ -0,0 +1,81 @@
+#include <rtt_host/mapped_file.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace rtt::host
+{
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+          m_open(std::exchange(other.m_open, false))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_open = std::exchange(other.m_open, false);
+        }
+        return *this;
+    }
+
+    bool MappedFile::open(const char* path) noexcept
+    {
+        close();
+
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat status{};
+        if (::fstat(fd, &status) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        const auto size = static_cast<size_t>(status.st_size);
+        if (size != 0)
+        {
+            void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                ::close(fd);
+                return false;
+            }
+            // The decoders read front to back
+            ::madvise(mapping, size, MADV_SEQUENTIAL);
+            m_data = static_cast<const uint8_t*>(mapping);
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+        m_size = size;
+        m_open = true;
+        return true;
+    }
+
+    void MappedFile::close() noexcept
+    {
+        if (m_data != nullptr)
+        {
+            ::munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_open = false;
+    }
+} // namespace rtt::host
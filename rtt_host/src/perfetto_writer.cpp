@@ -0,0 +1,306 @@
+#include <rtt_host/perfetto_writer.hpp>
+#include <cctype>
+
+namespace rtt::host
+{
+    namespace
+    {
+        // Field numbers of perfetto/protos/perfetto/trace/*.proto
+        constexpr uint32_t TRACE_PACKET{1};
+        constexpr uint32_t PACKET_TIMESTAMP{8};
+        constexpr uint32_t PACKET_SEQUENCE_ID{10};
+        constexpr uint32_t PACKET_TRACK_EVENT{11};
+        constexpr uint32_t PACKET_TRACK_DESCRIPTOR{60};
+        constexpr uint32_t DESCRIPTOR_UUID{1};
+        constexpr uint32_t DESCRIPTOR_NAME{2};
+        constexpr uint32_t DESCRIPTOR_COUNTER{8};
+        constexpr uint32_t EVENT_TYPE{9};
+        constexpr uint32_t EVENT_TRACK_UUID{11};
+        constexpr uint32_t EVENT_NAME{23};
+        constexpr uint32_t EVENT_COUNTER_VALUE{30};
+
+        // TrackEvent.Type
+        constexpr uint32_t SLICE_BEGIN{1};
+        constexpr uint32_t SLICE_END{2};
+        constexpr uint32_t INSTANT{3};
+        constexpr uint32_t COUNTER{4};
+
+        constexpr uint32_t WIRE_VARINT{0};
+        constexpr uint32_t WIRE_LENGTH{2};
+
+        constexpr uint32_t SEQUENCE_ID{1};
+        constexpr uint64_t KERNEL_TRACK{1};
+        constexpr uint64_t ISR_TRACK{2};
+        constexpr uint64_t HEAP_TRACK{3};
+        constexpr uint64_t TASK_TRACK_BASE{1ULL << 32};
+        constexpr uint64_t NANOSECONDS_PER_SECOND{1000000000ULL};
+
+        void putVarint(std::vector<uint8_t>& buffer, uint64_t value)
+        {
+            while (value >= 0x80U)
+            {
+                buffer.push_back(static_cast<uint8_t>(value | 0x80U));
+                value >>= 7;
+            }
+            buffer.push_back(static_cast<uint8_t>(value));
+        }
+
+        void putUint(std::vector<uint8_t>& buffer, uint32_t field, uint64_t value)
+        {
+            putVarint(buffer, (static_cast<uint64_t>(field) << 3) | WIRE_VARINT);
+            putVarint(buffer, value);
+        }
+
+        void putBytes(std::vector<uint8_t>& buffer, uint32_t field, const void* data, size_t size)
+        {
+            putVarint(buffer, (static_cast<uint64_t>(field) << 3) | WIRE_LENGTH);
+            putVarint(buffer, size);
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            buffer.insert(buffer.end(), bytes, bytes + size);
+        }
+
+        void putString(std::vector<uint8_t>& buffer, uint32_t field, const std::string& value)
+        {
+            putBytes(buffer, field, value.data(), value.size());
+        }
+
+        /**
+         * @brief "QUEUE_SEND" -> "Queue Send", as the Python export titles kernel events
+         */
+        std::string title(const char* name)
+        {
+            std::string result;
+            bool start = true;
+            for (const char* c = name; *c != '\0'; ++c)
+            {
+                if (*c == '_')
+                {
+                    result += ' ';
+                    start = true;
+                    continue;
+                }
+                const auto ch = static_cast<unsigned char>(*c);
+                result += static_cast<char>(start ? std::toupper(ch) : std::tolower(ch));
+                start = false;
+            }
+            return result;
+        }
+    } // namespace
+
+    PerfettoWriter::PerfettoWriter(std::FILE* file, const TraceDecoder& decoder, uint64_t frequency)
+        : m_file(file), m_decoder(decoder), m_frequency(frequency == 0 ? NANOSECONDS_PER_SECOND : frequency)
+    {
+        describeTrack(KERNEL_TRACK, "Kernel", false);
+        describeTrack(ISR_TRACK, "ISR", false);
+        describeTrack(HEAP_TRACK, "Memory Usage", true);
+    }
+
+    void PerfettoWriter::write(const TraceRecord* records, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            writeEvent(records[i]);
+        }
+    }
+
+    bool PerfettoWriter::finish()
+    {
+        endAll(m_lastTimestamp);
+        if (std::fflush(m_file) != 0)
+        {
+            m_failed = true;
+        }
+        return !m_failed;
+    }
+
+    void PerfettoWriter::writeEvent(const TraceRecord& record)
+    {
+        m_lastTimestamp = record.timestamp;
+        const uint64_t ts = record.timestamp;
+
+        switch (record.type)
+        {
+        case TRACE_EVENT_EVENTS_LOST:
+        {
+            // Open slices can't be closed reliably across a gap
+            endAll(ts);
+            static const std::string name = "Events lost";
+            trackEvent(ts, KERNEL_TRACK, INSTANT, &name);
+            break;
+        }
+        case TRACE_EVENT_TASK_SWITCHED_IN:
+        {
+            const std::string& name = taskTrack(record.handle);
+            if (m_running.insert(record.handle).second)
+            {
+                trackEvent(ts, TASK_TRACK_BASE | record.handle, SLICE_BEGIN, &name);
+            }
+            break;
+        }
+        case TRACE_EVENT_TASK_SWITCHED_OUT:
+            if (m_running.erase(record.handle) != 0)
+            {
+                trackEvent(ts, TASK_TRACK_BASE | record.handle, SLICE_END, nullptr);
+            }
+            break;
+        case TRACE_EVENT_ISR_ENTER:
+        {
+            static const std::string name = "ISR";
+            trackEvent(ts, ISR_TRACK, SLICE_BEGIN, &name);
+            ++m_isrDepth;
+            break;
+        }
+        case TRACE_EVENT_ISR_EXIT:
+            if (m_isrDepth > 0)
+            {
+                trackEvent(ts, ISR_TRACK, SLICE_END, nullptr);
+                --m_isrDepth;
+            }
+            break;
+        case TRACE_EVENT_TASK_CREATE:
+        case TRACE_EVENT_TASK_DELETE:
+        case TRACE_EVENT_TASK_READY:
+        case TRACE_EVENT_TASK_SUSPENDED:
+        case TRACE_EVENT_TASK_RESUMED:
+        {
+            static constexpr const char* PREFIXES[] = {"Create: ", "Delete: ", "Ready: ", "Suspended: ", "Resumed: "};
+            std::string name = PREFIXES[record.type - TRACE_EVENT_TASK_CREATE];
+            name += taskTrack(record.handle);
+            if (record.type == TRACE_EVENT_TASK_RESUMED && record.data == 1)
+            {
+                name += " (from ISR)";
+            }
+            trackEvent(ts, TASK_TRACK_BASE | record.handle, INSTANT, &name);
+            break;
+        }
+        case TRACE_EVENT_MALLOC:
+        {
+            static const std::string name = "malloc";
+            trackEvent(ts, KERNEL_TRACK, INSTANT, &name);
+            if (record.data > 0)
+            {
+                m_allocations[record.handle] = record.data;
+                m_allocated += record.data;
+                trackEvent(ts, HEAP_TRACK, COUNTER, nullptr, m_allocated);
+            }
+            break;
+        }
+        case TRACE_EVENT_FREE:
+        {
+            static const std::string name = "free";
+            trackEvent(ts, KERNEL_TRACK, INSTANT, &name);
+            // Frees of allocations from before the trace started would make the counter negative
+            const auto allocation = m_allocations.find(record.handle);
+            if (allocation != m_allocations.end())
+            {
+                m_allocated -= allocation->second;
+                m_allocations.erase(allocation);
+                trackEvent(ts, HEAP_TRACK, COUNTER, nullptr, m_allocated);
+            }
+            break;
+        }
+        default:
+            if (isTraceEventType(record.type))
+            {
+                // Queue, semaphore, mutex and timer events
+                const std::string name = title(traceEventName(record.type));
+                trackEvent(ts, KERNEL_TRACK, INSTANT, &name);
+            }
+            break;
+        }
+    }
+
+    void PerfettoWriter::describeTrack(uint64_t uuid, const std::string& name, bool counter)
+    {
+        m_message.clear();
+        putUint(m_message, DESCRIPTOR_UUID, uuid);
+        putString(m_message, DESCRIPTOR_NAME, name);
+        if (counter)
+        {
+            putBytes(m_message, DESCRIPTOR_COUNTER, nullptr, 0);
+        }
+
+        m_packet.clear();
+        putBytes(m_packet, PACKET_TRACK_DESCRIPTOR, m_message.data(), m_message.size());
+        emit();
+    }
+
+    const std::string& PerfettoWriter::taskTrack(uint32_t handle)
+    {
+        // Named when first seen: the registry is sent before the task's events
+        auto [track, added] = m_tracks.try_emplace(handle);
+        if (added)
+        {
+            track->second = m_decoder.getTaskName(handle);
+            describeTrack(TASK_TRACK_BASE | handle, track->second, false);
+        }
+        return track->second;
+    }
+
+    void PerfettoWriter::trackEvent(uint64_t timestamp, uint64_t track, uint32_t type, const std::string* name,
+                                    int64_t counter)
+    {
+        m_message.clear();
+        putUint(m_message, EVENT_TYPE, type);
+        putUint(m_message, EVENT_TRACK_UUID, track);
+        if (name != nullptr)
+        {
+            putString(m_message, EVENT_NAME, *name);
+        }
+        if (type == COUNTER)
+        {
+            putUint(m_message, EVENT_COUNTER_VALUE, static_cast<uint64_t>(counter));
+        }
+
+        m_packet.clear();
+        putUint(m_packet, PACKET_TIMESTAMP, toNanoseconds(timestamp));
+        putUint(m_packet, PACKET_SEQUENCE_ID, SEQUENCE_ID);
+        putBytes(m_packet, PACKET_TRACK_EVENT, m_message.data(), m_message.size());
+        emit();
+    }
+
+    void PerfettoWriter::endAll(uint64_t timestamp)
+    {
+        for (const uint32_t handle : m_running)
+        {
+            trackEvent(timestamp, TASK_TRACK_BASE | handle, SLICE_END, nullptr);
+        }
+        m_running.clear();
+        for (; m_isrDepth > 0; --m_isrDepth)
+        {
+            trackEvent(timestamp, ISR_TRACK, SLICE_END, nullptr);
+        }
+    }
+
+    void PerfettoWriter::emit()
+    {
+        // A trace is a sequence of Trace.packet fields, so packets can be appended as they come
+        uint8_t prefix[16];
+        size_t length = 0;
+        uint64_t value = (static_cast<uint64_t>(TRACE_PACKET) << 3) | WIRE_LENGTH;
+        for (int field = 0; field < 2; ++field)
+        {
+            while (value >= 0x80U)
+            {
+                prefix[length++] = static_cast<uint8_t>(value | 0x80U);
+                value >>= 7;
+            }
+            prefix[length++] = static_cast<uint8_t>(value);
+            value = m_packet.size();
+        }
+
+        if (std::fwrite(prefix, 1, length, m_file) != length ||
+            std::fwrite(m_packet.data(), 1, m_packet.size(), m_file) != m_packet.size())
+        {
+            m_failed = true;
+        }
+        ++m_packets;
+    }
+
+    uint64_t PerfettoWriter::toNanoseconds(uint64_t ticks) const noexcept
+    {
+        // Split to stay exact and within 64 bits for long traces
+        return (ticks / m_frequency) * NANOSECONDS_PER_SECOND +
+               (ticks % m_frequency) * NANOSECONDS_PER_SECOND / m_frequency;
+    }
+} // namespace rtt::host
@@ -0,0 +1,297 @@
+#include <rtt_host/rtt_host.h>
+#include <rtt_host/data_stream.hpp>
+#include <rtt_host/mapped_file.hpp>
+#include <rtt_host/perfetto_writer.hpp>
+#include <rtt_host/trace_analysis.hpp>
+#include <rtt_host/trace_decoder.hpp>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using rtt::host::TraceRecord;
+
+static_assert(sizeof(RttHostTraceRecord) == sizeof(TraceRecord), "RttHostTraceRecord must match TraceRecord");
+static_assert(offsetof(RttHostTraceRecord, type) == offsetof(TraceRecord, type),
+              "RttHostTraceRecord must match TraceRecord");
+
+struct RttHostTrace
+{
+    rtt::host::MappedFile file;
+    std::vector<TraceRecord> records; // Decoded by the first rtt_host_trace_records()
+    bool decoded{false};
+    rtt::host::TraceSummary summary;
+    rtt::host::TraceEncoding encoding{rtt::host::TraceEncoding::V1};
+    std::map<uint32_t, std::string> names;
+    std::unordered_map<uint32_t, std::string> fallbackNames; // Returned by rtt_host_trace_task_name()
+};
+
+struct RttHostData
+{
+    rtt::host::MappedFile file;
+    rtt::host::DataStream stream{nullptr, 0};
+};
+
+namespace
+{
+    void fillSummary(const rtt::host::TraceSummary& source, rtt::host::TraceEncoding encoding,
+                     RttHostTraceSummary& summary) noexcept
+    {
+        summary = RttHostTraceSummary{};
+        summary.events = source.events;
+        summary.first_timestamp = source.firstTimestamp;
+        summary.last_timestamp = source.lastTimestamp;
+        summary.gaps = source.gaps;
+        summary.lost_events = source.lostEvents;
+        summary.unmatched_in = source.unmatchedIn;
+        summary.unmatched_out = source.unmatchedOut;
+        summary.isr_count = source.isrCount;
+        summary.isr_matched = source.isrDurations.count;
+        summary.isr_total = source.isrDurations.total;
+        summary.isr_min = source.isrDurations.min;
+        summary.isr_max = source.isrDurations.max;
+        summary.task_count = static_cast<uint32_t>(source.tasks.size());
+        summary.encoding = encoding == rtt::host::TraceEncoding::V2 ? 2U : 1U;
+    }
+} // namespace
+
+extern "C" {
+
+RttHostTrace* rtt_host_trace_open(const char* path, unsigned threads)
+{
+    try
+    {
+        auto trace = std::make_unique<RttHostTrace>();
+        if (path == nullptr || !trace->file.open(path))
+        {
+            return nullptr;
+        }
+
+        // The summary is computed while streaming; records are only kept if asked for
+        rtt::host::TraceDecoder decoder(trace->file.data(), trace->file.size());
+        rtt::host::AnalysisOptions options;
+        options.threads = threads;
+        trace->summary = rtt::host::analyzeTrace(decoder, options);
+        trace->encoding = decoder.getEncoding();
+        trace->names.insert(decoder.getTaskNames().begin(), decoder.getTaskNames().end());
+        return trace.release();
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+void rtt_host_trace_close(RttHostTrace* trace)
+{
+    delete trace;
+}
+
+const RttHostTraceRecord* rtt_host_trace_records(RttHostTrace* trace, uint64_t* count)
+{
+    if (trace == nullptr)
+    {
+        return nullptr;
+    }
+    try
+    {
+        if (!trace->decoded)
+        {
+            // Second pass over the mapping, only for callers that need the individual events
+            rtt::host::TraceDecoder decoder(trace->file.data(), trace->file.size());
+            constexpr size_t BLOCK{65536};
+            trace->records.reserve(trace->summary.events);
+            size_t decoded = 0;
+            do
+            {
+                const size_t used = trace->records.size();
+                trace->records.resize(used + BLOCK);
+                decoded = decoder.next(&trace->records[used], BLOCK);
+                trace->records.resize(used + decoded);
+            } while (decoded != 0);
+            trace->records.shrink_to_fit();
+            trace->decoded = true;
+        }
+    }
+    catch (const std::exception&)
+    {
+        trace->records.clear();
+        return nullptr;
+    }
+    if (count != nullptr)
+    {
+        *count = trace->records.size();
+    }
+    return reinterpret_cast<const RttHostTraceRecord*>(trace->records.data());
+}
+
+int rtt_host_trace_summary(const RttHostTrace* trace, RttHostTraceSummary* summary)
+{
+    if (trace == nullptr || summary == nullptr)
+    {
+        return 0;
+    }
+    fillSummary(trace->summary, trace->encoding, *summary);
+    return 1;
+}
+
+uint64_t rtt_host_trace_type_count(const RttHostTrace* trace, uint32_t type)
+{
+    if (trace == nullptr || type >= trace->summary.typeCounts.size())
+    {
+        return 0;
+    }
+    return trace->summary.typeCounts[type];
+}
+
+int rtt_host_trace_task_stats(const RttHostTrace* trace, uint32_t index, RttHostTaskStats* stats)
+{
+    if (trace == nullptr || stats == nullptr || index >= trace->summary.tasks.size())
+    {
+        return 0;
+    }
+    auto task = trace->summary.tasks.begin();
+    std::advance(task, index);
+    *stats = RttHostTaskStats{};
+    stats->handle = task->first;
+    stats->count = task->second.count;
+    stats->total = task->second.total;
+    stats->min = task->second.min;
+    stats->max = task->second.max;
+    return 1;
+}
+
+const char* rtt_host_trace_task_name(RttHostTrace* trace, uint32_t handle)
+{
+    if (trace == nullptr)
+    {
+        return nullptr;
+    }
+    try
+    {
+        const auto name = trace->names.find(handle);
+        if (name != trace->names.end())
+        {
+            return name->second.c_str();
+        }
+        auto& fallback = trace->fallbackNames[handle];
+        if (fallback.empty())
+        {
+            char text[16];
+            std::snprintf(text, sizeof(text), "Task_0x%08X", static_cast<unsigned>(handle));
+            fallback = text;
+        }
+        return fallback.c_str();
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+const char* rtt_host_trace_registry_entry(const RttHostTrace* trace, uint32_t index, uint32_t* handle)
+{
+    if (trace == nullptr || index >= trace->names.size())
+    {
+        return nullptr;
+    }
+    auto entry = trace->names.begin();
+    std::advance(entry, index);
+    if (handle != nullptr)
+    {
+        *handle = entry->first;
+    }
+    return entry->second.c_str();
+}
+
+int rtt_host_export_perfetto(const char* trace_path, const char* output_path, uint64_t frequency, unsigned threads,
+                             RttHostTraceSummary* summary)
+{
+    if (trace_path == nullptr || output_path == nullptr)
+    {
+        return 0;
+    }
+    try
+    {
+        rtt::host::MappedFile file;
+        if (!file.open(trace_path))
+        {
+            return 0;
+        }
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> output(std::fopen(output_path, "wb"), &std::fclose);
+        if (output == nullptr)
+        {
+            return 0;
+        }
+
+        rtt::host::TraceDecoder decoder(file.data(), file.size());
+        rtt::host::PerfettoWriter writer(output.get(), decoder, frequency);
+        rtt::host::AnalysisOptions options;
+        options.threads = threads;
+        options.onBlock = [&writer](const TraceRecord* records, size_t count) { writer.write(records, count); };
+        const rtt::host::TraceSummary result = rtt::host::analyzeTrace(decoder, options);
+
+        const bool written = writer.finish();
+        const bool closed = std::fclose(output.release()) == 0;
+        if (summary != nullptr)
+        {
+            fillSummary(result, decoder.getEncoding(), *summary);
+        }
+        return written && closed ? 1 : 0;
+    }
+    catch (const std::exception&)
+    {
+        return 0;
+    }
+}
+
+RttHostData* rtt_host_data_open(const char* path)
+{
+    auto* data = new (std::nothrow) RttHostData();
+    if (data == nullptr)
+    {
+        return nullptr;
+    }
+    if (path == nullptr || !data->file.open(path))
+    {
+        delete data;
+        return nullptr;
+    }
+    data->stream = rtt::host::DataStream(data->file.data(), data->file.size());
+    return data;
+}
+
+void rtt_host_data_close(RttHostData* data)
+{
+    delete data;
+}
+
+int rtt_host_data_next(RttHostData* data, RttHostDataPacket* packet)
+{
+    rtt::host::DataPacket next{};
+    if (data == nullptr || packet == nullptr || !data->stream.next(next))
+    {
+        return 0;
+    }
+    *packet = RttHostDataPacket{};
+    packet->payload = next.payload;
+    packet->offset = next.offset;
+    packet->size = next.header.size;
+    packet->timestamp = next.header.timestamp;
+    packet->type = static_cast<uint8_t>(next.header.type);
+    packet->subtype = next.header.subtype;
+    return 1;
+}
+
+uint64_t rtt_host_data_skipped(const RttHostData* data)
+{
+    return data == nullptr ? 0U : data->stream.getSkippedBytes();
+}
+
+} // extern "C"
@@ -0,0 +1,425 @@
+#include <rtt_host/trace_analysis.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rtt::host
+{
+    namespace
+    {
+        /**
+         * @brief Running task between two task events
+         */
+        struct TaskState
+        {
+            bool running{false};
+            uint32_t handle{0};
+            uint64_t start{0};
+        };
+
+        /**
+         * @brief Running ISR between two ISR events
+         */
+        struct IsrState
+        {
+            bool running{false};
+            uint64_t start{0};
+        };
+
+        /**
+         * @brief Statistics of one block, relative to its first task and ISR events
+         *
+         * The task and ISR state after the first (lead) event of each kind does
+         * not depend on earlier events, so everything after it is computed by
+         * the worker. Only the lead events themselves need the state carried
+         * over from the previous blocks and are applied during the merge.
+         */
+        struct BlockResult
+        {
+            TraceSummary summary;
+            bool hasTaskLead{false};
+            TraceRecord taskLead{};
+            TaskState task; // After the last task event, valid with hasTaskLead
+            bool hasIsrLead{false};
+            TraceRecord isrLead{};
+            IsrState isr; // After the last ISR event, valid with hasIsrLead
+        };
+
+        bool isTaskEvent(uint8_t type) noexcept
+        {
+            return type == TRACE_EVENT_TASK_SWITCHED_IN || type == TRACE_EVENT_TASK_SWITCHED_OUT ||
+                   type == TRACE_EVENT_EVENTS_LOST;
+        }
+
+        bool isIsrEvent(uint8_t type) noexcept
+        {
+            return type == TRACE_EVENT_ISR_ENTER || type == TRACE_EVENT_ISR_EXIT || type == TRACE_EVENT_EVENTS_LOST;
+        }
+
+        void stepTask(TaskState& state, const TraceRecord& record, TraceSummary& summary)
+        {
+            switch (record.type)
+            {
+            case TRACE_EVENT_EVENTS_LOST:
+                // The switch out may be among the lost events; don't count across the gap
+                state.running = false;
+                break;
+            case TRACE_EVENT_TASK_SWITCHED_IN:
+                if (state.running)
+                {
+                    ++summary.unmatchedIn;
+                }
+                state = TaskState{true, record.handle, record.timestamp};
+                break;
+            case TRACE_EVENT_TASK_SWITCHED_OUT:
+                if (!state.running)
+                {
+                    ++summary.unmatchedOut;
+                }
+                else if (record.timestamp >= state.start)
+                {
+                    // Attributed to the task switched out, even if another one was switched in
+                    summary.tasks[record.handle].add(record.timestamp - state.start);
+                }
+                state.running = false;
+                break;
+            default:
+                break;
+            }
+        }
+
+        void stepIsr(IsrState& state, const TraceRecord& record, TraceSummary& summary) noexcept
+        {
+            switch (record.type)
+            {
+            case TRACE_EVENT_EVENTS_LOST:
+                state.running = false;
+                break;
+            case TRACE_EVENT_ISR_ENTER:
+                state = IsrState{true, record.timestamp};
+                ++summary.isrCount;
+                break;
+            case TRACE_EVENT_ISR_EXIT:
+                if (state.running && record.timestamp >= state.start)
+                {
+                    summary.isrDurations.add(record.timestamp - state.start);
+                }
+                state.running = false;
+                break;
+            default:
+                break;
+            }
+        }
+
+        BlockResult analyzeBlock(const TraceRecord* records, size_t count)
+        {
+            BlockResult result;
+            TraceSummary& summary = result.summary;
+            if (count == 0)
+            {
+                return result;
+            }
+
+            summary.events = count;
+            summary.firstTimestamp = records[0].timestamp;
+            summary.lastTimestamp = records[count - 1].timestamp;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const TraceRecord& record = records[i];
+                ++summary.typeCounts[record.type & 0x7FU];
+                if (record.type == TRACE_EVENT_EVENTS_LOST)
+                {
+                    ++summary.gaps;
+                    summary.lostEvents += record.data;
+                }
+
+                if (isTaskEvent(record.type))
+                {
+                    if (!result.hasTaskLead)
+                    {
+                        result.hasTaskLead = true;
+                        result.taskLead = record;
+                        // The state after the lead is the same whatever came before
+                        TraceSummary ignored;
+                        stepTask(result.task, record, ignored);
+                    }
+                    else
+                    {
+                        stepTask(result.task, record, summary);
+                    }
+                }
+
+                if (isIsrEvent(record.type))
+                {
+                    if (!result.hasIsrLead)
+                    {
+                        result.hasIsrLead = true;
+                        result.isrLead = record;
+                        TraceSummary ignored;
+                        stepIsr(result.isr, record, ignored);
+                    }
+                    else
+                    {
+                        stepIsr(result.isr, record, summary);
+                    }
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Combines block results in stream order
+         */
+        class Merger
+        {
+        public:
+            void add(const BlockResult& block)
+            {
+                const TraceSummary& part = block.summary;
+                if (part.events == 0)
+                {
+                    return;
+                }
+
+                if (m_summary.events == 0)
+                {
+                    m_summary.firstTimestamp = part.firstTimestamp;
+                }
+                m_summary.lastTimestamp = part.lastTimestamp;
+                m_summary.events += part.events;
+                m_summary.gaps += part.gaps;
+                m_summary.lostEvents += part.lostEvents;
+                for (size_t type = 0; type < part.typeCounts.size(); ++type)
+                {
+                    m_summary.typeCounts[type] += part.typeCounts[type];
+                }
+
+                if (block.hasTaskLead)
+                {
+                    stepTask(m_task, block.taskLead, m_summary);
+                    m_task = block.task;
+                }
+                if (block.hasIsrLead)
+                {
+                    stepIsr(m_isr, block.isrLead, m_summary);
+                    m_isr = block.isr;
+                }
+
+                for (const auto& [handle, stats] : part.tasks)
+                {
+                    m_summary.tasks[handle].merge(stats);
+                }
+                m_summary.unmatchedIn += part.unmatchedIn;
+                m_summary.unmatchedOut += part.unmatchedOut;
+                m_summary.isrCount += part.isrCount;
+                m_summary.isrDurations.merge(part.isrDurations);
+            }
+
+            TraceSummary finish()
+            {
+                // A task still running when the trace ended counts up to the last event
+                if (m_task.running && m_summary.lastTimestamp >= m_task.start)
+                {
+                    m_summary.tasks[m_task.handle].add(m_summary.lastTimestamp - m_task.start);
+                }
+                m_task.running = false;
+                return std::move(m_summary);
+            }
+
+        private:
+            TraceSummary m_summary;
+            TaskState m_task;
+            IsrState m_isr;
+        };
+
+        unsigned workerCount(const AnalysisOptions& options) noexcept
+        {
+            if (options.threads != 0)
+            {
+                return options.threads;
+            }
+            const unsigned hardware = std::thread::hardware_concurrency();
+            return hardware == 0 ? 1U : hardware;
+        }
+    } // namespace
+
+    TraceSummary analyzeTrace(TraceDecoder& decoder, const AnalysisOptions& options)
+    {
+        const unsigned threads = workerCount(options);
+        const size_t blockSize = options.blockSize == 0 ? 1U : options.blockSize;
+        Merger merger;
+
+        if (threads <= 1)
+        {
+            std::vector<TraceRecord> block(blockSize);
+            size_t count = 0;
+            while ((count = decoder.next(block.data(), block.size())) != 0)
+            {
+                if (options.onBlock)
+                {
+                    options.onBlock(block.data(), count);
+                }
+                merger.add(analyzeBlock(block.data(), count));
+            }
+            return merger.finish();
+        }
+
+        struct Job
+        {
+            size_t index;
+            std::vector<TraceRecord> records;
+            size_t count;
+        };
+
+        // Two blocks per worker in flight bound the memory use for any capture size
+        const size_t maxBuffers = static_cast<size_t>(threads) * 2U;
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<Job> pending;
+        std::vector<std::vector<TraceRecord>> buffers;
+        size_t allocated = 0;
+        bool done = false;
+        // Results that finished ahead of an earlier block. Each block is merged and dropped as soon as all
+        // blocks before it are merged; decoding pauses while maxBuffers results wait.
+        std::map<size_t, BlockResult> early;
+        size_t nextMerge = 0;
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (unsigned worker = 0; worker < threads; ++worker)
+        {
+            workers.emplace_back([&]() {
+                std::unique_lock<std::mutex> lock(mutex);
+                for (;;)
+                {
+                    changed.wait(lock, [&]() { return done || !pending.empty(); });
+                    if (pending.empty())
+                    {
+                        return;
+                    }
+                    Job job = std::move(pending.front());
+                    pending.pop_front();
+                    lock.unlock();
+
+                    BlockResult result = analyzeBlock(job.records.data(), job.count);
+
+                    lock.lock();
+                    buffers.push_back(std::move(job.records));
+                    if (job.index != nextMerge)
+                    {
+                        early.emplace(job.index, std::move(result));
+                    }
+                    else
+                    {
+                        merger.add(result);
+                        for (auto next = early.find(++nextMerge); next != early.end(); next = early.find(++nextMerge))
+                        {
+                            merger.add(next->second);
+                            early.erase(next);
+                        }
+                    }
+                    changed.notify_all();
+                }
+            });
+        }
+
+        for (size_t index = 0;; ++index)
+        {
+            std::vector<TraceRecord> block;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() {
+                    return early.size() < maxBuffers && (!buffers.empty() || allocated < maxBuffers);
+                });
+                if (!buffers.empty())
+                {
+                    block = std::move(buffers.back());
+                    buffers.pop_back();
+                }
+                else
+                {
+                    ++allocated;
+                }
+            }
+            block.resize(blockSize);
+
+            const size_t count = decoder.next(block.data(), block.size());
+            if (count == 0)
+            {
+                break;
+            }
+            if (options.onBlock)
+            {
+                options.onBlock(block.data(), count);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(Job{index, std::move(block), count});
+            changed.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            changed.notify_all();
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+
+        return merger.finish();
+    }
+
+    TraceSummary analyzeRecords(const TraceRecord* records, size_t count, const AnalysisOptions& options)
+    {
+        const unsigned threads = workerCount(options);
+        const size_t blockSize = options.blockSize == 0 ? 1U : options.blockSize;
+        const size_t blocks = (count + blockSize - 1) / blockSize;
+        std::vector<BlockResult> results(blocks);
+
+        auto analyze = [&](size_t index) {
+            const size_t offset = index * blockSize;
+            results[index] = analyzeBlock(&records[offset], count - offset < blockSize ? count - offset : blockSize);
+        };
+
+        if (threads <= 1 || blocks <= 1)
+        {
+            for (size_t index = 0; index < blocks; ++index)
+            {
+                analyze(index);
+            }
+        }
+        else
+        {
+            // The records are already in memory, so the workers just claim block indices
+            std::atomic<size_t> next{0};
+            std::vector<std::thread> workers;
+            const size_t workerTotal = threads < blocks ? threads : blocks;
+            workers.reserve(workerTotal);
+            for (size_t worker = 0; worker < workerTotal; ++worker)
+            {
+                workers.emplace_back([&]() {
+                    for (size_t index = next.fetch_add(1); index < blocks; index = next.fetch_add(1))
+                    {
+                        analyze(index);
+                    }
+                });
+            }
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        Merger merger;
+        for (const BlockResult& result : results)
+        {
+            merger.add(result);
+        }
+        return merger.finish();
+    }
+} // namespace rtt::host
@@ -0,0 +1,397 @@
+#include <rtt_host/trace_decoder.hpp>
+#include <cstdio>
+#include <cstring>
+
+namespace rtt::host
+{
+    namespace
+    {
+        // In-band text of the trace channel (rtt_freertos_trace.cpp)
+        constexpr char V1_HEADER[] = "RTT_TRACE_V1\n";
+        constexpr char V2_HEADER[] = "RTT_TRACE_V2\n";
+        constexpr char BINARY_REGISTRY[] = "TASK_REGISTRY_BIN\n";
+        constexpr char TEXT_REGISTRY_START[] = "TASK_REGISTRY_START\n";
+        constexpr char TEXT_REGISTRY_END[] = "TASK_REGISTRY_END\n";
+        constexpr const char* TEXT_MARKERS[] = {V1_HEADER,          V2_HEADER,        "TRACE_START\n",
+                                                "TRACE_STOP\n",     "TRACE_SNAPSHOT\n", "TRACE_SNAPSHOT_END\n"};
+
+        // RTT_TRACE_V2 record framing (rtt_freertos_trace.cpp)
+        constexpr uint8_t V2_SYNC{0x7E};
+        constexpr uint8_t V2_HAS_DATA{0x80};
+        constexpr uint8_t V2_TYPE_MASK{0x7F};
+        constexpr unsigned MAX_VARINT_SHIFT{35};
+
+        template <size_t N>
+        constexpr size_t length(const char (&)[N]) noexcept
+        {
+            return N - 1;
+        }
+
+        const uint8_t* find(const uint8_t* data, size_t size, const char* pattern, size_t length) noexcept
+        {
+            const uint8_t* end = data + size;
+            while (static_cast<size_t>(end - data) >= length)
+            {
+                const void* first = std::memchr(data, pattern[0], static_cast<size_t>(end - data) - length + 1);
+                if (first == nullptr)
+                {
+                    return nullptr;
+                }
+                data = static_cast<const uint8_t*>(first);
+                if (std::memcmp(data, pattern, length) == 0)
+                {
+                    return data;
+                }
+                ++data;
+            }
+            return nullptr;
+        }
+    } // namespace
+
+    bool isTraceEventType(uint8_t type) noexcept
+    {
+        return std::strcmp(traceEventName(type), "UNKNOWN") != 0;
+    }
+
+    const char* traceEventName(uint8_t type) noexcept
+    {
+        switch (type)
+        {
+        case TRACE_EVENT_TASK_SWITCHED_IN:
+            return "TASK_SWITCHED_IN";
+        case TRACE_EVENT_TASK_SWITCHED_OUT:
+            return "TASK_SWITCHED_OUT";
+        case TRACE_EVENT_TASK_CREATE:
+            return "TASK_CREATE";
+        case TRACE_EVENT_TASK_DELETE:
+            return "TASK_DELETE";
+        case TRACE_EVENT_TASK_READY:
+            return "TASK_READY";
+        case TRACE_EVENT_TASK_SUSPENDED:
+            return "TASK_SUSPENDED";
+        case TRACE_EVENT_TASK_RESUMED:
+            return "TASK_RESUMED";
+        case TRACE_EVENT_ISR_ENTER:
+            return "ISR_ENTER";
+        case TRACE_EVENT_ISR_EXIT:
+            return "ISR_EXIT";
+        case TRACE_EVENT_QUEUE_CREATE:
+            return "QUEUE_CREATE";
+        case TRACE_EVENT_QUEUE_SEND:
+            return "QUEUE_SEND";
+        case TRACE_EVENT_QUEUE_RECEIVE:
+            return "QUEUE_RECEIVE";
+        case TRACE_EVENT_SEMAPHORE_CREATE:
+            return "SEMAPHORE_CREATE";
+        case TRACE_EVENT_SEMAPHORE_GIVE:
+            return "SEMAPHORE_GIVE";
+        case TRACE_EVENT_SEMAPHORE_TAKE:
+            return "SEMAPHORE_TAKE";
+        case TRACE_EVENT_MUTEX_CREATE:
+            return "MUTEX_CREATE";
+        case TRACE_EVENT_MUTEX_GIVE:
+            return "MUTEX_GIVE";
+        case TRACE_EVENT_MUTEX_TAKE:
+            return "MUTEX_TAKE";
+        case TRACE_EVENT_TIMER_CREATE:
+            return "TIMER_CREATE";
+        case TRACE_EVENT_TIMER_START:
+            return "TIMER_START";
+        case TRACE_EVENT_TIMER_STOP:
+            return "TIMER_STOP";
+        case TRACE_EVENT_MALLOC:
+            return "MALLOC";
+        case TRACE_EVENT_FREE:
+            return "FREE";
+        case TRACE_EVENT_EVENTS_LOST:
+            return "EVENTS_LOST";
+        default:
+            return "UNKNOWN";
+        }
+    }
+
+    TraceDecoder::TraceDecoder(const uint8_t* data, size_t size) noexcept : m_data(data), m_size(size)
+    {
+        const uint8_t* header = find(data, size, V2_HEADER, length(V2_HEADER));
+        if (header != nullptr)
+        {
+            m_encoding = TraceEncoding::V2;
+            m_offset = static_cast<size_t>(header - data) + length(V2_HEADER);
+        }
+    }
+
+    std::string TraceDecoder::getTaskName(uint32_t handle) const
+    {
+        const auto name = m_names.find(handle);
+        if (name != m_names.end())
+        {
+            return name->second;
+        }
+        char fallback[16];
+        std::snprintf(fallback, sizeof(fallback), "Task_0x%08X", static_cast<unsigned>(handle));
+        return fallback;
+    }
+
+    size_t TraceDecoder::next(TraceRecord* records, size_t capacity) noexcept
+    {
+        return m_encoding == TraceEncoding::V2 ? nextV2(records, capacity) : nextV1(records, capacity);
+    }
+
+    bool TraceDecoder::startsWith(const char* marker, size_t length) const noexcept
+    {
+        return m_size - m_offset >= length && std::memcmp(&m_data[m_offset], marker, length) == 0;
+    }
+
+    bool TraceDecoder::skipInBand() noexcept
+    {
+        // All in-band text starts with 'R' or 'T'
+        const uint8_t first = m_data[m_offset];
+        if (first != 'R' && first != 'T')
+        {
+            return false;
+        }
+        if (startsWith(BINARY_REGISTRY, length(BINARY_REGISTRY)))
+        {
+            parseBinaryRegistry();
+            return true;
+        }
+        if (startsWith(TEXT_REGISTRY_START, length(TEXT_REGISTRY_START)))
+        {
+            parseTextRegistry();
+            return true;
+        }
+        for (const char* marker : TEXT_MARKERS)
+        {
+            const size_t size = std::strlen(marker);
+            if (startsWith(marker, size))
+            {
+                m_offset += size;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void TraceDecoder::parseBinaryRegistry() noexcept
+    {
+        // Marker, uint8 count, then per entry: uint32 handle, uint8 name length, name
+        size_t offset = m_offset + length(BINARY_REGISTRY);
+        if (offset >= m_size)
+        {
+            m_offset = m_size;
+            return;
+        }
+
+        const uint8_t count = m_data[offset++];
+        std::vector<uint32_t> handles;
+        handles.reserve(count);
+        for (uint8_t entry = 0; entry < count; ++entry)
+        {
+            if (m_size - offset < sizeof(uint32_t) + 1U)
+            {
+                m_offset = m_size;
+                return;
+            }
+            uint32_t handle = 0;
+            std::memcpy(&handle, &m_data[offset], sizeof(handle));
+            const uint8_t nameLength = m_data[offset + sizeof(handle)];
+            offset += sizeof(handle) + 1U;
+            if (m_size - offset < nameLength)
+            {
+                m_offset = m_size;
+                return;
+            }
+            m_names[handle].assign(reinterpret_cast<const char*>(&m_data[offset]), nameLength);
+            handles.push_back(handle);
+            offset += nameLength;
+        }
+
+        // A resent registry replaces the index mapping (a reused TCB keeps its index)
+        m_index = std::move(handles);
+        m_offset = offset;
+    }
+
+    void TraceDecoder::parseTextRegistry() noexcept
+    {
+        // "TASK:<handle>:<name>" lines up to the end marker
+        const size_t start = m_offset + length(TEXT_REGISTRY_START);
+        const uint8_t* end =
+            find(&m_data[start], m_size - start, TEXT_REGISTRY_END, length(TEXT_REGISTRY_END));
+        if (end == nullptr)
+        {
+            m_offset = m_size;
+            return;
+        }
+
+        m_index.clear();
+        const char* line = reinterpret_cast<const char*>(&m_data[start]);
+        const char* const last = reinterpret_cast<const char*>(end);
+        while (line < last)
+        {
+            const void* newline = std::memchr(line, '\n', static_cast<size_t>(last - line));
+            const char* lineEnd = newline == nullptr ? last : static_cast<const char*>(newline);
+            if (lineEnd - line > 5 && std::memcmp(line, "TASK:", 5) == 0)
+            {
+                const char* cursor = line + 5;
+                uint64_t handle = 0;
+                const char* digits = cursor;
+                while (cursor < lineEnd && *cursor >= '0' && *cursor <= '9' && handle <= UINT32_MAX)
+                {
+                    handle = handle * 10U + static_cast<uint64_t>(*cursor - '0');
+                    ++cursor;
+                }
+                if (cursor != digits && cursor < lineEnd && *cursor == ':' && handle <= UINT32_MAX)
+                {
+                    const char* name = cursor + 1;
+                    const char* nameEnd = lineEnd;
+                    while (nameEnd > name && (nameEnd[-1] == ' ' || nameEnd[-1] == '\r' || nameEnd[-1] == '\t'))
+                    {
+                        --nameEnd;
+                    }
+                    m_names[static_cast<uint32_t>(handle)].assign(name, static_cast<size_t>(nameEnd - name));
+                    m_index.push_back(static_cast<uint32_t>(handle));
+                }
+            }
+            line = lineEnd + 1;
+        }
+        m_offset = static_cast<size_t>(end - m_data) + length(TEXT_REGISTRY_END);
+    }
+
+    bool TraceDecoder::readVarint(size_t& offset, uint64_t& value) const noexcept
+    {
+        value = 0;
+        for (unsigned shift = 0; shift <= MAX_VARINT_SHIFT; shift += 7)
+        {
+            if (offset >= m_size)
+            {
+                return false;
+            }
+            const uint8_t byte = m_data[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t TraceDecoder::decodeHandle(uint64_t value) const noexcept
+    {
+        // (index << 1) | 1 for tasks of the last registry, handle << 1 otherwise
+        const uint64_t payload = value >> 1;
+        if ((value & 1U) != 0 && payload < m_index.size())
+        {
+            return m_index[static_cast<size_t>(payload)];
+        }
+        return static_cast<uint32_t>(payload);
+    }
+
+    void TraceDecoder::extend(uint32_t timestamp) noexcept
+    {
+        if (!m_started)
+        {
+            m_timestamp = timestamp;
+            m_started = true;
+            return;
+        }
+        // Nearest 64-bit value with these low bits: wraps go forward, small reorderings backward
+        const auto delta = static_cast<int32_t>(timestamp - static_cast<uint32_t>(m_timestamp));
+        if (delta < 0 && static_cast<uint64_t>(-static_cast<int64_t>(delta)) > m_timestamp)
+        {
+            m_timestamp = 0;
+            return;
+        }
+        m_timestamp = static_cast<uint64_t>(static_cast<int64_t>(m_timestamp) + delta);
+    }
+
+    size_t TraceDecoder::nextV1(TraceRecord* records, size_t capacity) noexcept
+    {
+        size_t count = 0;
+        while (count < capacity && m_size - m_offset >= sizeof(TraceEvent))
+        {
+            if (skipInBand())
+            {
+                continue;
+            }
+
+            TraceEvent event{};
+            std::memcpy(&event, &m_data[m_offset], sizeof(event));
+            if (!isTraceEventType(event.event_type))
+            {
+                ++m_offset; // Resynchronize on the next byte
+                continue;
+            }
+
+            extend(event.timestamp);
+            TraceRecord& record = records[count++];
+            record = TraceRecord{};
+            record.timestamp = m_timestamp;
+            record.handle = event.handle;
+            record.data = event.data;
+            record.type = event.event_type;
+            m_offset += sizeof(event);
+        }
+        return count;
+    }
+
+    size_t TraceDecoder::nextV2(TraceRecord* records, size_t capacity) noexcept
+    {
+        size_t count = 0;
+        while (count < capacity && m_offset < m_size)
+        {
+            if (skipInBand())
+            {
+                continue;
+            }
+
+            const uint8_t first = m_data[m_offset];
+            if (first == V2_SYNC)
+            {
+                if (m_size - m_offset < 1U + sizeof(uint32_t))
+                {
+                    m_offset = m_size;
+                    break;
+                }
+                uint32_t timestamp = 0;
+                std::memcpy(&timestamp, &m_data[m_offset + 1], sizeof(timestamp));
+                extend(timestamp);
+                m_haveTimestamp = true;
+                m_offset += 1U + sizeof(timestamp);
+                continue;
+            }
+
+            const auto type = static_cast<uint8_t>(first & V2_TYPE_MASK);
+            if (!m_haveTimestamp || !isTraceEventType(type))
+            {
+                // Lost framing: skip ahead to the next sync record
+                m_haveTimestamp = false;
+                ++m_offset;
+                continue;
+            }
+
+            size_t offset = m_offset + 1;
+            uint64_t zigzag = 0;
+            uint64_t handle = 0;
+            uint64_t data = 0;
+            if (!readVarint(offset, zigzag) || !readVarint(offset, handle) ||
+                ((first & V2_HAS_DATA) != 0 && !readVarint(offset, data)))
+            {
+                m_offset = m_size; // Truncated record at the end of the capture
+                break;
+            }
+
+            const auto delta = static_cast<uint32_t>((zigzag >> 1) ^ (0U - (zigzag & 1U)));
+            extend(static_cast<uint32_t>(m_timestamp) + delta);
+
+            TraceRecord& record = records[count++];
+            record = TraceRecord{};
+            record.timestamp = m_timestamp;
+            record.handle = decodeHandle(handle);
+            record.data = static_cast<uint32_t>(data);
+            record.type = type;
+            m_offset = offset;
+        }
+        return count;
+    }
+} // namespace rtt::host
@@ -79,6 +79,16 @@ int main()
     // Non-formattable types would cause compile errors with concepts
 #endif
 
+    // Example 7: Level macros are removed entirely when the level is below the
+    // RTT_LOG_MIN_LEVEL build option (no call, no format string in flash)
+    RTT_LOG_DEBUG(logger, "Compiled-in debug message: %d", value);
+    RTT_LOG_INFO(logger, "Compiled-in info message");
+
+    // Example 8: Deferred logging - only the format string address and raw
+    // arguments are sent; decode with scripts/rtt_log_decoder.py and the ELF
+    const auto sensor = "adc0";
+    RTT_LOG_DEFERRED(logger, rtt::LogLevel::Info, "Deferred: %s = %d mV (%.1f%%)", sensor, value, pi);
+
     logger.info("===========================================");
     logger.info("  Logger Example Completed");
     logger.info("===========================================");
@@ -0,0 +1,307 @@
+#pragma once
+
+/**
+ * @file isr_log_queue.hpp
+ * @brief Bounded-cycle logging from interrupt handlers
+ *
+ * Logger::log() takes the RTT lock and may spin in blocking mode, and
+ * logFormatted() runs snprintf; neither belongs in an interrupt handler. An
+ * ISR instead pushes a fixed-size record - format pointer, timestamp and up
+ * to RTT_LOG_ISR_MAX_ARGS argument words - into a lock-free MpscRing. The
+ * idle hook or a low-priority task drains the ring and formats the records
+ * as text or forwards them as deferred binary records. A full ring drops and
+ * counts records instead of blocking.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <rtt_logger/mpsc_ring.hpp>
+#include <rtt_logger/rtt_logger.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
+
+#ifndef RTT_LOG_ISR_QUEUE_SIZE
+#define RTT_LOG_ISR_QUEUE_SIZE 16 // Records, power of two
+#endif
+
+#ifndef RTT_LOG_ISR_MAX_ARGS
+#define RTT_LOG_ISR_MAX_ARGS 4 // Argument words per record
+#endif
+
+namespace rtt
+{
+    /// Records the ISR log queue holds before it drops
+    static constexpr size_t ISR_LOG_QUEUE_SIZE{RTT_LOG_ISR_QUEUE_SIZE};
+    /// Arguments of one ISR log record
+    static constexpr size_t ISR_LOG_MAX_ARGS{RTT_LOG_ISR_MAX_ARGS};
+    static_assert(ISR_LOG_MAX_ARGS > 0 && ISR_LOG_MAX_ARGS <= UINT8_MAX, "Invalid ISR log argument count");
+
+    /**
+     * @brief One queued ISR log message
+     *
+     * Arguments are machine words: integers up to 32 bits, float (double is
+     * stored as float), pointers and string pointers. Strings are read when
+     * the record is drained, so they must be string literals or other
+     * storage that outlives the record.
+     */
+    struct IsrLogRecord
+    {
+        const char* format;
+        uintptr_t args[ISR_LOG_MAX_ARGS];
+        uint32_t timestamp; // Timebase ticks (low 32 bits) when the record was pushed
+        LogLevel level;
+        uint8_t argCount;
+        bool deferred; // Forward as a deferred binary record instead of formatting it
+        DeferredArgType types[ISR_LOG_MAX_ARGS];
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Store one argument as a word of an ISR log record
+         */
+        template <typename T>
+        void storeIsrArgument(IsrLogRecord& record, size_t index, const T& argument) noexcept
+        {
+            using U = std::decay_t<T>;
+            DeferredArgType type = DeferredArgType::UInt32;
+            uintptr_t word = 0;
+            if constexpr (std::is_floating_point_v<U>)
+            {
+                const auto value = static_cast<float>(argument);
+                uint32_t bits = 0;
+                std::memcpy(&bits, &value, sizeof(bits));
+                type = DeferredArgType::Float;
+                word = bits;
+            }
+            else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)
+            {
+                type = DeferredArgType::String;
+                word = reinterpret_cast<uintptr_t>(argument);
+            }
+            else if constexpr (std::is_pointer_v<U>)
+            {
+                type = DeferredArgType::Pointer;
+                word = reinterpret_cast<uintptr_t>(argument);
+            }
+            else
+            {
+                static_assert(std::is_integral_v<U> || std::is_enum_v<U>, "Unsupported ISR log argument");
+                static_assert(sizeof(U) <= sizeof(uint32_t), "ISR log arguments are at most 32 bits");
+                const bool isSigned = std::is_signed_v<U>;
+                type = isSigned ? DeferredArgType::Int32 : DeferredArgType::UInt32;
+                word = static_cast<uint32_t>(argument);
+            }
+            record.types[index] = type;
+            record.args[index] = word;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Lock-free queue of log messages from interrupt handlers
+     *
+     * push() and pushDeferred() are safe from any task or interrupt,
+     * including nested interrupts, and take a bounded number of cycles: the
+     * level check, a timestamp, the argument copy and one compare-and-swap
+     * (retried only if another producer preempted it). drain() must be called
+     * from one task context, e.g. FreeRtosHooks::addIdleCallback(rtt_log_isr_drain).
+     *
+     * Use RTT_LOG_ISR()/RTT_LOG_ISR_DEFERRED() to remove calls below
+     * RTT_LOG_MIN_LEVEL at compile time:
+     * @code
+     * void ADC_IRQHandler() {
+     *     RTT_LOG_ISR(rtt::LogLevel::Debug, "ADC overrun on %u, status 0x%08x", channel, status);
+     * }
+     * @endcode
+     */
+    class IsrLogQueue
+    {
+    public:
+        static constexpr size_t MAX_ARGS{ISR_LOG_MAX_ARGS};
+
+        constexpr IsrLogQueue() noexcept = default;
+
+        /**
+         * @brief Queue a message formatted as text when drained
+         *
+         * Text records are written like Logger::log(), without timestamp; the
+         * push timestamp is only kept by deferred records.
+         *
+         * @param level Log level, checked against the draining logger now
+         * @param format printf-style format, must outlive the record (a string literal)
+         * @return True if queued, false if the level is disabled or the queue is full
+         */
+#if __cplusplus >= 202002L
+        template <Formattable... Args>
+#else
+        template <typename... Args>
+#endif
+        bool push(LogLevel level, const char* format, const Args&... args) noexcept
+        {
+            return enqueue(false, level, format, args...);
+        }
+
+        /**
+         * @brief Queue a message forwarded as a deferred binary record (see RTT_LOG_DEFERRED)
+         *
+         * The format address is sent instead of the text; use
+         * RTT_LOG_ISR_DEFERRED() so the format lands in the .rtt_fmt section.
+         */
+#if __cplusplus >= 202002L
+        template <Formattable... Args>
+#else
+        template <typename... Args>
+#endif
+        bool pushDeferred(LogLevel level, const char* format, const Args&... args) noexcept
+        {
+            return enqueue(true, level, format, args...);
+        }
+
+        /**
+         * @brief Write queued records to the logger's channel (one consumer only)
+         *
+         * After the records, drops since the last drain are reported as one
+         * warning "<n> ISR log records dropped".
+         *
+         * @param maxRecords Upper bound of records written by this call
+         * @return Number of records written
+         */
+        size_t drain(size_t maxRecords = SIZE_MAX) noexcept;
+
+        /**
+         * @brief Render the message of a record without level prefix or line ending
+         *
+         * Conversions take the record's arguments in order; length modifiers
+         * are ignored as every argument is one word, '*' widths are not
+         * supported and conversions without an argument are copied as-is.
+         *
+         * @return Message length, the buffer is always terminated
+         */
+        static size_t format(char* buffer, size_t capacity, const IsrLogRecord& record) noexcept;
+
+        /**
+         * @brief Logger the records are checked against and written to (default: getLogger())
+         */
+        void setLogger(Logger& logger) noexcept
+        {
+            m_logger = &logger;
+        }
+
+        /**
+         * @brief Records dropped because the queue was full, since the last reset()
+         */
+        [[nodiscard]] uint32_t droppedCount() const noexcept
+        {
+            return m_reported + m_ring.droppedCount();
+        }
+
+        /**
+         * @brief Number of queued records (approximate while producers are active)
+         */
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return m_ring.size();
+        }
+
+        [[nodiscard]] static constexpr size_t capacity() noexcept
+        {
+            return ISR_LOG_QUEUE_SIZE;
+        }
+
+        /**
+         * @brief Discard queued records and counters (not safe while producers are active)
+         */
+        void reset() noexcept
+        {
+            m_ring.reset();
+            m_reported = 0;
+        }
+
+    private:
+        template <typename... Args>
+        bool enqueue(bool deferred, LogLevel level, const char* format, const Args&... args) noexcept
+        {
+            static_assert(sizeof...(Args) <= MAX_ARGS, "Too many ISR log arguments (RTT_LOG_ISR_MAX_ARGS)");
+            if (!logger().isEnabled(level))
+            {
+                return false;
+            }
+
+            IsrLogRecord record;
+            record.format = format;
+            record.timestamp = Timebase::now32();
+            record.level = level;
+            record.argCount = static_cast<uint8_t>(sizeof...(Args));
+            record.deferred = deferred;
+            [[maybe_unused]] size_t index = 0;
+            (detail::storeIsrArgument(record, index++, args), ...);
+            return m_ring.tryPush(record);
+        }
+
+        [[nodiscard]] Logger& logger() const noexcept
+        {
+            return m_logger != nullptr ? *m_logger : getLogger();
+        }
+
+        void write(const IsrLogRecord& record) noexcept;
+
+        MpscRing<IsrLogRecord, ISR_LOG_QUEUE_SIZE> m_ring{};
+        Logger* m_logger{nullptr};
+        uint32_t m_reported{0}; // Drops already reported by drain()
+    };
+
+    /**
+     * @brief Get the global ISR log queue used by RTT_LOG_ISR()
+     */
+    IsrLogQueue& getIsrLogQueue() noexcept;
+} // namespace rtt
+
+/**
+ * @brief Drain the global ISR log queue (for FreeRtosHooks::addIdleCallback() or C code)
+ */
+extern "C" void rtt_log_isr_drain(void);
+
+/**
+ * @brief Queue a log message from an interrupt handler; compiles to nothing below RTT_LOG_MIN_LEVEL
+ *
+ * Usage: RTT_LOG_ISR(rtt::LogLevel::Warning, "UART error 0x%x", status);
+ */
+#define RTT_LOG_ISR(level, ...)                                                                       \
+    do                                                                                                \
+    {                                                                                                 \
+        if constexpr (rtt::isCompiledIn<level>())                                                     \
+        {                                                                                             \
+            rtt::getIsrLogQueue().push((level), __VA_ARGS__);                                         \
+        }                                                                                             \
+    }                                                                                                 \
+    while (0)
+
+/**
+ * @brief Queue a deferred (binary) log message from an interrupt handler, format in .rtt_fmt
+ *
+ * Usage: RTT_LOG_ISR_DEFERRED(rtt::LogLevel::Debug, "DMA %u done", stream);
+ */
+#if __cplusplus >= 202002L
+#define RTT_LOG_ISR_DEFERRED(level, format, ...)                                                      \
+    do                                                                                                \
+    {                                                                                                 \
+        if constexpr (rtt::isCompiledIn<level>())                                                     \
+        {                                                                                             \
+            static const char rtt_isr_format_[] RTT_DEFERRED_FORMAT_SECTION = format;                 \
+            rtt::getIsrLogQueue().pushDeferred((level), rtt_isr_format_ __VA_OPT__(, ) __VA_ARGS__);  \
+        }                                                                                             \
+    }                                                                                                 \
+    while (0)
+#else
+#define RTT_LOG_ISR_DEFERRED(level, format, ...)                                                      \
+    do                                                                                                \
+    {                                                                                                 \
+        if constexpr (rtt::isCompiledIn<level>())                                                     \
+        {                                                                                             \
+            static const char rtt_isr_format_[] RTT_DEFERRED_FORMAT_SECTION = format;                 \
+            rtt::getIsrLogQueue().pushDeferred((level), rtt_isr_format_, ##__VA_ARGS__);              \
+        }                                                                                             \
+    }                                                                                                 \
+    while (0)
+#endif
@@ -0,0 +1,175 @@
+#pragma once
+
+/**
+ * @file mpsc_ring.hpp
+ * @brief Lock-free bounded multi-producer/single-consumer ring
+ *
+ * Producers may run in any context, including nested interrupts: a slot is
+ * reserved with one compare-and-swap on the head index (LDREX/STREX on
+ * ARMv7-M) and published with a per-slot sequence number, so pushing never
+ * disables interrupts and retries only when preempted by another producer.
+ * A single consumer (e.g. a task draining into RTT) pops published slots in
+ * order. When the ring is full, new elements are dropped and counted.
+ *
+ * Requires lock-free 32-bit atomics (Cortex-M3/M4/M7 and hosts). Cortex-M0
+ * has no exclusive access instructions.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace rtt
+{
+    /**
+     * @brief Bounded lock-free MPSC ring of trivially copyable elements
+     * @tparam T Element type
+     * @tparam Capacity Number of slots (power of two)
+     */
+    template <typename T, size_t Capacity>
+    class MpscRing
+    {
+    public:
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static_assert(Capacity <= (1U << 30), "Capacity too large for 32-bit sequence numbers");
+        static_assert(std::is_trivially_copyable_v<T>, "Elements are copied with plain stores");
+
+        constexpr MpscRing() noexcept = default;
+
+        /**
+         * @brief Push an element (safe from any task or interrupt)
+         * @param value Element to copy into the ring
+         * @return true if stored, false if the ring was full (element dropped)
+         */
+        bool tryPush(const T& value) noexcept
+        {
+            uint32_t pos = m_head.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot& slot = m_slots[pos & MASK];
+                const auto diff = static_cast<int32_t>(slot.sequence.load(std::memory_order_acquire) -
+                                                       stored(pos, pos));
+                if (diff == 0)
+                {
+                    if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        slot.value = value;
+                        slot.sequence.store(stored(pos, pos + 1), std::memory_order_release);
+                        return true;
+                    }
+                    // pos was reloaded by the failed CAS
+                }
+                else if (diff < 0)
+                {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    pos = m_head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Pop the oldest published element (single consumer only)
+         * @param value Receives the element
+         * @return true if an element was popped, false if empty or the next slot is still being written
+         */
+        bool tryPop(T& value) noexcept
+        {
+            const uint32_t pos = m_tail.load(std::memory_order_relaxed);
+            Slot& slot = m_slots[pos & MASK];
+            if (slot.sequence.load(std::memory_order_acquire) != stored(pos, pos + 1))
+            {
+                return false;
+            }
+
+            value = slot.value;
+            slot.sequence.store(stored(pos, pos + Capacity), std::memory_order_release);
+            m_tail.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * @brief Approximate number of reserved elements
+         */
+        [[nodiscard]] size_t size() const noexcept
+        {
+            const uint32_t head = m_head.load(std::memory_order_relaxed);
+            const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+            return static_cast<size_t>(head - tail);
+        }
+
+        /**
+         * @brief Check if the ring holds no elements
+         */
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Get the number of slots
+         */
+        [[nodiscard]] static constexpr size_t capacity() noexcept
+        {
+            return Capacity;
+        }
+
+        /**
+         * @brief Get the number of elements dropped because the ring was full
+         */
+        [[nodiscard]] uint32_t droppedCount() const noexcept
+        {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Return the dropped counter and clear it
+         */
+        uint32_t takeDroppedCount() noexcept
+        {
+            return m_dropped.exchange(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Discard all elements (not safe while producers are active)
+         */
+        void reset() noexcept
+        {
+            for (auto& slot : m_slots)
+            {
+                slot.sequence.store(0, std::memory_order_relaxed);
+            }
+            m_head.store(0, std::memory_order_relaxed);
+            m_tail.store(0, std::memory_order_relaxed);
+            m_dropped.store(0, std::memory_order_release);
+        }
+
+    private:
+        static constexpr uint32_t MASK{static_cast<uint32_t>(Capacity - 1)};
+
+        struct Slot
+        {
+            // Stored relative to the slot index so that zero-initialized slots are valid
+            std::atomic<uint32_t> sequence{0};
+            T value{};
+        };
+
+        /**
+         * @brief Convert a sequence value for the slot used by pos into its stored form
+         */
+        [[nodiscard]] static constexpr uint32_t stored(uint32_t pos, uint32_t sequence) noexcept
+        {
+            return sequence - (pos & MASK);
+        }
+
+        std::array<Slot, Capacity> m_slots{};
+        std::atomic<uint32_t> m_head{0};
+        std::atomic<uint32_t> m_tail{0};
+        std::atomic<uint32_t> m_dropped{0};
+    };
+} // namespace rtt
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <string_view>
 #include <type_traits>
+#include <rtt_timebase/rtt_timebase.hpp>
 
 #if __cplusplus >= 202002L
 #include <concepts>
@@ -12,8 +16,54 @@
 extern "C" {
 int SEGGER_RTT_printf(unsigned int BufferIndex, const char* sFormat, ...);
 unsigned int SEGGER_RTT_WriteString(unsigned int BufferIndex, const char* s);
+unsigned int SEGGER_RTT_Write(unsigned int BufferIndex, const void* pBuffer, unsigned int NumBytes);
 }
 
+/**
+ * @brief Section that receives deferred log format strings
+ *
+ * Each call site gets its own input section so inline and non-inline users do not
+ * conflict. Collect them into a non-loaded output section in the linker script:
+ *
+ * ```
+ * .rtt_fmt 0 (INFO) : { KEEP(*(.rtt_fmt .rtt_fmt.*)) }
+ * ```
+ */
+#define RTT_DEFERRED_STRINGIFY_IMPL(x) #x
+#define RTT_DEFERRED_STRINGIFY(x) RTT_DEFERRED_STRINGIFY_IMPL(x)
+#define RTT_DEFERRED_FORMAT_SECTION \
+    __attribute__((section(".rtt_fmt." RTT_DEFERRED_STRINGIFY(__COUNTER__))))
+
+/**
+ * @brief Log a deferred (binary) message; the format string never reaches target flash
+ *
+ * Levels below RTT_LOG_COMPILED_MIN_LEVEL are compiled out, arguments included.
+ * Usage: RTT_LOG_DEFERRED(logger, rtt::LogLevel::Info, "ADC %u: %d mV", channel, millivolts);
+ */
+#if __cplusplus >= 202002L
+#define RTT_LOG_DEFERRED(logger, level, format, ...)                                                  \
+    do                                                                                                \
+    {                                                                                                 \
+        if constexpr (rtt::isCompiledIn<level>())                                                     \
+        {                                                                                             \
+            static const char rtt_deferred_format_[] RTT_DEFERRED_FORMAT_SECTION = format;            \
+            (logger).logDeferred((level), rtt_deferred_format_ __VA_OPT__(, ) __VA_ARGS__);           \
+        }                                                                                             \
+    }                                                                                                 \
+    while (0)
+#else
+#define RTT_LOG_DEFERRED(logger, level, format, ...)                                                  \
+    do                                                                                                \
+    {                                                                                                 \
+        if constexpr (rtt::isCompiledIn<level>())                                                     \
+        {                                                                                             \
+            static const char rtt_deferred_format_[] RTT_DEFERRED_FORMAT_SECTION = format;            \
+            (logger).logDeferred((level), rtt_deferred_format_, ##__VA_ARGS__);                       \
+        }                                                                                             \
+    }                                                                                                 \
+    while (0)
+#endif
+
 namespace rtt
 {
     /**
@@ -29,6 +79,23 @@ namespace rtt
         Critical
     };
 
+#ifndef RTT_LOG_COMPILED_MIN_LEVEL
+#define RTT_LOG_COMPILED_MIN_LEVEL 0
+#endif
+    /// Lowest log level compiled into the binary (set with the RTT_LOG_MIN_LEVEL CMake option)
+    static constexpr LogLevel COMPILED_MIN_LEVEL{static_cast<LogLevel>(RTT_LOG_COMPILED_MIN_LEVEL)};
+
+    /**
+     * @brief Check at compile time whether a log level is compiled in
+     * @tparam Level Log level to check
+     * @return true if messages of this level can be emitted
+     */
+    template <LogLevel Level>
+    [[nodiscard]] constexpr bool isCompiledIn() noexcept
+    {
+        return Level >= COMPILED_MIN_LEVEL;
+    }
+
 #if __cplusplus >= 202002L
     // C++20 Concept for formattable types (safe for printf-style formatting)
     template <typename T>
@@ -39,6 +106,209 @@ namespace rtt
         std::same_as<std::remove_cvref_t<T>, const void*>;
 #endif
 
+    /**
+     * @brief What to do with log messages that do not fit into one record
+     */
+    enum class TruncationPolicy : uint8_t
+    {
+        Truncate = 0, // Cut the message at the record size
+        TruncateWithMarker, // Cut the message and end it with "..."
+        Drop // Discard the whole message
+    };
+
+#ifndef RTT_LOGGER_MAX_RECORD_SIZE
+#define RTT_LOGGER_MAX_RECORD_SIZE 128
+#endif
+    /// Maximum size of a text log record including level prefix and line ending
+    static constexpr size_t LOG_MAX_RECORD_SIZE{RTT_LOGGER_MAX_RECORD_SIZE};
+    static_assert(LOG_MAX_RECORD_SIZE >= 16, "Log record size too small for level prefix and line ending");
+
+    /**
+     * @brief Argument type tags used in deferred log records
+     */
+    enum class DeferredArgType : uint8_t
+    {
+        Int32 = 0,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        String, // Followed by a length byte and the (unterminated) characters
+        Pointer
+    };
+
+    /**
+     * @brief Header of a deferred log record
+     *
+     * The record is followed by payloadSize bytes of tagged arguments. The format
+     * string is identified by its address in the .rtt_fmt section; the host decoder
+     * looks it up in the ELF file and renders the text.
+     */
+    struct DeferredLogHeader
+    {
+        uint8_t magic[2]; // Magic bytes: 'R', 'L' (RTT Log)
+        LogLevel level; // Log level of the message
+        uint8_t payloadSize; // Argument bytes following the header
+        uint32_t formatId; // Address of the format string
+        uint32_t timestamp; // Timebase ticks (low 32 bits)
+    } __attribute__((packed));
+
+    static constexpr uint8_t DEFERRED_LOG_MAGIC_0 = 'R';
+    static constexpr uint8_t DEFERRED_LOG_MAGIC_1 = 'L';
+
+#ifndef RTT_LOGGER_DEFERRED_MAX_RECORD_SIZE
+#define RTT_LOGGER_DEFERRED_MAX_RECORD_SIZE 64
+#endif
+    static constexpr size_t DEFERRED_LOG_MAX_RECORD_SIZE{RTT_LOGGER_DEFERRED_MAX_RECORD_SIZE};
+    static_assert(DEFERRED_LOG_MAX_RECORD_SIZE > sizeof(DeferredLogHeader) &&
+                      DEFERRED_LOG_MAX_RECORD_SIZE - sizeof(DeferredLogHeader) <= UINT8_MAX,
+                  "Deferred record payload must fit the 8-bit payloadSize field");
+
+    namespace detail
+    {
+        /**
+         * @brief Get the deferred argument tag for a formattable type
+         */
+        template <typename T>
+        constexpr DeferredArgType deferredArgType() noexcept
+        {
+            using U = std::decay_t<T>;
+            if constexpr (std::is_same_v<U, float>)
+            {
+                return DeferredArgType::Float;
+            }
+            else if constexpr (std::is_floating_point_v<U>)
+            {
+                return DeferredArgType::Double;
+            }
+            else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)
+            {
+                return DeferredArgType::String;
+            }
+            else if constexpr (std::is_pointer_v<U>)
+            {
+                return DeferredArgType::Pointer;
+            }
+            else if constexpr (sizeof(U) <= sizeof(uint32_t))
+            {
+                return std::is_signed_v<U> ? DeferredArgType::Int32 : DeferredArgType::UInt32;
+            }
+            else
+            {
+                return std::is_signed_v<U> ? DeferredArgType::Int64 : DeferredArgType::UInt64;
+            }
+        }
+
+        /**
+         * @brief Bounded writer for deferred log records
+         *
+         * Arguments that do not fit are dropped (strings are shortened first), so a
+         * record never exceeds the capacity of the buffer it is built in.
+         */
+        class DeferredRecordWriter
+        {
+        public:
+            constexpr DeferredRecordWriter(uint8_t* buffer, size_t capacity) noexcept :
+                m_buffer(buffer), m_capacity(capacity), m_pos(sizeof(DeferredLogHeader))
+            {
+            }
+
+            template <typename T>
+            void put(const T& argument) noexcept
+            {
+                constexpr DeferredArgType type = deferredArgType<T>();
+                const std::decay_t<T> value = argument;
+                if constexpr (type == DeferredArgType::String)
+                {
+                    putString(value);
+                }
+                else if constexpr (type == DeferredArgType::Pointer)
+                {
+                    putValue(type, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value)));
+                }
+                else if constexpr (type == DeferredArgType::Float)
+                {
+                    putValue(type, value);
+                }
+                else if constexpr (type == DeferredArgType::Double)
+                {
+                    putValue(type, static_cast<double>(value));
+                }
+                else if constexpr (type == DeferredArgType::Int32)
+                {
+                    putValue(type, static_cast<int32_t>(value));
+                }
+                else if constexpr (type == DeferredArgType::UInt32)
+                {
+                    putValue(type, static_cast<uint32_t>(value));
+                }
+                else if constexpr (type == DeferredArgType::Int64)
+                {
+                    putValue(type, static_cast<int64_t>(value));
+                }
+                else
+                {
+                    putValue(type, static_cast<uint64_t>(value));
+                }
+            }
+
+            /**
+             * @brief Write the header and return the total record size
+             */
+            size_t finish(LogLevel level, const char* format, uint32_t timestamp) noexcept
+            {
+                DeferredLogHeader header{};
+                header.magic[0] = DEFERRED_LOG_MAGIC_0;
+                header.magic[1] = DEFERRED_LOG_MAGIC_1;
+                header.level = level;
+                header.payloadSize = static_cast<uint8_t>(m_pos - sizeof(DeferredLogHeader));
+                header.formatId = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(format));
+                header.timestamp = timestamp;
+                std::memcpy(m_buffer, &header, sizeof(header));
+                return m_pos;
+            }
+
+        private:
+            uint8_t* m_buffer;
+            size_t m_capacity;
+            size_t m_pos;
+
+            template <typename V>
+            void putValue(DeferredArgType type, V value) noexcept
+            {
+                if (m_pos + 1 + sizeof(V) > m_capacity)
+                {
+                    return;
+                }
+                m_buffer[m_pos++] = static_cast<uint8_t>(type);
+                std::memcpy(&m_buffer[m_pos], &value, sizeof(V));
+                m_pos += sizeof(V);
+            }
+
+            void putString(const char* str) noexcept
+            {
+                if (m_pos + 2 > m_capacity)
+                {
+                    return;
+                }
+                const size_t room = m_capacity - m_pos - 2;
+                size_t length = 0;
+                while (str != nullptr && length < room && str[length] != '\0')
+                {
+                    ++length;
+                }
+                m_buffer[m_pos++] = static_cast<uint8_t>(DeferredArgType::String);
+                m_buffer[m_pos++] = static_cast<uint8_t>(length);
+                if (length > 0)
+                {
+                    std::memcpy(&m_buffer[m_pos], str, length);
+                    m_pos += length;
+                }
+            }
+        };
+    } // namespace detail
+
     /**
      * @brief Modern C++ wrapper for SEGGER RTT logging
      *
@@ -83,16 +353,70 @@ namespace rtt
          */
         [[nodiscard]] constexpr bool isEnabled(LogLevel level) const noexcept
         {
-            return level >= m_minLevel;
+            return level >= COMPILED_MIN_LEVEL && level >= m_minLevel;
+        }
+
+        /**
+         * @brief Set how messages longer than one record are handled
+         * @param policy New truncation policy
+         */
+        constexpr void setTruncationPolicy(TruncationPolicy policy) noexcept
+        {
+            m_truncationPolicy = policy;
+        }
+
+        /**
+         * @brief Get the current truncation policy
+         * @return Current truncation policy
+         */
+        [[nodiscard]] constexpr TruncationPolicy getTruncationPolicy() const noexcept
+        {
+            return m_truncationPolicy;
         }
 
         /**
          * @brief Log a message with specified level
+         *
+         * The record (prefix, message and line ending) is built on the stack and
+         * committed with a single RTT write, so lines from different tasks do not
+         * interleave.
+         *
          * @param level Log level
          * @param message Message to log
          */
         void log(LogLevel level, std::string_view message) const noexcept;
 
+        /**
+         * @brief Build a text log record "[LEVEL] message\r\n"
+         * @param buffer Destination buffer
+         * @param capacity Size of the destination buffer
+         * @param level Log level
+         * @param message Message text
+         * @param policy Truncation policy for messages that do not fit
+         * @return Record length in bytes, 0 if the message was dropped
+         */
+        [[nodiscard]] static size_t buildRecord(char* buffer, size_t capacity, LogLevel level, std::string_view message,
+                                                TruncationPolicy policy) noexcept;
+
+        /**
+         * @brief Build a text log record from a printf-style format
+         * @param buffer Destination buffer
+         * @param capacity Size of the destination buffer
+         * @param level Log level
+         * @param policy Truncation policy for messages that do not fit
+         * @param format Format string
+         * @param args Format arguments
+         * @return Record length in bytes, 0 if the message was dropped
+         */
+#if __cplusplus >= 202002L
+        template <Formattable... Args>
+#else
+        template <typename... Args>
+#endif
+        [[nodiscard]] static size_t buildFormattedRecord(char* buffer, size_t capacity, LogLevel level,
+                                                         TruncationPolicy policy, const char* format,
+                                                         Args&&... args) noexcept;
+
         /**
          * @brief Log a formatted message with specified level
          * @param level Log level
@@ -107,52 +431,84 @@ namespace rtt
         void logFormatted(LogLevel level, const char* format, Args&&... args) noexcept;
 #endif
 
+        /**
+         * @brief Log a deferred binary record (use RTT_LOG_DEFERRED to place the format in .rtt_fmt)
+         * @param level Log level
+         * @param format Format string; only its address is sent
+         * @param args Format arguments, sent as tagged raw bytes
+         */
+#if __cplusplus >= 202002L
+        template <Formattable... Args>
+        void logDeferred(LogLevel level, const char* format, Args&&... args) const noexcept;
+#else
+        template <typename... Args>
+        void logDeferred(LogLevel level, const char* format, Args&&... args) const noexcept;
+#endif
+
         /**
          * @brief Log trace message
          */
-        void trace(std::string_view message) const noexcept
+        void trace([[maybe_unused]] std::string_view message) const noexcept
         {
-            log(LogLevel::Trace, message);
+            if constexpr (isCompiledIn<LogLevel::Trace>())
+            {
+                log(LogLevel::Trace, message);
+            }
         }
 
         /**
          * @brief Log debug message
          */
-        void debug(std::string_view message) const noexcept
+        void debug([[maybe_unused]] std::string_view message) const noexcept
         {
-            log(LogLevel::Debug, message);
+            if constexpr (isCompiledIn<LogLevel::Debug>())
+            {
+                log(LogLevel::Debug, message);
+            }
         }
 
         /**
          * @brief Log info message
          */
-        void info(std::string_view message) const noexcept
+        void info([[maybe_unused]] std::string_view message) const noexcept
         {
-            log(LogLevel::Info, message);
+            if constexpr (isCompiledIn<LogLevel::Info>())
+            {
+                log(LogLevel::Info, message);
+            }
         }
 
         /**
          * @brief Log warning message
          */
-        void warning(std::string_view message) const noexcept
+        void warning([[maybe_unused]] std::string_view message) const noexcept
         {
-            log(LogLevel::Warning, message);
+            if constexpr (isCompiledIn<LogLevel::Warning>())
+            {
+                log(LogLevel::Warning, message);
+            }
         }
 
         /**
          * @brief Log error message
          */
-        void error(std::string_view message) const noexcept
+        void error([[maybe_unused]] std::string_view message) const noexcept
         {
-            log(LogLevel::Error, message);
+            if constexpr (isCompiledIn<LogLevel::Error>())
+            {
+                log(LogLevel::Error, message);
+            }
         }
 
         /**
          * @brief Log critical message
          */
-        void critical(std::string_view message) const noexcept
+        void critical([[maybe_unused]] std::string_view message) const noexcept
         {
-            log(LogLevel::Critical, message);
+            if constexpr (isCompiledIn<LogLevel::Critical>())
+            {
+                log(LogLevel::Critical, message);
+            }
         }
 
         /**
@@ -165,6 +521,11 @@ namespace rtt
 
         /**
          * @brief Initialize RTT
+         *
+         * Channels claimed from ChannelManager are configured again. Also
+         * starts the shared timebase with its default frequency unless
+         * Timebase::initialize() was called before.
+         *
          * @return true if successful, false otherwise
          */
         static bool initialize() noexcept;
@@ -172,6 +533,32 @@ namespace rtt
     private:
         uint32_t m_channel;
         LogLevel m_minLevel;
+        TruncationPolicy m_truncationPolicy{TruncationPolicy::TruncateWithMarker};
+
+        /**
+         * @brief Write the level prefix and check that the buffer can hold a record
+         * @return Prefix length, 0 if the buffer is too small
+         */
+        [[nodiscard]] static size_t beginRecord(char* buffer, size_t capacity, LogLevel level) noexcept;
+
+        /**
+         * @brief Apply the truncation policy and append the line ending
+         * @param buffer Buffer holding prefix and message
+         * @param length Used bytes (at most capacity - 2)
+         * @param truncated Whether the message was cut to fit
+         * @return Record length in bytes, 0 if the record is dropped
+         */
+        [[nodiscard]] static size_t finishRecord(char* buffer, size_t length, bool truncated,
+                                                 TruncationPolicy policy) noexcept;
+
+        /**
+         * @brief Get timestamp for deferred records
+         * @return Low 32 bits of the shared timebase
+         */
+        [[nodiscard]] static uint32_t getTimestamp() noexcept
+        {
+            return Timebase::now32();
+        }
 
         [[nodiscard]] static constexpr const char* getLevelString(LogLevel level) noexcept
         {
@@ -229,11 +616,93 @@ namespace rtt
             return;
         }
 
-        const char* levelStr = getLevelString(level);
-        SEGGER_RTT_WriteString(m_channel, levelStr);
-        SEGGER_RTT_WriteString(m_channel, " ");
+        char record[LOG_MAX_RECORD_SIZE];
+        const size_t length =
+            buildFormattedRecord(record, sizeof(record), level, m_truncationPolicy, format, std::forward<Args>(args)...);
+        if (length > 0)
+        {
+            SEGGER_RTT_Write(m_channel, record, static_cast<unsigned int>(length));
+        }
+    }
+
+#if __cplusplus >= 202002L
+    template <Formattable... Args>
+#else
+    template <typename... Args>
+#endif
+    size_t Logger::buildFormattedRecord(char* buffer, size_t capacity, LogLevel level, TruncationPolicy policy,
+                                        const char* format, Args&&... args) noexcept
+    {
+        const size_t prefixLength = beginRecord(buffer, capacity, level);
+        if (prefixLength == 0)
+        {
+            return 0;
+        }
+
+        // Leave room for the line ending; snprintf's terminator lands where it goes
+        const size_t room = capacity - 2 - prefixLength;
+        int written = 0;
+        if constexpr (sizeof...(Args) == 0)
+        {
+            written = std::snprintf(&buffer[prefixLength], room + 1, "%s", format);
+        }
+        else
+        {
+            written = std::snprintf(&buffer[prefixLength], room + 1, format, std::forward<Args>(args)...);
+        }
+
+        if (written < 0)
+        {
+            return 0;
+        }
+
+        const bool truncated = static_cast<size_t>(written) > room;
+        return finishRecord(buffer, prefixLength + (truncated ? room : static_cast<size_t>(written)), truncated,
+                            policy);
+    }
+
+#if __cplusplus >= 202002L
+    template <Formattable... Args>
+#else
+    template <typename... Args>
+#endif
+    void Logger::logDeferred(LogLevel level, const char* format, Args&&... args) const noexcept
+    {
+        if (!isEnabled(level))
+        {
+            return;
+        }
+
+        uint8_t record[DEFERRED_LOG_MAX_RECORD_SIZE];
+        detail::DeferredRecordWriter writer(record, sizeof(record));
+        (writer.put(args), ...);
+        const size_t size = writer.finish(level, format, getTimestamp());
 
-        SEGGER_RTT_printf(m_channel, format, std::forward<Args>(args)...);
-        SEGGER_RTT_WriteString(m_channel, "\r\n");
+        // One write per record keeps records intact when tasks preempt each other
+        SEGGER_RTT_Write(m_channel, record, static_cast<unsigned int>(size));
     }
 } // namespace rtt
+
+/**
+ * @brief Log a formatted message; compiles to nothing below RTT_LOG_MIN_LEVEL
+ *
+ * Arguments are still type-checked but neither the call nor the format string
+ * end up in the binary when the level is compiled out.
+ * Usage: RTT_LOG_DEBUG(logger, "State %d -> %d", from, to);
+ */
+#define RTT_LOG_AT_LEVEL(logger, level, ...)                                                         \
+    do                                                                                                \
+    {                                                                                                 \
+        if constexpr (rtt::isCompiledIn<level>())                                                     \
+        {                                                                                             \
+            (logger).logFormatted((level), __VA_ARGS__);                                              \
+        }                                                                                             \
+    }                                                                                                 \
+    while (0)
+
+#define RTT_LOG_TRACE(logger, ...) RTT_LOG_AT_LEVEL(logger, rtt::LogLevel::Trace, __VA_ARGS__)
+#define RTT_LOG_DEBUG(logger, ...) RTT_LOG_AT_LEVEL(logger, rtt::LogLevel::Debug, __VA_ARGS__)
+#define RTT_LOG_INFO(logger, ...) RTT_LOG_AT_LEVEL(logger, rtt::LogLevel::Info, __VA_ARGS__)
+#define RTT_LOG_WARNING(logger, ...) RTT_LOG_AT_LEVEL(logger, rtt::LogLevel::Warning, __VA_ARGS__)
+#define RTT_LOG_ERROR(logger, ...) RTT_LOG_AT_LEVEL(logger, rtt::LogLevel::Error, __VA_ARGS__)
+#define RTT_LOG_CRITICAL(logger, ...) RTT_LOG_AT_LEVEL(logger, rtt::LogLevel::Critical, __VA_ARGS__)
@@ -0,0 +1,211 @@
+#include <rtt_logger/isr_log_queue.hpp>
+#include <cstdio>
+
+namespace rtt
+{
+    namespace
+    {
+        constexpr char CONVERSIONS[] = "diouxXcfFeEgGaAsp";
+
+        [[nodiscard]] bool isOneOf(char c, const char* set) noexcept
+        {
+            return c != '\0' && std::strchr(set, c) != nullptr;
+        }
+
+        [[nodiscard]] float toFloat(uintptr_t word) noexcept
+        {
+            const auto bits = static_cast<uint32_t>(word);
+            float value = 0.0F;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        [[nodiscard]] int32_t toSigned(uintptr_t word, DeferredArgType type) noexcept
+        {
+            return type == DeferredArgType::Float ? static_cast<int32_t>(toFloat(word))
+                                                  : static_cast<int32_t>(static_cast<uint32_t>(word));
+        }
+
+        [[nodiscard]] uint32_t toUnsigned(uintptr_t word, DeferredArgType type) noexcept
+        {
+            return type == DeferredArgType::Float ? static_cast<uint32_t>(toFloat(word)) : static_cast<uint32_t>(word);
+        }
+
+        [[nodiscard]] double toDouble(uintptr_t word, DeferredArgType type) noexcept
+        {
+            switch (type)
+            {
+            case DeferredArgType::Float:
+                return toFloat(word);
+            case DeferredArgType::Int32:
+                return toSigned(word, type);
+            default:
+                return toUnsigned(word, type);
+            }
+        }
+
+        /**
+         * @brief Format one argument with a single-conversion spec such as "%-08.3f"
+         */
+        int formatArgument(char* buffer, size_t capacity, const char* spec, char conversion, uintptr_t word,
+                           DeferredArgType type) noexcept
+        {
+            switch (conversion)
+            {
+            case 'd':
+            case 'i':
+                return std::snprintf(buffer, capacity, spec, toSigned(word, type));
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                return std::snprintf(buffer, capacity, spec, toUnsigned(word, type));
+            case 'c':
+                return std::snprintf(buffer, capacity, spec, static_cast<int>(toUnsigned(word, type)));
+            case 's':
+            {
+                // Only string arguments are dereferenced
+                const char* text = type == DeferredArgType::String ? reinterpret_cast<const char*>(word) : "?";
+                return std::snprintf(buffer, capacity, spec, text != nullptr ? text : "(null)");
+            }
+            case 'p':
+                return std::snprintf(buffer, capacity, spec, reinterpret_cast<const void*>(word));
+            default:
+                return std::snprintf(buffer, capacity, spec, toDouble(word, type));
+            }
+        }
+
+        IsrLogQueue g_isrLogQueue;
+    } // namespace
+
+    size_t IsrLogQueue::format(char* buffer, size_t capacity, const IsrLogRecord& record) noexcept
+    {
+        if (buffer == nullptr || capacity == 0)
+        {
+            return 0;
+        }
+
+        const char* p = record.format != nullptr ? record.format : "";
+        const size_t last = capacity - 1U;
+        size_t length = 0;
+        uint8_t next = 0;
+        while (*p != '\0' && length < last)
+        {
+            if (*p != '%' || p[1] == '%')
+            {
+                buffer[length++] = *p;
+                p += *p == '%' ? 2 : 1;
+                continue;
+            }
+
+            // Copy flags, width and precision into a spec for exactly one argument
+            const char* start = p++;
+            char spec[16];
+            size_t specLength = 0;
+            spec[specLength++] = '%';
+            while ((isOneOf(*p, "-+ #0123456789.")) && specLength < sizeof(spec) - 2U)
+            {
+                spec[specLength++] = *p++;
+            }
+            while (isOneOf(*p, "hlLqjzt"))
+            {
+                ++p;
+            }
+
+            const char conversion = *p;
+            if (!isOneOf(conversion, CONVERSIONS) || next >= record.argCount)
+            {
+                // Unsupported or unmatched conversion: copy it verbatim
+                p += conversion != '\0' ? 1 : 0;
+                for (; start != p && length < last; ++start)
+                {
+                    buffer[length++] = *start;
+                }
+                continue;
+            }
+            ++p;
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+
+            const int written = formatArgument(&buffer[length], capacity - length, spec, conversion,
+                                               record.args[next], record.types[next]);
+            ++next;
+            if (written < 0)
+            {
+                break;
+            }
+            const size_t room = last - length;
+            length += static_cast<size_t>(written) < room ? static_cast<size_t>(written) : room;
+        }
+        buffer[length] = '\0';
+        return length;
+    }
+
+    size_t IsrLogQueue::drain(size_t maxRecords) noexcept
+    {
+        size_t drained = 0;
+        IsrLogRecord record;
+        while (drained < maxRecords && m_ring.tryPop(record))
+        {
+            write(record);
+            ++drained;
+        }
+
+        const uint32_t dropped = m_ring.takeDroppedCount();
+        if (dropped > 0)
+        {
+            m_reported += dropped;
+            logger().logFormatted(LogLevel::Warning, "%u ISR log records dropped", static_cast<unsigned>(dropped));
+        }
+        return drained;
+    }
+
+    void IsrLogQueue::write(const IsrLogRecord& record) noexcept
+    {
+        const Logger& target = logger();
+        if (!record.deferred)
+        {
+            char message[LOG_MAX_RECORD_SIZE];
+            const size_t length = format(message, sizeof(message), record);
+            target.log(record.level, std::string_view(message, length));
+            return;
+        }
+
+        uint8_t buffer[DEFERRED_LOG_MAX_RECORD_SIZE];
+        detail::DeferredRecordWriter writer(buffer, sizeof(buffer));
+        for (uint8_t i = 0; i < record.argCount; ++i)
+        {
+            const uintptr_t word = record.args[i];
+            switch (record.types[i])
+            {
+            case DeferredArgType::Int32:
+                writer.put(static_cast<int32_t>(static_cast<uint32_t>(word)));
+                break;
+            case DeferredArgType::Float:
+                writer.put(toFloat(word));
+                break;
+            case DeferredArgType::String:
+                writer.put(reinterpret_cast<const char*>(word));
+                break;
+            case DeferredArgType::Pointer:
+                writer.put(reinterpret_cast<const void*>(word));
+                break;
+            default:
+                writer.put(static_cast<uint32_t>(word));
+                break;
+            }
+        }
+        const size_t size = writer.finish(record.level, record.format, record.timestamp);
+        (void)target.write(buffer, size);
+    }
+
+    IsrLogQueue& getIsrLogQueue() noexcept
+    {
+        return g_isrLogQueue;
+    }
+} // namespace rtt
+
+extern "C" void rtt_log_isr_drain(void)
+{
+    rtt::getIsrLogQueue().drain();
+}
@@ -1,8 +1,15 @@
 #include <rtt_logger/rtt_logger.hpp>
+#include <rtt_channels/rtt_channels.hpp>
 #include "SEGGER_RTT.h"
 
 namespace rtt
 {
+    namespace
+    {
+        constexpr std::string_view RECORD_END{"\r\n"};
+        constexpr std::string_view TRUNCATION_MARKER{"..."};
+    } // namespace
+
     void Logger::log(LogLevel level, std::string_view message) const noexcept
     {
         if (!isEnabled(level))
@@ -10,15 +17,63 @@ namespace rtt
             return;
         }
 
-        const char* levelStr = getLevelString(level);
+        char record[LOG_MAX_RECORD_SIZE];
+        const size_t length = buildRecord(record, sizeof(record), level, message, m_truncationPolicy);
+        if (length > 0)
+        {
+            SEGGER_RTT_Write(m_channel, record, static_cast<unsigned int>(length));
+        }
+    }
+
+    size_t Logger::buildRecord(char* buffer, size_t capacity, LogLevel level, std::string_view message,
+                               TruncationPolicy policy) noexcept
+    {
+        const size_t prefixLength = beginRecord(buffer, capacity, level);
+        if (prefixLength == 0)
+        {
+            return 0;
+        }
+
+        const size_t room = capacity - RECORD_END.size() - prefixLength;
+        const bool truncated = message.size() > room;
+        const size_t messageLength = truncated ? room : message.size();
+        std::memcpy(&buffer[prefixLength], message.data(), messageLength);
+
+        return finishRecord(buffer, prefixLength + messageLength, truncated, policy);
+    }
+
+    size_t Logger::beginRecord(char* buffer, size_t capacity, LogLevel level) noexcept
+    {
+        const std::string_view levelStr{getLevelString(level)};
+        const size_t prefixLength = levelStr.size() + 1;
+
+        if (buffer == nullptr || capacity < prefixLength + TRUNCATION_MARKER.size() + RECORD_END.size())
+        {
+            return 0;
+        }
+
+        std::memcpy(buffer, levelStr.data(), levelStr.size());
+        buffer[levelStr.size()] = ' ';
+        return prefixLength;
+    }
 
-        // Write level prefix
-        SEGGER_RTT_WriteString(m_channel, levelStr);
-        SEGGER_RTT_WriteString(m_channel, " ");
+    size_t Logger::finishRecord(char* buffer, size_t length, bool truncated, TruncationPolicy policy) noexcept
+    {
+        if (truncated)
+        {
+            if (policy == TruncationPolicy::Drop)
+            {
+                return 0;
+            }
+            if (policy == TruncationPolicy::TruncateWithMarker)
+            {
+                std::memcpy(&buffer[length - TRUNCATION_MARKER.size()], TRUNCATION_MARKER.data(),
+                            TRUNCATION_MARKER.size());
+            }
+        }
 
-        // Write message (ensure null-terminated or use Write with size)
-        SEGGER_RTT_Write(m_channel, message.data(), message.size());
-        SEGGER_RTT_WriteString(m_channel, "\r\n");
+        std::memcpy(&buffer[length], RECORD_END.data(), RECORD_END.size());
+        return length + RECORD_END.size();
     }
 
     size_t Logger::write(const void* data, size_t size) const noexcept
@@ -28,7 +83,11 @@ namespace rtt
 
     bool Logger::initialize() noexcept
     {
-        SEGGER_RTT_Init();
+        ChannelManager::initialize();
+        if (!Timebase::isInitialized())
+        {
+            Timebase::initialize();
+        }
         return true;
     }
 
@@ -1,4 +1,5 @@
 #include <rtt_logger/rtt_logger.hpp>
+#include <rtt_memory_dump/memory_watch.hpp>
 #include <rtt_memory_dump/rtt_memory_dump.hpp>
 #include <cstdint>
 #include <array>
@@ -153,6 +154,43 @@ int main()
     }
 #endif
 
+    // Example 8: Raw dump, rendered on the host
+    {
+        logger.info("");
+        logger.info("Example 8: Raw binary dump via rtt_data (decode with rtt_data_reader.py)");
+        logger.info("-------------------------------------------");
+
+        static std::array<uint8_t, 256> ram_image{};
+        for (size_t i = 0; i < ram_image.size(); ++i)
+        {
+            ram_image[i] = static_cast<uint8_t>(i);
+        }
+
+        rtt::memory_dump::DumpConfig cfg(rtt::memory_dump::DumpFormat::Raw);
+        rtt::memory_dump::MemoryDumper dumper(cfg, logger);
+        dumper.dump(ram_image.data(), ram_image.size(), "RAM image");
+    }
+
+    // Example 9: Watching a structure for changes
+    {
+        logger.info("");
+        logger.info("Example 9: Incremental memory watch (only changed blocks are sent)");
+        logger.info("-------------------------------------------");
+
+        static std::array<uint32_t, 64> control_block{};
+        static std::array<uint8_t, rtt::memory_dump::MemoryWatch::hashBufferSize(sizeof(control_block))> hashes{};
+        rtt::memory_dump::MemoryWatch watch(control_block.data(), sizeof(control_block), hashes.data(), hashes.size());
+
+        // The first poll sends the whole block, later polls only what changed
+        for (uint32_t cycle = 0; cycle < 4; ++cycle)
+        {
+            control_block[cycle * 10] = cycle + 1;
+            const size_t changed = watch.poll();
+            logger.logFormatted(rtt::LogLevel::Info, "Poll %lu: %u of %u blocks sent", static_cast<unsigned long>(cycle),
+                                static_cast<unsigned int>(changed), static_cast<unsigned int>(watch.getBlockCount()));
+        }
+    }
+
     logger.info("");
     logger.info("===========================================");
     logger.info("  Memory Dump Examples Completed");
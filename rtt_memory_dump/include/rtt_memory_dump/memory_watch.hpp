@@ -0,0 +1,130 @@
+#pragma once
+
+#include <rtt_data/rtt_data.hpp>
+#include <cstddef>
+#include <cstdint>
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+namespace rtt::memory_dump
+{
+    /**
+     * @brief Periodic diff-only dump of a memory region
+     *
+     * The watch keeps per-block state in a caller-provided buffer and on each
+     * poll() sends only the blocks that changed since the previous poll, as
+     * rtt_data Memory packets tagged with their target address (adjacent
+     * changed blocks share one packet). The first poll, and the first after
+     * resync(), sends the whole region. The host applies the packets in order
+     * to rebuild the current contents (scripts/rtt_data_reader.py, merge_memory).
+     *
+     * The state buffer selects the mode:
+     * - at least the region size: shadow copy. Changes are detected exactly and
+     *   sent from the copy, so the host always matches what was compared.
+     * - at least hashBufferSize(): one 32-bit hash per block. Much smaller, a
+     *   change goes unnoticed only on a hash collision of the whole block.
+     */
+    class MemoryWatch
+    {
+    public:
+        enum class Mode : uint8_t
+        {
+            Invalid, // No region or the state buffer is too small
+            Shadow, // Exact comparison against a copy of the region
+            Hash // Comparison of per-block hashes
+        };
+
+        /// Default block size in bytes: granularity of change detection
+        static constexpr size_t DEFAULT_BLOCK_SIZE{32};
+
+        /**
+         * @brief Number of blocks of a region
+         */
+        [[nodiscard]] static constexpr size_t blockCount(size_t size, size_t blockSize = DEFAULT_BLOCK_SIZE) noexcept
+        {
+            return blockSize > 0 ? (size + blockSize - 1) / blockSize : 0;
+        }
+
+        /**
+         * @brief State buffer size needed for hash mode
+         */
+        [[nodiscard]] static constexpr size_t hashBufferSize(size_t size,
+                                                             size_t blockSize = DEFAULT_BLOCK_SIZE) noexcept
+        {
+            return blockCount(size, blockSize) * sizeof(uint32_t);
+        }
+
+        /**
+         * @brief Watch a memory region
+         * @param region Start of the watched region
+         * @param size Size of the region in bytes
+         * @param state Buffer for the shadow copy or block hashes (see class description)
+         * @param stateSize Size of the state buffer in bytes
+         * @param blockSize Granularity of change detection in bytes
+         */
+        MemoryWatch(const void* region, size_t size, void* state, size_t stateSize,
+                    size_t blockSize = DEFAULT_BLOCK_SIZE) noexcept;
+
+#if __cplusplus >= 202002L
+        /**
+         * @brief Watch a memory region (C++20 span version)
+         * @param region Watched bytes
+         * @param state Buffer for the shadow copy or block hashes
+         * @param blockSize Granularity of change detection in bytes
+         */
+        MemoryWatch(std::span<const uint8_t> region, std::span<uint8_t> state,
+                    size_t blockSize = DEFAULT_BLOCK_SIZE) noexcept :
+            MemoryWatch(region.data(), region.size(), state.data(), state.size(), blockSize)
+        {
+        }
+#endif
+
+        /**
+         * @brief Send the blocks changed since the last poll
+         *
+         * If a packet does not fit into the RTT buffer the next poll sends the
+         * whole region again, so the host never keeps a stale block.
+         *
+         * @param sender DataSender for the Memory packets
+         * @return Number of changed blocks (all blocks on the first poll)
+         */
+        size_t poll(data::DataSender& sender = data::getDataSender()) noexcept;
+
+        /**
+         * @brief Send the whole region on the next poll (e.g. after the host reconnected)
+         */
+        void resync() noexcept { m_synced = false; }
+
+        [[nodiscard]] Mode getMode() const noexcept { return m_mode; }
+        [[nodiscard]] bool isValid() const noexcept { return m_mode != Mode::Invalid; }
+        [[nodiscard]] const void* getRegion() const noexcept { return m_region; }
+        [[nodiscard]] size_t getSize() const noexcept { return m_size; }
+        [[nodiscard]] size_t getBlockSize() const noexcept { return m_blockSize; }
+        [[nodiscard]] size_t getBlockCount() const noexcept { return m_blockCount; }
+
+    private:
+        /**
+         * @brief Compare one block with its state and update the state
+         * @return True if the block changed (or force is set)
+         */
+        bool updateBlock(size_t block, size_t offset, size_t length, bool force) noexcept;
+
+        /**
+         * @brief Send a run of changed blocks
+         * @return True if all bytes were sent
+         */
+        bool sendRun(data::DataSender& sender, size_t offset, size_t length) const noexcept;
+
+        static uint32_t hashBlock(const uint8_t* data, size_t length) noexcept;
+
+        const uint8_t* m_region;
+        size_t m_size;
+        uint8_t* m_state;
+        size_t m_blockSize;
+        size_t m_blockCount;
+        Mode m_mode{Mode::Invalid};
+        bool m_synced{false};
+    };
+} // namespace rtt::memory_dump
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <rtt_data/rtt_data.hpp>
 #include <rtt_logger/rtt_logger.hpp>
 #include <cstdint>
 #include <string_view>
@@ -18,9 +19,13 @@ namespace rtt::memory_dump
         Hex, // Hexadecimal format (default)
         HexAscii, // Hexadecimal with ASCII representation
         Binary, // Binary format (0s and 1s)
-        Decimal // Decimal format
+        Decimal, // Decimal format
+        Raw // Memory packets via rtt_data, rendered on the host (scripts/rtt_data_reader.py)
     };
 
+    /// Largest number of bytes per formatted line
+    static constexpr size_t DUMP_MAX_BYTES_PER_LINE{64};
+
     /**
      * @brief Configuration for memory dump output
      */
@@ -128,65 +133,80 @@ namespace rtt::memory_dump
          */
         void setBytesPerLine(size_t bytes) noexcept
         {
-            if (bytes > 0 && bytes <= 64)
+            if (bytes > 0 && bytes <= DUMP_MAX_BYTES_PER_LINE)
             {
                 m_config.bytes_per_line = bytes;
             }
         }
 
+        /**
+         * @brief Set the DataSender used by DumpFormat::Raw
+         * @param sender DataSender to stream Memory packets through (default: global DataSender)
+         */
+        void setDataSender(data::DataSender& sender) noexcept
+        {
+            m_sender = &sender;
+        }
+
+        /**
+         * @brief Format one line of a dump without sending it
+         *
+         * Hex, binary and decimal digits come from lookup tables and the line is
+         * written in a single pass, so no printf runs per byte.
+         *
+         * @param data Pointer to the line's bytes
+         * @param size Number of bytes (at most the configured bytes per line)
+         * @param address Base address of the dump
+         * @param offset Offset of the line from the base address
+         * @param buffer Output buffer of at least LINE_BUFFER_SIZE characters
+         * @return Length of the line, excluding the terminating zero
+         */
+        size_t formatLine(const uint8_t* data, size_t size, uintptr_t address, size_t offset,
+                          char* buffer) const noexcept;
+
+        /// Size of a buffer that holds any formatted line (64 binary bytes behind a 64-bit address)
+        static constexpr size_t LINE_BUFFER_SIZE{24 + DUMP_MAX_BYTES_PER_LINE * 9};
+
     private:
         Logger& m_logger;
         DumpConfig m_config;
+        data::DataSender* m_sender{&data::getDataSender()};
 
         /**
-         * @brief Format a single line of memory dump
+         * @brief Stream a region as Memory packets
          * @param data Pointer to data
          * @param size Size of data
-         * @param address Base address
-         * @param offset Offset from base address
          */
-        void formatLine(const uint8_t* data, size_t size,
-                        uintptr_t address, size_t offset) noexcept;
+        void dumpRaw(const uint8_t* data, size_t size) noexcept;
 
         /**
-         * @brief Format bytes as hexadecimal
-         * @param data Pointer to data
-         * @param size Size of data
-         * @param buffer Output buffer
-         * @param buffer_size Size of output buffer
+         * @brief Bytes per line, limited to 1..DUMP_MAX_BYTES_PER_LINE
          */
-        void formatHex(const uint8_t* data, size_t size,
-                       char* buffer, size_t buffer_size) noexcept;
+        [[nodiscard]] size_t bytesPerLine() const noexcept;
 
         /**
-         * @brief Format bytes as ASCII (printable chars or '.')
-         * @param data Pointer to data
-         * @param size Size of data
-         * @param buffer Output buffer
-         * @param buffer_size Size of output buffer
+         * @brief Write bytes as hexadecimal ("XX XX XX")
+         * @return End of the written characters
          */
-        void formatAscii(const uint8_t* data, size_t size,
-                         char* buffer, size_t buffer_size) noexcept;
+        static char* formatHex(const uint8_t* data, size_t size, char* out) noexcept;
 
         /**
-         * @brief Format bytes as binary
-         * @param data Pointer to data
-         * @param size Size of data
-         * @param buffer Output buffer
-         * @param buffer_size Size of output buffer
+         * @brief Write bytes as ASCII (printable chars or '.'), padded to a line width
+         * @return End of the written characters
          */
-        void formatBinary(const uint8_t* data, size_t size,
-                          char* buffer, size_t buffer_size) noexcept;
+        static char* formatAscii(const uint8_t* data, size_t size, size_t width, char* out) noexcept;
 
         /**
-         * @brief Format bytes as decimal
-         * @param data Pointer to data
-         * @param size Size of data
-         * @param buffer Output buffer
-         * @param buffer_size Size of output buffer
+         * @brief Write bytes as binary ("01010101 11110000")
+         * @return End of the written characters
+         */
+        static char* formatBinary(const uint8_t* data, size_t size, char* out) noexcept;
+
+        /**
+         * @brief Write bytes as right-aligned decimal ("  5 255")
+         * @return End of the written characters
          */
-        void formatDecimal(const uint8_t* data, size_t size,
-                           char* buffer, size_t buffer_size) noexcept;
+        static char* formatDecimal(const uint8_t* data, size_t size, char* out) noexcept;
     };
 
     // Template implementation
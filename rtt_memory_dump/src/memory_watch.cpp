@@ -0,0 +1,114 @@
+#include <rtt_memory_dump/memory_watch.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace rtt::memory_dump
+{
+    MemoryWatch::MemoryWatch(const void* region, size_t size, void* state, size_t stateSize,
+                             size_t blockSize) noexcept :
+        m_region(static_cast<const uint8_t*>(region)), m_size(size), m_state(static_cast<uint8_t*>(state)),
+        m_blockSize(blockSize), m_blockCount(blockCount(size, blockSize))
+    {
+        if (region == nullptr || size == 0 || state == nullptr || blockSize == 0)
+        {
+            return;
+        }
+
+        if (stateSize >= size)
+        {
+            m_mode = Mode::Shadow;
+        }
+        else if (stateSize >= hashBufferSize(size, blockSize))
+        {
+            m_mode = Mode::Hash;
+        }
+    }
+
+    size_t MemoryWatch::poll(data::DataSender& sender) noexcept
+    {
+        if (m_mode == Mode::Invalid)
+        {
+            return 0;
+        }
+
+        const bool full = !m_synced;
+        bool complete = true;
+        size_t changed = 0;
+        size_t runOffset = 0;
+        size_t runLength = 0;
+        for (size_t block = 0; block < m_blockCount; ++block)
+        {
+            const size_t offset = block * m_blockSize;
+            const size_t length = std::min(m_blockSize, m_size - offset);
+            if (updateBlock(block, offset, length, full))
+            {
+                // Adjacent changed blocks go out as one run
+                runOffset = runLength == 0 ? offset : runOffset;
+                runLength += length;
+                ++changed;
+            }
+            else if (runLength > 0)
+            {
+                complete = sendRun(sender, runOffset, runLength) && complete;
+                runLength = 0;
+            }
+        }
+        if (runLength > 0)
+        {
+            complete = sendRun(sender, runOffset, runLength) && complete;
+        }
+
+        m_synced = complete;
+        return changed;
+    }
+
+    bool MemoryWatch::updateBlock(size_t block, size_t offset, size_t length, bool force) noexcept
+    {
+        if (m_mode == Mode::Shadow)
+        {
+            if (!force && std::memcmp(&m_region[offset], &m_state[offset], length) == 0)
+            {
+                return false;
+            }
+            std::memcpy(&m_state[offset], &m_region[offset], length);
+            return true;
+        }
+
+        // Hashes are copied bytewise, the state buffer needs no alignment
+        const uint32_t hash = hashBlock(&m_region[offset], length);
+        uint32_t previous = 0;
+        std::memcpy(&previous, &m_state[block * sizeof(uint32_t)], sizeof(previous));
+        if (!force && hash == previous)
+        {
+            return false;
+        }
+        std::memcpy(&m_state[block * sizeof(uint32_t)], &hash, sizeof(hash));
+        return true;
+    }
+
+    bool MemoryWatch::sendRun(data::DataSender& sender, size_t offset, size_t length) const noexcept
+    {
+        // Shadow mode sends the copy that was compared, so a concurrent write is picked up next poll
+        const uint8_t* source = m_mode == Mode::Shadow ? m_state : m_region;
+        const uintptr_t address = reinterpret_cast<uintptr_t>(m_region) + offset;
+        return sender.sendMemory(&source[offset], length, address) == data::memoryPacketBytes(length);
+    }
+
+    uint32_t MemoryWatch::hashBlock(const uint8_t* data, size_t length) noexcept
+    {
+        // FNV-1a over 32-bit words: every step is invertible, so a single changed word always changes the hash
+        uint32_t hash = 2166136261U;
+        size_t i = 0;
+        for (; i + sizeof(uint32_t) <= length; i += sizeof(uint32_t))
+        {
+            uint32_t word = 0;
+            std::memcpy(&word, &data[i], sizeof(word));
+            hash = (hash ^ word) * 16777619U;
+        }
+        for (; i < length; ++i)
+        {
+            hash = (hash ^ data[i]) * 16777619U;
+        }
+        return hash;
+    }
+} // namespace rtt::memory_dump
@@ -1,10 +1,59 @@
 #include <rtt_memory_dump/rtt_memory_dump.hpp>
 #include <SEGGER_RTT.h>
-#include <cstdio>
+#include <array>
+#include <cstring>
 #include <algorithm>
 
 namespace rtt::memory_dump
 {
+    namespace
+    {
+        // Line ending of text log records
+        constexpr std::string_view LINE_END{"\r\n"};
+        // Level prefix ("[INFO] ") and line ending around a formatted line
+        constexpr size_t RECORD_OVERHEAD{16};
+
+        constexpr std::array<char, 16> HEX_DIGITS{'0', '1', '2', '3', '4', '5', '6', '7',
+                                                  '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+        // Bit patterns of all nibbles, so a byte becomes two 4-character copies
+        constexpr auto NIBBLE_BITS = []() {
+            std::array<std::array<char, 4>, 16> table{};
+            for (size_t nibble = 0; nibble < table.size(); ++nibble)
+            {
+                for (size_t bit = 0; bit < 4; ++bit)
+                {
+                    table[nibble][bit] = (nibble & (8U >> bit)) != 0 ? '1' : '0';
+                }
+            }
+            return table;
+        }();
+
+        /**
+         * @brief Write a value as uppercase hexadecimal with at least minDigits digits
+         */
+        char* putHexValue(uintptr_t value, size_t minDigits, char* out) noexcept
+        {
+            size_t digits = minDigits;
+            while (digits < sizeof(value) * 2 && (value >> (digits * 4)) != 0)
+            {
+                ++digits;
+            }
+            for (size_t i = digits; i > 0; --i)
+            {
+                out[i - 1] = HEX_DIGITS[value & 0xFU];
+                value >>= 4;
+            }
+            return out + digits;
+        }
+
+        char* putString(const char* text, size_t length, char* out) noexcept
+        {
+            std::memcpy(out, text, length);
+            return out + length;
+        }
+    } // namespace
+
     void MemoryDumper::dump(const void* data, size_t size, std::string_view description) noexcept
     {
         if (data == nullptr || size == 0)
@@ -30,13 +79,31 @@ namespace rtt::memory_dump
         m_logger.logFormatted(LogLevel::Info, "Address: 0x%08lX, Size: %zu bytes",
                               static_cast<unsigned long>(address), size);
 
-        // Dump memory line by line
-        size_t offset = 0;
-        while (offset < size)
+        if (m_config.format == DumpFormat::Raw)
+        {
+            dumpRaw(bytes, size);
+            m_logger.info("=== End Memory Dump ===");
+            return;
+        }
+
+        // Dump memory line by line. Lines can be longer than LOG_MAX_RECORD_SIZE, so each one is
+        // formatted behind the level prefix and committed with one raw write instead of Logger::log().
+        if (m_logger.isEnabled(LogLevel::Info))
         {
-            const size_t line_size = std::min(m_config.bytes_per_line, size - offset);
-            formatLine(bytes + offset, line_size, address, offset);
-            offset += line_size;
+            char record[RECORD_OVERHEAD + LINE_BUFFER_SIZE];
+            const size_t prefix_length = Logger::buildRecord(record, sizeof(record), LogLevel::Info, "",
+                                                             TruncationPolicy::Truncate) - LINE_END.size();
+            const size_t bytes_per_line = bytesPerLine();
+            size_t offset = 0;
+            while (offset < size)
+            {
+                const size_t line_size = std::min(bytes_per_line, size - offset);
+                char* const line = &record[prefix_length];
+                const size_t length = formatLine(bytes + offset, line_size, address, offset, line);
+                std::memcpy(&line[length], LINE_END.data(), LINE_END.size());
+                (void)m_logger.write(record, prefix_length + length + LINE_END.size());
+                offset += line_size;
+            }
         }
 
         m_logger.info("=== End Memory Dump ===");
@@ -49,164 +116,138 @@ namespace rtt::memory_dump
     }
 #endif
 
-    void MemoryDumper::formatLine(const uint8_t* data, size_t size, uintptr_t address, size_t offset) noexcept
+    void MemoryDumper::dumpRaw(const uint8_t* data, size_t size) noexcept
+    {
+        const size_t sent = m_sender->sendMemory(data, size);
+        const size_t packets = (size + data::DATA_MEMORY_CHUNK_SIZE - 1) / data::DATA_MEMORY_CHUNK_SIZE;
+        const size_t expected = data::memoryPacketBytes(size);
+        if (sent < expected)
+        {
+            m_logger.logFormatted(LogLevel::Warning, "Raw dump incomplete: %zu of %zu bytes sent on channel %lu", sent,
+                                  expected, static_cast<unsigned long>(m_sender->getChannel()));
+            return;
+        }
+        m_logger.logFormatted(LogLevel::Info, "Raw dump: %zu packets on channel %lu", packets,
+                              static_cast<unsigned long>(m_sender->getChannel()));
+    }
+
+    size_t MemoryDumper::bytesPerLine() const noexcept
+    {
+        return std::clamp<size_t>(m_config.bytes_per_line, 1, DUMP_MAX_BYTES_PER_LINE);
+    }
+
+    size_t MemoryDumper::formatLine(const uint8_t* data, size_t size, uintptr_t address, size_t offset,
+                                    char* buffer) const noexcept
     {
-        static constexpr size_t BUFFER_SIZE = 512;
-        char buffer[BUFFER_SIZE];
-        size_t pos = 0;
+        const size_t width = bytesPerLine();
+        size = std::min(size, width);
+        char* out = buffer;
 
         // Format address or offset
         if (m_config.show_address)
         {
-            pos += snprintf(buffer + pos, BUFFER_SIZE - pos,
-                            "0x%08lX: ",
-                            static_cast<unsigned long>(address + offset));
+            out = putString("0x", 2, out);
+            out = putHexValue(address + offset, 8, out);
+            out = putString(": ", 2, out);
         }
         else if (m_config.show_offset)
         {
-            pos += snprintf(buffer + pos, BUFFER_SIZE - pos,
-                            "+0x%04zX: ", offset);
+            out = putString("+0x", 3, out);
+            out = putHexValue(offset, 4, out);
+            out = putString(": ", 2, out);
         }
 
         // Format data based on selected format
         switch (m_config.format)
         {
         case DumpFormat::Hex:
-            formatHex(data, size, buffer + pos, BUFFER_SIZE - pos);
+        case DumpFormat::Raw:
+            out = formatHex(data, size, out);
             break;
 
         case DumpFormat::HexAscii:
             {
-                // Format hex part
-                char hex_buffer[256];
-                formatHex(data, size, hex_buffer, sizeof(hex_buffer));
-
-                // Pad hex part to align ASCII
-                const size_t expected_hex_len = m_config.bytes_per_line * 3;
-                pos += snprintf(buffer + pos, BUFFER_SIZE - pos, "%-*s",
-                                static_cast<int>(expected_hex_len), hex_buffer);
-
-                // Add separator
-                pos += snprintf(buffer + pos, BUFFER_SIZE - pos, " | ");
-
-                // Format ASCII part
-                formatAscii(data, size, buffer + pos, BUFFER_SIZE - pos);
+                // Pad the hex part of short lines to align the ASCII column
+                char* const hex_start = out;
+                out = formatHex(data, size, out);
+                const size_t hex_width = width * 3;
+                while (static_cast<size_t>(out - hex_start) < hex_width)
+                {
+                    *out++ = ' ';
+                }
+                out = putString(" | ", 3, out);
+                out = formatAscii(data, size, width, out);
                 break;
             }
 
         case DumpFormat::Binary:
-            formatBinary(data, size, buffer + pos, BUFFER_SIZE - pos);
+            out = formatBinary(data, size, out);
             break;
 
         case DumpFormat::Decimal:
-            formatDecimal(data, size, buffer + pos, BUFFER_SIZE - pos);
+            out = formatDecimal(data, size, out);
             break;
         }
 
-        // Output the formatted line
-        m_logger.log(LogLevel::Info, buffer);
+        *out = '\0';
+        return static_cast<size_t>(out - buffer);
     }
 
-    void MemoryDumper::formatHex(const uint8_t* data, size_t size, char* buffer, size_t buffer_size) noexcept
+    char* MemoryDumper::formatHex(const uint8_t* data, size_t size, char* out) noexcept
     {
-        size_t pos = 0;
         for (size_t i = 0; i < size; ++i)
         {
-            // Need space for "XX " (3 chars) plus null terminator
-            if (pos + 4 > buffer_size)
-            {
-                break;
-            }
-
-            const int written = snprintf(buffer + pos, buffer_size - pos, "%02X ", data[i]);
-            if (written > 0)
-            {
-                pos += written;
-            }
-        }
-        // Remove trailing space and ensure null termination
-        if (pos > 0 && pos < buffer_size && buffer[pos - 1] == ' ')
-        {
-            buffer[pos - 1] = '\0';
-        }
-        else if (pos < buffer_size)
-        {
-            buffer[pos] = '\0';
+            out[0] = HEX_DIGITS[data[i] >> 4];
+            out[1] = HEX_DIGITS[data[i] & 0xFU];
+            out[2] = ' ';
+            out += 3;
         }
+        // No trailing space
+        return size > 0 ? out - 1 : out;
     }
 
-    void MemoryDumper::formatAscii(const uint8_t* data, size_t size, char* buffer, size_t buffer_size) noexcept
+    char* MemoryDumper::formatAscii(const uint8_t* data, size_t size, size_t width, char* out) noexcept
     {
-        size_t pos = 0;
-        for (size_t i = 0; i < size && pos < buffer_size - 1; ++i)
+        for (size_t i = 0; i < size; ++i)
         {
-            const char c = static_cast<char>(data[i]);
             // Print printable ASCII characters, otherwise print '.'
-            buffer[pos++] = (c >= 32 && c <= 126) ? c : '.';
+            out[i] = (data[i] >= 32 && data[i] <= 126) ? static_cast<char>(data[i]) : '.';
         }
 
         // Pad remaining bytes if line is not full
-        while (pos < m_config.bytes_per_line && pos < buffer_size - 1)
+        for (size_t i = size; i < width; ++i)
         {
-            buffer[pos++] = ' ';
+            out[i] = ' ';
         }
-
-        buffer[pos] = '\0';
+        return out + std::max(size, width);
     }
 
-    void MemoryDumper::formatBinary(const uint8_t* data, size_t size, char* buffer, size_t buffer_size) noexcept
+    char* MemoryDumper::formatBinary(const uint8_t* data, size_t size, char* out) noexcept
     {
-        size_t pos = 0;
         for (size_t i = 0; i < size; ++i)
         {
-            // Need space for 8 bits + 1 space + null terminator
-            if (pos + 10 > buffer_size)
-            {
-                break;
-            }
-
-            for (int bit = 7; bit >= 0; --bit)
-            {
-                buffer[pos++] = (data[i] & (1 << bit)) ? '1' : '0';
-            }
-            buffer[pos++] = ' ';
-        }
-        // Remove trailing space and ensure null termination
-        if (pos > 0 && pos < buffer_size && buffer[pos - 1] == ' ')
-        {
-            buffer[pos - 1] = '\0';
-        }
-        else if (pos < buffer_size)
-        {
-            buffer[pos] = '\0';
+            std::memcpy(out, NIBBLE_BITS[data[i] >> 4].data(), 4);
+            std::memcpy(out + 4, NIBBLE_BITS[data[i] & 0xFU].data(), 4);
+            out[8] = ' ';
+            out += 9;
         }
+        // No trailing space
+        return size > 0 ? out - 1 : out;
     }
 
-    void MemoryDumper::formatDecimal(const uint8_t* data, size_t size, char* buffer, size_t buffer_size) noexcept
+    char* MemoryDumper::formatDecimal(const uint8_t* data, size_t size, char* out) noexcept
     {
-        size_t pos = 0;
         for (size_t i = 0; i < size; ++i)
         {
-            // Need space for "NNN " (4 chars) plus null terminator
-            if (pos + 5 > buffer_size)
-            {
-                break;
-            }
-
-            const int written = snprintf(buffer + pos, buffer_size - pos, "%3u ", data[i]);
-            if (written > 0)
-            {
-                pos += written;
-            }
-        }
-        // Remove trailing space and ensure null termination
-        if (pos > 0 && pos < buffer_size && buffer[pos - 1] == ' ')
-        {
-            buffer[pos - 1] = '\0';
-        }
-        else if (pos < buffer_size)
-        {
-            buffer[pos] = '\0';
+            // Right-aligned in three columns, like "%3u"
+            const unsigned value = data[i];
+            out[0] = value >= 100 ? static_cast<char>('0' + value / 100) : ' ';
+            out[1] = value >= 10 ? static_cast<char>('0' + (value / 10) % 10) : ' ';
+            out[2] = static_cast<char>('0' + value % 10);
+            out[3] = ' ';
+            out += 4;
         }
+        // No trailing space
+        return size > 0 ? out - 1 : out;
     }
 } // namespace rtt::memory_dump
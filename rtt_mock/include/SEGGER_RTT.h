@@ -0,0 +1,98 @@
+#pragma once
+
+/**
+ * @file SEGGER_RTT.h
+ * @brief SEGGER RTT API implemented by the host mock (rtt_mock)
+ *
+ * Source compatible with SEGGER's header for everything this repository
+ * uses: the control block has the same layout, so code and tests that look
+ * at _SEGGER_RTT directly work unchanged. The host side (the probe) is
+ * driven through rtt_mock/rtt_mock.hpp.
+ */
+
+#include <stdarg.h>
+#include "SEGGER_RTT_Conf.h"
+
+#define SEGGER_RTT_MODE_NO_BLOCK_SKIP 0u // Drop a write that does not fit completely
+#define SEGGER_RTT_MODE_NO_BLOCK_TRIM 1u // Write as much as fits
+#define SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL 2u // Wait until the host has read enough
+#define SEGGER_RTT_MODE_MASK 3u
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Target -> host ring buffer
+ */
+typedef struct
+{
+    const char* sName;
+    char* pBuffer;
+    unsigned SizeOfBuffer;
+    unsigned WrOff; // Written by the target
+    volatile unsigned RdOff; // Written by the host
+    unsigned Flags;
+} SEGGER_RTT_BUFFER_UP;
+
+/**
+ * @brief Host -> target ring buffer
+ */
+typedef struct
+{
+    const char* sName;
+    char* pBuffer;
+    unsigned SizeOfBuffer;
+    volatile unsigned WrOff; // Written by the host
+    unsigned RdOff; // Written by the target
+    unsigned Flags;
+} SEGGER_RTT_BUFFER_DOWN;
+
+/**
+ * @brief RTT control block
+ */
+typedef struct
+{
+    char acID[16];
+    int MaxNumUpBuffers;
+    int MaxNumDownBuffers;
+    SEGGER_RTT_BUFFER_UP aUp[SEGGER_RTT_MAX_NUM_UP_BUFFERS];
+    SEGGER_RTT_BUFFER_DOWN aDown[SEGGER_RTT_MAX_NUM_DOWN_BUFFERS];
+} SEGGER_RTT_CB;
+
+extern SEGGER_RTT_CB _SEGGER_RTT;
+
+/**
+ * @brief Reset the control block; channel 0 gets the built-in terminal buffers
+ */
+void SEGGER_RTT_Init(void);
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char* sName, void* pBuffer, unsigned BufferSize,
+                              unsigned Flags);
+int SEGGER_RTT_ConfigDownBuffer(unsigned BufferIndex, const char* sName, void* pBuffer, unsigned BufferSize,
+                                unsigned Flags);
+int SEGGER_RTT_SetFlagsUpBuffer(unsigned BufferIndex, unsigned Flags);
+int SEGGER_RTT_SetFlagsDownBuffer(unsigned BufferIndex, unsigned Flags);
+
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void* pBuffer, unsigned NumBytes);
+unsigned SEGGER_RTT_WriteNoLock(unsigned BufferIndex, const void* pBuffer, unsigned NumBytes);
+unsigned SEGGER_RTT_WriteSkipNoLock(unsigned BufferIndex, const void* pBuffer, unsigned NumBytes);
+unsigned SEGGER_RTT_WriteString(unsigned BufferIndex, const char* s);
+unsigned SEGGER_RTT_PutChar(unsigned BufferIndex, char c);
+int SEGGER_RTT_printf(unsigned BufferIndex, const char* sFormat, ...);
+int SEGGER_RTT_vprintf(unsigned BufferIndex, const char* sFormat, va_list* pParamList);
+
+unsigned SEGGER_RTT_Read(unsigned BufferIndex, void* pBuffer, unsigned BufferSize);
+unsigned SEGGER_RTT_ReadNoLock(unsigned BufferIndex, void* pData, unsigned BufferSize);
+int SEGGER_RTT_HasKey(void);
+int SEGGER_RTT_GetKey(void);
+int SEGGER_RTT_WaitKey(void);
+
+unsigned SEGGER_RTT_HasData(unsigned BufferIndex);
+unsigned SEGGER_RTT_HasDataUp(unsigned BufferIndex);
+unsigned SEGGER_RTT_GetAvailWriteSpace(unsigned BufferIndex);
+unsigned SEGGER_RTT_GetBytesInBuffer(unsigned BufferIndex);
+
+#ifdef __cplusplus
+}
+#endif
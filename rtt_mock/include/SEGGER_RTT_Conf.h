@@ -0,0 +1,48 @@
+#pragma once
+
+/**
+ * @file SEGGER_RTT_Conf.h
+ * @brief Configuration of the host RTT mock (same names and defaults as SEGGER's)
+ */
+
+#ifndef SEGGER_RTT_MAX_NUM_UP_BUFFERS
+#define SEGGER_RTT_MAX_NUM_UP_BUFFERS 3
+#endif
+
+#ifndef SEGGER_RTT_MAX_NUM_DOWN_BUFFERS
+#define SEGGER_RTT_MAX_NUM_DOWN_BUFFERS 3
+#endif
+
+#ifndef BUFFER_SIZE_UP
+#define BUFFER_SIZE_UP 1024 // Size of the terminal up-buffer (channel 0)
+#endif
+
+#ifndef BUFFER_SIZE_DOWN
+#define BUFFER_SIZE_DOWN 16 // Size of the terminal down-buffer (channel 0)
+#endif
+
+#ifndef SEGGER_RTT_PRINTF_BUFFER_SIZE
+#define SEGGER_RTT_PRINTF_BUFFER_SIZE 256 // Longest SEGGER_RTT_printf() output
+#endif
+
+#ifndef SEGGER_RTT_MODE_DEFAULT
+#define SEGGER_RTT_MODE_DEFAULT SEGGER_RTT_MODE_NO_BLOCK_SKIP
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Take and release the mock's lock, which every API function holds (recursive)
+ */
+void rtt_mock_lock(void);
+void rtt_mock_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Same contract as SEGGER's: a sequence of *NoLock calls between them reaches the buffer as one block
+#define SEGGER_RTT_LOCK() rtt_mock_lock()
+#define SEGGER_RTT_UNLOCK() rtt_mock_unlock()
@@ -0,0 +1,111 @@
+#pragma once
+
+/**
+ * @file rtt_mock.hpp
+ * @brief Host side of the in-memory RTT mock
+ *
+ * In host builds (RTT_MOCK_RTT) the SEGGER_RTT target is this mock: the
+ * firmware-facing SEGGER_RTT_* functions operate on the same control block
+ * and ring buffers as on a target, with the same skip, trim and block
+ * semantics, and RttMock plays the debug probe that reads them.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "SEGGER_RTT.h"
+
+namespace rtt::mock
+{
+    /**
+     * @brief Byte counters of one up-buffer since the last reset()
+     */
+    struct ChannelStats
+    {
+        uint64_t written; // Bytes that went into the ring
+        uint64_t dropped; // Bytes refused in skip and trim mode
+        uint64_t blockedWrites; // Writes that had to wait for the host in block mode
+        uint64_t discarded; // Unread bytes the host threw away to unblock a write (nothing captured)
+    };
+
+    /**
+     * @brief Simulated debug probe for the mock up- and down-buffers
+     *
+     * Without a capture the host reads nothing: up-buffers fill and skip or
+     * trim like on a target without a probe attached. A blocking write would
+     * wait forever on the host, so the mock makes room by discarding the
+     * unread bytes instead (counted in ChannelStats::discarded).
+     *
+     * With a capture the host reads every write as soon as it is made, as a
+     * probe polling fast enough would, and appends it to the channel's
+     * capture. All functions are thread-safe; listeners run under the mock's
+     * lock and must not call into RTT.
+     */
+    class RttMock
+    {
+    public:
+        /**
+         * @brief Called with every write that reaches a captured channel
+         */
+        using Listener = void (*)(void* context, unsigned channel, const char* data, size_t size);
+
+        /**
+         * @brief Reinitialize the control block and forget captures, listeners and statistics
+         */
+        static void reset() noexcept;
+
+        /**
+         * @brief Read the channel continuously into its capture
+         *
+         * Bytes already in the up-buffer are captured right away.
+         */
+        static void startCapture(unsigned channel) noexcept;
+
+        /**
+         * @brief Stop reading the channel (the capture is kept)
+         */
+        static void stopCapture(unsigned channel) noexcept;
+
+        [[nodiscard]] static bool isCapturing(unsigned channel) noexcept;
+
+        /**
+         * @brief Bytes captured from the channel so far
+         * @return View into the capture, valid until the next write to or reset of the channel
+         */
+        [[nodiscard]] static std::string_view captured(unsigned channel) noexcept;
+
+        /**
+         * @brief Discard the capture of one channel
+         */
+        static void clearCaptured(unsigned channel) noexcept;
+
+        /**
+         * @brief Unread bytes in the up-buffer, without copying them
+         *
+         * Only the part up to the end of the ring: after consume() a second
+         * call returns the part that wrapped around.
+         */
+        [[nodiscard]] static std::string_view pending(unsigned channel) noexcept;
+
+        /**
+         * @brief Mark bytes of the up-buffer as read by the host
+         * @param bytes Bytes to consume, at most the bytes in the buffer
+         */
+        static void consume(unsigned channel, size_t bytes) noexcept;
+
+        /**
+         * @brief Send bytes to the target through a down-buffer
+         * @return Bytes the down-buffer accepted
+         */
+        static size_t sendToTarget(unsigned channel, std::string_view data) noexcept;
+
+        /**
+         * @brief Set the listener of a channel, called for every captured write
+         * @param listener Listener, nullptr to remove it
+         * @param context Passed to the listener
+         */
+        static void setListener(unsigned channel, Listener listener, void* context) noexcept;
+
+        [[nodiscard]] static ChannelStats getStats(unsigned channel) noexcept;
+    };
+} // namespace rtt::mock
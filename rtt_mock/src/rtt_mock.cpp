@@ -0,0 +1,529 @@
+#include "rtt_mock/rtt_mock.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+SEGGER_RTT_CB _SEGGER_RTT;
+
+namespace rtt::mock
+{
+    namespace
+    {
+        /**
+         * @brief Host-side state of one up-buffer
+         */
+        struct HostChannel
+        {
+            std::string capture;
+            bool capturing;
+            RttMock::Listener listener;
+            void* context;
+            ChannelStats stats;
+        };
+
+        std::recursive_mutex s_mutex;
+        std::array<HostChannel, SEGGER_RTT_MAX_NUM_UP_BUFFERS> s_channels{};
+        char s_terminalUp[BUFFER_SIZE_UP];
+        char s_terminalDown[BUFFER_SIZE_DOWN];
+
+        void doInit() noexcept
+        {
+            std::memset(&_SEGGER_RTT, 0, sizeof(_SEGGER_RTT));
+            _SEGGER_RTT.MaxNumUpBuffers = SEGGER_RTT_MAX_NUM_UP_BUFFERS;
+            _SEGGER_RTT.MaxNumDownBuffers = SEGGER_RTT_MAX_NUM_DOWN_BUFFERS;
+
+            _SEGGER_RTT.aUp[0].sName = "Terminal";
+            _SEGGER_RTT.aUp[0].pBuffer = s_terminalUp;
+            _SEGGER_RTT.aUp[0].SizeOfBuffer = sizeof(s_terminalUp);
+            _SEGGER_RTT.aUp[0].Flags = SEGGER_RTT_MODE_DEFAULT;
+
+            _SEGGER_RTT.aDown[0].sName = "Terminal";
+            _SEGGER_RTT.aDown[0].pBuffer = s_terminalDown;
+            _SEGGER_RTT.aDown[0].SizeOfBuffer = sizeof(s_terminalDown);
+            _SEGGER_RTT.aDown[0].Flags = SEGGER_RTT_MODE_DEFAULT;
+
+            std::memcpy(_SEGGER_RTT.acID, "SEGGER RTT", sizeof("SEGGER RTT"));
+        }
+
+        // Like SEGGER, every API function initializes the control block on first use
+        void ensureInit() noexcept
+        {
+            if (_SEGGER_RTT.acID[0] == '\0')
+            {
+                doInit();
+            }
+        }
+
+        [[nodiscard]] bool isUsable(const SEGGER_RTT_BUFFER_UP& up) noexcept
+        {
+            return up.pBuffer != nullptr && up.SizeOfBuffer > 1;
+        }
+
+        [[nodiscard]] unsigned availWriteSpace(unsigned size, unsigned readOffset, unsigned writeOffset) noexcept
+        {
+            return readOffset <= writeOffset ? size - 1U - writeOffset + readOffset : readOffset - writeOffset - 1U;
+        }
+
+        [[nodiscard]] unsigned bytesInBuffer(unsigned size, unsigned readOffset, unsigned writeOffset) noexcept
+        {
+            return writeOffset >= readOffset ? writeOffset - readOffset : size - readOffset + writeOffset;
+        }
+
+        // Append to the ring, wrapping at the end; the caller made sure it fits
+        void putBytes(SEGGER_RTT_BUFFER_UP& up, const char* data, unsigned size) noexcept
+        {
+            const unsigned first = std::min(size, up.SizeOfBuffer - up.WrOff);
+            std::memcpy(up.pBuffer + up.WrOff, data, first);
+            std::memcpy(up.pBuffer, data + first, size - first);
+            const unsigned offset = up.WrOff + size;
+            up.WrOff = offset >= up.SizeOfBuffer ? offset - up.SizeOfBuffer : offset;
+        }
+
+        // Probe side: read everything unread into the capture, or throw it away
+        void hostRead(unsigned channel) noexcept
+        {
+            SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[channel];
+            HostChannel& host = s_channels[channel];
+            unsigned readOffset = up.RdOff;
+            const unsigned writeOffset = up.WrOff;
+            if (!host.capturing)
+            {
+                host.stats.discarded += bytesInBuffer(up.SizeOfBuffer, readOffset, writeOffset);
+                up.RdOff = writeOffset;
+                return;
+            }
+
+            while (readOffset != writeOffset)
+            {
+                const unsigned end = writeOffset > readOffset ? writeOffset : up.SizeOfBuffer;
+                const char* data = up.pBuffer + readOffset;
+                const size_t size = end - readOffset;
+                host.capture.append(data, size);
+                if (host.listener != nullptr)
+                {
+                    host.listener(host.context, channel, data, size);
+                }
+                readOffset = end == up.SizeOfBuffer ? 0U : end;
+            }
+            up.RdOff = readOffset;
+        }
+
+        unsigned write(unsigned channel, const void* buffer, unsigned size, unsigned mode) noexcept
+        {
+            ensureInit();
+            if (channel >= SEGGER_RTT_MAX_NUM_UP_BUFFERS || !isUsable(_SEGGER_RTT.aUp[channel]))
+            {
+                return 0;
+            }
+
+            SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[channel];
+            HostChannel& host = s_channels[channel];
+            const char* data = static_cast<const char*>(buffer);
+            unsigned written = 0;
+            const unsigned avail = availWriteSpace(up.SizeOfBuffer, up.RdOff, up.WrOff);
+            switch (mode)
+            {
+                case SEGGER_RTT_MODE_NO_BLOCK_SKIP:
+                    if (avail >= size)
+                    {
+                        putBytes(up, data, size);
+                        written = size;
+                    }
+                    break;
+                case SEGGER_RTT_MODE_NO_BLOCK_TRIM:
+                    written = std::min(avail, size);
+                    putBytes(up, data, written);
+                    break;
+                default:
+                    // Block: whatever does not fit waits for the host to read
+                    for (bool blocked = false;; blocked = true)
+                    {
+                        const unsigned chunk =
+                            std::min(availWriteSpace(up.SizeOfBuffer, up.RdOff, up.WrOff), size - written);
+                        putBytes(up, data + written, chunk);
+                        written += chunk;
+                        if (written == size)
+                        {
+                            break;
+                        }
+                        if (!blocked)
+                        {
+                            ++host.stats.blockedWrites;
+                        }
+                        hostRead(channel);
+                    }
+                    break;
+            }
+
+            host.stats.written += written;
+            host.stats.dropped += size - written;
+            if (host.capturing)
+            {
+                hostRead(channel);
+            }
+            return written;
+        }
+    } // namespace
+
+    void RttMock::reset() noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        s_channels = {};
+        doInit();
+    }
+
+    void RttMock::startCapture(unsigned channel) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        ensureInit();
+        if (channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+        {
+            s_channels[channel].capturing = true;
+            if (isUsable(_SEGGER_RTT.aUp[channel]))
+            {
+                hostRead(channel);
+            }
+        }
+    }
+
+    void RttMock::stopCapture(unsigned channel) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        if (channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+        {
+            s_channels[channel].capturing = false;
+        }
+    }
+
+    bool RttMock::isCapturing(unsigned channel) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        return channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS && s_channels[channel].capturing;
+    }
+
+    std::string_view RttMock::captured(unsigned channel) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        return channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS ? std::string_view(s_channels[channel].capture)
+                                                       : std::string_view();
+    }
+
+    void RttMock::clearCaptured(unsigned channel) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        if (channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+        {
+            s_channels[channel].capture.clear();
+        }
+    }
+
+    std::string_view RttMock::pending(unsigned channel) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        ensureInit();
+        if (channel >= SEGGER_RTT_MAX_NUM_UP_BUFFERS || !isUsable(_SEGGER_RTT.aUp[channel]))
+        {
+            return {};
+        }
+        const SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[channel];
+        const unsigned end = up.WrOff >= up.RdOff ? up.WrOff : up.SizeOfBuffer;
+        return {up.pBuffer + up.RdOff, end - up.RdOff};
+    }
+
+    void RttMock::consume(unsigned channel, size_t bytes) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        ensureInit();
+        if (channel >= SEGGER_RTT_MAX_NUM_UP_BUFFERS || !isUsable(_SEGGER_RTT.aUp[channel]))
+        {
+            return;
+        }
+        SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[channel];
+        const unsigned count =
+            std::min(static_cast<unsigned>(bytes), bytesInBuffer(up.SizeOfBuffer, up.RdOff, up.WrOff));
+        const unsigned offset = up.RdOff + count;
+        up.RdOff = offset >= up.SizeOfBuffer ? offset - up.SizeOfBuffer : offset;
+    }
+
+    size_t RttMock::sendToTarget(unsigned channel, std::string_view data) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        ensureInit();
+        if (channel >= SEGGER_RTT_MAX_NUM_DOWN_BUFFERS)
+        {
+            return 0;
+        }
+        SEGGER_RTT_BUFFER_DOWN& down = _SEGGER_RTT.aDown[channel];
+        if (down.pBuffer == nullptr || down.SizeOfBuffer < 2)
+        {
+            return 0;
+        }
+        const unsigned size = std::min(static_cast<unsigned>(data.size()),
+                                       availWriteSpace(down.SizeOfBuffer, down.RdOff, down.WrOff));
+        unsigned writeOffset = down.WrOff;
+        for (unsigned i = 0; i < size; ++i)
+        {
+            down.pBuffer[writeOffset] = data[i];
+            writeOffset = writeOffset + 1U == down.SizeOfBuffer ? 0U : writeOffset + 1U;
+        }
+        down.WrOff = writeOffset;
+        return size;
+    }
+
+    void RttMock::setListener(unsigned channel, Listener listener, void* context) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        if (channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+        {
+            s_channels[channel].listener = listener;
+            s_channels[channel].context = context;
+        }
+    }
+
+    ChannelStats RttMock::getStats(unsigned channel) noexcept
+    {
+        const std::scoped_lock lock(s_mutex);
+        return channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS ? s_channels[channel].stats : ChannelStats{};
+    }
+} // namespace rtt::mock
+
+using rtt::mock::s_mutex;
+
+extern "C"
+{
+    void rtt_mock_lock(void)
+    {
+        s_mutex.lock();
+    }
+
+    void rtt_mock_unlock(void)
+    {
+        s_mutex.unlock();
+    }
+
+    void SEGGER_RTT_Init(void)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::doInit();
+    }
+
+    int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char* sName, void* pBuffer, unsigned BufferSize,
+                                  unsigned Flags)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        if (BufferIndex >= SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+        {
+            return -1;
+        }
+        SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[BufferIndex];
+        // As in SEGGER's implementation channel 0 keeps its terminal buffer, only the flags change
+        if (BufferIndex != 0)
+        {
+            up.sName = sName;
+            up.pBuffer = static_cast<char*>(pBuffer);
+            up.SizeOfBuffer = BufferSize;
+            up.RdOff = 0;
+            up.WrOff = 0;
+        }
+        up.Flags = Flags;
+        return 0;
+    }
+
+    int SEGGER_RTT_ConfigDownBuffer(unsigned BufferIndex, const char* sName, void* pBuffer, unsigned BufferSize,
+                                    unsigned Flags)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        if (BufferIndex >= SEGGER_RTT_MAX_NUM_DOWN_BUFFERS)
+        {
+            return -1;
+        }
+        SEGGER_RTT_BUFFER_DOWN& down = _SEGGER_RTT.aDown[BufferIndex];
+        if (BufferIndex != 0)
+        {
+            down.sName = sName;
+            down.pBuffer = static_cast<char*>(pBuffer);
+            down.SizeOfBuffer = BufferSize;
+            down.RdOff = 0;
+            down.WrOff = 0;
+        }
+        down.Flags = Flags;
+        return 0;
+    }
+
+    int SEGGER_RTT_SetFlagsUpBuffer(unsigned BufferIndex, unsigned Flags)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        if (BufferIndex >= SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+        {
+            return -1;
+        }
+        _SEGGER_RTT.aUp[BufferIndex].Flags = Flags;
+        return 0;
+    }
+
+    int SEGGER_RTT_SetFlagsDownBuffer(unsigned BufferIndex, unsigned Flags)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        if (BufferIndex >= SEGGER_RTT_MAX_NUM_DOWN_BUFFERS)
+        {
+            return -1;
+        }
+        _SEGGER_RTT.aDown[BufferIndex].Flags = Flags;
+        return 0;
+    }
+
+    unsigned SEGGER_RTT_WriteNoLock(unsigned BufferIndex, const void* pBuffer, unsigned NumBytes)
+    {
+        // The mock always locks: host tests write from several threads without SEGGER's interrupt lock
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        const unsigned mode =
+            BufferIndex < SEGGER_RTT_MAX_NUM_UP_BUFFERS ? _SEGGER_RTT.aUp[BufferIndex].Flags & SEGGER_RTT_MODE_MASK : 0U;
+        return rtt::mock::write(BufferIndex, pBuffer, NumBytes, mode);
+    }
+
+    unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void* pBuffer, unsigned NumBytes)
+    {
+        return SEGGER_RTT_WriteNoLock(BufferIndex, pBuffer, NumBytes);
+    }
+
+    unsigned SEGGER_RTT_WriteSkipNoLock(unsigned BufferIndex, const void* pBuffer, unsigned NumBytes)
+    {
+        const std::scoped_lock lock(s_mutex);
+        const unsigned written = rtt::mock::write(BufferIndex, pBuffer, NumBytes, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        return written == NumBytes ? 1U : 0U; // SEGGER returns whether the data was stored
+    }
+
+    unsigned SEGGER_RTT_WriteString(unsigned BufferIndex, const char* s)
+    {
+        return SEGGER_RTT_Write(BufferIndex, s, static_cast<unsigned>(std::strlen(s)));
+    }
+
+    unsigned SEGGER_RTT_PutChar(unsigned BufferIndex, char c)
+    {
+        return SEGGER_RTT_Write(BufferIndex, &c, 1U);
+    }
+
+    int SEGGER_RTT_vprintf(unsigned BufferIndex, const char* sFormat, va_list* pParamList)
+    {
+        char buffer[SEGGER_RTT_PRINTF_BUFFER_SIZE];
+        const int length = std::vsnprintf(buffer, sizeof(buffer), sFormat, *pParamList);
+        if (length < 0)
+        {
+            return -1;
+        }
+        const unsigned size = std::min(static_cast<unsigned>(length), static_cast<unsigned>(sizeof(buffer) - 1U));
+        return static_cast<int>(SEGGER_RTT_Write(BufferIndex, buffer, size));
+    }
+
+    int SEGGER_RTT_printf(unsigned BufferIndex, const char* sFormat, ...)
+    {
+        va_list args;
+        va_start(args, sFormat);
+        const int result = SEGGER_RTT_vprintf(BufferIndex, sFormat, &args);
+        va_end(args);
+        return result;
+    }
+
+    unsigned SEGGER_RTT_ReadNoLock(unsigned BufferIndex, void* pData, unsigned BufferSize)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        if (BufferIndex >= SEGGER_RTT_MAX_NUM_DOWN_BUFFERS)
+        {
+            return 0;
+        }
+        SEGGER_RTT_BUFFER_DOWN& down = _SEGGER_RTT.aDown[BufferIndex];
+        if (down.pBuffer == nullptr || down.SizeOfBuffer == 0)
+        {
+            return 0;
+        }
+        char* data = static_cast<char*>(pData);
+        unsigned count = 0;
+        unsigned readOffset = down.RdOff;
+        const unsigned writeOffset = down.WrOff;
+        while (count < BufferSize && readOffset != writeOffset)
+        {
+            data[count++] = down.pBuffer[readOffset];
+            readOffset = readOffset + 1U == down.SizeOfBuffer ? 0U : readOffset + 1U;
+        }
+        down.RdOff = readOffset;
+        return count;
+    }
+
+    unsigned SEGGER_RTT_Read(unsigned BufferIndex, void* pBuffer, unsigned BufferSize)
+    {
+        return SEGGER_RTT_ReadNoLock(BufferIndex, pBuffer, BufferSize);
+    }
+
+    int SEGGER_RTT_HasKey(void)
+    {
+        return SEGGER_RTT_HasData(0) != 0U ? 1 : 0;
+    }
+
+    int SEGGER_RTT_GetKey(void)
+    {
+        unsigned char c = 0;
+        return SEGGER_RTT_Read(0, &c, 1U) == 1U ? static_cast<int>(c) : -1;
+    }
+
+    int SEGGER_RTT_WaitKey(void)
+    {
+        int c = SEGGER_RTT_GetKey();
+        while (c < 0)
+        {
+            std::this_thread::yield(); // Another thread plays the host and sends the key
+            c = SEGGER_RTT_GetKey();
+        }
+        return c;
+    }
+
+    unsigned SEGGER_RTT_HasData(unsigned BufferIndex)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        if (BufferIndex >= SEGGER_RTT_MAX_NUM_DOWN_BUFFERS)
+        {
+            return 0;
+        }
+        const SEGGER_RTT_BUFFER_DOWN& down = _SEGGER_RTT.aDown[BufferIndex];
+        return rtt::mock::bytesInBuffer(down.SizeOfBuffer, down.RdOff, down.WrOff);
+    }
+
+    unsigned SEGGER_RTT_HasDataUp(unsigned BufferIndex)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        if (BufferIndex >= SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+        {
+            return 0;
+        }
+        const SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[BufferIndex];
+        return rtt::mock::bytesInBuffer(up.SizeOfBuffer, up.RdOff, up.WrOff);
+    }
+
+    unsigned SEGGER_RTT_GetBytesInBuffer(unsigned BufferIndex)
+    {
+        return SEGGER_RTT_HasDataUp(BufferIndex);
+    }
+
+    unsigned SEGGER_RTT_GetAvailWriteSpace(unsigned BufferIndex)
+    {
+        const std::scoped_lock lock(s_mutex);
+        rtt::mock::ensureInit();
+        if (BufferIndex >= SEGGER_RTT_MAX_NUM_UP_BUFFERS || !rtt::mock::isUsable(_SEGGER_RTT.aUp[BufferIndex]))
+        {
+            return 0;
+        }
+        const SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[BufferIndex];
+        return rtt::mock::availWriteSpace(up.SizeOfBuffer, up.RdOff, up.WrOff);
+    }
+}
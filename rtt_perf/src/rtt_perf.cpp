@@ -0,0 +1,352 @@
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <rtt_benchmark/suite.hpp>
+#include <rtt_channels/rtt_channels.hpp>
+#include <rtt_data/rtt_data.hpp>
+#include <rtt_freertos_trace/rtt_freertos_trace.hpp>
+#include <rtt_logger/rtt_logger.hpp>
+#include <rtt_memory_dump/rtt_memory_dump.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
+#include "SEGGER_RTT.h"
+
+#if RTT_MOCK_RTT
+#include <rtt_mock/rtt_mock.hpp>
+#endif
+
+#ifndef RTT_PERF_CHANNEL
+#define RTT_PERF_CHANNEL 2 // Channel the measured code writes to
+#endif
+
+#ifndef RTT_PERF_RESULT_CHANNEL
+#define RTT_PERF_RESULT_CHANNEL 1 // BenchmarkResult records (scripts/rtt_benchmark_compare.py)
+#endif
+
+#ifndef RTT_PERF_BUFFER_SIZE
+#define RTT_PERF_BUFFER_SIZE 1024 // Up-buffer of the measured channel
+#endif
+
+#ifndef RTT_PERF_RESULT_BUFFER_SIZE
+#define RTT_PERF_RESULT_BUFFER_SIZE 512
+#endif
+
+#ifndef RTT_PERF_ITERATIONS
+#define RTT_PERF_ITERATIONS 1000 // Timed calls per case and payload size
+#endif
+
+#ifndef RTT_PERF_WARMUP
+#define RTT_PERF_WARMUP 16
+#endif
+
+// 1: a probe reads the measured channel, so blocking cases wait for it and show the sustained link rate.
+// 0: nobody reads; each call first discards what the previous calls left in the buffer.
+#ifndef RTT_PERF_HOST_READS
+#define RTT_PERF_HOST_READS 0
+#endif
+
+// Blocking writes need a reader; the host mock stands in for one by discarding
+#define RTT_PERF_BLOCK_CASES (RTT_PERF_HOST_READS || RTT_MOCK_RTT)
+
+// Every case writes at most one call's worth of data at once, see the payload sizes below
+static_assert(RTT_PERF_BUFFER_SIZE >= 1024, "RTT_PERF_BUFFER_SIZE must be at least 1024 bytes");
+
+namespace
+{
+    using rtt::benchmark::BenchmarkDefinition;
+
+    constexpr unsigned PERF_CHANNEL{RTT_PERF_CHANNEL};
+    constexpr unsigned PERF_BUFFER_SIZE{RTT_PERF_BUFFER_SIZE};
+    constexpr size_t CALIBRATION_CALLS{64}; // Calls averaged for the bytes per call
+
+    /**
+     * @brief Where a case sends its data and what its mode means
+     */
+    enum class Sink : uint8_t
+    {
+        Channel, // Writes to the measured channel; mode is a rtt::ChannelMode
+        Trace // Trace events; mode is a TraceBufferMode
+    };
+
+    /**
+     * @brief One measured call, run for each payload size in one buffer mode
+     */
+    struct PerfCase
+    {
+        BenchmarkDefinition definition;
+        Sink sink;
+        unsigned mode;
+    };
+
+    char s_perfBuffer[PERF_BUFFER_SIZE];
+    char s_resultBuffer[RTT_PERF_RESULT_BUFFER_SIZE];
+    char s_payload[PERF_BUFFER_SIZE];
+
+    rtt::Logger s_logger{PERF_CHANNEL, rtt::LogLevel::Trace};
+    rtt::data::DataSender s_sender{PERF_CHANNEL};
+    rtt::data::DataSender s_resultSender{RTT_PERF_RESULT_CHANNEL};
+    rtt::memory_dump::MemoryDumper s_hexDumper{rtt::memory_dump::DumpConfig(rtt::memory_dump::DumpFormat::Hex),
+                                               s_logger};
+    rtt::memory_dump::MemoryDumper s_rawDumper{rtt::memory_dump::DumpConfig(rtt::memory_dump::DumpFormat::Raw),
+                                               s_logger};
+
+    uint32_t s_counter = 0;
+    uint32_t s_roomNeeded = 0; // Largest write burst of the running case, 0 while calibrating
+
+    /**
+     * @brief Free the measured buffer if the next call might not fit
+     *
+     * Part of every timed call; with RTT_PERF_HOST_READS it compiles to nothing.
+     */
+    inline void makeRoom() noexcept
+    {
+#if !RTT_PERF_HOST_READS
+        SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[PERF_CHANNEL];
+        const unsigned readOffset = up.RdOff;
+        const unsigned writeOffset = up.WrOff;
+        const unsigned avail = readOffset <= writeOffset ? up.SizeOfBuffer - 1U - writeOffset + readOffset
+                                                         : readOffset - writeOffset - 1U;
+        if (avail < s_roomNeeded)
+        {
+            up.RdOff = writeOffset;
+        }
+#endif
+    }
+
+    void logText(uint32_t size)
+    {
+        makeRoom();
+        s_logger.log(rtt::LogLevel::Info, std::string_view(s_payload, size));
+    }
+
+    // Same record length as logText: size - 8 characters of text and eight hex digits
+    void logFormatted(uint32_t size)
+    {
+        makeRoom();
+        s_logger.logFormatted(rtt::LogLevel::Info, "%.*s%08lx", static_cast<int>(size - 8U),
+                              static_cast<const char*>(s_payload),
+                              static_cast<unsigned long>(++s_counter));
+    }
+
+    void sendInt(uint32_t)
+    {
+        makeRoom();
+        (void)s_sender.sendInt(++s_counter);
+    }
+
+    void sendBinary(uint32_t size)
+    {
+        makeRoom();
+        (void)s_sender.sendBinary(s_payload, size);
+    }
+
+    void dumpHex(uint32_t size)
+    {
+        makeRoom();
+        s_hexDumper.dump(s_payload, size);
+    }
+
+    void dumpRaw(uint32_t size)
+    {
+        makeRoom();
+        s_rawDumper.dump(s_payload, size);
+    }
+
+    void traceEvent(uint32_t)
+    {
+        makeRoom();
+        rtt_trace_record_event(TRACE_EVENT_QUEUE_SEND, 0x20001000U, ++s_counter);
+    }
+
+    constexpr unsigned SKIP{static_cast<unsigned>(rtt::ChannelMode::Skip)};
+    constexpr unsigned TRIM{static_cast<unsigned>(rtt::ChannelMode::Trim)};
+    constexpr unsigned BLOCK{static_cast<unsigned>(rtt::ChannelMode::Block)};
+    constexpr size_t ITERATIONS{RTT_PERF_ITERATIONS};
+    constexpr size_t WARMUP{RTT_PERF_WARMUP};
+
+    // Payload sizes: log records stay below RTT_LOGGER_MAX_RECORD_SIZE (128), binary payloads scale with the buffer
+    PerfCase s_cases[] = {
+        {{"log.skip", logText, ITERATIONS, WARMUP, {16, 48, 112}}, Sink::Channel, SKIP},
+        {{"log.trim", logText, ITERATIONS, WARMUP, {16, 48, 112}}, Sink::Channel, TRIM},
+        {{"logFormatted.skip", logFormatted, ITERATIONS, WARMUP, {16, 48, 112}}, Sink::Channel, SKIP},
+        {{"logFormatted.trim", logFormatted, ITERATIONS, WARMUP, {16, 48, 112}}, Sink::Channel, TRIM},
+        {{"sendInt.skip", sendInt, ITERATIONS, WARMUP}, Sink::Channel, SKIP},
+        {{"sendInt.trim", sendInt, ITERATIONS, WARMUP}, Sink::Channel, TRIM},
+        {{"sendBinary.skip", sendBinary, ITERATIONS, WARMUP, {16, 64, PERF_BUFFER_SIZE / 4, PERF_BUFFER_SIZE / 2}},
+         Sink::Channel, SKIP},
+        {{"sendBinary.trim", sendBinary, ITERATIONS, WARMUP, {16, 64, PERF_BUFFER_SIZE / 4, PERF_BUFFER_SIZE / 2}},
+         Sink::Channel, TRIM},
+        {{"dumpHex.skip", dumpHex, ITERATIONS, WARMUP, {16, 64}}, Sink::Channel, SKIP},
+        {{"dumpRaw.skip", dumpRaw, ITERATIONS, WARMUP, {16, 256}}, Sink::Channel, SKIP},
+        {{"trace.skip", traceEvent, ITERATIONS, WARMUP}, Sink::Trace, TRACE_MODE_SKIP},
+        {{"trace.overwrite", traceEvent, ITERATIONS, WARMUP}, Sink::Trace, TRACE_MODE_OVERWRITE},
+        {{"trace.recorder", traceEvent, ITERATIONS, WARMUP}, Sink::Trace, TRACE_MODE_FLIGHT_RECORDER},
+#if RTT_PERF_BLOCK_CASES
+        {{"log.block", logText, ITERATIONS, WARMUP, {16, 48, 112}}, Sink::Channel, BLOCK},
+        {{"logFormatted.block", logFormatted, ITERATIONS, WARMUP, {16, 48, 112}}, Sink::Channel, BLOCK},
+        {{"sendInt.block", sendInt, ITERATIONS, WARMUP}, Sink::Channel, BLOCK},
+        {{"sendBinary.block", sendBinary, ITERATIONS, WARMUP, {16, 64, PERF_BUFFER_SIZE / 4, PERF_BUFFER_SIZE / 2}},
+         Sink::Channel, BLOCK},
+        {{"dumpHex.block", dumpHex, ITERATIONS, WARMUP, {16, 64}}, Sink::Channel, BLOCK},
+        {{"dumpRaw.block", dumpRaw, ITERATIONS, WARMUP, {16, 256}}, Sink::Channel, BLOCK},
+        {{"trace.block", traceEvent, ITERATIONS, WARMUP}, Sink::Trace, TRACE_MODE_BLOCK},
+#endif
+    };
+
+    /**
+     * @brief Bytes the calls of a case send to the measured channel
+     */
+    struct CallBytes
+    {
+        uint32_t total; // Over CALIBRATION_CALLS calls
+        uint32_t largest; // Largest amount one call sent
+    };
+
+    // Run the call untimed into an emptied buffer and count what arrives
+    CallBytes calibrate(const PerfCase& perfCase, uint32_t argument) noexcept
+    {
+        SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[PERF_CHANNEL];
+        CallBytes bytes{};
+        s_roomNeeded = 0;
+        for (size_t i = 0; i <= CALIBRATION_CALLS; ++i)
+        {
+            up.RdOff = up.WrOff;
+            if (i < CALIBRATION_CALLS)
+            {
+                perfCase.definition.getFunction()(argument);
+            }
+            else if (perfCase.sink == Sink::Trace)
+            {
+                rtt::trace::FreeRtosTrace::drain(); // Events still staged after the last call
+            }
+            const uint32_t sent = SEGGER_RTT_GetBytesInBuffer(PERF_CHANNEL);
+            bytes.total += sent;
+            bytes.largest = sent > bytes.largest ? sent : bytes.largest;
+        }
+        up.RdOff = up.WrOff;
+        return bytes;
+    }
+
+    void runCase(rtt::benchmark::Suite& suite, const PerfCase& perfCase, uint32_t argument) noexcept
+    {
+        // Calibration runs in skip mode; every call fits into the empty buffer
+        (void)rtt::ChannelManager::setMode(PERF_CHANNEL, rtt::ChannelMode::Skip);
+        if (perfCase.sink == Sink::Trace)
+        {
+            rtt::trace::FreeRtosTrace::setMode(static_cast<TraceBufferMode>(perfCase.mode));
+            rtt::trace::FreeRtosTrace::start();
+        }
+
+        const CallBytes bytes = calibrate(perfCase, argument);
+        if (perfCase.sink == Sink::Channel)
+        {
+            (void)rtt::ChannelManager::setMode(PERF_CHANNEL, static_cast<rtt::ChannelMode>(perfCase.mode));
+        }
+        s_roomNeeded = bytes.largest;
+        (void)suite.run(perfCase.definition, argument);
+
+        if (perfCase.sink == Sink::Trace)
+        {
+            rtt::trace::FreeRtosTrace::stop();
+        }
+
+        // Sustained rate: bytes per call over the mean time per call
+        const rtt::benchmark::BenchmarkResult& result = suite.getLastResult();
+        const uint64_t bytesPerSecond =
+            result.mean == 0 ? 0 : uint64_t{bytes.total} * result.frequency / (result.mean * CALIBRATION_CALLS);
+        rtt::getLogger().logFormatted(rtt::LogLevel::Info, "%-24s %8lu %8lu %8lu %7lu.%02lu %12lu",
+                                      static_cast<const char*>(result.name), static_cast<unsigned long>(result.p50),
+                                      static_cast<unsigned long>(result.p99), static_cast<unsigned long>(result.mean),
+                                      static_cast<unsigned long>(bytes.total / CALIBRATION_CALLS),
+                                      static_cast<unsigned long>(bytes.total % CALIBRATION_CALLS * 100U /
+                                                                 CALIBRATION_CALLS),
+                                      static_cast<unsigned long>(bytesPerSecond));
+    }
+
+#if RTT_MOCK_RTT
+    void printOutput(void*, unsigned, const char* data, size_t size)
+    {
+        (void)std::fwrite(data, 1, size, stdout);
+    }
+#endif
+} // namespace
+
+/**
+ * RTT throughput and overhead benchmarks
+ *
+ * Measures the time per call of the logger, the data sender, the trace
+ * recorder and the memory dumper for several payload sizes and buffer modes.
+ * Text report on channel 0, BenchmarkResult records on RTT_PERF_RESULT_CHANNEL.
+ * On the host (RTT mock) the report goes to stdout and the records to the
+ * file given as the first argument.
+ */
+int main(int argc, char** argv)
+{
+#if RTT_MOCK_RTT
+    using rtt::mock::RttMock;
+    RttMock::setListener(0, printOutput, nullptr);
+    RttMock::startCapture(0);
+    RttMock::startCapture(RTT_PERF_RESULT_CHANNEL);
+#else
+    (void)argc;
+    (void)argv;
+#endif
+
+    rtt::Logger::initialize();
+    rtt::trace::FreeRtosTrace::initialize(PERF_CHANNEL);
+
+    // Every case writes to the trace's channel: keep its claim, with the measured buffer instead of the trace's
+    if (rtt::ChannelManager::adopt(RTT_TRACE_CHANNEL_NAME, PERF_CHANNEL, s_perfBuffer, sizeof(s_perfBuffer),
+                                   rtt::ChannelMode::Skip) < 0 ||
+        rtt::ChannelManager::adopt("Results", RTT_PERF_RESULT_CHANNEL, s_resultBuffer, sizeof(s_resultBuffer),
+                                   rtt::ChannelMode::Block) < 0)
+    {
+        rtt::getLogger().error("rtt_perf: channels claimed by another stream");
+        return 1;
+    }
+    s_rawDumper.setDataSender(s_sender);
+    for (size_t i = 0; i < sizeof(s_payload); ++i)
+    {
+        s_payload[i] = static_cast<char>('a' + i % 26);
+    }
+
+    auto& logger = rtt::getLogger();
+    logger.logFormatted(rtt::LogLevel::Info, "rtt_perf: %u byte buffer on channel %u, times in ticks of %lu Hz",
+                        PERF_BUFFER_SIZE, PERF_CHANNEL, static_cast<unsigned long>(rtt::Timebase::getFrequency()));
+
+    logger.info("case                          p50      p99     mean bytes/call      bytes/s");
+
+    static rtt::benchmark::Suite suite(s_resultSender, logger);
+    suite.setTextReport(false); // One line per run instead
+    for (const PerfCase& perfCase : s_cases)
+    {
+        const BenchmarkDefinition& definition = perfCase.definition;
+        if (definition.getArgumentCount() == 0)
+        {
+            runCase(suite, perfCase, 0);
+        }
+        for (size_t i = 0; i < definition.getArgumentCount(); ++i)
+        {
+            runCase(suite, perfCase, definition.getArgument(i));
+        }
+    }
+    logger.info("rtt_perf: done");
+
+#if RTT_MOCK_RTT
+    if (argc > 1)
+    {
+        const std::string_view results = RttMock::captured(RTT_PERF_RESULT_CHANNEL);
+        std::FILE* file = std::fopen(argv[1], "wb");
+        if (file == nullptr || std::fwrite(results.data(), 1, results.size(), file) != results.size())
+        {
+            std::fprintf(stderr, "rtt_perf: cannot write %s\n", argv[1]);
+            if (file != nullptr)
+            {
+                (void)std::fclose(file);
+            }
+            return 1;
+        }
+        (void)std::fclose(file);
+    }
+#endif
+    return 0;
+}
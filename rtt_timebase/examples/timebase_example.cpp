@@ -0,0 +1,49 @@
+#include <rtt_logger/rtt_logger.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
+
+/**
+ * Example demonstrating the shared RTT timebase
+ *
+ * This example shows how to start the timebase with the CPU clock, take
+ * 64-bit timestamps and convert tick intervals to nanoseconds.
+ */
+int main()
+{
+    // Start the timebase before any module takes timestamps (CPU clock for DWT CYCCNT)
+    rtt::Timebase::initialize(80'000'000U);
+
+    // Logger::initialize() keeps the existing timebase configuration
+    rtt::Logger::initialize();
+    auto& logger = rtt::getLogger();
+    logger.setMinLevel(rtt::LogLevel::Info);
+
+    logger.info("RTT Timebase Example Started");
+    logger.logFormatted(rtt::LogLevel::Info, "Timebase frequency: %lu Hz",
+                        static_cast<unsigned long>(rtt::Timebase::getFrequency()));
+
+    // Example 1: Measure an interval in ticks and nanoseconds
+    const uint64_t start = rtt::Timebase::now();
+    volatile uint32_t sum = 0;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        sum = sum + i;
+    }
+    const uint64_t ticks = rtt::Timebase::now() - start;
+    logger.logFormatted(rtt::LogLevel::Info, "Loop took %llu ticks (%llu ns)", static_cast<unsigned long long>(ticks),
+                        static_cast<unsigned long long>(rtt::Timebase::toNanoseconds(ticks)));
+
+    // Example 2: Calibrate against a reference interval, e.g. 1 ms of SysTick
+    // (here: pretend 80'160 ticks were counted during exactly 1 ms)
+    if (rtt::Timebase::calibrate(80'160U, 1'000'000U))
+    {
+        logger.logFormatted(rtt::LogLevel::Info, "Calibrated frequency: %lu Hz",
+                            static_cast<unsigned long>(rtt::Timebase::getFrequency()));
+    }
+
+    // Example 3: Deferred log records carry the same timestamps as trace and data packets
+    RTT_LOG_DEFERRED(logger, rtt::LogLevel::Info, "Timestamped on the shared timeline");
+
+    logger.info("RTT Timebase Example Completed");
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#if !defined(RTT_TIMEBASE_COUNTER) && !defined(__ARM_ARCH)
+#include <chrono>
+#endif
+
+#ifndef RTT_TIMEBASE_DEFAULT_FREQUENCY_HZ
+#define RTT_TIMEBASE_DEFAULT_FREQUENCY_HZ 80000000U
+#endif
+
+namespace rtt
+{
+    /**
+     * @brief Shared high-resolution timebase for all RTT streams
+     *
+     * Logger, DataSender, FreeRTOS trace and benchmark timestamps are all taken
+     * from this clock so their streams can be correlated on one timeline.
+     *
+     * Counter sources:
+     * - ARM Cortex-M3/M4/M7: DWT cycle counter (CYCCNT)
+     * - RTT_TIMEBASE_COUNTER defined: the given expression, e.g. a free-running
+     *   32-bit timer register (required on Cortex-M0, which has no DWT)
+     * - Host builds: std::chrono::steady_clock in nanoseconds (initialize()
+     *   sets the frequency to 1 GHz)
+     *
+     * The 32-bit counter is extended to 64 bits without locks or critical
+     * sections, so now() may be called from any task or interrupt. The
+     * extension detects wraparound by comparing the top counter bit with the
+     * last observed one, which requires now() to be called at least once per
+     * half counter period (about 26 s at 80 MHz). Every timestamped RTT write
+     * does this; in quiet systems call update() from a periodic hook, e.g.
+     * FreeRtosHooks::addIdleCallback(&rtt::Timebase::update).
+     */
+    class Timebase
+    {
+    public:
+        /**
+         * @brief Enable the counter and set the tick frequency
+         *
+         * Restarts the timeline at zero. Call once at startup before other RTT
+         * modules take timestamps; Logger::initialize() calls it with the default
+         * frequency if the timebase has not been initialized yet.
+         *
+         * @param frequencyHz Counter frequency in Hz (CPU clock for CYCCNT)
+         * @return True if the counter is running
+         */
+        static bool initialize(uint32_t frequencyHz = RTT_TIMEBASE_DEFAULT_FREQUENCY_HZ) noexcept;
+
+        /**
+         * @brief Check if initialize() has been called
+         */
+        [[nodiscard]] static bool isInitialized() noexcept
+        {
+            return s_initialized.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the current time in ticks (64-bit, monotonic)
+         */
+        [[nodiscard]] static uint64_t now() noexcept
+        {
+#if defined(RTT_TIMEBASE_COUNTER) || defined(__ARM_ARCH)
+            // The upper word must be loaded before the counter is sampled
+            const uint32_t high = s_high.load(std::memory_order_acquire);
+            return extend(high, readCounter());
+#else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count()) -
+                   s_hostEpoch.load(std::memory_order_relaxed);
+#endif
+        }
+
+        /**
+         * @brief Get the low 32 bits of the current time, for 32-bit timestamp fields
+         */
+        [[nodiscard]] static uint32_t now32() noexcept
+        {
+            return static_cast<uint32_t>(now());
+        }
+
+        /**
+         * @brief Read the raw 32-bit counter without the 64-bit extension
+         *
+         * Cheapest possible timestamp for measuring short intervals: the
+         * difference of two samples (modulo 2^32) is exact for intervals below
+         * 2^32 ticks. Does not keep the extension current.
+         */
+        [[nodiscard]] static uint32_t sample() noexcept
+        {
+#if defined(RTT_TIMEBASE_COUNTER) || defined(__ARM_ARCH)
+            return readCounter();
+#else
+            return static_cast<uint32_t>(now());
+#endif
+        }
+
+        /**
+         * @brief Keep the 64-bit extension current (for periodic hooks)
+         */
+        static void update() noexcept
+        {
+            (void)now();
+        }
+
+        /**
+         * @brief Extend a raw 32-bit counter value to 64 bits
+         *
+         * For custom counter sources and tests; now() does this for the
+         * configured counter.
+         *
+         * @param counter Raw counter value sampled after the previous call
+         * @return 64-bit tick count
+         */
+        [[nodiscard]] static uint64_t extend(uint32_t counter) noexcept
+        {
+            return extend(s_high.load(std::memory_order_acquire), counter);
+        }
+
+        /**
+         * @brief Get the tick frequency in Hz
+         */
+        [[nodiscard]] static uint32_t getFrequency() noexcept
+        {
+            return s_frequency.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Set the tick frequency, e.g. after changing the CPU clock
+         * @param frequencyHz Counter frequency in Hz (ignored if 0)
+         */
+        static void setFrequency(uint32_t frequencyHz) noexcept;
+
+        /**
+         * @brief Calibrate the tick frequency against a reference interval
+         *
+         * Measure a known interval (e.g. SysTick or RTC periods) in ticks and pass
+         * both values; the frequency used for conversions is derived from them.
+         *
+         * @param ticks Ticks counted during the interval
+         * @param referenceNanoseconds Length of the interval in nanoseconds
+         * @return True if the resulting frequency was applied
+         */
+        static bool calibrate(uint64_t ticks, uint64_t referenceNanoseconds) noexcept;
+
+        /**
+         * @brief Convert ticks to nanoseconds
+         *
+         * Uses a fixed-point factor prepared by setFrequency(), so no division on
+         * the target.
+         */
+        [[nodiscard]] static uint64_t toNanoseconds(uint64_t ticks) noexcept
+        {
+            const uint32_t multiplier = s_multiplier.load(std::memory_order_relaxed);
+            const uint32_t shift = s_shift.load(std::memory_order_relaxed);
+            const uint64_t high = (ticks >> 32) * multiplier;
+            const uint64_t low = (ticks & 0xFFFFFFFFU) * multiplier;
+            return (high << (32U - shift)) + (low >> shift);
+        }
+
+        /**
+         * @brief Convert ticks to microseconds
+         */
+        [[nodiscard]] static uint64_t toMicroseconds(uint64_t ticks) noexcept
+        {
+            return toNanoseconds(ticks) / 1000U;
+        }
+
+    private:
+        static constexpr uint32_t TOP_BIT{0x80000000U};
+
+        /**
+         * @brief Fixed-point factor for tick to nanosecond conversion
+         */
+        struct Scale
+        {
+            uint32_t multiplier;
+            uint32_t shift;
+        };
+
+        /**
+         * @brief Compute the largest shift keeping 1e9 / frequency * 2^shift below 2^32
+         */
+        [[nodiscard]] static constexpr Scale computeScale(uint32_t frequencyHz) noexcept
+        {
+            constexpr uint64_t NS_PER_SECOND{1000000000U};
+            uint32_t shift = 31;
+            while (shift > 0 && ((NS_PER_SECOND << shift) / frequencyHz) > UINT32_MAX)
+            {
+                --shift;
+            }
+            return Scale{static_cast<uint32_t>((NS_PER_SECOND << shift) / frequencyHz), shift};
+        }
+
+        /**
+         * @brief Combine the upper word with a counter sampled after loading it
+         *
+         * The upper word keeps the wrap count in bits 0-30 and the top counter
+         * bit of the last observation in bit 31. A single 32-bit store updates
+         * it, so concurrent callers at most store the same value twice.
+         */
+        [[nodiscard]] static uint64_t extend(uint32_t high, uint32_t counter) noexcept
+        {
+            if (((high ^ counter) & TOP_BIT) != 0U)
+            {
+                // Top bit changed: half period passed, count a wrap when it went 1 -> 0
+                high = (high ^ TOP_BIT) + (high >> 31);
+                s_high.store(high, std::memory_order_release);
+            }
+            return (static_cast<uint64_t>(high & ~TOP_BIT) << 32) | counter;
+        }
+
+#if defined(RTT_TIMEBASE_COUNTER)
+        [[nodiscard]] static uint32_t readCounter() noexcept
+        {
+            return static_cast<uint32_t>(RTT_TIMEBASE_COUNTER);
+        }
+#elif defined(__ARM_ARCH)
+        [[nodiscard]] static uint32_t readCounter() noexcept
+        {
+            return *reinterpret_cast<volatile uint32_t*>(0xE0001004); // DWT_CYCCNT
+        }
+#else
+        static inline std::atomic<uint64_t> s_hostEpoch{0};
+#endif
+
+        static inline std::atomic<uint32_t> s_high{0};
+        static inline std::atomic<bool> s_initialized{false};
+        static inline std::atomic<uint32_t> s_frequency{RTT_TIMEBASE_DEFAULT_FREQUENCY_HZ};
+        // ns = ticks * multiplier >> shift, multiplier kept below 2^32 (see computeScale)
+        static inline std::atomic<uint32_t> s_multiplier{computeScale(RTT_TIMEBASE_DEFAULT_FREQUENCY_HZ).multiplier};
+        static inline std::atomic<uint32_t> s_shift{computeScale(RTT_TIMEBASE_DEFAULT_FREQUENCY_HZ).shift};
+    };
+} // namespace rtt
@@ -0,0 +1,72 @@
+#include <rtt_timebase/rtt_timebase.hpp>
+
+namespace rtt
+{
+    namespace
+    {
+#if !defined(RTT_TIMEBASE_COUNTER) && defined(__ARM_ARCH)
+        // DWT (Data Watchpoint and Trace) registers for ARM Cortex-M
+        volatile uint32_t* const DWT_CONTROL = reinterpret_cast<volatile uint32_t*>(0xE0001000);
+        volatile uint32_t* const DWT_CYCCNT = reinterpret_cast<volatile uint32_t*>(0xE0001004);
+        volatile uint32_t* const SCB_DEMCR = reinterpret_cast<volatile uint32_t*>(0xE000EDFC);
+        constexpr uint32_t DEMCR_TRCENA{1UL << 24};
+        constexpr uint32_t DWT_CTRL_CYCCNTENA{1UL << 0};
+#endif
+        constexpr uint32_t HOST_FREQUENCY_HZ{1000000000U};
+    } // namespace
+
+    bool Timebase::initialize(uint32_t frequencyHz) noexcept
+    {
+        bool running = true;
+#if defined(RTT_TIMEBASE_COUNTER)
+        // Custom counter: configured by the application
+        setFrequency(frequencyHz);
+#elif defined(__ARM_ARCH)
+        *SCB_DEMCR |= DEMCR_TRCENA; // Enable trace
+        *DWT_CYCCNT = 0; // Reset counter
+        *DWT_CONTROL |= DWT_CTRL_CYCCNTENA; // Enable counter
+        running = (*DWT_CONTROL & DWT_CTRL_CYCCNTENA) != 0U;
+        setFrequency(frequencyHz);
+#else
+        (void)frequencyHz;
+        s_hostEpoch.store(0, std::memory_order_relaxed);
+        s_hostEpoch.store(now(), std::memory_order_relaxed);
+        setFrequency(HOST_FREQUENCY_HZ);
+#endif
+        s_high.store(0, std::memory_order_release);
+        s_initialized.store(true, std::memory_order_release);
+        return running;
+    }
+
+    void Timebase::setFrequency(uint32_t frequencyHz) noexcept
+    {
+        if (frequencyHz == 0)
+        {
+            return;
+        }
+
+        const Scale scale = computeScale(frequencyHz);
+        s_frequency.store(frequencyHz, std::memory_order_relaxed);
+        s_multiplier.store(scale.multiplier, std::memory_order_relaxed);
+        s_shift.store(scale.shift, std::memory_order_relaxed);
+    }
+
+    bool Timebase::calibrate(uint64_t ticks, uint64_t referenceNanoseconds) noexcept
+    {
+        constexpr uint64_t NS_PER_SECOND{1000000000U};
+        if (ticks == 0 || referenceNanoseconds == 0 || ticks > UINT64_MAX / NS_PER_SECOND)
+        {
+            return false;
+        }
+
+        // Round to the nearest Hz
+        const uint64_t frequency = ((ticks * NS_PER_SECOND) + (referenceNanoseconds / 2)) / referenceNanoseconds;
+        if (frequency == 0 || frequency > UINT32_MAX)
+        {
+            return false;
+        }
+
+        setFrequency(static_cast<uint32_t>(frequency));
+        return true;
+    }
+} // namespace rtt
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <rtt_data/rtt_data.hpp>
 #include <rtt_logger/rtt_logger.hpp>
+#include <rtt_timebase/rtt_timebase.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <algorithm>
@@ -14,19 +20,88 @@
 #include <gtest/gtest.h>
 #endif
 
+#ifndef RTT_UNITTEST_NAME_LENGTH
+#define RTT_UNITTEST_NAME_LENGTH 40 // Characters per suite and test name in name records
+#endif
+
+#ifndef RTT_UNITTEST_MESSAGE_LENGTH
+#define RTT_UNITTEST_MESSAGE_LENGTH 96 // Characters of the first failure kept in failure records
+#endif
+
+#ifndef RTT_UNITTEST_RESULT_SCHEMA_ID
+#define RTT_UNITTEST_RESULT_SCHEMA_ID 0xB2
+#endif
+
+namespace rtt::unittest
+{
+    /// Characters per name in a name record, including the terminating zero
+    static constexpr size_t TEST_NAME_LENGTH{RTT_UNITTEST_NAME_LENGTH};
+    /// Characters of the failure message in a failure record, including the terminating zero
+    static constexpr size_t TEST_MESSAGE_LENGTH{RTT_UNITTEST_MESSAGE_LENGTH};
+    /// String packet naming a test once per program: "RTT_TEST <index> <suite> <name>"
+    static constexpr std::string_view TEST_NAME_TAG{"RTT_TEST"};
+    /// String packet with the first failure of a failed test: "RTT_FAIL <index> <file>:<line>: <message>"
+    static constexpr std::string_view TEST_FAILURE_TAG{"RTT_FAIL"};
+
+    /**
+     * @brief Outcome of one test
+     */
+    enum class TestStatus : uint8_t
+    {
+        Passed = 0,
+        Failed = 1, // Includes tests over their cycle budget
+        Skipped = 2
+    };
+
+    /**
+     * @brief Binary result record of one test, sent by RttTestEventListener
+     *
+     * Sent as a schema-registered Struct packet holding numbers only, so a
+     * passing test costs 32 bytes of payload. The names travel once per
+     * program in a TEST_NAME_TAG String packet with the same index, and a
+     * failed test sends its first failure in a TEST_FAILURE_TAG String
+     * packet before its record. scripts/rtt_junit.py turns a captured
+     * channel into JUnit XML. Times are in timebase ticks (CPU cycles with
+     * the DWT counter); frequency converts them to seconds.
+     */
+    struct TestResult
+    {
+        uint64_t cycles; // From OnTestStart to OnTestEnd, including fixture SetUp/TearDown
+        uint64_t budget; // Cycle budget, 0 if none
+        uint32_t frequency; // Timebase frequency in Hz
+        uint32_t failures; // Failed assertions (an exceeded budget counts as one)
+        uint16_t index; // Number of the test in its name record
+        TestStatus status;
+    };
+} // namespace rtt::unittest
+
+RTT_DATA_SCHEMA(rtt::unittest::TestResult, RTT_UNITTEST_RESULT_SCHEMA_ID, RTT_DATA_FIELD(cycles),
+                RTT_DATA_FIELD(budget), RTT_DATA_FIELD(frequency), RTT_DATA_FIELD(failures), RTT_DATA_FIELD(index),
+                RTT_DATA_FIELD(status));
+
 namespace rtt::unittest
 {
     /**
      * @brief RTT output capture for unit testing
      *
      * This class captures RTT output for verification in unit tests.
-     * It provides a mock RTT interface that can be used with GoogleTest.
+     * In host builds the SEGGER_RTT target is the in-memory mock (rtt_mock)
+     * and every line written to the channel while capturing becomes one
+     * message; the "[LEVEL] " prefix of log records is removed, so
+     * logger.info("Ready") is captured as "Ready". Against the real SEGGER
+     * RTT nothing can be read back on the target and the capture stays empty.
      */
     class RttCapture
     {
     public:
-        RttCapture() = default;
-        ~RttCapture() = default;
+        /**
+         * @param channel RTT up-buffer to capture
+         */
+        explicit RttCapture(unsigned channel = 0) noexcept : m_channel(channel)
+        {
+        }
+
+        ~RttCapture();
 
         // Non-copyable, non-movable
         RttCapture(const RttCapture&) = delete;
@@ -36,11 +111,16 @@ namespace rtt::unittest
 
         /**
          * @brief Start capturing RTT output
+         *
+         * Clears the previous capture; output still unread in the up-buffer is
+         * discarded and not captured.
          */
         void startCapture();
 
         /**
          * @brief Stop capturing RTT output
+         *
+         * An unterminated last line is kept as a message.
          */
         void stopCapture();
 
@@ -49,6 +129,14 @@ namespace rtt::unittest
          */
         void clear();
 
+        /**
+         * @brief Check if output is being captured
+         */
+        [[nodiscard]] bool isCapturing() const noexcept
+        {
+            return m_capturing;
+        }
+
         /**
          * @brief Get captured output
          * @return Vector of captured messages
@@ -91,7 +179,13 @@ namespace rtt::unittest
         }
 
     private:
+        static void onOutput(void* context, unsigned channel, const char* data, size_t size);
+        void appendOutput(std::string_view data);
+        void finishLine();
+
         std::vector<std::string> m_capturedOutput;
+        std::string m_line; // Received part of the current line
+        unsigned m_channel;
         bool m_capturing {false};
     };
 
@@ -125,16 +219,115 @@ namespace rtt::unittest
 
 #ifdef BUILD_TESTING
     /**
-     * @brief GoogleTest event listener that redirects output to RTT
+     * @brief Cycle budget of a scope in the running test, see RTT_TEST_CYCLE_BUDGET
+     *
+     * Times the scope from construction to destruction and adds a GoogleTest
+     * failure at the line of the budget if it took longer. The failure is
+     * reported from the test body, so every listener sees it before the test
+     * ends. RttTestEventListener records the budget of the test in its
+     * TestResult.
+     */
+    class CycleBudget
+    {
+    public:
+        /**
+         * @brief Start timing with a budget
+         * @param cycles Budget in timebase ticks (CPU cycles on the target, nanoseconds on the host); 0 for none
+         * @param file Source file reported with the failure
+         * @param line Source line reported with the failure
+         */
+        CycleBudget(uint64_t cycles, const char* file, int line) noexcept
+            : m_cycles(cycles), m_file(file), m_line(line)
+        {
+            s_cycles = cycles;
+            // Last, so the setup is not part of the measurement
+            m_start = Timebase::now();
+        }
+
+        ~CycleBudget()
+        {
+            const uint64_t elapsed = Timebase::now() - m_start;
+            if (m_cycles != 0 && elapsed > m_cycles)
+            {
+                ADD_FAILURE_AT(m_file, m_line) << "cycle budget exceeded: " << elapsed << " > " << m_cycles
+                                               << " cycles";
+            }
+        }
+
+        CycleBudget(const CycleBudget&) = delete;
+        CycleBudget& operator=(const CycleBudget&) = delete;
+
+        /**
+         * @brief Budget declared by the running test, 0 if none
+         */
+        [[nodiscard]] static uint64_t get() noexcept
+        {
+            return s_cycles;
+        }
+
+        static void clear() noexcept
+        {
+            s_cycles = 0;
+        }
+
+    private:
+        uint64_t m_cycles;
+        const char* m_file;
+        int m_line;
+        uint64_t m_start{0};
+
+        static inline uint64_t s_cycles{0};
+    };
+
+    /**
+     * @brief GoogleTest event listener that reports test results via RTT
      *
-     * This listener captures GoogleTest output and sends it via RTT instead of stdout.
-     * This is useful for embedded systems where stdout is not available.
+     * Replaces the console output on targets without stdout. Each test is
+     * timed with the shared timebase (DWT cycle counter on Cortex-M) from
+     * OnTestStart to OnTestEnd; a test over its RTT_TEST_CYCLE_BUDGET fails
+     * like any other failed assertion. With a DataSender, every test also produces a
+     * TestResult Struct packet (described once, before the first one), the
+     * first run of a test its name record and a failed test its failure
+     * record. The per-test text lines can be turned off with
+     * setTextReport(false) so that only failures and the summary are
+     * formatted on the target.
      */
     class RttTestEventListener : public ::testing::EmptyTestEventListener
     {
     public:
-        explicit RttTestEventListener(rtt::Logger& logger) : m_logger(logger)
+        /**
+         * @param logger Logger for the text report
+         * @param sender DataSender for TestResult records, nullptr for text only
+         */
+        explicit RttTestEventListener(rtt::Logger& logger, data::DataSender* sender = nullptr) noexcept :
+            m_logger(logger), m_sender(sender)
+        {
+        }
+
+        /**
+         * @brief Enable or disable the per-test and per-suite text lines (default: true)
+         *
+         * Failures and the program summary are always reported as text.
+         */
+        void setTextReport(bool enabled) noexcept
+        {
+            m_textReport = enabled;
+        }
+
+        /**
+         * @brief Get the result record of the last finished test
+         */
+        [[nodiscard]] const TestResult& getLastResult() const noexcept
+        {
+            return m_result;
+        }
+
+        /**
+         * @brief Get the first failure of the last test as "file:line: message", empty if it passed
+         */
+        [[nodiscard]] const char* getLastFailure() const noexcept
         {
+            return m_failure;
         }
 
         void OnTestProgramStart(const ::testing::UnitTest& unit_test) override
@@ -147,6 +340,9 @@ namespace rtt::unittest
 
         void OnTestSuiteStart(const ::testing::TestSuite& test_suite) override
         {
+            if (!m_textReport)
+                return;
+
             m_logger.logFormatted(LogLevel::Info, "[----------] %d tests from %s",
                                  test_suite.test_to_run_count(),
                                  test_suite.name());
@@ -154,35 +350,83 @@ namespace rtt::unittest
 
         void OnTestStart(const ::testing::TestInfo& test_info) override
         {
-            m_logger.logFormatted(LogLevel::Info, "[ RUN      ] %s.%s",
-                                 test_info.test_suite_name(),
-                                 test_info.name());
+            if (m_textReport)
+            {
+                m_logger.logFormatted(LogLevel::Info, "[ RUN      ] %s.%s",
+                                     test_info.test_suite_name(),
+                                     test_info.name());
+            }
+
+            m_result = TestResult{};
+            m_result.index = indexOf(test_info);
+            m_failure[0] = '\0';
+            CycleBudget::clear();
+            // Last, so the text report is not part of the measurement
+            m_start = Timebase::now();
         }
 
         void OnTestPartResult(const ::testing::TestPartResult& result) override
         {
-            if (result.type() == ::testing::TestPartResult::kSuccess)
+            if (!result.failed())
                 return;
 
-            const char* type = result.failed() ? "FAILURE" : "SUCCESS";
+            const char* file = result.file_name() ? result.file_name() : "unknown";
             m_logger.logFormatted(LogLevel::Error, "[  FAILED  ] %s:%d: %s",
-                                 result.file_name() ? result.file_name() : "unknown",
+                                 file,
                                  result.line_number(),
                                  result.message());
+            addFailure(file, result.line_number(), result.message());
         }
 
         void OnTestEnd(const ::testing::TestInfo& test_info) override
         {
-            const char* result = test_info.result()->Passed() ? "       OK" : "  FAILED";
-            m_logger.logFormatted(LogLevel::Info, "[%s] %s.%s (%lld ms)",
-                                 result,
-                                 test_info.test_suite_name(),
-                                 test_info.name(),
-                                 test_info.result()->elapsed_time());
+            m_result.cycles = Timebase::now() - m_start;
+            m_result.budget = CycleBudget::get();
+            m_result.frequency = Timebase::getFrequency();
+            CycleBudget::clear();
+
+            const ::testing::TestResult& result = *test_info.result();
+            if (m_result.failures > 0 || result.Failed())
+            {
+                m_result.status = TestStatus::Failed;
+            }
+            else if (result.Skipped())
+            {
+                m_result.status = TestStatus::Skipped;
+            }
+            else
+            {
+                m_result.status = TestStatus::Passed;
+            }
+
+            if (m_sender != nullptr)
+            {
+                if (m_failure[0] != '\0')
+                {
+                    sendRecord(TEST_FAILURE_TAG, m_result.index, m_failure, "");
+                }
+                (void)m_sender->sendStruct(m_result);
+            }
+
+            if (m_textReport || m_result.status == TestStatus::Failed)
+            {
+                const char* status = m_result.status == TestStatus::Passed    ? "       OK"
+                                     : m_result.status == TestStatus::Skipped ? "  SKIPPED"
+                                                                              : "  FAILED";
+                m_logger.logFormatted(LogLevel::Info, "[%s] %s.%s (%llu cycles, %llu us)",
+                                     status,
+                                     test_info.test_suite_name(),
+                                     test_info.name(),
+                                     static_cast<unsigned long long>(m_result.cycles),
+                                     static_cast<unsigned long long>(Timebase::toMicroseconds(m_result.cycles)));
+            }
         }
 
         void OnTestSuiteEnd(const ::testing::TestSuite& test_suite) override
         {
+            if (!m_textReport)
+                return;
+
             m_logger.logFormatted(LogLevel::Info, "[----------] %d tests from %s (%lld ms total)",
                                  test_suite.test_to_run_count(),
                                  test_suite.name(),
@@ -208,7 +452,70 @@ namespace rtt::unittest
         }
 
     private:
+        void addFailure(const char* file, int line, const char* message) noexcept
+        {
+            if (m_result.failures++ == 0)
+            {
+                // ADD_FAILURE() puts "Failed" on a line of its own before the streamed message
+                std::string_view text = message != nullptr ? message : "";
+                if (text.substr(0, 7) == "Failed\n")
+                {
+                    text.remove_prefix(7);
+                }
+                (void)std::snprintf(m_failure, sizeof(m_failure), "%s:%d: %.*s", file, line,
+                                    static_cast<int>(text.size()), text.data());
+                // One line per failure record
+                std::replace(m_failure, m_failure + std::strlen(m_failure), '\n', ' ');
+            }
+        }
+
+        /**
+         * @brief Number of a test, sending its name record when it runs for the first time
+         */
+        uint16_t indexOf(const ::testing::TestInfo& test_info)
+        {
+            const auto known = std::find(m_tests.begin(), m_tests.end(), &test_info);
+            const auto index = static_cast<uint16_t>(known - m_tests.begin());
+            if (known == m_tests.end())
+            {
+                m_tests.push_back(&test_info);
+                if (m_sender != nullptr)
+                {
+                    sendRecord(TEST_NAME_TAG, index, test_info.test_suite_name(), test_info.name());
+                }
+            }
+            return index;
+        }
+
+        /**
+         * @brief Send "<tag> <index> <first>[ <second>]" as a String packet
+         *
+         * With a second text both are names cut to TEST_NAME_LENGTH, otherwise
+         * the first is a message cut to TEST_MESSAGE_LENGTH.
+         */
+        void sendRecord(std::string_view tag, uint16_t index, const char* first, const char* second) noexcept
+        {
+            char record[16 + TEST_MESSAGE_LENGTH + TEST_NAME_LENGTH];
+            const bool names = second[0] != '\0';
+            const size_t limit = names ? TEST_NAME_LENGTH - 1U : TEST_MESSAGE_LENGTH - 1U;
+            const int length = std::snprintf(record, sizeof(record), "%.*s %u %.*s%s%.*s",
+                                             static_cast<int>(tag.size()), tag.data(), static_cast<unsigned>(index),
+                                             static_cast<int>(limit), first, names ? " " : "",
+                                             static_cast<int>(TEST_NAME_LENGTH - 1U), second);
+            if (length > 0)
+            {
+                const size_t size = std::min(static_cast<size_t>(length), sizeof(record) - 1U);
+                (void)m_sender->sendString(std::string_view(record, size));
+            }
+        }
+
         rtt::Logger& m_logger;
+        data::DataSender* m_sender;
+        bool m_textReport{true};
+        uint64_t m_start{0};
+        TestResult m_result{};
+        char m_failure[TEST_MESSAGE_LENGTH]{};
+        std::vector<const ::testing::TestInfo*> m_tests; // Tests named so far, by index
     };
 
     /**
@@ -219,8 +526,11 @@ namespace rtt::unittest
      *
      * @param logger Logger instance to use for output
      * @param remove_default_listener If true, removes the default console output listener
+     * @param sender DataSender for binary TestResult records, nullptr for text only
+     * @param text_report If false, only failures and the summary are reported as text
      */
-    inline void InstallRttTestListener(rtt::Logger& logger, bool remove_default_listener = true)
+    inline void InstallRttTestListener(rtt::Logger& logger, bool remove_default_listener = true,
+                                       data::DataSender* sender = nullptr, bool text_report = true)
     {
         ::testing::TestEventListeners& listeners = ::testing::UnitTest::GetInstance()->listeners();
 
@@ -229,7 +539,24 @@ namespace rtt::unittest
             delete listeners.Release(listeners.default_result_printer());
         }
 
-        listeners.Append(new RttTestEventListener(logger));
+        auto* listener = new RttTestEventListener(logger, sender);
+        listener->setTextReport(text_report);
+        listeners.Append(listener);
     }
 #endif // BUILD_TESTING
 } // namespace rtt::unittest
+
+#ifdef BUILD_TESTING
+#define RTT_UNITTEST_CONCAT_IMPL(a, b) a##b
+#define RTT_UNITTEST_CONCAT(a, b) RTT_UNITTEST_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Fail the running test if the rest of the enclosing scope takes more than a number of timebase ticks
+ *
+ * Checked when the scope ends, inside the test body, so the failure reaches
+ * every listener before the test ends. Works with or without RttTestEventListener.
+ * Usage: RTT_TEST_CYCLE_BUDGET(20000); // CPU cycles on the target
+ */
+#define RTT_TEST_CYCLE_BUDGET(cycles)                                                                      \
+    const ::rtt::unittest::CycleBudget RTT_UNITTEST_CONCAT(rttCycleBudget, __LINE__)((cycles), __FILE__, __LINE__)
+#endif
@@ -1,20 +1,105 @@
 #include "rtt_unittest/rtt_unittest.hpp"
 
+#if RTT_MOCK_RTT
+#include "rtt_mock/rtt_mock.hpp"
+#endif
+
 namespace rtt::unittest
 {
+    namespace
+    {
+        // Strip the "[LEVEL] " prefix of a log record, other lines are kept as they are
+        std::string_view messageText(std::string_view line) noexcept
+        {
+            const size_t end = line.find("] ");
+            if (line.empty() || line.front() != '[' || end == std::string_view::npos || end < 2)
+            {
+                return line;
+            }
+            for (size_t i = 1; i < end; ++i)
+            {
+                if (line[i] < 'A' || line[i] > 'Z')
+                {
+                    return line;
+                }
+            }
+            return line.substr(end + 2);
+        }
+    } // namespace
+
+    RttCapture::~RttCapture()
+    {
+        if (m_capturing)
+        {
+            stopCapture();
+        }
+    }
+
     void RttCapture::startCapture()
     {
         m_capturing = true;
         m_capturedOutput.clear();
+        m_line.clear();
+#if RTT_MOCK_RTT
+        using rtt::mock::RttMock;
+        RttMock::consume(m_channel, SEGGER_RTT_GetBytesInBuffer(m_channel));
+        RttMock::clearCaptured(m_channel);
+        RttMock::setListener(m_channel, &RttCapture::onOutput, this);
+        RttMock::startCapture(m_channel);
+#endif
     }
 
     void RttCapture::stopCapture()
     {
+#if RTT_MOCK_RTT
+        using rtt::mock::RttMock;
+        if (m_capturing)
+        {
+            RttMock::stopCapture(m_channel);
+            RttMock::setListener(m_channel, nullptr, nullptr);
+            RttMock::clearCaptured(m_channel);
+        }
+#endif
         m_capturing = false;
+        if (!m_line.empty())
+        {
+            finishLine();
+        }
     }
 
     void RttCapture::clear()
     {
         m_capturedOutput.clear();
+        m_line.clear();
+    }
+
+    void RttCapture::onOutput(void* context, unsigned /*channel*/, const char* data, size_t size)
+    {
+        static_cast<RttCapture*>(context)->appendOutput(std::string_view(data, size));
+    }
+
+    void RttCapture::appendOutput(std::string_view data)
+    {
+        for (const char c : data)
+        {
+            if (c == '\n')
+            {
+                if (!m_line.empty() && m_line.back() == '\r')
+                {
+                    m_line.pop_back();
+                }
+                finishLine();
+            }
+            else
+            {
+                m_line.push_back(c);
+            }
+        }
+    }
+
+    void RttCapture::finishLine()
+    {
+        m_capturedOutput.emplace_back(messageText(m_line));
+        m_line.clear();
     }
 } // namespace rtt::unittest
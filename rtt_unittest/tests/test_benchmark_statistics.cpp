@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "rtt_benchmark/statistics.hpp"
+
+namespace rtt::test
+{
+    using benchmark::LogHistogram;
+    using benchmark::P2Quantile;
+    using benchmark::Reservoir;
+    using benchmark::RunningStats;
+    using benchmark::StreamingStats;
+
+    TEST(RunningStatsTest, MeanAndVariance)
+    {
+        RunningStats stats;
+        for (const uint64_t value : {2U, 4U, 4U, 4U, 5U, 5U, 7U, 9U})
+        {
+            stats.add(value);
+        }
+
+        EXPECT_EQ(stats.count(), 8U);
+        EXPECT_EQ(stats.min(), 2U);
+        EXPECT_EQ(stats.max(), 9U);
+        EXPECT_EQ(stats.total(), 40U);
+        EXPECT_DOUBLE_EQ(stats.mean(), 5.0);
+        EXPECT_DOUBLE_EQ(stats.variance(), 32.0 / 7.0);
+    }
+
+    TEST(RunningStatsTest, EmptyAndSingle)
+    {
+        RunningStats stats;
+        EXPECT_EQ(stats.min(), 0U);
+        EXPECT_EQ(stats.variance(), 0.0);
+
+        stats.add(42);
+        EXPECT_EQ(stats.min(), 42U);
+        EXPECT_EQ(stats.variance(), 0.0);
+    }
+
+    TEST(P2QuantileTest, ExactForFewSamples)
+    {
+        P2Quantile median(0.5);
+        EXPECT_EQ(median.value(), 0.0);
+
+        median.add(30.0);
+        median.add(10.0);
+        median.add(20.0);
+        EXPECT_DOUBLE_EQ(median.value(), 20.0);
+    }
+
+    TEST(P2QuantileTest, ConvergesOnUniformStream)
+    {
+        P2Quantile p50(0.5);
+        P2Quantile p99(0.99);
+        std::vector<uint32_t> samples;
+        uint32_t state = 12345;
+        for (int i = 0; i < 20000; ++i)
+        {
+            state = state * 1103515245U + 12345U;
+            const uint32_t value = (state >> 16) % 10000U;
+            samples.push_back(value);
+            p50.add(value);
+            p99.add(value);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        EXPECT_NEAR(p50.value(), samples[10000], 100.0);
+        EXPECT_NEAR(p99.value(), samples[19800], 50.0);
+    }
+
+    TEST(P2QuantileTest, CapturesTail)
+    {
+        // 1% of iterations hit a slow path, which the mean hides
+        P2Quantile p999(0.999);
+        P2Quantile p50(0.5);
+        for (int i = 0; i < 10000; ++i)
+        {
+            const double value = (i % 100 == 99) ? 1000.0 : 10.0;
+            p50.add(value);
+            p999.add(value);
+        }
+
+        EXPECT_NEAR(p50.value(), 10.0, 1.0);
+        EXPECT_GT(p999.value(), 500.0);
+    }
+
+    TEST(LogHistogramTest, PowerOfTwoBins)
+    {
+        EXPECT_EQ(LogHistogram::binOf(0), 0U);
+        EXPECT_EQ(LogHistogram::binOf(1), 1U);
+        EXPECT_EQ(LogHistogram::binOf(3), 2U);
+        EXPECT_EQ(LogHistogram::binOf(4), 3U);
+        EXPECT_EQ(LogHistogram::binOf(UINT32_MAX), 32U);
+        EXPECT_EQ(LogHistogram::lowerBound(3), 4U);
+        EXPECT_EQ(LogHistogram::upperBound(3), 8U);
+
+        LogHistogram histogram;
+        histogram.add(5);
+        histogram.add(7);
+        histogram.add(100);
+        EXPECT_EQ(histogram.getCount(3), 2U);
+        EXPECT_EQ(histogram.getCount(7), 1U);
+        EXPECT_EQ(histogram.getCount(LogHistogram::BINS), 0U);
+    }
+
+    TEST(ReservoirTest, FillsThenSamples)
+    {
+        std::array<uint32_t, 16> buffer{};
+        Reservoir reservoir(buffer);
+
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            reservoir.add(i);
+        }
+        EXPECT_EQ(reservoir.size(), 10U);
+        EXPECT_EQ(buffer[9], 9U);
+
+        for (uint32_t i = 10; i < 10000; ++i)
+        {
+            reservoir.add(i);
+        }
+        EXPECT_EQ(reservoir.size(), 16U);
+        EXPECT_EQ(reservoir.seen(), 10000U);
+
+        // Later samples must have replaced most of the initial ones
+        const auto late = std::count_if(buffer.begin(), buffer.end(), [](uint32_t value) { return value >= 1000U; });
+        EXPECT_GE(late, 8);
+    }
+
+    TEST(ReservoirTest, NullBufferIsIgnored)
+    {
+        Reservoir reservoir(nullptr, 8);
+        reservoir.add(1);
+        EXPECT_EQ(reservoir.size(), 0U);
+        EXPECT_EQ(reservoir.capacity(), 0U);
+    }
+
+    TEST(StreamingStatsTest, FeedsAllEstimators)
+    {
+        std::array<uint32_t, 4> buffer{};
+        Reservoir reservoir(buffer);
+        StreamingStats stats;
+        stats.setReservoir(&reservoir);
+
+        for (uint32_t i = 1; i <= 1000; ++i)
+        {
+            stats.add(i);
+        }
+
+        EXPECT_EQ(stats.summary().count(), 1000U);
+        EXPECT_NEAR(stats.p50(), 500.0, 10.0);
+        EXPECT_NEAR(stats.p90(), 900.0, 10.0);
+        EXPECT_EQ(stats.histogram().getCount(10), 1000U - 511U);
+        EXPECT_EQ(reservoir.seen(), 1000U);
+
+        stats.reset();
+        EXPECT_EQ(stats.summary().count(), 0U);
+        EXPECT_EQ(reservoir.size(), 0U);
+    }
+} // namespace rtt::test
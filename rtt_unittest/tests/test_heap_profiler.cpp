@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "rtt_freertos_hooks/rtt_freertos_hooks.hpp"
+#include "rtt_freertos_trace/heap_profiler.hpp"
+#include "SEGGER_RTT.h"
+
+namespace rtt::test
+{
+    using trace::HEAP_CALLER_SLOTS;
+    using trace::HEAP_LEAK_CANDIDATES;
+    using trace::HEAP_LIVE_SLOTS;
+    using trace::HeapCallerStats;
+    using trace::HeapLeakCandidate;
+    using trace::HeapProfiler;
+    using trace::HeapSummary;
+
+    namespace
+    {
+        void* block(uintptr_t index) { return reinterpret_cast<void*>(0x20000000U + index * 16U); }
+
+        const void* caller(uintptr_t index) { return reinterpret_cast<const void*>(0x08000101U + index * 0x40U); }
+
+        uint32_t callerAddress(uintptr_t index) { return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(caller(index))); }
+
+        HeapCallerStats findCaller(uint32_t address)
+        {
+            std::array<HeapCallerStats, HEAP_CALLER_SLOTS + 1> callers{};
+            const size_t count = HeapProfiler::getCallers(callers.data(), callers.size());
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (callers[i].caller == address)
+                {
+                    return callers[i];
+                }
+            }
+            return HeapCallerStats{};
+        }
+    } // namespace
+
+    class HeapProfilerTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            HeapProfiler::reset();
+        }
+
+        void TearDown() override
+        {
+            HeapProfiler::reset();
+        }
+    };
+
+    TEST_F(HeapProfilerTest, TracksLiveAllocationsPerCaller)
+    {
+        HeapProfiler::recordMalloc(block(0), 100, caller(0));
+        HeapProfiler::recordMalloc(block(1), 40, caller(0));
+        HeapProfiler::recordMalloc(block(2), 8, caller(1));
+        HeapProfiler::recordFree(block(0));
+        HeapProfiler::recordMalloc(block(3), 20, caller(0));
+
+        const HeapSummary summary = HeapProfiler::getSummary();
+        EXPECT_EQ(summary.allocations, 4U);
+        EXPECT_EQ(summary.frees, 1U);
+        EXPECT_EQ(summary.liveCount, 3U);
+        EXPECT_EQ(summary.liveBytes, 68U);
+        EXPECT_EQ(summary.peakBytes, 148U);
+        EXPECT_EQ(summary.callers, 2U);
+
+        const HeapCallerStats first = findCaller(callerAddress(0));
+        EXPECT_EQ(first.allocations, 3U);
+        EXPECT_EQ(first.frees, 1U);
+        EXPECT_EQ(first.liveCount, 2U);
+        EXPECT_EQ(first.liveBytes, 60U);
+        EXPECT_EQ(first.peakBytes, 140U);
+        EXPECT_EQ(first.totalBytes, 160U);
+        EXPECT_EQ(first.largest, 100U);
+        EXPECT_EQ(findCaller(callerAddress(1)).liveBytes, 8U);
+    }
+
+    TEST_F(HeapProfilerTest, FindsEveryBlockAfterRandomFrees)
+    {
+        // Backward-shift deletion keeps all probe runs intact
+        std::vector<uintptr_t> blocks(200);
+        std::iota(blocks.begin(), blocks.end(), 0);
+        for (const uintptr_t index : blocks)
+        {
+            HeapProfiler::recordMalloc(block(index * 7), index + 1, caller(index % 3));
+        }
+
+        std::mt19937 random(1234);
+        std::shuffle(blocks.begin(), blocks.end(), random);
+        for (const uintptr_t index : blocks)
+        {
+            HeapProfiler::recordFree(block(index * 7));
+        }
+
+        const HeapSummary summary = HeapProfiler::getSummary();
+        EXPECT_EQ(summary.frees, 200U);
+        EXPECT_EQ(summary.unknownFrees, 0U);
+        EXPECT_EQ(summary.liveCount, 0U);
+        EXPECT_EQ(summary.liveBytes, 0U);
+        EXPECT_EQ(summary.peakBytes, 200U * 201U / 2U);
+    }
+
+    TEST_F(HeapProfilerTest, CountsUntrackedAndFailedAllocations)
+    {
+        const size_t maxLive = HEAP_LIVE_SLOTS - HEAP_LIVE_SLOTS / 8;
+        for (uintptr_t i = 0; i < maxLive + 3; ++i)
+        {
+            HeapProfiler::recordMalloc(block(i), 4, caller(0));
+        }
+        HeapProfiler::recordFree(block(maxLive)); // Was not tracked
+        HeapProfiler::recordFree(nullptr);
+        HeapProfiler::recordMalloc(nullptr, 512, caller(5));
+
+        const HeapSummary summary = HeapProfiler::getSummary();
+        EXPECT_EQ(summary.liveCount, maxLive);
+        EXPECT_EQ(summary.untracked, 3U);
+        EXPECT_EQ(summary.unknownFrees, 1U);
+        EXPECT_EQ(summary.allocations, maxLive + 3);
+        EXPECT_EQ(summary.failures, 1U);
+        EXPECT_EQ(summary.failedSize, 512U);
+        EXPECT_EQ(summary.failedCaller, callerAddress(5));
+    }
+
+    TEST_F(HeapProfilerTest, SharesOneEntryForCallersBeyondTheTable)
+    {
+        for (uintptr_t i = 0; i < HEAP_CALLER_SLOTS + 2; ++i)
+        {
+            HeapProfiler::recordMalloc(block(i), 16, caller(i));
+        }
+
+        const HeapSummary summary = HeapProfiler::getSummary();
+        EXPECT_EQ(summary.callers, HEAP_CALLER_SLOTS + 1);
+        const HeapCallerStats other = findCaller(0);
+        EXPECT_EQ(other.allocations, 2U);
+        EXPECT_EQ(other.liveBytes, 32U);
+    }
+
+    TEST_F(HeapProfilerTest, ListsOldestLiveAllocationsAsLeakCandidates)
+    {
+        for (uintptr_t i = 0; i < 20; ++i)
+        {
+            HeapProfiler::recordMalloc(block(i), 10 + i, caller(i % 2));
+        }
+        HeapProfiler::recordFree(block(0));
+        HeapProfiler::recordFree(block(2));
+
+        std::array<HeapLeakCandidate, HEAP_LEAK_CANDIDATES> candidates{};
+        ASSERT_EQ(HeapProfiler::getLeakCandidates(candidates.data(), candidates.size()), HEAP_LEAK_CANDIDATES);
+        const std::array<uintptr_t, 4> oldest{1, 3, 4, 5};
+        for (size_t i = 0; i < oldest.size(); ++i)
+        {
+            EXPECT_EQ(candidates[i].address, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(block(oldest[i]))));
+            EXPECT_EQ(candidates[i].size, 10U + oldest[i]);
+            EXPECT_EQ(candidates[i].caller, callerAddress(oldest[i] % 2));
+            EXPECT_EQ(candidates[i].age, 19U - oldest[i]);
+        }
+    }
+
+    TEST_F(HeapProfilerTest, ReportSendsSummaryCallersAndCandidates)
+    {
+        static std::array<char, 2048> buffer{};
+        SEGGER_RTT_ConfigUpBuffer(2, "Heap", buffer.data(), buffer.size(), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        _SEGGER_RTT.aUp[2].RdOff = 0;
+        _SEGGER_RTT.aUp[2].WrOff = 0;
+        data::DataSender sender(2);
+
+        rtt_heap_profiler_malloc(block(0), 64, const_cast<void*>(caller(0)));
+        rtt_heap_profiler_malloc(block(1), 32, const_cast<void*>(caller(1)));
+        rtt_heap_profiler_free(block(1));
+        HeapProfiler::setHeapSize(4096);
+        const size_t sent = HeapProfiler::report(sender);
+        ASSERT_EQ(sent, _SEGGER_RTT.aUp[2].WrOff);
+
+        // Count the Struct packets per schema, skipping the Schema packets sent first
+        std::array<size_t, 3> packets{};
+        HeapSummary summary{};
+        for (size_t offset = 0; offset + sizeof(data::DataHeader) <= sent;)
+        {
+            data::DataHeader header{};
+            std::memcpy(&header, &buffer[offset], sizeof(header));
+            if (header.type == data::DataType::Struct)
+            {
+                const size_t schema = header.subtype - RTT_HEAP_PROFILER_SCHEMA_ID;
+                ASSERT_LT(schema, packets.size());
+                ++packets[schema];
+                if (schema == 0)
+                {
+                    std::memcpy(&summary, &buffer[offset + sizeof(header)], sizeof(summary));
+                }
+            }
+            offset += sizeof(header) + header.size;
+        }
+        EXPECT_EQ(packets[0], 1U);
+        EXPECT_EQ(packets[1], 2U);
+        EXPECT_EQ(packets[2], 1U);
+        EXPECT_EQ(summary.heapSize, 4096U);
+        EXPECT_EQ(summary.liveBytes, 64U);
+        EXPECT_EQ(summary.callers, packets[1]);
+        EXPECT_EQ(summary.leakCandidates, packets[2]);
+    }
+
+    TEST_F(HeapProfilerTest, MallocFailedCallbackCanRecordTheReport)
+    {
+        static size_t reports{0};
+        reports = 0;
+        freertos::FreeRtosHooks::setMallocFailedCallback([] { ++reports; });
+        freertos::FreeRtosHooks::runMallocFailedCallback();
+        EXPECT_EQ(reports, 1U);
+
+        freertos::FreeRtosHooks::setMallocFailedCallback(nullptr);
+        freertos::FreeRtosHooks::runMallocFailedCallback();
+        EXPECT_EQ(reports, 1U);
+    }
+} // namespace rtt::test
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rtt_logger/isr_log_queue.hpp"
+#include "SEGGER_RTT.h"
+
+namespace rtt::test
+{
+    namespace
+    {
+        constexpr unsigned LOG_CHANNEL{1};
+
+        std::array<char, 2048> g_output{};
+
+        IsrLogRecord makeRecord(const char* format)
+        {
+            IsrLogRecord record{};
+            record.format = format;
+            record.level = LogLevel::Info;
+            return record;
+        }
+    } // namespace
+
+    class IsrLogQueueTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            SEGGER_RTT_ConfigUpBuffer(LOG_CHANNEL, "IsrLog", g_output.data(), g_output.size(),
+                                      SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+            output();
+            m_queue.setLogger(m_logger);
+        }
+
+        // Bytes written to the log channel since the last call
+        static std::string output()
+        {
+            SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[LOG_CHANNEL];
+            std::string text(g_output.data() + up.RdOff, up.WrOff - up.RdOff);
+            up.RdOff = 0;
+            up.WrOff = 0;
+            return text;
+        }
+
+        Logger m_logger{LOG_CHANNEL, LogLevel::Info};
+        IsrLogQueue m_queue;
+    };
+
+    TEST_F(IsrLogQueueTest, RecordsAreFormattedWhenDrained)
+    {
+        EXPECT_TRUE(m_queue.push(LogLevel::Warning, "ADC %u: %d mV %s", 3U, -5, static_cast<const char*>("low")));
+        EXPECT_TRUE(m_queue.push(LogLevel::Info, "gain %5.2f", 1.5F));
+        EXPECT_TRUE(m_queue.push(LogLevel::Error, "no arguments"));
+        EXPECT_EQ(output(), "");
+        EXPECT_EQ(m_queue.size(), 3U);
+
+        EXPECT_EQ(m_queue.drain(), 3U);
+        EXPECT_EQ(output(), "[WARN] ADC 3: -5 mV low\r\n"
+                            "[INFO] gain  1.50\r\n"
+                            "[ERROR] no arguments\r\n");
+        EXPECT_EQ(m_queue.size(), 0U);
+        EXPECT_EQ(m_queue.drain(), 0U);
+    }
+
+    TEST_F(IsrLogQueueTest, DrainHonorsLimit)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_TRUE(m_queue.push(LogLevel::Info, "%d", i));
+        }
+        EXPECT_EQ(m_queue.drain(2), 2U);
+        EXPECT_EQ(output(), "[INFO] 0\r\n[INFO] 1\r\n");
+        EXPECT_EQ(m_queue.drain(2), 1U);
+        EXPECT_EQ(output(), "[INFO] 2\r\n");
+    }
+
+    TEST_F(IsrLogQueueTest, DisabledLevelsAreNotQueued)
+    {
+        EXPECT_FALSE(m_queue.push(LogLevel::Debug, "hidden %d", 1));
+        EXPECT_EQ(m_queue.size(), 0U);
+
+        m_logger.setMinLevel(LogLevel::Debug);
+        EXPECT_TRUE(m_queue.push(LogLevel::Debug, "shown %d", 2));
+        EXPECT_EQ(m_queue.drain(), 1U);
+        EXPECT_EQ(output(), "[DEBUG] shown 2\r\n");
+        EXPECT_EQ(m_queue.droppedCount(), 0U);
+    }
+
+    TEST_F(IsrLogQueueTest, FullQueueDropsAndReportsCount)
+    {
+        for (size_t i = 0; i < IsrLogQueue::capacity() + 3U; ++i)
+        {
+            EXPECT_EQ(m_queue.push(LogLevel::Info, "%u", static_cast<unsigned>(i)), i < IsrLogQueue::capacity());
+        }
+        EXPECT_EQ(m_queue.droppedCount(), 3U);
+
+        EXPECT_EQ(m_queue.drain(), IsrLogQueue::capacity());
+        const std::string text = output();
+        EXPECT_EQ(text.rfind("[INFO] 0\r\n", 0), 0U);
+        const std::string warning = "[WARN] 3 ISR log records dropped\r\n";
+        ASSERT_GE(text.size(), warning.size());
+        EXPECT_EQ(text.substr(text.size() - warning.size()), warning);
+
+        // Reported once, still counted
+        EXPECT_EQ(m_queue.drain(), 0U);
+        EXPECT_EQ(output(), "");
+        EXPECT_EQ(m_queue.droppedCount(), 3U);
+
+        m_queue.reset();
+        EXPECT_EQ(m_queue.droppedCount(), 0U);
+    }
+
+    TEST_F(IsrLogQueueTest, FormatAppliesSpecsPerArgument)
+    {
+        char buffer[64];
+        IsrLogRecord record = makeRecord("%08x|%-4d|%%|%lu|%c");
+        detail::storeIsrArgument(record, 0, 0xBEEFU);
+        detail::storeIsrArgument(record, 1, 7);
+        detail::storeIsrArgument(record, 2, static_cast<uint16_t>(65535));
+        detail::storeIsrArgument(record, 3, 'z');
+        record.argCount = 4;
+        EXPECT_EQ(IsrLogQueue::format(buffer, sizeof(buffer), record), std::strlen("0000beef|7   |%|65535|z"));
+        EXPECT_STREQ(buffer, "0000beef|7   |%|65535|z");
+
+        // Doubles are stored as float; only string arguments are dereferenced by %s
+        record = makeRecord("%.2f|%+d|%s|%s");
+        detail::storeIsrArgument(record, 0, 2.5);
+        detail::storeIsrArgument(record, 1, 2.5F);
+        detail::storeIsrArgument(record, 2, static_cast<const char*>(nullptr));
+        detail::storeIsrArgument(record, 3, 42);
+        record.argCount = 4;
+        IsrLogQueue::format(buffer, sizeof(buffer), record);
+        EXPECT_STREQ(buffer, "2.50|+2|(null)|?");
+    }
+
+    TEST_F(IsrLogQueueTest, FormatCopiesUnmatchedConversionsAndTruncates)
+    {
+        IsrLogRecord record = makeRecord("a=%d b=%d c=%*d %");
+        detail::storeIsrArgument(record, 0, -1);
+        record.argCount = 1;
+
+        char buffer[64];
+        EXPECT_EQ(IsrLogQueue::format(buffer, sizeof(buffer), record), std::strlen("a=-1 b=%d c=%*d %"));
+        EXPECT_STREQ(buffer, "a=-1 b=%d c=%*d %");
+
+        char small[6];
+        EXPECT_EQ(IsrLogQueue::format(small, sizeof(small), record), 5U);
+        EXPECT_STREQ(small, "a=-1 ");
+
+        record = makeRecord("value %u");
+        detail::storeIsrArgument(record, 0, 123456U);
+        record.argCount = 1;
+        char tiny[9];
+        EXPECT_EQ(IsrLogQueue::format(tiny, sizeof(tiny), record), 8U);
+        EXPECT_STREQ(tiny, "value 12");
+        EXPECT_EQ(IsrLogQueue::format(tiny, 0, record), 0U);
+    }
+
+    TEST_F(IsrLogQueueTest, DeferredRecordsKeepPushTimestamp)
+    {
+        static const char format[] = "DMA %u: %d %f %s";
+        EXPECT_TRUE(m_queue.pushDeferred(LogLevel::Error, format, 7U, -2, 0.5F, static_cast<const char*>("tx")));
+        EXPECT_EQ(m_queue.drain(), 1U);
+
+        const std::string bytes = output();
+        ASSERT_GE(bytes.size(), sizeof(DeferredLogHeader));
+        DeferredLogHeader header{};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        EXPECT_EQ(header.magic[0], DEFERRED_LOG_MAGIC_0);
+        EXPECT_EQ(header.magic[1], DEFERRED_LOG_MAGIC_1);
+        EXPECT_EQ(header.level, LogLevel::Error);
+        EXPECT_EQ(header.formatId, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(format)));
+
+        // Same encoding as Logger::logDeferred() with the timestamp taken at push time
+        uint8_t expected[DEFERRED_LOG_MAX_RECORD_SIZE];
+        detail::DeferredRecordWriter writer(expected, sizeof(expected));
+        writer.put(7U);
+        writer.put(-2);
+        writer.put(0.5F);
+        writer.put(static_cast<const char*>("tx"));
+        const size_t size = writer.finish(LogLevel::Error, format, header.timestamp);
+        EXPECT_EQ(bytes, std::string(reinterpret_cast<const char*>(expected), size));
+    }
+
+    TEST_F(IsrLogQueueTest, MacrosUseGlobalQueue)
+    {
+        IsrLogQueue& queue = getIsrLogQueue();
+        queue.reset();
+        queue.setLogger(m_logger);
+
+        RTT_LOG_ISR(LogLevel::Info, "irq %d", 5);
+        RTT_LOG_ISR_DEFERRED(LogLevel::Info, "deferred irq");
+        EXPECT_EQ(queue.size(), 2U);
+
+        rtt_log_isr_drain();
+        const std::string text = output();
+        EXPECT_EQ(text.rfind("[INFO] irq 5\r\n", 0), 0U);
+        ASSERT_GT(text.size(), std::strlen("[INFO] irq 5\r\n"));
+        EXPECT_EQ(text[std::strlen("[INFO] irq 5\r\n")], static_cast<char>(DEFERRED_LOG_MAGIC_0));
+
+        queue.setLogger(getLogger());
+        queue.reset();
+    }
+
+    TEST_F(IsrLogQueueTest, ConcurrentProducersLoseNothingUncounted)
+    {
+        constexpr int PRODUCERS = 4;
+        constexpr int PUSHES = 2000;
+        std::atomic<int> running{PRODUCERS};
+        std::vector<std::thread> producers;
+        for (int p = 0; p < PRODUCERS; ++p)
+        {
+            producers.emplace_back([this, &running, p] {
+                for (int i = 0; i < PUSHES; ++i)
+                {
+                    m_queue.push(LogLevel::Info, "%d:%d", p, i);
+                }
+                running.fetch_sub(1);
+            });
+        }
+
+        size_t drained = 0;
+        while (running.load() > 0 || m_queue.size() > 0)
+        {
+            drained += m_queue.drain();
+            output();
+        }
+        for (std::thread& producer : producers)
+        {
+            producer.join();
+        }
+        drained += m_queue.drain();
+
+        EXPECT_EQ(drained + m_queue.droppedCount(), static_cast<size_t>(PRODUCERS * PUSHES));
+    }
+} // namespace rtt::test
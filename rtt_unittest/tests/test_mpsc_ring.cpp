@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "rtt_logger/mpsc_ring.hpp"
+
+#ifndef __ARM_ARCH
+#include <thread>
+#include <vector>
+#endif
+
+namespace rtt::test
+{
+    TEST(MpscRingTest, StartsEmpty)
+    {
+        MpscRing<uint32_t, 8> ring;
+        uint32_t value = 0;
+        EXPECT_TRUE(ring.empty());
+        EXPECT_EQ(ring.capacity(), 8U);
+        EXPECT_FALSE(ring.tryPop(value));
+    }
+
+    TEST(MpscRingTest, PushPopInOrder)
+    {
+        MpscRing<uint32_t, 8> ring;
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            EXPECT_TRUE(ring.tryPush(i));
+        }
+        EXPECT_EQ(ring.size(), 5U);
+
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            ASSERT_TRUE(ring.tryPop(value));
+            EXPECT_EQ(value, i);
+        }
+        EXPECT_TRUE(ring.empty());
+    }
+
+    TEST(MpscRingTest, DropsWhenFull)
+    {
+        MpscRing<uint32_t, 4> ring;
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            EXPECT_TRUE(ring.tryPush(i));
+        }
+        EXPECT_FALSE(ring.tryPush(99));
+        EXPECT_FALSE(ring.tryPush(100));
+        EXPECT_EQ(ring.droppedCount(), 2U);
+        EXPECT_EQ(ring.takeDroppedCount(), 2U);
+        EXPECT_EQ(ring.droppedCount(), 0U);
+
+        uint32_t value = 0;
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, 0U);
+        EXPECT_TRUE(ring.tryPush(4));
+    }
+
+    TEST(MpscRingTest, WrapsAround)
+    {
+        MpscRing<uint32_t, 4> ring;
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            ASSERT_TRUE(ring.tryPush(i));
+            ASSERT_TRUE(ring.tryPush(i + 1));
+            ASSERT_TRUE(ring.tryPop(value));
+            EXPECT_EQ(value, i);
+            ASSERT_TRUE(ring.tryPop(value));
+            EXPECT_EQ(value, i + 1);
+        }
+        EXPECT_EQ(ring.droppedCount(), 0U);
+    }
+
+    TEST(MpscRingTest, Reset)
+    {
+        MpscRing<uint32_t, 4> ring;
+        ring.tryPush(1);
+        ring.tryPush(2);
+        ring.reset();
+        uint32_t value = 0;
+        EXPECT_TRUE(ring.empty());
+        EXPECT_FALSE(ring.tryPop(value));
+        EXPECT_TRUE(ring.tryPush(3));
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, 3U);
+    }
+
+#ifndef __ARM_ARCH
+    TEST(MpscRingTest, ConcurrentProducers)
+    {
+        constexpr uint32_t PRODUCERS = 4;
+        constexpr uint32_t PER_PRODUCER = 20000;
+        MpscRing<uint32_t, 64> ring;
+
+        std::vector<std::thread> producers;
+        for (uint32_t p = 0; p < PRODUCERS; ++p)
+        {
+            producers.emplace_back(
+                [&ring, p]
+                {
+                    for (uint32_t i = 0; i < PER_PRODUCER; ++i)
+                    {
+                        // Producer id in the top bits, sequence in the rest
+                        while (!ring.tryPush((p << 24) | i))
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        }
+
+        std::vector<uint32_t> next(PRODUCERS, 0);
+        uint32_t received = 0;
+        uint32_t value = 0;
+        while (received < PRODUCERS * PER_PRODUCER)
+        {
+            if (!ring.tryPop(value))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            const uint32_t producer = value >> 24;
+            ASSERT_LT(producer, PRODUCERS);
+            // Each producer's elements arrive in order and exactly once
+            ASSERT_EQ(value & 0xFFFFFFU, next[producer]);
+            ++next[producer];
+            ++received;
+        }
+
+        for (auto& thread : producers)
+        {
+            thread.join();
+        }
+        EXPECT_TRUE(ring.empty());
+    }
+#endif
+} // namespace rtt::test
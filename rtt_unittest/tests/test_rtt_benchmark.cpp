@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include "rtt_benchmark/rtt_benchmark.hpp"
+#include "rtt_benchmark/suite.hpp"
+
+namespace
+{
+    uint32_t s_lastArgument = 0;
+    size_t s_calls = 0;
+
+    void suiteProbe(uint32_t argument)
+    {
+        s_lastArgument = argument;
+        ++s_calls;
+    }
+
+    void suitePlain(uint32_t argument)
+    {
+        rtt::benchmark::doNotOptimize(argument);
+    }
+} // namespace
+
+RTT_BENCHMARK_ARGS(suiteProbe, 10, 5, 16, 64);
+RTT_BENCHMARK(suitePlain, 20, 0);
+
+namespace rtt::test
+{
+    class RttBenchmarkTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            Logger::initialize();
+        }
+    };
+
+    TEST_F(RttBenchmarkTest, StatsAreConsistent)
+    {
+        benchmark::Benchmark bench("Consistency");
+        volatile uint32_t sink = 0;
+        const auto stats = bench.run<64>([&sink]() {
+            for (uint32_t i = 0; i < 100; ++i)
+            {
+                sink = sink + i;
+            }
+        });
+
+        EXPECT_EQ(stats.iterations, 64U);
+        EXPECT_LE(stats.min, stats.mean);
+        EXPECT_LE(stats.mean, stats.max);
+        EXPECT_GE(stats.total, stats.min * 64U);
+        EXPECT_LE(stats.total, stats.max * 64U);
+        EXPECT_GT(stats.max, 0U);
+    }
+
+    TEST_F(RttBenchmarkTest, OverheadIsSubtracted)
+    {
+        benchmark::Benchmark bench("Empty");
+        const auto stats = bench.run<64>([]() {});
+
+        // An empty function costs about as much as the overhead calibration loop
+        EXPECT_LE(stats.min, stats.overhead);
+    }
+
+    TEST_F(RttBenchmarkTest, ConvertsToNanoseconds)
+    {
+        benchmark::Benchmark bench("Convert");
+        const auto stats = bench.run<8>([]() {});
+
+        EXPECT_EQ(stats.minNanoseconds(), Timebase::toNanoseconds(stats.min));
+        EXPECT_EQ(stats.meanNanoseconds(), Timebase::toNanoseconds(stats.mean));
+        EXPECT_EQ(stats.maxNanoseconds(), Timebase::toNanoseconds(stats.max));
+        EXPECT_EQ(stats.totalNanoseconds(), Timebase::toNanoseconds(stats.total));
+    }
+
+    TEST_F(RttBenchmarkTest, PercentilesWithinRange)
+    {
+        benchmark::Benchmark bench("Percentiles");
+        volatile uint32_t sink = 0;
+        const auto stats = bench.run([&sink]() { sink = sink + 1; }, 10000);
+
+        EXPECT_EQ(stats.iterations, 10000U);
+        EXPECT_LE(stats.min, stats.p50);
+        EXPECT_LE(stats.p50, stats.p90);
+        EXPECT_LE(stats.p90, stats.p99);
+        EXPECT_LE(stats.p99, stats.p999);
+        EXPECT_LE(stats.p999, stats.max);
+    }
+
+    TEST_F(RttBenchmarkTest, FillsReservoir)
+    {
+        std::array<uint32_t, 32> buffer{};
+        benchmark::Reservoir reservoir(buffer);
+        benchmark::Benchmark bench("Reservoir");
+        bench.setReservoir(&reservoir);
+
+        (void)bench.run<100>([]() {});
+        EXPECT_EQ(reservoir.size(), 32U);
+        EXPECT_EQ(reservoir.seen(), 100U);
+        EXPECT_EQ(bench.getStatistics().summary().count(), 100U);
+    }
+
+    TEST_F(RttBenchmarkTest, WarmupIsNotTimed)
+    {
+        size_t calls = 0;
+        benchmark::Benchmark bench("Warmup");
+        bench.setWarmup(7);
+        const auto stats = bench.run([&calls]() { ++calls; }, 10);
+
+        EXPECT_EQ(calls, 17U);
+        EXPECT_EQ(stats.iterations, 10U);
+    }
+
+    TEST_F(RttBenchmarkTest, RegistryKeepsDefinitionOrder)
+    {
+        const benchmark::BenchmarkDefinition* probe = nullptr;
+        for (const auto* definition = benchmark::Registry::first(); definition != nullptr;
+             definition = definition->getNext())
+        {
+            if (std::strcmp(definition->getName(), "suiteProbe") == 0)
+            {
+                probe = definition;
+            }
+        }
+
+        ASSERT_NE(probe, nullptr);
+        EXPECT_GE(benchmark::Registry::count(), 2U);
+        EXPECT_EQ(probe->getIterations(), 10U);
+        EXPECT_EQ(probe->getWarmup(), 5U);
+        ASSERT_EQ(probe->getArgumentCount(), 2U);
+        EXPECT_EQ(probe->getArgument(1), 64U);
+        ASSERT_NE(probe->getNext(), nullptr);
+        EXPECT_STREQ(probe->getNext()->getName(), "suitePlain");
+    }
+
+    TEST_F(RttBenchmarkTest, SuiteRunsEachArgument)
+    {
+        benchmark::Suite suite;
+        suite.setTextReport(false);
+        suite.setFilter("suiteProbe");
+        s_calls = 0;
+
+        EXPECT_EQ(suite.run(), 2U);
+        EXPECT_EQ(s_calls, 2U * (10U + 5U));
+        EXPECT_EQ(s_lastArgument, 64U);
+
+        const auto& result = suite.getLastResult();
+        EXPECT_STREQ(result.name, "suiteProbe/64");
+        EXPECT_EQ(result.argument, 64U);
+        EXPECT_EQ(result.iterations, 10U);
+        EXPECT_EQ(result.frequency, Timebase::getFrequency());
+        EXPECT_LE(result.min, result.p50);
+        EXPECT_LE(result.p50, result.max);
+    }
+
+    TEST_F(RttBenchmarkTest, SuiteRunsSingleArgument)
+    {
+        benchmark::Suite suite;
+        suite.setTextReport(false);
+        const benchmark::BenchmarkDefinition* probe = nullptr;
+        for (const auto* definition = benchmark::Registry::first(); definition != nullptr;
+             definition = definition->getNext())
+        {
+            if (std::strcmp(definition->getName(), "suiteProbe") == 0)
+            {
+                probe = definition;
+            }
+        }
+        ASSERT_NE(probe, nullptr);
+        s_calls = 0;
+
+        EXPECT_EQ(suite.run(*probe, 32), 1U);
+        EXPECT_EQ(s_calls, 10U + 5U);
+        EXPECT_EQ(s_lastArgument, 32U);
+        EXPECT_STREQ(suite.getLastResult().name, "suiteProbe/32");
+    }
+
+    TEST_F(RttBenchmarkTest, SuiteNamesPlainBenchmarks)
+    {
+        benchmark::Suite suite;
+        suite.setTextReport(false);
+        suite.setFilter("suitePlain");
+
+        EXPECT_EQ(suite.run(), 1U);
+        EXPECT_STREQ(suite.getLastResult().name, "suitePlain");
+        EXPECT_EQ(suite.getLastResult().argument, 0U);
+    }
+
+    TEST_F(RttBenchmarkTest, DwtEventDifferencesWrap)
+    {
+        const benchmark::DwtEvents start{250, 0, 10, 255, 3};
+        const benchmark::DwtEvents end{4, 0, 10, 1, 5};
+        const auto events = benchmark::DwtCounters::elapsed(start, end);
+
+        EXPECT_EQ(events.cpi, 10U);
+        EXPECT_EQ(events.exception, 0U);
+        EXPECT_EQ(events.sleep, 0U);
+        EXPECT_EQ(events.lsu, 2U);
+        EXPECT_EQ(events.fold, 2U);
+    }
+
+#ifndef __ARM_ARCH
+    TEST_F(RttBenchmarkTest, ProfilingUnavailableOnHost)
+    {
+        benchmark::Benchmark bench("Profile");
+        EXPECT_FALSE(bench.enableProfiling());
+        EXPECT_FALSE(bench.isProfiling());
+
+        const auto stats = bench.run<10>([]() {});
+        EXPECT_FALSE(stats.profile.enabled);
+        EXPECT_EQ(stats.profile.cpi, 0U);
+    }
+#endif
+} // namespace rtt::test
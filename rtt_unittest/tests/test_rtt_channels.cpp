@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include <string>
+#include <rtt_channels/rtt_channels.hpp>
+#include <rtt_data/rtt_data.hpp>
+#include <rtt_logger/rtt_logger.hpp>
+#include "SEGGER_RTT.h"
+
+namespace rtt::test
+{
+    namespace
+    {
+        constexpr ChannelConfig VALID_TABLE[] = {
+            {"Terminal", 0, 0, ChannelMode::Skip},
+            {"Data", 1, 512, ChannelMode::Skip},
+            {"Profiler", ANY_CHANNEL, 256, ChannelMode::Trim},
+        };
+        constexpr ChannelConfig DUPLICATE_CHANNEL[] = {
+            {"Data", 1, 512, ChannelMode::Skip},
+            {"Profiler", 1, 256, ChannelMode::Skip},
+        };
+        constexpr ChannelConfig DUPLICATE_NAME[] = {
+            {"Data", 1, 512, ChannelMode::Skip},
+            {"Data", 2, 256, ChannelMode::Skip},
+        };
+        constexpr ChannelConfig SIZED_TERMINAL[] = {
+            {"Terminal", 0, 512, ChannelMode::Skip},
+        };
+        constexpr ChannelConfig ARENA_OVERFLOW[] = {
+            {"Data", 1, ChannelManager::ARENA_SIZE, ChannelMode::Skip},
+            {"Profiler", 2, 4, ChannelMode::Skip},
+        };
+
+        static_assert(ChannelManager::isValid(VALID_TABLE));
+        static_assert(!ChannelManager::isValid(DUPLICATE_CHANNEL));
+        static_assert(!ChannelManager::isValid(DUPLICATE_NAME));
+        static_assert(!ChannelManager::isValid(SIZED_TERMINAL));
+        static_assert(!ChannelManager::isValid(ARENA_OVERFLOW));
+    } // namespace
+
+    class ChannelManagerTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            ChannelManager::reset();
+            Logger::initialize();
+        }
+
+        // Leave no arena buffers in the control block for the next tests
+        void TearDown() override
+        {
+            ChannelManager::reset();
+            Logger::initialize();
+        }
+    };
+
+    TEST_F(ChannelManagerTest, ClaimConfiguresUpBufferFromArena)
+    {
+        EXPECT_EQ(ChannelManager::claim("Data", 1, 256, ChannelMode::Trim), 1);
+
+        const SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[1];
+        EXPECT_STREQ(up.sName, "Data");
+        EXPECT_EQ(up.SizeOfBuffer, 256U);
+        EXPECT_EQ(up.Flags, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+        EXPECT_EQ(ChannelManager::getArenaUsed(), 256U);
+
+        const ChannelInfo* info = ChannelManager::getInfo(1);
+        ASSERT_NE(info, nullptr);
+        EXPECT_EQ(info->buffer, up.pBuffer);
+        EXPECT_TRUE(info->fromArena);
+    }
+
+    TEST_F(ChannelManagerTest, RejectsSecondStreamOnClaimedChannel)
+    {
+        ASSERT_EQ(ChannelManager::claim("Data", 1, 256, ChannelMode::Skip), 1);
+
+        EXPECT_EQ(ChannelManager::claim("Trace", 1, 256, ChannelMode::Skip), -1);
+        EXPECT_EQ(ChannelManager::claim("Data", 2, 256, ChannelMode::Skip), -1);
+        EXPECT_STREQ(_SEGGER_RTT.aUp[1].sName, "Data");
+    }
+
+    TEST_F(ChannelManagerTest, ClaimAgainReusesBuffer)
+    {
+        ASSERT_EQ(ChannelManager::claim("Data", 1, 256, ChannelMode::Skip), 1);
+        char* const buffer = _SEGGER_RTT.aUp[1].pBuffer;
+
+        EXPECT_EQ(ChannelManager::claim("Data", 1, 128, ChannelMode::Block), 1);
+        EXPECT_EQ(_SEGGER_RTT.aUp[1].pBuffer, buffer);
+        EXPECT_EQ(_SEGGER_RTT.aUp[1].Flags, SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+        EXPECT_EQ(ChannelManager::getArenaUsed(), 256U);
+    }
+
+    TEST_F(ChannelManagerTest, AnyChannelTakesLowestFreeChannel)
+    {
+        EXPECT_EQ(ChannelManager::claim("Data", ANY_CHANNEL, 64, ChannelMode::Skip), 1);
+        EXPECT_EQ(ChannelManager::claim("Profiler", ANY_CHANNEL, 64, ChannelMode::Skip), 2);
+        EXPECT_EQ(ChannelManager::claim("Data", ANY_CHANNEL, 64, ChannelMode::Skip), 1);
+
+        if (ChannelManager::MAX_CHANNELS == 3)
+        {
+            EXPECT_EQ(ChannelManager::claim("Trace", ANY_CHANNEL, 64, ChannelMode::Skip), -1);
+        }
+    }
+
+    TEST_F(ChannelManagerTest, AnyChannelSkipsBuffersConfiguredDirectly)
+    {
+        std::array<char, 64> buffer{};
+        SEGGER_RTT_ConfigUpBuffer(1, "Direct", buffer.data(), buffer.size(), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+
+        EXPECT_EQ(ChannelManager::claim("Data", ANY_CHANNEL, 64, ChannelMode::Skip), 2);
+    }
+
+    TEST_F(ChannelManagerTest, RejectsClaimLargerThanArena)
+    {
+        EXPECT_EQ(ChannelManager::claim("Data", 1, ChannelManager::ARENA_SIZE + 1U, ChannelMode::Skip), -1);
+        EXPECT_EQ(ChannelManager::getInfo(1), nullptr);
+        EXPECT_EQ(ChannelManager::getArenaUsed(), 0U);
+    }
+
+    TEST_F(ChannelManagerTest, TerminalKeepsSeggerBuffer)
+    {
+        char* const terminal = _SEGGER_RTT.aUp[0].pBuffer;
+
+        EXPECT_EQ(ChannelManager::claim("Terminal", 0, 512, ChannelMode::Skip), -1);
+        EXPECT_EQ(ChannelManager::claim("Terminal", 0, 0, ChannelMode::Block), 0);
+        EXPECT_EQ(_SEGGER_RTT.aUp[0].pBuffer, terminal);
+        EXPECT_EQ(_SEGGER_RTT.aUp[0].Flags, SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+        EXPECT_EQ(ChannelManager::getArenaUsed(), 0U);
+    }
+
+    TEST_F(ChannelManagerTest, AdoptUsesModuleBuffer)
+    {
+        static char buffer[128];
+
+        EXPECT_EQ(ChannelManager::adopt("Trace", 2, buffer, sizeof(buffer), ChannelMode::Skip), 2);
+        EXPECT_EQ(_SEGGER_RTT.aUp[2].pBuffer, buffer);
+        EXPECT_EQ(_SEGGER_RTT.aUp[2].SizeOfBuffer, sizeof(buffer));
+        EXPECT_EQ(ChannelManager::getArenaUsed(), 0U);
+
+        ASSERT_TRUE(ChannelManager::setMode(2, ChannelMode::Trim));
+        EXPECT_EQ(_SEGGER_RTT.aUp[2].Flags, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+        EXPECT_FALSE(ChannelManager::setMode(1, ChannelMode::Trim));
+    }
+
+    TEST_F(ChannelManagerTest, DataSenderClaimsItsChannel)
+    {
+        data::DataSender sender;
+        ASSERT_TRUE(sender.initialize());
+        EXPECT_EQ(sender.getChannel(), 1U);
+        EXPECT_STREQ(_SEGGER_RTT.aUp[1].sName, "Data");
+        EXPECT_EQ(_SEGGER_RTT.aUp[1].SizeOfBuffer, data::DATA_BUFFER_SIZE);
+        EXPECT_TRUE(sender.initialize());
+        EXPECT_EQ(ChannelManager::getArenaUsed(), data::DATA_BUFFER_SIZE);
+
+        // A second stream on the same channel is refused and keeps its channel
+        data::DataSender other;
+        EXPECT_FALSE(other.initialize("Telemetry", 256));
+        EXPECT_EQ(other.getChannel(), 1U);
+
+        data::DataSender any(ANY_CHANNEL);
+        ASSERT_TRUE(any.initialize("Telemetry", 256, ChannelMode::Trim));
+        EXPECT_EQ(any.getChannel(), 2U);
+        EXPECT_EQ(_SEGGER_RTT.aUp[2].Flags, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+        EXPECT_GT(any.sendInt(int32_t{7}), 0U);
+        EXPECT_GT(_SEGGER_RTT.aUp[2].WrOff, 0U);
+    }
+
+    TEST_F(ChannelManagerTest, ClaimsSurviveInitialize)
+    {
+        ASSERT_TRUE(ChannelManager::configure(VALID_TABLE));
+
+        Logger::initialize();
+
+        EXPECT_STREQ(_SEGGER_RTT.aUp[1].sName, "Data");
+        EXPECT_EQ(_SEGGER_RTT.aUp[1].SizeOfBuffer, 512U);
+        EXPECT_STREQ(_SEGGER_RTT.aUp[2].sName, "Profiler");
+        EXPECT_EQ(_SEGGER_RTT.aUp[2].Flags, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+    }
+
+    TEST_F(ChannelManagerTest, FindsChannelByName)
+    {
+        ASSERT_TRUE(ChannelManager::configure(VALID_TABLE));
+
+        EXPECT_EQ(ChannelManager::find("Terminal"), 0);
+        EXPECT_EQ(ChannelManager::find("Profiler"), 2);
+        EXPECT_EQ(ChannelManager::find("Trace"), -1);
+    }
+
+    TEST_F(ChannelManagerTest, AnnounceWritesDescriptorTable)
+    {
+        ASSERT_EQ(ChannelManager::claim("Data", 1, 100, ChannelMode::Trim), 1);
+        std::array<char, 256> buffer{};
+        SEGGER_RTT_ConfigUpBuffer(2, "Out", buffer.data(), buffer.size(), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+
+        const size_t written = ChannelManager::announce(2);
+
+        const std::string expected = "RTT_CHANNELS 3\n"
+                                     "RTT_CHANNEL 0 " +
+                                     std::to_string(_SEGGER_RTT.aUp[0].SizeOfBuffer) +
+                                     " skip Terminal\n"
+                                     "RTT_CHANNEL 1 100 trim Data\n"
+                                     "RTT_CHANNEL 2 256 skip Out\n";
+        EXPECT_EQ(written, expected.size());
+        EXPECT_EQ(std::string(buffer.data(), _SEGGER_RTT.aUp[2].WrOff), expected);
+    }
+} // namespace rtt::test
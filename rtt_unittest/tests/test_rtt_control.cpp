@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <string>
+#include <string_view>
+#include "rtt_control/rtt_control.hpp"
+#include "rtt_freertos_trace/rtt_freertos_trace.hpp"
+#include "SEGGER_RTT.h"
+
+#if RTT_MOCK_RTT
+#include "rtt_mock/rtt_mock.hpp"
+#endif
+
+namespace rtt::test
+{
+    using control::Control;
+    using trace::FreeRtosTrace;
+
+    namespace
+    {
+        constexpr unsigned REPLY_CHANNEL{1};
+        constexpr unsigned DATA_CHANNEL{2};
+
+        std::array<char, 1024> g_replies{};
+        std::array<char, 4096> g_data{};
+    } // namespace
+
+    class ControlTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            Control::reset();
+            configureChannels();
+            ASSERT_TRUE(Control::initialize(0, REPLY_CHANNEL));
+            Control::setLogger(m_logger);
+            ASSERT_TRUE(Control::addStream("adc", m_sender));
+        }
+
+        void TearDown() override
+        {
+            Control::reset();
+            FreeRtosTrace::stop();
+            FreeRtosTrace::setCategoryMask(TRACE_CATEGORY_ALL);
+        }
+
+        static void configureChannels()
+        {
+            SEGGER_RTT_ConfigUpBuffer(REPLY_CHANNEL, "Replies", g_replies.data(), g_replies.size(),
+                                      SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+            SEGGER_RTT_ConfigUpBuffer(DATA_CHANNEL, "Data", g_data.data(), g_data.size(),
+                                      SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+            clearReplies();
+        }
+
+        static bool run(std::string_view line)
+        {
+            return Control::execute(line.data(), line.size());
+        }
+
+        // Replies written since the last call
+        static std::string replies()
+        {
+            SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[REPLY_CHANNEL];
+            std::string text(g_replies.data() + up.RdOff, up.WrOff - up.RdOff);
+            clearReplies();
+            return text;
+        }
+
+        static void clearReplies()
+        {
+            _SEGGER_RTT.aUp[REPLY_CHANNEL].RdOff = 0;
+            _SEGGER_RTT.aUp[REPLY_CHANNEL].WrOff = 0;
+        }
+
+        Logger m_logger{0, LogLevel::Info};
+        data::DataSender m_sender{DATA_CHANNEL};
+    };
+
+    TEST_F(ControlTest, LogCommandSetsMinimumLevel)
+    {
+        EXPECT_TRUE(run("log debug"));
+        EXPECT_EQ(m_logger.getMinLevel(), LogLevel::Debug);
+        EXPECT_EQ(replies(), "RTT_CONTROL OK log debug\n");
+
+        EXPECT_TRUE(run("log  4"));
+        EXPECT_EQ(m_logger.getMinLevel(), LogLevel::Error);
+        EXPECT_TRUE(run("log warn"));
+        EXPECT_EQ(m_logger.getMinLevel(), LogLevel::Warning);
+        replies();
+
+        EXPECT_FALSE(run("log loud"));
+        EXPECT_FALSE(run("log 6"));
+        EXPECT_FALSE(run("log"));
+        EXPECT_EQ(m_logger.getMinLevel(), LogLevel::Warning);
+        EXPECT_EQ(replies(), "RTT_CONTROL ERR invalid level: log loud\n"
+                             "RTT_CONTROL ERR invalid level: log 6\n"
+                             "RTT_CONTROL ERR usage: log <level>: log\n");
+    }
+
+    TEST_F(ControlTest, DataCommandsSwitchAndDecimateStreams)
+    {
+        EXPECT_GT(m_sender.sendInt<int32_t>(1), 0U);
+
+        EXPECT_TRUE(run("data adc off"));
+        EXPECT_FALSE(m_sender.isEnabled());
+        EXPECT_EQ(m_sender.sendInt<int32_t>(1), 0U);
+        EXPECT_EQ(m_sender.sendString("dropped"), 0U);
+        const uint8_t bytes[4] = {1, 2, 3, 4};
+        EXPECT_EQ(m_sender.sendMemory(bytes, sizeof(bytes)), 0U);
+
+        EXPECT_TRUE(run("data adc on"));
+        EXPECT_TRUE(run("data adc every 3"));
+        EXPECT_EQ(m_sender.getDecimation(), 3U);
+        size_t sent = 0;
+        for (int i = 0; i < 9; ++i)
+        {
+            sent += m_sender.sendInt<int32_t>(i) > 0 ? 1U : 0U;
+        }
+        EXPECT_EQ(sent, 3U);
+        // Memory regions are not decimated
+        EXPECT_EQ(m_sender.sendMemory(bytes, sizeof(bytes)), data::memoryPacketBytes(sizeof(bytes)));
+
+        EXPECT_TRUE(run("data adc every 1"));
+        EXPECT_GT(m_sender.sendInt<int32_t>(1), 0U);
+        EXPECT_GT(m_sender.sendInt<int32_t>(2), 0U);
+        replies();
+
+        EXPECT_FALSE(run("data dac off"));
+        EXPECT_FALSE(run("data adc every 0"));
+        EXPECT_FALSE(run("data adc every"));
+        EXPECT_FALSE(run("data adc maybe"));
+        EXPECT_FALSE(run("data adc off now"));
+        EXPECT_EQ(replies(), "RTT_CONTROL ERR unknown stream: data dac off\n"
+                             "RTT_CONTROL ERR invalid factor: data adc every 0\n"
+                             "RTT_CONTROL ERR invalid factor: data adc every\n"
+                             "RTT_CONTROL ERR unknown data command: data adc maybe\n"
+                             "RTT_CONTROL ERR unexpected argument: data adc off now\n");
+        EXPECT_TRUE(m_sender.isEnabled());
+    }
+
+    TEST_F(ControlTest, SampleBlockFlushCountsAsOneSample)
+    {
+        data::SampleBlock<uint16_t, 4> block(m_sender);
+        m_sender.setDecimation(2);
+        size_t sent = 0;
+        for (uint16_t i = 0; i < 16; ++i)
+        {
+            SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[DATA_CHANNEL];
+            up.RdOff = up.WrOff;
+            sent += block.push(i) && up.WrOff != up.RdOff ? 1U : 0U;
+        }
+        EXPECT_EQ(sent, 2U);
+    }
+
+    TEST_F(ControlTest, TraceCommandsControlFreeRtosTrace)
+    {
+        // Initializing the trace reinitializes RTT
+        FreeRtosTrace::initialize(DATA_CHANNEL);
+        SEGGER_RTT_ConfigUpBuffer(REPLY_CHANNEL, "Replies", g_replies.data(), g_replies.size(),
+                                  SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        clearReplies();
+
+        EXPECT_TRUE(run("trace mask task isr"));
+        EXPECT_EQ(FreeRtosTrace::getCategoryMask(), static_cast<uint32_t>(TRACE_CATEGORY_TASK | TRACE_CATEGORY_ISR));
+        EXPECT_TRUE(run("trace mask 0x44"));
+        EXPECT_EQ(FreeRtosTrace::getCategoryMask(), static_cast<uint32_t>(TRACE_CATEGORY_QUEUE | TRACE_CATEGORY_HEAP));
+        EXPECT_TRUE(run("trace mask all"));
+        EXPECT_EQ(FreeRtosTrace::getCategoryMask(), static_cast<uint32_t>(TRACE_CATEGORY_ALL));
+
+        EXPECT_TRUE(run("trace start"));
+        EXPECT_TRUE(FreeRtosTrace::isEnabled());
+        EXPECT_TRUE(run("trace registry"));
+        EXPECT_TRUE(run("trace snapshot"));
+        EXPECT_TRUE(run("trace stop"));
+        EXPECT_FALSE(FreeRtosTrace::isEnabled());
+        replies();
+
+        EXPECT_FALSE(run("trace mask 0x80"));
+        EXPECT_FALSE(run("trace mask tasks"));
+        EXPECT_FALSE(run("trace mask"));
+        EXPECT_FALSE(run("trace start now"));
+        EXPECT_FALSE(run("trace pause"));
+        EXPECT_EQ(FreeRtosTrace::getCategoryMask(), static_cast<uint32_t>(TRACE_CATEGORY_ALL));
+        EXPECT_EQ(replies(), "RTT_CONTROL ERR invalid category: trace mask 0x80\n"
+                             "RTT_CONTROL ERR invalid category: trace mask tasks\n"
+                             "RTT_CONTROL ERR usage: trace mask <category>...: trace mask\n"
+                             "RTT_CONTROL ERR unexpected argument: trace start now\n"
+                             "RTT_CONTROL ERR unknown trace command: trace pause\n");
+    }
+
+    TEST_F(ControlTest, RejectsUnknownAndMalformedCommands)
+    {
+        EXPECT_FALSE(run("reboot"));
+        EXPECT_FALSE(run("   "));
+        EXPECT_FALSE(run("trace mask task isr queue semaphore mutex timer heap all none"));
+        EXPECT_FALSE(run(std::string(Control::MAX_LINE, 'x')));
+        EXPECT_EQ(replies(), "RTT_CONTROL ERR unknown command: reboot\n"
+                             "RTT_CONTROL ERR empty command:    \n"
+                             "RTT_CONTROL ERR too many arguments: trace mask task isr queue semaphore mutex timer "
+                             "heap all none\n"
+                             "RTT_CONTROL ERR line too long: " +
+                                 std::string(Control::MAX_LINE - 1, 'x') + "\n");
+    }
+
+    TEST_F(ControlTest, RegistersStreamsByName)
+    {
+        data::DataSender other{DATA_CHANNEL};
+        EXPECT_EQ(Control::findStream("adc"), &m_sender);
+        EXPECT_EQ(Control::findStream("dac"), nullptr);
+        EXPECT_FALSE(Control::addStream("", other));
+        EXPECT_FALSE(Control::addStream("two words", other));
+        EXPECT_FALSE(Control::addStream(nullptr, other));
+
+        EXPECT_TRUE(Control::addStream("adc", other));
+        EXPECT_EQ(Control::findStream("adc"), &other);
+
+        // "adc" holds one slot already
+        std::array<std::string, Control::MAX_STREAMS> names{};
+        for (size_t i = 0; i + 1 < Control::MAX_STREAMS; ++i)
+        {
+            names[i] = "s" + std::to_string(i);
+            EXPECT_TRUE(Control::addStream(names[i].c_str(), other));
+        }
+        EXPECT_FALSE(Control::addStream("full", other));
+    }
+
+    TEST_F(ControlTest, RejectsMissingChannels)
+    {
+        EXPECT_FALSE(Control::initialize(SEGGER_RTT_MAX_NUM_DOWN_BUFFERS));
+        EXPECT_FALSE(Control::initialize(0, SEGGER_RTT_MAX_NUM_UP_BUFFERS));
+    }
+
+#if RTT_MOCK_RTT
+    TEST_F(ControlTest, PollExecutesLinesFromDownBuffer)
+    {
+        using mock::RttMock;
+
+        // Channel 0 has SEGGER's 16 byte terminal buffer: the host sends in pieces
+        EXPECT_EQ(RttMock::sendToTarget(0, "log error\r\nlog"), 14U);
+        EXPECT_EQ(Control::poll(), 1U);
+        EXPECT_EQ(m_logger.getMinLevel(), LogLevel::Error);
+        EXPECT_EQ(RttMock::sendToTarget(0, " trace\n\n"), 8U);
+        EXPECT_EQ(Control::poll(), 1U);
+        EXPECT_EQ(m_logger.getMinLevel(), LogLevel::Trace);
+        EXPECT_EQ(Control::poll(), 0U);
+        EXPECT_EQ(replies(), "RTT_CONTROL OK log error\nRTT_CONTROL OK log trace\n");
+
+        // Lines longer than MAX_LINE are rejected as a whole
+        ASSERT_TRUE(Control::initialize(1, REPLY_CHANNEL));
+        EXPECT_EQ(_SEGGER_RTT.aDown[1].SizeOfBuffer, Control::BUFFER_SIZE);
+        const std::string line = "data adc off " + std::string(Control::MAX_LINE, ' ') + "\n";
+        size_t offset = 0;
+        while (offset < line.size())
+        {
+            offset += RttMock::sendToTarget(1, std::string_view(line).substr(offset));
+            Control::poll();
+        }
+        EXPECT_TRUE(m_sender.isEnabled());
+        EXPECT_EQ(replies().rfind("RTT_CONTROL ERR line too long: data adc off", 0), 0U);
+
+        EXPECT_EQ(RttMock::sendToTarget(1, "data adc off\n"), 13U);
+        rtt_control_poll();
+        EXPECT_FALSE(m_sender.isEnabled());
+    }
+#endif
+} // namespace rtt::test
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "rtt_freertos_trace/rtt_freertos_trace.hpp"
+#include "rtt_timebase/rtt_timebase.hpp"
+#include "SEGGER_RTT.h"
+
+namespace rtt::test
+{
+    using trace::FreeRtosTrace;
+
+    namespace
+    {
+        constexpr uint8_t TRACE_CHANNEL{2};
+        constexpr char REGISTRY_MARKER[] = "TASK_REGISTRY_BIN\n";
+
+        std::array<char, 4096> g_buffer{};
+
+        using Registry = std::vector<std::pair<uint32_t, std::string>>;
+
+        // Decode every binary registry block written to the trace channel
+        std::vector<Registry> sentRegistries()
+        {
+            std::vector<Registry> registries;
+            const size_t end = _SEGGER_RTT.aUp[TRACE_CHANNEL].WrOff;
+            const std::string data(g_buffer.data(), end);
+            for (size_t offset = data.find(REGISTRY_MARKER); offset != std::string::npos;
+                 offset = data.find(REGISTRY_MARKER, offset))
+            {
+                offset += sizeof(REGISTRY_MARKER) - 1;
+                const auto count = static_cast<uint8_t>(data[offset++]);
+                Registry registry;
+                for (uint8_t i = 0; i < count; ++i)
+                {
+                    uint32_t handle = 0;
+                    std::memcpy(&handle, &data[offset], sizeof(handle));
+                    const auto length = static_cast<uint8_t>(data[offset + sizeof(handle)]);
+                    offset += sizeof(handle) + 1;
+                    registry.emplace_back(handle, data.substr(offset, length));
+                    offset += length;
+                }
+                registries.push_back(registry);
+            }
+            return registries;
+        }
+
+        int indexOf(const Registry& registry, uint32_t handle)
+        {
+            for (size_t i = 0; i < registry.size(); ++i)
+            {
+                if (registry[i].first == handle)
+                {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+    } // namespace
+
+    class FreeRtosTraceRegistryTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            FreeRtosTrace::setMode(TRACE_MODE_SKIP);
+            FreeRtosTrace::initialize(TRACE_CHANNEL);
+            SEGGER_RTT_ConfigUpBuffer(TRACE_CHANNEL, "Trace", g_buffer.data(), g_buffer.size(),
+                                      SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+            clearChannel();
+        }
+
+        void TearDown() override
+        {
+            FreeRtosTrace::stop();
+            FreeRtosTrace::setRegistryInterval(0);
+        }
+
+        static void clearChannel()
+        {
+            _SEGGER_RTT.aUp[TRACE_CHANNEL].RdOff = 0;
+            _SEGGER_RTT.aUp[TRACE_CHANNEL].WrOff = 0;
+        }
+    };
+
+    TEST_F(FreeRtosTraceRegistryTest, StartSendsBinaryRegistry)
+    {
+        // Fixed-size name arrays as in the TCB: the name ends at the terminator
+        const char tcbName[16] = "beta\0stale";
+        FreeRtosTrace::registerTask(0x20001000, "alpha");
+        rtt_trace_register_task(0x20002000, tcbName, sizeof(tcbName));
+        rtt_trace_register_task(0x20003000, "a-name-longer-than-the-entry", 28);
+
+        FreeRtosTrace::start();
+        const auto registries = sentRegistries();
+        ASSERT_EQ(registries.size(), 1U);
+        const Registry& registry = registries[0];
+        ASSERT_GE(indexOf(registry, 0x20001000), 0);
+        EXPECT_EQ(registry[indexOf(registry, 0x20001000)].second, "alpha");
+        EXPECT_EQ(registry[indexOf(registry, 0x20002000)].second, "beta");
+        EXPECT_EQ(registry[indexOf(registry, 0x20003000)].second, "a-name-longer-t");
+    }
+
+    TEST_F(FreeRtosTraceRegistryTest, ResendsWhenTasksChangeWhileTracing)
+    {
+        FreeRtosTrace::start();
+        const size_t known = sentRegistries().at(0).size();
+        clearChannel();
+
+        FreeRtosTrace::registerTask(0x20004000, "gamma");
+        EXPECT_TRUE(sentRegistries().empty()); // Sent by the drain, not from the hook
+        FreeRtosTrace::drain();
+        auto registries = sentRegistries();
+        ASSERT_EQ(registries.size(), 1U);
+        ASSERT_EQ(registries[0].size(), known + 1);
+        const int index = indexOf(registries[0], 0x20004000);
+        EXPECT_EQ(index, static_cast<int>(known));
+
+        // A task reusing the TCB takes over the entry and its index
+        clearChannel();
+        FreeRtosTrace::registerTask(0x20004000, "delta");
+        FreeRtosTrace::drain();
+        registries = sentRegistries();
+        ASSERT_EQ(registries.size(), 1U);
+        EXPECT_EQ(registries[0].size(), known + 1);
+        EXPECT_EQ(registries[0][index].second, "delta");
+
+        clearChannel();
+        FreeRtosTrace::drain();
+        EXPECT_TRUE(sentRegistries().empty());
+    }
+
+    TEST_F(FreeRtosTraceRegistryTest, DeletedTasksFreeTheirEntries)
+    {
+        FreeRtosTrace::registerTask(0x20005000, "keep");
+        FreeRtosTrace::start();
+        const size_t known = sentRegistries().at(0).size();
+
+        // More create/delete cycles than the registry has entries (RTT_TRACE_MAX_TASKS is at most 254)
+        for (uint32_t i = 0; i < 300; ++i)
+        {
+            FreeRtosTrace::registerTask(0x30000000 + i * 0x40, "worker");
+            FreeRtosTrace::unregisterTask(0x30000000 + i * 0x40);
+        }
+        clearChannel();
+        FreeRtosTrace::registerTask(0x30010000, "last");
+        FreeRtosTrace::drain();
+        auto registries = sentRegistries();
+        ASSERT_EQ(registries.size(), 1U);
+        ASSERT_EQ(registries[0].size(), known + 1);
+        EXPECT_EQ(registries[0][indexOf(registries[0], 0x30010000)].second, "last");
+        EXPECT_EQ(indexOf(registries[0], 0x30000000), -1);
+
+        // Deleting an earlier task moves the last entry into its index; the others stay found
+        clearChannel();
+        const int freed = indexOf(registries[0], 0x20005000);
+        FreeRtosTrace::unregisterTask(0x20005000);
+        FreeRtosTrace::drain();
+        const Registry before = registries[0];
+        registries = sentRegistries();
+        ASSERT_EQ(registries.size(), 1U);
+        ASSERT_EQ(registries[0].size(), known);
+        EXPECT_EQ(registries[0][freed].first, 0x30010000U);
+        for (const auto& [handle, name] : before)
+        {
+            if (handle != 0x20005000)
+            {
+                EXPECT_EQ(registries[0][indexOf(registries[0], handle)].second, name);
+                FreeRtosTrace::registerTask(handle, name); // Known handles keep their entry
+            }
+        }
+        clearChannel();
+        FreeRtosTrace::drain();
+        ASSERT_EQ(sentRegistries().size(), 1U);
+        EXPECT_EQ(sentRegistries()[0].size(), known);
+        FreeRtosTrace::unregisterTask(0x30010000);
+    }
+
+    TEST_F(FreeRtosTraceRegistryTest, ResendsOnRequestAndInterval)
+    {
+        FreeRtosTrace::start();
+        clearChannel();
+
+        FreeRtosTrace::requestRegistry();
+        FreeRtosTrace::drain();
+        EXPECT_EQ(sentRegistries().size(), 1U);
+
+        clearChannel();
+        FreeRtosTrace::setRegistryInterval(1);
+        const uint32_t sentAt = Timebase::now32();
+        while (Timebase::now32() == sentAt)
+        {
+        }
+        FreeRtosTrace::drain();
+        EXPECT_EQ(sentRegistries().size(), 1U);
+
+        // Not repeated after the trace stopped
+        FreeRtosTrace::stop();
+        clearChannel();
+        FreeRtosTrace::drain();
+        EXPECT_TRUE(sentRegistries().empty());
+    }
+
+    TEST_F(FreeRtosTraceRegistryTest, SkipsRegistryThatDoesNotFit)
+    {
+        FreeRtosTrace::start();
+
+        // Leave less room than the registry needs; it stays pending until the host reads
+        auto& up = _SEGGER_RTT.aUp[TRACE_CHANNEL];
+        up.WrOff = 8;
+        up.RdOff = 16;
+        FreeRtosTrace::requestRegistry();
+        FreeRtosTrace::drain();
+        EXPECT_EQ(up.WrOff, 8U);
+
+        clearChannel();
+        FreeRtosTrace::drain();
+        EXPECT_EQ(sentRegistries().size(), 1U);
+    }
+} // namespace rtt::test
@@ -0,0 +1,607 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "rtt_host/data_stream.hpp"
+#include "rtt_host/mapped_file.hpp"
+#include "rtt_host/perfetto_writer.hpp"
+#include "rtt_host/trace_analysis.hpp"
+#include "rtt_host/trace_decoder.hpp"
+
+#if RTT_MOCK_RTT
+#include "rtt_freertos_trace/rtt_freertos_trace.hpp"
+#include "rtt_mock/rtt_mock.hpp"
+#include "SEGGER_RTT.h"
+#endif
+
+namespace rtt::host::test
+{
+    namespace
+    {
+        using Bytes = std::vector<uint8_t>;
+
+        void append(Bytes& bytes, const std::string& text)
+        {
+            bytes.insert(bytes.end(), text.begin(), text.end());
+        }
+
+        void appendV1(Bytes& bytes, uint8_t type, uint32_t timestamp, uint32_t handle, uint32_t data = 0)
+        {
+            const TraceEvent event{type, timestamp, handle, data};
+            const auto* raw = reinterpret_cast<const uint8_t*>(&event);
+            bytes.insert(bytes.end(), raw, raw + sizeof(event));
+        }
+
+        void appendVarint(Bytes& bytes, uint64_t value)
+        {
+            while (value >= 0x80U)
+            {
+                bytes.push_back(static_cast<uint8_t>(value | 0x80U));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+
+        void appendSync(Bytes& bytes, uint32_t timestamp)
+        {
+            bytes.push_back(0x7E);
+            const auto* raw = reinterpret_cast<const uint8_t*>(&timestamp);
+            bytes.insert(bytes.end(), raw, raw + sizeof(timestamp));
+        }
+
+        // handle is the encoded varint: (index << 1) | 1 or handle << 1
+        void appendV2(Bytes& bytes, uint8_t type, int32_t delta, uint64_t handle, uint32_t data = 0)
+        {
+            bytes.push_back(static_cast<uint8_t>(type | (data != 0 ? 0x80U : 0U)));
+            appendVarint(bytes, (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+            appendVarint(bytes, handle);
+            if (data != 0)
+            {
+                appendVarint(bytes, data);
+            }
+        }
+
+        void appendRegistry(Bytes& bytes, const std::vector<std::pair<uint32_t, std::string>>& tasks)
+        {
+            append(bytes, "TASK_REGISTRY_BIN\n");
+            bytes.push_back(static_cast<uint8_t>(tasks.size()));
+            for (const auto& [handle, name] : tasks)
+            {
+                const auto* raw = reinterpret_cast<const uint8_t*>(&handle);
+                bytes.insert(bytes.end(), raw, raw + sizeof(handle));
+                bytes.push_back(static_cast<uint8_t>(name.size()));
+                append(bytes, name);
+            }
+        }
+
+        std::vector<TraceRecord> decodeAll(TraceDecoder& decoder, size_t capacity = 3)
+        {
+            std::vector<TraceRecord> records;
+            std::vector<TraceRecord> block(capacity);
+            for (size_t count = decoder.next(block.data(), block.size()); count != 0;
+                 count = decoder.next(block.data(), block.size()))
+            {
+                records.insert(records.end(), block.begin(), block.begin() + static_cast<std::ptrdiff_t>(count));
+            }
+            return records;
+        }
+
+        std::string tempPath(const char* name)
+        {
+            return ::testing::TempDir() + name;
+        }
+
+        void writeFile(const std::string& path, const Bytes& bytes)
+        {
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            ASSERT_NE(file, nullptr);
+            if (!bytes.empty())
+            {
+                ASSERT_EQ(std::fwrite(bytes.data(), 1, bytes.size(), file), bytes.size());
+            }
+            std::fclose(file);
+        }
+
+        // Trace with task switches, ISRs, a registry resend and a gap, spread over many blocks
+        Bytes syntheticV2Trace(size_t periods)
+        {
+            Bytes bytes;
+            append(bytes, "RTT_TRACE_V2\n");
+            appendRegistry(bytes, {{0x20001000, "idle"}, {0x20002000, "worker"}, {0x20003000, "net"}});
+            appendSync(bytes, 0xFFFF0000U); // Wraps during the trace
+            for (size_t i = 0; i < periods; ++i)
+            {
+                const uint64_t index = (i % 3) << 1 | 1U;
+                appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 10, index);
+                if (i % 5 == 0)
+                {
+                    appendV2(bytes, TRACE_EVENT_ISR_ENTER, 3, 15U << 1);
+                    appendV2(bytes, TRACE_EVENT_ISR_EXIT, static_cast<int32_t>(2 + i % 4), 15U << 1);
+                }
+                if (i % 17 == 0)
+                {
+                    // Switched in twice: unmatched SWITCHED_IN
+                    appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 1, index);
+                }
+                if (i % 97 == 0)
+                {
+                    appendV2(bytes, TRACE_EVENT_EVENTS_LOST, 4, 0, static_cast<uint32_t>(i + 1));
+                    appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, 2, index); // Unmatched
+                    continue;
+                }
+                appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, static_cast<int32_t>(50 + i % 7), index);
+            }
+            appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 10, 1U); // Still running at the end
+            appendV2(bytes, TRACE_EVENT_QUEUE_SEND, 25, 0x20008000U << 1);
+            return bytes;
+        }
+
+        void expectSameSummary(const TraceSummary& a, const TraceSummary& b)
+        {
+            EXPECT_EQ(a.events, b.events);
+            EXPECT_EQ(a.firstTimestamp, b.firstTimestamp);
+            EXPECT_EQ(a.lastTimestamp, b.lastTimestamp);
+            EXPECT_EQ(a.gaps, b.gaps);
+            EXPECT_EQ(a.lostEvents, b.lostEvents);
+            EXPECT_EQ(a.typeCounts, b.typeCounts);
+            EXPECT_EQ(a.unmatchedIn, b.unmatchedIn);
+            EXPECT_EQ(a.unmatchedOut, b.unmatchedOut);
+            EXPECT_EQ(a.isrCount, b.isrCount);
+            EXPECT_EQ(a.isrDurations.count, b.isrDurations.count);
+            EXPECT_EQ(a.isrDurations.total, b.isrDurations.total);
+            ASSERT_EQ(a.tasks.size(), b.tasks.size());
+            for (const auto& [handle, stats] : a.tasks)
+            {
+                ASSERT_EQ(b.tasks.count(handle), 1U) << handle;
+                const DurationStats& other = b.tasks.at(handle);
+                EXPECT_EQ(stats.count, other.count) << handle;
+                EXPECT_EQ(stats.total, other.total) << handle;
+                EXPECT_EQ(stats.min, other.min) << handle;
+                EXPECT_EQ(stats.max, other.max) << handle;
+            }
+        }
+
+        bool readVarint(const Bytes& bytes, size_t& offset, uint64_t& value)
+        {
+            value = 0;
+            for (unsigned shift = 0; offset < bytes.size() && shift < 64; shift += 7)
+            {
+                const uint8_t byte = bytes[offset++];
+                value |= static_cast<uint64_t>(byte & 0x7FU) << shift;
+                if ((byte & 0x80U) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        struct Field
+        {
+            uint32_t number;
+            uint64_t value; // Varint value or length
+            Bytes bytes; // Length-delimited content
+        };
+
+        // Minimal protobuf reader for varint and length-delimited fields
+        bool parseFields(const Bytes& bytes, std::vector<Field>& fields)
+        {
+            size_t offset = 0;
+            while (offset < bytes.size())
+            {
+                uint64_t key = 0;
+                Field field{};
+                if (!readVarint(bytes, offset, key) || !readVarint(bytes, offset, field.value))
+                {
+                    return false;
+                }
+                field.number = static_cast<uint32_t>(key >> 3);
+                if ((key & 7U) == 2U)
+                {
+                    if (field.value > bytes.size() - offset)
+                    {
+                        return false;
+                    }
+                    field.bytes.assign(bytes.begin() + static_cast<std::ptrdiff_t>(offset),
+                                       bytes.begin() + static_cast<std::ptrdiff_t>(offset + field.value));
+                    offset += field.value;
+                }
+                else if ((key & 7U) != 0U)
+                {
+                    return false;
+                }
+                fields.push_back(std::move(field));
+            }
+            return true;
+        }
+
+        const Field* findField(const std::vector<Field>& fields, uint32_t number)
+        {
+            for (const Field& field : fields)
+            {
+                if (field.number == number)
+                {
+                    return &field;
+                }
+            }
+            return nullptr;
+        }
+    } // namespace
+
+    TEST(RttHostTest, MappedFileMapsCapture)
+    {
+        const std::string path = tempPath("rtt_host_mapped.bin");
+        writeFile(path, {'a', 'b', 'c'});
+
+        MappedFile file;
+        ASSERT_TRUE(file.open(path.c_str()));
+        ASSERT_EQ(file.size(), 3U);
+        EXPECT_EQ(std::memcmp(file.data(), "abc", 3), 0);
+
+        // Moving transfers the mapping
+        MappedFile moved(std::move(file));
+        EXPECT_FALSE(file.isOpen());
+        EXPECT_TRUE(moved.isOpen());
+        EXPECT_EQ(moved.size(), 3U);
+
+        writeFile(path, {});
+        ASSERT_TRUE(moved.open(path.c_str()));
+        EXPECT_EQ(moved.size(), 0U);
+        EXPECT_EQ(moved.data(), nullptr);
+
+        std::remove(path.c_str());
+        EXPECT_FALSE(moved.open(path.c_str()));
+        EXPECT_FALSE(moved.isOpen());
+    }
+
+    TEST(RttHostTest, DataStreamSkipsBytesBetweenPackets)
+    {
+        Bytes bytes;
+        append(bytes, "boot R\n");
+        auto appendPacket = [&bytes](data::DataType type, const std::string& payload, uint32_t timestamp) {
+            data::DataHeader header{{data::DATA_MAGIC_0, data::DATA_MAGIC_1}, type, 0,
+                                    static_cast<uint32_t>(payload.size()), timestamp};
+            const auto* raw = reinterpret_cast<const uint8_t*>(&header);
+            bytes.insert(bytes.end(), raw, raw + sizeof(header));
+            append(bytes, payload);
+        };
+        appendPacket(data::DataType::String, "hello", 7);
+        append(bytes, "RDx"); // Magic with an unknown type
+        appendPacket(data::DataType::UInt32, std::string("\x2A\0\0\0", 4), 9);
+        appendPacket(data::DataType::Binary, "cut off", 11);
+        bytes.resize(bytes.size() - 3);
+
+        DataStream stream(bytes.data(), bytes.size());
+        DataPacket packet{};
+        ASSERT_TRUE(stream.next(packet));
+        EXPECT_EQ(packet.header.type, data::DataType::String);
+        EXPECT_EQ(packet.header.timestamp, 7U);
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(packet.payload), packet.header.size), "hello");
+        EXPECT_EQ(packet.offset, 7U);
+        EXPECT_EQ(packet.payload, bytes.data() + 7 + sizeof(data::DataHeader));
+
+        ASSERT_TRUE(stream.next(packet));
+        EXPECT_EQ(packet.header.type, data::DataType::UInt32);
+        uint32_t value = 0;
+        std::memcpy(&value, packet.payload, sizeof(value));
+        EXPECT_EQ(value, 42U);
+
+        // The truncated packet is not returned
+        EXPECT_FALSE(stream.next(packet));
+        EXPECT_GE(stream.getSkippedBytes(), 7U + 3U);
+    }
+
+    TEST(RttHostTest, DecodesV1WithMarkersRegistryAndResync)
+    {
+        Bytes bytes;
+        append(bytes, "RTT_TRACE_V1\nTRACE_START\n");
+        append(bytes, "TASK_REGISTRY_START\nTASK:536875008:idle\nTASK:536879104:worker \nTASK_REGISTRY_END\n");
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 100, 0x20001000);
+        bytes.push_back(0xEE); // Lost byte
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, 150, 0x20001000);
+        appendRegistry(bytes, {{0x20003000, "net"}});
+        append(bytes, "TRACE_STOP\n");
+        appendV1(bytes, TRACE_EVENT_MALLOC, 160, 0x20010000, 64);
+
+        TraceDecoder decoder(bytes.data(), bytes.size());
+        EXPECT_EQ(decoder.getEncoding(), TraceEncoding::V1);
+        const auto records = decodeAll(decoder);
+        ASSERT_EQ(records.size(), 3U);
+        EXPECT_EQ(records[0].type, TRACE_EVENT_TASK_SWITCHED_IN);
+        EXPECT_EQ(records[0].timestamp, 100U);
+        EXPECT_EQ(records[1].type, TRACE_EVENT_TASK_SWITCHED_OUT);
+        EXPECT_EQ(records[1].timestamp, 150U);
+        EXPECT_EQ(records[2].type, TRACE_EVENT_MALLOC);
+        EXPECT_EQ(records[2].handle, 0x20010000U);
+        EXPECT_EQ(records[2].data, 64U);
+
+        EXPECT_EQ(decoder.getTaskName(0x20001000), "idle");
+        EXPECT_EQ(decoder.getTaskName(0x20002000), "worker");
+        EXPECT_EQ(decoder.getTaskName(0x20003000), "net");
+        EXPECT_EQ(decoder.getTaskName(0x20004000), "Task_0x20004000");
+        EXPECT_EQ(decoder.getOffset(), bytes.size());
+    }
+
+    TEST(RttHostTest, ExtendsTimestampsAcrossCounterWraps)
+    {
+        Bytes bytes;
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 0xFFFFFF00U, 1);
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, 0x00000100U, 1); // Wrapped
+        appendV1(bytes, TRACE_EVENT_ISR_ENTER, 0x000000F0U, 2); // Slightly out of order
+        appendV1(bytes, TRACE_EVENT_ISR_EXIT, 0x80000000U, 2);
+        appendV1(bytes, TRACE_EVENT_QUEUE_SEND, 0xF0000000U, 3);
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 0x00000200U, 1); // Second wrap
+
+        TraceDecoder decoder(bytes.data(), bytes.size());
+        const auto records = decodeAll(decoder);
+        ASSERT_EQ(records.size(), 6U);
+        EXPECT_EQ(records[0].timestamp, 0xFFFFFF00ULL);
+        EXPECT_EQ(records[1].timestamp, 0x100000100ULL);
+        EXPECT_EQ(records[2].timestamp, 0x1000000F0ULL);
+        EXPECT_EQ(records[3].timestamp, 0x180000000ULL);
+        EXPECT_EQ(records[4].timestamp, 0x1F0000000ULL);
+        EXPECT_EQ(records[5].timestamp, 0x200000200ULL);
+    }
+
+    TEST(RttHostTest, DecodesV2WithRegistryIndicesAndSync)
+    {
+        Bytes bytes;
+        append(bytes, "boot text\nRTT_TRACE_V2\nTRACE_START\n");
+        appendRegistry(bytes, {{0x20001000, "idle"}, {0x20002000, "worker"}});
+        appendSync(bytes, 1000);
+        appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 5, 1U << 1 | 1U); // Index 1
+        appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, 20, 1U << 1 | 1U);
+        appendV2(bytes, TRACE_EVENT_ISR_ENTER, -3, 0x2AU << 1); // Raw handle, out of order
+        appendV2(bytes, TRACE_EVENT_EVENTS_LOST, 1, 0, 300);
+
+        // Garbage loses the framing until the next sync record
+        bytes.push_back(0x00);
+        appendV2(bytes, TRACE_EVENT_QUEUE_SEND, 1, 0);
+        appendSync(bytes, 5000);
+        // A resent registry replaces the index mapping
+        appendRegistry(bytes, {{0x20003000, "net"}});
+        appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 0, 1U);
+        appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 1, 7U << 1 | 1U); // Index past the registry
+        // Truncated record at the end
+        bytes.push_back(TRACE_EVENT_TASK_SWITCHED_OUT);
+        bytes.push_back(0x80);
+
+        TraceDecoder decoder(bytes.data(), bytes.size());
+        EXPECT_EQ(decoder.getEncoding(), TraceEncoding::V2);
+        const auto records = decodeAll(decoder);
+        ASSERT_EQ(records.size(), 6U);
+        EXPECT_EQ(records[0].timestamp, 1005U);
+        EXPECT_EQ(records[0].handle, 0x20002000U);
+        EXPECT_EQ(records[1].timestamp, 1025U);
+        EXPECT_EQ(records[2].type, TRACE_EVENT_ISR_ENTER);
+        EXPECT_EQ(records[2].timestamp, 1022U);
+        EXPECT_EQ(records[2].handle, 0x2AU);
+        EXPECT_EQ(records[3].type, TRACE_EVENT_EVENTS_LOST);
+        EXPECT_EQ(records[3].data, 300U);
+        EXPECT_EQ(records[4].timestamp, 5000U);
+        EXPECT_EQ(records[4].handle, 0x20003000U);
+        EXPECT_EQ(records[5].handle, 7U);
+        EXPECT_EQ(decoder.getTaskName(0x20001000), "idle");
+        EXPECT_EQ(decoder.getOffset(), bytes.size());
+    }
+
+    TEST(RttHostTest, AnalysisMatchesPythonAnalyzerSemantics)
+    {
+        Bytes bytes;
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, 10, 1); // Nothing running: unmatched
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 100, 1);
+        appendV1(bytes, TRACE_EVENT_ISR_ENTER, 110, 0);
+        appendV1(bytes, TRACE_EVENT_ISR_EXIT, 115, 0);
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, 150, 1);
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 200, 2);
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 210, 3); // Task 2 never switched out: unmatched
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, 240, 2); // Attributed to task 2
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 300, 1);
+        appendV1(bytes, TRACE_EVENT_ISR_ENTER, 305, 0);
+        appendV1(bytes, TRACE_EVENT_EVENTS_LOST, 320, 0, 12); // Ends task 1 and the ISR uncounted
+        appendV1(bytes, TRACE_EVENT_ISR_EXIT, 330, 0);
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_OUT, 340, 1);
+        appendV1(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 400, 3);
+        appendV1(bytes, TRACE_EVENT_QUEUE_SEND, 425, 9); // Task 3 runs until the last event
+
+        for (size_t blockSize : {1U, 2U, 5U, 65536U})
+        {
+            TraceDecoder decoder(bytes.data(), bytes.size());
+            AnalysisOptions options;
+            options.threads = 1;
+            options.blockSize = blockSize;
+            const TraceSummary summary = analyzeTrace(decoder, options);
+
+            EXPECT_EQ(summary.events, 15U);
+            EXPECT_EQ(summary.firstTimestamp, 10U);
+            EXPECT_EQ(summary.lastTimestamp, 425U);
+            EXPECT_EQ(summary.gaps, 1U);
+            EXPECT_EQ(summary.lostEvents, 12U);
+            EXPECT_EQ(summary.typeCounts[TRACE_EVENT_TASK_SWITCHED_IN], 5U);
+            EXPECT_EQ(summary.unmatchedIn, 1U);
+            EXPECT_EQ(summary.unmatchedOut, 2U);
+            ASSERT_EQ(summary.tasks.size(), 3U);
+            EXPECT_EQ(summary.tasks.at(1).count, 1U);
+            EXPECT_EQ(summary.tasks.at(1).total, 50U);
+            EXPECT_EQ(summary.tasks.at(2).total, 30U);
+            EXPECT_EQ(summary.tasks.at(3).count, 1U);
+            EXPECT_EQ(summary.tasks.at(3).total, 25U);
+            EXPECT_EQ(summary.isrCount, 2U);
+            EXPECT_EQ(summary.isrDurations.count, 1U);
+            EXPECT_EQ(summary.isrDurations.total, 5U);
+        }
+    }
+
+    TEST(RttHostTest, ParallelAnalysisMatchesSequential)
+    {
+        const Bytes bytes = syntheticV2Trace(5000);
+
+        TraceDecoder sequentialDecoder(bytes.data(), bytes.size());
+        AnalysisOptions sequential;
+        sequential.threads = 1;
+        size_t streamed = 0;
+        sequential.onBlock = [&streamed](const TraceRecord*, size_t count) { streamed += count; };
+        const TraceSummary expected = analyzeTrace(sequentialDecoder, sequential);
+        EXPECT_EQ(streamed, expected.events);
+        EXPECT_GT(expected.unmatchedIn, 0U);
+        EXPECT_GT(expected.unmatchedOut, 0U);
+        EXPECT_EQ(expected.tasks.size(), 3U);
+        EXPECT_GT(expected.lastTimestamp, 0xFFFFFFFFULL);
+
+        // Odd block sizes put task and ISR pairs across block boundaries
+        for (size_t blockSize : {1U, 7U, 64U, 1000U})
+        {
+            TraceDecoder decoder(bytes.data(), bytes.size());
+            AnalysisOptions parallel;
+            parallel.threads = 4;
+            parallel.blockSize = blockSize;
+            uint64_t previous = 0;
+            bool ordered = true;
+            parallel.onBlock = [&](const TraceRecord* records, size_t count) {
+                ordered = ordered && records[0].timestamp >= previous;
+                previous = records[count - 1].timestamp;
+            };
+            expectSameSummary(expected, analyzeTrace(decoder, parallel));
+            EXPECT_TRUE(ordered);
+
+            TraceDecoder recordDecoder(bytes.data(), bytes.size());
+            const auto records = decodeAll(recordDecoder, 4096);
+            expectSameSummary(expected, analyzeRecords(records.data(), records.size(), parallel));
+        }
+    }
+
+    TEST(RttHostTest, PerfettoWriterStreamsTrackEvents)
+    {
+        Bytes bytes;
+        append(bytes, "RTT_TRACE_V2\n");
+        appendRegistry(bytes, {{0x20001000, "idle"}});
+        appendSync(bytes, 1000);
+        appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 0, 1U);
+        appendV2(bytes, TRACE_EVENT_MALLOC, 10, 0x20010000U << 1, 64);
+        appendV2(bytes, TRACE_EVENT_ISR_ENTER, 10, 0);
+        appendV2(bytes, TRACE_EVENT_FREE, 10, 0x20010000U << 1);
+        appendV2(bytes, TRACE_EVENT_EVENTS_LOST, 10, 0, 3); // Closes the task and ISR slices
+        appendV2(bytes, TRACE_EVENT_TASK_SWITCHED_IN, 10, 0x20005000U << 1); // Left open at the end
+
+        const std::string path = tempPath("rtt_host_trace.pftrace");
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        TraceDecoder decoder(bytes.data(), bytes.size());
+        PerfettoWriter writer(file, decoder, 1000000); // 1 MHz: 1 tick = 1 us
+        const auto records = decodeAll(decoder);
+        writer.write(records.data(), records.size());
+        ASSERT_TRUE(writer.finish());
+        std::fclose(file);
+
+        MappedFile output;
+        ASSERT_TRUE(output.open(path.c_str()));
+        const Bytes trace(output.data(), output.data() + output.size());
+        std::vector<Field> packets;
+        ASSERT_TRUE(parseFields(trace, packets));
+        EXPECT_EQ(packets.size(), writer.getPacketCount());
+
+        std::map<std::string, uint64_t> tracks;
+        std::map<uint64_t, int> depth;
+        std::vector<int64_t> counters;
+        uint64_t firstTimestamp = UINT64_MAX;
+        for (const Field& packet : packets)
+        {
+            ASSERT_EQ(packet.number, 1U);
+            std::vector<Field> fields;
+            ASSERT_TRUE(parseFields(packet.bytes, fields));
+            if (const Field* descriptor = findField(fields, 60))
+            {
+                std::vector<Field> track;
+                ASSERT_TRUE(parseFields(descriptor->bytes, track));
+                const Field* name = findField(track, 2);
+                ASSERT_NE(name, nullptr);
+                tracks[std::string(name->bytes.begin(), name->bytes.end())] = findField(track, 1)->value;
+                continue;
+            }
+
+            const Field* timestamp = findField(fields, 8);
+            const Field* event = findField(fields, 11);
+            ASSERT_NE(timestamp, nullptr);
+            ASSERT_NE(event, nullptr);
+            ASSERT_NE(findField(fields, 10), nullptr);
+            firstTimestamp = std::min(firstTimestamp, timestamp->value);
+            std::vector<Field> values;
+            ASSERT_TRUE(parseFields(event->bytes, values));
+            const uint64_t type = findField(values, 9)->value;
+            const uint64_t track = findField(values, 11)->value;
+            if (type == 1U)
+            {
+                ++depth[track];
+            }
+            else if (type == 2U)
+            {
+                ASSERT_GT(depth[track], 0);
+                --depth[track];
+            }
+            else if (type == 4U)
+            {
+                counters.push_back(static_cast<int64_t>(findField(values, 30)->value));
+            }
+        }
+
+        EXPECT_EQ(tracks.count("idle"), 1U);
+        EXPECT_EQ(tracks.count("Task_0x20005000"), 1U);
+        EXPECT_EQ(tracks.count("ISR"), 1U);
+        EXPECT_EQ(tracks.count("Memory Usage"), 1U);
+        EXPECT_EQ(firstTimestamp, 1000000U); // 1000 ticks at 1 MHz in ns
+        EXPECT_EQ(counters, (std::vector<int64_t>{64, 0}));
+        for (const auto& [track, open] : depth)
+        {
+            EXPECT_EQ(open, 0) << track;
+        }
+        std::remove(path.c_str());
+    }
+
+#if RTT_MOCK_RTT
+    TEST(RttHostTest, DecodesFirmwareTraceCapture)
+    {
+        constexpr uint8_t CHANNEL{2};
+        static std::array<char, 4096> buffer{};
+
+        mock::RttMock::reset();
+        trace::FreeRtosTrace::setMode(TRACE_MODE_SKIP);
+        trace::FreeRtosTrace::initialize(CHANNEL);
+        SEGGER_RTT_ConfigUpBuffer(CHANNEL, "Trace", buffer.data(), buffer.size(), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        mock::RttMock::startCapture(CHANNEL);
+
+        trace::FreeRtosTrace::registerTask(0x20001000, "capture");
+        trace::FreeRtosTrace::start();
+        for (uint32_t i = 0; i < 50; ++i)
+        {
+            trace::FreeRtosTrace::recordEvent(TRACE_EVENT_TASK_SWITCHED_IN, 0x20001000);
+            trace::FreeRtosTrace::recordEvent(TRACE_EVENT_QUEUE_SEND, 0x20009000, i + 1);
+            trace::FreeRtosTrace::recordEvent(TRACE_EVENT_TASK_SWITCHED_OUT, 0x20001000);
+        }
+        trace::FreeRtosTrace::drain();
+        trace::FreeRtosTrace::stop();
+
+        const std::string capture(mock::RttMock::captured(CHANNEL));
+        mock::RttMock::reset();
+
+        const auto* data = reinterpret_cast<const uint8_t*>(capture.data());
+        TraceDecoder decoder(data, capture.size());
+        AnalysisOptions options;
+        options.threads = 2;
+        options.blockSize = 16;
+        const TraceSummary summary = analyzeTrace(decoder, options);
+
+        EXPECT_EQ(summary.events, 150U);
+        EXPECT_EQ(summary.typeCounts[TRACE_EVENT_QUEUE_SEND], 50U);
+        EXPECT_EQ(summary.unmatchedIn, 0U);
+        EXPECT_EQ(summary.unmatchedOut, 0U);
+        ASSERT_EQ(summary.tasks.count(0x20001000), 1U);
+        EXPECT_EQ(summary.tasks.at(0x20001000).count, 50U);
+        EXPECT_GE(summary.lastTimestamp, summary.firstTimestamp);
+        EXPECT_EQ(decoder.getTaskName(0x20001000), "capture");
+    }
+#endif // RTT_MOCK_RTT
+} // namespace rtt::host::test
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <cstring>
+#include <string>
 #include "rtt_logger/rtt_logger.hpp"
 
 namespace rtt::test
@@ -66,4 +68,189 @@ namespace rtt::test
         // Should write some data or return 0 if buffer full
         EXPECT_GE(written, 0);
     }
+
+    TEST_F(RttLoggerTest, DeferredHeaderLayout)
+    {
+        EXPECT_EQ(sizeof(DeferredLogHeader), 12U);
+    }
+
+    TEST_F(RttLoggerTest, DeferredArgTypes)
+    {
+        EXPECT_EQ(detail::deferredArgType<int>(), DeferredArgType::Int32);
+        EXPECT_EQ(detail::deferredArgType<uint16_t>(), DeferredArgType::UInt32);
+        EXPECT_EQ(detail::deferredArgType<int64_t>(), DeferredArgType::Int64);
+        EXPECT_EQ(detail::deferredArgType<uint64_t>(), DeferredArgType::UInt64);
+        EXPECT_EQ(detail::deferredArgType<float>(), DeferredArgType::Float);
+        EXPECT_EQ(detail::deferredArgType<double>(), DeferredArgType::Double);
+        EXPECT_EQ(detail::deferredArgType<const char*>(), DeferredArgType::String);
+        EXPECT_EQ(detail::deferredArgType<const void*>(), DeferredArgType::Pointer);
+    }
+
+    TEST_F(RttLoggerTest, DeferredRecordEncoding)
+    {
+        static const char format[] = "v=%d f=%f s=%s";
+        uint8_t buffer[DEFERRED_LOG_MAX_RECORD_SIZE]{};
+        detail::DeferredRecordWriter writer(buffer, sizeof(buffer));
+        writer.put(-5);
+        writer.put(1.5F);
+        const char* text = "ok";
+        writer.put(text);
+        const size_t size = writer.finish(LogLevel::Warning, format, 1234);
+
+        // Header + (1 + 4) + (1 + 4) + (1 + 1 + 2)
+        ASSERT_EQ(size, sizeof(DeferredLogHeader) + 14);
+
+        DeferredLogHeader header{};
+        std::memcpy(&header, buffer, sizeof(header));
+        EXPECT_EQ(header.magic[0], 'R');
+        EXPECT_EQ(header.magic[1], 'L');
+        EXPECT_EQ(header.level, LogLevel::Warning);
+        EXPECT_EQ(header.payloadSize, 14);
+        EXPECT_EQ(header.formatId, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(format)));
+        EXPECT_EQ(header.timestamp, 1234U);
+
+        const uint8_t* payload = buffer + sizeof(DeferredLogHeader);
+        EXPECT_EQ(payload[0], static_cast<uint8_t>(DeferredArgType::Int32));
+        int32_t intValue = 0;
+        std::memcpy(&intValue, &payload[1], sizeof(intValue));
+        EXPECT_EQ(intValue, -5);
+
+        EXPECT_EQ(payload[5], static_cast<uint8_t>(DeferredArgType::Float));
+        float floatValue = 0.0F;
+        std::memcpy(&floatValue, &payload[6], sizeof(floatValue));
+        EXPECT_FLOAT_EQ(floatValue, 1.5F);
+
+        EXPECT_EQ(payload[10], static_cast<uint8_t>(DeferredArgType::String));
+        EXPECT_EQ(payload[11], 2);
+        EXPECT_EQ(std::memcmp(&payload[12], "ok", 2), 0);
+    }
+
+    TEST_F(RttLoggerTest, DeferredRecordTruncatesLongStrings)
+    {
+        char longString[128];
+        std::memset(longString, 'x', sizeof(longString) - 1);
+        longString[sizeof(longString) - 1] = '\0';
+
+        uint8_t buffer[32]{};
+        detail::DeferredRecordWriter writer(buffer, sizeof(buffer));
+        writer.put(static_cast<const char*>(longString));
+        writer.put(1); // No room left, dropped
+        const size_t size = writer.finish(LogLevel::Info, "", 0);
+
+        EXPECT_EQ(size, sizeof(buffer));
+        EXPECT_EQ(buffer[sizeof(DeferredLogHeader) + 1], sizeof(buffer) - sizeof(DeferredLogHeader) - 2);
+    }
+
+    TEST_F(RttLoggerTest, DeferredLoggingMacro)
+    {
+        auto& logger = getLogger();
+        logger.setMinLevel(LogLevel::Trace);
+
+        // These should not crash
+        RTT_LOG_DEFERRED(logger, LogLevel::Info, "No arguments");
+        const char* text = "text";
+        RTT_LOG_DEFERRED(logger, LogLevel::Debug, "Value: %d, %u, %s", -1, 2U, text);
+    }
+
+    TEST_F(RttLoggerTest, TruncationPolicyDefault)
+    {
+        Logger logger;
+        EXPECT_EQ(logger.getTruncationPolicy(), TruncationPolicy::TruncateWithMarker);
+        logger.setTruncationPolicy(TruncationPolicy::Drop);
+        EXPECT_EQ(logger.getTruncationPolicy(), TruncationPolicy::Drop);
+    }
+
+    TEST_F(RttLoggerTest, BuildRecord)
+    {
+        char buffer[LOG_MAX_RECORD_SIZE];
+        const size_t length = Logger::buildRecord(buffer, sizeof(buffer), LogLevel::Warning, "Disk almost full",
+                                                  TruncationPolicy::Truncate);
+        EXPECT_EQ(std::string(buffer, length), "[WARN] Disk almost full\r\n");
+    }
+
+    TEST_F(RttLoggerTest, BuildRecordTruncation)
+    {
+        char buffer[20];
+        const std::string_view message{"This message is too long"};
+
+        size_t length = Logger::buildRecord(buffer, sizeof(buffer), LogLevel::Info, message, TruncationPolicy::Truncate);
+        EXPECT_EQ(std::string(buffer, length), "[INFO] This messag\r\n");
+
+        length = Logger::buildRecord(buffer, sizeof(buffer), LogLevel::Info, message,
+                                     TruncationPolicy::TruncateWithMarker);
+        EXPECT_EQ(std::string(buffer, length), "[INFO] This mes...\r\n");
+
+        length = Logger::buildRecord(buffer, sizeof(buffer), LogLevel::Info, message, TruncationPolicy::Drop);
+        EXPECT_EQ(length, 0U);
+    }
+
+    TEST_F(RttLoggerTest, BuildRecordTooSmallBuffer)
+    {
+        char buffer[8];
+        EXPECT_EQ(Logger::buildRecord(buffer, sizeof(buffer), LogLevel::Error, "x", TruncationPolicy::Truncate), 0U);
+    }
+
+    TEST_F(RttLoggerTest, BuildFormattedRecord)
+    {
+        char buffer[LOG_MAX_RECORD_SIZE];
+        const char* name = "motor";
+        size_t length = Logger::buildFormattedRecord(buffer, sizeof(buffer), LogLevel::Debug,
+                                                     TruncationPolicy::Truncate, "%s speed %d", name, 1200);
+        EXPECT_EQ(std::string(buffer, length), "[DEBUG] motor speed 1200\r\n");
+
+        length = Logger::buildFormattedRecord(buffer, sizeof(buffer), LogLevel::Info, TruncationPolicy::Truncate,
+                                              "100%");
+        EXPECT_EQ(std::string(buffer, length), "[INFO] 100%\r\n");
+    }
+
+    TEST_F(RttLoggerTest, BuildFormattedRecordTruncation)
+    {
+        char buffer[20];
+        size_t length = Logger::buildFormattedRecord(buffer, sizeof(buffer), LogLevel::Info,
+                                                     TruncationPolicy::TruncateWithMarker, "Value %d of %d", 123456,
+                                                     654321);
+        EXPECT_EQ(std::string(buffer, length), "[INFO] Value 12...\r\n");
+
+        length = Logger::buildFormattedRecord(buffer, sizeof(buffer), LogLevel::Info, TruncationPolicy::Drop,
+                                              "Value %d of %d", 123456, 654321);
+        EXPECT_EQ(length, 0U);
+    }
+
+    TEST_F(RttLoggerTest, CompiledMinLevel)
+    {
+        EXPECT_EQ(COMPILED_MIN_LEVEL, static_cast<LogLevel>(RTT_LOG_COMPILED_MIN_LEVEL));
+        EXPECT_TRUE(isCompiledIn<LogLevel::Critical>());
+        EXPECT_EQ(isCompiledIn<LogLevel::Trace>(), COMPILED_MIN_LEVEL == LogLevel::Trace);
+
+        // The runtime filter can only narrow what is compiled in
+        Logger logger(0, LogLevel::Trace);
+        EXPECT_EQ(logger.isEnabled(LogLevel::Trace), isCompiledIn<LogLevel::Trace>());
+    }
+
+    TEST_F(RttLoggerTest, CompiledMinLevelRemovesDeferredLogging)
+    {
+        auto& logger = getLogger();
+        logger.setMinLevel(LogLevel::Trace);
+
+        // Compiled-out levels do not even evaluate their arguments
+        int evaluated = 0;
+        RTT_LOG_DEFERRED(logger, LogLevel::Trace, "Trace %d", ++evaluated);
+        EXPECT_EQ(evaluated, isCompiledIn<LogLevel::Trace>() ? 1 : 0);
+        RTT_LOG_DEFERRED(logger, LogLevel::Critical, "Critical %d", ++evaluated);
+        EXPECT_EQ(evaluated, isCompiledIn<LogLevel::Trace>() ? 2 : 1);
+    }
+
+    TEST_F(RttLoggerTest, LevelMacros)
+    {
+        auto& logger = getLogger();
+        logger.setMinLevel(LogLevel::Trace);
+
+        // These should not crash
+        RTT_LOG_TRACE(logger, "Trace message");
+        RTT_LOG_DEBUG(logger, "Debug %d", 1);
+        RTT_LOG_INFO(logger, "Info %u", 2U);
+        RTT_LOG_WARNING(logger, "Warning");
+        RTT_LOG_ERROR(logger, "Error %d %d", 3, 4);
+        RTT_LOG_CRITICAL(logger, "Critical");
+    }
 } // namespace rtt::test
@@ -0,0 +1,315 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "rtt_memory_dump/memory_watch.hpp"
+#include "rtt_memory_dump/rtt_memory_dump.hpp"
+#include "SEGGER_RTT.h"
+
+namespace rtt::test
+{
+    using memory_dump::DumpConfig;
+    using memory_dump::DumpFormat;
+    using memory_dump::MemoryDumper;
+    using memory_dump::MemoryWatch;
+
+    namespace
+    {
+        std::string formatLine(const DumpConfig& config, const uint8_t* data, size_t size, uintptr_t address = 0,
+                               size_t offset = 0)
+        {
+            const MemoryDumper dumper(config);
+            std::array<char, MemoryDumper::LINE_BUFFER_SIZE> buffer{};
+            const size_t length = dumper.formatLine(data, size, address, offset, buffer.data());
+            EXPECT_EQ(length, std::strlen(buffer.data()));
+            return {buffer.data(), length};
+        }
+
+        struct MemoryPacket
+        {
+            uintptr_t address;
+            std::vector<uint8_t> bytes;
+        };
+
+        /**
+         * @brief Captures the Memory packets written to an RTT channel
+         */
+        class MemoryCapture
+        {
+        public:
+            explicit MemoryCapture(unsigned channel, unsigned flags = SEGGER_RTT_MODE_NO_BLOCK_SKIP) :
+                m_channel(channel), m_sender(channel)
+            {
+                SEGGER_RTT_ConfigUpBuffer(channel, "Memory", m_buffer.data(), m_buffer.size(), flags);
+                clear();
+            }
+
+            void clear()
+            {
+                _SEGGER_RTT.aUp[m_channel].RdOff = 0;
+                _SEGGER_RTT.aUp[m_channel].WrOff = 0;
+            }
+
+            [[nodiscard]] std::vector<MemoryPacket> packets() const
+            {
+                std::vector<MemoryPacket> packets;
+                const size_t end = _SEGGER_RTT.aUp[m_channel].WrOff;
+                for (size_t offset = 0; offset + sizeof(data::DataHeader) <= end;)
+                {
+                    data::DataHeader header{};
+                    std::memcpy(&header, &m_buffer[offset], sizeof(header));
+                    EXPECT_EQ(header.type, data::DataType::Memory);
+                    MemoryPacket packet{};
+                    std::memcpy(&packet.address, &m_buffer[offset + sizeof(header)], sizeof(packet.address));
+                    const size_t payload = offset + sizeof(header) + sizeof(uintptr_t);
+                    const auto* bytes = reinterpret_cast<const uint8_t*>(&m_buffer[payload]);
+                    packet.bytes.assign(bytes, bytes + header.size - sizeof(uintptr_t));
+                    packets.push_back(packet);
+                    offset += sizeof(header) + header.size;
+                }
+                return packets;
+            }
+
+            data::DataSender& sender() { return m_sender; }
+
+        private:
+            unsigned m_channel;
+            data::DataSender m_sender;
+            std::array<char, 2048> m_buffer{};
+        };
+    } // namespace
+
+    TEST(MemoryDumpTest, FormatsHex)
+    {
+        const std::array<uint8_t, 4> data{0x00, 0x7F, 0xA5, 0xFF};
+        EXPECT_EQ(formatLine(DumpConfig(DumpFormat::Hex, 16, false), data.data(), data.size()), "00 7F A5 FF");
+    }
+
+    TEST(MemoryDumpTest, FormatsHexAsciiPadded)
+    {
+        const std::array<uint8_t, 3> data{'O', 'K', 0x01};
+        const std::string line = formatLine(DumpConfig(DumpFormat::HexAscii, 4, false), data.data(), data.size());
+        EXPECT_EQ(line, "4F 4B 01     | OK. ");
+    }
+
+    TEST(MemoryDumpTest, FormatsBinaryAndDecimal)
+    {
+        const std::array<uint8_t, 3> data{0x05, 0xF0, 0xFF};
+        EXPECT_EQ(formatLine(DumpConfig(DumpFormat::Binary, 16, false), data.data(), data.size()),
+                  "00000101 11110000 11111111");
+        EXPECT_EQ(formatLine(DumpConfig(DumpFormat::Decimal, 16, false), data.data(), data.size()), "  5 240 255");
+    }
+
+    TEST(MemoryDumpTest, FormatsAddressAndOffsetLikePrintf)
+    {
+        const uint8_t byte = 0xAB;
+        const uintptr_t highest = UINTPTR_MAX - 0x10;
+        for (const uintptr_t address : {uintptr_t{0}, uintptr_t{0x20001FF0}, highest})
+        {
+            char expected[32];
+            std::snprintf(expected, sizeof(expected), "0x%08lX: AB", static_cast<unsigned long>(address + 0x10));
+            EXPECT_EQ(formatLine(DumpConfig(DumpFormat::Hex), &byte, 1, address, 0x10), expected);
+        }
+        EXPECT_EQ(formatLine(DumpConfig(DumpFormat::Hex, 16, false, true), &byte, 1, 0, 0x12345), "+0x12345: AB");
+    }
+
+    TEST(MemoryDumpTest, ClampsBytesPerLine)
+    {
+        std::array<uint8_t, 80> data{};
+        const std::string line = formatLine(DumpConfig(DumpFormat::Hex, 0, false), data.data(), data.size());
+        EXPECT_EQ(line, "00");
+        const std::string wide = formatLine(DumpConfig(DumpFormat::Hex, 200, false), data.data(), data.size());
+        EXPECT_EQ(wide.size(), memory_dump::DUMP_MAX_BYTES_PER_LINE * 3 - 1);
+    }
+
+    TEST(MemoryDumpTest, DumpWritesLinesLongerThanLogRecord)
+    {
+        static char buffer[8192];
+        SEGGER_RTT_ConfigUpBuffer(1, "Dump", buffer, sizeof(buffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        auto& up = _SEGGER_RTT.aUp[1];
+
+        std::array<uint8_t, 40> region{};
+        for (size_t i = 0; i < region.size(); ++i)
+        {
+            region[i] = static_cast<uint8_t>('A' + i);
+        }
+
+        Logger logger(1, LogLevel::Info);
+        for (const DumpConfig& config : {DumpConfig(DumpFormat::Binary, 16), DumpConfig(DumpFormat::HexAscii, 32)})
+        {
+            up.RdOff = up.WrOff = 0;
+            MemoryDumper dumper(config, logger);
+            dumper.dump(region.data(), region.size(), "region");
+
+            std::string expected = "[INFO] === Memory Dump: region ===\r\n";
+            char line[MemoryDumper::LINE_BUFFER_SIZE];
+            std::snprintf(line, sizeof(line), "[INFO] Address: 0x%08lX, Size: %zu bytes\r\n",
+                          static_cast<unsigned long>(reinterpret_cast<uintptr_t>(region.data())), region.size());
+            expected += line;
+            for (size_t offset = 0; offset < region.size(); offset += config.bytes_per_line)
+            {
+                const size_t size = std::min(config.bytes_per_line, region.size() - offset);
+                const std::string text =
+                    formatLine(config, &region[offset], size, reinterpret_cast<uintptr_t>(region.data()), offset);
+                if (size == config.bytes_per_line)
+                {
+                    EXPECT_GT(text.size(), LOG_MAX_RECORD_SIZE);
+                }
+                expected += "[INFO] " + text + "\r\n";
+            }
+            expected += "[INFO] === End Memory Dump ===\r\n";
+            EXPECT_EQ(std::string(buffer, up.WrOff), expected);
+        }
+
+        // Nothing is formatted below the logger's level
+        up.RdOff = up.WrOff = 0;
+        logger.setMinLevel(LogLevel::Warning);
+        MemoryDumper(DumpConfig(DumpFormat::Binary, 16), logger).dump(region.data(), region.size());
+        EXPECT_EQ(up.WrOff, 0U);
+    }
+
+    TEST(MemoryDumpTest, RawSendsAddressedChunks)
+    {
+        static char buffer[4096];
+        SEGGER_RTT_ConfigUpBuffer(2, "Memory", buffer, sizeof(buffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        auto& up = _SEGGER_RTT.aUp[2];
+        up.RdOff = up.WrOff = 0;
+
+        static std::array<uint8_t, data::DATA_MEMORY_CHUNK_SIZE + 10> region{};
+        for (size_t i = 0; i < region.size(); ++i)
+        {
+            region[i] = static_cast<uint8_t>(i);
+        }
+
+        data::DataSender sender(2);
+        MemoryDumper dumper(DumpConfig(DumpFormat::Raw));
+        dumper.setDataSender(sender);
+        dumper.dump(region.data(), region.size());
+
+        // Two packets: a full chunk, then the remaining 10 bytes
+        const size_t prefix = sizeof(data::DataHeader) + sizeof(uintptr_t);
+        ASSERT_EQ(up.WrOff, 2 * prefix + region.size());
+
+        data::DataHeader header{};
+        std::memcpy(&header, buffer, sizeof(header));
+        EXPECT_EQ(header.type, data::DataType::Memory);
+        EXPECT_EQ(header.subtype, sizeof(uintptr_t));
+        EXPECT_EQ(header.size, sizeof(uintptr_t) + data::DATA_MEMORY_CHUNK_SIZE);
+
+        const size_t second = prefix + data::DATA_MEMORY_CHUNK_SIZE;
+        uintptr_t address = 0;
+        std::memcpy(&header, &buffer[second], sizeof(header));
+        std::memcpy(&address, &buffer[second + sizeof(header)], sizeof(address));
+        EXPECT_EQ(header.size, sizeof(uintptr_t) + 10U);
+        EXPECT_EQ(address, reinterpret_cast<uintptr_t>(&region[data::DATA_MEMORY_CHUNK_SIZE]));
+        EXPECT_EQ(std::memcmp(&buffer[second + prefix], &region[data::DATA_MEMORY_CHUNK_SIZE], 10), 0);
+    }
+
+    TEST(MemoryDumpTest, RawStopsAtFirstChunkThatDoesNotFit)
+    {
+        // Room for one full packet and a few bytes: the second packet is dropped whole, header included
+        constexpr size_t PREFIX = sizeof(data::DataHeader) + sizeof(uintptr_t);
+        static char buffer[PREFIX + data::DATA_MEMORY_CHUNK_SIZE + 8];
+        SEGGER_RTT_ConfigUpBuffer(2, "Memory", buffer, sizeof(buffer), SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+        auto& up = _SEGGER_RTT.aUp[2];
+        up.RdOff = up.WrOff = 0;
+
+        // Not claimed in block mode, so the sender checks the room instead of waiting
+        static std::array<uint8_t, 2 * data::DATA_MEMORY_CHUNK_SIZE> region{};
+        data::DataSender sender(2);
+        EXPECT_EQ(sender.sendMemory(region.data(), region.size()), PREFIX + data::DATA_MEMORY_CHUNK_SIZE);
+        EXPECT_EQ(up.WrOff, PREFIX + data::DATA_MEMORY_CHUNK_SIZE);
+    }
+
+    TEST(MemoryWatchTest, SelectsModeFromStateSize)
+    {
+        std::array<uint8_t, 100> region{};
+        std::array<uint8_t, 100> shadow{};
+        std::array<uint8_t, MemoryWatch::hashBufferSize(100)> hashes{};
+        static_assert(MemoryWatch::hashBufferSize(100) == 4 * sizeof(uint32_t));
+
+        EXPECT_EQ(MemoryWatch(region.data(), region.size(), shadow.data(), shadow.size()).getMode(),
+                  MemoryWatch::Mode::Shadow);
+        EXPECT_EQ(MemoryWatch(region.data(), region.size(), hashes.data(), hashes.size()).getMode(),
+                  MemoryWatch::Mode::Hash);
+        EXPECT_FALSE(MemoryWatch(region.data(), region.size(), hashes.data(), hashes.size() - 1).isValid());
+        EXPECT_FALSE(MemoryWatch(region.data(), region.size(), shadow.data(), shadow.size(), 0).isValid());
+        EXPECT_FALSE(MemoryWatch(nullptr, 0, shadow.data(), shadow.size()).isValid());
+    }
+
+    class MemoryWatchModeTest : public ::testing::TestWithParam<bool>
+    {
+    };
+
+    TEST_P(MemoryWatchModeTest, SendsOnlyChangedBlocks)
+    {
+        static std::array<uint8_t, 250> region{};
+        static std::array<uint8_t, 250> state{};
+        region.fill(0x11);
+        const size_t stateSize = GetParam() ? state.size() : MemoryWatch::hashBufferSize(region.size());
+
+        MemoryCapture capture(2);
+        MemoryWatch watch(region.data(), region.size(), state.data(), stateSize);
+        const auto base = reinterpret_cast<uintptr_t>(region.data());
+
+        // The first poll sends the whole region
+        EXPECT_EQ(watch.poll(capture.sender()), 8U);
+        auto packets = capture.packets();
+        ASSERT_EQ(packets.size(), 1U);
+        EXPECT_EQ(packets[0].address, base);
+        EXPECT_EQ(packets[0].bytes.size(), region.size());
+
+        capture.clear();
+        EXPECT_EQ(watch.poll(capture.sender()), 0U);
+        EXPECT_TRUE(capture.packets().empty());
+
+        // Blocks 1 and 2 are adjacent and share a packet, the partial last block is sent alone
+        region[40] = 0x22;
+        region[70] = 0x33;
+        region[249] = 0x44;
+        capture.clear();
+        EXPECT_EQ(watch.poll(capture.sender()), 3U);
+        packets = capture.packets();
+        ASSERT_EQ(packets.size(), 2U);
+        EXPECT_EQ(packets[0].address, base + 32);
+        ASSERT_EQ(packets[0].bytes.size(), 64U);
+        EXPECT_EQ(packets[0].bytes[40 - 32], 0x22);
+        EXPECT_EQ(packets[0].bytes[70 - 32], 0x33);
+        EXPECT_EQ(packets[1].address, base + 224);
+        ASSERT_EQ(packets[1].bytes.size(), 26U);
+        EXPECT_EQ(packets[1].bytes.back(), 0x44);
+
+        watch.resync();
+        capture.clear();
+        EXPECT_EQ(watch.poll(capture.sender()), 8U);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(ShadowAndHash, MemoryWatchModeTest, ::testing::Bool());
+
+    TEST(MemoryWatchTest, ResendsAllAfterDroppedPacket)
+    {
+        static std::array<uint8_t, 1500> region{};
+        static std::array<uint8_t, MemoryWatch::hashBufferSize(1500)> hashes{};
+        MemoryCapture capture(2);
+        MemoryWatch watch(region.data(), region.size(), hashes.data(), hashes.size());
+        const size_t blocks = MemoryWatch::blockCount(region.size());
+
+        // Nearly full buffer: the first chunk does not fit and is dropped as a whole
+        _SEGGER_RTT.aUp[2].WrOff = 1500;
+        EXPECT_EQ(watch.poll(capture.sender()), blocks);
+        EXPECT_EQ(_SEGGER_RTT.aUp[2].WrOff, 1500U);
+
+        // Nothing changed, but the host missed data: everything is sent again
+        capture.clear();
+        EXPECT_EQ(watch.poll(capture.sender()), blocks);
+        EXPECT_EQ(capture.packets().size(), 2U);
+
+        capture.clear();
+        EXPECT_EQ(watch.poll(capture.sender()), 0U);
+        region[0] = 1;
+        EXPECT_EQ(watch.poll(capture.sender()), 1U);
+    }
+} // namespace rtt::test
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <string>
+#include <string_view>
+#include "SEGGER_RTT.h"
+
+#if RTT_MOCK_RTT
+#include "rtt_mock/rtt_mock.hpp"
+
+namespace rtt::mock::test
+{
+    namespace
+    {
+        constexpr unsigned CHANNEL{1};
+        constexpr std::string_view FIRST{"0123456789"};
+        constexpr std::string_view SECOND{"abcdefghij"};
+    } // namespace
+
+    class RttMockTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            RttMock::reset();
+        }
+
+        void TearDown() override
+        {
+            RttMock::reset();
+        }
+
+        // 16 byte ring: 15 bytes fit, as one slot always stays free
+        void configure(unsigned mode)
+        {
+            SEGGER_RTT_ConfigUpBuffer(CHANNEL, "Mock", m_buffer.data(), m_buffer.size(), mode);
+        }
+
+        static unsigned write(std::string_view data)
+        {
+            return SEGGER_RTT_Write(CHANNEL, data.data(), static_cast<unsigned>(data.size()));
+        }
+
+        std::array<char, 16> m_buffer{};
+    };
+
+    TEST_F(RttMockTest, SkipDropsWriteThatDoesNotFit)
+    {
+        configure(SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        EXPECT_EQ(write(FIRST), FIRST.size());
+        EXPECT_EQ(write(SECOND), 0U);
+
+        EXPECT_EQ(RttMock::pending(CHANNEL), FIRST);
+        const ChannelStats stats = RttMock::getStats(CHANNEL);
+        EXPECT_EQ(stats.written, FIRST.size());
+        EXPECT_EQ(stats.dropped, SECOND.size());
+    }
+
+    TEST_F(RttMockTest, TrimWritesWhatFits)
+    {
+        configure(SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+        EXPECT_EQ(write(FIRST), FIRST.size());
+        EXPECT_EQ(write(SECOND), 5U);
+
+        EXPECT_EQ(RttMock::pending(CHANNEL), "0123456789abcde");
+        EXPECT_EQ(SEGGER_RTT_GetAvailWriteSpace(CHANNEL), 0U);
+        EXPECT_EQ(RttMock::getStats(CHANNEL).dropped, 5U);
+    }
+
+    TEST_F(RttMockTest, BlockWithoutHostDiscardsUnreadBytes)
+    {
+        configure(SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+        EXPECT_EQ(write(FIRST), FIRST.size());
+        EXPECT_EQ(write(SECOND), SECOND.size());
+
+        const ChannelStats stats = RttMock::getStats(CHANNEL);
+        EXPECT_EQ(stats.blockedWrites, 1U);
+        EXPECT_EQ(stats.discarded, 15U);
+        EXPECT_EQ(stats.dropped, 0U);
+
+        // The rest of the second write wrapped around the end of the ring
+        EXPECT_EQ(RttMock::pending(CHANNEL), "f");
+        RttMock::consume(CHANNEL, 1);
+        EXPECT_EQ(RttMock::pending(CHANNEL), "ghij");
+    }
+
+    TEST_F(RttMockTest, CaptureReadsEveryWrite)
+    {
+        configure(SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        write(FIRST);
+        RttMock::startCapture(CHANNEL);
+        EXPECT_EQ(RttMock::captured(CHANNEL), FIRST);
+
+        // The host keeps up, so writes that together exceed the ring are not dropped
+        write(SECOND);
+        write(FIRST);
+        EXPECT_EQ(RttMock::captured(CHANNEL), "0123456789abcdefghij0123456789");
+        EXPECT_EQ(RttMock::getStats(CHANNEL).dropped, 0U);
+        EXPECT_EQ(SEGGER_RTT_GetBytesInBuffer(CHANNEL), 0U);
+
+        RttMock::clearCaptured(CHANNEL);
+        RttMock::stopCapture(CHANNEL);
+        write(SECOND);
+        EXPECT_TRUE(RttMock::captured(CHANNEL).empty());
+        EXPECT_EQ(SEGGER_RTT_GetBytesInBuffer(CHANNEL), SECOND.size());
+    }
+
+    TEST_F(RttMockTest, BlockingWriteLargerThanRingIsCaptured)
+    {
+        configure(SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+        RttMock::startCapture(CHANNEL);
+        const std::string data(100, 'x');
+        EXPECT_EQ(write(data), data.size());
+
+        EXPECT_EQ(RttMock::captured(CHANNEL), data);
+        EXPECT_EQ(RttMock::getStats(CHANNEL).blockedWrites, 1U);
+        EXPECT_EQ(RttMock::getStats(CHANNEL).discarded, 0U);
+    }
+
+    TEST_F(RttMockTest, PendingIsZeroCopy)
+    {
+        configure(SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        write(FIRST);
+        const std::string_view pending = RttMock::pending(CHANNEL);
+        EXPECT_EQ(pending.data(), m_buffer.data());
+        EXPECT_EQ(pending.size(), FIRST.size());
+
+        RttMock::consume(CHANNEL, 4);
+        EXPECT_EQ(RttMock::pending(CHANNEL).data(), m_buffer.data() + 4);
+        EXPECT_EQ(SEGGER_RTT_GetAvailWriteSpace(CHANNEL), 9U);
+    }
+
+    TEST_F(RttMockTest, ListenerSeesCapturedWrites)
+    {
+        configure(SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        std::string received;
+        RttMock::setListener(
+            CHANNEL,
+            [](void* context, unsigned, const char* data, size_t size)
+            { static_cast<std::string*>(context)->append(data, size); },
+            &received);
+        write(FIRST);
+        EXPECT_TRUE(received.empty()); // Only captured channels are read
+
+        RttMock::startCapture(CHANNEL);
+        SEGGER_RTT_printf(CHANNEL, "%d-%s", 42, "x");
+        EXPECT_EQ(received, "0123456789" "42-x");
+    }
+
+    TEST_F(RttMockTest, DownBufferDeliversKeys)
+    {
+        EXPECT_EQ(SEGGER_RTT_HasKey(), 0);
+        EXPECT_EQ(SEGGER_RTT_GetKey(), -1);
+
+        // Terminal down-buffer of BUFFER_SIZE_DOWN bytes, one slot stays free
+        EXPECT_EQ(RttMock::sendToTarget(0, "ab"), 2U);
+        EXPECT_EQ(SEGGER_RTT_HasKey(), 1);
+        EXPECT_EQ(SEGGER_RTT_GetKey(), 'a');
+        EXPECT_EQ(SEGGER_RTT_WaitKey(), 'b');
+        EXPECT_EQ(RttMock::sendToTarget(0, std::string(100, 'c')), BUFFER_SIZE_DOWN - 1U);
+
+        std::array<char, 8> data{};
+        EXPECT_EQ(SEGGER_RTT_Read(0, data.data(), data.size()), data.size());
+        EXPECT_EQ(SEGGER_RTT_HasData(0), BUFFER_SIZE_DOWN - 1U - data.size());
+    }
+
+    TEST_F(RttMockTest, UnconfiguredChannelAcceptsNothing)
+    {
+        EXPECT_EQ(write(FIRST), 0U);
+        EXPECT_EQ(SEGGER_RTT_GetAvailWriteSpace(CHANNEL), 0U);
+        EXPECT_TRUE(RttMock::pending(CHANNEL).empty());
+        EXPECT_EQ(SEGGER_RTT_ConfigUpBuffer(SEGGER_RTT_MAX_NUM_UP_BUFFERS, "Out", m_buffer.data(), m_buffer.size(),
+                                            SEGGER_RTT_MODE_NO_BLOCK_SKIP),
+                  -1);
+    }
+} // namespace rtt::mock::test
+#endif // RTT_MOCK_RTT
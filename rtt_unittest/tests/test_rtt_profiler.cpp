@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include "rtt_benchmark/profiler.hpp"
+#include "rtt_benchmark/rtt_benchmark.hpp"
+#include "SEGGER_RTT.h"
+
+namespace
+{
+    uint32_t profiledLeaf(uint32_t value)
+    {
+        RTT_PROFILE_FUNCTION();
+        return value * 3U;
+    }
+
+    [[maybe_unused]] void profiledOuter()
+    {
+        RTT_PROFILE_SCOPE("outer");
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            rtt::benchmark::doNotOptimize(profiledLeaf(i));
+        }
+    }
+
+    const rtt::benchmark::ProfileSite* findSite(const char* name)
+    {
+        for (const auto* site = rtt::benchmark::Profiler::first(); site != nullptr; site = site->getNext())
+        {
+            if (std::strcmp(site->getName(), name) == 0)
+            {
+                return site;
+            }
+        }
+        return nullptr;
+    }
+} // namespace
+
+namespace rtt::test
+{
+    using benchmark::ProfileSite;
+    using benchmark::Profiler;
+
+    class ProfilerTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            Logger::initialize();
+        }
+    };
+
+    TEST_F(ProfilerTest, SiteAggregates)
+    {
+        ProfileSite site("aggregate");
+        EXPECT_EQ(site.getMin(), 0U);
+
+        site.record(10, 8);
+        site.record(30, 25);
+        site.record(20, 20);
+
+        EXPECT_EQ(site.getCount(), 3U);
+        EXPECT_EQ(site.getMin(), 10U);
+        EXPECT_EQ(site.getMax(), 30U);
+        EXPECT_EQ(site.getTotal(), 60U);
+        EXPECT_EQ(site.getExclusive(), 53U);
+
+        site.reset();
+        EXPECT_EQ(site.getCount(), 0U);
+        EXPECT_EQ(site.getMin(), 0U);
+        EXPECT_EQ(site.getMax(), 0U);
+        EXPECT_EQ(site.getTotal(), 0U);
+    }
+
+    TEST_F(ProfilerTest, ScopeRegistersOnce)
+    {
+        const size_t before = Profiler::count();
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            benchmark::doNotOptimize(profiledLeaf(i));
+        }
+
+        const ProfileSite* site = findSite("profiledLeaf");
+        ASSERT_NE(site, nullptr);
+        EXPECT_TRUE(site->isRegistered());
+        EXPECT_GE(site->getCount(), 5U);
+        EXPECT_LE(site->getMin(), site->getMax());
+        EXPECT_LE(Profiler::count(), before + 1);
+    }
+
+    TEST_F(ProfilerTest, ManualRegistrationIsIdempotent)
+    {
+        static ProfileSite site("manual");
+        const size_t before = Profiler::count();
+        Profiler::registerSite(site);
+        Profiler::registerSite(site);
+
+        EXPECT_EQ(Profiler::count(), before + 1);
+        EXPECT_EQ(Profiler::first(), &site);
+    }
+
+    TEST_F(ProfilerTest, RecordTruncatesName)
+    {
+        ProfileSite site("a_rather_long_profiler_site_name");
+        site.record(100, 60);
+
+        const benchmark::ProfileRecord record = Profiler::makeRecord(site);
+        EXPECT_EQ(std::strlen(record.name), benchmark::PROFILER_NAME_LENGTH - 1);
+        EXPECT_EQ(std::strncmp(record.name, "a_rather_long", 13), 0);
+        EXPECT_EQ(record.count, 1U);
+        EXPECT_EQ(record.min, 100U);
+        EXPECT_EQ(record.max, 100U);
+        EXPECT_EQ(record.total, 100U);
+        EXPECT_EQ(record.exclusive, 60U);
+        EXPECT_EQ(record.frequency, Timebase::getFrequency());
+    }
+
+    TEST_F(ProfilerTest, ReportSendsAllSites)
+    {
+        static char buffer[2048];
+        SEGGER_RTT_ConfigUpBuffer(2, "Profiler", buffer, sizeof(buffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        data::DataSender sender(2);
+
+        benchmark::doNotOptimize(profiledLeaf(1));
+        EXPECT_EQ(Profiler::report(sender), Profiler::count());
+
+        EXPECT_EQ(Profiler::report(sender, true), Profiler::count());
+        const ProfileSite* site = findSite("profiledLeaf");
+        ASSERT_NE(site, nullptr);
+        EXPECT_EQ(site->getCount(), 0U);
+    }
+
+    TEST_F(ProfilerTest, ResetClearsAllSites)
+    {
+        benchmark::doNotOptimize(profiledLeaf(2));
+        Profiler::reset();
+        for (const auto* site = Profiler::first(); site != nullptr; site = site->getNext())
+        {
+            EXPECT_EQ(site->getCount(), 0U);
+        }
+    }
+
+#if RTT_PROFILER_EXCLUSIVE
+    TEST_F(ProfilerTest, NestedScopesAreExcluded)
+    {
+        Profiler::reset();
+        profiledOuter();
+
+        const ProfileSite* outer = findSite("outer");
+        const ProfileSite* leaf = findSite("profiledLeaf");
+        ASSERT_NE(outer, nullptr);
+        ASSERT_NE(leaf, nullptr);
+        EXPECT_EQ(outer->getCount(), 1U);
+        EXPECT_EQ(leaf->getCount(), 4U);
+        EXPECT_EQ(leaf->getExclusive(), leaf->getTotal());
+        EXPECT_LE(outer->getExclusive() + leaf->getTotal(), outer->getTotal());
+        EXPECT_EQ(*Profiler::scopeSlot(), nullptr);
+    }
+#endif
+} // namespace rtt::test
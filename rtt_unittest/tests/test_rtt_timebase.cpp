@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "rtt_timebase/rtt_timebase.hpp"
+
+namespace rtt::test
+{
+    class TimebaseTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            Timebase::initialize();
+            Timebase::setFrequency(80'000'000U);
+        }
+
+        void TearDown() override
+        {
+            Timebase::initialize();
+        }
+    };
+
+    TEST_F(TimebaseTest, ExtendCountsWraps)
+    {
+        EXPECT_EQ(Timebase::extend(0x10U), 0x10U);
+        EXPECT_EQ(Timebase::extend(0x90000000U), 0x90000000U);
+        EXPECT_EQ(Timebase::extend(0xFFFFFFF0U), 0xFFFFFFF0U);
+        EXPECT_EQ(Timebase::extend(0x00000010U), 0x100000010ULL);
+        EXPECT_EQ(Timebase::extend(0x80000000U), 0x180000000ULL);
+        EXPECT_EQ(Timebase::extend(0x00000000U), 0x200000000ULL);
+    }
+
+    TEST_F(TimebaseTest, ExtendIsStableWithinHalfPeriod)
+    {
+        for (uint32_t value = 0; value < 0x80000000U; value += 0x01000000U)
+        {
+            EXPECT_EQ(Timebase::extend(value), value);
+        }
+    }
+
+    TEST_F(TimebaseTest, ConvertsTicksToNanoseconds)
+    {
+        EXPECT_EQ(Timebase::getFrequency(), 80'000'000U);
+        EXPECT_EQ(Timebase::toNanoseconds(80'000'000U), 1'000'000'000U);
+        EXPECT_EQ(Timebase::toNanoseconds(1U), 12U);
+        EXPECT_EQ(Timebase::toMicroseconds(80U), 1U);
+
+        // Beyond 32 bits: 2^32 ticks at 80 MHz are 53.687 s
+        EXPECT_EQ(Timebase::toNanoseconds(1ULL << 32), 53'687'091'200ULL);
+    }
+
+    TEST_F(TimebaseTest, ConversionErrorIsSmallForOddFrequencies)
+    {
+        Timebase::setFrequency(120'000'000U);
+        const uint64_t ns = Timebase::toNanoseconds(120'000'000ULL * 3600U);
+        const uint64_t expected = 3600ULL * 1'000'000'000ULL;
+        EXPECT_LE(expected - ns, 3'600U); // Below 1 ns per second
+    }
+
+    TEST_F(TimebaseTest, CalibrateDerivesFrequency)
+    {
+        EXPECT_TRUE(Timebase::calibrate(80'160U, 1'000'000U));
+        EXPECT_EQ(Timebase::getFrequency(), 80'160'000U);
+
+        EXPECT_FALSE(Timebase::calibrate(0U, 1'000'000U));
+        EXPECT_FALSE(Timebase::calibrate(80'000U, 0U));
+        EXPECT_EQ(Timebase::getFrequency(), 80'160'000U);
+    }
+
+    TEST_F(TimebaseTest, ZeroFrequencyIsIgnored)
+    {
+        Timebase::setFrequency(0U);
+        EXPECT_EQ(Timebase::getFrequency(), 80'000'000U);
+    }
+
+#ifndef __ARM_ARCH
+    TEST_F(TimebaseTest, HostClockIsMonotonicNanoseconds)
+    {
+        Timebase::initialize();
+        EXPECT_TRUE(Timebase::isInitialized());
+        EXPECT_EQ(Timebase::getFrequency(), 1'000'000'000U);
+
+        const uint64_t first = Timebase::now();
+        const uint64_t second = Timebase::now();
+        EXPECT_LE(first, second);
+        EXPECT_LT(first, 1'000'000'000U); // Timeline restarts at initialize()
+    }
+#endif
+} // namespace rtt::test
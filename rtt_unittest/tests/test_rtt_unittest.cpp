@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
+#include <gtest/gtest-spi.h>
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "rtt_unittest/rtt_unittest.hpp"
+#include "SEGGER_RTT.h"
 
 namespace rtt::unittest::test
 {
@@ -30,4 +36,318 @@ namespace rtt::unittest::test
         // Capture is stopped after scope
         EXPECT_TRUE(true); // Test that destruction works without error
     }
+
+#if RTT_MOCK_RTT
+    TEST_F(RttCaptureTest, CapturesLogRecords)
+    {
+        auto& logger = rtt::getLogger();
+        logger.setMinLevel(LogLevel::Trace);
+        logger.info("Before capture");
+
+        {
+            ScopedRttCapture scoped(capture);
+            EXPECT_TRUE(capture.isCapturing());
+            logger.info("Test message");
+            logger.logFormatted(LogLevel::Warning, "Value %d", 42);
+        }
+        logger.info("After capture");
+
+        ASSERT_EQ(capture.getMessageCount(), 2U);
+        EXPECT_TRUE(capture.containsMessage("Test message"));
+        EXPECT_FALSE(capture.containsMessage("Before capture"));
+        EXPECT_EQ(capture.getLastMessage(), "Value 42");
+    }
+
+    TEST_F(RttCaptureTest, SplitsRawOutputIntoLines)
+    {
+        capture.startCapture();
+        SEGGER_RTT_WriteString(0, "[ RUN      ] Suite.Test\nfirst");
+        SEGGER_RTT_WriteString(0, " line\r\n[info] lower\nunterminated");
+        capture.stopCapture();
+
+        ASSERT_EQ(capture.getMessageCount(), 4U);
+        EXPECT_EQ(capture.getOutput()[0], "[ RUN      ] Suite.Test"); // Not a level prefix
+        EXPECT_EQ(capture.getOutput()[1], "first line");
+        EXPECT_EQ(capture.getOutput()[2], "[info] lower");
+        EXPECT_EQ(capture.getLastMessage(), "unterminated");
+    }
+
+    TEST_F(RttCaptureTest, CapturesOtherChannel)
+    {
+        std::array<char, 64> buffer{};
+        SEGGER_RTT_ConfigUpBuffer(1, "Capture", buffer.data(), buffer.size(), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        RttCapture channelCapture(1);
+        channelCapture.startCapture();
+        SEGGER_RTT_WriteString(0, "terminal\n");
+        SEGGER_RTT_WriteString(1, "channel one\n");
+        channelCapture.stopCapture();
+
+        ASSERT_EQ(channelCapture.getMessageCount(), 1U);
+        EXPECT_EQ(channelCapture.getLastMessage(), "channel one");
+        SEGGER_RTT_ConfigUpBuffer(1, "", nullptr, 0, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+    }
+#endif
+
+    class RttTestEventListenerTest : public ::testing::Test
+    {
+    protected:
+        static constexpr unsigned RESULT_CHANNEL{2};
+
+        void SetUp() override
+        {
+            SEGGER_RTT_ConfigUpBuffer(RESULT_CHANNEL, "Results", s_buffer.data(), s_buffer.size(),
+                                      SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+            _SEGGER_RTT.aUp[RESULT_CHANNEL].RdOff = 0;
+            _SEGGER_RTT.aUp[RESULT_CHANNEL].WrOff = 0;
+        }
+
+        void TearDown() override
+        {
+            CycleBudget::clear();
+        }
+
+        static const ::testing::TestInfo& info()
+        {
+            return *::testing::UnitTest::GetInstance()->current_test_info();
+        }
+
+        // Packets written to the result channel: count of schema packets, String packets and the decoded results
+        static std::vector<TestResult> results(size_t* schemas = nullptr, std::vector<std::string>* strings = nullptr)
+        {
+            SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[RESULT_CHANNEL];
+            std::vector<TestResult> decoded;
+            size_t offset = up.RdOff;
+            while (offset + sizeof(data::DataHeader) <= up.WrOff)
+            {
+                data::DataHeader header{};
+                std::memcpy(&header, &s_buffer[offset], sizeof(header));
+                const size_t payload = offset + sizeof(header);
+                if (header.type == data::DataType::Struct && header.subtype == RTT_UNITTEST_RESULT_SCHEMA_ID &&
+                    header.size == sizeof(TestResult))
+                {
+                    TestResult result{};
+                    std::memcpy(&result, &s_buffer[payload], sizeof(result));
+                    decoded.push_back(result);
+                }
+                if (schemas != nullptr && header.type == data::DataType::Schema)
+                {
+                    ++*schemas;
+                }
+                if (strings != nullptr && header.type == data::DataType::String)
+                {
+                    strings->emplace_back(&s_buffer[payload], size_t{header.size});
+                }
+                offset = payload + header.size;
+            }
+            return decoded;
+        }
+
+        static void spin(uint64_t ticks)
+        {
+            const uint64_t start = Timebase::now();
+            while (Timebase::now() - start < ticks)
+            {
+            }
+        }
+
+        static inline std::array<char, 1024> s_buffer{};
+        Logger m_logger{0, LogLevel::Info};
+        data::DataSender m_sender{RESULT_CHANNEL};
+    };
+
+    TEST_F(RttTestEventListenerTest, SendsSchemaAndResultPerTest)
+    {
+        RttTestEventListener listener(m_logger, &m_sender);
+        listener.OnTestProgramStart(*::testing::UnitTest::GetInstance());
+        listener.OnTestStart(info());
+        spin(10);
+        listener.OnTestEnd(info());
+
+        size_t schemas = 0;
+        std::vector<std::string> strings;
+        const std::vector<TestResult> sent = results(&schemas, &strings);
+        EXPECT_EQ(schemas, 1U);
+        ASSERT_EQ(sent.size(), 1U);
+        const TestResult& result = sent[0];
+        EXPECT_EQ(sizeof(TestResult), 32U); // Numbers only; names and failures are separate records
+        ASSERT_EQ(strings.size(), 1U);
+        EXPECT_EQ(strings[0], "RTT_TEST 0 RttTestEventListenerTest SendsSchemaAndResultPerTest");
+        EXPECT_EQ(result.index, 0U);
+        EXPECT_EQ(result.status, TestStatus::Passed);
+        EXPECT_EQ(result.failures, 0U);
+        EXPECT_EQ(result.budget, 0U);
+        EXPECT_GE(result.cycles, 10U);
+        EXPECT_EQ(result.frequency, Timebase::getFrequency());
+        EXPECT_EQ(listener.getLastResult().cycles, result.cycles);
+    }
+
+    TEST_F(RttTestEventListenerTest, EachSenderDescribesStructOnce)
+    {
+        TestResult result{};
+        EXPECT_GT(m_sender.sendStruct(result), 0U);
+        EXPECT_GT(m_sender.sendStruct(result), 0U);
+        size_t schemas = 0;
+        EXPECT_EQ(results(&schemas).size(), 2U);
+        EXPECT_EQ(schemas, 1U);
+
+        // Another sender, e.g. on another channel, describes the struct again
+        data::DataSender other{RESULT_CHANNEL};
+        EXPECT_GT(other.sendStruct(result), 0U);
+        schemas = 0;
+        EXPECT_EQ(results(&schemas).size(), 3U);
+        EXPECT_EQ(schemas, 2U);
+    }
+
+    TEST_F(RttTestEventListenerTest, ExplicitSchemaIsNotRepeated)
+    {
+        EXPECT_GT(m_sender.sendSchema<TestResult>(), 0U);
+        TestResult result{};
+        EXPECT_GT(m_sender.sendStruct(result), 0U);
+        size_t schemas = 0;
+        EXPECT_EQ(results(&schemas).size(), 1U);
+        EXPECT_EQ(schemas, 1U);
+
+        // An explicit resend, e.g. after the host reconnected, is still sent
+        EXPECT_GT(m_sender.sendSchema<TestResult>(), 0U);
+        schemas = 0;
+        EXPECT_EQ(results(&schemas).size(), 1U);
+        EXPECT_EQ(schemas, 2U);
+    }
+
+    TEST_F(RttTestEventListenerTest, DroppedSchemaIsSentAgain)
+    {
+        // Full channel in skip mode: the schema and the sample are dropped
+        SEGGER_RTT_BUFFER_UP& up = _SEGGER_RTT.aUp[RESULT_CHANNEL];
+        up.WrOff = up.SizeOfBuffer - 1U;
+        TestResult result{};
+        EXPECT_EQ(m_sender.sendStruct(result), 0U);
+
+        up.RdOff = 0;
+        up.WrOff = 0;
+        EXPECT_GT(m_sender.sendStruct(result), 0U);
+        size_t schemas = 0;
+        EXPECT_EQ(results(&schemas).size(), 1U);
+        EXPECT_EQ(schemas, 1U);
+    }
+
+    TEST_F(RttTestEventListenerTest, ExceededBudgetFailsTest)
+    {
+        RttTestEventListener listener(m_logger, &m_sender);
+        listener.OnTestStart(info());
+        int line = 0;
+        ::testing::TestPartResultArray failures;
+        {
+            // The budget fails in the test body, before the listener sees the test end
+            ::testing::ScopedFakeTestPartResultReporter reporter(
+                ::testing::ScopedFakeTestPartResultReporter::INTERCEPT_ONLY_CURRENT_THREAD, &failures);
+            RTT_TEST_CYCLE_BUDGET(1);
+            line = __LINE__ - 1;
+            spin(10);
+        }
+        ASSERT_EQ(failures.size(), 1);
+        listener.OnTestPartResult(failures.GetTestPartResult(0));
+        listener.OnTestEnd(info());
+        EXPECT_EQ(CycleBudget::get(), 0U);
+
+        std::vector<std::string> strings;
+        const std::vector<TestResult> sent = results(nullptr, &strings);
+        ASSERT_EQ(sent.size(), 1U);
+        EXPECT_EQ(sent[0].status, TestStatus::Failed);
+        EXPECT_EQ(sent[0].failures, 1U);
+        EXPECT_EQ(sent[0].budget, 1U);
+
+        // Name record, then the failure record before the result
+        ASSERT_EQ(strings.size(), 2U);
+        const std::string& failure = strings[1];
+        EXPECT_EQ(failure.rfind("RTT_FAIL 0 ", 0), 0U) << failure;
+        EXPECT_NE(failure.find("test_rtt_unittest.cpp:" + std::to_string(line) + ": cycle budget exceeded: "),
+                  std::string::npos)
+            << failure;
+    }
+
+    TEST_F(RttTestEventListenerTest, BudgetWithinLimitPasses)
+    {
+        RttTestEventListener listener(m_logger, &m_sender);
+        listener.OnTestStart(info());
+        {
+            RTT_TEST_CYCLE_BUDGET(UINT64_MAX);
+        }
+        listener.OnTestEnd(info());
+
+        EXPECT_EQ(listener.getLastResult().status, TestStatus::Passed);
+        EXPECT_EQ(listener.getLastResult().budget, UINT64_MAX);
+    }
+
+    TEST_F(RttTestEventListenerTest, BudgetFailsWithoutListener)
+    {
+        EXPECT_NONFATAL_FAILURE(
+            {
+                RTT_TEST_CYCLE_BUDGET(1);
+                spin(10);
+            },
+            "cycle budget exceeded");
+    }
+
+    TEST_F(RttTestEventListenerTest, KeepsFirstFailure)
+    {
+        RttTestEventListener listener(m_logger, &m_sender);
+        listener.OnTestStart(info());
+        listener.OnTestPartResult(::testing::TestPartResult(::testing::TestPartResult::kNonFatalFailure, "a.cpp", 12,
+                                                            "Expected equality"));
+        listener.OnTestPartResult(::testing::TestPartResult(::testing::TestPartResult::kFatalFailure, "b.cpp", 3,
+                                                            "Second"));
+        listener.OnTestPartResult(::testing::TestPartResult(::testing::TestPartResult::kSuccess, "c.cpp", 1, ""));
+        listener.OnTestEnd(info());
+
+        const TestResult& result = listener.getLastResult();
+        EXPECT_EQ(result.status, TestStatus::Failed);
+        EXPECT_EQ(result.failures, 2U);
+        EXPECT_STREQ(listener.getLastFailure(), "a.cpp:12: Expected equality");
+    }
+
+    TEST_F(RttTestEventListenerTest, WorksWithoutDataSender)
+    {
+        RttTestEventListener listener(m_logger);
+        listener.OnTestProgramStart(*::testing::UnitTest::GetInstance());
+        listener.OnTestStart(info());
+        listener.OnTestEnd(info());
+        EXPECT_TRUE(results().empty());
+        EXPECT_EQ(listener.getLastResult().status, TestStatus::Passed);
+        EXPECT_STREQ(listener.getLastFailure(), "");
+    }
+
+#if RTT_MOCK_RTT
+    TEST_F(RttTestEventListenerTest, TextReportCanBeReducedToFailures)
+    {
+        RttCapture capture;
+        RttTestEventListener listener(m_logger, &m_sender);
+        listener.setTextReport(false);
+        {
+            ScopedRttCapture scoped(capture);
+            listener.OnTestStart(info());
+            listener.OnTestEnd(info());
+        }
+        EXPECT_EQ(capture.getMessageCount(), 0U);
+
+        {
+            ScopedRttCapture scoped(capture);
+            listener.OnTestStart(info());
+            listener.OnTestPartResult(
+                ::testing::TestPartResult(::testing::TestPartResult::kNonFatalFailure, "a.cpp", 7, "broken"));
+            listener.OnTestEnd(info());
+        }
+        ASSERT_EQ(capture.getMessageCount(), 2U);
+        EXPECT_EQ(capture.getOutput()[0], "[  FAILED  ] a.cpp:7: broken");
+        EXPECT_EQ(capture.getOutput()[1].rfind("[  FAILED] RttTestEventListenerTest.TextReportCanBeReducedToFailures (",
+                                               0),
+                  0U);
+
+        // The name is sent once, the failure only with the failed run
+        std::vector<std::string> strings;
+        EXPECT_EQ(results(nullptr, &strings).size(), 2U);
+        ASSERT_EQ(strings.size(), 2U);
+        EXPECT_EQ(strings[0].rfind("RTT_TEST 0 RttTestEventListenerTest ", 0), 0U);
+        EXPECT_EQ(strings[1], "RTT_FAIL 0 a.cpp:7: broken");
+    }
+#endif
 } // namespace rtt::unittest::test
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include "rtt_freertos_hooks/system_monitor.hpp"
+#include "SEGGER_RTT.h"
+
+namespace rtt::test
+{
+    using freertos::MONITOR_IDLE_MAX_GAP;
+    using freertos::MONITOR_MAX_TASKS;
+    using freertos::STACK_FILL_WORD;
+    using freertos::SystemMonitor;
+    using freertos::SystemStats;
+
+    namespace
+    {
+        // Distinct fake task handles
+        std::array<uint32_t, MONITOR_MAX_TASKS + 1> g_tasks{};
+
+        const void* task(size_t index) { return &g_tasks[index]; }
+
+        int findTask(const SystemStats& stats, const void* handle)
+        {
+            for (uint32_t i = 0; i < stats.taskCount; ++i)
+            {
+                if (stats.handle[i] == static_cast<uint32_t>(reinterpret_cast<uintptr_t>(handle)))
+                {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+    } // namespace
+
+    class SystemMonitorTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            Logger::initialize();
+            SystemMonitor::reset();
+        }
+
+        void TearDown() override
+        {
+            SystemMonitor::reset();
+        }
+    };
+
+    TEST_F(SystemMonitorTest, AccumulatesRuntimePerTask)
+    {
+        ASSERT_TRUE(SystemMonitor::registerTask(task(0), "worker", nullptr, 0));
+        SystemMonitor::start(1000);
+
+        SystemMonitor::taskSwitchedIn(task(0), 1000);
+        SystemMonitor::taskSwitchedOut(1300);
+        SystemMonitor::taskSwitchedIn(task(1), 1300);
+        SystemMonitor::taskSwitchedOut(1400);
+        SystemMonitor::taskSwitchedIn(task(0), 1400);
+
+        // The running task is accounted up to the sample
+        const SystemStats& stats = SystemMonitor::sample(1500);
+        EXPECT_EQ(stats.period, 500U);
+        ASSERT_EQ(stats.taskCount, 2U);
+        const int worker = findTask(stats, task(0));
+        const int other = findTask(stats, task(1));
+        ASSERT_GE(worker, 0);
+        ASSERT_GE(other, 0);
+        EXPECT_STREQ(stats.name[worker], "worker");
+        EXPECT_STREQ(stats.name[other], "");
+        EXPECT_EQ(stats.runtime[worker], 400U);
+        EXPECT_EQ(stats.switches[worker], 2U);
+        EXPECT_EQ(stats.runtime[other], 100U);
+        EXPECT_EQ(stats.switches[other], 1U);
+
+        // Samples report the difference since the previous one
+        SystemMonitor::taskSwitchedOut(1550);
+        const SystemStats& next = SystemMonitor::sample(1600);
+        EXPECT_EQ(next.period, 100U);
+        EXPECT_EQ(next.runtime[findTask(next, task(0))], 50U);
+        EXPECT_EQ(next.switches[findTask(next, task(0))], 0U);
+    }
+
+    TEST_F(SystemMonitorTest, IgnoresHooksWhileStopped)
+    {
+        SystemMonitor::taskSwitchedIn(task(0), 0);
+        SystemMonitor::taskSwitchedOut(100);
+        EXPECT_EQ(SystemMonitor::getTaskCount(), 0U);
+
+        SystemMonitor::start(0);
+        SystemMonitor::taskSwitchedIn(task(0), 0);
+        SystemMonitor::stop();
+        SystemMonitor::taskSwitchedOut(100);
+        EXPECT_EQ(SystemMonitor::sample(100).runtime[0], 0U);
+    }
+
+    TEST_F(SystemMonitorTest, CountsIdleLoopGaps)
+    {
+        SystemMonitor::start(0);
+
+        SystemMonitor::idleEntry(50); // No previous exit yet
+        SystemMonitor::idleExit(100);
+        SystemMonitor::idleEntry(150); // +50
+        SystemMonitor::idleExit(160);
+
+        SystemMonitor::taskSwitchedIn(task(0), 170);
+        SystemMonitor::idleEntry(400); // A task ran in between
+        SystemMonitor::idleExit(410);
+        SystemMonitor::idleEntry(410 + MONITOR_IDLE_MAX_GAP + 1); // Preempted by an interrupt
+        SystemMonitor::idleExit(5000);
+        SystemMonitor::idleEntry(5030); // +30
+
+        const SystemStats& stats = SystemMonitor::sample(10000);
+        EXPECT_EQ(stats.idle, 80U);
+        EXPECT_EQ(stats.load, 9920U);
+        EXPECT_EQ(stats.frequency, Timebase::getFrequency());
+    }
+
+    TEST_F(SystemMonitorTest, ScansStacksIncrementally)
+    {
+        // The stack grows down: the upper 24 words are in use
+        std::array<uint32_t, 64> stack{};
+        stack.fill(STACK_FILL_WORD);
+        for (size_t i = 40; i < stack.size(); ++i)
+        {
+            stack[i] = static_cast<uint32_t>(i);
+        }
+        ASSERT_TRUE(SystemMonitor::registerTask(task(0), "stack", stack.data(), stack.size()));
+
+        // Sweeps check MONITOR_SCAN_WORDS words per pass from the stack base upwards
+        const size_t passes = 40 / freertos::MONITOR_SCAN_WORDS;
+        for (size_t i = 0; i < passes; ++i)
+        {
+            SystemMonitor::scanStacks();
+        }
+        EXPECT_EQ(SystemMonitor::sample(0).stackFree[0], 64U);
+        SystemMonitor::scanStacks();
+        EXPECT_EQ(SystemMonitor::sample(0).stackFree[0], 40U);
+
+        // Deeper use is found by a later sweep; the mark never recovers
+        stack[30] = 0;
+        for (size_t i = 0; i < passes; ++i)
+        {
+            SystemMonitor::scanStacks();
+        }
+        EXPECT_EQ(SystemMonitor::sample(0).stackFree[0], 30U);
+        stack[30] = STACK_FILL_WORD;
+        for (size_t i = 0; i < 2 * passes; ++i)
+        {
+            SystemMonitor::scanStacks();
+        }
+        const SystemStats& stats = SystemMonitor::sample(0);
+        EXPECT_EQ(stats.stackFree[0], 30U);
+        EXPECT_EQ(stats.stackWords[0], 64U);
+    }
+
+    TEST_F(SystemMonitorTest, FindsStackOfAddress)
+    {
+        std::array<uint32_t, 32> first{};
+        std::array<uint32_t, 16> second{};
+        ASSERT_TRUE(SystemMonitor::registerTask(task(0), "first", first.data(), first.size()));
+        ASSERT_TRUE(SystemMonitor::registerTask(task(1), "second", second.data(), second.size()));
+        ASSERT_TRUE(SystemMonitor::registerTask(task(2), "nostack", nullptr, 0));
+
+        uintptr_t start = 0;
+        uintptr_t end = 0;
+        ASSERT_TRUE(SystemMonitor::findStack(reinterpret_cast<uintptr_t>(&second[5]), start, end));
+        EXPECT_EQ(start, reinterpret_cast<uintptr_t>(second.data()));
+        EXPECT_EQ(end, reinterpret_cast<uintptr_t>(second.data() + second.size()));
+        ASSERT_TRUE(SystemMonitor::findStack(reinterpret_cast<uintptr_t>(first.data()), start, end));
+        EXPECT_EQ(end, reinterpret_cast<uintptr_t>(first.data() + first.size()));
+        EXPECT_FALSE(SystemMonitor::findStack(reinterpret_cast<uintptr_t>(first.data() + first.size()), start, end) &&
+                     start == reinterpret_cast<uintptr_t>(first.data()));
+
+        SystemMonitor::unregisterTask(task(1));
+        EXPECT_FALSE(SystemMonitor::findStack(reinterpret_cast<uintptr_t>(&second[5]), start, end));
+    }
+
+    TEST_F(SystemMonitorTest, ManagesTaskSlots)
+    {
+        EXPECT_FALSE(SystemMonitor::registerTask(nullptr, "null", nullptr, 0));
+
+        SystemMonitor::start(0);
+        SystemMonitor::taskSwitchedIn(task(0), 0);
+        EXPECT_EQ(SystemMonitor::getTaskCount(), 1U);
+
+        // Registering a seen task updates its slot
+        EXPECT_TRUE(SystemMonitor::registerTask(task(0), "late", nullptr, 0));
+        EXPECT_EQ(SystemMonitor::getTaskCount(), 1U);
+
+        for (size_t i = 1; i < MONITOR_MAX_TASKS; ++i)
+        {
+            EXPECT_TRUE(SystemMonitor::registerTask(task(i), "task", nullptr, 0));
+        }
+        EXPECT_FALSE(SystemMonitor::registerTask(task(MONITOR_MAX_TASKS), "full", nullptr, 0));
+
+        SystemMonitor::unregisterTask(task(0));
+        EXPECT_EQ(SystemMonitor::getTaskCount(), MONITOR_MAX_TASKS - 1);
+        EXPECT_EQ(rtt_monitor_register_task(task(MONITOR_MAX_TASKS), "c", nullptr, 0), 0);
+        EXPECT_EQ(rtt_monitor_register_task(task(0), "c", nullptr, 0), -1);
+    }
+
+    TEST_F(SystemMonitorTest, ReportSendsOneStructPacket)
+    {
+        static std::array<char, 2048> buffer{};
+        SEGGER_RTT_ConfigUpBuffer(2, "Monitor", buffer.data(), buffer.size(), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        _SEGGER_RTT.aUp[2].RdOff = 0;
+        _SEGGER_RTT.aUp[2].WrOff = 0;
+        data::DataSender sender(2);
+
+        ASSERT_TRUE(SystemMonitor::registerTask(task(0), "reporter", nullptr, 0));
+        SystemMonitor::start();
+        const size_t sent = SystemMonitor::report(sender);
+        ASSERT_GT(sent, sizeof(SystemStats) + sizeof(data::DataHeader));
+
+        // Schema first, then the stats as one Struct packet
+        data::DataHeader schema{};
+        std::memcpy(&schema, buffer.data(), sizeof(schema));
+        EXPECT_EQ(schema.type, data::DataType::Schema);
+        data::DataHeader header{};
+        const size_t offset = sizeof(schema) + schema.size;
+        std::memcpy(&header, &buffer[offset], sizeof(header));
+        EXPECT_EQ(header.type, data::DataType::Struct);
+        EXPECT_EQ(header.subtype, RTT_MONITOR_SCHEMA_ID);
+        ASSERT_EQ(header.size, sizeof(SystemStats));
+        EXPECT_EQ(offset + sizeof(header) + header.size, sent);
+
+        SystemStats stats{};
+        std::memcpy(&stats, &buffer[offset + sizeof(header)], sizeof(stats));
+        EXPECT_EQ(stats.taskCount, 1U);
+        EXPECT_STREQ(stats.name[0], "reporter");
+    }
+} // namespace rtt::test
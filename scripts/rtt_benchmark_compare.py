@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+RTT Benchmark Compare - Collect benchmark suite results and check for regressions
+
+rtt::benchmark::Suite sends one BenchmarkResult Struct packet per benchmark
+run over an rtt_data channel. This tool extracts the results from a captured
+channel, writes them as JSON and compares them against a stored baseline.
+The exit code is non-zero if any benchmark got slower than the threshold,
+so it can gate a hardware-in-the-loop pipeline.
+"""
+
+import argparse
+import json
+import sys
+from dataclasses import asdict, dataclass
+from pathlib import Path
+from typing import Any, Dict, List, Optional
+
+from rtt_data_reader import DataType, RttDataReader
+
+RESULT_SCHEMA_NAME = "rtt::benchmark::BenchmarkResult"
+RESULTS_VERSION = 1
+METRICS = ["min", "mean", "max", "stddev", "p50", "p90", "p99", "p999"]
+
+
+@dataclass
+class BenchmarkRecord:
+    """Result of one benchmark run (times in timebase ticks)"""
+
+    name: str
+    argument: int
+    iterations: int
+    overhead: int
+    frequency: int
+    min: int
+    mean: int
+    max: int
+    stddev: int
+    p50: int
+    p90: int
+    p99: int
+    p999: int
+
+    @classmethod
+    def from_sample(cls, sample: Dict[str, Any]) -> "BenchmarkRecord":
+        """Create a record from a decoded BenchmarkResult struct"""
+        name = bytes(value & 0xFF for value in sample["name"]).split(b"\0", 1)[0].decode("utf-8", errors="replace")
+        return cls(name, *(int(sample[key]) for key in ["argument", "iterations", "overhead", "frequency", *METRICS]))
+
+    def nanoseconds(self, metric: str) -> float:
+        """A metric converted to nanoseconds (ticks if the frequency is unknown)"""
+        ticks = getattr(self, metric)
+        return ticks * 1e9 / self.frequency if self.frequency else float(ticks)
+
+
+@dataclass
+class Comparison:
+    """Comparison of one benchmark against its baseline"""
+
+    name: str
+    baseline: Optional[float]
+    current: Optional[float]
+    status: str  # "ok", "regression", "improvement", "new" or "missing"
+
+    @property
+    def change(self) -> Optional[float]:
+        """Relative change (0.1 = 10% slower)"""
+        if not self.baseline or self.current is None:
+            return None
+        return self.current / self.baseline - 1.0
+
+
+def extract_results(data: bytes) -> List[BenchmarkRecord]:
+    """
+    Extract benchmark results from a captured rtt_data channel
+
+    Args:
+        data: Raw channel bytes
+
+    Returns:
+        Results in the order they were sent
+    """
+    reader = RttDataReader()
+    results = []
+    offset = 0
+    while len(data) - offset >= RttDataReader.HEADER_SIZE:
+        header = reader.parse_header(data[offset : offset + RttDataReader.HEADER_SIZE])
+        end = offset + RttDataReader.HEADER_SIZE + (header.size if header else 0)
+        if header is None or end > len(data):
+            offset += 1
+            continue
+
+        value = reader.parse_data(header, data[offset + RttDataReader.HEADER_SIZE : end])
+        if header.data_type == DataType.Struct and value is not None and reader.schemas[header.reserved].name == RESULT_SCHEMA_NAME:
+            results.append(BenchmarkRecord.from_sample(value))
+        offset = end
+    return results
+
+
+def to_json(results: List[BenchmarkRecord]) -> Dict[str, Any]:
+    """Convert results to the JSON document format (later runs of a name win)"""
+    return {"version": RESULTS_VERSION, "results": {record.name: asdict(record) for record in results}}
+
+
+def load_json(path: str) -> Dict[str, BenchmarkRecord]:
+    """Load a results or baseline JSON file"""
+    document = json.loads(Path(path).read_text())
+    if document.get("version") != RESULTS_VERSION:
+        msg = f"unsupported results version {document.get('version')}"
+        raise ValueError(msg)
+    return {name: BenchmarkRecord(**entry) for name, entry in document["results"].items()}
+
+
+def compare(baseline: Dict[str, BenchmarkRecord], current: Dict[str, BenchmarkRecord], metric: str = "p50", threshold: float = 0.05) -> List[Comparison]:
+    """
+    Compare results against a baseline
+
+    Args:
+        baseline: Baseline results by name
+        current: Current results by name
+        metric: Metric to compare (see METRICS)
+        threshold: Allowed relative slowdown, e.g. 0.05 for 5%
+
+    Returns:
+        One comparison per benchmark in either set
+    """
+    comparisons = []
+    for name in sorted(set(baseline) | set(current)):
+        if name not in baseline:
+            comparisons.append(Comparison(name, None, current[name].nanoseconds(metric), "new"))
+            continue
+        if name not in current:
+            comparisons.append(Comparison(name, baseline[name].nanoseconds(metric), None, "missing"))
+            continue
+
+        before = baseline[name].nanoseconds(metric)
+        after = current[name].nanoseconds(metric)
+        status = "ok"
+        if after > before * (1.0 + threshold):
+            status = "regression"
+        elif after < before * (1.0 - threshold):
+            status = "improvement"
+        comparisons.append(Comparison(name, before, after, status))
+    return comparisons
+
+
+def format_comparisons(comparisons: List[Comparison], metric: str) -> List[str]:
+    """Render comparisons as a table"""
+    lines = [f"{'Benchmark':<32} {'Baseline ' + metric:>16} {'Current ' + metric:>16} {'Change':>8}  Status"]
+    for comparison in comparisons:
+        before = f"{comparison.baseline:.0f} ns" if comparison.baseline is not None else "-"
+        after = f"{comparison.current:.0f} ns" if comparison.current is not None else "-"
+        change = f"{comparison.change * 100:+.1f}%" if comparison.change is not None else "-"
+        lines.append(f"{comparison.name:<32} {before:>16} {after:>16} {change:>8}  {comparison.status}")
+    return lines
+
+
+def run(capture: str, output: Optional[str] = None, baseline: Optional[str] = None, metric: str = "p50", threshold: float = 0.05) -> int:
+    """Extract results, optionally write JSON and compare against a baseline"""
+    try:
+        results = extract_results(Path(capture).read_bytes())
+    except OSError as e:
+        print(f"Error reading capture: {e}", file=sys.stderr)
+        return 2
+    if not results:
+        print("No benchmark results found", file=sys.stderr)
+        return 2
+
+    document = to_json(results)
+    if output:
+        Path(output).write_text(json.dumps(document, indent=2) + "\n")
+        print(f"Wrote {len(document['results'])} results to {output}")
+
+    if not baseline:
+        return 0
+
+    try:
+        reference = load_json(baseline)
+    except (OSError, ValueError, KeyError, TypeError) as e:
+        print(f"Error loading baseline: {e}", file=sys.stderr)
+        return 2
+
+    current = {name: BenchmarkRecord(**entry) for name, entry in document["results"].items()}
+    comparisons = compare(reference, current, metric, threshold)
+    for line in format_comparisons(comparisons, metric):
+        print(line)
+
+    regressions = [c for c in comparisons if c.status == "regression"]
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) regressed by more than {threshold * 100:.1f}%")
+        return 1
+    return 0
+
+
+def main():
+    """Main entry point"""
+    parser = argparse.ArgumentParser(
+        description="RTT Benchmark Compare - Collect rtt_benchmark suite results and detect regressions",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  # Store results of a run as the new baseline
+  %(prog)s --file bench.bin --output baseline.json
+
+  # Fail if any benchmark's median got more than 5%% slower
+  %(prog)s --file bench.bin --baseline baseline.json --output current.json
+
+  # Compare the 99th percentile with a 10%% tolerance
+  %(prog)s --file bench.bin --baseline baseline.json --metric p99 --threshold 10
+        """,
+    )
+
+    parser.add_argument("-f", "--file", required=True, help="Captured rtt_data channel containing BenchmarkResult records")
+    parser.add_argument("-o", "--output", help="Write results as JSON")
+    parser.add_argument("-b", "--baseline", help="Baseline JSON to compare against")
+    parser.add_argument("-m", "--metric", choices=METRICS, default="p50", help="Metric to compare (default: p50)")
+    parser.add_argument("-t", "--threshold", type=float, default=5.0, help="Allowed slowdown in percent (default: 5)")
+
+    args = parser.parse_args()
+    return run(args.file, args.output, args.baseline, args.metric, args.threshold / 100.0)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
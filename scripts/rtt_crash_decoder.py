@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""
+RTT Crash Decoder - Host-side decoding of rtt_fault_handler crash records
+
+With ReportFormat::Binary the fault handler sends one compact 'RC' record
+instead of a text report. This tool finds the records in a captured RTT
+channel (or a RAM dump of the preserved record), decodes registers and fault
+status, and resolves the PC, LR and candidate return addresses to function
+names using the symbol table of the firmware ELF file.
+"""
+
+import argparse
+import bisect
+import struct
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import List, Optional, Tuple
+
+from rtt_elf import ElfFile
+
+FAULT_TYPES = ["HardFault", "MemManage Fault", "BusFault", "UsageFault", "Unknown Fault"]
+
+# CFSR bit -> (name, description), must match rtt_fault_handler.cpp
+CFSR_BITS = {
+    0: ("IACCVIOL", "Instruction access violation"),
+    1: ("DACCVIOL", "Data access violation"),
+    3: ("MUNSTKERR", "MemManage fault on unstacking"),
+    4: ("MSTKERR", "MemManage fault on stacking"),
+    5: ("MLSPERR", "MemManage fault during lazy FP state preservation"),
+    7: ("MMARVALID", "MMFAR valid"),
+    8: ("IBUSERR", "Instruction bus error"),
+    9: ("PRECISERR", "Precise data bus error"),
+    10: ("IMPRECISERR", "Imprecise data bus error"),
+    11: ("UNSTKERR", "BusFault on unstacking"),
+    12: ("STKERR", "BusFault on stacking"),
+    13: ("LSPERR", "BusFault during lazy FP state preservation"),
+    15: ("BFARVALID", "BFAR valid"),
+    16: ("UNDEFINSTR", "Undefined instruction"),
+    17: ("INVSTATE", "Invalid state"),
+    18: ("INVPC", "Invalid PC load"),
+    19: ("NOCP", "No coprocessor"),
+    24: ("UNALIGNED", "Unaligned access"),
+    25: ("DIVBYZERO", "Divide by zero"),
+}
+
+HFSR_BITS = {1: ("VECTTBL", "Vector table read fault"), 30: ("FORCED", "Escalated configurable fault"), 31: ("DEBUGEVT", "Debug event")}
+
+REGISTER_NAMES = ["r0", "r1", "r2", "r3", "r12", "lr", "pc", "psr"]
+
+
+@dataclass
+class CrashRecord:
+    """Decoded crash record"""
+
+    fault_type: int
+    flags: int
+    registers: List[int]
+    exc_return: int
+    sp: int
+    cfsr: int
+    hfsr: int
+    mmfar: int
+    bfar: int
+    fpu: List[int]
+    return_addresses: List[int] = field(default_factory=list)
+
+    FLAG_PSP = 0x01
+    FLAG_FPU_FRAME = 0x02
+
+    @property
+    def fault_name(self) -> str:
+        """Name of the fault type"""
+        return FAULT_TYPES[self.fault_type] if self.fault_type < len(FAULT_TYPES) else FAULT_TYPES[-1]
+
+    @property
+    def pc(self) -> int:
+        """Faulting program counter"""
+        return self.registers[6]
+
+    @property
+    def lr(self) -> int:
+        """Link register of the faulting code"""
+        return self.registers[5]
+
+    @property
+    def uses_psp(self) -> bool:
+        """True if the process stack (a task) was active"""
+        return bool(self.flags & self.FLAG_PSP)
+
+    @property
+    def has_fpu_frame(self) -> bool:
+        """True if the FP context was stacked"""
+        return bool(self.flags & self.FLAG_FPU_FRAME)
+
+
+class Symbolizer:
+    """Resolve code addresses to function names"""
+
+    def __init__(self, functions: Optional[List[Tuple[int, int, str]]] = None):
+        """
+        Initialize symbolizer
+
+        Args:
+            functions: (address, size, name) of each function
+        """
+        self.functions = sorted(functions or [])
+        self._starts = [f[0] for f in self.functions]
+
+    @classmethod
+    def from_elf(cls, elf_path: str) -> "Symbolizer":
+        """Create a symbolizer from the function symbols of an ELF file"""
+        elf = ElfFile.from_file(elf_path)
+        # Thumb function symbols have bit 0 set
+        return cls([(s.value & ~1, s.size, s.name) for s in elf.symbols() if s.is_function and s.name])
+
+    def lookup(self, address: int) -> Optional[Tuple[str, int]]:
+        """Find the function containing address, returns (name, offset)"""
+        index = bisect.bisect_right(self._starts, address) - 1
+        if index < 0:
+            return None
+        start, size, name = self.functions[index]
+        if address >= start + max(size, 1):
+            return None
+        return name, address - start
+
+    def describe(self, address: int) -> str:
+        """Format an address with its symbol, e.g. '0x08000124 main+0x4'"""
+        address &= ~1
+        symbol = self.lookup(address)
+        if symbol is None:
+            return f"0x{address:08X}"
+        name, offset = symbol
+        return f"0x{address:08X} {name}+0x{offset:x}"
+
+
+class CrashDecoder:
+    """Decoder for binary crash records"""
+
+    MAGIC = b"RC"
+    VERSION = 1
+    HEADER_FORMAT = "<2sBBBBH"
+    FIXED_FORMAT = "<2sBBBBH8IIIIIII17I"
+    FIXED_SIZE = struct.calcsize(FIXED_FORMAT)
+
+    @classmethod
+    def parse_record(cls, data: bytes, offset: int = 0) -> Tuple[Optional[CrashRecord], int]:
+        """
+        Parse one record at offset
+
+        Returns:
+            Tuple of (record or None, bytes consumed); (None, 0) if not a valid record
+        """
+        if len(data) - offset < cls.FIXED_SIZE:
+            return None, 0
+
+        magic, version, fault_type, flags, count, size = struct.unpack_from(cls.HEADER_FORMAT, data, offset)
+        if magic != cls.MAGIC or version != cls.VERSION or size != cls.FIXED_SIZE + 4 * count or offset + size > len(data):
+            return None, 0
+
+        fields = struct.unpack_from(cls.FIXED_FORMAT, data, offset)
+        registers = list(fields[6:14])
+        exc_return, sp, cfsr, hfsr, mmfar, bfar = fields[14:20]
+        fpu = list(fields[20:37])
+        addresses = list(struct.unpack_from(f"<{count}I", data, offset + cls.FIXED_SIZE))
+        return CrashRecord(fault_type, flags, registers, exc_return, sp, cfsr, hfsr, mmfar, bfar, fpu, addresses), size
+
+    @classmethod
+    def find_records(cls, data: bytes) -> List[CrashRecord]:
+        """Find all crash records in a captured stream"""
+        records = []
+        offset = data.find(cls.MAGIC)
+        while offset >= 0:
+            record, consumed = cls.parse_record(data, offset)
+            if record is not None:
+                records.append(record)
+                offset += consumed
+            else:
+                offset += 1
+            offset = data.find(cls.MAGIC, offset)
+        return records
+
+    @staticmethod
+    def decode_bits(value: int, table: dict) -> List[str]:
+        """List the set bits of a status register as 'NAME: description'"""
+        return [f"{name}: {text}" for bit, (name, text) in sorted(table.items()) if value & (1 << bit)]
+
+    @classmethod
+    def format_record(cls, record: CrashRecord, symbolizer: Optional[Symbolizer] = None) -> List[str]:
+        """Render a record as report lines"""
+        symbolizer = symbolizer or Symbolizer()
+        lines = [f"Fault Type: {record.fault_name}", f"Stack: {'PSP (task)' if record.uses_psp else 'MSP (handler/main)'} at 0x{record.sp:08X}"]
+        lines.append(f"EXC_RETURN = 0x{record.exc_return:08X}")
+
+        lines.append("")
+        lines.append("--- CPU Registers ---")
+        for name, value in zip(REGISTER_NAMES, record.registers):
+            text = symbolizer.describe(value) if name in ("pc", "lr") else f"0x{value:08X}"
+            lines.append(f"{name.upper():<3} = {text}")
+
+        lines.append("")
+        lines.append("--- Fault Status Registers ---")
+        lines.append(f"CFSR  = 0x{record.cfsr:08X}")
+        lines.extend(f"  {text}" for text in cls.decode_bits(record.cfsr, CFSR_BITS))
+        lines.append(f"HFSR  = 0x{record.hfsr:08X}")
+        lines.extend(f"  {text}" for text in cls.decode_bits(record.hfsr, HFSR_BITS))
+        if record.cfsr & (1 << 7):
+            lines.append(f"MMFAR = 0x{record.mmfar:08X}")
+        if record.cfsr & (1 << 15):
+            lines.append(f"BFAR  = 0x{record.bfar:08X}")
+
+        if record.has_fpu_frame:
+            lines.append("")
+            lines.append("--- FPU Registers ---")
+            for index in range(16):
+                value = record.fpu[index]
+                lines.append(f"S{index:<2} = 0x{value:08X} ({struct.unpack('<f', struct.pack('<I', value))[0]:g})")
+            lines.append(f"FPSCR = 0x{record.fpu[16]:08X}")
+
+        lines.append("")
+        lines.append("--- Call Stack (candidates) ---")
+        lines.append(f"  #0 {symbolizer.describe(record.pc)}")
+        lines.append(f"  #1 {symbolizer.describe(record.lr)}")
+        for index, address in enumerate(record.return_addresses, start=2):
+            lines.append(f"  #{index} {symbolizer.describe(address)}")
+        return lines
+
+
+def decode_file(input_path: str, elf_path: Optional[str] = None) -> int:
+    """Decode all crash records in a file and print them"""
+    symbolizer = None
+    if elf_path:
+        try:
+            symbolizer = Symbolizer.from_elf(elf_path)
+        except (OSError, ValueError) as e:
+            print(f"Error loading ELF: {e}", file=sys.stderr)
+            return 1
+
+    try:
+        data = Path(input_path).read_bytes()
+    except OSError as e:
+        print(f"Error reading file: {e}", file=sys.stderr)
+        return 1
+
+    records = CrashDecoder.find_records(data)
+    if not records:
+        print("No crash records found", file=sys.stderr)
+        return 1
+
+    for index, record in enumerate(records):
+        print(f"=== Crash Record {index + 1} ===")
+        for line in CrashDecoder.format_record(record, symbolizer):
+            print(line)
+        print()
+    return 0
+
+
+def main():
+    """Main entry point"""
+    parser = argparse.ArgumentParser(
+        description="RTT Crash Decoder - Decode rtt_fault_handler crash records",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  # Decode a captured RTT channel
+  %(prog)s --file rtt_log.bin
+
+  # Resolve addresses to function names
+  %(prog)s --file rtt_log.bin --elf firmware.elf
+        """,
+    )
+
+    parser.add_argument("-f", "--file", required=True, help="Captured RTT data or RAM dump containing crash records")
+    parser.add_argument("-e", "--elf", help="Firmware ELF file for symbol lookup")
+
+    args = parser.parse_args()
+    return decode_file(args.file, args.elf)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
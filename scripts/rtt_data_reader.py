@@ -4,7 +4,8 @@ RTT Data Reader - Host-side data reading and formatting tool
 
 This script reads structured data sent via RTT from embedded devices using
 the rtt_data C++ library. It decodes the data packets and formats them for
-display or further analysis.
+display or further analysis. Memory dumps streamed in raw form are rendered
+as hex and ASCII here and can be saved as binary images.
 """
 
 import argparse
@@ -13,7 +14,8 @@ import sys
 import time
 from dataclasses import dataclass
 from enum import IntEnum
-from typing import Any, Optional, Tuple
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple
 
 
 class DataType(IntEnum):
@@ -31,6 +33,10 @@ class DataType(IntEnum):
     Double = 9
     String = 10
     Binary = 11
+    Array = 12
+    Schema = 13
+    Struct = 14
+    Memory = 15
 
 
 @dataclass
@@ -43,12 +49,117 @@ class DataHeader:
     size: int
     timestamp: int
 
+    @property
+    def element_type(self) -> Optional[DataType]:
+        """Element type of an Array packet (stored in the reserved byte)"""
+        if self.data_type != DataType.Array:
+            return None
+        try:
+            return DataType(self.reserved)
+        except ValueError:
+            return None
+
+    @property
+    def schema_id(self) -> Optional[int]:
+        """Schema ID of a Schema or Struct packet (stored in the reserved byte)"""
+        if self.data_type not in (DataType.Schema, DataType.Struct):
+            return None
+        return self.reserved
+
+
+@dataclass
+class SchemaField:
+    """Field of a registered struct"""
+
+    name: str
+    data_type: DataType
+    offset: int
+    count: int  # Number of elements, bytes for Binary fields
+
+
+@dataclass
+class StructSchema:
+    """Field layout of a registered struct (from a Schema packet)"""
+
+    schema_id: int
+    name: str
+    size: int
+    fields: List[SchemaField]
+
+    def decode(self, payload: bytes) -> Dict[str, Any]:
+        """
+        Decode the raw bytes of one struct sample
+
+        Args:
+            payload: Struct bytes
+
+        Returns:
+            Mapping of field name to value (lists for array fields, hex for Binary fields)
+        """
+        sample: Dict[str, Any] = {}
+        for schema_field in self.fields:
+            if schema_field.data_type not in RttDataReader.TYPE_FORMATS:
+                sample[schema_field.name] = payload[schema_field.offset : schema_field.offset + schema_field.count].hex()
+                continue
+            code = RttDataReader.TYPE_FORMATS[schema_field.data_type][-1]
+            values = struct.unpack_from(f"<{schema_field.count}{code}", payload, schema_field.offset)
+            sample[schema_field.name] = values[0] if schema_field.count == 1 else list(values)
+        return sample
+
+
+@dataclass
+class MemoryChunk:
+    """Bytes of target memory from a Memory packet (MemoryDumper DumpFormat::Raw)"""
+
+    address: int
+    data: bytes
+
+    def hexdump(self, bytes_per_line: int = 16) -> List[str]:
+        """Render the chunk as hex and ASCII lines, like the target's HexAscii format"""
+        lines = []
+        for offset in range(0, len(self.data), bytes_per_line):
+            line = self.data[offset : offset + bytes_per_line]
+            ascii_text = "".join(chr(b) if 32 <= b <= 126 else "." for b in line)
+            lines.append(f"0x{self.address + offset:08X}: {line.hex(' ').upper():<{bytes_per_line * 3}} | {ascii_text}")
+        return lines
+
+
+def merge_memory(chunks: List[MemoryChunk]) -> List[MemoryChunk]:
+    """
+    Merge Memory packets into contiguous regions
+
+    Args:
+        chunks: Chunks in any order; later chunks overwrite earlier bytes
+
+    Returns:
+        Regions sorted by address (gaps left by dropped packets split regions)
+    """
+    image: Dict[int, int] = {}
+    for chunk in chunks:
+        for offset, value in enumerate(chunk.data):
+            image[chunk.address + offset] = value
+
+    regions: List[MemoryChunk] = []
+    start = None
+    data = bytearray()
+    for address in sorted(image):
+        if start is not None and address != start + len(data):
+            regions.append(MemoryChunk(start, bytes(data)))
+            start = None
+        if start is None:
+            start = address
+            data = bytearray()
+        data.append(image[address])
+    if start is not None:
+        regions.append(MemoryChunk(start, bytes(data)))
+    return regions
+
 
 class RttDataReader:
     """Reader for RTT data packets"""
 
     MAGIC_BYTES = b"RD"
-    HEADER_SIZE = 12  # 2 (magic) + 1 (type) + 1 (reserved) + 4 (size) + 4 (timestamp)
+    HEADER_SIZE = 12  # 2 (magic) + 1 (type) + 1 (reserved/element type) + 4 (size) + 4 (timestamp)
     HEADER_FORMAT = "<2sBBII"  # Little-endian: 2 bytes, byte, byte, uint32, uint32
 
     # Type format strings for struct.unpack
@@ -75,6 +186,9 @@ class RttDataReader:
         self.verbose = verbose
         self.packet_count = 0
         self.error_count = 0
+        self.schemas: Dict[int, StructSchema] = {}
+        self.columns: Dict[int, Dict[str, List[Any]]] = {}
+        self.memory: List[MemoryChunk] = []
 
     def parse_header(self, data: bytes) -> Optional[DataHeader]:
         """
@@ -140,6 +254,18 @@ class RttDataReader:
             if header.data_type == DataType.Binary:
                 return payload.hex()
 
+            # Handle sample arrays
+            if header.data_type == DataType.Array:
+                return self.parse_array(header, payload)
+
+            # Handle registered structs
+            if header.data_type == DataType.Schema:
+                return self.parse_schema(header, payload)
+            if header.data_type == DataType.Struct:
+                return self.parse_struct(header, payload)
+            if header.data_type == DataType.Memory:
+                return self.parse_memory(header, payload)
+
             # Handle numeric types
             if header.data_type in self.TYPE_FORMATS:
                 fmt = self.TYPE_FORMATS[header.data_type]
@@ -154,6 +280,127 @@ class RttDataReader:
                 print(f"Data parsing error: {e}", file=sys.stderr)
             return None
 
+    def parse_array(self, header: DataHeader, payload: bytes) -> Optional[List[Any]]:
+        """
+        Parse the payload of an Array packet
+
+        Args:
+            header: Data header (element type in the reserved byte)
+            payload: Packed samples
+
+        Returns:
+            List of sample values or None on error
+        """
+        element_type = header.element_type
+        if element_type not in self.TYPE_FORMATS:
+            if self.verbose:
+                print(f"Invalid array element type: {header.reserved}", file=sys.stderr)
+            return None
+
+        code = self.TYPE_FORMATS[element_type][-1]
+        element_size = struct.calcsize(code)
+        if len(payload) % element_size != 0:
+            if self.verbose:
+                print(f"Array size {len(payload)} is not a multiple of {element_size}", file=sys.stderr)
+            return None
+
+        return list(struct.unpack(f"<{len(payload) // element_size}{code}", payload))
+
+    def parse_schema(self, header: DataHeader, payload: bytes) -> Optional[StructSchema]:
+        """
+        Parse a Schema packet and register the struct layout
+
+        Args:
+            header: Data header (schema ID in the reserved byte)
+            payload: Descriptor bytes
+
+        Returns:
+            StructSchema or None on error
+        """
+        try:
+            size, field_count = struct.unpack_from("<HB", payload, 0)
+            name, offset = self._read_name(payload, 3)
+            fields = []
+            for _ in range(field_count):
+                data_type, field_offset, count = struct.unpack_from("<BHH", payload, offset)
+                field_name, offset = self._read_name(payload, offset + 5)
+                if field_offset + self._field_size(DataType(data_type), count) > size:
+                    raise ValueError(f"field {field_name} exceeds struct size")
+                fields.append(SchemaField(field_name, DataType(data_type), field_offset, count))
+        except (struct.error, ValueError) as e:
+            if self.verbose:
+                print(f"Invalid schema descriptor: {e}", file=sys.stderr)
+            return None
+
+        schema = StructSchema(header.reserved, name, size, fields)
+        if self.schemas.get(schema.schema_id) != schema:
+            self.columns[schema.schema_id] = {f.name: [] for f in fields}
+        self.schemas[schema.schema_id] = schema
+        return schema
+
+    def parse_struct(self, header: DataHeader, payload: bytes) -> Optional[Dict[str, Any]]:
+        """
+        Decode a Struct packet with its registered schema
+
+        Args:
+            header: Data header (schema ID in the reserved byte)
+            payload: Raw struct bytes
+
+        Returns:
+            Mapping of field name to value or None if the schema is unknown
+        """
+        schema = self.schemas.get(header.reserved)
+        if schema is None or len(payload) != schema.size:
+            if self.verbose:
+                print(f"No matching schema for struct packet (id {header.reserved}, {len(payload)} bytes)", file=sys.stderr)
+            return None
+
+        sample = schema.decode(payload)
+        for name, value in sample.items():
+            self.columns[schema.schema_id][name].append(value)
+        return sample
+
+    def parse_memory(self, header: DataHeader, payload: bytes) -> Optional[MemoryChunk]:
+        """
+        Parse a Memory packet and collect it for merge_memory
+
+        Args:
+            header: Data header (address size in bytes in the reserved byte)
+            payload: Little-endian start address followed by the bytes
+
+        Returns:
+            MemoryChunk or None on error
+        """
+        if header.reserved not in (4, 8) or len(payload) < header.reserved:
+            if self.verbose:
+                print(f"Invalid memory packet (address size {header.reserved}, {len(payload)} bytes)", file=sys.stderr)
+            return None
+
+        chunk = MemoryChunk(int.from_bytes(payload[: header.reserved], "little"), payload[header.reserved :])
+        self.memory.append(chunk)
+        return chunk
+
+    def get_columns(self, schema_id: int) -> Dict[str, List[Any]]:
+        """Get all decoded samples of a struct as named columns"""
+        return self.columns.get(schema_id, {})
+
+    @staticmethod
+    def _read_name(payload: bytes, offset: int) -> Tuple[str, int]:
+        """Read a length-prefixed name, returns (name, offset after it)"""
+        length = payload[offset]
+        end = offset + 1 + length
+        if end > len(payload):
+            msg = "truncated name"
+            raise ValueError(msg)
+        return payload[offset + 1 : end].decode("utf-8", errors="replace"), end
+
+    @classmethod
+    def _field_size(cls, data_type: DataType, count: int) -> int:
+        """Size of a schema field in bytes"""
+        if data_type in cls.TYPE_FORMATS:
+            return count * struct.calcsize(cls.TYPE_FORMATS[data_type][-1])
+        return count
+
     def format_value(self, header: DataHeader, value: Any) -> str:
         """
         Format a value for display
@@ -173,6 +420,22 @@ class RttDataReader:
             return f'[{type_name}] "{value}"'
         if header.data_type in [DataType.Float, DataType.Double]:
             return f"[{type_name}] {value:.6f}"
+        if header.data_type == DataType.Array:
+            element_type = header.element_type
+            if element_type in [DataType.Float, DataType.Double]:
+                items = ", ".join(f"{v:.6f}" for v in value)
+            else:
+                items = ", ".join(str(v) for v in value)
+            return f"[{element_type.name}[{len(value)}]] [{items}]"
+        if header.data_type == DataType.Schema:
+            fields = ", ".join(f"{f.name}: {f.data_type.name}" + (f"[{f.count}]" if f.count > 1 else "") for f in value.fields)
+            return f"[{type_name}] {value.name} (id {value.schema_id}): {fields}"
+        if header.data_type == DataType.Memory:
+            return "\n".join([f"[{type_name}] 0x{value.address:08X}, {len(value.data)} bytes", *value.hexdump()])
+        if header.data_type == DataType.Struct:
+            name = self.schemas[header.reserved].name
+            items = ", ".join(f"{k}={v:.6f}" if isinstance(v, float) else f"{k}={v}" for k, v in value.items())
+            return f"[{name}] {items}"
         return f"[{type_name}] {value}"
 
     def process_packet(self, data: bytes) -> Tuple[Optional[Any], int]:
@@ -197,21 +460,28 @@ class RttDataReader:
             # Not enough data yet
             return None, 0
 
-        # Parse data payload
-        payload = data[self.HEADER_SIZE : total_size]
-        value = self.parse_data(header, payload)
+        return self.process_payload(header, bytes(data[self.HEADER_SIZE : total_size])), total_size
 
-        if value is not None:
-            self.packet_count += 1
+    def process_payload(self, header: DataHeader, payload: bytes) -> Optional[Any]:
+        """
+        Parse and print the payload of a framed packet
 
-            # Format output
-            timestamp_str = f"[{header.timestamp:06d}] " if header.timestamp > 0 else ""
-            formatted = self.format_value(header, value)
-            print(f"{timestamp_str}{formatted}")
+        Args:
+            header: Packet header
+            payload: header.size payload bytes
+
+        Returns:
+            Parsed value or None on error
+        """
+        value = self.parse_data(header, payload)
+        if value is None:
+            self.error_count += 1
+            return None
 
-            return value, total_size
-        self.error_count += 1
-        return None, total_size
+        self.packet_count += 1
+        timestamp_str = f"[{header.timestamp:06d}] " if header.timestamp > 0 else ""
+        print(f"{timestamp_str}{self.format_value(header, value)}")
+        return value
 
 
 def read_from_rtt(backend: str, channel: int = 1, **kwargs) -> None:
@@ -281,34 +551,84 @@ def read_from_rtt(backend: str, channel: int = 1, **kwargs) -> None:
         rtt.disconnect()
 
 
-def read_from_file(filename: str, verbose: bool = False) -> None:
+def write_memory(chunks: List[MemoryChunk], directory: str) -> List[Path]:
+    """
+    Write the memory regions received in Memory packets as binary images
+
+    Args:
+        chunks: Received chunks
+        directory: Output directory, one file per contiguous region
+
+    Returns:
+        Paths of the written files
+    """
+    output = Path(directory)
+    output.mkdir(parents=True, exist_ok=True)
+    paths = []
+    for region in merge_memory(chunks):
+        path = output / f"memory_0x{region.address:08X}.bin"
+        path.write_bytes(region.data)
+        paths.append(path)
+    return paths
+
+
+def read_native(reader: RttDataReader, filename: str) -> int:
+    """
+    Frame the packets of a capture with the rtt_host C++ library
+
+    The library memory-maps the file and finds the packets; only their
+    payloads are copied into Python for decoding.
+
+    Returns:
+        Bytes skipped because they did not start a packet
+
+    Raises:
+        RuntimeError: If the library is not available or the file cannot be mapped
+    """
+    import rtt_host  # pylint: disable=import-outside-toplevel
+
+    print(f"Processing {Path(filename).stat().st_size} bytes from {filename} (native)...\n")
+    with rtt_host.NativeDataStream(filename) as stream:
+        for packet in stream:
+            header = DataHeader(RttDataReader.MAGIC_BYTES, DataType(packet.type), packet.subtype, len(packet.payload), packet.timestamp)
+            reader.process_payload(header, packet.payload.tobytes())
+        return stream.skipped_bytes
+
+
+def read_from_file(filename: str, verbose: bool = False, memory_dir: Optional[str] = None, native: bool = False) -> None:
     """
     Read and parse data from a binary file
 
     Args:
         filename: Path to binary file
         verbose: Enable verbose output
+        memory_dir: Write received memory dumps as binary images to this directory
+        native: Frame packets with the rtt_host C++ library (scripts/rtt_host.py)
     """
     reader = RttDataReader(verbose=verbose)
 
     try:
-        with open(filename, "rb") as f:
-            data = f.read()
-
-        buffer = bytearray(data)
+        if native:
+            skipped = read_native(reader, filename)
+            print(f"\nPackets processed: {reader.packet_count}, Errors: {reader.error_count}, Skipped bytes: {skipped}")
+        else:
+            with open(filename, "rb") as f:
+                data = f.read()
 
-        print(f"Processing {len(buffer)} bytes from {filename}...\n")
+            print(f"Processing {len(data)} bytes from {filename}...\n")
 
-        while len(buffer) >= RttDataReader.HEADER_SIZE:
-            _, consumed = reader.process_packet(bytes(buffer))
+            view = memoryview(data)
+            offset = 0
+            while len(data) - offset >= RttDataReader.HEADER_SIZE:
+                _, consumed = reader.process_packet(view[offset:])
+                # Skip one byte and try again if no packet starts here
+                offset += consumed if consumed > 0 else 1
 
-            if consumed > 0:
-                buffer = buffer[consumed:]
-            else:
-                # Skip one byte and try again
-                buffer = buffer[1:]
+            print(f"\nPackets processed: {reader.packet_count}, Errors: {reader.error_count}")
 
-        print(f"\nPackets processed: {reader.packet_count}, Errors: {reader.error_count}")
+        if memory_dir and reader.memory:
+            for path in write_memory(reader.memory, memory_dir):
+                print(f"Wrote {path} ({path.stat().st_size} bytes)")
 
     except FileNotFoundError:
         print(f"File not found: {filename}", file=sys.stderr)
@@ -332,6 +652,12 @@ Examples:
   # Parse binary file
   %(prog)s --file data.bin
 
+  # Parse a large capture with the rtt_host C++ library
+  %(prog)s --file data.bin --native
+
+  # Save memory dumps (DumpFormat::Raw) as binary images
+  %(prog)s --file data.bin --memory-dir dumps
+
   # Verbose output
   %(prog)s --backend openocd --verbose
         """,
@@ -344,13 +670,15 @@ Examples:
     parser.add_argument("-i", "--interface", default="SWD", choices=["SWD", "JTAG"], help="Debug interface (for J-Link, default: SWD)")
     parser.add_argument("--host", default="localhost", help="OpenOCD host (default: localhost)")
     parser.add_argument("-p", "--port", type=int, default=4444, help="OpenOCD port (default: 4444)")
+    parser.add_argument("-m", "--memory-dir", help="Write received memory dumps as binary images to this directory (with --file)")
+    parser.add_argument("--native", action="store_true", help="Frame packets of --file with the rtt_host C++ library (see scripts/rtt_host.py)")
     parser.add_argument("-v", "--verbose", action="store_true", help="Enable verbose output")
 
     args = parser.parse_args()
 
     # Read from file or RTT
     if args.file:
-        read_from_file(args.file, args.verbose)
+        read_from_file(args.file, args.verbose, args.memory_dir, args.native)
     elif args.backend:
         read_from_rtt(backend=args.backend, channel=args.channel, device=args.device, interface=args.interface, host=args.host, port=args.port, verbose=args.verbose)
     else:
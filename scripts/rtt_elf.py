@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""
+RTT ELF - Minimal ELF reader for host-side RTT tools
+
+This module reads the parts of an ELF file the RTT host tools need (section
+headers, section contents and the symbol table) without external
+dependencies. Both 32-bit and 64-bit, little and big endian files are
+supported so the same code works for target images and host test builds.
+"""
+
+import struct
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional, Union
+
+
+@dataclass
+class ElfSection:
+    """Section header entry"""
+
+    name: str
+    type: int
+    flags: int
+    address: int
+    offset: int
+    size: int
+
+
+@dataclass
+class ElfSymbol:
+    """Symbol table entry"""
+
+    name: str
+    value: int
+    size: int
+    info: int
+    section_index: int
+
+    @property
+    def is_function(self) -> bool:
+        """Check if the symbol is a function (STT_FUNC)"""
+        return (self.info & 0x0F) == 2
+
+
+class ElfError(ValueError):
+    """Raised for files that are not valid ELF images"""
+
+
+class ElfFile:
+    """Read-only view of an ELF file"""
+
+    ELF_MAGIC = b"\x7fELF"
+    SHT_NOBITS = 8
+    SHT_SYMTAB = 2
+
+    def __init__(self, data: bytes):
+        """
+        Parse an ELF image
+
+        Args:
+            data: Complete ELF file contents
+        """
+        if len(data) < 16 or data[:4] != self.ELF_MAGIC:
+            msg = "Not an ELF file"
+            raise ElfError(msg)
+
+        self.data = data
+        self.is_64bit = data[4] == 2
+        self.endian = "<" if data[5] == 1 else ">"
+        self.sections: List[ElfSection] = []
+        self._parse_sections()
+
+    @classmethod
+    def from_file(cls, path: Union[str, Path]) -> "ElfFile":
+        """Load and parse an ELF file from disk"""
+        return cls(Path(path).read_bytes())
+
+    def _unpack(self, fmt: str, offset: int) -> tuple:
+        """Unpack a structure at the given file offset"""
+        fmt = self.endian + fmt
+        size = struct.calcsize(fmt)
+        if offset < 0 or offset + size > len(self.data):
+            msg = f"Truncated ELF file (offset {offset})"
+            raise ElfError(msg)
+        return struct.unpack_from(fmt, self.data, offset)
+
+    def _parse_sections(self) -> None:
+        """Parse section headers and resolve their names"""
+        if self.is_64bit:
+            shoff = self._unpack("Q", 0x28)[0]
+            shentsize, shnum, shstrndx = self._unpack("HHH", 0x3A)
+            header_format = "IIQQQQIIQQ"
+        else:
+            shoff = self._unpack("I", 0x20)[0]
+            shentsize, shnum, shstrndx = self._unpack("HHH", 0x2E)
+            header_format = "IIIIIIIIII"
+
+        raw = []
+        for index in range(shnum):
+            fields = self._unpack(header_format, shoff + index * shentsize)
+            # name, type, flags, addr, offset, size
+            raw.append(fields[:6])
+
+        names = b""
+        if 0 <= shstrndx < len(raw):
+            _, _, _, _, str_offset, str_size = raw[shstrndx]
+            names = self.data[str_offset : str_offset + str_size]
+
+        for name_offset, sh_type, flags, address, offset, size in raw:
+            self.sections.append(ElfSection(self._cstring(names, name_offset), sh_type, flags, address, offset, size))
+
+    @staticmethod
+    def _cstring(table: bytes, offset: int) -> str:
+        """Read a NUL-terminated string from a string table"""
+        if offset >= len(table):
+            return ""
+        end = table.find(b"\x00", offset)
+        if end < 0:
+            end = len(table)
+        return table[offset:end].decode("utf-8", errors="replace")
+
+    def get_section(self, name: str) -> Optional[ElfSection]:
+        """Find a section by exact name"""
+        for section in self.sections:
+            if section.name == name:
+                return section
+        return None
+
+    def find_sections(self, prefix: str) -> List[ElfSection]:
+        """Find sections named `prefix` or `prefix.*`"""
+        return [s for s in self.sections if s.name == prefix or s.name.startswith(prefix + ".")]
+
+    def section_data(self, section: ElfSection) -> bytes:
+        """Get the file contents of a section (empty for NOBITS sections)"""
+        if section.type == self.SHT_NOBITS:
+            return b""
+        return self.data[section.offset : section.offset + section.size]
+
+    def strings_in_sections(self, prefix: str) -> Dict[int, str]:
+        """
+        Collect NUL-terminated strings from matching sections keyed by address
+
+        Args:
+            prefix: Section name prefix (e.g. ".rtt_fmt")
+
+        Returns:
+            Mapping of string address to string
+        """
+        strings: Dict[int, str] = {}
+        for section in self.find_sections(prefix):
+            data = self.section_data(section)
+            pos = 0
+            while pos < len(data):
+                end = data.find(b"\x00", pos)
+                if end < 0:
+                    end = len(data)
+                if end > pos:
+                    strings[section.address + pos] = data[pos:end].decode("utf-8", errors="replace")
+                pos = end + 1
+        return strings
+
+    def symbols(self) -> List[ElfSymbol]:
+        """Read all entries of the symbol table (.symtab)"""
+        result: List[ElfSymbol] = []
+        for section in self.sections:
+            if section.type != self.SHT_SYMTAB:
+                continue
+            link = self._section_link(section)
+            names = self.section_data(self.sections[link]) if 0 <= link < len(self.sections) else b""
+            data = self.section_data(section)
+            entry_size = 24 if self.is_64bit else 16
+            for offset in range(0, len(data) - entry_size + 1, entry_size):
+                if self.is_64bit:
+                    name, info, _, shndx, value, size = struct.unpack_from(self.endian + "IBBHQQ", data, offset)
+                else:
+                    name, value, size, info, _, shndx = struct.unpack_from(self.endian + "IIIBBH", data, offset)
+                result.append(ElfSymbol(self._cstring(names, name), value, size, info, shndx))
+        return result
+
+    def _section_link(self, section: ElfSection) -> int:
+        """Get the sh_link field of a section header"""
+        index = self.sections.index(section)
+        if self.is_64bit:
+            shoff = self._unpack("Q", 0x28)[0]
+            shentsize = self._unpack("H", 0x3A)[0]
+            return self._unpack("I", shoff + index * shentsize + 0x28)[0]
+        shoff = self._unpack("I", 0x20)[0]
+        shentsize = self._unpack("H", 0x2E)[0]
+        return self._unpack("I", shoff + index * shentsize + 0x18)[0]
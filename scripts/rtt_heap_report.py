@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""
+RTT Heap Report - Decode rtt::trace::HeapProfiler reports
+
+A report is one HeapSummary Struct packet followed by one HeapCallerStats
+packet per allocating call site and the oldest live allocations as
+HeapLeakCandidate packets. This tool extracts the last complete report from
+a captured rtt_data channel and prints the heap totals, the callers sorted
+by live bytes and the leak candidates. With an ELF file, caller addresses
+are resolved to functions.
+"""
+
+import argparse
+import json
+import sys
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import Any, Dict, List, Optional
+
+from rtt_crash_decoder import Symbolizer
+from rtt_data_reader import DataType, RttDataReader
+
+SUMMARY_SCHEMA_NAME = "rtt::trace::HeapSummary"
+CALLER_SCHEMA_NAME = "rtt::trace::HeapCallerStats"
+LEAK_SCHEMA_NAME = "rtt::trace::HeapLeakCandidate"
+
+
+@dataclass
+class HeapReport:
+    """One decoded HeapProfiler report"""
+
+    summary: Dict[str, int]
+    callers: List[Dict[str, int]] = field(default_factory=list)
+    leaks: List[Dict[str, int]] = field(default_factory=list)
+
+    @property
+    def complete(self) -> bool:
+        """True if all records announced by the summary were received"""
+        return len(self.callers) == self.summary["callers"] and len(self.leaks) == self.summary["leakCandidates"]
+
+    @property
+    def fragmented(self) -> bool:
+        """True if the last failed allocation was smaller than the free heap"""
+        heap_size = self.summary["heapSize"]
+        free = heap_size - self.summary["liveBytes"]
+        return self.summary["failures"] > 0 and heap_size > 0 and self.summary["failedSize"] < free
+
+
+def extract_reports(data: bytes) -> List[HeapReport]:
+    """
+    Extract heap reports from a captured rtt_data channel
+
+    Args:
+        data: Raw channel bytes
+
+    Returns:
+        Reports in the order they were sent
+    """
+    reader = RttDataReader()
+    reports: List[HeapReport] = []
+    offset = 0
+    while len(data) - offset >= RttDataReader.HEADER_SIZE:
+        header = reader.parse_header(data[offset : offset + RttDataReader.HEADER_SIZE])
+        end = offset + RttDataReader.HEADER_SIZE + (header.size if header else 0)
+        if header is None or end > len(data):
+            offset += 1
+            continue
+
+        value = reader.parse_data(header, data[offset + RttDataReader.HEADER_SIZE : end])
+        offset = end
+        if header.data_type != DataType.Struct or value is None:
+            continue
+
+        record = {key: int(number) for key, number in value.items()}
+        name = reader.schemas[header.reserved].name
+        if name == SUMMARY_SCHEMA_NAME:
+            reports.append(HeapReport(record))
+        elif reports and name == CALLER_SCHEMA_NAME:
+            reports[-1].callers.append(record)
+        elif reports and name == LEAK_SCHEMA_NAME:
+            reports[-1].leaks.append(record)
+    return reports
+
+
+def last_report(reports: List[HeapReport]) -> Optional[HeapReport]:
+    """The last complete report (the last one if none is complete)"""
+    complete = [report for report in reports if report.complete]
+    if complete:
+        return complete[-1]
+    return reports[-1] if reports else None
+
+
+def format_report(report: HeapReport, symbolizer: Optional[Symbolizer] = None) -> List[str]:
+    """Render a report as text"""
+
+    def describe(address: int) -> str:
+        if address == 0:
+            return "(other callers)"
+        return symbolizer.describe(address) if symbolizer else f"0x{address:08X}"
+
+    summary = report.summary
+    lines = [
+        f"Heap size:    {summary['heapSize'] or 'unknown'}",
+        f"Live:         {summary['liveBytes']} bytes in {summary['liveCount']} allocations",
+        f"Peak:         {summary['peakBytes']} bytes",
+        f"Allocations:  {summary['allocations']} ({summary['frees']} freed)",
+    ]
+    if summary["untracked"] or summary["unknownFrees"]:
+        lines.append(f"Untracked:    {summary['untracked']} allocations, {summary['unknownFrees']} unknown frees (live table full)")
+    if summary["failures"]:
+        lines.append(f"Failures:     {summary['failures']}, last {summary['failedSize']} bytes from {describe(summary['failedCaller'])}")
+        if report.fragmented:
+            free = summary["heapSize"] - summary["liveBytes"]
+            lines.append(f"              {free} bytes were free: the heap is fragmented")
+    if not report.complete:
+        lines.append("Warning: report is incomplete")
+
+    lines += ["", f"{'Live bytes':>10} {'Live':>6} {'Peak':>8} {'Allocs':>7} {'Frees':>7} {'Largest':>8}  Caller"]
+    for caller in sorted(report.callers, key=lambda c: (-c["liveBytes"], -c["totalBytes"])):
+        lines.append(
+            f"{caller['liveBytes']:>10} {caller['liveCount']:>6} {caller['peakBytes']:>8} {caller['allocations']:>7} "
+            f"{caller['frees']:>7} {caller['largest']:>8}  {describe(caller['caller'])}"
+        )
+
+    if report.leaks:
+        lines += ["", "Oldest live allocations:", f"{'Address':>10} {'Size':>8} {'Age':>8}  Caller"]
+        for leak in report.leaks:
+            lines.append(f"0x{leak['address']:08X} {leak['size']:>8} {leak['age']:>8}  {describe(leak['caller'])}")
+    return lines
+
+
+def run(capture: str, elf: Optional[str] = None, output: Optional[str] = None) -> int:
+    """Decode the last report of a capture, print it and optionally write it as JSON"""
+    try:
+        reports = extract_reports(Path(capture).read_bytes())
+        symbolizer = Symbolizer.from_elf(elf) if elf else None
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 2
+
+    report = last_report(reports)
+    if report is None:
+        print("No heap report found", file=sys.stderr)
+        return 2
+
+    for line in format_report(report, symbolizer):
+        print(line)
+    if output:
+        document: Dict[str, Any] = asdict(report)
+        Path(output).write_text(json.dumps(document, indent=2) + "\n")
+    return 0
+
+
+def main():
+    """Main entry point"""
+    parser = argparse.ArgumentParser(
+        description="RTT Heap Report - Decode rtt::trace::HeapProfiler reports",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  # Print the last report of a capture
+  %(prog)s --file heap.bin
+
+  # Resolve callers to functions and keep the report as JSON
+  %(prog)s --file heap.bin --elf firmware.elf --output heap.json
+        """,
+    )
+
+    parser.add_argument("-f", "--file", required=True, help="Captured rtt_data channel containing heap reports")
+    parser.add_argument("-e", "--elf", help="ELF file to resolve caller addresses")
+    parser.add_argument("-o", "--output", help="Write the report as JSON")
+
+    args = parser.parse_args()
+    return run(args.file, args.elf, args.output)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,421 @@
+#!/usr/bin/env python3
+"""
+RTT Host - Python bindings of the rtt_host C++ decoder library
+
+Loads the shared rtt_host_c library (built with the host CMake presets,
+e.g. build/default/rtt_host/librtt_host_c.so) through ctypes. The library
+memory-maps captures and decodes them in C++; decoded trace events are
+exposed as a ctypes array over the library's memory, without copying.
+
+Traces are analyzed in one streaming pass when opened; the events are only
+decoded into memory when NativeTrace.records is used.
+
+The library is found through the RTT_HOST_LIBRARY environment variable or
+in the build directories of the repository. Tools fall back to their pure
+Python decoders when it is not available (find_library() returns None).
+
+Usage:
+    with NativeTrace("trace.bin") as trace:
+        print(trace.summary().events)
+    export_perfetto("trace.bin", "trace.pftrace", frequency=168000000)
+"""
+
+import ctypes
+import os
+import sys
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, Iterator, List, Optional, Sequence, Union
+
+PathLike = Union[str, Path]
+
+LIBRARY_ENV = "RTT_HOST_LIBRARY"
+LIBRARY_NAMES = ("librtt_host_c.so", "librtt_host_c.dylib", "rtt_host_c.dll", "librtt_host_c.dll")
+REPOSITORY_ROOT = Path(__file__).resolve().parent.parent
+
+
+class RttHostError(RuntimeError):
+    """Raised when the library is missing or a capture cannot be decoded"""
+
+
+class TraceRecord(ctypes.Structure):
+    """Decoded trace event (RttHostTraceRecord)"""
+
+    _fields_ = [
+        ("timestamp", ctypes.c_uint64),
+        ("handle", ctypes.c_uint32),
+        ("data", ctypes.c_uint32),
+        ("type", ctypes.c_uint8),
+        ("reserved", ctypes.c_uint8 * 7),
+    ]
+
+
+class _TraceSummary(ctypes.Structure):
+    _fields_ = [
+        ("events", ctypes.c_uint64),
+        ("first_timestamp", ctypes.c_uint64),
+        ("last_timestamp", ctypes.c_uint64),
+        ("gaps", ctypes.c_uint64),
+        ("lost_events", ctypes.c_uint64),
+        ("unmatched_in", ctypes.c_uint64),
+        ("unmatched_out", ctypes.c_uint64),
+        ("isr_count", ctypes.c_uint64),
+        ("isr_matched", ctypes.c_uint64),
+        ("isr_total", ctypes.c_uint64),
+        ("isr_min", ctypes.c_uint64),
+        ("isr_max", ctypes.c_uint64),
+        ("task_count", ctypes.c_uint32),
+        ("encoding", ctypes.c_uint32),
+    ]
+
+
+class _TaskStats(ctypes.Structure):
+    _fields_ = [
+        ("handle", ctypes.c_uint32),
+        ("reserved", ctypes.c_uint32),
+        ("count", ctypes.c_uint64),
+        ("total", ctypes.c_uint64),
+        ("min", ctypes.c_uint64),
+        ("max", ctypes.c_uint64),
+    ]
+
+
+class _DataPacket(ctypes.Structure):
+    _fields_ = [
+        ("payload", ctypes.c_void_p),
+        ("offset", ctypes.c_uint64),
+        ("size", ctypes.c_uint32),
+        ("timestamp", ctypes.c_uint32),
+        ("type", ctypes.c_uint8),
+        ("subtype", ctypes.c_uint8),
+        ("reserved", ctypes.c_uint8 * 6),
+    ]
+
+
+@dataclass
+class TraceSummary:
+    """Statistics of a whole trace, as computed by the library"""
+
+    events: int
+    first_timestamp: int
+    last_timestamp: int
+    gaps: int
+    lost_events: int
+    unmatched_in: int
+    unmatched_out: int
+    isr_count: int
+    isr_matched: int
+    isr_total: int
+    isr_min: Optional[int]
+    isr_max: Optional[int]
+    task_count: int
+    encoding: str
+
+    @classmethod
+    def from_native(cls, native: _TraceSummary) -> "TraceSummary":
+        """Convert the C structure"""
+        matched = native.isr_matched > 0
+        return cls(
+            events=native.events,
+            first_timestamp=native.first_timestamp,
+            last_timestamp=native.last_timestamp,
+            gaps=native.gaps,
+            lost_events=native.lost_events,
+            unmatched_in=native.unmatched_in,
+            unmatched_out=native.unmatched_out,
+            isr_count=native.isr_count,
+            isr_matched=native.isr_matched,
+            isr_total=native.isr_total,
+            isr_min=native.isr_min if matched else None,
+            isr_max=native.isr_max if matched else None,
+            task_count=native.task_count,
+            encoding="V2" if native.encoding == 2 else "V1",
+        )
+
+
+@dataclass
+class TaskStats:
+    """Execution periods of one task in timebase ticks"""
+
+    handle: int
+    name: str
+    count: int
+    total: int
+    min: int
+    max: int
+
+
+@dataclass
+class DataPacket:
+    """One rtt_data packet, payload is a view into the mapped capture"""
+
+    type: int
+    subtype: int
+    timestamp: int
+    offset: int
+    payload: memoryview
+
+
+def find_library(search_paths: Optional[Sequence[PathLike]] = None) -> Optional[Path]:
+    """
+    Locate the rtt_host_c shared library
+
+    Args:
+        search_paths: Directories to search, default: the repository's build directories
+
+    Returns:
+        Path of the library, or None if it was not built
+    """
+    explicit = os.environ.get(LIBRARY_ENV)
+    if explicit:
+        path = Path(explicit)
+        return path if path.is_file() else None
+
+    if search_paths is None:
+        build = REPOSITORY_ROOT / "build"
+        search_paths = (sorted(build.glob("*/rtt_host")) + [build / "rtt_host"]) if build.is_dir() else []
+
+    for directory in search_paths:
+        for name in LIBRARY_NAMES:
+            candidate = Path(directory) / name
+            if candidate.is_file():
+                return candidate
+    return None
+
+
+_library: Optional[ctypes.CDLL] = None
+
+
+def load_library(path: Optional[PathLike] = None) -> ctypes.CDLL:
+    """
+    Load the library and declare its functions
+
+    Raises:
+        RttHostError: If the library cannot be found or loaded
+    """
+    global _library  # pylint: disable=global-statement
+    if _library is not None and path is None:
+        return _library
+
+    location = Path(path) if path is not None else find_library()
+    if location is None:
+        msg = f"rtt_host_c library not found (build the host tools or set {LIBRARY_ENV})"
+        raise RttHostError(msg)
+    try:
+        library = ctypes.CDLL(str(location))
+    except OSError as e:
+        msg = f"Cannot load {location}: {e}"
+        raise RttHostError(msg) from e
+
+    trace_p = ctypes.c_void_p
+    library.rtt_host_trace_open.argtypes = [ctypes.c_char_p, ctypes.c_uint]
+    library.rtt_host_trace_open.restype = trace_p
+    library.rtt_host_trace_close.argtypes = [trace_p]
+    library.rtt_host_trace_close.restype = None
+    library.rtt_host_trace_records.argtypes = [trace_p, ctypes.POINTER(ctypes.c_uint64)]
+    library.rtt_host_trace_records.restype = ctypes.POINTER(TraceRecord)
+    library.rtt_host_trace_summary.argtypes = [trace_p, ctypes.POINTER(_TraceSummary)]
+    library.rtt_host_trace_summary.restype = ctypes.c_int
+    library.rtt_host_trace_type_count.argtypes = [trace_p, ctypes.c_uint32]
+    library.rtt_host_trace_type_count.restype = ctypes.c_uint64
+    library.rtt_host_trace_task_stats.argtypes = [trace_p, ctypes.c_uint32, ctypes.POINTER(_TaskStats)]
+    library.rtt_host_trace_task_stats.restype = ctypes.c_int
+    library.rtt_host_trace_task_name.argtypes = [trace_p, ctypes.c_uint32]
+    library.rtt_host_trace_task_name.restype = ctypes.c_char_p
+    library.rtt_host_trace_registry_entry.argtypes = [trace_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint32)]
+    library.rtt_host_trace_registry_entry.restype = ctypes.c_char_p
+    library.rtt_host_export_perfetto.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint, ctypes.POINTER(_TraceSummary)]
+    library.rtt_host_export_perfetto.restype = ctypes.c_int
+
+    data_p = ctypes.c_void_p
+    library.rtt_host_data_open.argtypes = [ctypes.c_char_p]
+    library.rtt_host_data_open.restype = data_p
+    library.rtt_host_data_close.argtypes = [data_p]
+    library.rtt_host_data_close.restype = None
+    library.rtt_host_data_next.argtypes = [data_p, ctypes.POINTER(_DataPacket)]
+    library.rtt_host_data_next.restype = ctypes.c_int
+    library.rtt_host_data_skipped.argtypes = [data_p]
+    library.rtt_host_data_skipped.restype = ctypes.c_uint64
+
+    if path is None:
+        _library = library
+    return library
+
+
+def _encode(path: PathLike) -> bytes:
+    return os.fsencode(str(path))
+
+
+class NativeTrace:
+    """Trace capture decoded and analyzed by the library"""
+
+    def __init__(self, path: PathLike, threads: int = 0, library: Optional[ctypes.CDLL] = None):
+        """
+        Map and analyze a capture
+
+        Args:
+            path: rtt_freertos_trace capture (V1 or V2)
+            threads: Analysis worker threads, 0 for one per CPU
+
+        Raises:
+            RttHostError: If the library is missing or the file cannot be read
+        """
+        self._library = library or load_library()
+        self._handle = self._library.rtt_host_trace_open(_encode(path), threads)
+        if not self._handle:
+            msg = f"Cannot decode {path}"
+            raise RttHostError(msg)
+        self._records: Optional["ctypes.Array[TraceRecord]"] = None
+
+    def close(self) -> None:
+        """Release the library's memory; records become invalid"""
+        if self._handle:
+            self._library.rtt_host_trace_close(self._handle)
+            self._handle = None
+        self._records = None
+
+    def __enter__(self) -> "NativeTrace":
+        return self
+
+    def __exit__(self, *_args: object) -> None:
+        self.close()
+
+    def __len__(self) -> int:
+        return self.summary().events if self._handle else 0
+
+    @property
+    def records(self) -> "ctypes.Array[TraceRecord]":
+        """
+        Decoded events, a view into the library's memory valid until close()
+
+        The first access decodes the whole capture into memory.
+
+        Raises:
+            RttHostError: If the events do not fit into memory
+        """
+        if self._records is None:
+            if not self._handle:
+                return (TraceRecord * 0)()
+            count = ctypes.c_uint64()
+            pointer = self._library.rtt_host_trace_records(self._handle, ctypes.byref(count))
+            if not pointer and self.summary().events:
+                msg = "Cannot decode the trace events"
+                raise RttHostError(msg)
+            self._records = (TraceRecord * count.value).from_address(ctypes.addressof(pointer.contents)) if pointer and count.value else (TraceRecord * 0)()
+        return self._records
+
+    def summary(self) -> TraceSummary:
+        """Statistics computed while opening"""
+        native = _TraceSummary()
+        self._library.rtt_host_trace_summary(self._handle, ctypes.byref(native))
+        return TraceSummary.from_native(native)
+
+    def type_counts(self) -> Dict[int, int]:
+        """Number of events per event type, only types that occurred"""
+        counts = {}
+        for event_type in range(128):
+            count = int(self._library.rtt_host_trace_type_count(self._handle, event_type))
+            if count:
+                counts[event_type] = count
+        return counts
+
+    def task_name(self, handle: int) -> str:
+        """Registered name of a task or Task_0x%08X"""
+        name = self._library.rtt_host_trace_task_name(self._handle, handle)
+        return name.decode("utf-8", errors="replace") if name else f"Task_0x{handle:08X}"
+
+    def task_registry(self) -> Dict[int, str]:
+        """Task names of all registries in the capture, by handle"""
+        registry = {}
+        handle = ctypes.c_uint32()
+        index = 0
+        while True:
+            name = self._library.rtt_host_trace_registry_entry(self._handle, index, ctypes.byref(handle))
+            if name is None:
+                return registry
+            registry[handle.value] = name.decode("utf-8", errors="replace")
+            index += 1
+
+    def task_stats(self) -> List[TaskStats]:
+        """Execution periods per task, in ascending handle order"""
+        stats = []
+        native = _TaskStats()
+        index = 0
+        while self._library.rtt_host_trace_task_stats(self._handle, index, ctypes.byref(native)):
+            stats.append(TaskStats(native.handle, self.task_name(native.handle), native.count, native.total, native.min, native.max))
+            index += 1
+        return stats
+
+
+def export_perfetto(trace_path: PathLike, output_path: PathLike, frequency: int, threads: int = 0, library: Optional[ctypes.CDLL] = None) -> TraceSummary:
+    """
+    Stream a trace capture to a Perfetto protobuf trace (open in https://ui.perfetto.dev/)
+
+    Args:
+        frequency: Timebase frequency in Hz
+        threads: Analysis worker threads running alongside the export
+
+    Returns:
+        Statistics computed in the same pass
+
+    Raises:
+        RttHostError: If the library is missing or the export failed
+    """
+    library = library or load_library()
+    native = _TraceSummary()
+    if not library.rtt_host_export_perfetto(_encode(trace_path), _encode(output_path), frequency, threads, ctypes.byref(native)):
+        msg = f"Cannot export {trace_path} to {output_path}"
+        raise RttHostError(msg)
+    return TraceSummary.from_native(native)
+
+
+class NativeDataStream:
+    """Zero-copy iteration over the rtt_data packets of a capture"""
+
+    def __init__(self, path: PathLike, library: Optional[ctypes.CDLL] = None):
+        """
+        Raises:
+            RttHostError: If the library is missing or the file cannot be mapped
+        """
+        self._library = library or load_library()
+        self._handle = self._library.rtt_host_data_open(_encode(path))
+        if not self._handle:
+            msg = f"Cannot map {path}"
+            raise RttHostError(msg)
+
+    def close(self) -> None:
+        """Unmap the capture; payload views become invalid"""
+        if self._handle:
+            self._library.rtt_host_data_close(self._handle)
+            self._handle = None
+
+    def __enter__(self) -> "NativeDataStream":
+        return self
+
+    def __exit__(self, *_args: object) -> None:
+        self.close()
+
+    def __iter__(self) -> Iterator[DataPacket]:
+        native = _DataPacket()
+        while self._handle and self._library.rtt_host_data_next(self._handle, ctypes.byref(native)):
+            payload = (ctypes.c_uint8 * native.size).from_address(native.payload) if native.size else (ctypes.c_uint8 * 0)()
+            yield DataPacket(native.type, native.subtype, native.timestamp, native.offset, memoryview(payload).cast("B"))
+
+    @property
+    def skipped_bytes(self) -> int:
+        """Bytes skipped so far because they did not start a packet"""
+        return int(self._library.rtt_host_data_skipped(self._handle)) if self._handle else 0
+
+
+def main() -> int:
+    """Print where the library was found"""
+    location = find_library()
+    if location is None:
+        print(f"rtt_host_c library not found (build the host tools or set {LIBRARY_ENV})", file=sys.stderr)
+        return 1
+    print(location)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
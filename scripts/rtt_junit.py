@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+RTT JUnit - Convert on-target unit test results to JUnit XML
+
+rtt::unittest::RttTestEventListener sends one numeric TestResult Struct packet
+per test over an rtt_data channel when it is given a DataSender, a String
+record "RTT_TEST <index> <suite> <name>" the first time a test runs and a
+String record "RTT_FAIL <index> <text>" before the result of a failed test.
+This tool
+extracts the results from a captured channel and writes a JUnit XML report
+for CI systems, with the measured cycles and the cycle budget of each test
+as properties. The exit code is non-zero if any test failed, so it can gate
+a hardware-in-the-loop pipeline.
+"""
+
+import argparse
+import sys
+import xml.etree.ElementTree as ET
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple
+
+from rtt_data_reader import DataType, RttDataReader
+
+RESULT_SCHEMA_NAME = "rtt::unittest::TestResult"
+TEST_NAME_TAG = "RTT_TEST"
+TEST_FAILURE_TAG = "RTT_FAIL"
+STATUS_NAMES = {0: "passed", 1: "failed", 2: "skipped"}
+
+
+def _parse_record(text: str) -> Optional[Tuple[str, int, str]]:
+    """Split a "<tag> <index> <rest>" String record, None if it is not one"""
+    parts = text.split(" ", 2)
+    if len(parts) < 3 or parts[0] not in (TEST_NAME_TAG, TEST_FAILURE_TAG) or not parts[1].isdigit():
+        return None
+    return parts[0], int(parts[1]), parts[2]
+
+
+@dataclass
+class UnitTestRecord:
+    """Result of one test (times in timebase ticks)"""
+
+    suite: str
+    name: str
+    failure: str
+    cycles: int
+    budget: int
+    frequency: int
+    failures: int
+    status: str  # "passed", "failed" or "skipped"
+
+    @classmethod
+    def from_sample(cls, sample: Dict[str, Any], suite: str, name: str, failure: str = "") -> "UnitTestRecord":
+        """Create a record from a decoded TestResult struct and the test's name and failure records"""
+        status = STATUS_NAMES.get(int(sample["status"]), "failed")
+        return cls(
+            suite,
+            name,
+            failure,
+            int(sample["cycles"]),
+            int(sample["budget"]),
+            int(sample["frequency"]),
+            int(sample["failures"]),
+            status,
+        )
+
+    @property
+    def seconds(self) -> float:
+        """Test duration in seconds (0 if the frequency is unknown)"""
+        return self.cycles / self.frequency if self.frequency else 0.0
+
+    @property
+    def over_budget(self) -> bool:
+        """True if the test exceeded its cycle budget"""
+        return self.budget != 0 and self.cycles > self.budget
+
+
+def extract_results(data: bytes) -> List[UnitTestRecord]:
+    """
+    Extract test results from a captured rtt_data channel
+
+    Args:
+        data: Raw channel bytes
+
+    Returns:
+        Results in the order they were sent
+    """
+    reader = RttDataReader()
+    results = []
+    names: Dict[int, Tuple[str, str]] = {}
+    failures: Dict[int, str] = {}
+    offset = 0
+    while len(data) - offset >= RttDataReader.HEADER_SIZE:
+        header = reader.parse_header(data[offset : offset + RttDataReader.HEADER_SIZE])
+        end = offset + RttDataReader.HEADER_SIZE + (header.size if header else 0)
+        if header is None or end > len(data):
+            offset += 1
+            continue
+
+        value = reader.parse_data(header, data[offset + RttDataReader.HEADER_SIZE : end])
+        if header.data_type == DataType.String and isinstance(value, str):
+            record = _parse_record(value)
+            if record is not None and record[0] == TEST_NAME_TAG:
+                suite, _, name = record[2].partition(" ")
+                names[record[1]] = (suite, name)
+            elif record is not None:
+                failures[record[1]] = record[2]
+        elif header.data_type == DataType.Struct and value is not None and reader.schemas[header.reserved].name == RESULT_SCHEMA_NAME:
+            index = int(value["index"])
+            # The name record is missing if the capture started after the test first ran
+            suite, name = names.get(index, ("unknown", f"test{index}"))
+            results.append(UnitTestRecord.from_sample(value, suite, name, failures.pop(index, "")))
+        offset = end
+    return results
+
+
+def to_junit(results: List[UnitTestRecord], name: str = "rtt_unittest") -> ET.ElementTree:
+    """
+    Build a JUnit XML document
+
+    Args:
+        results: Test results, grouped into test suites by suite name
+        name: Name of the root testsuites element
+
+    Returns:
+        Element tree of the report
+    """
+    suites: Dict[str, List[UnitTestRecord]] = {}
+    for record in results:
+        suites.setdefault(record.suite, []).append(record)
+
+    def counts(element: ET.Element, records: List[UnitTestRecord]) -> None:
+        element.set("tests", str(len(records)))
+        element.set("failures", str(sum(1 for r in records if r.status == "failed")))
+        element.set("errors", "0")
+        element.set("skipped", str(sum(1 for r in records if r.status == "skipped")))
+        element.set("time", f"{sum(r.seconds for r in records):.6f}")
+
+    root = ET.Element("testsuites", name=name)
+    counts(root, results)
+    for suite_name, records in suites.items():
+        suite = ET.SubElement(root, "testsuite", name=suite_name)
+        counts(suite, records)
+        for record in records:
+            case = ET.SubElement(suite, "testcase", classname=record.suite, name=record.name, time=f"{record.seconds:.6f}")
+            properties = ET.SubElement(case, "properties")
+            ET.SubElement(properties, "property", name="cycles", value=str(record.cycles))
+            if record.budget:
+                ET.SubElement(properties, "property", name="budget", value=str(record.budget))
+
+            if record.status == "failed":
+                failure = ET.SubElement(case, "failure", message=record.failure or "failed")
+                failure.set("type", "cycle_budget" if record.over_budget and record.failures == 1 else "assertion")
+                failure.text = f"{record.failure}\n{record.failures} failed assertion(s)"
+            elif record.status == "skipped":
+                ET.SubElement(case, "skipped")
+    if hasattr(ET, "indent"):  # Python 3.9+
+        ET.indent(root)
+    return ET.ElementTree(root)
+
+
+def format_summary(results: List[UnitTestRecord]) -> List[str]:
+    """Render results as a table"""
+    lines = [f"{'Test':<48} {'Cycles':>12} {'Budget':>12}  Status"]
+    for record in results:
+        budget = str(record.budget) if record.budget else "-"
+        lines.append(f"{record.suite + '.' + record.name:<48} {record.cycles:>12} {budget:>12}  {record.status}")
+    failed = sum(1 for r in results if r.status == "failed")
+    lines.append(f"\n{len(results)} tests, {failed} failed, {sum(1 for r in results if r.status == 'skipped')} skipped")
+    return lines
+
+
+def run(capture: str, output: Optional[str] = None, name: str = "rtt_unittest", quiet: bool = False) -> int:
+    """Extract results, write the JUnit report and return the exit code"""
+    try:
+        results = extract_results(Path(capture).read_bytes())
+    except OSError as e:
+        print(f"Error reading capture: {e}", file=sys.stderr)
+        return 2
+    if not results:
+        print("No test results found", file=sys.stderr)
+        return 2
+
+    tree = to_junit(results, name)
+    if output:
+        tree.write(output, encoding="utf-8", xml_declaration=True)
+    else:
+        tree.write(sys.stdout, encoding="unicode")
+        print()
+
+    if not quiet:
+        # Keep stdout for the report when it is not written to a file
+        stream = sys.stdout if output else sys.stderr
+        for line in format_summary(results):
+            print(line, file=stream)
+    return 1 if any(r.status == "failed" for r in results) else 0
+
+
+def main():
+    """Main entry point"""
+    parser = argparse.ArgumentParser(
+        description="RTT JUnit - Convert rtt_unittest binary test results to JUnit XML",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  # Write a JUnit report and fail if any test failed or exceeded its cycle budget
+  %(prog)s --file results.bin --output junit.xml
+
+  # Print the report to stdout
+  %(prog)s --file results.bin --quiet
+        """,
+    )
+
+    parser.add_argument("-f", "--file", required=True, help="Captured rtt_data channel containing TestResult records")
+    parser.add_argument("-o", "--output", help="Write the JUnit XML report to a file (default: stdout)")
+    parser.add_argument("-n", "--name", default="rtt_unittest", help="Name of the test run (default: rtt_unittest)")
+    parser.add_argument("-q", "--quiet", action="store_true", help="Do not print the summary table")
+
+    args = parser.parse_args()
+    return run(args.file, args.output, args.name, args.quiet)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+"""
+RTT Log Decoder - Host-side rendering of deferred rtt_logger records
+
+Messages logged with RTT_LOG_DEFERRED are sent as compact binary records that
+carry the address of the format string instead of the text. This tool loads
+the format strings from the .rtt_fmt section of the firmware ELF file and
+renders the records back into the usual "[LEVEL] message" lines. Plain text
+log lines on the same channel are passed through unchanged.
+"""
+
+import argparse
+import re
+import struct
+import sys
+from dataclasses import dataclass
+from enum import IntEnum
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple
+
+from rtt_elf import ElfFile
+
+
+class DeferredArgType(IntEnum):
+    """Argument type tags (must match C++ rtt::DeferredArgType)"""
+
+    Int32 = 0
+    UInt32 = 1
+    Int64 = 2
+    UInt64 = 3
+    Float = 4
+    Double = 5
+    String = 6
+    Pointer = 7
+
+
+LEVEL_NAMES = ["TRACE", "DEBUG", "INFO", "WARN", "ERROR", "CRIT"]
+
+ARG_FORMATS = {
+    DeferredArgType.Int32: "<i",
+    DeferredArgType.UInt32: "<I",
+    DeferredArgType.Int64: "<q",
+    DeferredArgType.UInt64: "<Q",
+    DeferredArgType.Float: "<f",
+    DeferredArgType.Double: "<d",
+    DeferredArgType.Pointer: "<I",
+}
+
+# printf conversion: flags, width, precision, length modifier, conversion
+PRINTF_SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|L|z|j|t)?([diouxXeEfFgGcsp%])")
+
+
+@dataclass
+class DeferredRecord:
+    """Decoded deferred log record"""
+
+    level: int
+    format_id: int
+    timestamp: int
+    args: List[Any]
+
+
+class RttLogDecoder:
+    """Decoder for mixed text / deferred binary log streams"""
+
+    MAGIC_BYTES = b"RL"
+    HEADER_SIZE = 12  # 2 (magic) + 1 (level) + 1 (payload size) + 4 (format id) + 4 (timestamp)
+    HEADER_FORMAT = "<2sBBII"
+    FORMAT_SECTION = ".rtt_fmt"
+    MAX_RECORD_SIZE = 64  # RTT_LOGGER_DEFERRED_MAX_RECORD_SIZE, header included
+
+    def __init__(self, formats: Optional[Dict[int, str]] = None, cpu_hz: Optional[int] = None, max_record_size: int = MAX_RECORD_SIZE):
+        """
+        Initialize decoder
+
+        Args:
+            formats: Mapping of format string address to format string
+            cpu_hz: CPU frequency to convert cycle timestamps into seconds
+            max_record_size: RTT_LOGGER_DEFERRED_MAX_RECORD_SIZE of the firmware
+        """
+        self.formats: Dict[int, str] = formats or {}
+        self.cpu_hz = cpu_hz
+        self.max_record_size = max_record_size
+        self._buffer = b""
+
+    @classmethod
+    def from_elf(cls, elf_path: str, cpu_hz: Optional[int] = None, max_record_size: int = MAX_RECORD_SIZE) -> "RttLogDecoder":
+        """Create a decoder with the format strings of an ELF file"""
+        elf = ElfFile.from_file(elf_path)
+        return cls(elf.strings_in_sections(cls.FORMAT_SECTION), cpu_hz, max_record_size)
+
+    def parse_record(self, data: bytes) -> Tuple[Optional[DeferredRecord], int]:
+        """
+        Parse one deferred record from the start of data
+
+        Returns:
+            Tuple of (record or None, bytes consumed); (None, 0) if incomplete
+        """
+        if len(data) < self.HEADER_SIZE:
+            return None, 0
+
+        magic, level, payload_size, format_id, timestamp = struct.unpack_from(self.HEADER_FORMAT, data, 0)
+        if magic != self.MAGIC_BYTES:
+            return None, 0
+
+        total = self.HEADER_SIZE + payload_size
+        if len(data) < total:
+            return None, 0
+
+        return DeferredRecord(level, format_id, timestamp, self.parse_args(data[self.HEADER_SIZE : total])), total
+
+    def check_record(self, data: bytes) -> Optional[bool]:
+        """
+        Check whether data starts with a plausible deferred record
+
+        Text such as "CTRL" or "WORLD" contains the magic too, so a record
+        start also needs a valid level and payload size, a format id from the
+        format table (if one is loaded) and a well-formed argument list.
+
+        Returns:
+            True for a complete valid record, False if data cannot start a
+            record, None if more bytes are needed to decide
+        """
+        prefix = data[: len(self.MAGIC_BYTES)]
+        if prefix != self.MAGIC_BYTES[: len(prefix)]:
+            return False
+        if len(data) > 2 and data[2] >= len(LEVEL_NAMES):
+            return False
+        if len(data) > 3 and self.HEADER_SIZE + data[3] > self.max_record_size:
+            return False
+        if len(data) < self.HEADER_SIZE:
+            return None
+
+        format_id = struct.unpack_from("<I", data, 4)[0]
+        if self.formats and format_id not in self.formats:
+            return False
+        total = self.HEADER_SIZE + data[3]
+        if len(data) < total:
+            return None
+        return self.valid_args(data[self.HEADER_SIZE : total])
+
+    @staticmethod
+    def valid_args(payload: bytes) -> bool:
+        """Check that payload is exactly a sequence of tagged arguments"""
+        pos = 0
+        while pos < len(payload):
+            tag = payload[pos]
+            pos += 1
+            if tag == DeferredArgType.String:
+                if pos >= len(payload):
+                    return False
+                pos += 1 + payload[pos]
+            elif tag <= DeferredArgType.Pointer:
+                pos += struct.calcsize(ARG_FORMATS[DeferredArgType(tag)])
+            else:
+                return False
+        return pos == len(payload)
+
+    @staticmethod
+    def parse_args(payload: bytes) -> List[Any]:
+        """Decode the tagged argument list of a record"""
+        args: List[Any] = []
+        pos = 0
+        while pos < len(payload):
+            tag = payload[pos]
+            pos += 1
+            if tag == DeferredArgType.String:
+                if pos >= len(payload):
+                    break
+                length = payload[pos]
+                pos += 1
+                args.append(payload[pos : pos + length].decode("utf-8", errors="replace"))
+                pos += length
+                continue
+
+            try:
+                fmt = ARG_FORMATS[DeferredArgType(tag)]
+            except ValueError:
+                break
+            size = struct.calcsize(fmt)
+            if pos + size > len(payload):
+                break
+            args.append(struct.unpack_from(fmt, payload, pos)[0])
+            pos += size
+        return args
+
+    @staticmethod
+    def render(fmt: str, args: List[Any]) -> str:
+        """
+        Render a printf-style format string with decoded arguments
+
+        Length modifiers are dropped since the arguments are already typed,
+        and missing arguments are shown as "?".
+        """
+        remaining = list(args)
+
+        def next_arg() -> Any:
+            return remaining.pop(0) if remaining else None
+
+        def replace(match: "re.Match[str]") -> str:
+            flags, width, precision, _, conversion = match.groups()
+            if conversion == "%":
+                return "%"
+
+            if width == "*":
+                value = next_arg()
+                width = str(value) if isinstance(value, int) else ""
+            if precision == "*":
+                value = next_arg()
+                precision = str(value) if isinstance(value, int) else ""
+
+            value = next_arg()
+            if value is None:
+                return "?"
+
+            spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+            try:
+                if conversion == "p":
+                    return "0x%08x" % value  # noqa: UP031
+                if conversion in "diouxXc" and isinstance(value, float):
+                    value = int(value)
+                if conversion in "eEfFgG" and not isinstance(value, (int, float)):
+                    return str(value)
+                if conversion in "diouxX" and not isinstance(value, int):
+                    return str(value)
+                return (spec + ("d" if conversion in "iu" else conversion)) % value
+            except (TypeError, ValueError, OverflowError):
+                return str(value)
+
+        return PRINTF_SPEC.sub(replace, fmt)
+
+    def format_record(self, record: DeferredRecord) -> str:
+        """Render a record as a log line"""
+        level = LEVEL_NAMES[record.level] if record.level < len(LEVEL_NAMES) else f"L{record.level}"
+        fmt = self.formats.get(record.format_id)
+        if fmt is None:
+            text = f"<unknown format 0x{record.format_id:08x}> " + " ".join(str(a) for a in record.args)
+        else:
+            text = self.render(fmt, record.args)
+
+        line = f"[{level}] {text}"
+        if self.cpu_hz:
+            line = f"{record.timestamp / self.cpu_hz:12.6f} {line}"
+        elif record.timestamp:
+            line = f"{record.timestamp:10d} {line}"
+        return line
+
+    def feed(self, data: bytes) -> List[str]:
+        """
+        Feed raw channel bytes and return all complete lines
+
+        Binary records start with the 'RL' magic and a valid header (see
+        check_record()); everything else is treated as text and split at
+        line endings.
+        """
+        self._buffer += data
+        lines: List[str] = []
+
+        while self._buffer:
+            state = self.check_record(self._buffer)
+            if state is None:
+                break
+            if state:
+                record, consumed = self.parse_record(self._buffer)
+                lines.append(self.format_record(record))
+                self._buffer = self._buffer[consumed:]
+                continue
+
+            # Text up to the next line ending or the next binary record
+            newline = self._buffer.find(b"\n")
+            limit = newline if newline >= 0 else len(self._buffer)
+            magic = self._buffer.find(self.MAGIC_BYTES, 1, limit + 1)
+            while magic >= 0 and self.check_record(self._buffer[magic:]) is False:
+                magic = self._buffer.find(self.MAGIC_BYTES, magic + 1, limit + 1)
+            if magic >= 0 and self.check_record(self._buffer[magic:]) is None:
+                break  # Wait until the candidate record is complete
+            if magic < 0 and newline < 0:
+                break
+            if magic >= 0:
+                end, skip = magic, magic
+            else:
+                end, skip = newline, newline + 1
+            text = self._buffer[:end].decode("utf-8", errors="replace").rstrip("\r")
+            if text:
+                lines.append(text)
+            self._buffer = self._buffer[skip:]
+
+        return lines
+
+
+def decode_file(elf_path: str, input_path: str, cpu_hz: Optional[int] = None, max_record_size: int = RttLogDecoder.MAX_RECORD_SIZE) -> int:
+    """Decode a captured log channel file and print it"""
+    try:
+        decoder = RttLogDecoder.from_elf(elf_path, cpu_hz, max_record_size)
+    except (OSError, ValueError) as e:
+        print(f"Error loading ELF: {e}", file=sys.stderr)
+        return 1
+
+    try:
+        data = Path(input_path).read_bytes()
+    except OSError as e:
+        print(f"Error reading file: {e}", file=sys.stderr)
+        return 1
+
+    for line in decoder.feed(data + b"\n"):
+        print(line)
+    return 0
+
+
+def main():
+    """Main entry point"""
+    parser = argparse.ArgumentParser(
+        description="RTT Log Decoder - Render deferred rtt_logger records",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  # Decode a captured log channel
+  %(prog)s --elf firmware.elf --file rtt_log.bin
+
+  # Show timestamps in seconds (80 MHz core clock)
+  %(prog)s --elf firmware.elf --file rtt_log.bin --cpu-hz 80000000
+        """,
+    )
+
+    parser.add_argument("-e", "--elf", required=True, help="Firmware ELF file containing the .rtt_fmt section")
+    parser.add_argument("-f", "--file", required=True, help="Captured RTT log channel data")
+    parser.add_argument("--cpu-hz", type=int, help="CPU frequency for timestamp conversion")
+    parser.add_argument(
+        "--max-record-size",
+        type=int,
+        default=RttLogDecoder.MAX_RECORD_SIZE,
+        help=f"RTT_LOGGER_DEFERRED_MAX_RECORD_SIZE of the firmware (default: {RttLogDecoder.MAX_RECORD_SIZE})",
+    )
+
+    args = parser.parse_args()
+    return decode_file(args.elf, args.file, args.cpu_hz, args.max_record_size)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
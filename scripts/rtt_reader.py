@@ -10,12 +10,20 @@ It can read RTT output from embedded devices running unit tests or applications.
 """
 
 import argparse
+import re
 import socket
 import sys
 import time
 from abc import ABC, abstractmethod
+from dataclasses import dataclass
 from enum import Enum
-from typing import Optional
+from typing import Dict, List, Optional
+
+# One line of the descriptor table written by rtt::ChannelManager::announce()
+CHANNEL_LINE = re.compile(r"^RTT_CHANNEL (\d+) (\d+) (\w+) (.*?)\r?$", re.MULTILINE)
+
+# Reply of rtt::control::Control to a command: "RTT_CONTROL OK <command>" or "RTT_CONTROL ERR <reason>: <command>"
+CONTROL_LINE = re.compile(r"^RTT_CONTROL (OK|ERR) (.*?)\r?$", re.MULTILINE)
 
 
 class RttBackend(Enum):
@@ -25,6 +33,62 @@ class RttBackend(Enum):
     JLINK = "jlink"
 
 
+@dataclass
+class ChannelDescriptor:
+    """One up-buffer from the descriptor table"""
+
+    index: int
+    size: int
+    mode: str
+    name: str
+
+
+def parse_channel_table(text: str) -> Dict[str, ChannelDescriptor]:
+    """
+    Parse the descriptor table of rtt::ChannelManager::announce()
+
+    Args:
+        text: Terminal output containing RTT_CHANNEL lines, other lines are ignored
+
+    Returns:
+        Descriptors by channel name
+    """
+    channels = {}
+    for match in CHANNEL_LINE.finditer(text):
+        descriptor = ChannelDescriptor(int(match.group(1)), int(match.group(2)), match.group(3), match.group(4))
+        channels[descriptor.name] = descriptor
+    return channels
+
+
+@dataclass
+class ControlReply:
+    """Reply of the target to one control command"""
+
+    ok: bool
+    command: str
+    reason: Optional[str] = None
+
+
+def parse_control_replies(text: str) -> List[ControlReply]:
+    """
+    Parse the replies of rtt::control::Control
+
+    Args:
+        text: Terminal output containing RTT_CONTROL lines, other lines are ignored
+
+    Returns:
+        Replies in the order they were written
+    """
+    replies = []
+    for match in CONTROL_LINE.finditer(text):
+        if match.group(1) == "OK":
+            replies.append(ControlReply(True, match.group(2)))
+        else:
+            reason, _, command = match.group(2).rpartition(": ")
+            replies.append(ControlReply(False, command, reason or None))
+    return replies
+
+
 class RttReader(ABC):
     """Abstract base class for RTT readers"""
 
@@ -44,6 +108,15 @@ class RttReader(ABC):
     def is_connected(self) -> bool:
         """Check if connected to target"""
 
+    def write_rtt(self, channel: int, data: bytes) -> int:
+        """
+        Write data to an RTT down-buffer
+
+        Returns:
+            Bytes the down-buffer accepted, 0 if the backend cannot write
+        """
+        return 0
+
 
 class OpenOcdRttReader(RttReader):
     """RTT reader using OpenOCD telnet interface"""
@@ -229,6 +302,17 @@ class JLinkRttReader(RttReader):
             print(f"Read error: {e}", file=sys.stderr)
             return None
 
+    def write_rtt(self, channel: int, data: bytes) -> int:
+        """Write data to an RTT down-buffer via J-Link"""
+        if not self._connected or not self.jlink:
+            return 0
+
+        try:
+            return int(self.jlink.rtt_write(channel, list(data)))
+        except Exception as e:
+            print(f"Write error: {e}", file=sys.stderr)
+            return 0
+
     def is_connected(self) -> bool:
         """Check if connected to J-Link"""
         return self._connected
@@ -249,18 +333,92 @@ class RttReaderApp:
         self.output_file = output_file
         self.running = False
 
-    def run(self, channel: int = 0, poll_interval: float = 0.01):
+    def resolve_channel(self, name: str, timeout: float = 5.0, poll_interval: float = 0.01) -> Optional[int]:
+        """
+        Find a channel by name in the descriptor table on channel 0
+
+        The target writes the table at startup (rtt::ChannelManager::announce()),
+        so connect before resetting it. Output read while waiting is not shown.
+
+        Args:
+            name: Channel name, e.g. "FreeRTOS Trace"
+            timeout: Seconds to wait for the table
+            poll_interval: Polling interval in seconds
+
+        Returns:
+            Channel number, or None if the name did not appear in time
+        """
+        text = ""
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            data = self.reader.read_rtt(0)
+            if data:
+                text += data.decode("utf-8", errors="ignore")
+                descriptor = parse_channel_table(text).get(name)
+                if descriptor:
+                    return descriptor.index
+            else:
+                time.sleep(poll_interval)
+        return None
+
+    def send_command(self, command: str, channel: int = 0, timeout: float = 1.0, poll_interval: float = 0.01) -> bool:
+        """
+        Send one command line to rtt::control::Control
+
+        The terminal down-buffer holds only a few bytes, so the line is written
+        in pieces as the target polls it. The reply arrives on the reply channel
+        (channel 0 by default) and is shown by the reading loop.
+
+        Args:
+            command: Command without line ending, e.g. "log debug"
+            channel: Down-buffer the target polls
+            timeout: Seconds to wait for the target to take the whole line
+            poll_interval: Retry interval in seconds while the down-buffer is full
+
+        Returns:
+            True if the whole line was written
+        """
+        data = (command.strip() + "\n").encode()
+        deadline = time.monotonic() + timeout
+        while data:
+            written = self.reader.write_rtt(channel, data)
+            data = data[written:]
+            if data:
+                if time.monotonic() >= deadline:
+                    return False
+                time.sleep(poll_interval)
+        return True
+
+    def run(self, channel: int = 0, poll_interval: float = 0.01, channel_name: Optional[str] = None, commands: Optional[List[str]] = None, control_channel: int = 0):
         """
         Main reading loop
 
         Args:
             channel: RTT channel to read from
             poll_interval: Polling interval in seconds
+            channel_name: Read the channel with this name instead (see resolve_channel)
+            commands: Control commands sent after connecting (see send_command)
+            control_channel: Down-buffer the commands are written to
         """
         if not self.reader.connect():
             print("Failed to connect to target", file=sys.stderr)
             return 1
 
+        if channel_name:
+            resolved = self.resolve_channel(channel_name, poll_interval=poll_interval)
+            if resolved is None:
+                print(f"Channel '{channel_name}' not found in the channel table", file=sys.stderr)
+                self.reader.disconnect()
+                return 1
+            channel = resolved
+
+        for command in commands or []:
+            if not self.send_command(command, control_channel, poll_interval=poll_interval):
+                print(f"Failed to send command '{command}' (the backend must support writing, e.g. J-Link)", file=sys.stderr)
+                self.reader.disconnect()
+                return 1
+            print(f"Sent command: {command}")
+
         self.running = True
         print(f"Reading RTT channel {channel}. Press Ctrl+C to exit.\n")
 
@@ -313,6 +471,12 @@ Examples:
 
   # Save output to file
   %(prog)s --backend jlink --device STM32F205RB --output rtt_log.txt
+
+  # Read the channel the target announced as "FreeRTOS Trace" (reset the target after starting)
+  %(prog)s --backend jlink --channel-name "FreeRTOS Trace" --output trace.bin
+
+  # Raise the log level and start the trace through the control channel (rtt_control)
+  %(prog)s --backend jlink --command "log debug" --command "trace start"
         """,
     )
 
@@ -331,8 +495,11 @@ Examples:
 
     # Common options
     parser.add_argument("-c", "--channel", type=int, default=0, help="RTT channel number (default: 0)")
+    parser.add_argument("-n", "--channel-name", help="Channel name from the target's channel table (overrides --channel)")
     parser.add_argument("-o", "--output", help="Save output to file")
     parser.add_argument("--poll-interval", type=float, default=0.01, help="Polling interval in seconds (default: 0.01)")
+    parser.add_argument("-C", "--command", action="append", default=[], help="Control command sent to rtt_control after connecting (repeatable)")
+    parser.add_argument("--control-channel", type=int, default=0, help="Down-buffer for --command (default: 0)")
 
     args = parser.parse_args()
 
@@ -344,7 +511,7 @@ Examples:
 
     # Create and run application
     app = RttReaderApp(reader, output_file=args.output)
-    return app.run(channel=args.channel, poll_interval=args.poll_interval)
+    return app.run(channel=args.channel, poll_interval=args.poll_interval, channel_name=args.channel_name, commands=args.command, control_channel=args.control_channel)
 
 
 if __name__ == "__main__":
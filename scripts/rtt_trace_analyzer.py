@@ -19,7 +19,7 @@ import sys
 from collections import Counter, defaultdict
 from dataclasses import dataclass
 from pathlib import Path
-from typing import Dict, List
+from typing import Dict, List, Tuple
 
 # Chrome Trace format constants
 CHROME_TRACE_ISR_THREAD_ID = 999999  # Special thread ID for ISRs in Chrome Trace
@@ -49,6 +49,7 @@ TRACE_EVENTS = {
     0x52: "TIMER_STOP",
     0x60: "MALLOC",
     0x61: "FREE",
+    0x70: "EVENTS_LOST",
 }
 
 
@@ -70,10 +71,23 @@ class TraceParser:
     EVENT_FORMAT = "<BIII"
     EVENT_SIZE = struct.calcsize(EVENT_FORMAT)
 
+    # In-band text lines between binary events
+    TEXT_MARKERS = (b"RTT_TRACE_V1\n", b"RTT_TRACE_V2\n", b"TRACE_START\n", b"TRACE_STOP\n", b"TRACE_SNAPSHOT\n", b"TRACE_SNAPSHOT_END\n")
+
+    # Binary task registry: marker, uint8 count, then per entry uint32 handle, uint8 name length, name
+    REGISTRY_MARKER = b"TASK_REGISTRY_BIN\n"
+
+    # RTT_TRACE_V2 compact encoding
+    V2_HEADER = b"RTT_TRACE_V2\n"
+    V2_SYNC = 0x7E
+    V2_HAS_DATA = 0x80
+
     def __init__(self, trace_file: Path):
         self.trace_file = trace_file
         self.events: List[TraceEvent] = []
         self.task_registry: Dict[int, str] = {}
+        self.task_index: List[int] = []  # Handles in registry order (V2 handle indices)
+        self.encoding = "V1"
         self.cpu_frequency = 168000000  # STM32F205 default (168 MHz)
 
     def parse(self) -> bool:
@@ -88,9 +102,13 @@ class TraceParser:
             self._parse_text_data(content)
 
             # Parse binary trace events
-            self._parse_binary_events(content)
+            if self.V2_HEADER in content:
+                self.encoding = "V2"
+                self._parse_v2_events(content)
+            else:
+                self._parse_binary_events(content)
 
-            print(f"Parsed {len(self.events)} trace events")
+            print(f"Parsed {len(self.events)} trace events ({self.encoding} encoding)")
             print(f"Registered {len(self.task_registry)} tasks")
             if self.task_registry:
                 print("Task registry:")
@@ -102,6 +120,33 @@ class TraceParser:
             print(f"Error parsing trace file: {e}", file=sys.stderr)
             return False
 
+    def parse_native(self, threads: int = 0) -> bool:
+        """
+        Parse with the rtt_host C++ library (memory-mapped, 64-bit extended timestamps)
+
+        Args:
+            threads: Analysis worker threads of the library, 0 for one per CPU
+
+        Returns:
+            False if the library is not available or the file cannot be decoded
+        """
+        try:
+            import rtt_host  # pylint: disable=import-outside-toplevel
+
+            with rtt_host.NativeTrace(self.trace_file, threads=threads) as trace:
+                self.encoding = trace.summary().encoding
+                self.events = [
+                    TraceEvent(event_type=r.type, event_name=TRACE_EVENTS.get(r.type, "UNKNOWN"), timestamp=r.timestamp, handle=r.handle, data=r.data) for r in trace.records
+                ]
+                self.task_registry = trace.task_registry()
+        except (ImportError, RuntimeError) as e:
+            print(f"Error: native decoder unavailable: {e}", file=sys.stderr)
+            return False
+
+        print(f"Parsed {len(self.events)} trace events ({self.encoding} encoding, native)")
+        print(f"Registered {len(self.task_registry)} tasks")
+        return True
+
     def _parse_text_data(self, content: bytes):
         """Parse text markers and task registry"""
         try:
@@ -123,19 +168,57 @@ class TraceParser:
                                 handle = int(parts[1])
                                 name = parts[2].strip()
                                 self.task_registry[handle] = name
+                                self.task_index.append(handle)
                                 print(f"  Registered task: handle=0x{handle:08X} ({handle}), name='{name}'")
                             except ValueError as e:
                                 print(f"  Warning: Failed to parse task entry '{line}': {e}")
-            else:
+            elif self.REGISTRY_MARKER not in content:
                 print("  Warning: No task registry found in trace data")
         except Exception as e:
             print(f"  Warning: Error parsing text data: {e}")
 
+    def _parse_binary_registry(self, content: bytes, offset: int) -> int:
+        """Parse a binary task registry block, returns offset after it"""
+        offset += len(self.REGISTRY_MARKER)
+        if offset >= len(content):
+            return len(content)
+
+        count = content[offset]
+        offset += 1
+        handles = []
+        for _ in range(count):
+            if offset + 5 > len(content):
+                return len(content)
+            handle, length = struct.unpack_from("<IB", content, offset)
+            offset += 5
+            if offset + length > len(content):
+                return len(content)
+            self.task_registry[handle] = content[offset : offset + length].decode("utf-8", errors="replace")
+            handles.append(handle)
+            offset += length
+
+        # A resent registry replaces the index mapping (a reused TCB keeps its index)
+        self.task_index = handles
+        return offset
+
     def _parse_binary_events(self, content: bytes):
         """Parse binary trace events"""
         offset = 0
 
         while offset + self.EVENT_SIZE <= len(content):
+            if content.startswith(self.REGISTRY_MARKER, offset):
+                offset = self._parse_binary_registry(content, offset)
+                continue
+            # Skip in-band text so it isn't mistaken for events
+            if content.startswith(b"TASK_REGISTRY_START\n", offset):
+                end = content.find(b"TASK_REGISTRY_END\n", offset)
+                offset = len(content) if end < 0 else end + len(b"TASK_REGISTRY_END\n")
+                continue
+            marker = next((m for m in self.TEXT_MARKERS if content.startswith(m, offset)), None)
+            if marker is not None:
+                offset += len(marker)
+                continue
+
             try:
                 # Try to extract an event
                 event_bytes = content[offset : offset + self.EVENT_SIZE]
@@ -155,6 +238,93 @@ class TraceParser:
                 # Not enough bytes for a full event
                 break
 
+    @staticmethod
+    def _read_varint(content: bytes, offset: int) -> Tuple[int, int]:
+        """Read an unsigned LEB128 varint, returns (value, new offset)"""
+        value = 0
+        shift = 0
+        while True:
+            if offset >= len(content) or shift > 35:
+                msg = "Truncated varint"
+                raise ValueError(msg)
+            byte = content[offset]
+            offset += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value, offset
+
+    def _parse_v2_registry(self, content: bytes, offset: int) -> int:
+        """Parse an in-band task registry block, returns offset after it"""
+        end = content.find(b"TASK_REGISTRY_END\n", offset)
+        if end < 0:
+            return len(content)
+
+        self.task_index = []
+        for line in content[offset:end].decode("utf-8", errors="ignore").split("\n"):
+            if line.startswith("TASK:"):
+                parts = line.split(":", 2)
+                if len(parts) >= 3 and parts[1].isdigit():
+                    handle = int(parts[1])
+                    self.task_registry[handle] = parts[2].strip()
+                    self.task_index.append(handle)
+        return end + len(b"TASK_REGISTRY_END\n")
+
+    def _decode_v2_handle(self, value: int) -> int:
+        """Decode a V2 handle (registry index or raw handle)"""
+        if value & 1:
+            index = value >> 1
+            return self.task_index[index] if index < len(self.task_index) else index
+        return value >> 1
+
+    def _parse_v2_events(self, content: bytes):
+        """Parse RTT_TRACE_V2 delta/varint encoded events"""
+        offset = content.find(self.V2_HEADER) + len(self.V2_HEADER)
+        timestamp = None  # Unknown until the first sync record
+
+        while offset < len(content):
+            if content.startswith(b"TASK_REGISTRY_START\n", offset):
+                offset = self._parse_v2_registry(content, offset)
+                continue
+            if content.startswith(self.REGISTRY_MARKER, offset):
+                offset = self._parse_binary_registry(content, offset)
+                continue
+            marker = next((m for m in self.TEXT_MARKERS if content.startswith(m, offset)), None)
+            if marker is not None:
+                offset += len(marker)
+                continue
+
+            first = content[offset]
+            if first == self.V2_SYNC:
+                if offset + 5 > len(content):
+                    break
+                timestamp = struct.unpack_from("<I", content, offset + 1)[0]
+                offset += 5
+                continue
+
+            event_type = first & 0x7F
+            if timestamp is None or event_type not in TRACE_EVENTS:
+                # Lost framing: skip ahead to the next sync record
+                timestamp = None
+                offset += 1
+                continue
+
+            try:
+                zigzag, next_offset = self._read_varint(content, offset + 1)
+                handle, next_offset = self._read_varint(content, next_offset)
+                data = 0
+                if first & self.V2_HAS_DATA:
+                    data, next_offset = self._read_varint(content, next_offset)
+            except ValueError:
+                break
+
+            delta = (zigzag >> 1) ^ -(zigzag & 1)
+            timestamp = (timestamp + delta) & 0xFFFFFFFF
+            self.events.append(
+                TraceEvent(event_type=event_type, event_name=TRACE_EVENTS[event_type], timestamp=timestamp, handle=self._decode_v2_handle(handle), data=data)
+            )
+            offset = next_offset
+
     def get_task_name(self, handle: int) -> str:
         """Get task name from handle"""
         return self.task_registry.get(handle, f"Task_0x{handle:08X}")
@@ -171,6 +341,15 @@ class TraceAnalyzer:
         self.parser = parser
         self.events = parser.events
 
+    def get_gaps(self) -> List[Tuple[int, int]]:
+        """
+        Get the gaps reported by EVENTS_LOST records
+
+        Returns:
+            List of (timestamp of the first lost event, number of lost events)
+        """
+        return [(e.timestamp, e.data) for e in self.events if e.event_name == "EVENTS_LOST"]
+
     def print_summary(self):
         """Print summary statistics"""
         print("\n=== Trace Summary ===")
@@ -194,6 +373,12 @@ class TraceAnalyzer:
         print(f"Start timestamp: {start_time}")
         print(f"End timestamp: {end_time}")
 
+        gaps = self.get_gaps()
+        if gaps:
+            print(f"\nLost events: {sum(count for _, count in gaps)} in {len(gaps)} gap(s)")
+            for timestamp, count in gaps:
+                print(f"  {count:6d} events lost since {self.parser.timestamp_to_seconds(timestamp):.6f}s")
+
     def analyze_task_runtime(self):
         """Analyze task runtime statistics with detailed execution metrics"""
         print("\n=== Task Runtime Analysis ===")
@@ -210,7 +395,12 @@ class TraceAnalyzer:
         unmatched_out = 0
 
         for event in self.events:
-            if event.event_name == "TASK_SWITCHED_IN":
+            if event.event_name == "EVENTS_LOST":
+                # The switch out may be among the lost events; don't count across the gap
+                current_task = None
+                task_start_time = None
+
+            elif event.event_name == "TASK_SWITCHED_IN":
                 # Validation: Check if previous task switch-in wasn't closed
                 if current_task is not None:
                     print(f"  Warning: Task 0x{current_task:08X} switched in without switching out", file=sys.stderr)
@@ -300,7 +490,9 @@ class TraceAnalyzer:
         isr_durations = []
 
         for event in self.events:
-            if event.event_name == "ISR_ENTER":
+            if event.event_name == "EVENTS_LOST":
+                isr_start_time = None
+            elif event.event_name == "ISR_ENTER":
                 isr_start_time = event.timestamp
                 isr_count += 1
             elif event.event_name == "ISR_EXIT" and isr_start_time is not None:
@@ -336,6 +528,8 @@ class TraceAnalyzer:
             if event.event_name in ["TASK_SWITCHED_IN", "TASK_SWITCHED_OUT"]:
                 task_name = self.parser.get_task_name(event.handle)
                 print(f"{time_sec:12.6f}s: {event.event_name:25s} {task_name}")
+            elif event.event_name == "EVENTS_LOST":
+                print(f"{time_sec:12.6f}s: {event.event_name:25s} LOST {event.data} events")
             else:
                 print(f"{time_sec:12.6f}s: {event.event_name:25s} handle=0x{event.handle:08X}")
 
@@ -346,6 +540,8 @@ class TraceAnalyzer:
         data = {
             "metadata": {
                 "total_events": len(self.events),
+                "encoding": self.parser.encoding,
+                "lost_events": sum(count for _, count in self.get_gaps()),
                 "cpu_frequency": self.parser.cpu_frequency,
                 "task_registry": {str(k): v for k, v in self.parser.task_registry.items()},
             },
@@ -384,8 +580,16 @@ class TraceAnalyzer:
         for event in self.events:
             timestamp_us = self.parser.timestamp_to_seconds(event.timestamp) * 1_000_000  # Convert to microseconds
 
+            # Gaps - open tasks and ISRs can't be closed reliably across them
+            if event.event_name == "EVENTS_LOST":
+                trace_events.append(
+                    {"name": "Events lost", "cat": "trace", "ph": "i", "s": "g", "ts": timestamp_us, "pid": 0, "tid": 0, "args": {"count": event.data}}
+                )
+                active_tasks.clear()
+                active_isrs.clear()
+
             # Task switch events - use duration events
-            if event.event_name == "TASK_SWITCHED_IN":
+            elif event.event_name == "TASK_SWITCHED_IN":
                 task_name = self.parser.get_task_name(event.handle)
                 active_tasks[event.handle] = {"name": task_name, "ts": timestamp_us}
 
@@ -614,6 +818,97 @@ class TraceAnalyzer:
         self.export_chrome_trace(output_file)
 
 
+class NativeTraceReport:
+    """Print the analysis from the rtt_host library's streaming summary, without decoding events into Python"""
+
+    def __init__(self, trace, cpu_frequency: int):
+        """
+        Args:
+            trace: Open rtt_host.NativeTrace
+            cpu_frequency: CPU frequency in Hz
+        """
+        self.trace = trace
+        self.summary = trace.summary()
+        self.cpu_frequency = cpu_frequency
+
+    def timestamp_to_seconds(self, timestamp: float) -> float:
+        """Convert cycle count to seconds"""
+        return timestamp / self.cpu_frequency
+
+    def print_summary(self):
+        """Print summary statistics"""
+        summary = self.summary
+        print("\n=== Trace Summary ===")
+        print(f"Total events: {summary.events}")
+
+        if not summary.events:
+            return
+
+        print("\nEvent type breakdown:")
+        counts: Counter = Counter()
+        for event_type, count in self.trace.type_counts().items():
+            counts[TRACE_EVENTS.get(event_type, "UNKNOWN")] += count
+        for event_name, count in sorted(counts.items()):
+            percentage = (count / summary.events) * 100
+            print(f"  {event_name:25s}: {count:6d} ({percentage:5.1f}%)")
+
+        duration = self.timestamp_to_seconds(summary.last_timestamp - summary.first_timestamp)
+        print(f"\nTrace duration: {duration:.6f} seconds")
+        print(f"Start timestamp: {summary.first_timestamp}")
+        print(f"End timestamp: {summary.last_timestamp}")
+
+        if summary.gaps:
+            print(f"\nLost events: {summary.lost_events} in {summary.gaps} gap(s)")
+
+    def analyze_task_runtime(self):
+        """Print task runtime statistics"""
+        print("\n=== Task Runtime Analysis ===")
+        stats = [task for task in self.trace.task_stats() if task.count]
+        if not stats:
+            print("No task switch events found")
+            return
+
+        summary = self.summary
+        if summary.unmatched_in > 0 or summary.unmatched_out > 0:
+            print(f"\nValidation warnings: {summary.unmatched_in} unmatched SWITCHED_IN, {summary.unmatched_out} unmatched SWITCHED_OUT events")
+
+        total_runtime = sum(task.total for task in stats)
+        trace_duration = summary.last_timestamp - summary.first_timestamp
+        cpu_utilization = (total_runtime / trace_duration * 100) if trace_duration > 0 else 0
+
+        print(f"\nTrace duration: {self.timestamp_to_seconds(trace_duration):.6f} seconds")
+        print(f"Total task runtime: {self.timestamp_to_seconds(total_runtime):.6f} seconds")
+        print(f"CPU utilization: {cpu_utilization:.1f}%")
+        print(f"Idle time: {100 - cpu_utilization:.1f}%")
+        print("\nTask runtime breakdown:")
+        print(f"{'Task Name':<20} {'Runtime':>12} {'CPU %':>7} {'Executions':>12} {'Avg Time':>12} {'Min Time':>12} {'Max Time':>12}")
+        print("-" * 110)
+
+        for task in sorted(stats, key=lambda t: t.total, reverse=True):
+            cpu_percent = (task.total / trace_duration) * 100 if trace_duration > 0 else 0
+            avg_time = self.timestamp_to_seconds(task.total / task.count)
+            print(
+                f"{task.name:<20} {self.timestamp_to_seconds(task.total):10.6f}s {cpu_percent:6.1f}% {task.count:12d} "
+                f"{avg_time:10.6f}s {self.timestamp_to_seconds(task.min):10.6f}s {self.timestamp_to_seconds(task.max):10.6f}s"
+            )
+
+    def analyze_interrupts(self):
+        """Print interrupt statistics"""
+        print("\n=== Interrupt Analysis ===")
+        summary = self.summary
+        if summary.isr_count == 0:
+            print("No interrupts recorded")
+            return
+
+        print(f"Total interrupts: {summary.isr_count}")
+
+        if summary.isr_matched:
+            print(f"Average ISR duration: {self.timestamp_to_seconds(summary.isr_total / summary.isr_matched):.6f}s")
+            print(f"Min ISR duration: {self.timestamp_to_seconds(summary.isr_min):.6f}s")
+            print(f"Max ISR duration: {self.timestamp_to_seconds(summary.isr_max):.6f}s")
+            print(f"Total ISR time: {self.timestamp_to_seconds(summary.isr_total):.6f}s")
+
+
 def main():
     """Main entry point"""
     parser = argparse.ArgumentParser(description="FreeRTOS Trace Analyzer - Analyze RTT trace data")
@@ -627,6 +922,9 @@ def main():
     parser.add_argument("--export-json", type=Path, help="Export trace data to JSON file")
     parser.add_argument("--export-chrome-trace", type=Path, help="Export trace data to Chrome Trace format (viewable in chrome://tracing)")
     parser.add_argument("--export-perfetto", type=Path, help="Export trace data to Perfetto format (viewable in https://ui.perfetto.dev/)")
+    parser.add_argument("--export-perfetto-proto", type=Path, help="Stream trace data to a Perfetto protobuf trace with the rtt_host library")
+    parser.add_argument("--native", action="store_true", help="Decode and analyze with the rtt_host C++ library (see scripts/rtt_host.py)")
+    parser.add_argument("--threads", type=int, default=0, help="Worker threads of the rtt_host library (default: one per CPU)")
     parser.add_argument("--cpu-freq", type=int, default=120000000, help="CPU frequency in Hz (default: 128000000 for STM32F205)")
 
     args = parser.parse_args()
@@ -635,11 +933,49 @@ def main():
         print(f"Error: Trace file '{args.tracefile}' not found", file=sys.stderr)
         return 1
 
+    # Streams straight from the file, no events are held in Python
+    if args.export_perfetto_proto:
+        try:
+            import rtt_host  # pylint: disable=import-outside-toplevel
+
+            summary = rtt_host.export_perfetto(args.tracefile, args.export_perfetto_proto, args.cpu_freq, threads=args.threads)
+        except (ImportError, RuntimeError) as e:
+            print(f"Error: {e}", file=sys.stderr)
+            return 1
+        print(f"Exported {summary.events} events to Perfetto protobuf trace: {args.export_perfetto_proto}")
+        print("View in Perfetto: https://ui.perfetto.dev/")
+
+        # Only decode the trace again if other output was requested as well
+        analysis = (args.stats, args.timeline, args.task_runtime, args.interrupts, args.export_json, args.export_chrome_trace, args.export_perfetto)
+        if not any(analysis):
+            return 0
+
+    # Summary and statistics come straight from the library's streaming pass
+    needs_events = args.timeline or args.export_json or args.export_chrome_trace or args.export_perfetto
+    if args.native and not needs_events:
+        try:
+            import rtt_host  # pylint: disable=import-outside-toplevel
+
+            with rtt_host.NativeTrace(args.tracefile, threads=args.threads) as trace:
+                report = NativeTraceReport(trace, args.cpu_freq)
+                print(f"Analyzed {report.summary.events} trace events ({report.summary.encoding} encoding, native)")
+                print(f"Registered {len(trace.task_registry())} tasks")
+                if args.stats or (not args.task_runtime and not args.interrupts):
+                    report.print_summary()
+                if args.task_runtime:
+                    report.analyze_task_runtime()
+                if args.interrupts:
+                    report.analyze_interrupts()
+        except (ImportError, RuntimeError) as e:
+            print(f"Error: native decoder unavailable: {e}", file=sys.stderr)
+            return 1
+        return 0
+
     # Parse trace file
     trace_parser = TraceParser(args.tracefile)
     trace_parser.cpu_frequency = args.cpu_freq
 
-    if not trace_parser.parse():
+    if not (trace_parser.parse_native(args.threads) if args.native else trace_parser.parse()):
         return 1
 
     # Analyze trace
@@ -47,6 +47,7 @@ TRACE_EVENTS = {
     0x52: "TIMER_STOP",
     0x60: "MALLOC",
     0x61: "FREE",
+    0x70: "EVENTS_LOST",
 }
 
 
@@ -1,8 +1,9 @@
 """Shared test utilities and fixtures for RTT tools tests."""
 
+import struct
 import tempfile
 from pathlib import Path
-from typing import Generator
+from typing import Generator, List, Optional, Tuple
 
 import pytest
 
@@ -37,3 +38,62 @@ def sample_binary_file(temp_dir: Path) -> Path:
     # Write some test binary data
     binary_file.write_bytes(b"\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09")
     return binary_file
+
+
+def build_elf32(sections: List[Tuple[str, int, bytes]], symbols: Optional[List[Tuple[str, int, int]]] = None) -> bytes:
+    """
+    Build a minimal little-endian ELF32 image.
+
+    Args:
+        sections: (name, address, contents) for each PROGBITS section
+        symbols: (name, address, size) for each function symbol
+    """
+    symbols = symbols or []
+    strtab = b"\x00"
+    symtab = b"\x00" * 16
+    for name, address, size in symbols:
+        symtab += struct.pack("<IIIBBH", len(strtab), address, size, 0x12, 0, 1)
+        strtab += name.encode() + b"\x00"
+
+    # (name, type, address, contents, link)
+    entries = [(name, 1, address, data, 0) for name, address, data in sections]
+    strtab_index = len(entries) + 2
+    entries.append((".symtab", 2, 0, symtab, strtab_index))
+    entries.append((".strtab", 3, 0, strtab, 0))
+    entries.append((".shstrtab", 3, 0, b"", 0))
+
+    shstrtab = b"\x00"
+    name_offsets = []
+    for entry in entries:
+        name_offsets.append(len(shstrtab))
+        shstrtab += entry[0].encode() + b"\x00"
+    entries[-1] = (".shstrtab", 3, 0, shstrtab, 0)
+
+    body = b""
+    offsets = []
+    for entry in entries:
+        offsets.append(52 + len(body))
+        body += entry[3]
+    shoff = 52 + len(body)
+
+    header = b"\x7fELF" + bytes([1, 1, 1]) + b"\x00" * 9
+    header += struct.pack("<HHIIIIIHHHHHH", 2, 40, 1, 0, 0, shoff, 0, 52, 0, 0, 40, len(entries) + 1, len(entries))
+
+    section_headers = b"\x00" * 40
+    for (_, sh_type, address, data, link), name_offset, offset in zip(entries, name_offsets, offsets):
+        section_headers += struct.pack("<IIIIIIIIII", name_offset, sh_type, 0, address, offset, len(data), link, 0, 1, 16 if sh_type == 2 else 0)
+
+    return header + body + section_headers
+
+
+@pytest.fixture
+def sample_elf_file(temp_dir: Path) -> Path:
+    """Create a sample ELF file with deferred log format strings."""
+    elf_file = temp_dir / "firmware.elf"
+    elf_file.write_bytes(
+        build_elf32(
+            [(".text", 0x08000000, b"\x00" * 64), (".rtt_fmt.0", 0x0, b"Value: %d\x00Name: %s\x00"), (".rtt_fmt.1", 0x20, b"Pi: %.2f\x00")],
+            [("main", 0x08000000, 32), ("worker", 0x08000020, 32)],
+        )
+    )
+    return elf_file
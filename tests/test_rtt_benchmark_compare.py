@@ -0,0 +1,121 @@
+"""Unit tests for rtt_benchmark_compare.py."""
+
+import json
+import struct
+from pathlib import Path
+
+from rtt_benchmark_compare import RESULT_SCHEMA_NAME, BenchmarkRecord, compare, extract_results, load_json, run, to_json
+from rtt_data_reader import DataType
+
+SCHEMA_ID = 0xB0
+RESULT_FIELDS = [("argument", DataType.UInt32), ("iterations", DataType.UInt32), ("overhead", DataType.UInt32), ("frequency", DataType.UInt32)]
+RESULT_FIELDS += [(name, DataType.UInt64) for name in ["min", "mean", "max", "stddev", "p50", "p90", "p99", "p999"]]
+RESULT_SIZE = 32 + 4 * 4 + 8 * 8
+
+
+def packet(data_type: DataType, subtype: int, payload: bytes) -> bytes:
+    """Build an rtt_data packet."""
+    return struct.pack("<2sBBII", b"RD", data_type, subtype, len(payload), 0) + payload
+
+
+def schema_packet() -> bytes:
+    """Build the Schema packet Suite::run sends for BenchmarkResult."""
+    fields = [("name", DataType.Int8, 0, 32)]
+    offset = 32
+    for name, data_type in RESULT_FIELDS:
+        fields.append((name, data_type, offset, 1))
+        offset += 4 if data_type == DataType.UInt32 else 8
+
+    payload = struct.pack("<HB", RESULT_SIZE, len(fields)) + bytes([len(RESULT_SCHEMA_NAME)]) + RESULT_SCHEMA_NAME.encode()
+    for name, data_type, field_offset, count in fields:
+        payload += struct.pack("<BHH", data_type, field_offset, count) + bytes([len(name)]) + name.encode()
+    return packet(DataType.Schema, SCHEMA_ID, payload)
+
+
+def result_packet(name: str, p50: int, argument: int = 0, frequency: int = 100_000_000) -> bytes:
+    """Build a BenchmarkResult Struct packet."""
+    payload = name.encode().ljust(32, b"\0")
+    payload += struct.pack("<4I", argument, 100, 6, frequency)
+    payload += struct.pack("<8Q", p50 - 10, p50, p50 + 50, 5, p50, p50 + 5, p50 + 20, p50 + 40)
+    return packet(DataType.Struct, SCHEMA_ID, payload)
+
+
+def record(name: str, p50: int, frequency: int = 100_000_000) -> BenchmarkRecord:
+    """Build a result record."""
+    return BenchmarkRecord(name, 0, 100, 6, frequency, p50, p50, p50, 0, p50, p50, p50, p50)
+
+
+class TestExtractResults:
+    """Test decoding results from a capture."""
+
+    def test_extract(self) -> None:
+        """Test decoding results between other packets and noise."""
+        data = b"noise" + schema_packet() + packet(DataType.Int32, 0, struct.pack("<i", 5))
+        data += result_packet("crc/64", 1200, argument=64) + result_packet("spin", 80)
+        results = extract_results(data)
+
+        assert [r.name for r in results] == ["crc/64", "spin"]
+        assert results[0].argument == 64
+        assert results[0].p50 == 1200
+        assert results[0].p999 == 1240
+        assert results[0].nanoseconds("p50") == 12000.0
+
+    def test_requires_schema(self) -> None:
+        """Test that results without a schema are not decoded."""
+        assert extract_results(result_packet("spin", 80)) == []
+
+    def test_ignores_other_structs(self) -> None:
+        """Test that structs of other schemas are skipped."""
+        data = schema_packet().replace(RESULT_SCHEMA_NAME.encode(), b"rtt::benchmark::BenchmarkResulX")
+        assert extract_results(data + result_packet("spin", 80)) == []
+
+
+class TestCompare:
+    """Test baseline comparison."""
+
+    def test_statuses(self) -> None:
+        """Test regression, improvement, ok, new and missing results."""
+        baseline = {"a": record("a", 100), "b": record("b", 100), "c": record("c", 100), "gone": record("gone", 100)}
+        current = {"a": record("a", 110), "b": record("b", 90), "c": record("c", 103), "added": record("added", 100)}
+        statuses = {c.name: c.status for c in compare(baseline, current, "p50", 0.05)}
+        assert statuses == {"a": "regression", "b": "improvement", "c": "ok", "gone": "missing", "added": "new"}
+
+    def test_compares_time_not_ticks(self) -> None:
+        """Test that results at different clock frequencies are compared in nanoseconds."""
+        comparisons = compare({"a": record("a", 100, 100_000_000)}, {"a": record("a", 200, 200_000_000)})
+        assert comparisons[0].status == "ok"
+        assert comparisons[0].change == 0.0
+
+
+class TestJson:
+    """Test the JSON results format."""
+
+    def test_round_trip(self, temp_dir: Path) -> None:
+        """Test writing and loading results."""
+        path = temp_dir / "results.json"
+        path.write_text(json.dumps(to_json([record("a", 100)])))
+        assert load_json(str(path)) == {"a": record("a", 100)}
+
+
+class TestRun:
+    """Test the command line entry point."""
+
+    def test_baseline_gate(self, temp_dir: Path) -> None:
+        """Test storing a baseline, then failing on a regression."""
+        baseline = temp_dir / "baseline.json"
+        capture = temp_dir / "bench.bin"
+        capture.write_bytes(schema_packet() + result_packet("spin", 100))
+        assert run(str(capture), output=str(baseline)) == 0
+
+        capture.write_bytes(schema_packet() + result_packet("spin", 102))
+        assert run(str(capture), baseline=str(baseline)) == 0
+
+        capture.write_bytes(schema_packet() + result_packet("spin", 150))
+        assert run(str(capture), baseline=str(baseline)) == 1
+        assert run(str(capture), baseline=str(baseline), threshold=0.6) == 0
+
+    def test_no_results(self, temp_dir: Path) -> None:
+        """Test a capture without benchmark results."""
+        capture = temp_dir / "bench.bin"
+        capture.write_bytes(b"")
+        assert run(str(capture)) == 2
@@ -0,0 +1,127 @@
+"""Unit tests for rtt_crash_decoder.py."""
+
+import struct
+from pathlib import Path
+
+from conftest import build_elf32
+from rtt_crash_decoder import CrashDecoder, CrashRecord, Symbolizer, decode_file
+
+
+def make_record(
+    fault_type: int = 0,
+    flags: int = 0,
+    pc: int = 0x08000104,
+    lr: int = 0x08000025,
+    cfsr: int = 0,
+    bfar: int = 0,
+    fpu=None,
+    addresses=(),
+) -> bytes:
+    """Build a binary crash record as sent by FaultHandler::sendCrashRecord."""
+    registers = [0x10, 0x11, 0x12, 0x13, 0x1C, lr, pc, 0x21000000]
+    fpu = list(fpu) if fpu is not None else [0] * 17
+    size = CrashDecoder.FIXED_SIZE + 4 * len(addresses)
+    data = struct.pack("<2sBBBBH", b"RC", 1, fault_type, flags, len(addresses), size)
+    data += struct.pack("<8I", *registers)
+    data += struct.pack("<6I", 0xFFFFFFFD, 0x20001000, cfsr, 0x40000000, 0, bfar)
+    data += struct.pack("<17I", *fpu)
+    return data + struct.pack(f"<{len(addresses)}I", *addresses)
+
+
+class TestParseRecord:
+    """Test record parsing."""
+
+    def test_fixed_size(self) -> None:
+        """Test that the fixed part matches the C++ layout."""
+        assert CrashDecoder.FIXED_SIZE == 132
+
+    def test_fields(self) -> None:
+        """Test decoding all record fields."""
+        record, consumed = CrashDecoder.parse_record(make_record(2, CrashRecord.FLAG_PSP, cfsr=0x8200, bfar=0x40001234, addresses=[0x08000030]))
+        assert consumed == 136
+        assert record.fault_name == "BusFault"
+        assert record.pc == 0x08000104
+        assert record.lr == 0x08000025
+        assert record.uses_psp
+        assert not record.has_fpu_frame
+        assert record.sp == 0x20001000
+        assert record.bfar == 0x40001234
+        assert record.return_addresses == [0x08000030]
+
+    def test_rejects_bad_size(self) -> None:
+        """Test that a size not matching the address count is rejected."""
+        data = bytearray(make_record(addresses=[1, 2]))
+        data[6] = 0
+        assert CrashDecoder.parse_record(bytes(data)) == (None, 0)
+
+    def test_truncated(self) -> None:
+        """Test that an incomplete record is not parsed."""
+        assert CrashDecoder.parse_record(make_record(addresses=[1])[:-1]) == (None, 0)
+
+    def test_find_in_stream(self) -> None:
+        """Test locating records between text output."""
+        data = b"[INFO] RC text before\r\n" + make_record(0) + b"more text" + make_record(3)
+        assert [r.fault_name for r in CrashDecoder.find_records(data)] == ["HardFault", "UsageFault"]
+
+
+class TestSymbolizer:
+    """Test address to symbol resolution."""
+
+    def test_lookup(self) -> None:
+        """Test lookup inside, between and outside functions."""
+        symbolizer = Symbolizer([(0x08000000, 0x20, "main"), (0x08000100, 0x40, "worker")])
+        assert symbolizer.lookup(0x08000004) == ("main", 4)
+        assert symbolizer.lookup(0x08000080) is None
+        assert symbolizer.lookup(0x07FFFFFF) is None
+        assert symbolizer.describe(0x08000105) == "0x08000104 worker+0x4"
+        assert symbolizer.describe(0x20000000) == "0x20000000"
+
+    def test_from_elf(self, temp_dir: Path) -> None:
+        """Test loading Thumb function symbols from an ELF file."""
+        elf_file = temp_dir / "firmware.elf"
+        elf_file.write_bytes(build_elf32([(".text", 0x08000000, b"\x00" * 64)], [("main", 0x08000001, 32), ("worker", 0x08000021, 32)]))
+        symbolizer = Symbolizer.from_elf(str(elf_file))
+        assert symbolizer.lookup(0x08000024) == ("worker", 4)
+
+
+class TestFormatRecord:
+    """Test report rendering."""
+
+    def test_report(self) -> None:
+        """Test the symbolized report."""
+        symbolizer = Symbolizer([(0x08000000, 0x40, "main"), (0x08000100, 0x40, "worker")])
+        record, _ = CrashDecoder.parse_record(make_record(2, cfsr=0x8200, bfar=0x40001234, addresses=[0x08000030]))
+        lines = CrashDecoder.format_record(record, symbolizer)
+        assert "Fault Type: BusFault" in lines
+        assert "PC  = 0x08000104 worker+0x4" in lines
+        assert "  PRECISERR: Precise data bus error" in lines
+        assert "BFAR  = 0x40001234" in lines
+        assert lines[-3:] == ["  #0 0x08000104 worker+0x4", "  #1 0x08000024 main+0x24", "  #2 0x08000030 main+0x30"]
+
+    def test_fpu_frame(self) -> None:
+        """Test that FP registers are shown only for an FP frame."""
+        fpu = [struct.unpack("<I", struct.pack("<f", 1.5))[0]] + [0] * 16
+        record, _ = CrashDecoder.parse_record(make_record(flags=CrashRecord.FLAG_FPU_FRAME, fpu=fpu))
+        assert "S0  = 0x3FC00000 (1.5)" in CrashDecoder.format_record(record)
+        record, _ = CrashDecoder.parse_record(make_record())
+        assert "--- FPU Registers ---" not in CrashDecoder.format_record(record)
+
+
+class TestDecodeFile:
+    """Test the command line entry point."""
+
+    def test_decode(self, temp_dir: Path) -> None:
+        """Test decoding a capture file."""
+        capture = temp_dir / "capture.bin"
+        capture.write_bytes(make_record())
+        assert decode_file(str(capture)) == 0
+
+    def test_no_records(self, temp_dir: Path) -> None:
+        """Test a capture without records."""
+        capture = temp_dir / "capture.bin"
+        capture.write_bytes(b"just text\n")
+        assert decode_file(str(capture)) == 1
+
+    def test_missing_file(self, temp_dir: Path) -> None:
+        """Test a missing capture file."""
+        assert decode_file(str(temp_dir / "missing.bin")) == 1
@@ -1,8 +1,9 @@
 """Unit tests for rtt_data_reader.py."""
 
 import struct
+from pathlib import Path
 
-from rtt_data_reader import DataHeader, DataType, RttDataReader
+from rtt_data_reader import DataHeader, DataType, MemoryChunk, RttDataReader, merge_memory, read_from_file
 
 
 class TestDataType:
@@ -14,6 +15,7 @@ class TestDataType:
         assert DataType.UInt8 == 1
         assert DataType.String == 10
         assert DataType.Binary == 11
+        assert DataType.Array == 12
 
 
 class TestDataHeader:
@@ -169,3 +171,151 @@ class TestRttDataReader:
         _value, consumed = reader.process_packet(header_data)
         assert consumed == 0  # Not enough data
         assert reader.packet_count == 0
+
+
+class TestArrayPackets:
+    """Test Array packets sent by DataSender::sendArray and SampleBlock."""
+
+    def test_element_type(self) -> None:
+        """Test that the element type is taken from the reserved byte."""
+        assert DataHeader(b"RD", DataType.Array, DataType.Int16, 4, 0).element_type == DataType.Int16
+        assert DataHeader(b"RD", DataType.Int16, 0, 2, 0).element_type is None
+        assert DataHeader(b"RD", DataType.Array, 200, 4, 0).element_type is None
+
+    def test_parse_int16_array(self) -> None:
+        """Test decoding a packet of Int16 samples as a list."""
+        reader = RttDataReader()
+        payload = struct.pack("<4h", 1, -2, 300, -32768)
+        header = DataHeader(b"RD", DataType.Array, DataType.Int16, len(payload), 0)
+        assert reader.parse_data(header, payload) == [1, -2, 300, -32768]
+
+    def test_parse_float_array(self) -> None:
+        """Test decoding a packet of Float samples."""
+        reader = RttDataReader()
+        payload = struct.pack("<2f", 0.5, -1.25)
+        header = DataHeader(b"RD", DataType.Array, DataType.Float, len(payload), 0)
+        assert reader.parse_data(header, payload) == [0.5, -1.25]
+        assert reader.format_value(header, [0.5, -1.25]) == "[Float[2]] [0.500000, -1.250000]"
+
+    def test_invalid_arrays(self) -> None:
+        """Test rejecting unknown element types and partial elements."""
+        reader = RttDataReader()
+        assert reader.parse_data(DataHeader(b"RD", DataType.Array, DataType.String, 2, 0), b"ab") is None
+        assert reader.parse_data(DataHeader(b"RD", DataType.Array, DataType.UInt32, 6, 0), b"\x00" * 6) is None
+
+    def test_process_array_packet(self) -> None:
+        """Test processing a complete Array packet from a stream."""
+        reader = RttDataReader()
+        payload = struct.pack("<3H", 10, 20, 30)
+        packet = struct.pack("<2sBBII", b"RD", DataType.Array, DataType.UInt16, len(payload), 7) + payload
+
+        value, consumed = reader.process_packet(packet + b"next")
+        assert value == [10, 20, 30]
+        assert consumed == RttDataReader.HEADER_SIZE + 6
+        assert reader.packet_count == 1
+
+
+def make_schema_packet(schema_id: int, name: str, size: int, fields) -> bytes:
+    """Build a Schema packet as sent by DataSender::sendSchema."""
+    payload = struct.pack("<HB", size, len(fields)) + bytes([len(name)]) + name.encode()
+    for field_name, data_type, offset, count in fields:
+        payload += struct.pack("<BHH", data_type, offset, count) + bytes([len(field_name)]) + field_name.encode()
+    return struct.pack("<2sBBII", b"RD", DataType.Schema, schema_id, len(payload), 0) + payload
+
+
+IMU_FIELDS = [("accel", DataType.Float, 0, 3), ("temp", DataType.Int16, 12, 1), ("raw", DataType.Binary, 14, 2)]
+
+
+class TestStructPackets:
+    """Test schema-registered struct streaming."""
+
+    def test_schema_registration(self) -> None:
+        """Test that a Schema packet registers the field layout."""
+        reader = RttDataReader()
+        schema, consumed = reader.process_packet(make_schema_packet(3, "Imu", 16, IMU_FIELDS))
+        assert consumed > RttDataReader.HEADER_SIZE
+        assert schema.name == "Imu"
+        assert [f.name for f in schema.fields] == ["accel", "temp", "raw"]
+        assert reader.schemas[3] is schema
+
+    def test_struct_decoding(self) -> None:
+        """Test decoding struct samples into named columns."""
+        reader = RttDataReader()
+        reader.process_packet(make_schema_packet(3, "Imu", 16, IMU_FIELDS))
+        for seq in range(2):
+            payload = struct.pack("<3fh2s", 0.5, -1.0, float(seq), 250 + seq, b"\xaa\xbb")
+            sample, _ = reader.process_packet(struct.pack("<2sBBII", b"RD", DataType.Struct, 3, len(payload), 0) + payload)
+        assert sample == {"accel": [0.5, -1.0, 1.0], "temp": 251, "raw": "aabb"}
+        assert reader.get_columns(3)["temp"] == [250, 251]
+        assert reader.get_columns(7) == {}
+
+    def test_unknown_schema(self) -> None:
+        """Test that samples without a matching schema are errors."""
+        reader = RttDataReader()
+        packet = struct.pack("<2sBBII", b"RD", DataType.Struct, 9, 4, 0) + b"\x00" * 4
+        value, consumed = reader.process_packet(packet)
+        assert value is None
+        assert consumed == len(packet)
+        assert reader.error_count == 1
+
+    def test_invalid_schema(self) -> None:
+        """Test rejecting truncated descriptors and fields outside the struct."""
+        reader = RttDataReader()
+        assert reader.process_packet(make_schema_packet(1, "Bad", 4, [("x", DataType.UInt32, 2, 1)]))[0] is None
+        payload = make_schema_packet(1, "Bad", 16, IMU_FIELDS)[RttDataReader.HEADER_SIZE : -3]
+        assert reader.parse_schema(DataHeader(b"RD", DataType.Schema, 1, len(payload), 0), payload) is None
+        assert reader.schemas == {}
+
+    def test_format(self) -> None:
+        """Test formatting schema and struct packets."""
+        reader = RttDataReader()
+        schema, _ = reader.process_packet(make_schema_packet(3, "Imu", 16, IMU_FIELDS))
+        schema_header = DataHeader(b"RD", DataType.Schema, 3, 0, 0)
+        assert reader.format_value(schema_header, schema) == "[Schema] Imu (id 3): accel: Float[3], temp: Int16, raw: Binary[2]"
+        struct_header = DataHeader(b"RD", DataType.Struct, 3, 16, 0)
+        assert reader.format_value(struct_header, {"temp": 250, "gain": 0.5}) == "[Imu] temp=250, gain=0.500000"
+
+
+def make_memory_packet(address: int, data: bytes, address_size: int = 4) -> bytes:
+    """Build a Memory packet as sent by DataSender::sendMemory."""
+    payload = address.to_bytes(address_size, "little") + data
+    return struct.pack("<2sBBII", b"RD", DataType.Memory, address_size, len(payload), 0) + payload
+
+
+class TestMemoryPackets:
+    """Test raw memory dump packets."""
+
+    def test_parse_memory(self) -> None:
+        """Test decoding 32- and 64-bit addressed chunks."""
+        reader = RttDataReader()
+        chunk, consumed = reader.process_packet(make_memory_packet(0x20000000, b"\x01\x02"))
+        assert chunk == MemoryChunk(0x20000000, b"\x01\x02")
+        assert consumed == RttDataReader.HEADER_SIZE + 6
+        chunk, _ = reader.process_packet(make_memory_packet(0x7FFF00001000, b"ab", 8))
+        assert chunk.address == 0x7FFF00001000
+        assert len(reader.memory) == 2
+
+    def test_invalid_address_size(self) -> None:
+        """Test rejecting unknown address widths."""
+        reader = RttDataReader()
+        assert reader.process_packet(make_memory_packet(0x100, b"ab", 2))[0] is None
+        assert reader.memory == []
+
+    def test_hexdump(self) -> None:
+        """Test the host-side hex and ASCII rendering."""
+        lines = MemoryChunk(0x20000010, b"OK\x00" + bytes(range(16))).hexdump(16)
+        assert lines[0] == "0x20000010: 4F 4B 00 00 01 02 03 04 05 06 07 08 09 0A 0B 0C  | OK.............."
+        assert lines[1] == "0x20000020: 0D 0E 0F                                         | ..."
+
+    def test_merge(self) -> None:
+        """Test merging chunks into contiguous regions, overlaps and gaps."""
+        chunks = [MemoryChunk(0x104, b"efgh"), MemoryChunk(0x100, b"abcd"), MemoryChunk(0x106, b"XY"), MemoryChunk(0x200, b"z")]
+        assert merge_memory(chunks) == [MemoryChunk(0x100, b"abcdefXY"), MemoryChunk(0x200, b"z")]
+        assert merge_memory([]) == []
+
+    def test_write_images(self, temp_dir: Path) -> None:
+        """Test saving a raw dump from a capture as a binary image."""
+        capture = temp_dir / "dump.bin"
+        capture.write_bytes(make_memory_packet(0x20000000, b"\xaa" * 4) + make_memory_packet(0x20000004, b"\xbb" * 4))
+        read_from_file(str(capture), memory_dir=str(temp_dir / "images"))
+        assert (temp_dir / "images" / "memory_0x20000000.bin").read_bytes() == b"\xaa" * 4 + b"\xbb" * 4
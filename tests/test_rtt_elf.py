@@ -0,0 +1,54 @@
+"""Unit tests for rtt_elf.py."""
+
+from pathlib import Path
+
+import pytest
+from conftest import build_elf32
+from rtt_elf import ElfError, ElfFile
+
+
+class TestElfFile:
+    """Test ElfFile class."""
+
+    def test_invalid_magic(self) -> None:
+        """Test rejecting non-ELF data."""
+        with pytest.raises(ElfError):
+            ElfFile(b"not an elf file")
+
+    def test_truncated_file(self) -> None:
+        """Test rejecting a truncated ELF file."""
+        data = build_elf32([(".text", 0, b"\x00" * 4)])
+        with pytest.raises(ElfError):
+            ElfFile(data[:40])
+
+    def test_sections(self, sample_elf_file: Path) -> None:
+        """Test parsing section headers."""
+        elf = ElfFile.from_file(sample_elf_file)
+        assert not elf.is_64bit
+        assert elf.endian == "<"
+
+        text = elf.get_section(".text")
+        assert text is not None
+        assert text.address == 0x08000000
+        assert text.size == 64
+        assert elf.get_section(".missing") is None
+
+    def test_find_sections_by_prefix(self, sample_elf_file: Path) -> None:
+        """Test finding sections by name prefix."""
+        elf = ElfFile.from_file(sample_elf_file)
+        names = [s.name for s in elf.find_sections(".rtt_fmt")]
+        assert names == [".rtt_fmt.0", ".rtt_fmt.1"]
+
+    def test_strings_in_sections(self, sample_elf_file: Path) -> None:
+        """Test collecting strings keyed by address."""
+        elf = ElfFile.from_file(sample_elf_file)
+        strings = elf.strings_in_sections(".rtt_fmt")
+        assert strings == {0x0: "Value: %d", 0xA: "Name: %s", 0x20: "Pi: %.2f"}
+
+    def test_symbols(self, sample_elf_file: Path) -> None:
+        """Test reading the symbol table."""
+        elf = ElfFile.from_file(sample_elf_file)
+        functions = {s.name: s for s in elf.symbols() if s.is_function}
+        assert set(functions) == {"main", "worker"}
+        assert functions["worker"].value == 0x08000020
+        assert functions["worker"].size == 32
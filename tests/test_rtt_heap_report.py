@@ -0,0 +1,155 @@
+"""Unit tests for rtt_heap_report.py."""
+
+import json
+import struct
+from pathlib import Path
+from typing import List
+
+from conftest import build_elf32
+from rtt_crash_decoder import Symbolizer
+from rtt_data_reader import DataType
+from rtt_heap_report import CALLER_SCHEMA_NAME, LEAK_SCHEMA_NAME, SUMMARY_SCHEMA_NAME, extract_reports, format_report, last_report, run
+
+SUMMARY_FIELDS = ["heapSize", "liveBytes", "peakBytes", "liveCount", "allocations", "frees", "failures"]
+SUMMARY_FIELDS += ["failedSize", "failedCaller", "untracked", "unknownFrees", "callers", "leakCandidates"]
+CALLER_FIELDS = ["caller", "allocations", "frees", "liveCount", "liveBytes", "peakBytes", "totalBytes", "largest"]
+LEAK_FIELDS = ["address", "size", "caller", "age"]
+
+
+def packet(data_type: DataType, subtype: int, payload: bytes) -> bytes:
+    """Build an rtt_data packet."""
+    return struct.pack("<2sBBII", b"RD", data_type, subtype, len(payload), 0) + payload
+
+
+def schema_packet(schema_id: int, name: str, fields: List[str]) -> bytes:
+    """Build the Schema packet of a struct of uint32_t fields."""
+    payload = struct.pack("<HB", 4 * len(fields), len(fields)) + bytes([len(name)]) + name.encode()
+    for index, field in enumerate(fields):
+        payload += struct.pack("<BHH", DataType.UInt32, 4 * index, 1) + bytes([len(field)]) + field.encode()
+    return packet(DataType.Schema, schema_id, payload)
+
+
+def schemas() -> bytes:
+    """Build the Schema packets HeapProfiler::report sends."""
+    data = schema_packet(0xC1, SUMMARY_SCHEMA_NAME, SUMMARY_FIELDS)
+    data += schema_packet(0xC2, CALLER_SCHEMA_NAME, CALLER_FIELDS)
+    return data + schema_packet(0xC3, LEAK_SCHEMA_NAME, LEAK_FIELDS)
+
+
+def struct_packet(schema_id: int, fields: List[str], **values: int) -> bytes:
+    """Build a Struct packet, missing fields are 0."""
+    return packet(DataType.Struct, schema_id, struct.pack(f"<{len(fields)}I", *(values.get(f, 0) for f in fields)))
+
+
+def summary(**values: int) -> bytes:
+    """Build a HeapSummary packet."""
+    return struct_packet(0xC1, SUMMARY_FIELDS, **values)
+
+
+def caller(**values: int) -> bytes:
+    """Build a HeapCallerStats packet."""
+    return struct_packet(0xC2, CALLER_FIELDS, **values)
+
+
+def leak(**values: int) -> bytes:
+    """Build a HeapLeakCandidate packet."""
+    return struct_packet(0xC3, LEAK_FIELDS, **values)
+
+
+def sample_report() -> bytes:
+    """Build a report with two callers and one leak candidate."""
+    data = summary(heapSize=4096, liveBytes=96, peakBytes=160, liveCount=3, allocations=5, frees=2, callers=2, leakCandidates=1)
+    data += caller(caller=0x08000011, allocations=1, liveCount=1, liveBytes=16, peakBytes=16, totalBytes=16, largest=16)
+    data += caller(caller=0x08000105, allocations=4, frees=2, liveCount=2, liveBytes=80, peakBytes=144, totalBytes=144, largest=64)
+    return data + leak(address=0x20000100, size=16, caller=0x08000011, age=4)
+
+
+class TestExtractReports:
+    """Test decoding reports from a capture."""
+
+    def test_extract(self) -> None:
+        """Test decoding a report between other packets and noise."""
+        data = b"noise" + schemas() + packet(DataType.Int32, 0, struct.pack("<i", 5)) + sample_report()
+        reports = extract_reports(data)
+
+        assert len(reports) == 1
+        report = reports[0]
+        assert report.complete
+        assert report.summary["liveBytes"] == 96
+        assert [c["caller"] for c in report.callers] == [0x08000011, 0x08000105]
+        assert report.leaks[0]["address"] == 0x20000100
+
+    def test_last_complete_report(self) -> None:
+        """Test that a truncated last report is skipped."""
+        data = schemas() + sample_report() + summary(liveBytes=1, callers=3)
+        reports = extract_reports(data)
+
+        assert len(reports) == 2
+        assert not reports[1].complete
+        assert last_report(reports) is reports[0]
+        assert last_report(reports[1:]) is reports[1]
+        assert last_report([]) is None
+
+    def test_records_before_summary(self) -> None:
+        """Test that caller records without a preceding summary are dropped."""
+        assert extract_reports(schemas() + caller(caller=0x08000011)) == []
+
+
+class TestFormatReport:
+    """Test report rendering."""
+
+    def test_callers_sorted_by_live_bytes(self) -> None:
+        """Test that the caller holding the most memory comes first."""
+        lines = format_report(extract_reports(schemas() + sample_report())[0])
+        rows = [line for line in lines if line.endswith(("0x08000011", "0x08000105"))]
+
+        assert rows[0].endswith("0x08000105")
+        assert "Live:         96 bytes in 3 allocations" in lines
+        assert any(line.startswith("0x20000100") for line in lines)
+
+    def test_fragmentation(self) -> None:
+        """Test the fragmentation hint for a failure smaller than the free heap."""
+        data = schemas() + summary(heapSize=4096, liveBytes=1024, failures=1, failedSize=512, failedCaller=0x08000011)
+        report = extract_reports(data)[0]
+
+        assert report.fragmented
+        lines = format_report(report)
+        assert any("3072 bytes were free" in line for line in lines)
+
+        exhausted = extract_reports(schemas() + summary(heapSize=4096, liveBytes=4000, failures=1, failedSize=512))[0]
+        assert not exhausted.fragmented
+
+    def test_symbolized(self) -> None:
+        """Test resolving callers to functions."""
+        symbolizer = Symbolizer([(0x08000000, 0x20, "main"), (0x08000100, 0x40, "worker")])
+        data = schemas() + summary(callers=2) + caller(caller=0x08000011, liveBytes=4) + caller(caller=0, liveBytes=2)
+        lines = format_report(extract_reports(data)[0], symbolizer)
+
+        assert any(line.endswith("main+0x10") for line in lines)
+        assert any(line.endswith("(other callers)") for line in lines)
+
+
+class TestRun:
+    """Test the command line entry point."""
+
+    def test_run(self, temp_dir: Path, capsys) -> None:
+        """Test printing and JSON output with an ELF file."""
+        capture = temp_dir / "heap.bin"
+        capture.write_bytes(schemas() + sample_report())
+        elf_file = temp_dir / "firmware.elf"
+        elf_file.write_bytes(build_elf32([(".text", 0x08000000, b"\x00" * 512)], [("main", 0x08000001, 32), ("worker", 0x08000101, 64)]))
+        output = temp_dir / "heap.json"
+
+        assert run(str(capture), str(elf_file), str(output)) == 0
+        assert "worker+0x4" in capsys.readouterr().out
+        document = json.loads(output.read_text())
+        assert document["summary"]["peakBytes"] == 160
+        assert len(document["callers"]) == 2
+
+    def test_no_report(self, temp_dir: Path) -> None:
+        """Test the exit code without a report."""
+        capture = temp_dir / "empty.bin"
+        capture.write_bytes(b"")
+
+        assert run(str(capture)) == 2
+        assert run(str(temp_dir / "missing.bin")) == 2
@@ -0,0 +1,279 @@
+"""Unit tests for rtt_host.py (tests using the library are skipped when it was not built)."""
+
+import os
+import struct
+import sys
+from pathlib import Path
+from typing import Iterator, Optional
+
+import pytest
+
+import rtt_data_reader
+import rtt_host
+import rtt_trace_analyzer
+from rtt_trace_analyzer import TraceAnalyzer, TraceParser
+
+LIBRARY = rtt_host.find_library()
+needs_library = pytest.mark.skipif(LIBRARY is None, reason="rtt_host_c library not built")
+
+
+def varint(value: int) -> bytes:
+    """Encode an unsigned LEB128 varint."""
+    out = b""
+    while value >= 0x80:
+        out += bytes([(value & 0x7F) | 0x80])
+        value >>= 7
+    return out + bytes([value])
+
+
+def v2_event(event_type: int, delta: int, handle_field: int, data: int = 0) -> bytes:
+    """Encode one RTT_TRACE_V2 event (handle_field already index- or raw-encoded)."""
+    zigzag = ((delta << 1) ^ (delta >> 31)) & 0xFFFFFFFF
+    out = bytes([event_type | (0x80 if data else 0)]) + varint(zigzag) + varint(handle_field)
+    return out + (varint(data) if data else b"")
+
+
+def sample_trace() -> bytes:
+    """V2 trace with a registry, task switches, an ISR and a gap."""
+    registry = b"TASK_REGISTRY_BIN\n" + bytes([2])
+    registry += struct.pack("<IB", 0x20001000, 4) + b"idle" + struct.pack("<IB", 0x20002000, 6) + b"worker"
+    content = b"RTT_TRACE_V2\n" + registry + b"\x7e" + struct.pack("<I", 1000)
+    content += v2_event(0x01, 0, 0b01)  # idle in
+    content += v2_event(0x10, 5, 0)  # ISR enter
+    content += v2_event(0x11, 3, 0)  # ISR exit
+    content += v2_event(0x02, 12, 0b01)  # idle out after 20
+    content += v2_event(0x01, 1, 0b11)  # worker in
+    content += v2_event(0x70, 4, 0, 7)  # 7 events lost
+    content += v2_event(0x02, 6, 0b11)  # worker out, unmatched after the gap
+    content += v2_event(0x01, 10, 0b11)  # worker in
+    content += v2_event(0x21, 30, 0x20008000 << 1, 1)  # queue send, worker still running
+    return content
+
+
+class EnvironmentOverride:
+    """Set or clear an environment variable for a block."""
+
+    def __init__(self, name: str, value: Optional[str]):
+        self.name = name
+        self.value = value
+        self.saved: Optional[str] = None
+
+    def __enter__(self) -> "EnvironmentOverride":
+        self.saved = os.environ.get(self.name)
+        if self.value is None:
+            os.environ.pop(self.name, None)
+        else:
+            os.environ[self.name] = self.value
+        return self
+
+    def __exit__(self, *_args: object) -> None:
+        if self.saved is None:
+            os.environ.pop(self.name, None)
+        else:
+            os.environ[self.name] = self.saved
+
+
+class TestFindLibrary:
+    """Test locating the shared library."""
+
+    def test_searches_given_directories(self, temp_dir: Path) -> None:
+        """Test the first directory containing the library wins."""
+        (temp_dir / "b").mkdir()
+        library = temp_dir / "b" / "librtt_host_c.so"
+        library.write_bytes(b"")
+        with EnvironmentOverride(rtt_host.LIBRARY_ENV, None):
+            assert rtt_host.find_library([temp_dir / "a", temp_dir / "b"]) == library
+            assert rtt_host.find_library([temp_dir / "a"]) is None
+
+    def test_environment_variable_takes_precedence(self, temp_dir: Path) -> None:
+        """Test RTT_HOST_LIBRARY overrides the search, also when it is wrong."""
+        library = temp_dir / "custom.so"
+        library.write_bytes(b"")
+        (temp_dir / "librtt_host_c.so").write_bytes(b"")
+        with EnvironmentOverride(rtt_host.LIBRARY_ENV, str(library)):
+            assert rtt_host.find_library([temp_dir]) == library
+        with EnvironmentOverride(rtt_host.LIBRARY_ENV, str(temp_dir / "missing.so")):
+            assert rtt_host.find_library([temp_dir]) is None
+
+    def test_load_reports_missing_library(self, temp_dir: Path) -> None:
+        """Test a missing or invalid library raises RttHostError."""
+        with pytest.raises(rtt_host.RttHostError, match="Cannot load"):
+            rtt_host.load_library(temp_dir / "missing.so")
+        invalid = temp_dir / "librtt_host_c.so"
+        invalid.write_bytes(b"not a library")
+        with pytest.raises(rtt_host.RttHostError, match="Cannot load"):
+            rtt_host.load_library(invalid)
+
+    def test_record_layout_matches_c_api(self) -> None:
+        """Test the ctypes structures match rtt_host.h."""
+        assert struct.calcsize("<QIIB7x") == 24
+        assert rtt_host.TraceRecord.__dict__["type"].offset == 16
+        assert len(bytes(rtt_host.TraceRecord())) == 24
+
+
+class TestNativeTrace:
+    """Test decoding with the library against the Python decoder."""
+
+    @staticmethod
+    def write_trace(temp_dir: Path) -> Path:
+        """Write the sample trace to a file."""
+        trace_file = temp_dir / "trace.bin"
+        trace_file.write_bytes(sample_trace())
+        return trace_file
+
+    @needs_library
+    def test_events_match_python_decoder(self, temp_dir: Path) -> None:
+        """Test the library decodes the same events as TraceParser."""
+        trace_file = self.write_trace(temp_dir)
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+
+        with rtt_host.NativeTrace(trace_file, threads=2) as trace:
+            assert len(trace) == len(parser.events)
+            for record, event in zip(trace.records, parser.events):
+                assert (record.type, record.timestamp, record.handle, record.data) == (event.event_type, event.timestamp, event.handle, event.data)
+            assert trace.task_registry() == parser.task_registry
+            assert trace.task_name(0x20003000) == "Task_0x20003000"
+
+    @needs_library
+    def test_summary_and_task_stats(self, temp_dir: Path) -> None:
+        """Test the statistics follow the Python analyzer."""
+        with rtt_host.NativeTrace(self.write_trace(temp_dir)) as trace:
+            summary = trace.summary()
+            stats = {task.name: task for task in trace.task_stats()}
+
+        assert summary.encoding == "V2"
+        assert summary.events == 9
+        assert summary.first_timestamp == 1000
+        assert summary.last_timestamp == 1071
+        assert (summary.gaps, summary.lost_events) == (1, 7)
+        assert (summary.unmatched_in, summary.unmatched_out) == (0, 1)
+        assert (summary.isr_count, summary.isr_matched, summary.isr_total, summary.isr_min) == (1, 1, 3, 3)
+        assert stats["idle"].total == 20
+        # Still running at the end: counted up to the last event
+        assert (stats["worker"].count, stats["worker"].total) == (1, 30)
+
+    @needs_library
+    def test_records_are_released_on_close(self, temp_dir: Path) -> None:
+        """Test close() drops the view into the library's memory."""
+        trace = rtt_host.NativeTrace(self.write_trace(temp_dir))
+        assert len(trace) == 9
+        trace.close()
+        assert len(trace) == 0
+        trace.close()
+
+    @needs_library
+    def test_missing_file_raises(self, temp_dir: Path) -> None:
+        """Test a missing capture raises RttHostError."""
+        with pytest.raises(rtt_host.RttHostError, match="Cannot decode"):
+            rtt_host.NativeTrace(temp_dir / "missing.bin")
+
+    @needs_library
+    def test_export_perfetto(self, temp_dir: Path) -> None:
+        """Test the protobuf export writes Trace.packet fields."""
+        output = temp_dir / "trace.pftrace"
+        summary = rtt_host.export_perfetto(self.write_trace(temp_dir), output, frequency=1000000, threads=2)
+        assert summary.events == 9
+        content = output.read_bytes()
+        assert content[0] == 0x0A
+        assert b"worker" in content
+        assert b"Memory Usage" in content
+
+    @needs_library
+    def test_analyzer_native_options(self, temp_dir: Path, capsys) -> None:
+        """Test rtt_trace_analyzer decodes and exports through the library."""
+        trace_file = self.write_trace(temp_dir)
+        output = temp_dir / "out.pftrace"
+        saved = sys.argv
+        sys.argv = ["rtt_trace_analyzer.py", str(trace_file), "--native", "--task-runtime", "--export-perfetto-proto", str(output)]
+        try:
+            assert rtt_trace_analyzer.main() == 0
+        finally:
+            sys.argv = saved
+        out = capsys.readouterr().out
+        assert "native" in out
+        assert "worker" in out
+        assert output.stat().st_size > 0
+
+        parser = TraceParser(trace_file)
+        assert parser.parse_native()
+        assert len(TraceAnalyzer(parser).get_gaps()) == 1
+
+    @needs_library
+    def test_analyzer_native_report_matches_python(self, temp_dir: Path, capsys) -> None:
+        """Test --native prints the analysis from the library summary like the Python analyzer."""
+        trace_file = self.write_trace(temp_dir)
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        parser.cpu_frequency = 1000000
+        analyzer = TraceAnalyzer(parser)
+        capsys.readouterr()
+        analyzer.analyze_task_runtime()
+        analyzer.analyze_interrupts()
+        expected = capsys.readouterr().out
+
+        with rtt_host.NativeTrace(trace_file) as trace:
+            report = rtt_trace_analyzer.NativeTraceReport(trace, 1000000)
+            report.analyze_task_runtime()
+            report.analyze_interrupts()
+            report.print_summary()
+            assert trace._records is None  # pylint: disable=protected-access
+        out = capsys.readouterr().out
+        assert out.startswith(expected)
+        assert "EVENTS_LOST" in out
+        assert "Lost events: 7 in 1 gap(s)" in out
+
+    @needs_library
+    def test_analyzer_perfetto_proto_only(self, temp_dir: Path, capsys) -> None:
+        """Test the protobuf export alone does not parse the trace in Python."""
+        trace_file = self.write_trace(temp_dir)
+        output = temp_dir / "only.pftrace"
+        saved = sys.argv
+        sys.argv = ["rtt_trace_analyzer.py", str(trace_file), "--export-perfetto-proto", str(output)]
+        try:
+            assert rtt_trace_analyzer.main() == 0
+        finally:
+            sys.argv = saved
+        out = capsys.readouterr().out
+        assert "Exported" in out
+        assert "Parsed" not in out
+        assert "Trace Summary" not in out
+        assert output.stat().st_size > 0
+
+
+class TestNativeDataStream:
+    """Test rtt_data packet iteration with the library."""
+
+    @staticmethod
+    def packet(data_type: int, payload: bytes, timestamp: int) -> bytes:
+        """Encode one rtt_data packet."""
+        return b"RD" + struct.pack("<BBII", data_type, 0, len(payload), timestamp) + payload
+
+    @needs_library
+    def test_iterates_packets_and_skips_text(self, temp_dir: Path) -> None:
+        """Test packets are found between unrelated bytes."""
+        data_file = temp_dir / "data.bin"
+        data_file.write_bytes(b"boot\n" + self.packet(10, b"hello", 5) + b"RDx" + self.packet(5, struct.pack("<I", 42), 9))
+
+        with rtt_host.NativeDataStream(data_file) as stream:
+            packets: Iterator[rtt_host.DataPacket] = iter(stream)
+            first = next(packets)
+            assert (first.type, first.timestamp, first.offset, bytes(first.payload)) == (10, 5, 5, b"hello")
+            second = next(packets)
+            assert struct.unpack("<I", bytes(second.payload))[0] == 42
+            assert next(packets, None) is None
+            assert stream.skipped_bytes == 5 + 3
+
+    @needs_library
+    def test_data_reader_native_matches_python(self, temp_dir: Path, capsys) -> None:
+        """Test rtt_data_reader prints the same packets when the library frames them."""
+        data_file = temp_dir / "data.bin"
+        data_file.write_bytes(b"boot\n" + self.packet(10, b"hello", 5) + b"RDx" + self.packet(5, struct.pack("<I", 42), 9))
+
+        rtt_data_reader.read_from_file(str(data_file))
+        python_lines = capsys.readouterr().out.splitlines()
+        rtt_data_reader.read_from_file(str(data_file), native=True)
+        native_lines = capsys.readouterr().out.splitlines()
+
+        assert native_lines[2:4] == python_lines[2:4] == ['[000005] [String] "hello"', "[000009] [UInt32] 42"]
+        assert native_lines[-1] == "Packets processed: 2, Errors: 0, Skipped bytes: 8"
@@ -0,0 +1,151 @@
+"""Unit tests for rtt_junit.py."""
+
+import struct
+import xml.etree.ElementTree as ET
+from pathlib import Path
+from typing import List, Optional, Tuple
+
+from rtt_data_reader import DataType
+from rtt_junit import RESULT_SCHEMA_NAME, extract_results, run, to_junit
+
+SCHEMA_ID = 0xB2
+# (name, type, offset)
+RESULT_FIELDS: List[Tuple[str, DataType, int]] = [
+    ("cycles", DataType.UInt64, 0),
+    ("budget", DataType.UInt64, 8),
+    ("frequency", DataType.UInt32, 16),
+    ("failures", DataType.UInt32, 20),
+    ("index", DataType.UInt16, 24),
+    ("status", DataType.UInt8, 26),
+]
+RESULT_SIZE = 32
+
+
+def packet(data_type: DataType, subtype: int, payload: bytes) -> bytes:
+    """Build an rtt_data packet."""
+    return struct.pack("<2sBBII", b"RD", data_type, subtype, len(payload), 0) + payload
+
+
+def schema_packet(name: str = RESULT_SCHEMA_NAME) -> bytes:
+    """Build the Schema packet RttTestEventListener sends for TestResult."""
+    payload = struct.pack("<HB", RESULT_SIZE, len(RESULT_FIELDS)) + bytes([len(name)]) + name.encode()
+    for field, data_type, offset in RESULT_FIELDS:
+        payload += struct.pack("<BHH", data_type, offset, 1) + bytes([len(field)]) + field.encode()
+    return packet(DataType.Schema, SCHEMA_ID, payload)
+
+
+def name_packet(index: int, suite: str, name: str) -> bytes:
+    """Build the String record naming a test."""
+    return packet(DataType.String, 0, f"RTT_TEST {index} {suite} {name}".encode())
+
+
+def failure_packet(index: int, failure: str) -> bytes:
+    """Build the String record carrying the first failure of a test."""
+    return packet(DataType.String, 0, f"RTT_FAIL {index} {failure}".encode())
+
+
+def result_packet(index: int, cycles: int, status: int = 0, budget: int = 0, failures: Optional[int] = None) -> bytes:
+    """Build a TestResult Struct packet."""
+    count = failures if failures is not None else (1 if status == 1 else 0)
+    payload = struct.pack("<QQIIHB", cycles, budget, 100_000_000, count, index, status)
+    return packet(DataType.Struct, SCHEMA_ID, payload.ljust(RESULT_SIZE, b"\0"))
+
+
+def capture() -> bytes:
+    """A capture of three tests in two suites."""
+    data = b"noise" + schema_packet() + packet(DataType.Int32, 0, struct.pack("<i", 5))
+    data += name_packet(0, "Crc", "Table") + result_packet(0, 1200, budget=5000)
+    data += name_packet(1, "Crc", "Slow") + failure_packet(1, "crc.cpp:20: cycle budget exceeded: 9000 > 5000 cycles")
+    data += result_packet(1, 9000, status=1, budget=5000)
+    data += name_packet(2, "Uart", "NeedsHardware") + result_packet(2, 50, status=2)
+    return data
+
+
+class TestExtractResults:
+    """Test decoding results from a capture."""
+
+    def test_extract(self) -> None:
+        """Test decoding results between other packets and noise."""
+        results = extract_results(capture())
+
+        assert [(r.suite, r.name, r.status) for r in results] == [("Crc", "Table", "passed"), ("Crc", "Slow", "failed"), ("Uart", "NeedsHardware", "skipped")]
+        assert results[0].cycles == 1200
+        assert results[0].seconds == 12e-6
+        assert results[1].over_budget
+        assert results[1].failure.startswith("crc.cpp:20: cycle budget exceeded")
+
+    def test_repeated_test_is_named_once(self) -> None:
+        """Test that a repeated test keeps its name and only failed runs carry a failure."""
+        data = schema_packet() + name_packet(0, "Crc", "Flaky") + result_packet(0, 100)
+        data += failure_packet(0, "crc.cpp:9: Expected equality") + result_packet(0, 100, status=1) + result_packet(0, 100)
+        results = extract_results(data)
+
+        assert [(r.name, r.status, r.failure) for r in results] == [("Flaky", "passed", ""), ("Flaky", "failed", "crc.cpp:9: Expected equality"), ("Flaky", "passed", "")]
+
+    def test_missing_name_record(self) -> None:
+        """Test that results whose name record was not captured still get a name."""
+        results = extract_results(schema_packet() + result_packet(3, 100) + packet(DataType.String, 0, b"RTT_TEST x Crc Table"))
+        assert [(r.suite, r.name) for r in results] == [("unknown", "test3")]
+
+    def test_requires_schema(self) -> None:
+        """Test that results without a schema are not decoded."""
+        assert extract_results(name_packet(0, "Crc", "Table") + result_packet(0, 1200)) == []
+
+    def test_ignores_other_structs(self) -> None:
+        """Test that structs of other schemas are skipped."""
+        data = schema_packet("rtt::unittest::TestResulX") + name_packet(0, "Crc", "Table") + result_packet(0, 1200)
+        assert extract_results(data) == []
+
+
+class TestJunit:
+    """Test the JUnit XML report."""
+
+    def test_report(self) -> None:
+        """Test suites, counts, properties, failures and skips."""
+        root = to_junit(extract_results(capture()), "board").getroot()
+
+        assert root.tag == "testsuites"
+        assert (root.get("name"), root.get("tests"), root.get("failures"), root.get("skipped")) == ("board", "3", "1", "1")
+        suites = root.findall("testsuite")
+        assert [(s.get("name"), s.get("tests"), s.get("failures")) for s in suites] == [("Crc", "2", "1"), ("Uart", "1", "0")]
+
+        table, slow = suites[0].findall("testcase")
+        assert (table.get("classname"), table.get("name"), table.get("time")) == ("Crc", "Table", "0.000012")
+        assert table.find("failure") is None
+        assert {p.get("name"): p.get("value") for p in table.iter("property")} == {"cycles": "1200", "budget": "5000"}
+
+        failure = slow.find("failure")
+        assert failure is not None
+        assert failure.get("type") == "cycle_budget"
+        assert failure.get("message") == "crc.cpp:20: cycle budget exceeded: 9000 > 5000 cycles"
+        assert suites[1].find("testcase/skipped") is not None
+
+    def test_assertion_failure(self) -> None:
+        """Test that assertion failures are not reported as budget failures."""
+        data = schema_packet() + name_packet(0, "Crc", "Wrong") + failure_packet(0, "crc.cpp:9: Expected equality")
+        data += result_packet(0, 100, status=1, failures=2)
+        failure = to_junit(extract_results(data)).getroot().find("testsuite/testcase/failure")
+        assert failure is not None
+        assert failure.get("type") == "assertion"
+        assert failure.text is not None and "2 failed assertion(s)" in failure.text
+
+
+class TestRun:
+    """Test the command line entry point."""
+
+    def test_writes_report_and_fails_on_failures(self, temp_dir: Path) -> None:
+        """Test the report file and the exit code."""
+        path = temp_dir / "results.bin"
+        output = temp_dir / "junit.xml"
+        path.write_bytes(capture())
+        assert run(str(path), str(output), quiet=True) == 1
+        assert ET.parse(str(output)).getroot().get("tests") == "3"
+
+        path.write_bytes(schema_packet() + name_packet(0, "Crc", "Table") + result_packet(0, 1200))
+        assert run(str(path), str(output), quiet=True) == 0
+
+    def test_no_results(self, temp_dir: Path) -> None:
+        """Test a capture without test results."""
+        path = temp_dir / "results.bin"
+        path.write_bytes(b"")
+        assert run(str(path)) == 2
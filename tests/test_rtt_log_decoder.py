@@ -0,0 +1,127 @@
+"""Unit tests for rtt_log_decoder.py."""
+
+import struct
+from pathlib import Path
+
+from rtt_log_decoder import DeferredArgType, RttLogDecoder
+
+
+def make_record(level: int, format_id: int, payload: bytes, timestamp: int = 0) -> bytes:
+    """Build a deferred log record."""
+    return struct.pack("<2sBBII", b"RL", level, len(payload), format_id, timestamp) + payload
+
+
+def int_arg(value: int) -> bytes:
+    """Encode an Int32 argument."""
+    return struct.pack("<Bi", DeferredArgType.Int32, value)
+
+
+def string_arg(value: str) -> bytes:
+    """Encode a String argument."""
+    raw = value.encode()
+    return struct.pack("<BB", DeferredArgType.String, len(raw)) + raw
+
+
+class TestRender:
+    """Test printf-style rendering."""
+
+    def test_integers_and_strings(self) -> None:
+        """Test common conversions."""
+        assert RttLogDecoder.render("a=%d b=%s c=%%", [5, "x"]) == "a=5 b=x c=%"
+
+    def test_length_modifiers(self) -> None:
+        """Test stripping of C length modifiers."""
+        assert RttLogDecoder.render("%lu %lld %hhx %zu", [1, -2, 255, 4]) == "1 -2 ff 4"
+
+    def test_width_and_precision(self) -> None:
+        """Test width, precision and '*' arguments."""
+        assert RttLogDecoder.render("[%5d] %.2f %*d", [42, 3.14159, 4, 7]) == "[   42] 3.14    7"
+
+    def test_pointer(self) -> None:
+        """Test pointer conversion."""
+        assert RttLogDecoder.render("%p", [0x20001000]) == "0x20001000"
+
+    def test_missing_arguments(self) -> None:
+        """Test missing arguments are marked."""
+        assert RttLogDecoder.render("%d %d", [1]) == "1 ?"
+
+
+class TestRttLogDecoder:
+    """Test RttLogDecoder class."""
+
+    def test_parse_record(self) -> None:
+        """Test parsing a complete record."""
+        payload = int_arg(-3) + struct.pack("<Bf", DeferredArgType.Float, 1.5) + string_arg("ok") + struct.pack("<BI", DeferredArgType.UInt32, 7)
+        data = make_record(2, 0x10, payload, 1234)
+        decoder = RttLogDecoder()
+
+        record, consumed = decoder.parse_record(data)
+        assert consumed == len(data)
+        assert record is not None
+        assert record.level == 2
+        assert record.format_id == 0x10
+        assert record.timestamp == 1234
+        assert record.args == [-3, 1.5, "ok", 7]
+
+    def test_parse_incomplete_record(self) -> None:
+        """Test that incomplete records are not consumed."""
+        data = make_record(2, 0x10, int_arg(1))
+        record, consumed = RttLogDecoder().parse_record(data[:-1])
+        assert record is None
+        assert consumed == 0
+
+    def test_format_record(self) -> None:
+        """Test rendering a record with a known format."""
+        decoder = RttLogDecoder({0x10: "Value: %d"})
+        record, _ = decoder.parse_record(make_record(3, 0x10, int_arg(42)))
+        assert decoder.format_record(record) == "[WARN] Value: 42"
+
+    def test_format_unknown_id(self) -> None:
+        """Test rendering a record with an unknown format id."""
+        decoder = RttLogDecoder()
+        record, _ = decoder.parse_record(make_record(2, 0x99, int_arg(1)))
+        assert "unknown format 0x00000099" in decoder.format_record(record)
+
+    def test_timestamp_conversion(self) -> None:
+        """Test cycle timestamps are converted with the CPU frequency."""
+        decoder = RttLogDecoder({0: "tick"}, cpu_hz=1000)
+        record, _ = decoder.parse_record(make_record(2, 0, b"", 500))
+        assert decoder.format_record(record).split() == ["0.500000", "[INFO]", "tick"]
+
+    def test_feed_mixed_stream(self) -> None:
+        """Test demultiplexing text lines and binary records."""
+        decoder = RttLogDecoder({0x10: "Name: %s"})
+        stream = b"[INFO] Text line\r\n" + make_record(4, 0x10, string_arg("motor")) + b"[DEBUG] More text\r\n"
+
+        lines = decoder.feed(stream[:10]) + decoder.feed(stream[10:25]) + decoder.feed(stream[25:])
+        assert lines == ["[INFO] Text line", "[ERROR] Name: motor", "[DEBUG] More text"]
+
+    def test_feed_magic_in_text(self) -> None:
+        """Test that "RL" inside text lines does not start a record."""
+        decoder = RttLogDecoder({0x10: "Name: %s"})
+        text = b"[INFO] CTRL register set\r\n[INFO] WORLD hello\r\n"
+        stream = text + b"[INFO] URL" + make_record(4, 0x10, string_arg("motor")) + b"[INFO] next\r\n"
+
+        assert decoder.feed(stream) == ["[INFO] CTRL register set", "[INFO] WORLD hello", "[INFO] URL", "[ERROR] Name: motor", "[INFO] next"]
+        lines = [line for i in range(len(stream)) for line in decoder.feed(stream[i : i + 1])]
+        assert lines == ["[INFO] CTRL register set", "[INFO] WORLD hello", "[INFO] URL", "[ERROR] Name: motor", "[INFO] next"]
+
+    def test_check_record(self) -> None:
+        """Test header validation of record candidates."""
+        decoder = RttLogDecoder({0x10: "Value: %d"})
+        record = make_record(2, 0x10, int_arg(1))
+        assert decoder.check_record(record) is True
+        assert decoder.check_record(record[:-1]) is None
+        assert decoder.check_record(b"R") is None
+        assert decoder.check_record(make_record(6, 0x10, int_arg(1))) is False
+        assert decoder.check_record(make_record(2, 0x11, int_arg(1))) is False
+        assert decoder.check_record(make_record(2, 0x10, b"\x08" + bytes(4))) is False
+        assert decoder.check_record(make_record(2, 0x10, int_arg(1) + b"\x00")) is False
+        assert decoder.check_record(make_record(2, 0x10, bytes(53))) is False
+        assert RttLogDecoder(max_record_size=128).check_record(make_record(2, 0x99, int_arg(0) * 20)) is True
+
+    def test_from_elf(self, sample_elf_file: Path) -> None:
+        """Test loading format strings from an ELF file."""
+        decoder = RttLogDecoder.from_elf(str(sample_elf_file))
+        record, _ = decoder.parse_record(make_record(2, 0xA, string_arg("board")))
+        assert decoder.format_record(record) == "[INFO] Name: board"
@@ -1,6 +1,48 @@
 """Unit tests for rtt_reader.py."""
 
-from rtt_reader import JLinkRttReader, OpenOcdRttReader, RttBackend, RttReaderApp
+from typing import List, Optional
+
+from rtt_reader import ChannelDescriptor, ControlReply, JLinkRttReader, OpenOcdRttReader, RttBackend, RttReader, RttReaderApp, parse_channel_table, parse_control_replies
+
+CHANNEL_TABLE = (
+    "RTT_CHANNELS 3\n"
+    "RTT_CHANNEL 0 1024 skip Terminal\n"
+    "RTT_CHANNEL 1 1024 trim Data\n"
+    "RTT_CHANNEL 2 2048 skip FreeRTOS Trace\n"
+)
+
+
+class FakeReader(RttReader):
+    """Reader returning prepared chunks from channel 0."""
+
+    def __init__(self, chunks: List[bytes]) -> None:
+        self.chunks = chunks
+
+    def connect(self) -> bool:
+        return True
+
+    def disconnect(self) -> None:
+        pass
+
+    def read_rtt(self, channel: int = 0, size: int = 1024) -> Optional[bytes]:
+        return self.chunks.pop(0) if channel == 0 and self.chunks else None
+
+    def is_connected(self) -> bool:
+        return True
+
+
+class FakeWriter(FakeReader):
+    """Reader whose down-buffer accepts a few bytes per write."""
+
+    def __init__(self, accepted: List[int]) -> None:
+        super().__init__([])
+        self.accepted = accepted
+        self.sent: List[bytes] = []
+
+    def write_rtt(self, channel: int, data: bytes) -> int:
+        count = min(self.accepted.pop(0) if self.accepted else 0, len(data))
+        self.sent.append(data[:count])
+        return count
 
 
 class TestRttBackend:
@@ -100,3 +142,54 @@ class TestRttReaderApp:
         reader = OpenOcdRttReader()
         app = RttReaderApp(reader, output_file="output.txt")
         assert app.output_file == "output.txt"
+
+    def test_resolve_channel_from_table(self) -> None:
+        """Test finding a channel in a table split across reads."""
+        table = CHANNEL_TABLE.encode()
+        app = RttReaderApp(FakeReader([b"[INFO] boot\r\n", table[:40], table[40:]]))
+        assert app.resolve_channel("FreeRTOS Trace", timeout=1.0, poll_interval=0) == 2
+
+    def test_resolve_unknown_channel(self) -> None:
+        """Test resolving a name that is not in the table."""
+        app = RttReaderApp(FakeReader([CHANNEL_TABLE.encode()]))
+        assert app.resolve_channel("Profiler", timeout=0.05, poll_interval=0) is None
+
+    def test_send_command_in_pieces(self) -> None:
+        """Test a command is written as the down-buffer makes room."""
+        writer = FakeWriter([4, 0, 16])
+        app = RttReaderApp(writer)
+        assert app.send_command(" trace mask task isr ", timeout=1.0, poll_interval=0)
+        assert b"".join(writer.sent) == b"trace mask task isr\n"
+
+    def test_send_command_times_out(self) -> None:
+        """Test a backend that cannot write fails the command."""
+        app = RttReaderApp(FakeReader([]))
+        assert not app.send_command("log debug", timeout=0.05, poll_interval=0)
+        assert OpenOcdRttReader().write_rtt(0, b"log debug\n") == 0
+
+
+class TestParseControlReplies:
+    """Test parse_control_replies."""
+
+    def test_parses_ok_and_error_replies(self) -> None:
+        """Test replies between log records, reasons containing a colon."""
+        text = "[INFO] Ready\r\nRTT_CONTROL OK log debug\r\nRTT_CONTROL ERR usage: trace mask <category>...: trace mask\n"
+        assert parse_control_replies(text) == [
+            ControlReply(True, "log debug"),
+            ControlReply(False, "trace mask", "usage: trace mask <category>..."),
+        ]
+
+
+class TestParseChannelTable:
+    """Test parse_channel_table."""
+
+    def test_parses_descriptors(self) -> None:
+        """Test descriptors with names containing spaces."""
+        channels = parse_channel_table(CHANNEL_TABLE)
+        assert list(channels) == ["Terminal", "Data", "FreeRTOS Trace"]
+        assert channels["FreeRTOS Trace"] == ChannelDescriptor(2, 2048, "skip", "FreeRTOS Trace")
+
+    def test_ignores_other_lines(self) -> None:
+        """Test log records and CRLF line ends around the table."""
+        channels = parse_channel_table("[INFO] Ready\r\nRTT_CHANNEL 1 512 block Data\r\n")
+        assert channels == {"Data": ChannelDescriptor(1, 512, "block", "Data")}
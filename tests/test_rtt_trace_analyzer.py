@@ -7,6 +7,27 @@ from pathlib import Path
 from rtt_trace_analyzer import TraceAnalyzer, TraceEvent, TraceParser
 
 
+def varint(value: int) -> bytes:
+    """Encode an unsigned LEB128 varint."""
+    out = b""
+    while value >= 0x80:
+        out += bytes([(value & 0x7F) | 0x80])
+        value >>= 7
+    return out + bytes([value])
+
+
+def v2_event(event_type: int, delta: int, handle_field: int, data: int = 0) -> bytes:
+    """Encode one RTT_TRACE_V2 event (handle_field already index- or raw-encoded)."""
+    zigzag = (delta << 1) ^ (delta >> 31) if delta < 0 else delta << 1
+    out = bytes([event_type | (0x80 if data else 0)]) + varint(zigzag & 0xFFFFFFFF) + varint(handle_field)
+    return out + (varint(data) if data else b"")
+
+
+def v2_sync(timestamp: int) -> bytes:
+    """Encode an RTT_TRACE_V2 sync record."""
+    return b"\x7e" + struct.pack("<I", timestamp)
+
+
 class TestTraceEvent:
     """Test TraceEvent dataclass."""
 
@@ -175,3 +196,194 @@ class TestTraceAnalyzer:
             data = json.load(f)
             assert "traceEvents" in data
             assert "metadata" in data
+
+
+class TestTraceParserV2:
+    """Test RTT_TRACE_V2 decoding."""
+
+    REGISTRY = b"TASK_REGISTRY_START\nTASK:536871168:Idle\nTASK:536871424:Main\nTASK_REGISTRY_END\n"
+
+    def parse(self, temp_dir: Path, body: bytes) -> TraceParser:
+        """Write a V2 stream and parse it."""
+        trace_file = temp_dir / "trace_v2.bin"
+        trace_file.write_bytes(b"RTT_TRACE_V2\nTRACE_START\n" + self.REGISTRY + body + b"TRACE_STOP\n")
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        return parser
+
+    def test_detects_encoding(self, temp_dir: Path) -> None:
+        """Test that the header marker selects the V2 decoder."""
+        parser = self.parse(temp_dir, b"")
+        assert parser.encoding == "V2"
+        assert parser.events == []
+        assert parser.task_index == [536871168, 536871424]
+
+    def test_deltas_and_handles(self, temp_dir: Path) -> None:
+        """Test timestamp deltas, registry indices and raw handles."""
+        body = v2_sync(1000) + v2_event(0x01, 0, (1 << 1) | 1) + v2_event(0x02, 250, (1 << 1) | 1) + v2_event(0x21, 5, 0x20009000 << 1)
+        parser = self.parse(temp_dir, body)
+
+        assert [(e.event_name, e.timestamp, e.handle) for e in parser.events] == [
+            ("TASK_SWITCHED_IN", 1000, 536871424),
+            ("TASK_SWITCHED_OUT", 1250, 536871424),
+            ("QUEUE_SEND", 1255, 0x20009000),
+        ]
+        assert parser.get_task_name(parser.events[0].handle) == "Main"
+
+    def test_negative_delta_and_wrap(self, temp_dir: Path) -> None:
+        """Test out-of-order events and 32-bit timestamp wrap."""
+        body = v2_sync(0xFFFFFFF0) + v2_event(0x10, 0, 0) + v2_event(0x11, 0x20, 0) + v2_event(0x10, -3, 0)
+        parser = self.parse(temp_dir, body)
+        assert [e.timestamp for e in parser.events] == [0xFFFFFFF0, 0x10, 0x0D]
+
+    def test_data_field(self, temp_dir: Path) -> None:
+        """Test that the data varint is present only when flagged."""
+        body = v2_sync(0) + v2_event(0x60, 1, 0x20004000 << 1, 128) + v2_event(0x61, 1, 0x20004000 << 1)
+        parser = self.parse(temp_dir, body)
+        assert [(e.event_name, e.data) for e in parser.events] == [("MALLOC", 128), ("FREE", 0)]
+
+    def test_resync_after_garbage(self, temp_dir: Path) -> None:
+        """Test that decoding resumes at the next sync record after corruption."""
+        body = v2_sync(0) + v2_event(0x01, 1, 1) + b"\x7f\xff" + v2_sync(500) + v2_event(0x02, 10, 1)
+        parser = self.parse(temp_dir, body)
+        assert [(e.event_name, e.timestamp) for e in parser.events] == [("TASK_SWITCHED_IN", 1), ("TASK_SWITCHED_OUT", 510)]
+
+    def test_smaller_than_v1(self) -> None:
+        """Test that a typical context switch is much smaller than the 13-byte V1 event."""
+        assert len(v2_event(0x01, 3000, (5 << 1) | 1)) <= 4
+
+
+class TestSnapshot:
+    """Test decoding of flight recorder dumps."""
+
+    REGISTRY = b"TASK_REGISTRY_START\nTASK:536871168:Idle\nTASK_REGISTRY_END\n"
+
+    def test_v1_text_not_decoded_as_events(self, temp_dir: Path) -> None:
+        """Test that markers and the registry between V1 events are skipped."""
+        trace_file = temp_dir / "snapshot.bin"
+        events = struct.pack("<BIII", 0x01, 100, 536871168, 0) + struct.pack("<BIII", 0x02, 200, 536871168, 0)
+        trace_file.write_bytes(b"RTT_TRACE_V1\nTRACE_SNAPSHOT\n" + self.REGISTRY + events + b"TRACE_SNAPSHOT_END\n")
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        assert [e.event_name for e in parser.events] == ["TASK_SWITCHED_IN", "TASK_SWITCHED_OUT"]
+        assert parser.get_task_name(536871168) == "Idle"
+
+    def test_v2_dump_after_stream(self, temp_dir: Path) -> None:
+        """Test a V2 dump that repeats the header and registry after streamed data."""
+        trace_file = temp_dir / "snapshot_v2.bin"
+        dump = b"RTT_TRACE_V2\nTRACE_SNAPSHOT\n" + self.REGISTRY + v2_sync(5000) + v2_event(0x01, 0, 1) + b"TRACE_SNAPSHOT_END\n"
+        trace_file.write_bytes(b"RTT_TRACE_V2\nTRACE_START\n" + dump)
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        assert [(e.event_name, e.timestamp, e.handle) for e in parser.events] == [("TASK_SWITCHED_IN", 5000, 536871168)]
+
+
+def binary_registry(*tasks: tuple) -> bytes:
+    """Encode a binary TASK_REGISTRY_BIN block from (handle, name) pairs."""
+    out = b"TASK_REGISTRY_BIN\n" + bytes([len(tasks)])
+    for handle, name in tasks:
+        out += struct.pack("<IB", handle, len(name)) + name.encode()
+    return out
+
+
+class TestBinaryRegistry:
+    """Test decoding of binary task registry blocks."""
+
+    def test_v1_registry(self, temp_dir: Path) -> None:
+        """Test that a binary registry between V1 events is decoded and not taken for events."""
+        trace_file = temp_dir / "registry_v1.bin"
+        events = struct.pack("<BIII", 0x01, 100, 0x20000100, 0)
+        registry = binary_registry((0x20000100, "Idle"), (0x20000200, ""))
+        trace_file.write_bytes(b"RTT_TRACE_V1\nTRACE_START\n" + registry + events)
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        assert [e.event_name for e in parser.events] == ["TASK_SWITCHED_IN"]
+        assert parser.get_task_name(0x20000100) == "Idle"
+        assert parser.task_registry[0x20000200] == ""
+
+    def test_v2_resend_mid_stream(self, temp_dir: Path) -> None:
+        """Test that a resent registry names late tasks and replaces the index mapping."""
+        trace_file = temp_dir / "registry_v2.bin"
+        body = binary_registry((0x20000100, "Idle")) + v2_sync(0) + v2_event(0x01, 1, 1)
+        body += binary_registry((0x20000100, "Idle"), (0x20000200, "Late")) + v2_event(0x01, 1, (1 << 1) | 1)
+        trace_file.write_bytes(b"RTT_TRACE_V2\nTRACE_START\n" + body)
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        assert [e.handle for e in parser.events] == [0x20000100, 0x20000200]
+        assert parser.get_task_name(0x20000200) == "Late"
+        assert parser.task_index == [0x20000100, 0x20000200]
+
+    def test_attach_mid_run(self, temp_dir: Path) -> None:
+        """Test a capture that starts without a header: the periodic registry still names tasks."""
+        trace_file = temp_dir / "registry_attach.bin"
+        events = struct.pack("<BIII", 0x02, 5, 0x20000300, 0)
+        trace_file.write_bytes(events + binary_registry((0x20000300, "Worker")) + events)
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        assert len(parser.events) == 2
+        assert parser.get_task_name(0x20000300) == "Worker"
+
+    def test_truncated(self, temp_dir: Path) -> None:
+        """Test that a registry cut off by the end of the capture is ignored."""
+        trace_file = temp_dir / "registry_cut.bin"
+        trace_file.write_bytes(b"RTT_TRACE_V2\n" + binary_registry((0x20000100, "Idle"))[:-2])
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        assert parser.task_registry == {}
+
+
+class TestEventsLost:
+    """Test reporting of EVENTS_LOST gap records."""
+
+    def parse(self, temp_dir: Path, events: list) -> TraceAnalyzer:
+        """Write V1 events and return an analyzer for them."""
+        trace_file = temp_dir / "trace_lost.bin"
+        trace_file.write_bytes(b"".join(struct.pack("<BIII", *event) for event in events))
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        return TraceAnalyzer(parser)
+
+    def test_gaps(self, temp_dir: Path) -> None:
+        """Test that loss records are decoded with their count and start time."""
+        analyzer = self.parse(temp_dir, [(0x21, 100, 0x1000, 0), (0x70, 150, 0, 42), (0x21, 400, 0x1000, 0), (0x70, 500, 0, 3)])
+        assert analyzer.events[1].event_name == "EVENTS_LOST"
+        assert analyzer.get_gaps() == [(150, 42), (500, 3)]
+
+    def test_v2_gap(self, temp_dir: Path) -> None:
+        """Test a loss record placed ahead of newer events (overwrite mode)."""
+        trace_file = temp_dir / "trace_lost_v2.bin"
+        body = v2_sync(900) + v2_event(0x70, 0, 0, 7) + v2_event(0x21, 100, 0x1000 << 1)
+        trace_file.write_bytes(b"RTT_TRACE_V2\n" + body)
+        parser = TraceParser(trace_file)
+        assert parser.parse()
+        assert TraceAnalyzer(parser).get_gaps() == [(900, 7)]
+
+    def test_summary_and_timeline(self, temp_dir: Path, capsys) -> None:
+        """Test that the summary and the timeline show the gaps."""
+        analyzer = self.parse(temp_dir, [(0x21, 100, 0x1000, 0), (0x70, 150, 0, 42), (0x21, 400, 0x1000, 0)])
+        analyzer.print_summary()
+        analyzer.print_timeline()
+        output = capsys.readouterr().out
+        assert "Lost events: 42 in 1 gap(s)" in output
+        assert "LOST 42 events" in output
+
+    def test_task_runtime_not_counted_across_gap(self, temp_dir: Path, capsys) -> None:
+        """Test that a task switched in before a gap is not charged for it."""
+        analyzer = self.parse(temp_dir, [(0x01, 0, 0x2000, 0), (0x70, 10, 0, 5), (0x01, 1000, 0x3000, 0), (0x02, 1100, 0x3000, 0)])
+        analyzer.analyze_task_runtime()
+        captured = capsys.readouterr()
+        assert "switched in without switching out" not in captured.err
+        assert "Task_0x00002000" not in captured.out
+
+    def test_export_marks_gaps(self, temp_dir: Path) -> None:
+        """Test that the exports carry the gaps."""
+        analyzer = self.parse(temp_dir, [(0x01, 0, 0x2000, 0), (0x70, 10, 0, 5), (0x02, 1000, 0x2000, 0)])
+        json_file = temp_dir / "trace.json"
+        chrome_file = temp_dir / "trace_chrome.json"
+        analyzer.export_json(json_file)
+        analyzer.export_chrome_trace(chrome_file)
+
+        assert json.loads(json_file.read_text())["metadata"]["lost_events"] == 5
+        chrome = json.loads(chrome_file.read_text())["traceEvents"]
+        assert [e["args"]["count"] for e in chrome if e["name"] == "Events lost"] == [5]
+        assert not [e for e in chrome if e.get("cat") == "task"]